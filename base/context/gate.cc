@@ -8,6 +8,30 @@
 namespace vertexai {
 namespace context {
 
+GateEntry::~GateEntry() noexcept {
+  if (gate_) {
+    gate_->Leave();
+  }
+}
+
+GateEntry& GateEntry::operator=(GateEntry&& other) noexcept {
+  if (gate_) {
+    gate_->Leave();
+  }
+  gate_ = std::move(other.gate_);
+  return *this;
+}
+
+void GateEntry::TryEnterGate(std::shared_ptr<Gate> gate) {
+  if (gate_) {
+    throw error::Internal{"Using a single gate entry to track multiple synchronization gates"};
+  }
+  if (!gate->TryEnter()) {
+    throw error::Cancelled{};
+  }
+  gate_ = std::move(gate);
+}
+
 Rundown::~Rundown() noexcept {
   if (gate_) {
     gate_->RemoveRundown(handle_);
@@ -22,9 +46,38 @@ void Rundown::TryEnterGate(std::shared_ptr<Gate> gate) {
   gate_ = std::move(gate);
 }
 
-bool Gate::is_open() noexcept {
-  std::lock_guard<std::mutex> lock{mu_};
-  return is_open_;
+bool Gate::is_open() noexcept { return !(state_.load(std::memory_order_acquire) & kClosedBit); }
+
+bool Gate::TryEnter() noexcept {
+  auto prev = state_.fetch_add(kEntryDelta, std::memory_order_acquire);
+  if (prev & kClosedBit) {
+    // The gate closed before we got in; back the entry out again.
+    Leave();
+    return false;
+  }
+  return true;
+}
+
+void Gate::Leave() noexcept {
+  auto prev = state_.fetch_sub(kEntryDelta, std::memory_order_acq_rel);
+  if (!(prev & kClosedBit) || (prev >> 1) != 1) {
+    return;
+  }
+  // The gate closed while this entry was active, and this was the last entry out; complete the
+  // gate's rundown.  This mirrors the tail of RemoveRundown, and like it must wait for the close
+  // to finish delivering callbacks before declaring the gate finalized.
+  bool done = false;
+  {
+    std::unique_lock<std::mutex> lock{mu_};
+    cv_.wait(lock, [this]() { return close_complete_; });
+    if (rundowns_remaining_ == 0 && !finalized_set_) {
+      finalized_set_ = true;
+      done = true;
+    }
+  }  // Drop the mutex
+  if (done) {
+    finalized_prom_.set_value();
+  }
 }
 
 void Gate::CheckIsOpen() {
@@ -42,6 +95,7 @@ boost::shared_future<void> Gate::Close() noexcept {
       return finalized_future_;
     }
     is_open_ = false;
+    state_.fetch_or(kClosedBit, std::memory_order_acq_rel);
     rundowns.swap(rundowns_);
     rundowns_remaining_ = rundowns.size();
     result = finalized_future_;
@@ -54,8 +108,11 @@ boost::shared_future<void> Gate::Close() noexcept {
   bool done = false;
   {
     std::lock_guard<std::mutex> lock{mu_};
-    done = (rundowns_remaining_ == 0);
     close_complete_ = true;
+    if (rundowns_remaining_ == 0 && (state_.load(std::memory_order_acquire) >> 1) == 0 && !finalized_set_) {
+      finalized_set_ = true;
+      done = true;
+    }
   }
   cv_.notify_all();
   if (done) {
@@ -94,7 +151,8 @@ void Gate::RemoveRundown(std::list<std::unique_ptr<Rundown::Callback>>::iterator
     if (!rundowns_remaining_) {
       LOG(FATAL) << "Over-dereference of a synchronization gate";
     }
-    if (!--rundowns_remaining_) {
+    if (!--rundowns_remaining_ && (state_.load(std::memory_order_acquire) >> 1) == 0 && !finalized_set_) {
+      finalized_set_ = true;
       done = true;
     }
   }  // Drop the mutex
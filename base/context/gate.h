@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -36,8 +38,33 @@ namespace context {
 //   TryEnterGate() (which will throw if the gate is closed).  Additionally, Rundown instances can be given a callback
 //   to be invoked when the Gate transitions from Open to Closed, allowing operations to actively initiate their own
 //   cancellation (cancelling RPCs, closing downstream gates, &c).
+//
+//   * Operations that don't need a close callback can use GateEntry instead; entering and leaving are single
+//   atomic operations, keeping the gate's mutex off the steady-state submission path.
 class Gate;
 
+// GateEntry holds a Gate open without registering a close callback.  It is the fast path for steady-state
+// submissions: entering and leaving are single atomic read-modify-writes on the gate's entry counter, and
+// the Gate's mutex is only touched when the gate is closed underneath an active entry.  Use Rundown instead
+// when a callback must be invoked at close time.
+class GateEntry final {
+ public:
+  GateEntry() noexcept {}
+
+  // Destroys the GateEntry, releasing the gate (allowing it to reach the Finalized state).
+  ~GateEntry() noexcept;
+
+  GateEntry(GateEntry&& other) noexcept : gate_{std::move(other.gate_)} {}  // MoveConstructible
+  GateEntry& operator=(GateEntry&& other) noexcept;                         // MoveAssignable
+
+  // Attempt to enter the indicated Gate, throwing error::Cancelled if the gate's been closed
+  // and error::Internal if the GateEntry's already entered a Gate.
+  void TryEnterGate(std::shared_ptr<Gate> gate);
+
+ private:
+  std::shared_ptr<Gate> gate_;
+};
+
 class Rundown final {
  public:
   // Constructs a Rundown without an associated callback.
@@ -117,8 +144,21 @@ class Gate final {
   boost::shared_future<void> Close() noexcept;
 
  private:
+  friend class GateEntry;
   friend class Rundown;
 
+  // Lock-free fast-path state: bit zero is set once the gate closes; the remaining bits count live
+  // GateEntry objects.  is_open()/CheckIsOpen() read it without taking the mutex.
+  static constexpr std::uint64_t kClosedBit = 1;
+  static constexpr std::uint64_t kEntryDelta = 1ull << 1;
+
+  // Attempt to enter the gate via the fast path, returning false if the gate's been closed.
+  bool TryEnter() noexcept;
+
+  // Leave the gate via the fast path.  If the gate has been closed and this was the last entry, completes
+  // the gate's transition to the Finalized state.
+  void Leave() noexcept;
+
   // Attempt to add a rundown to the gate.  The callback may be empty; if it is not, the callback will be invoked if the
   // gate is closed before the rundown is destroyed (technically, before RemoveRundown returns).  If the gate has been
   // closed, a Cancelled exception will be thrown; otherwise, the iterator is the Gate's reference to the rundown's
@@ -130,12 +170,15 @@ class Gate final {
   // is invoked.
   void RemoveRundown(std::list<std::unique_ptr<Rundown::Callback>>::iterator handle) noexcept;
 
+  std::atomic<std::uint64_t> state_{0};
+
   std::mutex mu_;
   std::condition_variable cv_;
   bool is_open_ = true;
   std::list<std::unique_ptr<Rundown::Callback>> rundowns_;
   std::size_t rundowns_remaining_ = 0;
   bool close_complete_ = false;
+  bool finalized_set_ = false;
   boost::promise<void> finalized_prom_;
   boost::shared_future<void> finalized_future_ = finalized_prom_.get_future();
 };
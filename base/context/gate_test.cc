@@ -96,6 +96,71 @@ TEST(GateTest, RundownHoldsGateOpen) {
   f.wait();
 }
 
+TEST(GateTest, GateEntryCannotEnterClosedGate) {
+  auto gate = std::make_shared<Gate>();
+
+  auto f = gate->Close();
+  EXPECT_THAT(f.is_ready(), Eq(true));
+
+  GateEntry entry;
+  EXPECT_THROW(entry.TryEnterGate(gate), error::Cancelled);
+
+  f.wait();
+}
+
+TEST(GateTest, GateEntryCanUseGate) {
+  auto gate = std::make_shared<Gate>();
+
+  {
+    GateEntry entry;
+    entry.TryEnterGate(gate);
+  }
+
+  auto f = gate->Close();
+  EXPECT_THAT(f.is_ready(), Eq(true));
+  EXPECT_THAT(gate->is_open(), Eq(false));
+  f.wait();
+}
+
+TEST(GateTest, GateEntryHoldsGateOpen) {
+  auto gate = std::make_shared<Gate>();
+
+  boost::shared_future<void> f;
+  {
+    GateEntry entry;
+    entry.TryEnterGate(gate);
+
+    f = gate->Close();
+    EXPECT_THAT(f.is_ready(), Eq(false));
+    EXPECT_THAT(gate->is_open(), Eq(false));
+    EXPECT_THROW(gate->CheckIsOpen(), error::Cancelled);
+  }
+
+  EXPECT_THAT(f.is_ready(), Eq(true));
+  f.wait();
+}
+
+TEST(GateTest, GateEntryAndRundownBothHoldGateOpen) {
+  auto gate = std::make_shared<Gate>();
+
+  boost::shared_future<void> f;
+  {
+    Rundown rundown;
+    rundown.TryEnterGate(gate);
+    {
+      GateEntry entry;
+      entry.TryEnterGate(gate);
+
+      f = gate->Close();
+      EXPECT_THAT(f.is_ready(), Eq(false));
+    }
+    EXPECT_THAT(f.is_ready(), Eq(false));
+  }
+
+  EXPECT_THAT(f.is_ready(), Eq(true));
+  f.wait();
+}
+
 TEST(GateTest, RundownCallbackOnClose) {
   auto gate = std::make_shared<Gate>();
   EXPECT_THAT(gate->is_open(), Eq(true));
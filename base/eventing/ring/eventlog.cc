@@ -0,0 +1,80 @@
+#include "base/eventing/ring/eventlog.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/eventing/file/eventlog.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace eventing {
+namespace ring {
+
+namespace {
+
+constexpr std::uint64_t kDefaultCapacity = 65536;
+
+}  // namespace
+
+EventLog::EventLog(const proto::EventLog& config)
+    : config_{config},
+      sample_rate_{std::max<std::uint64_t>(config.sample_rate(), 1)},
+      slots_{config.capacity() ? config.capacity() : kDefaultCapacity} {}
+
+EventLog::~EventLog() { FlushAndClose(); }
+
+void EventLog::LogEvent(context::proto::Event event) {
+  if (closed_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // Sample by activity so that a retained activity keeps all of its events.
+  if (sample_rate_ > 1 && (event.activity_id().index() % sample_rate_) != 0) {
+    return;
+  }
+  auto ticket = next_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = slots_[ticket % slots_.size()];
+  if (slot.busy.test_and_set(std::memory_order_acquire)) {
+    // Someone else is writing or flushing this slot; losing an event beats
+    // blocking the instrumented path.
+    return;
+  }
+  slot.ticket = ticket + 1;
+  slot.event = std::move(event);
+  slot.busy.clear(std::memory_order_release);
+}
+
+void EventLog::FlushAndClose() {
+  if (closed_.exchange(true)) {
+    return;
+  }
+  // Copy the retained window out of the ring, oldest first.
+  std::vector<std::pair<std::uint64_t, context::proto::Event>> retained;
+  for (auto& slot : slots_) {
+    if (slot.busy.test_and_set(std::memory_order_acquire)) {
+      continue;
+    }
+    if (slot.ticket) {
+      retained.emplace_back(slot.ticket, slot.event);
+    }
+    slot.busy.clear(std::memory_order_release);
+  }
+  std::sort(retained.begin(), retained.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  if (config_.filename().empty()) {
+    IVLOG(1, "Discarding " << retained.size() << " retained events; no flush filename configured");
+    return;
+  }
+  file::proto::EventLog file_config;
+  file_config.set_filename(config_.filename());
+  // The file log stamps its stream uuid on the first event it writes, the
+  // same as when events stream to it directly.
+  file::EventLog out{file_config};
+  for (auto& kvp : retained) {
+    out.LogEvent(std::move(kvp.second));
+  }
+  out.FlushAndClose();
+}
+
+}  // namespace ring
+}  // namespace eventing
+}  // namespace vertexai
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "base/context/eventlog.h"
+#include "base/eventing/ring/eventlog.pb.h"
+
+namespace vertexai {
+namespace eventing {
+namespace ring {
+
+// An EventLog that retains the most recent events in a fixed-size in-memory
+// ring instead of streaming them to disk.  The hot path costs one atomic
+// increment plus a protobuf move into a slot, so instrumentation can stay
+// enabled in production; the retained window is written out (to the
+// configured file, in the file eventlog's format) only when the log is
+// flushed.
+class EventLog final : public context::EventLog {
+ public:
+  explicit EventLog(const proto::EventLog& config);
+  ~EventLog();
+
+  void LogEvent(context::proto::Event event) final;
+
+  void FlushAndClose() final;
+
+ private:
+  struct Slot {
+    // Guards the slot's event during writes and flush-time copies.  Writers
+    // that lose the race drop their event rather than stall the hot path.
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    // 1-based claim order of the event held in the slot; 0 = never written.
+    std::uint64_t ticket = 0;
+    context::proto::Event event;
+  };
+
+  // The client configuration.
+  proto::EventLog config_;
+
+  std::uint64_t sample_rate_;
+  std::vector<Slot> slots_;
+  std::atomic<std::uint64_t> next_{0};
+  std::atomic<bool> closed_{false};
+};
+
+}  // namespace ring
+}  // namespace eventing
+}  // namespace vertexai
@@ -183,6 +183,37 @@ cl_kernel CreateKernel(cl_program program, const char* kernel_name, cl_int* errc
 #endif
 }
 
+cl_program CreateProgramWithBinary(cl_context context, cl_uint num_devices, const cl_device_id* device_list,
+                                   const size_t* lengths, const unsigned char** binaries, cl_int* binary_status,
+                                   cl_int* errcode_ret) {
+#ifdef OCL_STATIC_1_0
+
+  return clCreateProgramWithBinary(context, num_devices, device_list, lengths, binaries, binary_status, errcode_ret);
+
+#else
+
+  static auto* impl = GetImpl<cl_program (*)(cl_context, cl_uint, const cl_device_id*, const size_t*,
+                                             const unsigned char**, cl_int*, cl_int*)>("clCreateProgramWithBinary");
+
+  return impl(context, num_devices, device_list, lengths, binaries, binary_status, errcode_ret);
+
+#endif
+}
+
+cl_program CreateProgramWithIL(cl_context context, const void* il, size_t length, cl_int* errcode_ret) {
+#ifdef OCL_STATIC_2_1
+
+  return clCreateProgramWithIL(context, il, length, errcode_ret);
+
+#else
+
+  static auto* impl = GetImpl<cl_program (*)(cl_context, const void*, size_t, cl_int*)>("clCreateProgramWithIL");
+
+  return impl(context, il, length, errcode_ret);
+
+#endif
+}
+
 cl_program CreateProgramWithSource(cl_context context, cl_uint count, const char** strings, const size_t* lengths,
                                    cl_int* errcode_ret) {
 #ifdef OCL_STATIC_1_0
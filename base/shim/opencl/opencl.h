@@ -140,6 +140,12 @@ extern cl_context CreateContext(const cl_context_properties* properties, cl_uint
 
 extern cl_kernel CreateKernel(cl_program program, const char* kernel_name, cl_int* errcode_ret);
 
+extern cl_program CreateProgramWithBinary(cl_context context, cl_uint num_devices, const cl_device_id* device_list,
+                                          const size_t* lengths, const unsigned char** binaries,
+                                          cl_int* binary_status, cl_int* errcode_ret);
+
+extern cl_program CreateProgramWithIL(cl_context context, const void* il, size_t length, cl_int* errcode_ret);
+
 extern cl_program CreateProgramWithSource(cl_context context, cl_uint count, const char** strings,
                                           const size_t* lengths, cl_int* errcode_ret);
 
@@ -6,7 +6,9 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
 #include <cstdlib>
+#include <thread>
 
 namespace vertexai {
 namespace env {
@@ -33,5 +35,22 @@ void Set(const std::string& key, const std::string& value) {
 #endif
 }
 
+std::size_t IntraOpThreadBudget() {
+  auto threads = Get("PLAIDML_INTRA_OP_THREADS");
+  if (threads.size()) {
+    return std::max(1, std::atoi(threads.c_str()));
+  }
+  std::size_t budget = std::thread::hardware_concurrency();
+  if (!budget) {
+    budget = 1;
+  }
+  auto reserved = Get("PLAIDML_RESERVED_CORES");
+  if (reserved.size()) {
+    auto count = std::max(0, std::atoi(reserved.c_str()));
+    budget = static_cast<std::size_t>(count) < budget ? budget - count : 1;
+  }
+  return budget;
+}
+
 }  // namespace env
 }  // namespace vertexai
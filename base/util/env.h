@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace vertexai {
@@ -19,5 +20,12 @@ std::string Get(const std::string& key, const std::string& default_value = "");
 // Writes the requested environment variable.
 void Set(const std::string& key, const std::string& value);
 
+// Returns the process-wide intra-op worker budget, used to size thread pools
+// and parallel loops.  When PLAIDML_INTRA_OP_THREADS is set it is the budget;
+// otherwise the budget is the hardware thread count less
+// PLAIDML_RESERVED_CORES, leaving headroom for co-located processes.  The
+// result is always at least one.
+std::size_t IntraOpThreadBudget();
+
 }  // namespace env
 }  // namespace vertexai
@@ -42,6 +42,15 @@ int64_t GetPerfCounter(const std::string& name) {
   return *(it->second);
 }
 
+std::map<std::string, int64_t> GetPerfCounters() {
+  std::lock_guard<std::mutex> lock(GetMutex());
+  std::map<std::string, int64_t> result;
+  for (const auto& kvp : GetTable()) {
+    result.emplace(kvp.first, kvp.second->load());
+  }
+  return result;
+}
+
 void SetPerfCounter(const std::string& name, int64_t value) {
   std::lock_guard<std::mutex> lock(GetMutex());
   auto& table = GetTable();
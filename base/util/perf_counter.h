@@ -27,4 +27,7 @@ class PerfCounter {
 int64_t GetPerfCounter(const std::string& name);
 void SetPerfCounter(const std::string& name, int64_t value);
 
+// Snapshot every registered counter, for metrics exposition
+std::map<std::string, int64_t> GetPerfCounters();
+
 }  // namespace vertexai
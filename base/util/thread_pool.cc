@@ -0,0 +1,81 @@
+// Copyright 2019, Intel Corporation
+
+#include "base/util/thread_pool.h"
+
+#include <utility>
+
+#include "base/util/env.h"
+
+namespace vertexai {
+
+ThreadPool::ThreadPool(std::size_t workers) {
+  if (!workers) {
+    workers = env::IntraOpThreadBudget();
+  }
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; i++) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{mu_};
+    shutdown_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock{mu_};
+    tasks_.emplace_back(std::move(task));
+    outstanding_++;
+  }
+  work_available_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock{mu_};
+  work_complete_.wait(lock, [this]() { return outstanding_ == 0; });
+  if (first_error_) {
+    auto err = first_error_;
+    first_error_ = nullptr;
+    std::rethrow_exception(err);
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock{mu_};
+      work_available_.wait(lock, [this]() { return shutdown_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{mu_};
+      if (!first_error_) {
+        first_error_ = std::current_exception();
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock{mu_};
+      outstanding_--;
+      if (outstanding_ == 0) {
+        work_complete_.notify_all();
+      }
+    }
+  }
+}
+
+}  // namespace vertexai
@@ -0,0 +1,49 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vertexai {
+
+// A simple fixed-size worker pool.  Tasks are run in submission order
+// (modulo worker availability); Wait() blocks until every submitted
+// task has completed and rethrows the first exception raised by any
+// task, if one occurred.
+class ThreadPool {
+ public:
+  // Constructs a pool with the indicated number of workers; zero
+  // requests the process-wide budget from env::IntraOpThreadBudget().
+  explicit ThreadPool(std::size_t workers = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t size() const { return workers_.size(); }
+
+  // Enqueues a task for execution on some worker.
+  void Submit(std::function<void()> task);
+
+  // Blocks until all previously submitted tasks are complete.
+  void Wait();
+
+ private:
+  void WorkerLoop();
+
+  std::mutex mu_;
+  std::condition_variable work_available_;
+  std::condition_variable work_complete_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> workers_;
+  std::size_t outstanding_ = 0;
+  std::exception_ptr first_error_;
+  bool shutdown_ = false;
+};
+
+}  // namespace vertexai
@@ -9,7 +9,7 @@ const size_t BLOCK_SIZE = 8 * 1024;
 
 namespace vertexai {
 
-UnZipArchive::UnZipArchive(const std::string& path) : zip_file_(unzOpen64(path.c_str())) {
+UnZipArchive::UnZipArchive(const std::string& path) : zip_file_(unzOpen64(path.c_str())), path_(path) {
   if (!zip_file_) {
     throw std::runtime_error("Cannot open zip archive for extraction.");
   }
@@ -17,14 +17,51 @@ UnZipArchive::UnZipArchive(const std::string& path) : zip_file_(unzOpen64(path.c
 
 UnZipArchive::~UnZipArchive() { unzClose(zip_file_); }
 
+void UnZipArchive::EnsureIndex() {
+  if (indexed_) {
+    return;
+  }
+  char name[512];
+  for (int err = unzGoToFirstFile(zip_file_); err == UNZ_OK; err = unzGoToNextFile(zip_file_)) {
+    unz_file_info64 fi;
+    if (unzGetCurrentFileInfo64(zip_file_, &fi, name, sizeof(name), nullptr, 0, nullptr, 0) != UNZ_OK) {
+      break;
+    }
+    unz64_file_pos pos;
+    if (unzGetFilePos64(zip_file_, &pos) != UNZ_OK) {
+      break;
+    }
+    index_.emplace(name, pos);
+  }
+  indexed_ = true;
+}
+
 bool UnZipArchive::Exist(const std::string& filename) {
-  return unzLocateFile(zip_file_, filename.c_str(), nullptr) == UNZ_OK;
+  EnsureIndex();
+  return index_.count(filename) != 0;
 }
 
-UnZipFile UnZipArchive::OpenFile(const std::string& filename) { return UnZipFile(zip_file_, filename); }
+UnZipFile UnZipArchive::OpenFile(const std::string& filename) {
+  EnsureIndex();
+  auto it = index_.find(filename);
+  if (it == index_.end()) {
+    throw std::runtime_error(std::string("Could not locate file within zip archive: ") + filename);
+  }
+  return UnZipFile(zip_file_, filename, &it->second);
+}
+
+std::vector<std::string> UnZipArchive::Entries() {
+  EnsureIndex();
+  std::vector<std::string> names;
+  names.reserve(index_.size());
+  for (const auto& kvp : index_) {
+    names.push_back(kvp.first);
+  }
+  return names;
+}
 
-UnZipFile::UnZipFile(unzFile zip_file, const std::string& filename) : zip_file_(zip_file) {
-  if (unzLocateFile(zip_file_, filename.c_str(), nullptr) != UNZ_OK) {
+UnZipFile::UnZipFile(unzFile zip_file, const std::string& filename, const unz64_file_pos* pos) : zip_file_(zip_file) {
+  if (unzGoToFilePos64(zip_file_, pos) != UNZ_OK) {
     auto msg = std::string("Could not locate file within zip archive: ") + filename;
     throw std::runtime_error(msg);
   }
@@ -40,6 +77,8 @@ std::string UnZipFile::ReadString() {
   return str;
 }
 
+std::uint64_t UnZipFile::FileOffset() const { return unzGetCurrentFileZStreamPos64(zip_file_); }
+
 void UnZipFile::ReadInto(void* buf, std::size_t len) {
   char* ptr = static_cast<char*>(buf);
   std::size_t bytes_remaining = len;
@@ -4,7 +4,10 @@
 
 #include <unzip.h>
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace vertexai {
 
@@ -12,7 +15,7 @@ class UnZipFile {
   friend class UnZipArchive;
 
  private:
-  UnZipFile(unzFile zip_file, const std::string& filename);
+  UnZipFile(unzFile zip_file, const std::string& filename, const unz64_file_pos* pos);
 
  public:
   ~UnZipFile();
@@ -20,6 +23,17 @@ class UnZipFile {
   std::string ReadString();
   void ReadInto(void* buf, std::size_t len);
 
+  // Size of the entry's contents.
+  std::uint64_t size() const { return fi_.uncompressed_size; }
+
+  // True when the entry is stored without compression, so its bytes live
+  // contiguously in the archive file and can be read (or mapped) directly.
+  bool IsStored() const { return fi_.compression_method == 0; }
+
+  // Offset of the next unread content byte from the start of the archive
+  // file.  Only meaningful for stored entries.
+  std::uint64_t FileOffset() const;
+
  private:
   unzFile zip_file_;
   unz_file_info64 fi_;
@@ -33,8 +47,21 @@ class UnZipArchive {
   bool Exist(const std::string& filename);
   UnZipFile OpenFile(const std::string& filename);
 
+  // Names of every entry in the archive, in directory order.
+  std::vector<std::string> Entries();
+
+  const std::string& path() const { return path_; }
+
  private:
+  // Builds the entry index on first use: one walk of the central directory,
+  // after which every lookup seeks straight to its entry instead of
+  // rescanning the directory per open.
+  void EnsureIndex();
+
   unzFile zip_file_;
+  std::string path_;
+  bool indexed_ = false;
+  std::map<std::string, unz64_file_pos> index_;
 };
 
 }  // namespace vertexai
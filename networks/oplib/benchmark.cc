@@ -0,0 +1,115 @@
+// Copyright 2019, Intel Corporation
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "base/util/env.h"
+#include "networks/oplib/oplib.h"
+#include "plaidml2/exec/exec.h"
+#include "plaidml2/op/op.h"
+
+// Benchmark suite over the parameterized builders in oplib.h, for A/B-ing
+// codegen changes on realistic topologies.  Each benchmark compiles once,
+// runs a fixed warmup to reach steady state (first runs pay for lazy driver
+// work and caches), then reports per-iteration wall time via manual timing
+// along with p50/p90/p99 latency counters.
+//
+// Set PLAIDML_BENCH_KERNEL_PROFILE=1 to also dump a per-kernel breakdown of
+// the steady-state iterations after each benchmark.
+
+namespace edsl = plaidml::edsl;
+namespace exec = plaidml::exec;
+
+namespace networks::oplib {
+
+namespace {
+
+constexpr size_t kWarmupRuns = 3;
+
+bool kernel_profile_enabled() {  //
+  return vertexai::env::Get("PLAIDML_BENCH_KERNEL_PROFILE") == "1";
+}
+
+double percentile(const std::vector<double>& sorted, double pct) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto rank = static_cast<size_t>(pct * (sorted.size() - 1));
+  return sorted[rank];
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void run_steady_state(benchmark::State& state, const edsl::Program& program, const std::string& name) {
+  auto executable = exec::Binder(program).compile();
+  for (size_t i = 0; i < kWarmupRuns; i++) {
+    executable->run();
+  }
+  if (kernel_profile_enabled()) {
+    exec::clear_kernel_profile();
+    exec::enable_kernel_profile(true);
+  }
+  std::vector<double> latencies;
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    executable->run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    state.SetIterationTime(elapsed.count());
+    latencies.push_back(elapsed.count() * 1e3);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  state.counters["p50_ms"] = percentile(latencies, 0.50);
+  state.counters["p90_ms"] = percentile(latencies, 0.90);
+  state.counters["p99_ms"] = percentile(latencies, 0.99);
+  state.SetItemsProcessed(state.iterations());
+  if (kernel_profile_enabled()) {
+    exec::enable_kernel_profile(false);
+    std::cerr << "=== kernel profile: " << name << " ===\n" << exec::kernel_profile();
+  }
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void BM_Resnet50(benchmark::State& state) {
+  plaidml::op::init();
+  run_steady_state(state, BuildResnet50(state.range(0)), "resnet50");
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void BM_Resnet101(benchmark::State& state) {
+  plaidml::op::init();
+  run_steady_state(state, BuildResnet101(state.range(0)), "resnet101");
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void BM_Resnet152(benchmark::State& state) {
+  plaidml::op::init();
+  run_steady_state(state, BuildResnet152(state.range(0)), "resnet152");
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void BM_Mobilenet(benchmark::State& state) {
+  plaidml::op::init();
+  run_steady_state(state, BuildMobilenet(state.range(0)), "mobilenet");
+}
+
+// NOLINTNEXTLINE[runtime/references]
+void BM_Transformer(benchmark::State& state) {
+  plaidml::op::init();
+  run_steady_state(state,  //
+                   BuildTransformer(state.range(0), /*seq_len=*/128, /*d_model=*/512, /*num_heads=*/8),
+                   "transformer");
+}
+
+BENCHMARK(BM_Resnet50)->Unit(benchmark::kMillisecond)->UseManualTime()->Arg(1)->Arg(8);
+BENCHMARK(BM_Resnet101)->Unit(benchmark::kMillisecond)->UseManualTime()->Arg(1);
+BENCHMARK(BM_Resnet152)->Unit(benchmark::kMillisecond)->UseManualTime()->Arg(1);
+BENCHMARK(BM_Mobilenet)->Unit(benchmark::kMillisecond)->UseManualTime()->Arg(1)->Arg(8);
+BENCHMARK(BM_Transformer)->Unit(benchmark::kMillisecond)->UseManualTime()->Arg(1)->Arg(8);
+
+}  // namespace
+
+}  // namespace networks::oplib
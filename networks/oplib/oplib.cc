@@ -0,0 +1,257 @@
+// Copyright 2019, Intel Corporation
+
+#include "networks/oplib/oplib.h"
+
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include "plaidml2/op/op.h"
+
+namespace edsl = plaidml::edsl;
+namespace op = plaidml::op;
+
+namespace networks::oplib {
+
+namespace {
+
+edsl::Tensor conv(                    //
+    const edsl::Tensor& I,            //
+    const edsl::Tensor& W,            //
+    const std::vector<int>& strides,  //
+    const std::string& autopadding,   //
+    const std::string& name) {
+  return op::convolution(  //
+      I,                   // input
+      W,                   // weights
+      strides,             // strides
+      {1, 1},              // dilations
+      {1, 1},              // data dilations
+      {},                  // filter shape (ie for transposed)
+      1,                   // # of groups
+      autopadding,         // autopadding
+      {},                  // manual padding
+      "nxc",               // input layout
+      "xck",               // filter layout
+      "none",              // group layout
+      false,               // Winograd OK?
+      name,                // name
+      "ungrouped",         // autogroup (ie for grouped)
+      "none",              // deriv (ie for transposed)
+      {});
+}
+
+edsl::Tensor depthwise_conv(          //
+    const edsl::Tensor& I,            //
+    const edsl::Tensor& W,            //
+    const std::vector<int>& strides,  //
+    const std::string& name) {
+  return op::convolution(  //
+      I,                   // input
+      W,                   // weights
+      strides,             // strides
+      {1, 1},              // dilations
+      {1, 1},              // data dilations
+      {},                  // filter shape (ie for transposed)
+      1,                   // # of groups
+      "same_upper",        // autopadding
+      {},                  // manual padding
+      "nxc",               // input layout
+      "xck",               // filter layout
+      "in_C",              // group layout
+      false,               // Winograd OK?
+      name,                // name
+      "max",               // autogroup: one group per input channel
+      "none",              // deriv (ie for transposed)
+      {});
+}
+
+edsl::Tensor f32(const std::vector<int64_t>& dims) {  //
+  return edsl::Placeholder(PLAIDML_DATA_FLOAT32, dims);
+}
+
+edsl::Tensor bottleneck_block(        //
+    const edsl::Tensor& I,            //
+    int64_t in_channels,              //
+    int64_t mid_channels,             //
+    int64_t out_channels,             //
+    const std::vector<int>& strides,  //
+    bool use_shortcut_conv,           //
+    const std::string& base_name) {
+  auto W_2a = f32({1, 1, in_channels, mid_channels});
+  auto B_2a = f32({mid_channels});
+  edsl::Tensor relu_2a = op::relu(conv(I, W_2a, strides, "valid", base_name + "_branch2a") + B_2a);
+
+  auto W_2b = f32({3, 3, mid_channels, mid_channels});
+  auto B_2b = f32({mid_channels});
+  edsl::Tensor relu_2b = op::relu(conv(relu_2a, W_2b, {1, 1}, "same_upper", base_name + "_branch2b") + B_2b);
+
+  auto W_2c = f32({1, 1, mid_channels, out_channels});
+  auto B_2c = f32({out_channels});
+  auto conv_2c = conv(relu_2b, W_2c, {1, 1}, "valid", base_name + "_branch2c");
+
+  if (use_shortcut_conv) {
+    auto W_1 = f32({1, 1, in_channels, out_channels});
+    auto B_1 = f32({out_channels});
+    auto conv_1 = conv(I, W_1, strides, "valid", base_name + "_branch1");
+    return op::relu(conv_2c + B_2c + conv_1 + B_1);
+  }
+  return op::relu(conv_2c + B_2c + I);
+}
+
+edsl::Tensor separable_block(  //
+    const edsl::Tensor& I,     //
+    int64_t in_channels,       //
+    int64_t out_channels,      //
+    const std::vector<int>& strides, const std::string& base_name) {
+  auto W_dw = f32({3, 3, in_channels, 1});
+  auto B_dw = f32({in_channels});
+  edsl::Tensor relu_dw = op::relu(depthwise_conv(I, W_dw, strides, base_name + "_dw") + B_dw);
+
+  auto W_pw = f32({1, 1, in_channels, out_channels});
+  auto B_pw = f32({out_channels});
+  return op::relu(conv(relu_dw, W_pw, {1, 1}, "valid", base_name + "_pw") + B_pw);
+}
+
+}  // namespace
+
+edsl::Program BuildResnet(int64_t batch_size, const std::vector<int>& stage_blocks) {
+  if (stage_blocks.size() != 4) {
+    throw std::runtime_error("BuildResnet requires exactly 4 stage block counts");
+  }
+  auto I = edsl::Placeholder(PLAIDML_DATA_FLOAT32, {batch_size, 224, 224, 3});
+
+  auto W_conv1 = f32({7, 7, 3, 64});
+  auto B_conv1 = f32({64});
+  auto conv1 = op::convolution(  //
+      I,                         // input
+      W_conv1,                   // weights
+      {2, 2},                    // strides
+      {1, 1},                    // dilations
+      {1, 1},                    // data dilations
+      {},                        // filter shape (ie for transposed)
+      1,                         // # of groups
+      "none",                    // autopadding
+      {3, 3},                    // manual padding
+      "nxc",                     // input layout
+      "xck",                     // filter layout
+      "none",                    // group layout
+      false,                     // Winograd OK?
+      "conv1",                   // name
+      "ungrouped",               // autogroup (ie for grouped)
+      "none",                    // deriv (ie for transposed)
+      {});
+  edsl::Tensor relu1 = op::relu(conv1 + B_conv1);
+  auto X = op::pool(  //
+      relu1,          // input
+      "max",          // pool mode
+      {3, 3},         // pool shape
+      {2, 2},         // strides
+      "none",         // autopadding
+      {1, 1},         // manual padding
+      "nxc");         // input layout
+
+  int64_t in_channels = 64;
+  for (size_t stage = 0; stage < stage_blocks.size(); stage++) {
+    int64_t mid_channels = 64 << stage;
+    int64_t out_channels = 256 << stage;
+    std::vector<int> first_strides = stage == 0 ? std::vector<int>{1, 1} : std::vector<int>{2, 2};
+    for (int i = 0; i < stage_blocks[stage]; i++) {
+      auto name = "res" + std::to_string(stage + 2) + std::string(1, 'a' + i);
+      if (i == 0) {
+        X = bottleneck_block(X, in_channels, mid_channels, out_channels, first_strides, true, name);
+      } else {
+        X = bottleneck_block(X, out_channels, mid_channels, out_channels, {1, 1}, false, name);
+      }
+    }
+    in_channels = out_channels;
+  }
+
+  auto global_mean = op::mean(X, edsl::make_tuple<int64_t>({1, 2}));
+  auto W_dense = f32({in_channels, 1000});
+  auto B_dense = f32({1000});
+  auto dense = op::dot(global_mean, W_dense) + B_dense;
+  auto softmax = op::softmax(dense, 1);
+  return edsl::Program("resnet", {softmax});
+}
+
+edsl::Program BuildMobilenet(int64_t batch_size) {
+  auto I = edsl::Placeholder(PLAIDML_DATA_FLOAT32, {batch_size, 224, 224, 3});
+
+  auto W_conv1 = f32({3, 3, 3, 32});
+  auto B_conv1 = f32({32});
+  edsl::Tensor X = op::relu(conv(I, W_conv1, {2, 2}, "same_upper", "conv1") + B_conv1);
+
+  // (output channels, stride) for each depthwise-separable block.
+  const std::vector<std::pair<int64_t, int>> blocks = {
+      {64, 1},  {128, 2}, {128, 1}, {256, 2},  {256, 1},  {512, 2},  {512, 1},
+      {512, 1}, {512, 1}, {512, 1}, {512, 1},  {1024, 2}, {1024, 1},
+  };
+  int64_t in_channels = 32;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    auto name = "block" + std::to_string(i + 1);
+    X = separable_block(X, in_channels, blocks[i].first, {blocks[i].second, blocks[i].second}, name);
+    in_channels = blocks[i].first;
+  }
+
+  auto global_mean = op::mean(X, edsl::make_tuple<int64_t>({1, 2}));
+  auto W_dense = f32({in_channels, 1000});
+  auto B_dense = f32({1000});
+  auto dense = op::dot(global_mean, W_dense) + B_dense;
+  auto softmax = op::softmax(dense, 1);
+  return edsl::Program("mobilenet", {softmax});
+}
+
+edsl::Program BuildTransformer(int64_t batch_size, int64_t seq_len, int64_t d_model, int64_t num_heads) {
+  if (d_model % num_heads != 0) {
+    throw std::runtime_error("BuildTransformer requires d_model divisible by num_heads");
+  }
+  int64_t head_dim = d_model / num_heads;
+
+  auto X = edsl::Placeholder(PLAIDML_DATA_FLOAT32, {batch_size, seq_len, d_model});
+  auto W_q = f32({d_model, num_heads, head_dim});
+  auto W_k = f32({d_model, num_heads, head_dim});
+  auto W_v = f32({d_model, num_heads, head_dim});
+  auto W_o = f32({num_heads, head_dim, d_model});
+  auto W_ff1 = f32({d_model, 4 * d_model});
+  auto B_ff1 = f32({4 * d_model});
+  auto W_ff2 = f32({4 * d_model, d_model});
+  auto B_ff2 = f32({d_model});
+
+  edsl::TensorDim B, S, D, H, DH, F;
+  X.bind_dims(B, S, D);
+  W_q.bind_dims(D, H, DH);
+  W_ff1.bind_dims(D, F);
+  edsl::TensorIndex b, s, t, d, h, e, f;
+
+  // Per-head projections.
+  auto Q = edsl::TensorOutput(B, H, S, DH);
+  Q(b, h, s, d) += X(b, s, e) * W_q(e, h, d);
+  auto K = edsl::TensorOutput(B, H, S, DH);
+  K(b, h, s, d) += X(b, s, e) * W_k(e, h, d);
+  auto V = edsl::TensorOutput(B, H, S, DH);
+  V(b, h, s, d) += X(b, s, e) * W_v(e, h, d);
+
+  // Scaled dot-product attention.
+  auto scores = edsl::TensorOutput(B, H, S, S);
+  scores(b, h, s, t) += Q(b, h, s, d) * K(b, h, t, d);
+  auto probs = op::softmax(scores * (1.0 / std::sqrt(static_cast<double>(head_dim))), 3);
+  auto attended = edsl::TensorOutput(B, H, S, DH);
+  attended(b, h, s, d) += probs(b, h, s, t) * V(b, h, t, d);
+
+  // Re-project the concatenated heads and apply the residual connection.
+  auto projected = edsl::TensorOutput(B, S, D);
+  projected(b, s, e) += attended(b, h, s, d) * W_o(h, d, e);
+  auto attn_out = X + projected;
+
+  // Position-wise feed-forward network with a residual connection.
+  auto ff1 = edsl::TensorOutput(B, S, F);
+  ff1(b, s, f) += attn_out(b, s, e) * W_ff1(e, f);
+  edsl::Tensor ff1_act = op::relu(ff1 + B_ff1);
+  auto ff2 = edsl::TensorOutput(B, S, D);
+  ff2(b, s, e) += ff1_act(b, s, f) * W_ff2(f, e);
+  auto out = attn_out + ff2 + B_ff2;
+  return edsl::Program("transformer", {out});
+}
+
+}  // namespace networks::oplib
@@ -0,0 +1,36 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include <vector>
+
+#include "plaidml2/edsl/edsl.h"
+
+// Parameterized network builders used by the oplib benchmark suite.  Each
+// builder returns a Program over fresh placeholders; callers compile and run
+// it via plaidml2/exec.  plaidml::op::init() must be called first.
+
+namespace networks::oplib {
+
+// A bottleneck-style resnet with the given number of residual blocks per
+// stage.  {3, 4, 6, 3} is resnet50, {3, 4, 23, 3} is resnet101, and
+// {3, 8, 36, 3} is resnet152.
+plaidml::edsl::Program BuildResnet(int64_t batch_size, const std::vector<int>& stage_blocks);
+
+inline plaidml::edsl::Program BuildResnet50(int64_t batch_size) { return BuildResnet(batch_size, {3, 4, 6, 3}); }
+inline plaidml::edsl::Program BuildResnet101(int64_t batch_size) { return BuildResnet(batch_size, {3, 4, 23, 3}); }
+inline plaidml::edsl::Program BuildResnet152(int64_t batch_size) { return BuildResnet(batch_size, {3, 8, 36, 3}); }
+
+// Mobilenet v1: a 3x3 stem followed by 13 depthwise-separable blocks, global
+// pooling, and a dense classifier.  Exercises depthwise (grouped) convolution
+// codegen, which has a very different compute/bandwidth profile from the
+// resnet bottlenecks.
+plaidml::edsl::Program BuildMobilenet(int64_t batch_size);
+
+// A single transformer encoder block: multi-head self-attention plus a
+// position-wise feed-forward network, with residual connections.  Built from
+// raw edsl contractions, so it exercises batched matmul and softmax codegen
+// rather than the convolution paths.  d_model must be divisible by num_heads.
+plaidml::edsl::Program BuildTransformer(int64_t batch_size, int64_t seq_len, int64_t d_model, int64_t num_heads);
+
+}  // namespace networks::oplib
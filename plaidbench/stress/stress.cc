@@ -0,0 +1,309 @@
+// Copyright 2019 Intel Corporation.
+//
+// Throughput stress harness: drives one compiled network through N
+// concurrent executors to measure how far the device is from saturation.
+// The frontend benchmarks are single-stream -- one batch in flight at a
+// time -- which undersells devices with enough parallelism to overlap
+// several batches.  Here every worker holds its own Executable and
+// buffers over a single shared Program, so compilation happens once and
+// the schedules race only on the device queue.
+//
+// Load is open-loop when --rate is given: request i is due at start +
+// i/rate regardless of how fast earlier requests finished, and latency is
+// measured from that due time, so queueing delay under overload shows up
+// in the tail instead of being hidden by back-pressure.  With no --rate
+// each worker runs back-to-back (closed loop), which measures peak
+// throughput instead.
+//
+// Usage: stress [--threads=N] [--seconds=S] [--rate=R]
+//               [--batch=B] [--dim=D] [--layers=L]
+//               [--device=DEV] [--target=TGT] [--profile]
+//
+// Output: per-stage setup times, total throughput, and a latency
+// histogram with p50/p90/p99 drawn from log-spaced buckets.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "plaidml2/core/core.h"
+#include "plaidml2/edsl/edsl.h"
+#include "plaidml2/exec/exec.h"
+
+namespace {
+
+using plaidml::Buffer;
+using plaidml::TensorShape;
+namespace edsl = plaidml::edsl;
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::duration d) {  //
+  return std::chrono::duration<double>(d).count();
+}
+
+edsl::Tensor Dot(const edsl::Tensor& X, const edsl::Tensor& Y) {
+  edsl::TensorDim I, J, K;
+  edsl::TensorIndex i, j, k;
+  X.bind_dims(I, K);
+  Y.bind_dims(K, J);
+  auto R = edsl::TensorOutput(I, J);
+  R(i, j) += X(i, k) * Y(k, j);
+  return R;
+}
+
+edsl::Tensor Relu(const edsl::Tensor& I) {  //
+  return edsl::select(I < 0.0, edsl::Tensor{0.0}, I);
+}
+
+// Latency histogram over log-spaced buckets: bucket b covers
+// [2^(b/4), 2^((b+1)/4)) microseconds, ~19% wide, which is plenty for
+// tail percentiles without per-sample storage.
+struct Histogram {
+  static constexpr size_t kBuckets = 128;
+
+  std::vector<uint64_t> counts = std::vector<uint64_t>(kBuckets, 0);
+  uint64_t total = 0;
+
+  static size_t BucketOf(double usecs) {
+    if (usecs < 1.0) {
+      return 0;
+    }
+    auto b = static_cast<size_t>(4.0 * std::log2(usecs));
+    return std::min(b, kBuckets - 1);
+  }
+
+  void Add(double usecs) {
+    counts[BucketOf(usecs)]++;
+    total++;
+  }
+
+  void Merge(const Histogram& other) {
+    for (size_t b = 0; b < kBuckets; b++) {
+      counts[b] += other.counts[b];
+    }
+    total += other.total;
+  }
+
+  // Upper edge of the bucket holding the q'th quantile sample.
+  double Quantile(double q) const {
+    uint64_t rank = static_cast<uint64_t>(q * total);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; b++) {
+      seen += counts[b];
+      if (seen > rank) {
+        return std::exp2((b + 1) / 4.0);
+      }
+    }
+    return std::exp2(kBuckets / 4.0);
+  }
+};
+
+struct Options {
+  size_t threads = 4;
+  double seconds = 10.0;
+  double rate = 0.0;  // requests/sec across all workers; 0 = closed loop
+  int64_t batch = 16;
+  int64_t dim = 512;
+  size_t layers = 4;
+  std::string device;
+  std::string target;
+  bool profile = false;
+};
+
+bool ParseFlag(const std::string& arg, const char* name, std::string* out) {
+  std::string prefix = std::string("--") + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  *out = arg.substr(prefix.size());
+  return true;
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options opts;
+  opts.device = plaidml::Settings::get("PLAIDML_DEVICE");
+  opts.target = plaidml::Settings::get("PLAIDML_TARGET");
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    std::string value;
+    if (ParseFlag(arg, "threads", &value)) {
+      opts.threads = std::stoul(value);
+    } else if (ParseFlag(arg, "seconds", &value)) {
+      opts.seconds = std::stod(value);
+    } else if (ParseFlag(arg, "rate", &value)) {
+      opts.rate = std::stod(value);
+    } else if (ParseFlag(arg, "batch", &value)) {
+      opts.batch = std::stoll(value);
+    } else if (ParseFlag(arg, "dim", &value)) {
+      opts.dim = std::stoll(value);
+    } else if (ParseFlag(arg, "layers", &value)) {
+      opts.layers = std::stoul(value);
+    } else if (ParseFlag(arg, "device", &value)) {
+      opts.device = value;
+    } else if (ParseFlag(arg, "target", &value)) {
+      opts.target = value;
+    } else if (arg == "--profile") {
+      opts.profile = true;
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  return opts;
+}
+
+struct WorkerResult {
+  Histogram latencies;
+  uint64_t runs = 0;
+  double compile_secs = 0.0;
+  double alloc_secs = 0.0;
+};
+
+void FillRandom(Buffer* buffer, std::mt19937* gen) {
+  auto view = buffer->mmap_discard();
+  auto* data = reinterpret_cast<float*>(view.data());
+  std::uniform_real_distribution<float> dist(-1.0, 1.0);
+  size_t count = view.size() / sizeof(float);
+  for (size_t i = 0; i < count; i++) {
+    data[i] = dist(*gen);
+  }
+  view.writeback();
+}
+
+void Worker(const Options& opts,                  //
+            const edsl::Program& program,         //
+            const std::vector<edsl::Tensor>& inputs,  //
+            const edsl::Tensor& output,           //
+            Clock::time_point start,              //
+            std::atomic<uint64_t>* next_arrival,  //
+            std::atomic<bool>* done,              //
+            size_t seed,                          //
+            WorkerResult* result) {
+  // Per-worker buffers: the Program is shared, the bindings are not, so
+  // concurrent runs never alias each other's data.
+  std::mt19937 gen(seed);
+  auto alloc_start = Clock::now();
+  TensorShape io_shape(PLAIDML_DATA_FLOAT32, {opts.batch, opts.dim});
+  TensorShape weight_shape(PLAIDML_DATA_FLOAT32, {opts.dim, opts.dim});
+  std::vector<plaidml::exec::Binding> input_bindings;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    Buffer buffer(opts.device, i == 0 ? io_shape : weight_shape);
+    FillRandom(&buffer, &gen);
+    input_bindings.emplace_back(plaidml::exec::Binding{inputs[i], buffer});
+  }
+  Buffer output_buffer(opts.device, io_shape);
+  std::vector<plaidml::exec::Binding> output_bindings = {{output, output_buffer}};
+  result->alloc_secs = Seconds(Clock::now() - alloc_start);
+
+  auto compile_start = Clock::now();
+  plaidml::exec::Executable exe(program, opts.device, opts.target, input_bindings, output_bindings);
+  result->compile_secs = Seconds(Clock::now() - compile_start);
+  exe.run();  // warmup; JIT and first-touch costs land here, not in the histogram
+
+  while (!done->load(std::memory_order_relaxed)) {
+    Clock::time_point due = Clock::now();
+    if (opts.rate > 0.0) {
+      // Claim the next slot in the global arrival schedule and wait for
+      // it; falling behind just means the wait is zero and the lateness
+      // is charged to this request's latency.
+      uint64_t slot = next_arrival->fetch_add(1, std::memory_order_relaxed);
+      due = start + std::chrono::duration_cast<Clock::duration>(  //
+                        std::chrono::duration<double>(slot / opts.rate));
+      std::this_thread::sleep_until(due);
+      if (done->load(std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    exe.run();
+    result->latencies.Add(Seconds(Clock::now() - due) * 1e6);
+    result->runs++;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  auto opts = ParseOptions(argc, argv);
+  plaidml::exec::init();
+  plaidml::edsl::init();
+
+  std::cout << "device=" << opts.device << " target=" << opts.target  //
+            << " threads=" << opts.threads << " batch=" << opts.batch  //
+            << " dim=" << opts.dim << " layers=" << opts.layers;
+  if (opts.rate > 0.0) {
+    std::cout << " rate=" << opts.rate << "/s (open loop)";
+  } else {
+    std::cout << " (closed loop)";
+  }
+  std::cout << std::endl;
+
+  // One shared Program: a stack of Dot+Relu layers, the shape of the work
+  // most frontend networks reduce to once convolutions are lowered.
+  auto build_start = Clock::now();
+  std::vector<edsl::Tensor> inputs;
+  inputs.push_back(edsl::Placeholder(PLAIDML_DATA_FLOAT32, {opts.batch, opts.dim}, "X"));
+  auto T = inputs[0];
+  for (size_t l = 0; l < opts.layers; l++) {
+    auto W = edsl::Placeholder(PLAIDML_DATA_FLOAT32, {opts.dim, opts.dim}, "W" + std::to_string(l));
+    inputs.push_back(W);
+    T = Relu(Dot(T, W));
+  }
+  edsl::Program program("stress", {T});
+  double build_secs = Seconds(Clock::now() - build_start);
+
+  if (opts.profile) {
+    plaidml::exec::enable_kernel_profile();
+  }
+
+  std::atomic<uint64_t> next_arrival{0};
+  std::atomic<bool> done{false};
+  std::vector<WorkerResult> results(opts.threads);
+  std::vector<std::thread> workers;
+  auto start = Clock::now();
+  for (size_t i = 0; i < opts.threads; i++) {
+    workers.emplace_back(Worker, std::cref(opts), std::cref(program), std::cref(inputs), std::cref(T),  //
+                         start, &next_arrival, &done, i + 1, &results[i]);
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(opts.seconds));
+  done.store(true, std::memory_order_relaxed);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  double elapsed = Seconds(Clock::now() - start);
+
+  Histogram merged;
+  uint64_t runs = 0;
+  double compile_secs = 0.0;
+  double alloc_secs = 0.0;
+  for (const auto& result : results) {
+    merged.Merge(result.latencies);
+    runs += result.runs;
+    compile_secs = std::max(compile_secs, result.compile_secs);
+    alloc_secs = std::max(alloc_secs, result.alloc_secs);
+  }
+
+  std::cout << "setup: build " << build_secs << "s, compile " << compile_secs  //
+            << "s, alloc " << alloc_secs << "s (worst worker)" << std::endl;
+  std::cout << "runs: " << runs << " in " << elapsed << "s = "  //
+            << (runs / elapsed) << " runs/s, "                  //
+            << (runs * opts.batch / elapsed) << " samples/s" << std::endl;
+  if (merged.total) {
+    std::cout << "latency: p50 " << merged.Quantile(0.5) / 1e3    //
+              << "ms, p90 " << merged.Quantile(0.9) / 1e3         //
+              << "ms, p99 " << merged.Quantile(0.99) / 1e3 << "ms" << std::endl;
+  }
+  if (opts.profile) {
+    std::cout << "kernel profile (kname runs exec_ns queue_wait_ns bytes_moved):" << std::endl;
+    std::cout << plaidml::exec::kernel_profile();
+  }
+  return 0;
+}
@@ -667,6 +667,22 @@ class _Library(plaidml.library.Library):
             ctypes.POINTER(_C_Applier)  # plaidml_applier* applier
         ]
 
+        # PLAIDML_API bool plaidml_apply_op_list(size_t oplist_size, const char* oplist,
+        #                                        size_t nvars, plaidml_var** vars,
+        #                                        size_t nouts, const char** out_names, plaidml_var** out_vars);
+        self.plaidml_apply_op_list = lib.plaidml_apply_op_list
+        self.plaidml_apply_op_list.argtypes = [
+            ctypes.c_size_t,  # size_t oplist_size
+            ctypes.c_char_p,  # const char* oplist
+            ctypes.c_size_t,  # size_t nvars
+            ctypes.POINTER(ctypes.POINTER(_C_Var)),  # plaidml_var** vars
+            ctypes.c_size_t,  # size_t nouts
+            ctypes.POINTER(ctypes.c_char_p),  # const char** out_names
+            ctypes.POINTER(ctypes.POINTER(_C_Var))  # plaidml_var** out_vars
+        ]
+        self.plaidml_apply_op_list.restype = ctypes.c_bool
+        self.plaidml_apply_op_list.errcheck = self._check_err
+
         # PLAIDML_API plaidml_invoker* plaidml_alloc_invoker(vai_ctx* ctx, plaidml_function* function);
         self.plaidml_alloc_invoker = lib.plaidml_alloc_invoker
         self.plaidml_alloc_invoker.argtypes = [
@@ -700,6 +716,16 @@ class _Library(plaidml.library.Library):
         self.plaidml_save_invoker.restype = ctypes.c_bool
         self.plaidml_save_invoker.errcheck = self._check_err
 
+        # PLAIDML_API plaidml_invoker* plaidml_load_invoker(vai_ctx* ctx, plaidml_device* dev, const char* file);
+        self.plaidml_load_invoker = lib.plaidml_load_invoker
+        self.plaidml_load_invoker.argtypes = [
+            ctypes.POINTER(plaidml.library._C_Context),  # vai_ctx* ctx
+            ctypes.POINTER(_C_Device),  # plaidml_device* dev
+            ctypes.c_char_p,  # const char* file
+        ]
+        self.plaidml_load_invoker.restype = ctypes.POINTER(_C_Invoker)
+        self.plaidml_load_invoker.errcheck = self._check_err
+
         # PLAIDML_API bool plaidml_set_invoker_input(plaidml_invoker* invoker, const char* name, plaidml_var* var);
         self.plaidml_set_invoker_input = lib.plaidml_set_invoker_input
         self.plaidml_set_invoker_input.argtypes = [
@@ -1412,6 +1438,24 @@ class Applier(object):
         return Var(_lib().plaidml_apply_alloc_output(self, name.encode()))
 
 
+def apply_op_list(oplist, input_vars=(), output_names=()):
+    """Applies a batch of function applications in a single FFI call.
+
+    oplist is a serialized vertexai.plaidml.proto.OpList, built client-side;
+    each op's inputs bind either a value produced by an earlier op in the
+    batch or an entry of input_vars (by index).  Returns one Var for each
+    name in output_names.  This replaces one Applier round trip per op when
+    constructing large graphs.
+    """
+    input_vars = [_as_plaidml_var(v) for v in input_vars]
+    vars_array = (ctypes.POINTER(_C_Var) * len(input_vars))(*[v._as_parameter_ for v in input_vars])
+    names_array = (ctypes.c_char_p * len(output_names))(*[n.encode() for n in output_names])
+    out_array = (ctypes.POINTER(_C_Var) * len(output_names))()
+    _lib().plaidml_apply_op_list(len(oplist), oplist, len(input_vars), vars_array, len(output_names), names_array,
+                                 out_array)
+    return [Var(out_array[i]) for i in range(len(output_names))]
+
+
 class Composer(object):
 
     def __init__(self):
@@ -1478,6 +1522,18 @@ class Invoker(object):
         _lib().plaidml_save_invoker(self, filename.encode(), 1)
 
 
+def load_invoker(ctx, device, filename):
+    """Restores an Invoker saved with Invoker.save, skipping recomposition.
+
+    Input and output bindings must still be set before invoking.
+    """
+    invoker = Invoker.__new__(Invoker)
+    invoker._as_parameter_ = _lib().plaidml_load_invoker(ctx, device._as_parameter_, filename.encode())
+    invoker._free = _lib().plaidml_free_invoker
+    invoker._ctx = ctx
+    return invoker
+
+
 class Invocation(object):
 
     def __init__(self, ctx, invoker):
@@ -199,6 +199,14 @@ VAI_API void vai_cancel_ctx(vai_ctx* ctx);
 //   "@type": "type.vertex.ai/vertexai.eventing.file.proto.EventLog",
 //   "filename": "eventlog.gz"
 //
+// For always-on production instrumentation, the ring eventlog keeps the
+// most recent events in memory (optionally sampled) and only writes them
+// out when the log is flushed:
+//
+//   "@type": "type.vertex.ai/vertexai.eventing.ring.proto.EventLog",
+//   "filename": "eventlog.gz",
+//   "sample_rate": 16
+//
 // If the context already has an associated eventlog, that eventlog
 // will be finalized and closed asynchronously, once all asynchronous
 // activity using that eventlog has completed.
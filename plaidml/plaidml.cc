@@ -1234,6 +1234,72 @@ extern "C" plaidml_var* plaidml_apply_alloc_output(plaidml_applier* applier, con
 
 extern "C" void plaidml_free_applier(plaidml_applier* applier) { delete applier; }
 
+// Applies a serialized proto::OpList in one call; see plaidml.h.  This is the
+// batched equivalent of an alloc_applier/add_input/alloc_output sequence per
+// op, used by the Python bridges to keep graph construction from paying an
+// FFI round trip for every op.
+extern "C" bool plaidml_apply_op_list(size_t oplist_size, const char* oplist,  //
+                                      size_t nvars, plaidml_var** vars,       //
+                                      size_t nouts, const char** out_names, plaidml_var** out_vars) {
+  if (oplist == NULL || (nvars && vars == NULL) || (nouts && (out_names == NULL || out_vars == NULL))) {
+    vertexai::SetLastOOM();
+    return false;
+  }
+  try {
+    plaidml::proto::OpList ops;
+    if (!ops.ParseFromArray(oplist, oplist_size)) {
+      throw vertexai::error::InvalidArgument{"Unable to parse the serialized op list"};
+    }
+    std::map<std::string, std::shared_ptr<Value>> values;
+    for (const auto& op : ops.ops()) {
+      auto func = std::make_shared<BoundFunction>(op.code(), std::string{});
+      FunctionApplication apply{func};
+      for (const auto& input : op.inputs()) {
+        switch (input.source_case()) {
+          case plaidml::proto::OpInput::kValue: {
+            auto it = values.find(input.value());
+            if (it == values.end()) {
+              throw vertexai::error::InvalidArgument{"Op input refers to an undefined value: " + input.value()};
+            }
+            apply.SetInput(input.name(), it->second);
+            break;
+          }
+          case plaidml::proto::OpInput::kExternal: {
+            if (input.external() >= nvars || vars[input.external()] == NULL) {
+              throw vertexai::error::InvalidArgument{"Op input refers to an invalid external var"};
+            }
+            apply.SetInput(input.name(), vars[input.external()]->value);
+            break;
+          }
+          default:
+            throw vertexai::error::InvalidArgument{"Op input has no source: " + input.name()};
+        }
+      }
+      for (const auto& output : op.outputs()) {
+        values[output.value()] = apply.GetOutput(output.name());
+      }
+    }
+    std::vector<std::unique_ptr<plaidml_var>> results;
+    for (size_t i = 0; i < nouts; ++i) {
+      if (out_names[i] == NULL) {
+        throw vertexai::error::InvalidArgument{"Op list output names must be non-null"};
+      }
+      auto it = values.find(out_names[i]);
+      if (it == values.end()) {
+        throw vertexai::error::InvalidArgument{"Op list output was never produced: " + std::string{out_names[i]}};
+      }
+      results.emplace_back(std::make_unique<plaidml_var>(plaidml_var{it->second}));
+    }
+    for (size_t i = 0; i < nouts; ++i) {
+      out_vars[i] = results[i].release();
+    }
+  } catch (...) {
+    vertexai::SetLastException(std::current_exception());
+    return false;
+  }
+  return true;
+}
+
 // plaidml_invoker
 
 namespace {
@@ -1340,6 +1406,13 @@ std::map<std::string, ApplierParameterShape> ToApplierParameterShapes(
 }  // namespace
 
 struct plaidml_invoker {
+  // Guards the mutable bindings and the cached compiled state below.
+  // Invocation scheduling takes the mutex only long enough to snapshot the
+  // bindings and build (or fetch) the RunInfo; the actual compilation and
+  // run proceed on immutable snapshots, so concurrent invocations from
+  // multiple threads don't serialize on the invoker.
+  std::mutex mu;
+
   std::shared_ptr<BoundFunction> func;
   std::map<std::string, std::shared_ptr<Value>> inputs;
   std::map<std::string, std::shared_ptr<TensorValue>> outputs;
@@ -1357,9 +1430,13 @@ struct plaidml_invoker {
 
 namespace {
 
-void BuildInvokerRunInfo(plaidml_invoker* invoker, const std::string& name) {
+// Builds (or fetches from the cache) the RunInfo for the invoker's current
+// bindings.  Must be called with the invoker's mutex held; the returned
+// snapshot remains valid after the mutex is released, even if the invoker is
+// subsequently rebound.
+std::shared_ptr<RunInfo> BuildInvokerRunInfo(plaidml_invoker* invoker, const std::string& name) {
   if (invoker->runinfo) {
-    return;
+    return invoker->runinfo;
   }
   invoker->runinfo = invoker->runinfo_cache.Lookup(
       std::make_pair(ToApplierParameterShapes(invoker->inputs), ToApplierParameterShapes(invoker->outputs)),
@@ -1387,6 +1464,7 @@ void BuildInvokerRunInfo(plaidml_invoker* invoker, const std::string& name) {
         composer->Done();
         return std::make_shared<RunInfo>(composer->PrepareToRun(name));
       });
+  return invoker->runinfo;
 }
 
 }  // namespace
@@ -1423,12 +1501,16 @@ extern "C" bool plaidml_set_invoker_input(plaidml_invoker* invoker, const char*
         default:
           throw vertexai::error::InvalidArgument{"Invocation inputs must be tensors or constants"};
       }
+      std::lock_guard<std::mutex> lock{invoker->mu};
       invoker->inputs[name] = var->value;
+      invoker->applier_for_output_shape.reset();
+      invoker->runinfo.reset();
     } else {
+      std::lock_guard<std::mutex> lock{invoker->mu};
       invoker->inputs.erase(name);
+      invoker->applier_for_output_shape.reset();
+      invoker->runinfo.reset();
     }
-    invoker->applier_for_output_shape.reset();
-    invoker->runinfo.reset();
     return true;
   } catch (...) {
     vertexai::SetLastException(std::current_exception());
@@ -1442,6 +1524,7 @@ extern "C" plaidml_shape* plaidml_alloc_invoker_output_shape(plaidml_invoker* in
     return nullptr;
   }
   try {
+    std::lock_guard<std::mutex> lock{invoker->mu};
     if (!invoker->applier_for_output_shape) {
       invoker->applier_for_output_shape =
           invoker->applier_for_output_shape_cache.Lookup(ToApplierParameterShapes(invoker->inputs), [invoker]() {
@@ -1479,11 +1562,14 @@ extern "C" bool plaidml_set_invoker_output(plaidml_invoker* invoker, const char*
       if (var->value->type() != Value::TENSOR) {
         throw vertexai::error::InvalidArgument{"Invocation outputs must be tensors"};
       }
+      std::lock_guard<std::mutex> lock{invoker->mu};
       invoker->outputs[name] = std::dynamic_pointer_cast<TensorValue>(var->value);
+      invoker->runinfo.reset();
     } else {
+      std::lock_guard<std::mutex> lock{invoker->mu};
       invoker->outputs.erase(name);
+      invoker->runinfo.reset();
     }
-    invoker->runinfo.reset();
     return true;
   } catch (...) {
     vertexai::SetLastException(std::current_exception());
@@ -1492,6 +1578,7 @@ extern "C" bool plaidml_set_invoker_output(plaidml_invoker* invoker, const char*
 }
 
 extern "C" bool plaidml_set_invoker_const(plaidml_invoker* invoker) {
+  std::lock_guard<std::mutex> lock{invoker->mu};
   invoker->func->SetBoundConst();
   return true;
 }
@@ -1503,6 +1590,7 @@ extern "C" bool plaidml_save_invoker(plaidml_invoker* invoker, const char* filen
   }
 
   try {
+    std::lock_guard<std::mutex> lock{invoker->mu};
     auto path = boost::filesystem::path(filename);
     if (!boost::filesystem::exists(path.parent_path())) {
       boost::filesystem::create_directory(path.parent_path());
@@ -1529,8 +1617,8 @@ extern "C" bool plaidml_save_invoker(plaidml_invoker* invoker, const char* filen
     }
 
     // At this point, we're saving a Stripe file format.
-    BuildInvokerRunInfo(invoker, path.stem().string());
-    auto stripe = GenerateStripe(*invoker->runinfo);
+    auto runinfo = BuildInvokerRunInfo(invoker, path.stem().string());
+    auto stripe = GenerateStripe(*runinfo);
 
     std::ofstream file{path.string()};
 
@@ -1561,6 +1649,26 @@ extern "C" bool plaidml_save_invoker(plaidml_invoker* invoker, const char* filen
   }
 }
 
+extern "C" plaidml_invoker* plaidml_load_invoker(vai_ctx* ctx, plaidml_device* dev, const char* filename) {
+  if (!ctx || !dev || !filename) {
+    vertexai::SetLastOOM();
+    return nullptr;
+  }
+  try {
+    std::unique_ptr<plaidml_function> function{plaidml_load_function(ctx, dev, filename)};
+    if (!function) {
+      // plaidml_load_function has already recorded the failure.
+      return nullptr;
+    }
+    auto invoker = std::make_unique<plaidml_invoker>();
+    invoker->func = function->func;
+    return invoker.release();
+  } catch (...) {
+    vertexai::SetLastException(std::current_exception());
+    return nullptr;
+  }
+}
+
 // plaidml_invocation
 //
 // Currently, the actual invocation structure is a placeholder; it
@@ -1598,15 +1706,29 @@ extern "C" plaidml_invocation* plaidml_schedule_invocation(vai_ctx* ctx, plaidml
   context::Activity activity{ctx->activity.ctx(), "plaidml::invoker::ScheduleInvocation"};
   try {
     auto invocation = std::make_unique<plaidml_invocation>();
-    auto rundown = std::make_shared<context::Rundown>();
-    rundown->TryEnterGate(activity.ctx().gate());
-    BuildInvokerRunInfo(invoker, "invoker_program");
+    // No cancellation callback is needed here; a GateEntry holds the gate open over the run
+    // without the per-submission locking a Rundown registration would cost.
+    auto gate_entry = std::make_shared<context::GateEntry>();
+    gate_entry->TryEnterGate(activity.ctx().gate());
+
+    // Snapshot the bindings and the compiled state; everything after this
+    // point works on immutable data, so concurrent invocations (and even
+    // concurrent rebinding of the invoker) proceed without blocking on us.
+    std::shared_ptr<RunInfo> runinfo;
+    std::map<std::string, std::shared_ptr<Value>> inputs;
+    std::map<std::string, std::shared_ptr<TensorValue>> outputs;
+    {
+      std::lock_guard<std::mutex> lock{invoker->mu};
+      runinfo = BuildInvokerRunInfo(invoker, "invoker_program");
+      inputs = invoker->inputs;
+      outputs = invoker->outputs;
+    }
 
     // Gather up the appropriate buffers
     std::shared_ptr<Evaluator> evaluator;
 
-    auto in_buffers = BindBuffers(invoker->runinfo->input_buffers, invoker->inputs, &evaluator);
-    auto out_buffers = BindBuffers(invoker->runinfo->output_buffers, invoker->outputs, &evaluator);
+    auto in_buffers = BindBuffers(runinfo->input_buffers, inputs, &evaluator);
+    auto out_buffers = BindBuffers(runinfo->output_buffers, outputs, &evaluator);
 
     std::unordered_set<const tile::Buffer*> output_set;
     for (const auto& kv : out_buffers) {
@@ -1619,15 +1741,15 @@ extern "C" plaidml_invocation* plaidml_schedule_invocation(vai_ctx* ctx, plaidml
 
     tile::proto::Program prog;
     prog.set_dev_id(evaluator->get_id());
-    prog.set_code(invoker->runinfo->code);
-    for (const auto& kv : invoker->runinfo->input_shapes) {
+    prog.set_code(runinfo->code);
+    for (const auto& kv : runinfo->input_shapes) {
       auto& input = (*prog.mutable_inputs())[kv.first];
       *input.mutable_shape() = tile::IntoProto(kv.second);
       if (output_set.count(in_buffers[kv.first].get())) {
         input.set_consumed(true);
       }
     }
-    for (const auto& kv : invoker->runinfo->output_shapes) {
+    for (const auto& kv : runinfo->output_shapes) {
       *(*prog.mutable_outputs())[kv.first].mutable_shape() = tile::IntoProto(kv.second);
     }
 
@@ -1655,7 +1777,7 @@ extern "C" plaidml_invocation* plaidml_schedule_invocation(vai_ctx* ctx, plaidml
 
     tile::ConstBufferManager const_bufs;
     const_bufs.allocator = std::make_shared<PlatformAllocator>(*evaluator);
-    for (const auto& kvp : invoker->runinfo->input_shapes) {
+    for (const auto& kvp : runinfo->input_shapes) {
       if (kvp.second.is_const) {
         const_bufs.buffers[kvp.first] = in_buffers[kvp.first];
       }
@@ -1665,7 +1787,7 @@ extern "C" plaidml_invocation* plaidml_schedule_invocation(vai_ctx* ctx, plaidml
     // Run the program
     auto result = program->Run(activity.ctx(), in_buffers, out_buffers);
     result.then(boost::launch::async,
-                [rundown = std::move(rundown), program = std::move(program)](decltype(result) fut) {
+                [gate_entry = std::move(gate_entry), program = std::move(program)](decltype(result) fut) {
                   try {
                     fut.get();
                   } catch (const std::exception& ex) {
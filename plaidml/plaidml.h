@@ -445,6 +445,20 @@ PLAIDML_API plaidml_var* plaidml_apply_alloc_output(plaidml_applier* applier, co
 // subsequent calls.  Freeing a NULL applier is a no-op.
 PLAIDML_API void plaidml_free_applier(plaidml_applier* applier);
 
+// Applies a batch of function applications in a single call, avoiding one
+// FFI round trip per op during graph construction.
+//
+// oplist/oplist_size hold a serialized vertexai.plaidml.proto.OpList.  Each
+// op's code is built and applied in order; its inputs bind either a value
+// produced by an earlier op in the batch (by name) or an entry of the vars
+// array (by index).  After the last op, each name in out_names is looked up
+// among the batch's values and a var for it is written to the corresponding
+// slot of out_vars; the caller is responsible for calling plaidml_free_var()
+// on each.  On failure, returns false without writing any output vars.
+PLAIDML_API bool plaidml_apply_op_list(size_t oplist_size, const char* oplist,  //
+                                       size_t nvars, plaidml_var** vars,       //
+                                       size_t nouts, const char** out_names, plaidml_var** out_vars);
+
 // A PlaidML invoker provides a mechanism for scheduling runs of a
 // PlaidML function.
 //
@@ -454,10 +468,14 @@ PLAIDML_API void plaidml_free_applier(plaidml_applier* applier);
 // and must be dimensionally consistent with each other, at the time
 // the invoker is used to invoke the supplied function.
 //
-// Invokers are not threadsafe, and they are stateful; callers are
-// advised to synchronize concurrent access from the time the
-// invoker's inputs are set through to when the function has completed
-// running.
+// Invokers are threadsafe.  Binding calls are serialized with respect
+// to each other and to invocation scheduling, and each call to
+// plaidml_schedule_invocation snapshots the current bindings and the
+// compiled function state before running, so a fully-configured
+// invoker may be shared by any number of threads scheduling
+// invocations concurrently.  Callers that rebind inputs or outputs
+// between runs still need their own synchronization to ensure that a
+// particular run observes a consistent set of bindings.
 
 #ifdef __cplusplus
 struct plaidml_invoker;
@@ -513,6 +531,12 @@ PLAIDML_API bool plaidml_set_invoker_const(plaidml_invoker* invoker);
 // already be set to concrete values that are consistent in size.
 PLAIDML_API bool plaidml_save_invoker(plaidml_invoker* invoker, const char* filename, plaidml_file_format format);
 
+// Restores an invoker from a PLAIDML_FILE_FORMAT_TILE file written by
+// plaidml_save_invoker, recreating the composed function and its bound
+// tensors so a restarted session skips recomposition.  Input and output
+// bindings must still be set before the invoker can run.
+PLAIDML_API plaidml_invoker* plaidml_load_invoker(vai_ctx* ctx, plaidml_device* dev, const char* filename);
+
 // A PlaidML invocation describes one particular run of a function.
 #ifdef __cplusplus
 struct plaidml_invocation;
@@ -0,0 +1,138 @@
+// Copyright 2019 Intel Corporation.
+//
+// Multi-client stress test: drives a device from many threads at once to
+// exercise the documented invoker thread-safety guarantees, both with one
+// invoker shared across all threads and with an invoker per thread.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "base/util/logging.h"
+#include "plaidml/base/context.h"
+#include "plaidml/plaidml++.h"
+#include "testing/plaidml_config.h"
+
+using ::testing::Eq;
+
+namespace {
+
+using namespace vertexai::plaidml;  // NOLINT
+
+constexpr std::size_t kDim = 16;
+constexpr std::size_t kThreads = 8;
+constexpr std::size_t kRunsPerThread = 20;
+
+const char* kMatmulCode = R"(
+  function (A[I, K], B[K, J]) -> (O) {
+    O[i, j : I, J] = +(A[i, k] * B[k, j]);
+  }
+)";
+
+tensor<float> MakeRampTensor(const std::shared_ptr<vertexai::ctx>& ctx, device* dev) {
+  tensor<float> ret = dev->allocate(shape<float>(ctx, {kDim, kDim}));
+  mapping<float> view = ret.map(map_for_write);
+  for (size_t i = 0; i < kDim; i++) {
+    for (size_t j = 0; j < kDim; j++) {
+      view(i, j) = kDim * i + j;
+    }
+  }
+  return ret;
+}
+
+void CheckMatmulResult(tensor<float>* out) {
+  mapping<float> view = out->map(map_for_read);
+  for (size_t i = 0; i < kDim; i++) {
+    for (size_t j = 0; j < kDim; j++) {
+      float expected = 0.0;
+      for (size_t k = 0; k < kDim; k++) {
+        expected += (kDim * i + k) * (kDim * k + j);
+      }
+      ASSERT_THAT(view(i, j), Eq(expected)) << "at (" << i << ", " << j << ")";
+    }
+  }
+}
+
+// Many threads scheduling invocations through a single fully-configured
+// invoker.  Every run computes the same product, so any run's output is
+// valid no matter how the runs interleave.
+TEST(PlaidML_Stress, SharedInvoker) {
+  vai_clear_status();
+  auto ctx = std::make_shared<vertexai::ctx>();
+  auto devices = enumerate_devices(ctx, vertexai::testing::PlaidMLConfig());
+  ASSERT_THAT(devices.empty(), Eq(false));
+  device dev = devices[0].open();
+
+  function matmul(kMatmulCode);
+  tensor<float> in = MakeRampTensor(ctx, &dev);
+  tensor<float> out = dev.allocate(shape<float>(ctx, {kDim, kDim}));
+
+  invoker shared{ctx, matmul};
+  shared.set_input("A", in).set_input("B", in).set_output("O", out);
+
+  std::atomic<size_t> failures{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&]() {
+      for (size_t run = 0; run < kRunsPerThread; run++) {
+        try {
+          shared.invoke();
+        } catch (...) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(failures.load(), Eq(0));
+  CheckMatmulResult(&out);
+}
+
+// Each thread acts as an independent client with its own invoker and output
+// buffer against the same device and function; outputs are verified per
+// thread, so any cross-talk between clients shows up as a wrong product.
+TEST(PlaidML_Stress, InvokerPerThread) {
+  vai_clear_status();
+  auto ctx = std::make_shared<vertexai::ctx>();
+  auto devices = enumerate_devices(ctx, vertexai::testing::PlaidMLConfig());
+  ASSERT_THAT(devices.empty(), Eq(false));
+  device dev = devices[0].open();
+
+  function matmul(kMatmulCode);
+  tensor<float> in = MakeRampTensor(ctx, &dev);
+
+  std::atomic<size_t> failures{0};
+  std::vector<tensor<float>> outs;
+  for (size_t t = 0; t < kThreads; t++) {
+    outs.push_back(dev.allocate(shape<float>(ctx, {kDim, kDim})));
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      try {
+        invoker client{ctx, matmul};
+        client.set_input("A", in).set_input("B", in).set_output("O", outs[t]);
+        for (size_t run = 0; run < kRunsPerThread; run++) {
+          client.invoke();
+        }
+      } catch (...) {
+        failures++;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(failures.load(), Eq(0));
+  for (size_t t = 0; t < kThreads; t++) {
+    CheckMatmulResult(&outs[t]);
+  }
+}
+
+}  // namespace
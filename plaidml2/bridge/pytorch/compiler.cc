@@ -2,7 +2,10 @@
 
 #include "plaidml2/bridge/pytorch/compiler.h"
 
+#include <chrono>
+#include <cstdlib>
 #include <map>
+#include <utility>
 
 #include "plaidml2/bridge/pytorch/logging.h"
 #include "plaidml2/op/op.h"
@@ -471,9 +474,18 @@ std::map<Symbol, OpFunction> kSupportedOps = {
 const at::Symbol Compiler::symbol = Symbol::fromQualString("plaidml::CompilationGroup");
 
 Compiler::Compiler(const std::string& device_id, const std::string& target_id, const Node* node)
-    : device_id_(device_id),                //
-      target_id_(target_id),                //
-      subgraph_(node->g(attr::Subgraph)) {  //
+    : device_id_(device_id),              //
+      target_id_(target_id),              //
+      subgraph_(node->g(attr::Subgraph)),  //
+      capacity_(16) {
+  // Dynamic-shaped models can produce many argument specs per subgraph;
+  // PLAIDML_PT_CACHE_SIZE bounds how many compiled variants are kept.
+  if (auto env = std::getenv("PLAIDML_PT_CACHE_SIZE")) {
+    auto value = std::atoi(env);
+    if (value > 0) {
+      capacity_ = value;
+    }
+  }
 }
 
 bool Compiler::is_supported(Node* node) {
@@ -503,12 +515,32 @@ void Compiler::run(Stack* stack) {
   at::ArrayRef<IValue> inputs = last(*stack, num_inputs);
 
   CompleteArgumentSpec spec{false, inputs};
-  auto it = cache_.find(spec);
-  if (it == cache_.end()) {
-    std::tie(it, std::ignore) = cache_.emplace(spec, compile(inputs));
+  auto exec = lookup(spec);
+  if (!exec) {
+    // Compile this signature in the background; serve the request through the
+    // interpreter meanwhile, so a newly-seen shape costs a slow request
+    // instead of a compile stall.
+    std::unique_lock<std::mutex> lock{mu_};
+    auto it = pending_.find(spec);
+    if (it == pending_.end()) {
+      std::vector<IValue> held{inputs.begin(), inputs.end()};
+      pending_.emplace(spec, std::async(std::launch::async, [this, held = std::move(held)] {  //
+                         return compile(held);
+                       }));
+    } else if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      auto done = std::move(it->second);
+      pending_.erase(it);
+      lock.unlock();
+      exec = done.get();  // rethrows if the compile failed
+      insert(spec, exec);
+    }
+  }
+  if (!exec) {
+    run_fallback(stack);
+    return;
   }
 
-  auto outputs = it->second->run(inputs);
+  auto outputs = exec->run(inputs);
 
   drop(*stack, num_inputs);
   for (const auto& output : outputs) {
@@ -517,6 +549,37 @@ void Compiler::run(Stack* stack) {
   }
 }
 
+std::shared_ptr<Executable> Compiler::lookup(const CompleteArgumentSpec& spec) {
+  std::lock_guard<std::mutex> lock{mu_};
+  auto it = cache_.find(spec);
+  if (it == cache_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  return it->second.exec;
+}
+
+void Compiler::insert(const CompleteArgumentSpec& spec, const std::shared_ptr<Executable>& exec) {
+  std::lock_guard<std::mutex> lock{mu_};
+  lru_.push_front(spec);
+  cache_.emplace(spec, CacheEntry{exec, lru_.begin()});
+  while (cache_.size() > capacity_) {
+    cache_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+void Compiler::run_fallback(Stack* stack) {
+  IVLOG(1, "Compiler::run> fallback");
+  std::unique_lock<std::mutex> lock{mu_};
+  if (!fallback_code_) {
+    fallback_code_ = std::make_unique<Code>(subgraph_);
+  }
+  auto& code = *fallback_code_;
+  lock.unlock();
+  InterpreterState(code).run(*stack);
+}
+
 std::shared_ptr<Executable> Compiler::compile(at::ArrayRef<IValue> inputs) {
   IVLOG(1, "Compiler::compile>");
   std::vector<edsl::Tensor> input_tensors;
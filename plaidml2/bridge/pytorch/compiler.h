@@ -3,9 +3,13 @@
 #pragma once
 
 #include <torch/csrc/jit/argument_spec.h>
+#include <torch/csrc/jit/interpreter.h>
 #include <torch/csrc/jit/ir.h>
 
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -47,10 +51,29 @@ class Compiler {
 
  private:
   std::shared_ptr<Executable> compile(at::ArrayRef<torch::jit::IValue> inputs);
+  // Returns the compiled executable for spec (bumping it to most-recently-used),
+  // or nullptr if this signature hasn't finished compiling.
+  std::shared_ptr<Executable> lookup(const torch::jit::CompleteArgumentSpec& spec);
+  void insert(const torch::jit::CompleteArgumentSpec& spec, const std::shared_ptr<Executable>& exec);
+  // Runs the subgraph through the JIT interpreter; used while a signature's
+  // compile is still in flight.
+  void run_fallback(torch::jit::Stack* stack);
 
  private:
+  struct CacheEntry {
+    std::shared_ptr<Executable> exec;
+    std::list<torch::jit::CompleteArgumentSpec>::iterator lru_it;
+  };
+
   std::string device_id_;
   std::string target_id_;
   std::shared_ptr<torch::jit::Graph> subgraph_;
-  std::unordered_map<torch::jit::CompleteArgumentSpec, std::shared_ptr<Executable>> cache_;
+  std::mutex mu_;
+  size_t capacity_;
+  // Most-recently-used signatures at the front; entries past capacity_ are
+  // evicted from the back.
+  std::list<torch::jit::CompleteArgumentSpec> lru_;
+  std::unordered_map<torch::jit::CompleteArgumentSpec, CacheEntry> cache_;
+  std::unordered_map<torch::jit::CompleteArgumentSpec, std::future<std::shared_ptr<Executable>>> pending_;
+  std::unique_ptr<torch::jit::Code> fallback_code_;
 };
@@ -109,8 +109,13 @@ class TensorShape {
   std::shared_ptr<plaidml_shape> ptr_;
 };
 
+namespace exec {
+class Executable;
+}  // namespace exec
+
 class View {
   friend class Buffer;
+  friend class exec::Executable;
 
  public:
   char* data() {  //
@@ -140,6 +145,14 @@ class Buffer {
             ffi::call<plaidml_buffer*>(plaidml_buffer_alloc, device.c_str(), shape.nbytes()))),
         shape_(shape) {}
 
+  // Wraps caller-owned host memory without copying it.  The memory must
+  // stay valid (and suitably aligned) for the buffer's lifetime; runs read
+  // and write it in place, eliminating the staging copy both ways.
+  Buffer(const std::string& device, const TensorShape& shape, void* data)
+      : ptr_(details::make_plaidml_buffer(ffi::call<plaidml_buffer*>(
+            plaidml_buffer_adopt, device.c_str(), static_cast<char*>(data), shape.nbytes()))),
+        shape_(shape) {}
+
   explicit Buffer(plaidml_buffer* ptr, const TensorShape& shape)
       : ptr_(details::make_plaidml_buffer(ptr)), shape_(shape) {}
 
@@ -14,12 +14,15 @@
 #include "base/context/eventlog.h"
 #include "base/eventing/file/eventlog.h"
 #include "base/util/env.h"
+#include "base/util/perf_counter.h"
 #include "plaidml2/core/internal.h"
 #include "plaidml2/core/settings.h"
 #include "tile/platform/local_machine/platform.h"
+#include "tile/targets/targets.h"
 
 #ifdef PLAIDML_AST
 using vertexai::tile::TensorDimension;
+using vertexai::tile::TensorDimensions;
 using vertexai::tile::TensorShape;
 #endif
 #ifdef PLAIDML_MLIR
@@ -67,6 +70,10 @@ void plaidml_init(plaidml_error* err) {
       Settings::Instance()->load();
       auto ctx = GlobalContext::getContext();
       GetPlatform();
+      // Parse the embedded target configs on a background thread so the
+      // first compile doesn't stall on them; invocations that never compile
+      // pay nothing beyond the thread.
+      vertexai::tile::targets::PrefetchConfigs();
       auto eventlog_str = vertexai::env::Get("PLAIDML_EVENTLOG_FILENAME");
       if (eventlog_str.size()) {
         IVLOG(1, "Logging events to " << eventlog_str);
@@ -158,6 +165,18 @@ void plaidml_settings_set(  //
   });
 }
 
+plaidml_string* plaidml_perf_counters(  //
+    plaidml_error* err) {
+  return ffi_wrap<plaidml_string*>(err, nullptr, [&]() -> plaidml_string* {
+    std::stringstream ss;
+    for (const auto& kvp : vertexai::GetPerfCounters()) {
+      ss << "# TYPE " << kvp.first << " counter\n";
+      ss << kvp.first << " " << kvp.second << "\n";
+    }
+    return new plaidml_string{ss.str()};
+  });
+}
+
 const char* plaidml_string_ptr(plaidml_string* str) {  //
   return str->str.c_str();
 }
@@ -194,7 +213,7 @@ plaidml_shape* plaidml_shape_alloc(  //
     const int64_t* strides) {
   return ffi_wrap<plaidml_shape*>(err, nullptr, [&] {
 #ifdef PLAIDML_AST
-    std::vector<TensorDimension> dims(ndims);
+    TensorDimensions dims(ndims);
     for (size_t i = 0; i < ndims; i++) {
       dims[i] = TensorDimension{strides[i], static_cast<uint64_t>(sizes[i])};
     }
@@ -327,6 +346,18 @@ plaidml_buffer* plaidml_buffer_alloc(  //
   });
 }
 
+plaidml_buffer* plaidml_buffer_adopt(  //
+    plaidml_error* err,                //
+    const char* device_id,             //
+    char* data,                        //
+    size_t size) {
+  return ffi_wrap<plaidml_buffer*>(err, nullptr, [&] {
+    auto ctx = GlobalContext::getContext();
+    auto buffer = GetPlatform()->MakeHostBuffer(*ctx, device_id, data, size);
+    return new plaidml_buffer{buffer};
+  });
+}
+
 plaidml_view* plaidml_buffer_mmap_current(  //
     plaidml_error* err,                     //
     plaidml_buffer* buffer) {
@@ -49,6 +49,11 @@ typedef struct plaidml_value plaidml_value;
 typedef struct {
   plaidml_expr* expr;
   plaidml_buffer* buffer;
+  // Optional physical layout request, honored for outputs: comma-separated
+  // logical dimension indices, outermost first (e.g. "0,3,1,2" stores an
+  // NHWC program output in NCHW order).  NULL keeps the logical row-major
+  // layout.
+  const char* layout;
 } plaidml_binding;
 
 //
@@ -120,6 +125,12 @@ void plaidml_settings_load(  //
 void plaidml_settings_save(  //
     plaidml_error* err);
 
+// Renders every performance counter in the Prometheus text exposition format
+// (a "# TYPE <name> counter" line followed by one sample per counter), so a
+// pull-based metrics agent can scrape runtime health.
+plaidml_string* plaidml_perf_counters(  //
+    plaidml_error* err);
+
 //
 // Shape
 //
@@ -199,6 +210,15 @@ plaidml_buffer* plaidml_buffer_alloc(  //
     const char* device_id,             //
     size_t size);
 
+// Wraps caller-owned host memory as a buffer without copying it.  The caller
+// keeps ownership of the memory and must keep it valid and suitably aligned
+// for the buffer's lifetime; runs read and write it in place.
+plaidml_buffer* plaidml_buffer_adopt(  //
+    plaidml_error* err,                //
+    const char* device_id,             //
+    char* data,                        //
+    size_t size);
+
 plaidml_view* plaidml_buffer_mmap_current(  //
     plaidml_error* err,                     //
     plaidml_buffer* buffer);
@@ -44,6 +44,14 @@ fs::path settings_path() {
 
 Settings::Settings() {  //
   settings_.emplace("PLAIDML_SETTINGS", settings_path().string());
+  // Concurrency knobs, seeded with the effective process-wide defaults so
+  // that tools enumerating settings can see (and pin) them.  At run time an
+  // explicitly set environment variable always wins.
+  settings_.emplace("PLAIDML_RESERVED_CORES", vertexai::env::Get("PLAIDML_RESERVED_CORES", "0"));
+  settings_.emplace("PLAIDML_INTRA_OP_THREADS", std::to_string(vertexai::env::IntraOpThreadBudget()));
+  // Compile for small-batch latency rather than throughput; see
+  // tile/codegen/driver.cc for what the mode changes.
+  settings_.emplace("PLAIDML_LATENCY_MODE", vertexai::env::Get("PLAIDML_LATENCY_MODE", "0"));
 }
 
 Settings* Settings::Instance() {
@@ -55,11 +63,12 @@ const std::map<std::string, std::string>& Settings::all() const {  //
   return settings_;
 }
 
-std::string Settings::get(const std::string& key) const {
+std::string Settings::get(const std::string& key) {
   auto env_var = vertexai::env::Get(key);
   if (env_var.size()) {
     return env_var;
   }
+  ReloadIfChanged();
   auto it = settings_.find(key);
   if (it == settings_.end()) {
     return "";
@@ -72,12 +81,34 @@ void Settings::set(const std::string& key, const std::string& value) {
   vertexai::env::Set(key, value);
 }
 
+void Settings::ReloadIfChanged() {
+  static bool watch = vertexai::env::Get("PLAIDML_SETTINGS_WATCH") == "1";
+  if (!watch) {
+    return;
+  }
+  auto it = settings_.find("PLAIDML_SETTINGS");
+  fs::path path = vertexai::env::Get("PLAIDML_SETTINGS", it == settings_.end() ? "" : it->second);
+  boost::system::error_code ec;
+  auto mtime = fs::last_write_time(path, ec);
+  if (ec || mtime == loaded_mtime_) {
+    return;
+  }
+  // Record the new stamp before load(); its own get() calls come back here.
+  loaded_mtime_ = mtime;
+  load();
+}
+
 void Settings::load() {
   fs::path settings_path{get("PLAIDML_SETTINGS")};
   if (!fs::exists(settings_path)) {
     LOG(WARNING) << "No PlaidML settings found.";
     return;
   }
+  boost::system::error_code ec;
+  auto mtime = fs::last_write_time(settings_path, ec);
+  if (!ec) {
+    loaded_mtime_ = mtime;
+  }
   settings_.clear();
   fs::ifstream file(settings_path);
   for (std::string line; std::getline(file, line);) {
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <ctime>
 #include <map>
 #include <string>
 
@@ -14,7 +15,11 @@ class Settings {
   static Settings* Instance();
 
   const std::map<std::string, std::string>& all() const;
-  std::string get(const std::string& key) const;
+  // With PLAIDML_SETTINGS_WATCH=1, get() reloads the settings file when it
+  // has changed on disk since the last load, so a serving process can be
+  // retuned without a restart.  Explicitly set environment variables still
+  // win over file contents either way.
+  std::string get(const std::string& key);
   void set(const std::string& key, const std::string& value);
 
   void load();
@@ -22,9 +27,11 @@ class Settings {
 
  private:
   Settings();
+  void ReloadIfChanged();
 
  private:
   std::map<std::string, std::string> settings_;
+  std::time_t loaded_mtime_ = 0;
 };
 
 }  // namespace plaidml::core
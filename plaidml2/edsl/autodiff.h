@@ -31,6 +31,60 @@ inline std::vector<Tensor> Gradient(const std::vector<Tensor>& wrt, const Tensor
   return ret;
 }
 
+// As Gradient, but marks each Tensor in `checkpoints` as a recomputation
+// boundary: the backward pass rematerializes forward intermediates from the
+// checkpoints instead of storing every activation, trading extra compute for
+// the memory to run larger batches.  Typical use marks layer boundaries.
+inline std::vector<Tensor> Gradient(const std::vector<Tensor>& wrt, const Tensor& loss,
+                                    const std::vector<Tensor>& checkpoints) {
+  std::vector<plaidml_expr*> wrt_exprs(wrt.size());
+  std::vector<plaidml_expr*> checkpoint_exprs(checkpoints.size());
+  std::vector<plaidml_expr*> deriv_exprs(wrt.size());
+  for (size_t i = 0; i < wrt.size(); ++i) {
+    wrt_exprs[i] = wrt[i].as_ptr();
+  }
+  for (size_t i = 0; i < checkpoints.size(); ++i) {
+    checkpoint_exprs[i] = checkpoints[i].as_ptr();
+  }
+  ffi::call_void(                          //
+      plaidml_expr_gradient_checkpointed,  //
+      wrt_exprs.size(),                    //
+      wrt_exprs.data(),                    //
+      loss.as_ptr(),                       //
+      checkpoint_exprs.size(),             //
+      checkpoint_exprs.data(),             //
+      deriv_exprs.data());
+  std::vector<Tensor> ret(wrt.size());
+  for (size_t i = 0; i < wrt.size(); ++i) {
+    ret[i] = Tensor(deriv_exprs[i]);
+  }
+  return ret;
+}
+
+// Forward-mode differentiation: propagates `tangents` (one per Tensor in
+// `wrt`, shape-matched pairwise) through the computation of `output`,
+// returning the Jacobian-vector product -- the directional derivative of
+// the output along the tangents -- in a single forward sweep, where
+// composing two reverse-mode passes costs roughly twice as much.  Apply
+// Gradient to the result to get Hessian-vector products.
+inline Tensor Jvp(const std::vector<Tensor>& wrt, const std::vector<Tensor>& tangents, const Tensor& output) {
+  if (wrt.size() != tangents.size()) {
+    throw std::runtime_error("Jvp requires exactly one tangent per wrt Tensor");
+  }
+  std::vector<plaidml_expr*> wrt_exprs(wrt.size());
+  std::vector<plaidml_expr*> tangent_exprs(tangents.size());
+  for (size_t i = 0; i < wrt.size(); ++i) {
+    wrt_exprs[i] = wrt[i].as_ptr();
+    tangent_exprs[i] = tangents[i].as_ptr();
+  }
+  return Tensor(ffi::call<plaidml_expr*>(  //
+      plaidml_expr_jvp,                    //
+      wrt_exprs.size(),                    //
+      wrt_exprs.data(),                    //
+      tangent_exprs.data(),                //
+      output.as_ptr()));
+}
+
 inline void RegisterTensorDeriv(const std::string& name, TensorDeriv fn) {
   auto thunk = ThunkTensorDeriv(fn);
   ffi::call_void(plaidml_deriv_register, name.c_str(), thunk, reinterpret_cast<void*>(fn));
@@ -9,6 +9,7 @@
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -1261,6 +1262,148 @@ inline Tensor Call(const std::string& fn, const std::vector<Tensor>& args) {
   return Tensor{ptr};
 }
 
+namespace details {
+
+// Expression-template support for fuse().  A fused elementwise chain is
+// composed at C++ compile time and emitted leaf-to-root in a single pass;
+// only the finished chain is wrapped in a Tensor, so the interior operators
+// skip the per-node Tensor (and its heap-allocated Impl) that the dynamic
+// operators construct.
+
+using FusedExprPtr = std::unique_ptr<plaidml_expr, Deleter>;
+
+// A raw expression during the emit pass.  Tensor leaves borrow their
+// expression from the Tensor they wrap; every other node owns its
+// expression, which is freed once the parent call has consumed it.
+struct FusedRaw {
+  plaidml_expr* ptr;
+  FusedExprPtr owner;
+};
+
+struct FusedTensorArg {
+  const Tensor* tensor;
+  FusedRaw Emit() const { return FusedRaw{tensor->as_ptr(), FusedExprPtr()}; }
+};
+
+struct FusedIntArg {
+  int64_t value;
+  FusedRaw Emit() const {
+    auto ptr = ffi::call<plaidml_expr*>(plaidml_expr_int, value);
+    return FusedRaw{ptr, FusedExprPtr(ptr)};
+  }
+};
+
+struct FusedFloatArg {
+  double value;
+  FusedRaw Emit() const {
+    auto ptr = ffi::call<plaidml_expr*>(plaidml_expr_float, value);
+    return FusedRaw{ptr, FusedExprPtr(ptr)};
+  }
+};
+
+template <typename ARG>
+struct FusedUnaryExpr {
+  const char* fn;
+  ARG arg;
+  FusedRaw Emit() const {
+    auto sub = arg.Emit();
+    plaidml_expr* args[] = {sub.ptr};
+    auto ptr = ffi::call<plaidml_expr*>(plaidml_expr_call, fn, 1, args);
+    return FusedRaw{ptr, FusedExprPtr(ptr)};
+  }
+  operator Tensor() const { return Tensor{Emit().owner.release()}; }  // NOLINT[runtime/explicit]
+};
+
+template <typename LHS, typename RHS>
+struct FusedBinaryExpr {
+  const char* fn;
+  LHS lhs;
+  RHS rhs;
+  FusedRaw Emit() const {
+    auto lraw = lhs.Emit();
+    auto rraw = rhs.Emit();
+    plaidml_expr* args[] = {lraw.ptr, rraw.ptr};
+    auto ptr = ffi::call<plaidml_expr*>(plaidml_expr_call, fn, 2, args);
+    return FusedRaw{ptr, FusedExprPtr(ptr)};
+  }
+  operator Tensor() const { return Tensor{Emit().owner.release()}; }  // NOLINT[runtime/explicit]
+};
+
+template <typename T>
+struct is_fused_expr : std::false_type {};
+template <>
+struct is_fused_expr<FusedTensorArg> : std::true_type {};
+template <typename ARG>
+struct is_fused_expr<FusedUnaryExpr<ARG>> : std::true_type {};
+template <typename LHS, typename RHS>
+struct is_fused_expr<FusedBinaryExpr<LHS, RHS>> : std::true_type {};
+
+inline FusedTensorArg MakeFusedArg(const Tensor& tensor) { return FusedTensorArg{&tensor}; }
+inline FusedIntArg MakeFusedArg(int value) { return FusedIntArg{value}; }
+inline FusedIntArg MakeFusedArg(int64_t value) { return FusedIntArg{value}; }
+inline FusedFloatArg MakeFusedArg(double value) { return FusedFloatArg{value}; }
+template <typename T, typename std::enable_if<is_fused_expr<T>::value, int>::type = 0>
+inline T MakeFusedArg(const T& arg) {
+  return arg;
+}
+
+// The operators live here so argument-dependent lookup finds them whenever
+// either operand is fused; MakeFusedArg in the return type keeps them out
+// of overload resolution for operand types the fused form doesn't cover.
+#define PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(_op_, _fn_)                                                    \
+  template <typename LHS, typename RHS,                                                                     \
+            typename std::enable_if<is_fused_expr<LHS>::value || is_fused_expr<RHS>::value, int>::type = 0> \
+  inline auto operator _op_(const LHS& lhs, const RHS& rhs)                                                 \
+      ->FusedBinaryExpr<decltype(MakeFusedArg(lhs)), decltype(MakeFusedArg(rhs))> {                         \
+    return {_fn_, MakeFusedArg(lhs), MakeFusedArg(rhs)};                                                    \
+  }
+
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(+, "add");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(-, "sub");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(*, "mul");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(/, "div");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(==, "cmp_eq");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(!=, "cmp_ne");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(<, "cmp_lt");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(>, "cmp_gt");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(<=, "cmp_le");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(>=, "cmp_ge");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(<<, "bit_left");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(>>, "bit_right");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(&, "bit_and");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(|, "bit_or");
+PLAIDML_EDSL_DEFINE_FUSED_BINARY_OPS(^, "bit_xor");
+
+template <typename ARG, typename std::enable_if<is_fused_expr<ARG>::value, int>::type = 0>
+inline FusedUnaryExpr<ARG> operator-(const ARG& arg) {
+  return {"neg", arg};
+}
+
+template <typename ARG, typename std::enable_if<is_fused_expr<ARG>::value, int>::type = 0>
+inline FusedUnaryExpr<ARG> operator~(const ARG& arg) {
+  return {"bit_not", arg};
+}
+
+}  // namespace details
+
+///
+/// Lifts a Tensor into fused (expression-template) form.  An elementwise
+/// chain with at least one fused operand is composed at C++ compile time and
+/// built without an intermediate Tensor per operator, which matters for
+/// dynamically-constructed graphs where graph-build time is visible:
+///
+///     Tensor O = fuse(A) * B + 2.0 * fuse(C);
+///
+/// The chain produces the same expression the dynamic operators would.  A
+/// fused expression converts implicitly to Tensor, so anything the fused
+/// form doesn't cover — contractions, named primitives, mixed-type operands
+/// — takes it through that conversion and proceeds on the dynamic path.
+/// Fused expressions refer to their Tensor leaves rather than retaining
+/// them, so a chain should be consumed by the full expression that builds
+/// it, not stashed with auto.
+///
+inline details::FusedTensorArg fuse(const Tensor& tensor) { return details::FusedTensorArg{&tensor}; }
+
 class Value {
  public:
   Value() : ptr_(details::make_ptr(ffi::call<plaidml_value*>(plaidml_value_none))) {}
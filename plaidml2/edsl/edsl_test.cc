@@ -347,6 +347,17 @@ module {
   exec::Binder(program).compile()->run();
 }
 
+TEST(CppEdsl, FusedEltwiseChain) {
+  auto A = Placeholder(PLAIDML_DATA_FLOAT32, {10, 20});
+  auto B = Placeholder(PLAIDML_DATA_FLOAT32, {10, 20});
+  auto C = Placeholder(PLAIDML_DATA_FLOAT32, {10, 20});
+  // The fused chain produces the same expression the dynamic operators
+  // build node-by-node, without an intermediate Tensor per operator.
+  Tensor fused = fuse(A) * B + 2.0 * (-fuse(C)) - 1;
+  Program program("fused_eltwise_chain", {fused});
+  exec::Binder(program).compile()->run();
+}
+
 TEST(CppEdsl, Relu) {
   auto A = Placeholder(PLAIDML_DATA_FLOAT32, {10, 20});
   Program program("relu", {Relu(A)});
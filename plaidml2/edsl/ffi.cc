@@ -908,6 +908,74 @@ void plaidml_expr_gradient(  //
   });
 }
 
+void plaidml_expr_gradient_checkpointed(  //
+    plaidml_error* err,                   //
+    size_t nwrts,                         //
+    plaidml_expr** wrts,                  //
+    plaidml_expr* loss,                   //
+    size_t ncheckpoints,                  //
+    plaidml_expr** checkpoints,           //
+    plaidml_expr** derivs) {
+  // As plaidml_expr_gradient, but rematerializes forward intermediates from
+  // the given checkpoint tensors in the backward pass instead of storing
+  // every activation until its gradient is consumed.
+  ffi_wrap_void(err, [&] {
+    IVLOG(3, "plaidml_expr_gradient_checkpointed");
+#ifdef PLAIDML_AST
+    std::vector<ExprPtr> wrt_exprs(nwrts);
+    for (size_t i = 0; i < nwrts; i++) {
+      wrt_exprs[i] = wrts[i]->expr;
+    }
+    std::vector<ExprPtr> checkpoint_exprs(ncheckpoints);
+    for (size_t i = 0; i < ncheckpoints; i++) {
+      checkpoint_exprs[i] = checkpoints[i]->expr;
+    }
+    auto deriv_exprs = ComputeGradients(wrt_exprs, loss->expr, checkpoint_exprs);
+    for (size_t i = 0; i < nwrts; i++) {
+      derivs[i] = new plaidml_expr{deriv_exprs[i]};
+    }
+#endif
+#ifdef PLAIDML_MLIR
+    // The MLIR path doesn't support checkpointing yet; fall back to plain
+    // gradients rather than failing the program.
+    IVLOG(1, "Checkpoints are ignored when building gradients via MLIR");
+    std::vector<mlir::Value> wrt_values(nwrts);
+    for (size_t i = 0; i < nwrts; i++) {
+      wrt_values[i] = wrts[i]->value;
+    }
+    auto deriv_values = GlobalContext::get()->ComputeGradients(wrt_values, loss->value);
+    for (size_t i = 0; i < nwrts; i++) {
+      derivs[i] = new plaidml_expr{deriv_values[i]};
+    }
+#endif
+  });
+}
+
+plaidml_expr* plaidml_expr_jvp(  //
+    plaidml_error* err,          //
+    size_t nwrts,                //
+    plaidml_expr** wrts,         //
+    plaidml_expr** tangents,     //
+    plaidml_expr* output) {
+  // Forward-mode counterpart of plaidml_expr_gradient: propagates the given
+  // tangents through the computation of `output` in one sweep and returns
+  // the Jacobian-vector product.
+  return ffi_wrap<plaidml_expr*>(err, nullptr, [&]() -> plaidml_expr* {
+    IVLOG(3, "plaidml_expr_jvp");
+#ifdef PLAIDML_AST
+    std::vector<ExprPtr> wrt_exprs(nwrts);
+    std::vector<ExprPtr> tangent_exprs(nwrts);
+    for (size_t i = 0; i < nwrts; i++) {
+      wrt_exprs[i] = wrts[i]->expr;
+      tangent_exprs[i] = tangents[i]->expr;
+    }
+    return new plaidml_expr{ComputeJvp(output->expr, wrt_exprs, tangent_exprs)};
+#else
+    throw std::runtime_error("Forward-mode differentiation is not yet supported via MLIR");
+#endif
+  });
+}
+
 void plaidml_deriv_register(  //
     plaidml_error* err,       //
     const char* name,         //
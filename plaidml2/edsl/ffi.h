@@ -141,6 +141,30 @@ void plaidml_expr_gradient(  //
     plaidml_expr* loss,      //
     plaidml_expr** derivs);
 
+// As plaidml_expr_gradient, but treats each expr in `checkpoints` as a
+// recomputation boundary: the backward pass rematerializes forward
+// intermediates from the checkpoints instead of keeping them stored,
+// trading compute for activation memory.
+void plaidml_expr_gradient_checkpointed(  //
+    plaidml_error* err,                   //
+    size_t nwrts,                         //
+    plaidml_expr** wrts,                  //
+    plaidml_expr* loss,                   //
+    size_t ncheckpoints,                  //
+    plaidml_expr** checkpoints,           //
+    plaidml_expr** derivs);
+
+// Forward-mode differentiation: propagates `tangents` (one per expr in
+// `wrts`) through the computation of `output` in a single sweep, returning
+// the Jacobian-vector product -- the directional derivative of the output
+// along the tangents.
+plaidml_expr* plaidml_expr_jvp(  //
+    plaidml_error* err,          //
+    size_t nwrts,                //
+    plaidml_expr** wrts,         //
+    plaidml_expr** tangents,     //
+    plaidml_expr* output);
+
 typedef void (*plaidml_deriv)(  //
     void* user_ctx,             //
     plaidml_expr* Y,            //
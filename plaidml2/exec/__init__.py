@@ -35,6 +35,23 @@ def list_targets():
         ffi_call(lib.plaidml_strings_free, strs)
 
 
+def enable_kernel_profile(enable=True):
+    ffi_call(lib.plaidml_kernel_profile_enable, enable)
+
+
+def kernel_profile():
+    """Returns {kname: (runs, exec_ns, queue_wait_ns, bytes_moved)} for all kernels run so far."""
+    ret = {}
+    for line in decode_str(ffi_call(lib.plaidml_kernel_profile_repr)).splitlines():
+        kname, runs, exec_ns, queue_wait_ns, bytes_moved = line.split('\t')
+        ret[kname] = (int(runs), int(exec_ns), int(queue_wait_ns), int(bytes_moved))
+    return ret
+
+
+def clear_kernel_profile():
+    ffi_call(lib.plaidml_kernel_profile_clear)
+
+
 class Executable(ForeignObject):
     __ffi_del__ = lib.plaidml_executable_free
 
@@ -64,6 +81,28 @@ class Executable(ForeignObject):
     def run(self):
         ffi_call(lib.plaidml_executable_run, self.as_ptr())
 
+    def run_async(self):
+        """Enqueues a run without waiting for completion.
+
+        Up to PLAIDML_RUN_QUEUE_DEPTH runs (default 2) may be in flight, so
+        the next frame's input transfer overlaps this frame's kernels.
+        Rotate input/output buffers between in-flight runs and call wait()
+        before reading outputs.
+        """
+        ffi_call(lib.plaidml_executable_run_async, self.as_ptr())
+
+    def wait(self):
+        ffi_call(lib.plaidml_executable_wait, self.as_ptr())
+
+    def warmup(self):
+        """Executes the schedule once against scratch buffers.
+
+        Call at deploy time so the first real run doesn't pay for lazy
+        buffer instantiation, kernel warmup, or driver finalization.
+        Bound buffers are left untouched.
+        """
+        ffi_call(lib.plaidml_executable_warmup, self.as_ptr())
+
 
 class Binder:
 
@@ -2,9 +2,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "plaidml2/core/core.h"
@@ -36,6 +43,9 @@ inline std::shared_ptr<T> make_ptr(T* ptr) {
 struct Binding {
   edsl::Tensor tensor;
   Buffer buffer;
+  // For outputs: optional physical layout, as comma-separated logical
+  // dimension indices, outermost first.  Empty keeps the logical layout.
+  std::string layout;
 };
 
 inline std::vector<std::string> list_devices() {
@@ -56,6 +66,20 @@ inline std::vector<std::string> list_targets() {
   return ret;
 }
 
+inline void enable_kernel_profile(bool enable = true) {  //
+  ffi::call_void(plaidml_kernel_profile_enable, enable);
+}
+
+// Returns the accumulated per-kernel statistics as tab-separated lines:
+//   kname <tab> runs <tab> exec_ns <tab> queue_wait_ns <tab> bytes_moved
+inline std::string kernel_profile() {  //
+  return ffi::str(ffi::call<plaidml_string*>(plaidml_kernel_profile_repr));
+}
+
+inline void clear_kernel_profile() {  //
+  ffi::call_void(plaidml_kernel_profile_clear);
+}
+
 class Executable {
  public:
   Executable(const edsl::Program& program,        //
@@ -79,6 +103,7 @@ class Executable {
     for (size_t i = 0; i < inputs.size(); i++) {
       inputs_storage[i].expr = inputs[i].tensor.as_ptr();
       inputs_storage[i].buffer = inputs[i].buffer.as_ptr();
+      inputs_storage[i].layout = nullptr;
       raw_inputs[i] = &inputs_storage[i];
     }
     std::vector<plaidml_binding> outputs_storage(outputs.size());
@@ -86,6 +111,7 @@ class Executable {
     for (size_t i = 0; i < raw_outputs.size(); i++) {
       outputs_storage[i].expr = outputs[i].tensor.as_ptr();
       outputs_storage[i].buffer = outputs[i].buffer.as_ptr();
+      outputs_storage[i].layout = outputs[i].layout.empty() ? nullptr : outputs[i].layout.c_str();
       raw_outputs[i] = &outputs_storage[i];
     }
     ptr_ = details::make_ptr(            //
@@ -104,10 +130,158 @@ class Executable {
     ffi::call_void(plaidml_executable_run, ptr_.get());
   }
 
+  // Enqueues a run without waiting for completion, so the next frame's
+  // input transfer can overlap this frame's kernels.  Rotate buffers
+  // between in-flight runs; call wait() before reading outputs.
+  void run_async() {  //
+    ffi::call_void(plaidml_executable_run_async, ptr_.get());
+  }
+
+  // Returns a future that resolves once the output bound to `buffer` is on
+  // the host -- its producing kernels and device-to-host copy are done --
+  // without waiting for the rest of the run.  Use after run_async() to
+  // start postprocessing early outputs while the device finishes the
+  // remainder; wait() still drains every outstanding run and callback.
+  std::future<View> output_ready(const Buffer& buffer) {
+    struct Pending {
+      std::promise<View> promise;
+    };
+    auto pending = new Pending;
+    auto ret = pending->promise.get_future();
+    ffi::call_void(                       //
+        plaidml_executable_output_ready,  //
+        ptr_.get(),                       //
+        buffer.as_ptr(),                  //
+        [](void* user_ctx, plaidml_view* view) {
+          std::unique_ptr<Pending> pending(static_cast<Pending*>(user_ctx));
+          if (view) {
+            pending->promise.set_value(View(plaidml::details::make_plaidml_view(view)));
+          } else {
+            pending->promise.set_exception(
+                std::make_exception_ptr(std::runtime_error("output_ready: mapping the output failed")));
+          }
+        },
+        static_cast<void*>(pending));
+    return ret;
+  }
+
+  void wait() {  //
+    ffi::call_void(plaidml_executable_wait, ptr_.get());
+  }
+
+  // Executes the schedule once against scratch buffers at deploy time, so
+  // the first real run doesn't pay for lazy buffer instantiation, kernel
+  // warmup, or driver finalization.  Bound buffers are left untouched.
+  void warmup() {  //
+    ffi::call_void(plaidml_executable_warmup, ptr_.get());
+  }
+
  private:
   std::shared_ptr<plaidml_executable> ptr_;
 };
 
+// Maps arbitrary sizes onto a bounded set of bucket sizes.  With explicit
+// boundaries, a size rounds up to the first boundary that holds it; sizes
+// beyond the last boundary (or all sizes, when no boundaries are given)
+// round up to the next power of two, so unanticipated traffic still lands
+// in O(log max_size) buckets rather than one bucket per distinct size.
+class ShapeBucketer {
+ public:
+  explicit ShapeBucketer(std::vector<int64_t> boundaries = {}) : boundaries_(std::move(boundaries)) {
+    std::sort(boundaries_.begin(), boundaries_.end());
+  }
+
+  int64_t bucket(int64_t size) const {
+    for (auto boundary : boundaries_) {
+      if (size <= boundary) {
+        return boundary;
+      }
+    }
+    int64_t ret = 1;
+    while (ret < size) {
+      ret <<= 1;
+    }
+    return ret;
+  }
+
+ private:
+  std::vector<int64_t> boundaries_;
+};
+
+// Routes variable-size requests to a bounded set of compiled executables.
+//
+// Serving traffic with arbitrary sequence lengths would otherwise trigger a
+// compile per distinct length.  A BucketedExecutable rounds each request
+// size up to its bucket (see ShapeBucketer), lazily compiles one instance
+// per bucket via a caller-supplied builder -- which sees the padded size, so
+// its placeholders and staging buffers are bucket-shaped -- then zero-pads
+// each request input into the instance's staging input and runs.  Inputs are
+// padded byte-wise, so the variable dimension must be outermost in each
+// padded input; the builder's program is responsible for masking the pad
+// region (e.g. via contraction constraints) so it cannot reach real outputs.
+class BucketedExecutable {
+ public:
+  // One compiled bucket: the padded-size executable plus the bucket-shaped
+  // staging buffers its bindings refer to.
+  struct Instance {
+    std::shared_ptr<Executable> exe;
+    std::vector<Buffer> inputs;
+    std::vector<Buffer> outputs;
+  };
+
+  // `build` receives the bucketed size and returns the compiled instance
+  // for it; it is invoked at most once per bucket.
+  using Builder = std::function<Instance(int64_t size)>;
+
+  explicit BucketedExecutable(Builder build, std::vector<int64_t> boundaries = {})
+      : build_(std::move(build)), bucketer_(std::move(boundaries)) {}
+
+  // Dispatches one request of the given size: compiles the bucket on first
+  // use, copies each request input into the corresponding staging input
+  // (zeroing the pad region), runs, and returns the instance so the caller
+  // can read its outputs -- of which only the leading `size` extent is
+  // meaningful.  Dispatch is serialized; each instance owns one set of
+  // staging buffers.
+  Instance& run(int64_t size, const std::vector<Buffer>& inputs) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto& instance = resolve(size);
+    if (inputs.size() != instance.inputs.size()) {
+      throw std::runtime_error("BucketedExecutable::run: input count mismatch");
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+      auto src = const_cast<Buffer&>(inputs[i]).mmap_current();
+      auto dst = instance.inputs[i].mmap_discard();
+      auto used = std::min(src.size(), dst.size());
+      std::memcpy(dst.data(), src.data(), used);
+      std::memset(dst.data() + used, 0, dst.size() - used);
+      dst.writeback();
+    }
+    instance.exe->run();
+    return instance;
+  }
+
+  // The number of buckets compiled so far.
+  size_t instances() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return instances_.size();
+  }
+
+ private:
+  Instance& resolve(int64_t size) {
+    auto bucket = bucketer_.bucket(size);
+    auto it = instances_.find(bucket);
+    if (it == instances_.end()) {
+      it = instances_.emplace(bucket, build_(bucket)).first;
+    }
+    return it->second;
+  }
+
+  Builder build_;
+  ShapeBucketer bucketer_;
+  mutable std::mutex mu_;
+  std::map<int64_t, Instance> instances_;
+};
+
 class Binder {
  private:
   using BindingMap = std::map<edsl::TensorRef, Buffer>;
@@ -157,6 +331,32 @@ class Binder {
     return *this;
   }
 
+  // Requests a physical layout for `output`, as comma-separated logical
+  // dimension indices, outermost first (e.g. "0,3,1,2" stores an NHWC
+  // program output in NCHW order).  The compiler folds the permutation into
+  // the kernels that produce the output, so no separate transpose runs; the
+  // buffer's logical shape is unchanged, only its stride order differs.
+  Binder& set_output_layout(const edsl::Tensor& output, const std::string& layout) {
+    output_layouts_[output] = layout;
+    return *this;
+  }
+
+  // Donates `input`'s buffer to `output`: the two are bound to the same
+  // buffer, which tells the compiler the input's contents may be overwritten
+  // and lets it fold the pair into one device allocation instead of keeping
+  // them distinct.  This eliminates the output-to-input copy in iterated
+  // invocations that feed an output state tensor back in as an input.  The
+  // input must already be bound; after a run, the buffer holds the output
+  // value and the input value is gone.
+  Binder& donate(const edsl::Tensor& input, const edsl::Tensor& output) {
+    auto it = inputs_.find(input);
+    if (it == inputs_.end()) {
+      throw std::runtime_error("Binder::donate requires the donated input to be bound first");
+    }
+    outputs_[output] = it->second;
+    return *this;
+  }
+
   std::shared_ptr<Executable> compile() {
     std::vector<Binding> input_bindings;
     std::vector<Binding> output_bindings;
@@ -164,7 +364,12 @@ class Binder {
       if (arg.is_input) {
         input_bindings.emplace_back(Binding{arg.tensor, get_buffer(&inputs_, arg)});
       } else {
-        output_bindings.emplace_back(Binding{arg.tensor, get_buffer(&outputs_, arg)});
+        std::string layout;
+        auto it = output_layouts_.find(arg.tensor);
+        if (it != output_layouts_.end()) {
+          layout = it->second;
+        }
+        output_bindings.emplace_back(Binding{arg.tensor, get_buffer(&outputs_, arg), layout});
       }
     }
     return std::make_shared<Executable>(program_, device_, target_, input_bindings, output_bindings);
@@ -188,6 +393,7 @@ class Binder {
   std::string target_;
   std::map<edsl::TensorRef, Buffer> inputs_;
   std::map<edsl::TensorRef, Buffer> outputs_;
+  std::map<edsl::TensorRef, std::string> output_layouts_;
 };
 
 }  // namespace exec
@@ -3,17 +3,25 @@
 #include "plaidml2/exec/ffi.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <list>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <boost/thread/future.hpp>
+
 #include "llvm/Support/FormatVariadic.h"
 
 #include "base/util/env.h"
 #include "plaidml2/core/internal.h"
+#include "tile/base/kernel_profile.h"
+#include "tile/stripe/stripe.h"
 #include "tile/targets/targets.h"
 
 #ifdef PLAIDML_AST
@@ -37,6 +45,7 @@ using vertexai::tile::Allocator;
 using vertexai::tile::Buffer;
 using vertexai::tile::BufferPtr;
 using vertexai::tile::ConstBufferManager;
+using vertexai::tile::KernelProfile;
 using vertexai::tile::Program;
 using vertexai::tile::View;
 using vertexai::tile::targets::GetConfigs;
@@ -69,6 +78,83 @@ class PlatformAllocator : public Allocator {
   std::string device_id_;
 };
 
+// Parses a layout request: comma-separated logical dimension indices,
+// outermost first, which must form a permutation of 0..ndims-1.
+std::vector<size_t> ParseLayout(const std::string& layout, size_t ndims) {
+  std::vector<size_t> perm;
+  std::istringstream ss(layout);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) {
+    perm.push_back(std::stoul(tok));
+  }
+  std::vector<bool> seen(ndims, false);
+  if (perm.size() != ndims) {
+    throw std::runtime_error(llvm::formatv("Invalid layout \"{0}\": expected {1} dimensions", layout, ndims));
+  }
+  for (size_t dim : perm) {
+    if (dim >= ndims || seen[dim]) {
+      throw std::runtime_error(llvm::formatv("Invalid layout \"{0}\": not a permutation", layout));
+    }
+    seen[dim] = true;
+  }
+  return perm;
+}
+
+// Rewrites the strides of `name`'s refinement in `block` and of every
+// refinement derived from it in nested blocks.  The program is fresh from
+// lowering here, so derived refinements still cover the whole tensor.
+void FixRefStrides(vertexai::tile::stripe::Block* block,  //
+                   const std::string& name,               //
+                   const std::vector<int64_t>& strides) {
+  auto it = block->ref_by_into(name, false);
+  if (it == block->refs.end() || it->interior_shape.dims.size() != strides.size()) {
+    return;
+  }
+  for (size_t i = 0; i < strides.size(); i++) {
+    it->mut().interior_shape.dims[i].stride = strides[i];
+  }
+  for (const auto& stmt : block->stmts) {
+    auto inner = vertexai::tile::stripe::Block::Downcast(stmt);
+    if (!inner) {
+      continue;
+    }
+    for (const auto& ref : inner->refs) {
+      if (ref.from == name) {
+        FixRefStrides(inner.get(), ref.into(), strides);
+      }
+    }
+  }
+}
+
+// Applies a requested physical layout to output `name`: the logical shape is
+// unchanged, but the strides are recomputed as if the dimensions were stored
+// in permuted order, so the producing kernels write the permuted layout
+// directly and no separate transpose is needed.
+void ApplyOutputLayout(vertexai::tile::stripe::Program* stripe,  //
+                       const std::string& name,                  //
+                       const std::string& layout) {
+  auto root = stripe->entry.get();
+  auto it = root->ref_by_into(name, false);
+  if (it == root->refs.end()) {
+    throw std::runtime_error("Layout requested for unknown output: " + name);
+  }
+  auto& dims = it->interior_shape.dims;
+  auto perm = ParseLayout(layout, dims.size());
+  std::vector<int64_t> strides(dims.size());
+  int64_t stride = 1;
+  for (size_t i = perm.size(); i-- > 0;) {
+    strides[perm[i]] = stride;
+    stride *= dims[perm[i]].size;
+  }
+  FixRefStrides(root, name, strides);
+  auto shape_it = stripe->output_shapes.find(name);
+  if (shape_it != stripe->output_shapes.end() && shape_it->second.dims.size() == strides.size()) {
+    for (size_t i = 0; i < strides.size(); i++) {
+      shape_it->second.dims[i].stride = strides[i];
+    }
+  }
+}
+
 #ifdef PLAIDML_MLIR
 
 std::vector<ProgramArgument> BindProgramArguments(  //
@@ -120,9 +206,11 @@ extern "C" {
 
 struct plaidml_executable {
   using BufferMap = std::map<std::string, std::shared_ptr<Buffer>>;
+  std::string device;
   BufferMap input_bufs;
   BufferMap output_bufs;
   std::shared_ptr<Program> program;
+  std::list<boost::future<void>> pending;
 #ifdef PLAIDML_MLIR
   std::unique_ptr<Executable> exec;
 #endif  // PLAIDML_MLIR
@@ -168,7 +256,7 @@ plaidml_strings* plaidml_targets_get(  //
     }
 #endif
 
-    auto configs = GetConfigs().configs();
+    const auto& configs = GetConfigs()->configs();
     auto strs = new plaidml_string*[configs.size()];
     size_t i = 0;
     for (const auto& [key, value] : configs) {
@@ -190,7 +278,7 @@ plaidml_executable* plaidml_compile(  //
   return ffi_wrap<plaidml_executable*>(err, nullptr, [&] {
     IVLOG(1, "Compiling with device: " << device << ", target: " << target);
     if (vertexai::env::Get("PLAIDML_EE") != "1") {
-      auto configs = GetConfigs().configs();
+      const auto& configs = GetConfigs()->configs();
       if (!configs.count(target)) {
         throw std::runtime_error(llvm::formatv("Unknown target specified: {0}", target));
       }
@@ -199,9 +287,8 @@ plaidml_executable* plaidml_compile(  //
     ConstBufferManager const_bufs;
     const_bufs.allocator = std::make_shared<PlatformAllocator>(device);
     auto exec = std::make_unique<plaidml_executable>();
+    exec->device = device;
     auto stripe = vertexai::tile::lang::GenerateStripe(program->eval.runinfo);
-    Context ctx;
-    exec->program = GetPlatform()->MakeProgram(ctx, device, target, stripe, &const_bufs);
     std::unordered_map<ExprPtr, BufferPtr> input_bindings;
     for (size_t i = 0; i < ninputs; i++) {
       auto param_expr = std::dynamic_pointer_cast<ParamExpr>(inputs[i]->expr->expr);
@@ -212,8 +299,12 @@ plaidml_executable* plaidml_compile(  //
       input_bindings[inputs[i]->expr->expr] = inputs[i]->buffer->buffer;
     }
     std::unordered_map<ExprPtr, BufferPtr> output_bindings;
+    std::unordered_map<ExprPtr, std::string> output_layouts;
     for (size_t i = 0; i < noutputs; i++) {
       output_bindings[outputs[i]->expr->expr] = outputs[i]->buffer->buffer;
+      if (outputs[i]->layout && outputs[i]->layout[0]) {
+        output_layouts[outputs[i]->expr->expr] = outputs[i]->layout;
+      }
     }
     for (const auto& arg : program->eval.args) {
       if (arg.is_input) {
@@ -227,11 +318,29 @@ plaidml_executable* plaidml_compile(  //
           throw std::runtime_error("Invalid program, unbound output");
         }
         exec->output_bufs[arg.name] = it->second;
+        auto layout_it = output_layouts.find(arg.expr);
+        if (layout_it != output_layouts.end()) {
+          ApplyOutputLayout(stripe.get(), arg.name, layout_it->second);
+        }
       }
     }
     for (const auto& kvp : program->eval.updates) {
       exec->output_bufs[kvp.first] = kvp.second->buffer;
     }
+    // Binding the same buffer to an input and an output donates the input:
+    // its contents may be overwritten, letting the placer fold the pair into
+    // one allocation instead of scheduling a copy between them.
+    std::unordered_set<Buffer*> donated_bufs;
+    for (const auto& kvp : exec->output_bufs) {
+      donated_bufs.insert(kvp.second.get());
+    }
+    for (const auto& kvp : exec->input_bufs) {
+      if (kvp.second && donated_bufs.count(kvp.second.get())) {
+        stripe->donated_inputs.insert(kvp.first);
+      }
+    }
+    Context ctx;
+    exec->program = GetPlatform()->MakeProgram(ctx, device, target, stripe, &const_bufs);
     return exec.release();
 #endif
 #ifdef PLAIDML_MLIR
@@ -250,13 +359,19 @@ plaidml_executable* plaidml_compile(  //
     ConstBufferManager const_bufs;
     const_bufs.allocator = std::make_shared<PlatformAllocator>(device);
     auto exec = std::make_unique<plaidml_executable>();
+    exec->device = device;
 
     // 1. lower tile dialect -> stripe dialect
     auto module = LowerIntoStripe(*program->program->module);
     // 2. convert MLIR -> stripe
     auto stripe = FromMLIR(*module);
-    exec->program = GetPlatform()->MakeProgram(*ctx, device, target, stripe, &const_bufs);
-    IVLOG(1, "After make program");
+
+    llvm::DenseMap<Value, const char*> output_layouts;
+    for (unsigned i = 0; i < noutputs; i++) {
+      if (outputs[i]->layout && outputs[i]->layout[0]) {
+        output_layouts[outputs[i]->expr->value] = outputs[i]->layout;
+      }
+    }
 
     auto attrName = StripeDialect::getDialectAttrName("name");
     auto stripeFuncOp = cast<FuncOp>(module->getBody()->front());
@@ -271,9 +386,29 @@ plaidml_executable* plaidml_compile(  //
         exec->input_bufs[name] = arg.buffer;
       } else {
         exec->output_bufs[name] = arg.buffer;
+        auto layout_it = output_layouts.find(arg.value);
+        if (layout_it != output_layouts.end()) {
+          ApplyOutputLayout(stripe.get(), name, layout_it->second);
+        }
       }
     }
 
+    // Binding the same buffer to an input and an output donates the input:
+    // its contents may be overwritten, letting the placer fold the pair into
+    // one allocation instead of scheduling a copy between them.
+    std::unordered_set<Buffer*> donated_bufs;
+    for (const auto& kvp : exec->output_bufs) {
+      donated_bufs.insert(kvp.second.get());
+    }
+    for (const auto& kvp : exec->input_bufs) {
+      if (kvp.second && donated_bufs.count(kvp.second.get())) {
+        stripe->donated_inputs.insert(kvp.first);
+      }
+    }
+
+    exec->program = GetPlatform()->MakeProgram(*ctx, device, target, stripe, &const_bufs);
+    IVLOG(1, "After make program");
+
     return exec.release();
 #endif
   });
@@ -304,4 +439,113 @@ void plaidml_executable_run(  //
   });
 }
 
+void plaidml_executable_run_async(  //
+    plaidml_error* err,             //
+    plaidml_executable* exec) {
+  ffi_wrap_void(err, [&] {
+#ifdef PLAIDML_MLIR
+    if (exec->exec) {
+      // The EE path is synchronous; there's nothing to overlap with.
+      exec->exec->invoke();
+      return;
+    }
+#endif  // PLAIDML_MLIR
+    size_t depth = 2;
+    auto env_depth = vertexai::env::Get("PLAIDML_RUN_QUEUE_DEPTH");
+    if (env_depth.length()) {
+      auto env_value = std::atoi(env_depth.c_str());
+      if (env_value > 0) {
+        depth = env_value;
+      }
+    }
+    while (exec->pending.size() >= depth) {
+      exec->pending.front().get();
+      exec->pending.pop_front();
+    }
+    auto ctx = GlobalContext::getContext();
+    exec->pending.push_back(exec->program->Run(*ctx, exec->input_bufs, exec->output_bufs));
+  });
+}
+
+void plaidml_executable_warmup(  //
+    plaidml_error* err,          //
+    plaidml_executable* exec) {
+  ffi_wrap_void(err, [&] {
+#ifdef PLAIDML_MLIR
+    if (exec->exec) {
+      // The EE path JIT-compiles at construction; there's no lazy run-time
+      // state left to prime.
+      return;
+    }
+#endif  // PLAIDML_MLIR
+    auto ctx = GlobalContext::getContext();
+    // Scratch buffers stand in for the caller's bindings so warmup never
+    // clobbers real data; allocating them also exercises the same memory
+    // strategy paths the first real run would.
+    auto scratch = [&](const plaidml_executable::BufferMap& bufs) {
+      plaidml_executable::BufferMap dummies;
+      for (const auto& kvp : bufs) {
+        dummies[kvp.first] = GetPlatform()->MakeBuffer(*ctx, exec->device, kvp.second->size());
+      }
+      return dummies;
+    };
+    exec->program->Run(*ctx, scratch(exec->input_bufs), scratch(exec->output_bufs)).get();
+  });
+}
+
+void plaidml_executable_wait(  //
+    plaidml_error* err,        //
+    plaidml_executable* exec) {
+  ffi_wrap_void(err, [&] {
+    while (!exec->pending.empty()) {
+      exec->pending.front().get();
+      exec->pending.pop_front();
+    }
+  });
+}
+
+void plaidml_executable_output_ready(  //
+    plaidml_error* err,                //
+    plaidml_executable* exec,          //
+    plaidml_buffer* buffer,            //
+    plaidml_output_callback callback,  //
+    void* user_ctx) {
+  ffi_wrap_void(err, [&] {
+    // Mapping one buffer waits only on that buffer's producing kernels
+    // and its device-to-host transfer, not the whole run.
+    auto ctx = GlobalContext::getContext();
+    auto done = buffer->buffer->MapCurrent(*ctx).then(
+        [callback, user_ctx](boost::future<std::unique_ptr<vertexai::tile::View>> view) {
+          try {
+            callback(user_ctx, new plaidml_view{view.get()});
+          } catch (...) {
+            callback(user_ctx, nullptr);
+          }
+        });
+    exec->pending.push_back(std::move(done));
+  });
+}
+
+void plaidml_kernel_profile_enable(  //
+    plaidml_error* err,              //
+    bool enable) {
+  ffi_wrap_void(err, [&] {  //
+    KernelProfile::Instance()->set_enabled(enable);
+  });
+}
+
+plaidml_string* plaidml_kernel_profile_repr(  //
+    plaidml_error* err) {
+  return ffi_wrap<plaidml_string*>(err, nullptr, [&] {  //
+    return new plaidml_string{KernelProfile::Instance()->Report()};
+  });
+}
+
+void plaidml_kernel_profile_clear(  //
+    plaidml_error* err) {
+  ffi_wrap_void(err, [&] {  //
+    KernelProfile::Instance()->Clear();
+  });
+}
+
 }  // extern "C"
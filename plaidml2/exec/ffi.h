@@ -47,6 +47,59 @@ void plaidml_executable_run(  //
     plaidml_error* err,       //
     plaidml_executable* exec);
 
+// Enqueues a run without waiting for it to finish.  Up to
+// PLAIDML_RUN_QUEUE_DEPTH runs (default 2) may be in flight; beyond
+// that, the oldest run is waited for first.  Callers must rotate
+// input/output buffers between in-flight runs.
+void plaidml_executable_run_async(  //
+    plaidml_error* err,             //
+    plaidml_executable* exec);
+
+// Waits for all in-flight runs started by plaidml_executable_run_async.
+void plaidml_executable_wait(  //
+    plaidml_error* err,        //
+    plaidml_executable* exec);
+
+// Runs the full schedule once against freshly allocated scratch buffers,
+// paying the run path's lazy costs (buffer instantiation, kernel warmup,
+// driver finalization) at deploy time instead of on the first inference.
+// The caller's bound buffers are not touched.
+void plaidml_executable_warmup(  //
+    plaidml_error* err,          //
+    plaidml_executable* exec);
+
+// Invoked when an output becomes ready; `view` holds the output's mapped
+// contents and must be freed with plaidml_view_free.  On failure `view` is
+// null.
+typedef void (*plaidml_output_callback)(  //
+    void* user_ctx,                       //
+    plaidml_view* view);
+
+// Registers a callback that fires once `buffer`'s producing kernels and
+// device-to-host transfer complete, without waiting for the rest of the
+// run.  Call after enqueueing a run; plaidml_executable_wait also drains
+// any callbacks still outstanding.
+void plaidml_executable_output_ready(  //
+    plaidml_error* err,                //
+    plaidml_executable* exec,          //
+    plaidml_buffer* buffer,            //
+    plaidml_output_callback callback,  //
+    void* user_ctx);
+
+//
+// Kernel profiling
+//
+
+void plaidml_kernel_profile_enable(  //
+    plaidml_error* err,              //
+    bool enable);
+
+plaidml_string* plaidml_kernel_profile_repr(  //
+    plaidml_error* err);
+
+void plaidml_kernel_profile_clear(  //
+    plaidml_error* err);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
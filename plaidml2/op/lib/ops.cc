@@ -27,10 +27,12 @@ Value concatenate(const Value&);
 Value convolution(const Value&);
 Value cumprod(const Value&);
 Value cumsum(const Value&);
+Value dequantize(const Value&);
 Value dot(const Value&);
 Value elu(const Value&);
 Value expand_dims(const Value&);
 Value flip(const Value&);
+Value fused_convolution(const Value&);
 Value hard_sigmoid(const Value&);
 Value image_resize(const Value&);
 Value max(const Value&);
@@ -40,6 +42,7 @@ Value min(const Value&);
 Value minimum(const Value&);
 Value pool(const Value&);
 Value prod(const Value&);
+Value quantize(const Value&);
 Value relu(const Value&);
 Value repeat(const Value&);
 Value reshape(const Value&);
@@ -523,6 +526,168 @@ std::vector<int64_t>* extend_manual_padding(std::vector<int64_t>* pads, size_t r
   return pads;
 }
 
+Tensor constant_matrix(const std::vector<std::vector<double>>& data) {
+  // Materializes a small constant matrix as a tensor. The op library has no
+  // mechanism for binding literal data to a program input, so the matrix is
+  // built in-graph: an index grid over the target shape is compared against
+  // the flat position of each nonzero entry. This is only reasonable for
+  // matrices with a handful of entries, like the Winograd transforms below;
+  // constant folding collapses the selects at compile time.
+  auto rows = static_cast<int64_t>(data.size());
+  auto cols = static_cast<int64_t>(data[0].size());
+  Tensor One{1.0};
+  TensorIndex i, j;
+  auto Ones = TensorOutput(TensorDim{rows}, TensorDim{cols});
+  Ones(i, j) = One();
+  auto flat = index(Ones, 0) * cols + index(Ones, 1);
+  Tensor M{0.0};
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      if (data[r][c] != 0.0) {
+        M = select(flat == r * cols + c, Tensor{data[r][c]}, M);
+      }
+    }
+  }
+  return M;
+}
+
+Tensor winograd_conv2d(const Tensor& I, const Tensor& K,              //
+                       const TensorDim& XO, const TensorDim& YO,      //
+                       const TensorDim& XP, const TensorDim& YP,      //
+                       const std::string& name) {
+  // Lowers a stride-1 3x3 NXC/XCK convolution via the Winograd F(2x2, 3x3)
+  // minimal filtering algorithm (Lavin & Gray, "Fast Algorithms for
+  // Convolutional Neural Networks"): transform 4x4 input tiles and the
+  // filter into the Winograd domain, multiply elementwise across channels,
+  // and inverse-transform to recover 2x2 output tiles. Each stage is an
+  // ordinary contraction, so the downstream tiling and fusion passes treat
+  // them like any other kernel.
+  auto A = constant_matrix({{1, 0}, {1, 1}, {1, -1}, {0, -1}});
+  auto B = constant_matrix({{1, 0, 0, 0}, {0, 1, -1, 1}, {-1, 1, 1, 0}, {0, 0, 0, -1}});
+  auto G = constant_matrix({{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}});
+
+  TensorDim N, X, Y, CI, CO, S;
+  TensorDim BI{4};  // Input tile size
+  TensorDim BO{2};  // Output tile size (BI - S + 1)
+  I.bind_dims(N, X, Y, CI);
+  K.bind_dims(S, S, CI, CO);
+  auto XB = (XO + BO - 1) / BO;
+  auto YB = (YO + BO - 1) / BO;
+
+  auto U1 = TensorOutput(BI, S, CI, CO);
+  auto U = TensorOutput(BI, BI, CI, CO);
+  auto V1 = TensorOutput(N, BI, BI, XB, YB, CI);
+  auto V = TensorOutput(N, BI, BI, XB, YB, CI);
+  auto M = TensorOutput(N, BI, BI, XB, YB, CO);
+  auto O1 = TensorOutput(N, BO, BI, XB, YB, CO);
+  Tensor O{name, {N, XO, YO, CO}};
+  TensorIndex n, i, j, k, x, y, ci, co;
+  U1(i, j, ci, co) += G(i, k) * K(k, j, ci, co);
+  U(i, j, ci, co) += U1(i, k, ci, co) * G(j, k);
+  V1(n, i, j, x, y, ci) += B(k, i) * I(n, BO * x + k - XP, BO * y + j - YP, ci);
+  V(n, i, j, x, y, ci) += V1(n, i, k, x, y, ci) * B(k, j);
+  M(n, i, j, x, y, co) += V(n, i, j, x, y, ci) * U(i, j, ci, co);
+  O1(n, i, j, x, y, co) += A(k, i) * M(n, k, j, x, y, co);
+  O(n, BO * x + i, BO * y + j, co) += O1(n, i, k, x, y, co) * A(k, j);
+  O.no_reduce();
+  return O;
+}
+
+// Lowers a channel-multiplier-1 depthwise convolution as a single direct
+// contraction: each channel reduces only over its own filter window, so the
+// general grouped lowering's within-group channel index (range 1) and its
+// constraint are dead weight — and their presence keeps the stencil and
+// thread passes from matching the kernel against the direct-conv patterns.
+// Handles forward NXC/NCX inputs with XCK and XGCK filters; other
+// combinations stay on the general path.
+Tensor depthwise_conv(const Tensor& I, const Tensor& F,               //
+                      const std::vector<TensorDim>& O_spatial_dims,   //
+                      const std::vector<TensorDim>& pad_before,       //
+                      const std::vector<int64_t>& strides,            //
+                      const std::vector<int64_t>& dilations,          //
+                      const std::vector<int64_t>& data_dilations,     //
+                      TensorLayout input_layout,                      //
+                      TensorLayout filter_layout,                     //
+                      GroupLayout group_layout,                       //
+                      const std::string& name) {
+  size_t rank = O_spatial_dims.size();
+  TensorDim N, C;
+  TensorDim one{1};
+  std::vector<TensorDim> X(rank);
+  std::vector<TensorDim> K(rank);
+  TensorIndex n("n");
+  TensorIndex c("c");
+  TensorIndex zero{0};
+  std::vector<TensorIndex> x;
+  std::vector<TensorIndex> k;
+  for (size_t i = 0; i < rank; ++i) {
+    x.emplace_back(str(boost::format("x%1%") % i));
+    k.emplace_back(str(boost::format("k%1%") % i));
+  }
+
+  std::vector<TensorDim> I_dims;
+  std::vector<TensorDim> O_dims;
+  std::vector<TensorIndex> I_idxs;
+  std::vector<TensorIndex> O_idxs;
+  switch (input_layout) {
+    case TensorLayout::NCX:
+      I_dims.push_back(N);
+      I_dims.push_back(C);
+      O_dims.push_back(N);
+      O_dims.push_back(C);
+      I_idxs.push_back(n);
+      I_idxs.push_back(c);
+      O_idxs.push_back(n);
+      O_idxs.push_back(c);
+      for (size_t i = 0; i < rank; ++i) {
+        I_dims.push_back(X[i]);
+        O_dims.push_back(O_spatial_dims[i]);
+        I_idxs.emplace_back((strides[i] * x[i] + dilations[i] * k[i] - pad_before[i]) / data_dilations[i]);
+        O_idxs.push_back(x[i]);
+      }
+      break;
+    case TensorLayout::NXC:
+      I_dims.push_back(N);
+      O_dims.push_back(N);
+      I_idxs.push_back(n);
+      O_idxs.push_back(n);
+      for (size_t i = 0; i < rank; ++i) {
+        I_dims.push_back(X[i]);
+        O_dims.push_back(O_spatial_dims[i]);
+        I_idxs.emplace_back((strides[i] * x[i] + dilations[i] * k[i] - pad_before[i]) / data_dilations[i]);
+        O_idxs.push_back(x[i]);
+      }
+      I_dims.push_back(C);
+      O_dims.push_back(C);
+      I_idxs.push_back(c);
+      O_idxs.push_back(c);
+      break;
+    default:
+      throw std::runtime_error("Invalid input_layout");
+  }
+  I.bind_dims(I_dims);
+
+  // The channel axis takes the filter's group position; the size-1
+  // within-group channel positions are pinned at index 0.
+  std::vector<TensorDim> F_dims(K.begin(), K.end());
+  std::vector<TensorIndex> F_idxs(k.begin(), k.end());
+  if (filter_layout == TensorLayout::XGCK) {
+    F_dims.insert(F_dims.end(), {C, one, one});
+    F_idxs.insert(F_idxs.end(), {c, zero, zero});
+  } else if (group_layout == GroupLayout::IN_C) {
+    F_dims.insert(F_dims.end(), {C, one});
+    F_idxs.insert(F_idxs.end(), {c, zero});
+  } else {  // XCK with the group folded into K
+    F_dims.insert(F_dims.end(), {one, C});
+    F_idxs.insert(F_idxs.end(), {zero, c});
+  }
+  F.bind_dims(F_dims);
+
+  Tensor O{name, O_dims};
+  O(O_idxs) += I(I_idxs) * F(F_idxs);
+  return O;
+}
+
 }  // namespace
 
 Value abs(const Value& value) {
@@ -776,7 +941,7 @@ Value convolution(const Value& value) {
   auto input_layout = tensor_layout_from_str(args[9].as_str());
   auto filter_layout = tensor_layout_from_str(args[10].as_str());
   auto group_layout = group_layout_from_str(args[11].as_str());
-  // auto winograd_allowed = args[12].as_bool();  // TODO: Implement Winograd
+  auto winograd_allowed = args[12].as_bool();
   auto name = args[13].as_str();
   auto autogroup_mode = autogroup_mode_from_str(args[14].as_str());
   auto deriv_mode = conv_deriv_mode_from_str(args[15].as_str());
@@ -1085,6 +1250,49 @@ Value convolution(const Value& value) {
     O_spatial_dims.emplace_back(local_output_size);
   }
 
+  // Dispatch eligible convolutions to the Winograd lowering. Eligibility is
+  // by shape (3x3 filter, stride 1, no dilation, ungrouped, forward mode);
+  // profitability is by multiply count: per 2x2 output tile the direct
+  // lowering does 36*CI*CO multiplies while the Winograd GEMM does 16*CI*CO,
+  // but Winograd also pays roughly 128*CI for the input transform and 48*CO
+  // for the inverse transform (the filter transform amortizes across the
+  // spatial extent), so thin layers stay on the direct path.
+  if (winograd_allowed && deriv_mode == ConvDerivMode::NONE && group_layout == GroupLayout::NONE &&
+      spatial_rank == 2 && input_layout == TensorLayout::NXC && filter_layout == TensorLayout::XCK &&
+      std::all_of(strides.begin(), strides.end(), [](int64_t s) { return s == 1; }) &&
+      std::all_of(dilations.begin(), dilations.end(), [](int64_t d) { return d == 1; }) &&
+      std::all_of(data_dilations.begin(), data_dilations.end(), [](int64_t d) { return d == 1; })) {
+    auto F_int_dims = F.shape().int_dims();
+    auto f_ci = F_int_dims[2];
+    auto f_co = F_int_dims[3];
+    if (F_int_dims[0] == 3 && F_int_dims[1] == 3 &&
+        36 * f_ci * f_co > 16 * f_ci * f_co + 128 * f_ci + 48 * f_co) {
+      auto O_wino = winograd_conv2d(I, F, O_spatial_dims[0], O_spatial_dims[1], pad_before[0], pad_before[1], name);
+      return Value{O_wino};
+    }
+  }
+
+  // Dispatch channel-multiplier-1 depthwise convolutions to the direct
+  // single-contraction lowering; see depthwise_conv.
+  if (deriv_mode == ConvDerivMode::NONE && autogroup_mode == AutogroupMode::DEPTHWISE &&
+      (input_layout == TensorLayout::NCX || input_layout == TensorLayout::NXC) &&
+      (filter_layout == TensorLayout::XCK || filter_layout == TensorLayout::XGCK)) {
+    auto F_int_dims = F.shape().int_dims();
+    bool multiplier_one;
+    if (filter_layout == TensorLayout::XGCK) {
+      multiplier_one = F_int_dims[spatial_rank + 1] == 1 && F_int_dims[spatial_rank + 2] == 1;
+    } else if (group_layout == GroupLayout::IN_C) {
+      multiplier_one = F_int_dims[spatial_rank + 1] == 1;
+    } else {
+      multiplier_one = F_int_dims[spatial_rank] == 1;
+    }
+    if (multiplier_one) {
+      auto O_dw = depthwise_conv(I, F, O_spatial_dims, pad_before, strides, dilations, data_dilations,  //
+                                 input_layout, filter_layout, group_layout, name);
+      return Value{O_dw};
+    }
+  }
+
   // Now set up the dimensions of the result to be returned
   switch (deriv_mode) {
     case ConvDerivMode::NONE:
@@ -1342,6 +1550,19 @@ Value cumsum(const Value& value) {
   return Value{O};
 }
 
+Value dequantize(const Value& value) {
+  IVLOG(1, "dequantize");
+  auto args = value.as_tuple();
+  if (args.size() != 3) {
+    throw std::runtime_error("dequantize expects 3 arguments (input, scale, zero_point)");
+  }
+  auto I = args[0].as_tensor();
+  auto scale = args[1].as_float();
+  auto zero_point = args[2].as_int();
+  auto O = (as_float(I, 32) - Tensor{zero_point}) * Tensor{scale};
+  return Value{O};
+}
+
 Value dot(const Value& value) {
   IVLOG(1, "dot");
   auto args = value.as_tuple();
@@ -1501,6 +1722,67 @@ Value flip(const Value& value) {
   return Value{O};
 }
 
+Value fused_convolution(const Value& value) {
+  IVLOG(1, "fused_convolution");
+  // Parameters 0-16 are exactly the convolution op parameters, followed by:
+  // 17. Bias Tensor (or None)
+  // 18. Activation ("none", "relu", or "sigmoid")
+  // 19. Activation Alpha (or None; e.g. the slope of a leaky relu)
+  //
+  // Emitting the bias-add and activation here, directly on the contraction
+  // result, guarantees the whole chain reaches codegen as one producer-consumer
+  // group. When the same layers are built as separate frontend ops, the fusion
+  // pass has to rediscover the chain and cannot always do so (notably for
+  // padded convolutions), materializing the pre-activation tensor in global
+  // memory.
+
+  // Read Arguments
+  auto args = value.as_tuple();
+  if (args.size() != 20) {
+    throw std::runtime_error("fused_convolution op expects 20 arguments");
+  }
+  auto input_layout = tensor_layout_from_str(args[9].as_str());
+  auto deriv_mode = conv_deriv_mode_from_str(args[15].as_str());
+  auto bias = args[17];
+  auto activation = args[18].as_str();
+  auto alpha = args[19];
+
+  if (deriv_mode != ConvDerivMode::NONE) {
+    throw std::runtime_error("fused_convolution only supports forward (non-derivative) convolutions");
+  }
+
+  auto O = convolution(Value{std::vector<Value>(args.begin(), args.begin() + 17)}).as_tensor();
+
+  if (!bias.is_none()) {
+    auto B = bias.as_tensor();
+    if (B.shape().ndims() != 1) {
+      throw std::runtime_error("fused_convolution expects a rank 1 (per-output-channel) bias tensor");
+    }
+    if (input_layout == TensorLayout::NCX) {
+      // Move the channel dim left of the spatial dims so the bias broadcasts
+      TensorDim CO;
+      B.bind_dims({CO});
+      auto spatial_rank = args[2].as_int_tuple().size();
+      std::vector<TensorDim> B_dims{CO};
+      for (size_t i = 0; i < spatial_rank; ++i) {
+        B_dims.emplace_back(1);
+      }
+      B = edsl::reshape(B, B_dims);
+    }
+    O = O + B;
+  }
+
+  if (activation == "relu") {
+    return relu(edsl::make_tuple(Value{O}, alpha, edsl::None(), 0.0));
+  } else if (activation == "sigmoid") {
+    return sigmoid(edsl::make_tuple(Value{O}));
+  } else if (!activation.empty() && activation != "none") {
+    throw std::runtime_error(
+        str(boost::format("Unsupported activation '%1%' requested in fused_convolution op") % activation));
+  }
+  return Value{O};
+}
+
 Value hard_sigmoid(const Value& value) {
   IVLOG(1, "hard_sigmoid");
   auto args = value.as_tuple();
@@ -1914,6 +2196,24 @@ Value pool(const Value& value) {
   }
 }
 
+Value quantize(const Value& value) {
+  IVLOG(1, "quantize");
+  auto args = value.as_tuple();
+  if (args.size() != 3) {
+    throw std::runtime_error("quantize expects 3 arguments (input, scale, zero_point)");
+  }
+  auto I = args[0].as_tensor();
+  auto scale = args[1].as_float();
+  auto zero_point = args[2].as_int();
+  // Affine int8 quantization: q = clamp(round(x / scale) + zero_point, -128, 127)
+  auto Q = Call("round", I / Tensor{scale}) + Tensor{zero_point};
+  auto lo = Tensor{-128};
+  auto hi = Tensor{127};
+  Q = select(Q < lo, lo, Q);
+  Q = select(Q > hi, hi, Q);
+  return Value{as_int(Q, 8)};
+}
+
 Value relu(const Value& value) {
   IVLOG(1, "relu");
   auto args = value.as_tuple();
@@ -2754,10 +3054,12 @@ void RegisterOps() {
   registry->Register("convolution", convolution);
   registry->Register("cumprod", cumprod);
   registry->Register("cumsum", cumsum);
+  registry->Register("dequantize", dequantize);
   registry->Register("dot", dot);
   registry->Register("elu", elu);
   registry->Register("expand_dims", expand_dims);
   registry->Register("flip", flip);
+  registry->Register("fused_convolution", fused_convolution);
   registry->Register("hard_sigmoid", hard_sigmoid);
   registry->Register("image_resize", image_resize);
   registry->Register("max", max);
@@ -2767,6 +3069,7 @@ void RegisterOps() {
   registry->Register("minimum", minimum);
   registry->Register("pool", pool);
   registry->Register("prod", prod);
+  registry->Register("quantize", quantize);
   registry->Register("relu", relu);
   registry->Register("repeat", repeat);
   registry->Register("reshape", reshape);
@@ -115,6 +115,11 @@ inline edsl::Tensor cumsum(const edsl::Tensor& I, int axis) {
   return details::op("cumsum", args).as_tensor();
 }
 
+inline edsl::Tensor dequantize(const edsl::Tensor& I, double scale, int zero_point) {
+  auto args = edsl::make_tuple(I, scale, zero_point);
+  return details::op("dequantize", args).as_tensor();
+}
+
 inline edsl::Tensor dot(const edsl::Tensor& I, const edsl::Tensor& K) {
   auto args = edsl::make_tuple(I, K);
   return details::op("dot", args).as_tensor();
@@ -135,6 +140,52 @@ inline edsl::Tensor flip(const edsl::Tensor& I, int axis) {
   return details::op("flip", args).as_tensor();
 }
 
+// As convolution, but with the bias-add and activation emitted as part of the
+// same op so the chain never materializes the pre-activation tensor.
+inline edsl::Tensor fused_convolution(            //
+    const edsl::Tensor& I,                        //
+    const edsl::Tensor& F,                        //
+    const std::vector<int>& strides,              //
+    const std::vector<int>& dilations,            //
+    const std::vector<int>& data_dilations,       //
+    const std::vector<int>& filter_shape,         //
+    int groups,                                   //
+    const std::string& autopad_mode,              //
+    const std::vector<int>& manual_padding,       //
+    const std::string& input_layout,              //
+    const std::string& filter_layout,             //
+    const std::string& group_layout,              //
+    bool winograd_allowed,                        //
+    const std::string& name,                      //
+    const std::string& autogroup_mode,            //
+    const edsl::Value& bias = edsl::None(),       //
+    const std::string& activation = "none",       //
+    const edsl::Value& alpha = edsl::None()       //
+) {
+  auto args = edsl::make_tuple(          //
+      I,                                 //
+      F,                                 //
+      edsl::make_tuple(strides),         //
+      edsl::make_tuple(dilations),       //
+      edsl::make_tuple(data_dilations),  //
+      edsl::make_tuple(filter_shape),    //
+      groups,                            //
+      autopad_mode,                      //
+      edsl::make_tuple(manual_padding),  //
+      input_layout,                      //
+      filter_layout,                     //
+      group_layout,                      //
+      winograd_allowed,                  //
+      name,                              //
+      autogroup_mode,                    //
+      std::string("none"),               //
+      edsl::make_tuple(std::vector<int>{}),  //
+      bias,                              //
+      activation,                        //
+      alpha);
+  return details::op("fused_convolution", args).as_tensor();
+}
+
 inline edsl::Tensor hard_sigmoid(const edsl::Tensor& I, double slope) {
   auto args = edsl::make_tuple(I, slope);
   return details::op("hard_sigmoid", args).as_tensor();
@@ -202,6 +253,11 @@ inline edsl::Tensor prod(const edsl::Tensor& I, const edsl::Value& axes = edsl::
   return details::op("prod", args).as_tensor();
 }
 
+inline edsl::Tensor quantize(const edsl::Tensor& I, double scale, int zero_point) {
+  auto args = edsl::make_tuple(I, scale, zero_point);
+  return details::op("quantize", args).as_tensor();
+}
+
 class relu {
  protected:
   edsl::Tensor I_;
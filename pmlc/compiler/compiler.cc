@@ -16,6 +16,7 @@
 #include "mlir/Target/LLVMIR.h"
 #include "mlir/Transforms/Passes.h"
 
+#include "base/util/env.h"
 #include "base/util/logging.h"
 #include "pmlc/compiler/registry.h"
 #include "pmlc/conversion/tile_to_pxa/tile_to_pxa.h"
@@ -181,14 +182,25 @@ Executable::Executable(StringRef entry, StringRef target, ModuleOp programModule
   OwningModuleRef module(copy);
   PassManager manager(module->getContext());
 
-  auto shouldPrintBeforePass = [](auto, auto) { return false; };
-  auto shouldPrintAfterPass = [](auto, auto) { return VLOG_IS_ON(3); };
-  manager.enableIRPrinting(shouldPrintBeforePass, shouldPrintAfterPass, true, false, llvm::errs());
+  // IR printing interleaves output from concurrent pass executions, so it
+  // forces the context back to a single thread.  Threading can also be
+  // disabled explicitly with PLAIDML_MLIR_THREADS=0.
+  if (VLOG_IS_ON(3) || vertexai::env::Get("PLAIDML_MLIR_THREADS") == "0") {
+    module->getContext()->disableMultithreading();
+  }
+  if (VLOG_IS_ON(3)) {
+    auto shouldPrintBeforePass = [](auto, auto) { return false; };
+    auto shouldPrintAfterPass = [](auto, auto) { return true; };
+    manager.enableIRPrinting(shouldPrintBeforePass, shouldPrintAfterPass, true, false, llvm::errs());
+  }
+  if (VLOG_IS_ON(1)) {
+    manager.enableTiming();
+  }
 
   manager.addNestedPass<FuncOp>(createCanonicalizerPass());
   manager.addNestedPass<FuncOp>(createCSEPass());
 
-  manager.addPass(createLowerTileToPXAPass());
+  manager.addNestedPass<FuncOp>(createLowerTileToPXAPass());
   manager.addNestedPass<FuncOp>(createCanonicalizerPass());
   manager.addNestedPass<FuncOp>(createCSEPass());
 
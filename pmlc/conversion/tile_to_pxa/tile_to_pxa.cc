@@ -791,8 +791,11 @@ struct ReturnOpConversion : public OpConversionPattern<ReturnOp> {
   }
 };
 
-struct LoweringPass : public mlir::ModulePass<LoweringPass> {
-  void runOnModule() final {
+// Runs per-function so the pass manager can convert the functions of a
+// multi-function module in parallel; see ConvertStripeToAffine for the
+// same structure.
+struct LoweringPass : public mlir::FunctionPass<LoweringPass> {
+  void runOnFunction() final {
     // Set up target (i.e. what is legal)
     mlir::ConversionTarget target(getContext());
     target.addLegalDialect<mlir::AffineOpsDialect>();
@@ -865,8 +868,8 @@ struct LoweringPass : public mlir::ModulePass<LoweringPass> {
         >(&getContext());
 
     // Run the conversion
-    if (failed(applyFullConversion(getModule(), target, patterns, nullptr))) {
-      getModule().dump();
+    if (failed(applyFullConversion(getFunction(), target, patterns, nullptr))) {
+      getFunction().dump();
       emitError(mlir::UnknownLoc::get(&getContext()), "Error lowering tile -> pxa\n");
       signalPassFailure();
       return;
@@ -4,10 +4,13 @@
 
 #include <limits>
 #include <map>
+#include <memory>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Host.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/Translation.h"
 
@@ -19,16 +22,14 @@
 #include "pmlc/dialect/stripe/transcode.h"
 #include "pmlc/dialect/stripe/transforms.h"
 #include "pmlc/dialect/stripe/util.h"
-#include "tile/targets/cpu/heatmap.h"
+#include "tile/targets/cpu/heatmap_model.h"
 
 namespace pmlc {
 namespace dialect {
 namespace stripe {
 
 using vertexai::tile::codegen::proto::MLIR_AutoStencilPass;
-using vertexai::tile::targets::cpu::kHeatmapKeys;
-using vertexai::tile::targets::cpu::kHeatmapSize;
-using vertexai::tile::targets::cpu::kHeatmapValues;
+using vertexai::tile::targets::cpu::Heatmap;
 using BlockArgumentSet = llvm::SmallPtrSet<mlir::BlockArgument, 8>;
 
 // Number of tensors for the matrix multiplication
@@ -36,6 +37,27 @@ const unsigned kNumTensors = 3;
 // Number of searching index, i.e., M, N, K
 const unsigned kNumIndex = 3;
 
+// Register-file geometry of the host, probed through LLVM's feature
+// detection.  Used to score candidate stencils analytically when the
+// measured heatmap (collected on one SKU) has no entry for a shape.
+struct HostSimdInfo {
+  unsigned vector_elems;   // fp32 lanes per vector register
+  unsigned num_registers;  // architectural vector registers
+};
+
+HostSimdInfo GetHostSimdInfo() {
+  llvm::StringMap<bool> features;
+  if (llvm::sys::getHostCPUFeatures(features)) {
+    if (features.lookup("avx512f")) {
+      return {16, 32};
+    }
+    if (features.lookup("avx2") || features.lookup("avx")) {
+      return {8, 16};
+    }
+  }
+  return {4, 16};
+}
+
 class AutoStencil {
  public:
   explicit AutoStencil(const MLIR_AutoStencilPass& opts);
@@ -73,8 +95,10 @@ class AutoStencil {
 
   // Optimization options
   const MLIR_AutoStencilPass& options;
+  // Host SIMD geometry, for scoring shapes the heatmap doesn't cover
+  HostSimdInfo simd;
   // Stencil efficiency heatmap
-  std::map<std::tuple<unsigned, unsigned, unsigned>, double> kHeatmap;
+  std::shared_ptr<Heatmap> heatmap;
   // The current op
   ParallelForOp curOp;
   // Tensors' order
@@ -109,25 +133,14 @@ class AutoStencil {
   unsigned bestTiles[kNumIndex];
 };
 
-AutoStencil::AutoStencil(const MLIR_AutoStencilPass& opts) : options(opts) {
-  for (unsigned i = 0; i < kHeatmapSize; ++i) {
-    kHeatmap.emplace(std::make_tuple(kHeatmapKeys[i][0], kHeatmapKeys[i][1], kHeatmapKeys[i][2]), kHeatmapValues[i]);
-  }
+AutoStencil::AutoStencil(const MLIR_AutoStencilPass& opts) : options(opts), simd(GetHostSimdInfo()) {
+  heatmap = opts.heatmap().empty() ? Heatmap::Default() : Heatmap::Load(opts.heatmap());
 }
 
 std::pair<double, unsigned> AutoStencil::Throughput(unsigned m, unsigned n, unsigned k) {
-  auto iter = kHeatmap.find(std::make_tuple(m, n, k));
-  if (iter != kHeatmap.end()) {
-    return std::make_pair(iter->second, options.startup_cost());
-  }
-  // We mainly care about M and K. If both (m, n - 1, k) and (m, n + 1, k) exist,
-  // we may use their average value for prediction
-  auto iter0 = kHeatmap.find(std::make_tuple(m, n - 1, k));
-  if (n == 1 || iter0 != kHeatmap.end()) {
-    auto iter1 = kHeatmap.find(std::make_tuple(m, n + 1, k));
-    if (iter1 != kHeatmap.end()) {
-      return std::make_pair((n > 1) ? ((iter0->second + iter1->second) / 2) : iter1->second, options.startup_cost());
-    }
+  double measured = heatmap->Throughput(m, n, k);
+  if (measured != 0.0) {
+    return std::make_pair(measured, options.startup_cost());
   }
   // If we cannot find (m, n, k) in the heatmap, try the special cases
   for (const auto& spec : options.special_stencils()) {
@@ -154,6 +167,24 @@ std::pair<double, unsigned> AutoStencil::Throughput(unsigned m, unsigned n, unsi
       return std::make_pair(0.001, spec.startup_cost());
     }
   }
+  if (options.host_parametric()) {
+    // Analytic fallback for SKUs the heatmap wasn't measured on.  An
+    // (m x n x k) microkernel keeps an m x n fp32 accumulator tile in
+    // vector registers, n lanes wide; shapes whose accumulators fit the
+    // register file with room left for the streamed A and B operands
+    // run near peak, and everything else is rejected so the search
+    // stays inside register-blockable shapes.
+    if (n % simd.vector_elems == 0) {
+      unsigned acc_regs = (n / simd.vector_elems) * m;
+      if (acc_regs + 2 * (n / simd.vector_elems) <= simd.num_registers) {
+        // Two FMA issues per cycle, mul+add per lane, derated for loop
+        // overhead on short accumulation chains.
+        double peak = 4.0 * simd.vector_elems;
+        double derate = k / (k + 8.0);
+        return std::make_pair(peak * derate, options.startup_cost());
+      }
+    }
+  }
   return std::make_pair(0.0, 0);
 }
 
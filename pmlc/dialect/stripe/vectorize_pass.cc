@@ -0,0 +1,182 @@
+// Copyright 2019, Intel Corporation
+
+#include "pmlc/dialect/stripe/vectorize_pass.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "base/util/logging.h"
+#include "pmlc/dialect/stripe/analysis.h"
+#include "pmlc/dialect/stripe/dialect.h"
+#include "pmlc/dialect/stripe/ops.h"
+#include "pmlc/dialect/stripe/transcode.h"
+#include "pmlc/dialect/stripe/transforms.h"
+#include "pmlc/dialect/stripe/util.h"
+
+namespace pmlc {
+namespace dialect {
+namespace stripe {
+
+namespace {
+
+// The flattened element stride of an index within a tensor access: the sum
+// over all dimensions of the index's coefficient times the dimension stride.
+// This is how far a memory access moves per step of the index.
+int64_t FlatIdxStride(const FlatTensorAccess& access, mlir::BlockArgument idx) {
+  int64_t total = 0;
+  auto shape = access.base_type.getShape();
+  for (size_t i = 0; i < access.access.size(); i++) {
+    auto it = access.access[i].terms.find(idx);
+    if (it != access.access[i].terms.end()) {
+      total += it->second * shape[i].stride;
+    }
+  }
+  return total;
+}
+
+// Per-index legality of vectorizing a single innermost loop.
+struct VectorizePlan {
+  // legal[i] is false once index i has been ruled out.
+  llvm::SmallVector<bool, 8> legal;
+  // unit_store[i] is true if index i is unit-stride in at least one store or
+  // aggregate; vectorizing an index nothing is stored along gains nothing.
+  llvm::SmallVector<bool, 8> unit_store;
+  // Set when the loop body contains an op we can't reason about at all.
+  bool blocked = false;
+};
+
+// Analyzes the interior of an innermost loop, ruling out indexes which any
+// memory access or affine consumer uses in a non-vectorizable way.
+VectorizePlan AnalyzeLoop(ParallelForOp op) {
+  VectorizePlan plan;
+  size_t n_idxs = op.ranges().size();
+  plan.legal.assign(n_idxs, true);
+  plan.unit_store.assign(n_idxs, false);
+  Block* body = op.getBody();
+
+  auto for_each_idx = [&](const std::function<void(size_t, mlir::BlockArgument)>& fn) {
+    for (size_t i = 0; i < n_idxs; i++) {
+      fn(i, body->getArgument(i));
+    }
+  };
+
+  op.getOperation()->walk([&](Operation* inner) {
+    if (inner == op.getOperation() || plan.blocked) {
+      return;
+    }
+    if (auto load = mlir::dyn_cast<LoadOp>(inner)) {
+      auto access = ComputeAccess(load.from());
+      for_each_idx([&](size_t i, mlir::BlockArgument idx) {
+        // Loads may be contiguous (stride 1) or broadcast (stride 0).
+        int64_t stride = FlatIdxStride(access, idx);
+        if (stride != 0 && stride != 1) {
+          plan.legal[i] = false;
+        }
+      });
+    } else if (auto store = mlir::dyn_cast<StoreOp>(inner)) {
+      auto access = ComputeAccess(store.into());
+      for_each_idx([&](size_t i, mlir::BlockArgument idx) {
+        // Stores must be contiguous: stride 0 would make the lanes conflict.
+        int64_t stride = FlatIdxStride(access, idx);
+        if (stride != 1) {
+          plan.legal[i] = false;
+        } else {
+          plan.unit_store[i] = true;
+        }
+      });
+    } else if (auto agg = mlir::dyn_cast<AggregateOp>(inner)) {
+      auto access = ComputeAccess(agg.into());
+      for_each_idx([&](size_t i, mlir::BlockArgument idx) {
+        // Stride 0 here is a cross-lane reduction; keep those scalar.
+        int64_t stride = FlatIdxStride(access, idx);
+        if (stride != 1) {
+          plan.legal[i] = false;
+        } else {
+          plan.unit_store[i] = true;
+        }
+      });
+    } else if (auto load_idx = mlir::dyn_cast<LoadIndexOp>(inner)) {
+      AffinePolynomial poly(load_idx.from());
+      for_each_idx([&](size_t i, mlir::BlockArgument idx) {
+        if (poly.terms.count(idx)) {
+          plan.legal[i] = false;
+        }
+      });
+    } else if (auto con = mlir::dyn_cast<ConstraintOp>(inner)) {
+      AffinePolynomial poly(con.input());
+      for_each_idx([&](size_t i, mlir::BlockArgument idx) {
+        // A constraint on the index makes the lanes diverge.
+        if (poly.terms.count(idx)) {
+          plan.legal[i] = false;
+        }
+      });
+    } else if (mlir::isa<RefineOp>(inner) || mlir::isa<AffinePolyOp>(inner) || mlir::isa<TerminateOp>(inner) ||
+               inner->hasNoSideEffect()) {
+      // Pure scalar computation is fine along any index.
+    } else {
+      // Specials (gather, scatter, prng, ...) and anything else we don't
+      // understand block the whole loop.
+      plan.blocked = true;
+    }
+  });
+  return plan;
+}
+
+}  // namespace
+
+// For every innermost loop matching reqs, find the best index which every
+// store is unit-stride along and every load is unit-stride or broadcast
+// along, and split a width-sized inner loop off of it.  The inner loop is
+// tagged 'vectorize'; uneven ranges get an interior constraint from Tile,
+// which constraint lifting later pulls out of the fast path.
+void VectorizePass::runOnFunction() {
+  auto reqs = vertexai::tile::stripe::FromProto(options.reqs());
+  uint64_t width = options.width();
+  mlir::FuncOp f = getFunction();
+  f.walk([&](ParallelForOp op) {
+    if (!hasAttrs(op.getOperation(), reqs)) {
+      return;
+    }
+    // Only innermost loops are candidates.
+    bool innermost = true;
+    op.getOperation()->walk([&](ParallelForOp inner) {
+      if (inner.getOperation() != op.getOperation()) {
+        innermost = false;
+      }
+    });
+    if (!innermost) {
+      return;
+    }
+    auto plan = AnalyzeLoop(op);
+    if (plan.blocked) {
+      return;
+    }
+    // Pick the legal index with the largest range.
+    ssize_t best = -1;
+    for (size_t i = 0; i < plan.legal.size(); i++) {
+      if (!plan.legal[i] || !plan.unit_store[i] || op.getRange(i) < 2) {
+        continue;
+      }
+      if (best < 0 || op.getRange(i) > op.getRange(best)) {
+        best = i;
+      }
+    }
+    if (best < 0) {
+      return;
+    }
+    llvm::SmallVector<int64_t, 8> tile_sizes(op.ranges().size(), 1);
+    tile_sizes[best] = std::min(static_cast<int64_t>(width), op.getRange(best));
+    IVLOG(3, "VectorizePass> vectorizing index " << best << " by " << tile_sizes[best]);
+    Tile(op, tile_sizes);
+    // Tile leaves the interior in a fresh inner loop; tag it for the backend.
+    for (auto& inner : *op.getBody()) {
+      if (auto inner_pf = mlir::dyn_cast<ParallelForOp>(inner)) {
+        setOpAttrUnit(inner_pf.getOperation(), inner_pf.getBodyBuilder(), "vectorize");
+      }
+    }
+  });
+}
+
+}  // namespace stripe
+}  // namespace dialect
+}  // namespace pmlc
@@ -0,0 +1,22 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "mlir/Pass/Pass.h"
+
+#include "tile/codegen/codegen.pb.h"
+
+namespace pmlc {
+namespace dialect {
+namespace stripe {
+
+struct VectorizePass : public mlir::FunctionPass<VectorizePass> {
+  explicit VectorizePass(const vertexai::tile::codegen::proto::MLIR_VectorizePass& options) : options(options) {}
+  void runOnFunction() override;
+
+  vertexai::tile::codegen::proto::MLIR_VectorizePass options;
+};
+
+}  // namespace stripe
+}  // namespace dialect
+}  // namespace pmlc
@@ -156,7 +156,7 @@ mlir::Value Gradient::DeriveEltwise(mlir::Value dout, mlir::Value out, size_t id
   auto op = out->getDefiningOp();
   IVLOG(5, "Gradient::DeriveEltwise> dout=" << mlir::debugString(dout) << ", op=" << mlir::debugString(*op)
                                             << ", idx=" << idx);
-  auto deriv = DerivRegistry::Instance()->Resolve(op->getName().getStringRef());
+  const auto& deriv = DerivRegistry::Instance()->Resolve(op->getName().getStringRef());
   llvm::SmallVector<mlir::Value, 3> operands{op->getOperands()};  // TODO: Size
   // TODO: Need to add simple_reduce here, unless done in the "if isa EltwiseOp" block above
   return deriv.fn(out, dout, operands, deriv.user_fn, deriv.user_ctx)[idx];
@@ -6,6 +6,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "pmlc/dialect/tile/ir/ops.h"
 
@@ -44,22 +45,32 @@ class DerivRegistry {
   }
 
   void Register(const std::string& name, const Deriv& fn, void* user_fn, void* user_ctx) {  //
-    if (registry_.count(name)) {
+    if (ids_.count(name)) {
       throw std::runtime_error("Attempted to register deriv '" + name + "', which was already in the DerivRegistry");
     }
-    registry_[name] = DerivEntry{fn, user_fn, user_ctx};
+    ids_.emplace(name, entries_.size());
+    entries_.push_back(DerivEntry{fn, user_fn, user_ctx});
   }
 
-  DerivEntry Resolve(const std::string& name) const {
-    auto it = registry_.find(name);
-    if (it == registry_.end()) {
+  // Maps a derivative name to its dense id, assigned in registration order.
+  // Callers that resolve the same op repeatedly can hold the id and index
+  // straight into the entry table, skipping the string lookup.
+  size_t ResolveId(const std::string& name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
       throw std::runtime_error("Invalid derivative: Unknown function " + name);
     }
     return it->second;
   }
 
+  // Entries are append-only, so the returned reference stays valid.
+  const DerivEntry& Resolve(size_t id) const { return entries_[id]; }
+
+  const DerivEntry& Resolve(const std::string& name) const { return entries_[ResolveId(name)]; }
+
  private:
-  std::unordered_map<std::string, DerivEntry> registry_;
+  std::unordered_map<std::string, size_t> ids_;
+  std::vector<DerivEntry> entries_;
 };
 
 class Gradient {
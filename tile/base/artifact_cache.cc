@@ -0,0 +1,84 @@
+// Copyright 2019, Intel Corp.
+
+#include "tile/base/artifact_cache.h"
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+#include "base/util/uuid.h"
+
+namespace fs = boost::filesystem;
+
+namespace vertexai {
+namespace tile {
+
+ArtifactCache::ArtifactCache(const std::string& dir, bool use_env) {
+  std::string dirname = dir;
+  if (dirname.empty()) {
+    if (!use_env) {
+      return;
+    }
+    dirname = env::Get("PLAIDML_PROGRAM_CACHE");
+    if (dirname.empty()) {
+      return;
+    }
+  }
+  try {
+    dir_ = dirname;
+    fs::create_directories(dir_);
+    enabled_ = true;
+    VLOG(1) << "Using program cache directory: " << dir_;
+  } catch (const std::exception& ex) {
+    LOG(WARNING) << "Disabling program cache; unable to use " << dirname << ": " << ex.what();
+  }
+}
+
+ArtifactCache* ArtifactCache::Instance() {
+  static ArtifactCache instance("", true);
+  return &instance;
+}
+
+bool ArtifactCache::TryGet(const std::string& key, std::string* artifact) {
+  if (!enabled_) {
+    return false;
+  }
+  std::ifstream file(PathFor(key).string(), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  artifact->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (!file.good() && !file.eof()) {
+    return false;
+  }
+  VLOG(1) << "Program cache hit: " << key;
+  return true;
+}
+
+void ArtifactCache::Put(const std::string& key, const std::string& artifact) {
+  if (!enabled_) {
+    return;
+  }
+  try {
+    auto staging = dir_ / (to_string(GetRandomUUID()) + ".tmp");
+    {
+      std::ofstream file(staging.string(), std::ios::binary | std::ios::trunc);
+      file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+      file.write(artifact.data(), artifact.size());
+    }
+    fs::rename(staging, PathFor(key));
+    VLOG(1) << "Program cache store: " << key;
+  } catch (const std::exception& ex) {
+    LOG(WARNING) << "Unable to store program cache entry " << key << ": " << ex.what();
+  }
+}
+
+fs::path ArtifactCache::PathFor(const std::string& key) const {  //
+  return dir_ / (key + ".bin");
+}
+
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,46 @@
+// Copyright 2019, Intel Corp.
+
+#pragma once
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+namespace vertexai {
+namespace tile {
+
+// ArtifactCache persists opaque compiled artifacts (JITted objects, device
+// binaries, etc.) across process restarts.  Artifacts are stored as files in
+// a directory, one per key; keys are expected to be collision-resistant
+// digests of whatever fully determines the artifact (e.g. the canonical
+// Stripe program plus the target configuration).  The cache is disabled
+// unless a directory is supplied, so cold paths pay nothing.
+class ArtifactCache final {
+ public:
+  // Constructs a cache over the given directory; with use_env set, an empty
+  // directory falls back to PLAIDML_PROGRAM_CACHE.
+  explicit ArtifactCache(const std::string& dir = "", bool use_env = false);
+
+  // Gets the singleton instance, configured from PLAIDML_PROGRAM_CACHE.
+  static ArtifactCache* Instance();
+
+  bool enabled() const { return enabled_; }
+
+  // Reads the artifact stored under the given key; returns false on a miss.
+  bool TryGet(const std::string& key, std::string* artifact);
+
+  // Stores an artifact under the given key.  The write is atomic (staged to
+  // a temporary file and renamed), so concurrent processes sharing a cache
+  // directory never observe partial artifacts.  Failures are logged and
+  // swallowed; the cache is strictly an optimization.
+  void Put(const std::string& key, const std::string& artifact);
+
+ private:
+  boost::filesystem::path PathFor(const std::string& key) const;
+
+  bool enabled_ = false;
+  boost::filesystem::path dir_;
+};
+
+}  // namespace tile
+}  // namespace vertexai
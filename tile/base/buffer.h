@@ -72,6 +72,11 @@ class Buffer {
   // asynchronously (e.g. a problem with the underlying device, or with the calls that created the buffer's contents).
   virtual boost::future<std::unique_ptr<View>> MapCurrent(const context::Context& ctx) = 0;
 
+  // Synchronously maps a read/write view of the buffer's current contents when the implementation can produce one
+  // without waiting on device work; returns nullptr otherwise, and the caller falls back to MapCurrent.  Host-backed
+  // buffers override this so CPU-only execution paths skip the per-buffer future machinery entirely.
+  virtual std::unique_ptr<View> MapCurrentSync(const context::Context& ctx) { return nullptr; }
+
   // Synchronously maps a read/write view of a buffer, optionally (implementation-specific) discarding the buffer's
   // existing contents.
   virtual std::unique_ptr<View> MapDiscard(const context::Context& ctx) = 0;
@@ -111,6 +116,10 @@ class SimpleBuffer : public Buffer, public std::enable_shared_from_this<SimpleBu
     return boost::make_ready_future(std::move(view));
   }
 
+  std::unique_ptr<View> MapCurrentSync(const context::Context& ctx) final {
+    return std::make_unique<SimpleView>(data_.data(), data_.size());
+  }
+
   std::unique_ptr<View> MapDiscard(const context::Context& ctx) final {
     return std::make_unique<SimpleView>(data_.data(), data_.size());
   }
@@ -121,5 +130,40 @@ class SimpleBuffer : public Buffer, public std::enable_shared_from_this<SimpleBu
   std::vector<char> data_;
 };
 
+// A buffer that wraps caller-owned host memory without copying it.  The
+// caller guarantees that the memory stays valid and is not concurrently
+// modified for the lifetime of the buffer, and that it is aligned suitably
+// for the datatype it holds; programs read and write it in place, so there
+// is no staging copy in either direction.
+class AdoptedBuffer final : public Buffer {
+  class AdoptedView final : public View {
+   public:
+    AdoptedView(char* data, std::size_t size) : View(data, size) {}
+    void WriteBack(const context::Context& ctx) final {}
+  };
+
+ public:
+  AdoptedBuffer(void* data, uint64_t size) : data_{static_cast<char*>(data)}, size_{size} {}
+
+  uint64_t size() const final { return size_; }
+
+  boost::future<std::unique_ptr<View>> MapCurrent(const context::Context& ctx) final {
+    std::unique_ptr<View> view(new AdoptedView(data_, size_));
+    return boost::make_ready_future(std::move(view));
+  }
+
+  std::unique_ptr<View> MapCurrentSync(const context::Context& ctx) final {
+    return std::make_unique<AdoptedView>(data_, size_);
+  }
+
+  std::unique_ptr<View> MapDiscard(const context::Context& ctx) final {
+    return std::make_unique<AdoptedView>(data_, size_);
+  }
+
+ private:
+  char* data_;
+  uint64_t size_;
+};
+
 }  // namespace tile
 }  // namespace vertexai
@@ -0,0 +1,51 @@
+// Copyright 2019, Intel Corp.
+
+#include "tile/base/kernel_profile.h"
+
+#include <sstream>
+
+#include "base/util/env.h"
+
+namespace vertexai {
+namespace tile {
+
+KernelProfile::KernelProfile() : enabled_(env::Get("PLAIDML_KERNEL_PROFILE") == "1") {}
+
+KernelProfile* KernelProfile::Instance() {
+  static KernelProfile instance;
+  return &instance;
+}
+
+void KernelProfile::Record(const std::string& kname, uint64_t exec_ns, uint64_t queue_wait_ns, uint64_t bytes_moved) {
+  if (!enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{mu_};
+  auto& entry = entries_[kname];
+  entry.runs++;
+  entry.exec_ns += exec_ns;
+  entry.queue_wait_ns += queue_wait_ns;
+  entry.bytes_moved += bytes_moved;
+}
+
+std::map<std::string, KernelProfile::Entry> KernelProfile::Snapshot() const {
+  std::lock_guard<std::mutex> lock{mu_};
+  return entries_;
+}
+
+void KernelProfile::Clear() {
+  std::lock_guard<std::mutex> lock{mu_};
+  entries_.clear();
+}
+
+std::string KernelProfile::Report() const {
+  std::ostringstream ss;
+  for (const auto& kvp : Snapshot()) {
+    ss << kvp.first << "\t" << kvp.second.runs << "\t" << kvp.second.exec_ns << "\t" << kvp.second.queue_wait_ns
+       << "\t" << kvp.second.bytes_moved << "\n";
+  }
+  return ss.str();
+}
+
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,52 @@
+// Copyright 2019, Intel Corp.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace vertexai {
+namespace tile {
+
+// KernelProfile accumulates per-kernel execution statistics, keyed by the
+// generated kernel name (which embeds the originating Stripe block name).
+// HALs that read device timestamps record into the process-wide instance;
+// callers query a snapshot through the plaidml2 exec API, so production
+// latency tracking doesn't require parsing event logs.  Collection is off
+// unless enabled here or via PLAIDML_KERNEL_PROFILE=1.
+class KernelProfile final {
+ public:
+  struct Entry {
+    uint64_t runs = 0;
+    uint64_t exec_ns = 0;        // Device execution time (start to end)
+    uint64_t queue_wait_ns = 0;  // Time between enqueue and execution start
+    uint64_t bytes_moved = 0;    // Bytes accessed, per the kernel's cost model
+  };
+
+  static KernelProfile* Instance();
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  void Record(const std::string& kname, uint64_t exec_ns, uint64_t queue_wait_ns, uint64_t bytes_moved);
+
+  std::map<std::string, Entry> Snapshot() const;
+
+  void Clear();
+
+  // Renders a snapshot as tab-separated lines:
+  //   kname <tab> runs <tab> exec_ns <tab> queue_wait_ns <tab> bytes_moved
+  std::string Report() const;
+
+ private:
+  KernelProfile();
+
+  bool enabled_ = false;
+  mutable std::mutex mu_;
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace tile
+}  // namespace vertexai
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <list>
 #include <map>
@@ -13,10 +14,18 @@ namespace tile {
 // A simplistic LRU cache implementation.
 // The cache must be externally synchronized.
 // Value must be CopyConstructible.
+//
+// When constructed with a byte budget, the cache switches from recency-based
+// to cost-aware eviction (greedy-dual-size-frequency): each entry carries a
+// priority of clock + hits * cost / bytes, the entry with the lowest priority
+// is evicted first, and the clock is advanced to the evicted priority so that
+// stale-but-expensive entries age out eventually.  Costs and sizes are
+// reported after the fact via Annotate(), since they're typically only known
+// once an entry has been built.
 template <typename Key, typename Value, typename Compare = std::less<Key>>
 class LruCache {
  public:
-  explicit LruCache(std::size_t size_max) : size_max_(size_max) {}
+  explicit LruCache(std::size_t size_max, std::size_t bytes_max = 0) : size_max_(size_max), bytes_max_(bytes_max) {}
 
   // Finds the value associated with the specified key.  If the value is not in
   // the cache, Builder() will be invoked to construct it; this adds a value to
@@ -31,38 +40,97 @@ class LruCache {
     auto it = entries_.find(key);
 
     if (it != entries_.end()) {
+      it->second.hits++;
+      it->second.priority = clock_ + Score(it->second);
       lru_.erase(it->second.lru_ent);
       it->second.lru_ent = lru_.emplace(lru_.begin(), LruEnt{it});
       return it->second.value;
     }
 
     Value result = builder();
-    if (size_max_ > 0) {
+    if (size_max_ > 0 || bytes_max_ > 0) {
       it = entries_.emplace(key, MapEnt{result, lru_.end()}).first;
-      while (lru_.size() > 0 && size_max_ < entries_.size()) {
-        entries_.erase(lru_.back().map_ent);
-        lru_.pop_back();
-      }
+      it->second.priority = clock_ + Score(it->second);
       it->second.lru_ent = lru_.emplace(lru_.begin(), LruEnt{it});
+      EvictOverBudget(it);
     }
     return result;
   }
 
+  // Records the measured build cost and resident byte size of an entry, once
+  // known; unknown keys (e.g. already evicted) are ignored.  Only meaningful
+  // for byte-bounded caches; count-bounded caches stay purely LRU.
+  void Annotate(const Key& key, double cost, std::size_t bytes) {
+    std::unique_lock<std::mutex> lock{mu_};
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return;
+    }
+    bytes_total_ += bytes - it->second.bytes;
+    it->second.cost = cost;
+    it->second.bytes = bytes;
+    it->second.priority = clock_ + Score(it->second);
+    EvictOverBudget(entries_.end());
+  }
+
  private:
   struct LruEnt;
 
   struct MapEnt {
     Value value;
     typename std::list<LruEnt>::iterator lru_ent;
+    std::size_t hits = 1;
+    double cost = 1.0;
+    std::size_t bytes = 0;
+    double priority = 0.0;
   };
 
   struct LruEnt {
     typename std::map<Key, MapEnt>::iterator map_ent;
   };
 
+  double Score(const MapEnt& ent) const { return ent.hits * ent.cost / std::max<std::size_t>(ent.bytes, 1); }
+
+  // Evicts until both the entry-count and byte budgets are met, sparing the
+  // entry just inserted (if any).  Count-bounded caches evict by recency;
+  // byte-bounded caches evict the lowest-priority entry, found by a linear
+  // scan -- these caches hold tens of entries, not thousands.
+  void EvictOverBudget(typename std::map<Key, MapEnt>::iterator keep) {
+    while (entries_.size() > 1 &&
+           ((size_max_ > 0 && entries_.size() > size_max_) || (bytes_max_ > 0 && bytes_total_ > bytes_max_))) {
+      typename std::map<Key, MapEnt>::iterator victim;
+      if (bytes_max_ > 0) {
+        victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+          if (it == keep) {
+            continue;
+          }
+          if (victim == entries_.end() || it->second.priority < victim->second.priority) {
+            victim = it;
+          }
+        }
+        if (victim == entries_.end()) {
+          break;
+        }
+        clock_ = victim->second.priority;
+      } else {
+        victim = lru_.back().map_ent;
+        if (victim == keep) {
+          break;
+        }
+      }
+      bytes_total_ -= victim->second.bytes;
+      lru_.erase(victim->second.lru_ent);
+      entries_.erase(victim);
+    }
+  }
+
   // The maximum cache size.
   const std::size_t size_max_;
 
+  // The maximum total annotated bytes; 0 disables byte accounting.
+  const std::size_t bytes_max_;
+
   // The map/LRU mutex.
   std::mutex mu_;
 
@@ -72,6 +140,10 @@ class LruCache {
   // The LRU list.  Recently used entries are at the front; the next entry to
   // evict is at the back.
   std::list<LruEnt> lru_;
+
+  // Total annotated bytes and the greedy-dual aging clock.
+  std::size_t bytes_total_ = 0;
+  double clock_ = 0.0;
 };
 
 }  // namespace tile
@@ -31,6 +31,18 @@ class Platform {
       const std::string& device,               //
       std::uint64_t size) = 0;
 
+  // Wraps caller-owned host memory as a buffer without copying it.  The
+  // caller keeps ownership and guarantees the memory stays valid (and
+  // suitably aligned) for the buffer's lifetime; see AdoptedBuffer.
+  // Platforms whose devices cannot access host memory in place may throw.
+  virtual std::shared_ptr<Buffer> MakeHostBuffer(  //
+      const context::Context& ctx,                 //
+      const std::string& device,                   //
+      void* data,                                  //
+      std::uint64_t size) {
+    return std::make_shared<AdoptedBuffer>(data, size);
+  }
+
   // Builds (pre-compiling if possible) a program for executing the supplied Program
   virtual std::shared_ptr<Program> MakeProgram(  //
       const context::Context& ctx,               //
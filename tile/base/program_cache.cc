@@ -2,30 +2,50 @@
 
 #include "tile/base/program_cache.h"
 
+#include <chrono>
 #include <map>
 #include <sstream>
 
+#include "base/util/env.h"
 #include "base/util/logging.h"
 
 namespace vertexai {
 namespace tile {
 
+namespace {
+
+std::size_t BytesMax() {
+  auto mb = env::Get("PLAIDML_PROGRAM_CACHE_MB");
+  if (mb.size()) {
+    return static_cast<std::size_t>(std::atoi(mb.c_str())) << 20;
+  }
+  return 0;
+}
+
+}  // namespace
+
 ProgramCache::ProgramCache(std::shared_ptr<Platform> platform, std::size_t size_max)
-    : platform_{platform}, cache_{size_max} {}
+    : platform_{platform}, cache_{size_max, BytesMax()} {}
 
 std::tuple<std::string, std::shared_ptr<Program>> ProgramCache::GetProgram(const context::Context& ctx,
                                                                            const std::string& fallback_id,
                                                                            const tile::proto::Program& program,
                                                                            ConstBufferManager* const_bufs) {
-  auto entry = GetEntry(fallback_id, program);
+  auto key = MakeKey(program);
+  auto entry = GetEntry(key, fallback_id, program);
   VLOG(3) << "Using compiled program " << entry->id() << " for user program " << program.id();
-  return std::make_tuple(entry->id(), entry->GetProgram(ctx, platform_.get(), const_bufs));
+  auto compiled = entry->GetProgram(ctx, platform_.get(), const_bufs);
+  // Now that the compile cost and size are known, feed them back so that
+  // byte-bounded caches can weigh eviction by the cost of recompilation.
+  cache_.Annotate(key, entry->compile_secs(), entry->bytes());
+  return std::make_tuple(entry->id(), compiled);
 }
 
 std::shared_ptr<lang::Program> ProgramCache::GetParsedProgram(const context::Context& ctx,
                                                               const std::string& fallback_id,
                                                               const tile::proto::Program& program) {
-  return GetEntry(fallback_id, program)->GetParsedProgram();
+  auto key = MakeKey(program);
+  return GetEntry(key, fallback_id, program)->GetParsedProgram();
 }
 
 namespace {
@@ -48,8 +68,7 @@ void SerializeShapemap(std::ostringstream* serialized, const M& m) {
 
 }  // namespace
 
-std::shared_ptr<ProgramCache::Entry> ProgramCache::GetEntry(const std::string& fallback_id,
-                                                            const tile::proto::Program& program) {
+ProgramCache::Key ProgramCache::MakeKey(const tile::proto::Program& program) {
   std::ostringstream serialized;
 
   // N.B. For cache lookup, we only serialize the parts of the program that
@@ -60,10 +79,15 @@ std::shared_ptr<ProgramCache::Entry> ProgramCache::GetEntry(const std::string& f
   SerializeShapemap(&serialized, program.inputs());
   SerializeShapemap(&serialized, program.outputs());
 
+  return Key{program.dev_id(), serialized.str()};
+}
+
+std::shared_ptr<ProgramCache::Entry> ProgramCache::GetEntry(const Key& key, const std::string& fallback_id,
+                                                            const tile::proto::Program& program) {
   // The cache itself must be externally synchronized.
   std::lock_guard<std::mutex> lock{mu_};
 
-  return cache_.Lookup(Key{program.dev_id(), serialized.str()}, [&]() {
+  return cache_.Lookup(key, [&]() {
     std::string cid = "c" + std::to_string(next_id_++);
     if (program.id().size()) {
       cid = cid + '_' + program.id();
@@ -81,7 +105,12 @@ std::shared_ptr<ProgramCache::Entry> ProgramCache::GetEntry(const std::string& f
 std::shared_ptr<Program> ProgramCache::Entry::GetProgram(const context::Context& ctx, Platform* dev,
                                                          ConstBufferManager* const_bufs) {
   std::call_once(compile_once_, [this, ctx, dev, const_bufs]() {
+    // The compiled program's footprint isn't exposed by the Platform
+    // interface, so the serialized program stands in as the size proxy.
+    bytes_ = proto_.ByteSizeLong();
+    auto start = std::chrono::steady_clock::now();
     compiled_ = dev->MakeProgram(ctx, proto_, const_bufs);
+    compile_secs_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     proto_.Clear();
   });
   return compiled_;
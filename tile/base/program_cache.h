@@ -19,6 +19,11 @@ namespace vertexai {
 namespace tile {
 
 // ProgramCache implements an LRU Tile program cache.
+//
+// When PLAIDML_PROGRAM_CACHE_MB is set, the cache is additionally bounded by
+// that many megabytes of program state and evicts by measured recompile cost
+// and hit frequency rather than by recency alone, so that a rarely-but-
+// regularly used program that takes a minute to compile outlives a cheap one.
 class ProgramCache final {
  public:
   ProgramCache(std::shared_ptr<Platform> platform, std::size_t size_max);
@@ -66,15 +71,24 @@ class ProgramCache final {
 
     std::shared_ptr<lang::Program> GetParsedProgram();
 
+    // The measured compile time and program size; valid once GetProgram has
+    // returned at least once.
+    double compile_secs() const { return compile_secs_; }
+    std::size_t bytes() const { return bytes_; }
+
    private:
     std::string id_;
     std::once_flag compile_once_, parse_once_;
     tile::proto::Program proto_;
     std::shared_ptr<Program> compiled_;
     std::shared_ptr<lang::Program> parsed_;
+    double compile_secs_ = 0.0;
+    std::size_t bytes_ = 0;
   };
 
-  std::shared_ptr<Entry> GetEntry(const std::string& fallback_id, const tile::proto::Program& program);
+  Key MakeKey(const tile::proto::Program& program);
+
+  std::shared_ptr<Entry> GetEntry(const Key& key, const std::string& fallback_id, const tile::proto::Program& program);
 
   std::shared_ptr<Platform> platform_;
 
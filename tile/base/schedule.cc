@@ -2,6 +2,9 @@
 
 #include "tile/base/schedule.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/util/error.h"
 
 namespace vertexai {
@@ -19,6 +22,9 @@ void Alloc::Log(el::base::type::ostream_t& os) const {
     os << "Tmp: ";
   }
   os << byte_size << " bytes";
+  if (unit_bytes) {
+    os << " (+" << unit_bytes << "/batch)";
+  }
   if (safe_self_alias_allocs.size()) {
     os << " May-alias:";
     for (const auto& ap : safe_self_alias_allocs) {
@@ -35,6 +41,9 @@ void Step::Log(el::base::type::ostream_t& os) const {
     case Tag::kCopy:
       os << "Copy(" << byte_count << ')';
       break;
+    case Tag::kCallback:
+      os << "Callback: " << callback_name;
+      break;
     default:
       os << "<InvalidStep>";
   }
@@ -96,11 +105,16 @@ void Schedule::Log(el::base::type::ostream_t& os) const {
 }
 
 void ScheduleToProto(proto::Schedule* pb, const Schedule& schedule) {
+  pb->set_planned_batch(schedule.planned_batch);
   for (const auto& alloc : schedule.allocs) {
     auto* apb = pb->add_allocs();
     apb->set_size(alloc.byte_size);
     apb->set_input(alloc.input);
     apb->set_output(alloc.output);
+    apb->set_unit_bytes(alloc.unit_bytes);
+    for (const auto& ap : alloc.safe_self_alias_allocs) {
+      apb->add_safe_self_alias_aidxs(ap->idx);
+    }
   }
 
   std::size_t sidx = 0;
@@ -115,6 +129,7 @@ void ScheduleToProto(proto::Schedule* pb, const Schedule& schedule) {
         run_pb->set_kidx(step.kidx);
         for (const auto& output : step.outputs) {
           run_pb->add_output_aidxs(output.allocp->idx);
+          run_pb->add_output_add_deps(output.add_dep);
         }
         for (const auto& input : step.inputs) {
           run_pb->add_input_aidxs(input->idx);
@@ -136,6 +151,19 @@ void ScheduleToProto(proto::Schedule* pb, const Schedule& schedule) {
         copy_pb->set_from_aidx(step.inputs[0]->idx);
         copy_pb->set_to_aidx(step.outputs[0].allocp->idx);
         copy_pb->set_count_bytes(step.byte_count);
+        copy_pb->set_output_add_dep(step.outputs[0].add_dep);
+        break;
+      }
+      case Step::Tag::kCallback: {
+        auto* callback_pb = spb->mutable_callback();
+        callback_pb->set_name(step.callback_name);
+        for (const auto& output : step.outputs) {
+          callback_pb->add_output_aidxs(output.allocp->idx);
+          callback_pb->add_output_add_deps(output.add_dep);
+        }
+        for (const auto& input : step.inputs) {
+          callback_pb->add_input_aidxs(input->idx);
+        }
         break;
       }
       default:
@@ -145,6 +173,167 @@ void ScheduleToProto(proto::Schedule* pb, const Schedule& schedule) {
   }
 }
 
+Schedule ScheduleFromProto(const proto::Schedule& pb) {
+  Schedule ret;
+  ret.planned_batch = pb.planned_batch() ? pb.planned_batch() : 1;
+
+  std::vector<Alloc*> allocs;
+  allocs.reserve(pb.allocs_size());
+  for (const auto& apb : pb.allocs()) {
+    auto ait = ret.allocs.emplace(ret.allocs.end());
+    ait->byte_size = apb.size();
+    ait->unit_bytes = apb.unit_bytes();
+    ait->input = apb.input();
+    ait->output = apb.output();
+    allocs.push_back(&*ait);
+  }
+  {
+    std::size_t aidx = 0;
+    for (const auto& apb : pb.allocs()) {
+      for (auto alias_aidx : apb.safe_self_alias_aidxs()) {
+        if (allocs.size() <= alias_aidx) {
+          throw error::Internal{"In schedule parsing: alloc a" + std::to_string(aidx) +
+                                " aliases out-of-range alloc a" + std::to_string(alias_aidx)};
+        }
+        allocs[aidx]->safe_self_alias_allocs.insert(allocs[alias_aidx]);
+      }
+      aidx++;
+    }
+  }
+
+  auto alloc_at = [&allocs](std::uint64_t aidx, std::size_t sidx) {
+    if (allocs.size() <= aidx) {
+      throw error::Internal{"In schedule parsing: step " + std::to_string(sidx) +
+                            " references out-of-range alloc a" + std::to_string(aidx)};
+    }
+    return allocs[aidx];
+  };
+
+  std::vector<Step*> steps;
+  steps.reserve(pb.steps_size());
+  std::size_t sidx = 0;
+  for (const auto& spb : pb.steps()) {
+    Step* step = nullptr;
+    switch (spb.action_case()) {
+      case proto::Step::kRun: {
+        step = &*ret.steps.emplace(ret.steps.end(), Step{Step::Tag::kRun});
+        step->kidx = spb.run().kidx();
+        int oidx = 0;
+        for (auto aidx : spb.run().output_aidxs()) {
+          bool add_dep = oidx < spb.run().output_add_deps_size() ? spb.run().output_add_deps(oidx) : true;
+          step->outputs.push_back(OutputInfo{alloc_at(aidx, sidx), add_dep});
+          oidx++;
+        }
+        for (auto aidx : spb.run().input_aidxs()) {
+          step->inputs.push_back(alloc_at(aidx, sidx));
+        }
+        break;
+      }
+      case proto::Step::kCopy: {
+        step = &*ret.steps.emplace(ret.steps.end(), Step{Step::Tag::kCopy});
+        step->byte_count = spb.copy().count_bytes();
+        step->outputs.push_back(OutputInfo{alloc_at(spb.copy().to_aidx(), sidx), spb.copy().output_add_dep()});
+        step->inputs.push_back(alloc_at(spb.copy().from_aidx(), sidx));
+        break;
+      }
+      case proto::Step::kCallback: {
+        // N.B. Only the name comes back; the caller must rebind the function.
+        step = &*ret.steps.emplace(ret.steps.end(), Step{Step::Tag::kCallback});
+        step->callback_name = spb.callback().name();
+        int oidx = 0;
+        for (auto aidx : spb.callback().output_aidxs()) {
+          bool add_dep = oidx < spb.callback().output_add_deps_size() ? spb.callback().output_add_deps(oidx) : true;
+          step->outputs.push_back(OutputInfo{alloc_at(aidx, sidx), add_dep});
+          oidx++;
+        }
+        for (auto aidx : spb.callback().input_aidxs()) {
+          step->inputs.push_back(alloc_at(aidx, sidx));
+        }
+        break;
+      }
+      default:
+        throw error::Internal{"In schedule parsing: step " + std::to_string(sidx) + " has an invalid action"};
+    }
+    steps.push_back(step);
+    sidx++;
+  }
+  sidx = 0;
+  for (auto& step : ret.steps) {
+    for (auto dep_sidx : pb.steps(sidx).deps()) {
+      if (steps.size() <= dep_sidx) {
+        throw error::Internal{"In schedule parsing: step " + std::to_string(sidx) +
+                              " depends on out-of-range step s" + std::to_string(dep_sidx)};
+      }
+      step.deps.insert(steps[dep_sidx]);
+    }
+    sidx++;
+  }
+
+  ret.Reindex();
+  return ret;
+}
+
+Schedule BindBatch(const Schedule& schedule, std::uint64_t batch) {
+  if (batch < 1 || schedule.planned_batch < batch) {
+    throw error::InvalidArgument{"Cannot bind a schedule planned for batch " +
+                                 std::to_string(schedule.planned_batch) + " to batch " + std::to_string(batch)};
+  }
+  std::uint64_t dropped = schedule.planned_batch - batch;
+
+  Schedule ret;
+  ret.planned_batch = batch;
+
+  // Rebuild the allocs, shrinking each by its per-row quantum.
+  std::vector<Alloc*> allocs;
+  allocs.reserve(schedule.allocs.size());
+  for (const auto& alloc : schedule.allocs) {
+    auto ait = ret.allocs.emplace(ret.allocs.end(), alloc);
+    ait->byte_size = alloc.byte_size - dropped * alloc.unit_bytes;
+    ait->safe_self_alias_allocs.clear();
+    allocs.push_back(&*ait);
+  }
+  auto src_ait = schedule.allocs.begin();
+  for (auto& alloc : ret.allocs) {
+    for (Alloc* ap : src_ait->safe_self_alias_allocs) {
+      alloc.safe_self_alias_allocs.insert(allocs[ap->idx]);
+    }
+    ++src_ait;
+  }
+
+  // Rebuild the steps against the new allocs.
+  std::vector<Step*> steps;
+  steps.reserve(schedule.steps.size());
+  for (const auto& step : schedule.steps) {
+    auto sit = ret.steps.emplace(ret.steps.end(), Step{step.tag});
+    sit->idx = step.idx;
+    sit->kidx = step.kidx;
+    sit->byte_count = step.byte_count;
+    sit->callback = step.callback;
+    sit->callback_name = step.callback_name;
+    for (Alloc* input : step.inputs) {
+      sit->inputs.push_back(allocs[input->idx]);
+    }
+    for (const auto& oi : step.outputs) {
+      sit->outputs.push_back(OutputInfo{allocs[oi.allocp->idx], oi.add_dep});
+    }
+    if (sit->tag == Step::Tag::kCopy && sit->inputs.size() && sit->outputs.size()) {
+      // A whole-tensor copy of a batch-scaled alloc only has the bound
+      // number of rows to move.
+      sit->byte_count = std::min({sit->byte_count, sit->inputs[0]->byte_size, sit->outputs[0].allocp->byte_size});
+    }
+    steps.push_back(&*sit);
+  }
+  auto src_sit = schedule.steps.begin();
+  for (auto& step : ret.steps) {
+    for (Step* dep : src_sit->deps) {
+      step.deps.insert(steps[dep->idx]);
+    }
+    ++src_sit;
+  }
+
+  return ret;
+}
+
 }  // namespace schedule
 }  // namespace tile
 }  // namespace vertexai
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <list>
 #include <memory>
 #include <set>
@@ -14,6 +15,11 @@
 
 namespace vertexai {
 namespace tile {
+
+namespace hal {
+class Buffer;
+}  // namespace hal
+
 namespace schedule {
 
 // Describes a memory allocation for use by a program.
@@ -26,6 +32,10 @@ struct Alloc {
 
   std::size_t idx = 0;
   std::uint64_t byte_size = 0;
+  // Bytes this alloc grows per row of the schedule's batch parameter; zero
+  // for batch-invariant allocations.  See Schedule::planned_batch and
+  // BindBatch.
+  std::uint64_t unit_bytes = 0;
   std::set<Alloc*> safe_self_alias_allocs;
   std::string input;   // If non-empty, this is a program input.
   std::string output;  // If non-empty, this is a program output.
@@ -43,7 +53,7 @@ struct OutputInfo {
 
 // A particular step to take in evaluating a program.
 struct Step {
-  enum class Tag { kRun, kCopy };
+  enum class Tag { kRun, kCopy, kCallback };
 
   explicit Step(Tag tag_) : tag{tag_} {}
 
@@ -57,6 +67,15 @@ struct Step {
 
   std::size_t kidx = 0;          // Used for run steps
   std::uint64_t byte_count = 0;  // Used for copy steps
+
+  // Used for callback steps: invoked on the host once the step's
+  // dependencies have resolved, with the step's parameter buffers (outputs
+  // first, then inputs, matching run-step parameter order).  The callback is
+  // responsible for mapping any buffers it needs host access to.  Note that
+  // only callback_name survives serialization; the function itself must be
+  // rebound by whatever injects the step.
+  std::function<void(const std::vector<std::shared_ptr<hal::Buffer>>&)> callback;
+  std::string callback_name;
 };
 
 inline MAKE_LOGGABLE(Step, step, os) {
@@ -71,6 +90,11 @@ struct Schedule {
 
   std::list<Alloc> allocs;
   std::list<Step> steps;
+
+  // The batch size the schedule's byte sizes were planned at.  Schedules
+  // whose allocs carry unit_bytes annotations can be rebound to any smaller
+  // batch via BindBatch.
+  std::uint64_t planned_batch = 1;
 };
 
 inline MAKE_LOGGABLE(Schedule, schedule, os) {
@@ -81,6 +105,19 @@ inline MAKE_LOGGABLE(Schedule, schedule, os) {
 // Serializes a schedule to a protocol buffer.
 void ScheduleToProto(proto::Schedule* pb, const Schedule& schedule);
 
+// Reconstructs a schedule from its protocol buffer form; the result is
+// indexed.  Callback steps come back with only their names bound (see
+// CallbackStep); the caller must rebind their functions before running.
+// Raises error::Internal if the proto's cross-references are inconsistent.
+Schedule ScheduleFromProto(const proto::Schedule& pb);
+
+// Rebinds a schedule planned at planned_batch to a smaller batch, shrinking
+// each alloc by unit_bytes per dropped batch row and clamping copy steps to
+// the bound alloc sizes, without re-running scheduling or placement.  The
+// source schedule must have been indexed (see Reindex); the result's alloc
+// and step graphs are rebuilt, so it's fully independent of the source.
+Schedule BindBatch(const Schedule& schedule, std::uint64_t batch);
+
 }  // namespace schedule
 }  // namespace tile
 }  // namespace vertexai
@@ -8,6 +8,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #include "tile/proto/shape.pb.h"
 
 namespace vertexai {
@@ -222,13 +224,18 @@ struct TensorDimension {
   }
 };
 
+// Nearly every shape in practice has rank <= 4; keeping the dimensions
+// inline makes the ubiquitous shape copies in compile (alias analysis) and
+// run-time binding paths allocation-free.
+using TensorDimensions = boost::container::small_vector<TensorDimension, 6>;
+
 struct TensorShape {
   TensorShape() = default;
-  TensorShape(DataType type, const std::vector<TensorDimension>& dims, const std::string& layout = "")
+  TensorShape(DataType type, const TensorDimensions& dims, const std::string& layout = "")
       : type(type), dims(dims), layout(layout) {}
 
   DataType type = DataType::INVALID;
-  std::vector<TensorDimension> dims;
+  TensorDimensions dims;
   bool is_const = false;
   std::string codec;
   std::string layout;
@@ -275,8 +282,8 @@ struct TensorShape {
   size_t sizes_product_bytes() const { return sizes_product() * byte_width(type); }
 
   // Sort dims from low stride to high stride
-  std::vector<TensorDimension> natural_dims() const {
-    std::vector<TensorDimension> ret = dims;
+  TensorDimensions natural_dims() const {
+    TensorDimensions ret = dims;
     std::sort(ret.begin(), ret.end(), [](const TensorDimension& a, const TensorDimension& b) {
       return std::abs(a.stride) < std::abs(b.stride);
     });
@@ -327,7 +334,7 @@ std::ostream& operator<<(std::ostream& os, const TensorDimension& dim);
 
 inline TensorShape SimpleShape(DataType type, const std::vector<size_t>& sizes, const std::string& layout = "") {
   int64_t stride = 1;
-  std::vector<TensorDimension> dims(sizes.size());
+  TensorDimensions dims(sizes.size());
   for (int i = sizes.size() - 1; i >= 0; i--) {
     dims[i].stride = stride;
     dims[i].size = sizes[i];
@@ -1,11 +1,37 @@
 #include "tile/bilp/ilp_solver.h"
 
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include "base/util/env.h"
+#include "tile/base/lru_cache.h"
+
 namespace vertexai {
 namespace tile {
 namespace bilp {
 
 using namespace math;  // NOLINT
 
+namespace {
+
+// Bounds problems repeat heavily across the contractions of a typical
+// network, so a modest window captures most of a compile.
+constexpr std::size_t kSolveCacheSize = 1024;
+
+bool cache_enabled() { return env::Get("PLAIDML_ILP_CACHE") != "0"; }
+
+template <typename C>
+std::string constraint_key(const std::vector<C>& constraints) {
+  std::ostringstream key;
+  for (const auto& c : constraints) {
+    key << c << ";";
+  }
+  return key.str();
+}
+
+}  // namespace
+
 std::map<std::string, Rational> ILPSolver::reportSolution() const {
   std::vector<Rational> sym_soln = getSymbolicSolution();
   std::map<std::string, Rational> soln;
@@ -24,16 +50,62 @@ std::map<Polynomial<Rational>, ILPResult> ILPSolver::batch_solve(const std::vect
                                                                  const std::vector<Polynomial<Rational>>& objectives) {
   // Solve a batch of ILP problems, all with the same constraints but different objectives
   // A wrapper for the Tableau version
-  Tableau t = makeStandardFormTableau(constraints);
-  return batch_solve(&t, objectives);
+  if (!cache_enabled()) {
+    Tableau t = makeStandardFormTableau(constraints);
+    return batch_solve(&t, objectives);
+  }
+  return cached_batch_solve(
+      constraint_key(constraints), [&]() { return makeStandardFormTableau(constraints); }, objectives);
 }
 
 std::map<Polynomial<Rational>, ILPResult> ILPSolver::batch_solve(const std::vector<SimpleConstraint>& constraints,
                                                                  const std::vector<Polynomial<Rational>>& objectives) {
   // Solve a batch of ILP problems, all with the same constraints but different objectives
   // A wrapper for the Tableau version
-  Tableau t = makeStandardFormTableau(constraints);
-  return batch_solve(&t, objectives);
+  if (!cache_enabled()) {
+    Tableau t = makeStandardFormTableau(constraints);
+    return batch_solve(&t, objectives);
+  }
+  return cached_batch_solve(
+      constraint_key(constraints), [&]() { return makeStandardFormTableau(constraints); }, objectives);
+}
+
+std::map<Polynomial<Rational>, ILPResult> ILPSolver::cached_batch_solve(
+    const std::string& constraint_key, const std::function<Tableau()>& make_tableau,
+    const std::vector<Polynomial<Rational>>& objectives) {
+  // Nearly identical constraint systems recur across similar contractions, so
+  // keep the canonicalized (phase 1 complete) tableau for each constraint set
+  // process-wide; a re-solve with the same constraints warm starts from that
+  // basis instead of pivoting from scratch. An infeasible constraint set is
+  // cached as nullptr, leaving the throw/ignore decision to each caller.
+  static LruCache<std::string, std::shared_ptr<const Tableau>> canonical_cache{kSolveCacheSize};
+  auto canonical = canonical_cache.Lookup(constraint_key, [&]() -> std::shared_ptr<const Tableau> {
+    auto t = std::make_shared<Tableau>(make_tableau());
+    if (!t->convertToCanonicalForm()) {
+      return nullptr;
+    }
+    return t;
+  });
+  if (!canonical) {
+    IVLOG(3, "Feasible region empty");
+    if (throw_infeasible) {
+      throw std::runtime_error("Unable to run ILPSolver::batch_solve: Feasible region empty.");
+    }
+    return std::map<Polynomial<Rational>, ILPResult>{};
+  }
+
+  // A whole batch that has been solved before is answered without any pivoting
+  std::ostringstream batch_key;
+  batch_key << constraint_key << "|";
+  for (const Polynomial<Rational>& obj : objectives) {
+    batch_key << obj << ";";
+  }
+  static LruCache<std::string, std::shared_ptr<const std::map<Polynomial<Rational>, ILPResult>>> solution_cache{
+      kSolveCacheSize};
+  auto result = solution_cache.Lookup(batch_key.str(), [&]() {
+    return std::make_shared<const std::map<Polynomial<Rational>, ILPResult>>(solve_objectives(*canonical, objectives));
+  });
+  return *result;
 }
 
 std::map<Polynomial<Rational>, ILPResult> ILPSolver::batch_solve(Tableau* tableau,
@@ -47,21 +119,23 @@ std::map<Polynomial<Rational>, ILPResult> ILPSolver::batch_solve(Tableau* tablea
     }
     return std::map<Polynomial<Rational>, ILPResult>{};
   }
-  var_names_ = tableau->varNames();
-  tableau->convertToCanonicalForm();
+  return solve_objectives(*tableau, objectives);
+}
 
+std::map<Polynomial<Rational>, ILPResult> ILPSolver::solve_objectives(
+    const Tableau& canonical, const std::vector<Polynomial<Rational>>& objectives) {
   std::map<Polynomial<Rational>, ILPResult> ret;
   for (const Polynomial<Rational>& obj : objectives) {
     clean();
-    var_names_ = tableau->varNames();
+    var_names_ = canonical.varNames();
 
     // Copy tableau for manipulation specific to the objective
-    Tableau specific_t = *tableau;
+    Tableau specific_t = canonical;
 
     // Set first row based on objective
     specific_t.mat()(0, 0) = 1;
-    for (size_t i = 0; i < tableau->varNames().size(); ++i) {
-      std::string var = tableau->varNames()[i];
+    for (size_t i = 0; i < var_names_.size(); ++i) {
+      std::string var = var_names_[i];
       if (var.substr(var.size() - 4, 4) == "_pos") {
         specific_t.mat()(0, i + 1) = -obj[var.substr(1, var.size() - 5)];
       } else if (var.substr(var.size() - 4, 4) == "_neg") {
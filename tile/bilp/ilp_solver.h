@@ -3,6 +3,7 @@
 #include <gtest/gtest_prod.h>
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -57,6 +58,14 @@ class ILPSolver {
 
   // Solves a tableau representing an ILP problem
   ILPResult solve(Tableau& tableau, bool already_canonical = false);  // NOLINT(runtime/references)
+  // Solves each objective against a tableau already in canonical form
+  std::map<math::Polynomial<math::Rational>, ILPResult> solve_objectives(
+      const Tableau& canonical, const std::vector<math::Polynomial<math::Rational>>& objectives);
+  // Batch solve through the process-wide canonical tableau & solution caches;
+  // make_tableau is only invoked when the constraint set has not been seen
+  std::map<math::Polynomial<math::Rational>, ILPResult> cached_batch_solve(
+      const std::string& constraint_key, const std::function<Tableau()>& make_tableau,
+      const std::vector<math::Polynomial<math::Rational>>& objectives);
   // Reports the minimized value of the objective for last solved problem
   math::Rational reportObjective() const { return best_objective; }
   // Reports the variable values minimizing the objective for last solved problem
@@ -410,6 +410,48 @@ void AliasMap::AddConstraintsForBlock() {
   }
 }
 
+std::shared_ptr<AliasMapCache::Entry> AliasMapCache::Root() {
+  std::lock_guard<std::mutex> lock{mu_};
+  if (!root_) {
+    root_ = std::make_shared<Entry>();
+  }
+  return root_;
+}
+
+std::shared_ptr<AliasMapCache::Entry> AliasMapCache::Lookup(const std::shared_ptr<Entry>& parent,
+                                                            stripe::Block* block) {
+  std::lock_guard<std::mutex> lock{mu_};
+  auto it = entries_.find(block);
+  if (it != entries_.end()) {
+    return it->second;
+  }
+  auto entry = std::make_shared<Entry>();
+  entry->parent = parent;
+  entry->map = AliasMap{parent->map, block};
+  entries_.emplace(block, entry);
+  return entry;
+}
+
+void AliasMapCache::Invalidate(const stripe::Block* block) {
+  std::lock_guard<std::mutex> lock{mu_};
+  InvalidateLocked(block);
+}
+
+void AliasMapCache::InvalidateLocked(const stripe::Block* block) {
+  entries_.erase(block);
+  for (const auto& stmt : block->stmts) {
+    auto inner = stripe::Block::Downcast(stmt);
+    if (inner) {
+      InvalidateLocked(inner.get());
+    }
+  }
+}
+
+void AliasMapCache::Clear() {
+  std::lock_guard<std::mutex> lock{mu_};
+  entries_.clear();
+}
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
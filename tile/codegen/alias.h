@@ -4,11 +4,13 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "base/util/lookup.h"
+#include "tile/codegen/compile_pass.h"
 #include "tile/stripe/stripe.h"
 
 namespace vertexai {
@@ -91,6 +93,43 @@ class AliasMap {
   std::string MakePassthruIdx(stripe::Block* block, const std::string& idx_name);
 };
 
+// Memoizes per-block AliasMaps across passes, so that consecutive passes
+// which leave the aliasing structure alone (see CompilePass::
+// preserves_aliasing()) don't each rebuild the full analysis from the root.
+// Passes that mutate only part of the tree can drop just the affected scopes
+// via Invalidate(); the driver clears the whole cache after any pass that
+// makes undeclared mutations.
+class AliasMapCache {
+ public:
+  // A memoized AliasMap.  Each entry owns its ancestor chain, so the map's
+  // internal parent pointers stay valid even if the cache is cleared while
+  // the entry is still in use.
+  struct Entry {
+    std::shared_ptr<Entry> parent;
+    AliasMap map;
+  };
+
+  // Returns the root-level entry (the AliasMap above the program entry).
+  std::shared_ptr<Entry> Root();
+
+  // Returns the memoized entry for block, building it from the parent entry
+  // when absent.
+  std::shared_ptr<Entry> Lookup(const std::shared_ptr<Entry>& parent, stripe::Block* block);
+
+  // Drops the entries for block and everything beneath it.
+  void Invalidate(const stripe::Block* block);
+
+  // Drops every entry.
+  void Clear();
+
+ private:
+  void InvalidateLocked(const stripe::Block* block);
+
+  std::mutex mu_;
+  std::shared_ptr<Entry> root_;
+  std::unordered_map<const stripe::Block*, std::shared_ptr<Entry>> entries_;
+};
+
 // Determines whether two extent vectors overlap.  This is used to
 // determine the overlap of the exterior ranges of two AliasInfos,
 // across the entire range over which the underlying refinement will
@@ -122,6 +161,35 @@ void RunOnBlocks(stripe::Block* root, const stripe::Tags& reqs, const F& func, b
   RunOnBlocksRecurse(root_map, root, reqs, func, rec_func);
 }
 
+template <typename F>
+void CachedRunOnBlocksRecurse(AliasMapCache* cache, const std::shared_ptr<AliasMapCache::Entry>& entry,
+                              stripe::Block* block, const stripe::Tags& reqs, const F& func, bool rec_func) {
+  bool run_func = block->has_tags(reqs) || reqs.count("all") > 0;
+  if (run_func) {
+    func(entry->map, block);
+  }
+  if (!run_func || rec_func) {
+    for (auto& stmt : block->stmts) {
+      auto inner = stripe::Block::Downcast(stmt);
+      if (inner) {
+        auto inner_entry = cache->Lookup(entry, inner.get());
+        CachedRunOnBlocksRecurse(cache, inner_entry, inner.get(), reqs, func, rec_func);
+      }
+    }
+  }
+}
+
+// Like RunOnBlocks, but reads and extends the AliasMaps memoized on the
+// CompilerState instead of rebuilding them.  Only passes that declare
+// preserves_aliasing() (or that Invalidate() the scopes they change) may use
+// this form; anything else would hand later passes stale analysis.
+template <typename F>
+void RunOnBlocks(CompilerState* state, const stripe::Tags& reqs, const F& func, bool rec_func = false) {
+  auto* cache = state->alias_cache.get();
+  auto root = cache->Lookup(cache->Root(), state->entry());
+  CachedRunOnBlocksRecurse(cache, root, state->entry(), reqs, func, rec_func);
+}
+
 std::ostream& operator<<(std::ostream& os, const AliasInfo& ai);
 
 }  // namespace codegen
@@ -0,0 +1,272 @@
+// Copyright 2019, Intel Corp.
+
+#include "tile/codegen/attention.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tile/codegen/pattern.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// The kernels making up one softmax(Q K^T) V chain, in dataflow order.
+struct AttentionChain {
+  Block* qk = nullptr;              // scores = Q * K^T
+  Block* rowmax = nullptr;          // optional max-reduction for numerical stability
+  std::vector<Block*> eltwise;      // scale / subtract / exp / divide kernels
+  Block* rowsum = nullptr;          // softmax denominator
+  Block* pv = nullptr;              // out = probs * V
+
+  std::vector<Block*> blocks() const {
+    std::vector<Block*> ret;
+    ret.push_back(qk);
+    if (rowmax) {
+      ret.push_back(rowmax);
+    }
+    for (auto* block : eltwise) {
+      ret.push_back(block);
+    }
+    ret.push_back(rowsum);
+    ret.push_back(pv);
+    return ret;
+  }
+};
+
+bool IsMatmul(const Block& block) {
+  return block.has_tag("contraction") && block.has_tag("agg_op_add") && block.has_tag("comb_op_mul");
+}
+
+bool ReadsBuffer(const Block& block, const std::string& name) {
+  for (const auto& ref : block.refs) {
+    if (IsReadDir(ref.dir) && ref.from == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Maps each buffer in the parent scope to the single kernel that writes it.
+// Buffers with multiple writers are disqualified (mapped to nullptr).
+class Dataflow {
+ public:
+  explicit Dataflow(Block* parent) {
+    for (const auto& stmt : parent->stmts) {
+      auto inner = Block::Downcast(stmt);
+      if (!inner) {
+        continue;
+      }
+      for (const auto& ref : inner->refs) {
+        if (IsWriteDir(ref.dir)) {
+          auto it_new = writers_.emplace(ref.from, inner.get());
+          if (!it_new.second) {
+            it_new.first->second = nullptr;
+          }
+        }
+        if (IsReadDir(ref.dir)) {
+          readers_[ref.from].push_back(inner.get());
+        }
+      }
+    }
+  }
+
+  Block* writer(const std::string& name) const {
+    auto it = writers_.find(name);
+    return it == writers_.end() ? nullptr : it->second;
+  }
+
+  const std::vector<Block*>& readers(const std::string& name) const {
+    static const std::vector<Block*> kEmpty;
+    auto it = readers_.find(name);
+    return it == readers_.end() ? kEmpty : it->second;
+  }
+
+ private:
+  std::map<std::string, Block*> writers_;
+  std::map<std::string, std::vector<Block*>> readers_;
+};
+
+// Starting from the final contraction 'pv' and the divide kernel producing its
+// probabilities input, walk the dataflow backwards through the softmax and
+// locate the scores contraction.  Returns an empty optional if the kernels in
+// between don't form a softmax.
+std::optional<AttentionChain> MatchChain(Block* pv, Block* div, const Dataflow& flow) {
+  AttentionChain chain;
+  chain.pv = pv;
+
+  // The divide must combine elementwise exponentials with their sum-reduction.
+  Block* exp = nullptr;
+  std::string numer;
+  for (const auto& ref : div->refs) {
+    if (!IsReadDir(ref.dir)) {
+      continue;
+    }
+    Block* prod = flow.writer(ref.from);
+    if (!prod) {
+      return std::nullopt;
+    }
+    if (prod->has_tag("eltwise_exp")) {
+      exp = prod;
+      numer = ref.from;
+    } else if (prod->has_tag("contraction") && prod->has_tag("agg_op_add")) {
+      chain.rowsum = prod;
+    }
+  }
+  if (!exp || !chain.rowsum || !ReadsBuffer(*chain.rowsum, numer)) {
+    return std::nullopt;
+  }
+  chain.eltwise.push_back(div);
+
+  // Walk from the exponential back to the scores contraction, passing through
+  // any elementwise kernels (the max subtraction, masking, or a 1/sqrt(d)
+  // scale).  A max-reduction feeding one of them is the stability row-max.
+  Block* cur = exp;
+  for (size_t guard = 0; !chain.qk && guard < 8; guard++) {
+    chain.eltwise.push_back(cur);
+    Block* next = nullptr;
+    for (const auto& ref : cur->refs) {
+      if (!IsReadDir(ref.dir)) {
+        continue;
+      }
+      Block* prod = flow.writer(ref.from);
+      if (!prod) {
+        continue;  // a user input, e.g. an additive mask
+      }
+      if (IsMatmul(*prod)) {
+        chain.qk = prod;
+      } else if (prod->has_tag("contraction") && prod->has_tag("agg_op_max")) {
+        chain.rowmax = prod;
+      } else if (prod->has_tag("eltwise") && !next) {
+        next = prod;
+      }
+    }
+    if (chain.qk) {
+      break;
+    }
+    if (!next) {
+      return std::nullopt;
+    }
+    cur = next;
+  }
+  if (!chain.qk) {
+    return std::nullopt;
+  }
+  std::reverse(chain.eltwise.begin(), chain.eltwise.end());
+
+  // Every intermediate buffer must stay private to the chain; if anything else
+  // reads the scores or probabilities we can't stream them through a cache.
+  auto blocks = chain.blocks();
+  std::set<Block*> members(blocks.begin(), blocks.end());
+  for (auto* block : blocks) {
+    if (block == chain.pv) {
+      continue;
+    }
+    for (const auto& ref : block->refs) {
+      if (!IsWriteDir(ref.dir)) {
+        continue;
+      }
+      for (auto* reader : flow.readers(ref.from)) {
+        if (!members.count(reader)) {
+          return std::nullopt;
+        }
+      }
+    }
+  }
+  // The row-max (when present) must reduce a chain buffer, not a stray input.
+  if (chain.rowmax) {
+    bool internal = false;
+    for (const auto& ref : chain.rowmax->refs) {
+      if (IsReadDir(ref.dir) && members.count(flow.writer(ref.from))) {
+        internal = true;
+      }
+    }
+    if (!internal) {
+      return std::nullopt;
+    }
+  }
+  return chain;
+}
+
+}  // namespace
+
+void RecognizeAttention(const AliasMap& alias_map, Block* block, const proto::AttentionPass& options) {
+  std::optional<pattern::Term> gemm_pattern;
+  if (!options.gemm_pattern().empty()) {
+    gemm_pattern = pattern::Parse(options.gemm_pattern());
+  }
+  Dataflow flow(block);
+  auto set_tags = FromProto(options.set());
+  size_t count = 0;
+  for (const auto& stmt : block->stmts) {
+    auto pv = Block::Downcast(stmt);
+    if (!pv || !IsMatmul(*pv)) {
+      continue;
+    }
+    for (const auto& ref : pv->refs) {
+      if (!IsReadDir(ref.dir)) {
+        continue;
+      }
+      Block* div = flow.writer(ref.from);
+      if (!div || !div->has_tag("eltwise_div")) {
+        continue;
+      }
+      auto chain = MatchChain(pv.get(), div, flow);
+      if (!chain) {
+        continue;
+      }
+      if (gemm_pattern) {
+        if (!pattern::MatchFirst(*gemm_pattern, pattern::IntoTerm(*chain->qk)) ||
+            !pattern::MatchFirst(*gemm_pattern, pattern::IntoTerm(*chain->pv))) {
+          continue;
+        }
+      }
+      IVLOG(2, "AttentionPass> chain " << count << ": " << chain->qk->name << " -> " << chain->pv->name);
+      chain->qk->set_attr("attention", "qk");
+      if (chain->rowmax) {
+        chain->rowmax->set_attr("attention", "rowmax");
+      }
+      for (auto* eltwise : chain->eltwise) {
+        eltwise->set_attr("attention", "softmax");
+      }
+      chain->rowsum->set_attr("attention", "rowsum");
+      chain->pv->set_attr("attention", "pv");
+      for (auto* member : chain->blocks()) {
+        member->add_tags(set_tags);
+        member->set_attr("attention_chain", static_cast<int64_t>(count));
+      }
+      count++;
+      break;
+    }
+  }
+}
+
+void AttentionPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  RunOnBlocks(state, reqs,
+              [this](const AliasMap& map, Block* block) {  //
+                RecognizeAttention(map, block, options_);
+              });
+}
+
+namespace {
+
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<AttentionPass, proto::AttentionPass>::Register();
+  return 0;
+}();
+
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,28 @@
+// Copyright 2019, Intel Corp.
+
+#pragma once
+
+#include "tile/codegen/alias.h"
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+void RecognizeAttention(const AliasMap& alias_map, stripe::Block* block, const proto::AttentionPass& options);
+
+class AttentionPass final : public CompilePass {
+ public:
+  explicit AttentionPass(const proto::AttentionPass& options) : options_{options} {}
+  bool preserves_aliasing() const final { return true; }
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::AttentionPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
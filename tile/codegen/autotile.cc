@@ -4,17 +4,21 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
 #include <vector>
+#include <boost/format.hpp>
 #include <boost/math/special_functions/prime.hpp>
 
 #include "base/util/logging.h"
 #include "base/util/stream_container.h"
+#include "base/util/thread_pool.h"
 #include "base/util/throw.h"
 #include "tile/codegen/alias.h"
 #include "tile/codegen/tile.h"
+#include "tile/lang/tile_cache.h"
 #include "tile/math/util.h"
 #include "tile/stripe/stripe.h"
 
@@ -35,13 +39,15 @@ struct TileMetrics {
   double output_bandwidth = 0;
   int64_t total_bytes = 0;
   double total_bandwidth = 0;
+  int64_t register_estimate = 0;
 
   bool IsValid(const proto::AutotilePass& options) const {
     return !((options.max_output_size() && output_bytes > options.max_output_size()) ||
              (options.max_per_output_size() && max_output_bytes > options.max_per_output_size()) ||
              (options.max_input_size() && input_bytes > options.max_input_size()) ||
              (options.max_per_input_size() && max_input_bytes > options.max_per_input_size()) ||
-             (options.max_total_size() && total_bytes > options.max_total_size()));
+             (options.max_total_size() && total_bytes > options.max_total_size()) ||
+             (options.max_registers() && register_estimate > options.max_registers()));
   }
 };
 
@@ -114,7 +120,8 @@ std::ostream& operator<<(std::ostream& os, const TileMetrics& metrics) {
      << ", " << metrics.max_output_bytes  //
      << ", " << metrics.output_bandwidth  //
      << ", " << metrics.total_bytes       //
-     << ", " << metrics.total_bandwidth << ")";
+     << ", " << metrics.total_bandwidth   //
+     << ", " << metrics.register_estimate << ")";
   return os;
 }
 
@@ -162,10 +169,16 @@ TileMetrics ComputeSizes(const std::map<std::string, size_t>& tile_by_name,  //
       ret.input_bytes += bytes;
       ret.max_input_bytes = std::max(ret.max_input_bytes, bytes);
       ret.input_bandwidth += bandwidth;
+      // Scalarize keeps roughly one operand register live per input
+      ret.register_estimate += 1;
     } else if (ref.dir == RefDir::Out) {
       ret.output_bytes += bytes;
       ret.max_output_bytes = std::max(ret.max_output_bytes, bytes);
       ret.output_bandwidth += bandwidth;
+      // Every interior output element is an accumulator that stays live
+      // across the inner loops once scalarize runs; these are what spill
+      // when a tile outgrows the register file
+      ret.register_estimate += tiled.sizes_product();
     }
     IVLOG(4, "    ComputeSizes> ref: " << ref);
     IVLOG(4, "                tiled: " << tiled);
@@ -336,6 +349,84 @@ struct TileResult {
   double cost;
 };
 
+// Process-wide memo of completed tile searches.  Compiling a family of
+// closely-related programs (the same network instantiated at several
+// batch sizes) re-runs the search over blocks that are either identical
+// or identical except for the batch extent; both cases key here by
+// canonical block hash.  Exact hits replay the search's deterministic
+// result.  With reuse_outer_dim set, a block matching a previously
+// searched one up to the indexes that only drive dim 0 of its
+// refinements reuses that tiling, clamped to the new ranges.
+struct TileMemo {
+  using Key = std::pair<std::string, uint64_t>;  // (serialized options, block hash)
+
+  static TileMemo* Instance() {
+    static TileMemo memo;
+    return &memo;
+  }
+
+  std::mutex mu;
+  std::map<Key, TileResult> exact;
+  std::map<Key, TileResult> outer;
+};
+
+// Hashes the block with every index that feeds only dim 0 of the
+// block's refinements normalized away (range 1, matching interior
+// dims collapsed), so batch-size variants of one kernel collide.
+uint64_t OuterDimHash(const Block& block) {
+  auto clone = CloneBlock(block, -1, /* share_leaves = */ true);
+  std::set<std::string> outer_idxs;
+  for (const auto& idx : clone->idxs) {
+    if (idx.affine != Affine()) {
+      continue;
+    }
+    bool used = false;
+    bool only_dim0 = true;
+    for (const auto& ref : clone->refs) {
+      for (size_t i = 0; i < ref.access.size(); i++) {
+        if (ref.access[i].getMap().count(idx.name)) {
+          used = true;
+          if (i != 0) {
+            only_dim0 = false;
+          }
+        }
+      }
+    }
+    if (used && only_dim0) {
+      outer_idxs.insert(idx.name);
+    }
+  }
+  for (auto& idx : clone->idxs) {
+    if (outer_idxs.count(idx.name)) {
+      idx.range = 1;
+    }
+  }
+  for (const auto& ref : clone->refs) {
+    if (!ref.access.empty() && !ref.interior_shape.dims.empty()) {
+      for (const auto& kvp : ref.access[0].getMap()) {
+        if (outer_idxs.count(kvp.first)) {
+          ref.mut().interior_shape.dims[0].size = 1;
+          break;
+        }
+      }
+    }
+  }
+  return CanonicalHash(*clone);
+}
+
+// Adapts a memoized tiling to a block whose ranges may differ in the
+// normalized (outer) indexes; returns nothing on structural mismatch.
+std::optional<TileResult> ClampTile(const TileResult& cached, const Block& block) {
+  if (cached.tile.dims.size() != block.idxs.size()) {
+    return std::nullopt;
+  }
+  TileResult result = cached;
+  for (size_t i = 0; i < block.idxs.size(); i++) {
+    result.tile.set(i, result.tile.dims[i].size, block.idxs[i].range);
+  }
+  return result;
+}
+
 struct TileSearchState {
   std::set<Tile> found_tiles;
   std::optional<TileResult> best_so_far;
@@ -354,8 +445,8 @@ struct TileSearchState {
 };
 
 template <typename CostModel>
-std::optional<TileResult> PickBestTile(const Block& block, bool only_po2, bool only_even, bool only_multiple_of_32,
-                                       bool is_fast, const CostModel& model) {
+std::optional<TileResult> PickBestTile(const CompilerState* cstate, const Block& block, bool only_po2, bool only_even,
+                                       bool only_multiple_of_32, bool is_fast, const CostModel& model) {
   IVLOG(3, "Autotile> PickBestTile> block: " << block.name);
   TileSearchState state;
   Tile tile(block, only_multiple_of_32 ? 32 : 1);
@@ -370,6 +461,12 @@ std::optional<TileResult> PickBestTile(const Block& block, bool only_po2, bool o
   Cost base_cost = cost;
   state.AddTile(tile, base_cost);
   while (!state.todo.empty()) {
+    if (cstate->should_stop()) {
+      // Deadline expired or the compile was cancelled: settle for the best
+      // tiling found so far rather than finishing the search.
+      IVLOG(2, "Autotile> PickBestTile> stopping early on " << block.name);
+      break;
+    }
     auto it = state.todo.begin();
     if (cost.outcome == Cost::Valid && it->first > cost.value && is_fast) {
       break;
@@ -414,18 +511,88 @@ std::optional<TileResult> PickBestTile(const Block& block, bool only_po2, bool o
 
 void AutotilePass::Apply(CompilerState* state) const {
   auto reqs = FromProto(options_.reqs());
-  RunOnBlocks(state->entry(), reqs, [this](const AliasMap& map, Block* block) {
-    if (block->has_any_tags(FromProto(options_.exclude()))) {
-      return;
+  // Gather the matching blocks, then search for the best tiling of each.
+  // The searches only read their blocks, so with options.parallel() they
+  // are farmed out to a thread pool; idle workers pull the next pending
+  // block search from the shared queue.
+  std::vector<Block*> blocks;
+  RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, Block* block) {
+    if (!block->has_any_tags(FromProto(options_.exclude()))) {
+      blocks.push_back(block);
+    }
+  });
+  std::vector<std::optional<TileResult>> results(blocks.size());
+  auto* memo = TileMemo::Instance();
+  const auto options_key = options_.SerializeAsString();
+  auto search = [&](size_t i) {
+    TileMemo::Key exact_key{options_key, CanonicalHash(*blocks[i])};
+    {
+      std::lock_guard<std::mutex> lock{memo->mu};
+      auto it = memo->exact.find(exact_key);
+      if (it != memo->exact.end()) {
+        results[i] = it->second;
+        return;
+      }
+      if (options_.reuse_outer_dim()) {
+        auto jt = memo->outer.find(TileMemo::Key{options_key, OuterDimHash(*blocks[i])});
+        if (jt != memo->outer.end()) {
+          if (auto clamped = ClampTile(jt->second, *blocks[i])) {
+            results[i] = *clamped;
+            return;
+          }
+        }
+      }
+    }
+    ComputeDensityCostModel model(*blocks[i], options_);
+    results[i] = PickBestTile(state, *blocks[i], options_.only_po2(), options_.only_even(),
+                              options_.only_multiple_of_32(), options_.fast(), model);
+    if (results[i]) {
+      std::lock_guard<std::mutex> lock{memo->mu};
+      memo->exact.emplace(exact_key, *results[i]);
+      memo->outer.emplace(TileMemo::Key{options_key, OuterDimHash(*blocks[i])}, *results[i]);
     }
-    ComputeDensityCostModel model(*block, options_);
-    auto result = PickBestTile(*block, options_.only_po2(), options_.only_even(), options_.only_multiple_of_32(),
-                               options_.fast(), model);
+  };
+  if (options_.parallel() && blocks.size() > 1) {
+    ThreadPool pool;
+    for (size_t i = 0; i < blocks.size(); i++) {
+      pool.Submit([&search, i]() { search(i); });
+    }
+    pool.Wait();
+  } else {
+    for (size_t i = 0; i < blocks.size(); i++) {
+      search(i);
+    }
+  }
+  // Applying a tiling mutates the tree, so that part stays serial.
+  for (size_t i = 0; i < blocks.size(); i++) {
+    Block* block = blocks[i];
+    auto& result = results[i];
     if (result) {
+      std::string profile_key;
+      if (options_.profile_guided()) {
+        profile_key = str(boost::format("%016x") % CanonicalHash(*block));
+        // A plan with a measured runtime beats the cost model's estimate.
+        auto measured = lang::TileCache::Instance()->GetBestTile(profile_key);
+        if (measured.size() == block->idxs.size()) {
+          for (size_t j = 0; j < measured.size(); j++) {
+            result->tile.set(j, measured[j], block->idxs[j].range);
+          }
+        }
+      }
       IVLOG(2, "Autotile> block: " << block->name << ", tile: " << result->tile << ", cost: " << result->cost);
       const TileShape& tiling_shape = options_.flip() ? result->tile.counts() : result->tile.sizes();
       if (ApplyTile(block, tiling_shape, false, false, options_.flip() || options_.interleave(),
                     options_.location_idx_tag())) {
+        if (!profile_key.empty()) {
+          // Carry the key and the chosen plan through codegen so the HAL's
+          // kernel timing can be recorded against them.
+          std::string plan;
+          for (const auto& dim : result->tile.dims) {
+            plan += (plan.empty() ? "" : ",") + std::to_string(dim.size);
+          }
+          block->set_attr("tile_key", profile_key);
+          block->set_attr("tile_plan", plan);
+        }
         auto inner = block->SubBlock(0);
         if (options_.copy_tags()) {
           inner->set_attrs(*block);
@@ -456,14 +623,14 @@ void AutotilePass::Apply(CompilerState* state) const {
       }
       LOG(WARNING) << "Autotile> block: " << block->name << " was NOT split; unable to find a valid tiling";
     }
-  });
+  }
 }
 
 void PartitionComputePass::Apply(CompilerState* state) const {
   auto reqs = FromProto(options_.reqs());
-  RunOnBlocks(state->entry(), reqs, [this](const AliasMap& map, Block* block) {
+  RunOnBlocks(state->entry(), reqs, [this, state](const AliasMap& map, Block* block) {
     PartitionComputeCostModel model(*block, options_);
-    auto result = PickBestTile(*block, false, false, options_.only_multiple_of_32(), false, model);
+    auto result = PickBestTile(state, *block, false, false, options_.only_multiple_of_32(), false, model);
     if (result) {
       IVLOG(2, "PartitionCompute> block: " << block->name                 //
                                            << ", tile: " << result->tile  //
@@ -0,0 +1,167 @@
+// Copyright 2020, Intel Corporation
+
+#include "tile/codegen/batched_gemm.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "base/util/logging.h"
+#include "tile/codegen/stencil.h"
+#include "tile/codegen/tile.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// The contraction's indexes classified by which tensors they stride:
+// batch indexes stride the output and both inputs, m/n stride the output
+// and one input, k strides both inputs only.
+struct GemmShape {
+  std::set<std::string> batch;
+  uint64_t batch_range = 1;
+  uint64_t m_range = 1;
+  uint64_t n_range = 1;
+  uint64_t k_range = 1;
+  bool valid = false;
+};
+
+GemmShape Classify(Block* block) {
+  GemmShape shape;
+  if (block->ref_outs().size() != 1 || block->ref_ins().size() != 2) {
+    return shape;
+  }
+  auto out_flat = block->ref_outs()[0]->FlatAccess();
+  auto a_flat = block->ref_ins()[0]->FlatAccess();
+  auto b_flat = block->ref_ins()[1]->FlatAccess();
+  bool has_m = false;
+  bool has_n = false;
+  bool has_k = false;
+  for (const auto& idx : block->idxs) {
+    if (idx.affine != Affine() || idx.range == 1) {
+      continue;
+    }
+    bool in_out = out_flat.get(idx.name) != 0;
+    bool in_a = a_flat.get(idx.name) != 0;
+    bool in_b = b_flat.get(idx.name) != 0;
+    if (in_out && in_a && in_b) {
+      shape.batch.insert(idx.name);
+      shape.batch_range *= idx.range;
+    } else if (in_out && in_a) {
+      has_m = true;
+      shape.m_range *= idx.range;
+    } else if (in_out && in_b) {
+      has_n = true;
+      shape.n_range *= idx.range;
+    } else if (in_a && in_b) {
+      has_k = true;
+      shape.k_range *= idx.range;
+    } else {
+      // An index that strides a single tensor (or none) isn't GEMM-shaped.
+      return shape;
+    }
+  }
+  shape.valid = !shape.batch.empty() && has_m && has_n && has_k;
+  return shape;
+}
+
+void TagStencilIdxs(Block* block, const StencilMatch& match) {
+  for (const auto& idx_match : match.idxs) {
+    if (idx_match.stencil_idx_name == "*") {
+      continue;
+    }
+    auto idx = block->idx_by_name(idx_match.block_idx_name);
+    if (idx) {
+      idx->set_tag("stencil");
+      idx->set_tag(str(boost::format("stencil_%1%") % idx_match.stencil_idx_name));
+    }
+  }
+}
+
+void BatchedGemm(Block* block, const proto::BatchedGemmPass& options) {
+  auto shape = Classify(block);
+  if (!shape.valid || shape.batch_range < options.min_batch()) {
+    return;
+  }
+  if (shape.m_range > options.max_matrix_dim() ||  //
+      shape.n_range > options.max_matrix_dim() ||  //
+      shape.k_range > options.max_matrix_dim()) {
+    // Big enough per-matrix problems tile well on their own.
+    return;
+  }
+  IVLOG(2, "BatchedGemm: " << block->name << " batch=" << shape.batch_range << " m=" << shape.m_range
+                           << " n=" << shape.n_range << " k=" << shape.k_range);
+
+  // Split the batch indexes into an outer loop: tile size 1 on batch,
+  // full range everywhere else, so the inner block is exactly the
+  // per-matrix GEMM.
+  TileShape tile;
+  for (const auto& idx : block->idxs) {
+    tile.push_back(shape.batch.count(idx.name) ? 1 : idx.range);
+  }
+  ApplyTile(block, tile, false);
+  for (auto& idx : block->idxs) {
+    if (shape.batch.count(idx.name)) {
+      idx.set_tag("gemm_batch");
+    }
+  }
+  block->add_tags(FromProto(options.batch_set()));
+
+  // Stencil the per-matrix problem; its shape, not the batched one, now
+  // drives the plan.
+  auto inner = block->SubBlock(0);
+  inner->add_tags(FromProto(options.outer_set()));
+  std::vector<proto::Stencil> specs(options.stencils().begin(), options.stencils().end());
+  if (specs.empty()) {
+    return;
+  }
+  auto match = FindBestStencil(specs, false, inner.get());
+  if (!match) {
+    return;
+  }
+  TileShape stencil_tile;
+  for (const auto& idx : match->idxs) {
+    stencil_tile.push_back(idx.value);
+  }
+  ApplyTile(inner.get(), stencil_tile, false);
+  TagStencilIdxs(inner.get(), *match);
+  auto micro = inner->SubBlock(0);
+  TagStencilIdxs(micro.get(), *match);
+  micro->add_tags(FromProto(options.inner_set()));
+}
+
+void BatchedGemmRecurse(Block* block, const proto::BatchedGemmPass& options, const Tags& reqs) {
+  for (const auto& stmt : block->stmts) {
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      BatchedGemmRecurse(inner.get(), options, reqs);
+    }
+  }
+  if (block->has_tags(reqs)) {
+    BatchedGemm(block, options);
+  }
+}
+
+}  // namespace
+
+void BatchedGemmPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  BatchedGemmRecurse(state->entry(), options_, reqs);
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<BatchedGemmPass, proto::BatchedGemmPass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,27 @@
+// Copyright 2020, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+// Splits batched small-matrix contractions into an outer batch loop over a
+// per-matrix GEMM and stencils the per-matrix problem; see
+// proto::BatchedGemmPass.
+class BatchedGemmPass final : public CompilePass {
+ public:
+  explicit BatchedGemmPass(const proto::BatchedGemmPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::BatchedGemmPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
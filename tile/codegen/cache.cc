@@ -45,6 +45,47 @@ size_t NextOdd(size_t n) {
   return (n & 0x1) ? n : (n + 1);
 }
 
+// Pad the cached sizes (row-major, innermost last) so that no non-unit dim
+// gets a stride that is a multiple of the local-memory bank count.  A stride
+// that is a multiple of the bank count lands every lane of a warp stepping
+// that dim on the same bank, serializing the access into conflict replays.
+// Padding goes on the innermost non-unit dim, since its size is a factor of
+// every outer stride.  Returns the padded dim, if any.
+std::optional<size_t> PadForBanks(std::vector<size_t>* sizes, size_t banks) {
+  if (banks == 0) {
+    return std::nullopt;
+  }
+  // The innermost non-unit dim; unit dims carry no stride of their own
+  int pad_dim = -1;
+  for (int k = static_cast<int>(sizes->size()) - 1; k >= 0; --k) {
+    if ((*sizes)[k] > 1) {
+      pad_dim = k;
+      break;
+    }
+  }
+  if (pad_dim <= 0) {
+    return std::nullopt;
+  }
+  // Bump the pad dim until every outer non-unit dim's stride misses the
+  // banks; a size coprime to the bank count always terminates the loop.
+  for (size_t attempt = 0; attempt < banks; ++attempt) {
+    bool conflict = false;
+    size_t stride = 1;
+    for (int k = static_cast<int>(sizes->size()) - 1; k > 0; --k) {
+      stride *= (*sizes)[k];
+      if ((*sizes)[k - 1] > 1 && stride % banks == 0) {
+        conflict = true;
+        break;
+      }
+    }
+    if (!conflict) {
+      return attempt ? std::make_optional<size_t>(pad_dim) : std::nullopt;
+    }
+    ++(*sizes)[pad_dim];
+  }
+  return std::make_optional<size_t>(pad_dim);
+}
+
 // Test if outer contains inner
 bool ContainBlock(Block* outer, Block* inner) {
   if (outer == inner) {
@@ -130,7 +171,8 @@ void ApplyCache(const AliasMap& alias_map,    //
                 bool add_constraints,         //
                 bool reorder_idx,             //
                 bool odd_size,                //
-                double odd_limit) {
+                double odd_limit,             //
+                size_t local_banks) {
 
   auto ref_it = ref_block->ref_by_from(var_name, false);
   if (ref_it == ref_block->refs.end()) {
@@ -285,6 +327,7 @@ void ApplyCache(const AliasMap& alias_map,    //
     }
   }
   
+  auto bank_pad = PadForBanks(&local_sizes, local_banks);
   TensorShape cached_exterior_ts = SimpleShape(outer_ref_it->interior_shape.type, local_sizes);
   TensorShape cached_interior_ts = cached_exterior_ts;
   for (auto& dim : cached_interior_ts.dims) {
@@ -372,6 +415,9 @@ void ApplyCache(const AliasMap& alias_map,    //
                   })
                   .first;
   decl->mut().access.resize(cached_exterior_ts.dims.size());
+  if (bank_pad) {
+    decl->mut().bank_dim = BankDimension{*bank_pad};
+  }
 
   // Build the local map that translates local access from
   // cache block to ref block
@@ -457,7 +503,8 @@ void ApplySimpleCache(const AliasMap& map,          //
                       bool add_constraints,         //
                       bool reorder_idx,             //
                       bool odd_size,                //
-                      double odd_limit) {
+                      double odd_limit,             //
+                      size_t local_banks) {
   auto it = block->ref_by_into(var_name, false);
   if (it == block->refs.end()) {
     throw std::runtime_error("ApplySimpleCache: Invalid var_name");
@@ -472,6 +519,9 @@ void ApplySimpleCache(const AliasMap& map,          //
       sizes[i] = NextOdd(sizes[i]);
     }
   }
+  // The padded tail is never touched: the transfer loops below are guarded
+  // by the OOB constraints, just as with odd_size.
+  auto bank_pad = PadForBanks(&sizes, local_banks);
   TensorShape cached_ts = SimpleShape(raw_ts.type, sizes);
   // Make a new name for the raw variable
   std::string raw_name = block->unique_ref_name(var_name + "_raw");
@@ -570,6 +620,9 @@ void ApplySimpleCache(const AliasMap& map,          //
                   })
                   .first;
   decl->mut().access.resize(cached_ts.dims.size());
+  if (bank_pad) {
+    decl->mut().bank_dim = BankDimension{*bank_pad};
+  }
   // Update inner blocks strides + locations
   FixupRefs(block, var_name);
 }
@@ -625,9 +678,9 @@ static void CacheBlock(const AliasMap& map, Block* block, const proto::CachePass
     }
     for (const auto& ref : refs) {
       if (dirs.count(ref.dir)) {
-        codegen::ApplyCache(map, inout, ref_block, block, ref.into(), mem_loc, xfer_loc, 
+        codegen::ApplyCache(map, inout, ref_block, block, ref.into(), mem_loc, xfer_loc,
           {"cache", "cache_load"}, {"cache", "cache_store"}, options.add_constraints(),
-          options.reorder_idx(), options.odd_size(), options.odd_limit());
+          options.reorder_idx(), options.odd_size(), options.odd_limit(), options.local_banks());
       }
     }
   }
@@ -638,7 +691,7 @@ static void CacheBlock(const AliasMap& map, Block* block, const proto::CachePass
       if (dirs.count(ref.dir)) {
         codegen::ApplySimpleCache(map, inout, block, ref.into(), mem_loc, xfer_loc,
           {"cache", "cache_load"}, {"cache", "cache_store"}, options.add_constraints(),
-          options.reorder_idx(), options.odd_size());
+          options.reorder_idx(), options.odd_size(), options.odd_limit(), options.local_banks());
       }
     }
   }
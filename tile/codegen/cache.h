@@ -25,7 +25,8 @@ void ApplyCache(const AliasMap& map,                                       //
                 bool add_constraints = true,                               //
                 bool reorder_idx = true,                                   //
                 bool odd_size = false,                                     //
-                double odd_limit = 2.0);
+                double odd_limit = 2.0,                                    //
+                size_t local_banks = 0);
 
 void ApplySimpleCache(const AliasMap& map,                                       //
                       stripe::RefDir dir,                                        //
@@ -38,7 +39,8 @@ void ApplySimpleCache(const AliasMap& map,
                       bool add_constraints = true,                               //
                       bool reorder_idx = true,                                   //
                       bool odd_size = false,                                     //
-                      double odd_limit = 2.0);
+                      double odd_limit = 2.0,                                    //
+                      size_t local_banks = 0);
 
 class CachePass final : public CompilePass {
  public:
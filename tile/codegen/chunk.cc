@@ -0,0 +1,93 @@
+// Copyright 2018, Intel Corporation
+
+#include "tile/codegen/chunk.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/util/logging.h"
+#include "tile/codegen/alias.h"
+#include "tile/codegen/tile.h"
+#include "tile/math/util.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+using math::RoundUp;
+
+namespace {
+
+void DoChunkPass(const AliasMap& scope, Block* block, const proto::ChunkPass& options) {
+  auto outs = block->ref_outs(true);
+  if (outs.empty()) {
+    return;
+  }
+  // Pick the index to chunk over: the configured one, or the largest index
+  // appearing in the first output's access (i.e. a spatial dimension of the
+  // output, so chunks write disjoint slices).
+  std::string idx_name = options.idx();
+  if (idx_name.empty()) {
+    Affine flat = outs[0]->FlatAccess();
+    uint64_t best_range = 0;
+    for (const auto& idx : block->idxs) {
+      if (flat.get(idx.name) != 0 && idx.range > best_range) {
+        best_range = idx.range;
+        idx_name = idx.name;
+      }
+    }
+  }
+  auto idx = block->idx_by_name(idx_name);
+  if (!idx || idx->range <= 1 || idx->affine != Affine()) {
+    return;
+  }
+  uint64_t num_chunks = options.num_chunks();
+  if (options.output_size_limit()) {
+    // Pick the smallest chunk count that brings the per-chunk output
+    // footprint under the limit; the footprint shrinks roughly linearly in
+    // the chunk count since chunks slice the output along one dimension.
+    uint64_t total_bytes = 0;
+    for (const auto& ref : outs) {
+      total_bytes += block->exterior_shape(ref->into()).byte_size();
+    }
+    num_chunks = RoundUp(total_bytes, options.output_size_limit());
+  }
+  num_chunks = std::min(num_chunks, idx->range);
+  if (num_chunks <= 1) {
+    return;
+  }
+  // Tile so the outer block iterates only the chunk index, leaving every
+  // other index at full range inside; contiguous (non-interleaved) splitting
+  // keeps each chunk a dense slice of the output.
+  TileShape tile(block->idxs.size());
+  for (size_t i = 0; i < block->idxs.size(); i++) {
+    const auto& block_idx = block->idxs[i];
+    tile[i] = block_idx.name == idx_name ? RoundUp(block_idx.range, num_chunks) : block_idx.range;
+  }
+  IVLOG(2, "Chunking " << block->name << " along " << idx_name << " into " << num_chunks << " chunks");
+  ApplyTile(block, tile, false, false, false);
+  block->add_tags(FromProto(options.outer_set()));
+  block->SubBlock(0)->add_tags(FromProto(options.inner_set()));
+}
+
+}  // namespace
+
+void ChunkPass::Apply(CompilerState* state) const {
+  auto reqs = stripe::FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [this](const AliasMap& map, stripe::Block* block) {  //
+    DoChunkPass(map, block, options_);
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<ChunkPass, proto::ChunkPass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
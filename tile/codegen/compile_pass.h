@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
+#include "base/context/context.h"
 #include "base/util/any_factory.h"
 #include "base/util/any_factory_map.h"
 #include "tile/base/buffer.h"
@@ -14,6 +16,18 @@ namespace tile {
 namespace codegen {
 
 struct MLIRState;
+class AliasMapCache;
+class TagIndex;
+
+// How much invariant checking the driver performs around a pass.  kFull
+// walks the whole tree verifying refinement structure; kBasic is a
+// constant-time structural check.  The full walk runs at pipeline entry and
+// exit, and around passes that request it (Pass.validate in codegen.proto);
+// trusted passes in the middle of the pipeline get the cheap tier.
+enum class Validation {
+  kBasic,
+  kFull,
+};
 
 struct CompilerState {
   explicit CompilerState(std::shared_ptr<stripe::Program> prog);
@@ -22,6 +36,27 @@ struct CompilerState {
   std::unique_ptr<MLIRState> mlir;
   std::shared_ptr<stripe::Program> prog;
   ConstBufferManager* const_bufs;
+  // Per-block AliasMaps memoized across aliasing-preserving passes; see
+  // AliasMapCache in alias.h.
+  std::shared_ptr<AliasMapCache> alias_cache;
+  // Tag-to-block index for RunOnTaggedBlocks; dropped alongside the alias
+  // cache.  See TagIndex in tag_index.h.
+  std::shared_ptr<TagIndex> tag_index;
+  // The checking tier in effect for the pass currently running; passes with
+  // their own defensive re-verification may consult this and skip it.
+  Validation validation = Validation::kFull;
+  // The compile's ambient context, carrying the caller's cancellation gate
+  // and deadline (see the Optimize overload in driver.h).  Defaults to an
+  // unbounded context.
+  context::Context ctx;
+
+  // True once the compile has been cancelled or its deadline has passed.
+  // Long-running searches poll this at iteration granularity and settle for
+  // their best result so far rather than throwing, so a pathological shape
+  // costs bounded compile latency instead of an unbounded search.
+  bool should_stop() const {  //
+    return ctx.cancelled() || std::chrono::steady_clock::now() >= ctx.deadline();
+  }
 
   stripe::Block* entry() { return prog->entry.get(); }
 };
@@ -32,6 +67,10 @@ class CompilePass {
  public:
   virtual ~CompilePass() {}
   virtual bool is_stripe() const { return true; }
+  // Whether this pass leaves every block's aliasing structure (refinements,
+  // indexes, and block nesting) untouched.  The driver drops the memoized
+  // AliasMaps after any pass that doesn't.
+  virtual bool preserves_aliasing() const { return false; }
   virtual void Apply(CompilerState* root) const = 0;
 };
 
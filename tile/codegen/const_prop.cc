@@ -1,13 +1,17 @@
 // Copyright 2019, Intel Corp.
 
+#include <map>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <utility>
 #include <vector>
 
 #include "tile/codegen/const_prop.h"
 
 #include "base/util/any_factory_map.h"
+#include "base/util/env.h"
+#include "tile/base/lru_cache.h"
 #include "tile/codegen/cache.h"
 #include "tile/codegen/localize.h"
 #include "tile/targets/cpu/jit.h"
@@ -16,6 +20,17 @@ namespace vertexai {
 namespace tile {
 namespace codegen {
 
+namespace {
+
+// The derived constants produced by one constant propagation program,
+// together with the source buffers they were computed from.
+struct FoldedConstants {
+  std::vector<std::shared_ptr<tile::Buffer>> sources;
+  std::map<std::string, std::shared_ptr<tile::Buffer>> outputs;
+};
+
+}  // namespace
+
 void ConstantPropagatePass::Apply(CompilerState* state) const {
   // Extract the primary blocks
   auto prog = state->entry();
@@ -38,42 +53,69 @@ void ConstantPropagatePass::Apply(CompilerState* state) const {
     cmain->refs.emplace(*main->ref_by_into(kvp.first));
   }
 
-  // Go through all the original blocks and move over anything which
+  // Count the statements writing each buffer.  A buffer written more than
+  // once (e.g. an aggregation output initialized by one block and
+  // accumulated by another) can't be detached from runtime execution order,
+  // so only single-writer outputs become constants.
+  std::map<std::string, size_t> writers;
+  for (const auto& stmt : main->stmts) {
+    for (const auto& name : stmt->buffer_writes()) {
+      writers[name]++;
+    }
+  }
+
+  // The specials with a compile-time CPU implementation; "copy" has none,
+  // and prng is deliberately left to runtime.
+  static const std::set<std::string> foldable_specials = {
+      "zero",         "reshape",      "shape",        "gather",       "scatter",
+      "agg_init_add", "agg_init_mul", "agg_init_min", "agg_init_max"};
+
+  // Go through all the original statements and move over anything which
   // can be computed via constant propagation
   auto stmt_it = main->stmts.begin();
   while (stmt_it != main->stmts.end()) {
     auto inner = stripe::Block::Downcast(*stmt_it);
-    if (!inner) {
+    auto special = stripe::Special::Downcast(*stmt_it);
+    if (!inner && !special) {
+      stmt_it++;
+      continue;
+    }
+    if (special && !foldable_specials.count(special->name)) {
       stmt_it++;
       continue;
     }
 
-    bool inputs_const = true;
-    for (const auto& in : inner->ref_ins()) {
-      if (!all_const.count(in->from)) {
-        inputs_const = false;
+    // Foldable when every read is a known constant and every write has no
+    // other writer.  Statements with no reads at all (pure generators, e.g.
+    // an index fill) qualify too: they depend on nothing but their shape.
+    auto writes = (*stmt_it)->buffer_writes();
+    bool foldable = !writes.empty();
+    for (const auto& name : (*stmt_it)->buffer_reads()) {
+      if (!all_const.count(name)) {
+        foldable = false;
         break;
       }
     }
-
-    // If it's not all constants, continue
-    if (inner->ref_ins().size() == 0 || !inputs_const) {
+    for (const auto& name : writes) {
+      if (writers[name] != 1 || all_const.count(name)) {
+        foldable = false;
+        break;
+      }
+    }
+    if (!foldable) {
       stmt_it++;
       continue;
     }
 
-    // Add block to constant propagation program + remove from the original
-    cmain->stmts.push_back(inner);
+    // Add the statement to the constant propagation program + remove it
+    // from the original
+    cmain->stmts.push_back(*stmt_it);
     auto old_it = stmt_it;
     stmt_it++;
     main->erase_stmt(old_it);
 
-    // Add all block outputs as new constant outputs
-    for (const auto& in : inner->ref_outs()) {
-      std::string name = in->from;
-      if (all_const.count(name)) {
-        throw std::runtime_error("Constant propagation failed due to multiple assignments");
-      }
+    // Add all outputs as new constant outputs
+    for (const auto& name : writes) {
       all_const.emplace(name);
       out_const.emplace(name);
       // Switch the original refinements to be user refs
@@ -90,9 +132,6 @@ void ConstantPropagatePass::Apply(CompilerState* state) const {
       main->ref_by_into(name)->mut().dir = stripe::RefDir::In;
       prog->ref_by_into(name)->mut().interior_shape.is_const = true;
       FixupRefs(prog, name);
-      // Make a new buffer in the constant buffers
-      size_t buf_size = cprog->ref_by_into(name)->interior_shape.byte_size();
-      state->const_bufs->buffers.emplace(name, state->const_bufs->allocator->allocate(buf_size));
     }
   }
 
@@ -101,30 +140,94 @@ void ConstantPropagatePass::Apply(CompilerState* state) const {
     return;
   }
 
-  // Now, we 'map' all the inputs + outputs
-  std::vector<std::unique_ptr<tile::View>> views;
-  std::map<std::string, void*> buffers;
-  context::Context ctx;
-  for (const auto& name : all_const) {
-    std::shared_ptr<tile::Buffer> buf = state->const_bufs->buffers.at(name);
-    std::unique_ptr<tile::View> view;
-    if (in_const.count(name)) {
-      view = buf->MapCurrent(ctx).get();
+  // Derived constants consumed only by other folded statements are scratch:
+  // they need a buffer while the constant program runs, but nothing at
+  // runtime reads them, so neither a retained buffer nor a refinement
+  // should outlive the fold.
+  std::set<std::string> live;
+  for (const auto& stmt : main->stmts) {
+    for (const auto& name : stmt->buffer_reads()) {
+      live.insert(name);
+    }
+  }
+  std::set<std::string> scratch_const;
+  for (auto it = out_const.begin(); it != out_const.end();) {
+    const auto& name = *it;
+    if (!live.count(name) && prog->ref_by_into(name)->dir == stripe::RefDir::None) {
+      scratch_const.insert(name);
+      main->refs.erase(main->ref_by_into(name));
+      prog->refs.erase(prog->ref_by_into(name));
+      it = out_const.erase(it);
     } else {
-      view = buf->MapDiscard(ctx);
+      ++it;
     }
-    buffers.emplace(name, view->data());
-    views.emplace_back(std::move(view));
   }
 
-  // Now, we JIT the constant propagation logic
-  for (const auto& name : out_const) {
-    IVLOG(2, "Jitting constant propagation for" << name);
+  // Computes the folded constants: allocates an output buffer per derived
+  // constant, maps everything, and JITs the constant propagation program.
+  auto fold = [&]() -> std::shared_ptr<FoldedConstants> {
+    auto entry = std::make_shared<FoldedConstants>();
+    for (const auto& name : in_const) {
+      entry->sources.push_back(state->const_bufs->buffers.at(name));
+    }
+    std::map<std::string, std::shared_ptr<tile::Buffer>> scratch;
+    for (const auto& name : out_const) {
+      size_t buf_size = cprog->ref_by_into(name)->interior_shape.byte_size();
+      entry->outputs.emplace(name, state->const_bufs->allocator->allocate(buf_size));
+    }
+    for (const auto& name : scratch_const) {
+      size_t buf_size = cprog->ref_by_into(name)->interior_shape.byte_size();
+      scratch.emplace(name, state->const_bufs->allocator->allocate(buf_size));
+    }
+    std::vector<std::unique_ptr<tile::View>> views;
+    std::map<std::string, void*> buffers;
+    context::Context ctx;
+    for (const auto& name : all_const) {
+      std::shared_ptr<tile::Buffer> buf;
+      std::unique_ptr<tile::View> view;
+      if (in_const.count(name)) {
+        buf = state->const_bufs->buffers.at(name);
+        view = buf->MapCurrent(ctx).get();
+      } else if (scratch_const.count(name)) {
+        buf = scratch.at(name);
+        view = buf->MapDiscard(ctx);
+      } else {
+        buf = entry->outputs.at(name);
+        view = buf->MapDiscard(ctx);
+      }
+      buffers.emplace(name, view->data());
+      views.emplace_back(std::move(view));
+    }
+    for (const auto& name : out_const) {
+      IVLOG(2, "Jitting constant propagation for" << name);
+    }
+    targets::cpu::JitExecute(*cprog, buffers);
+    // Unmap the views
+    views.clear();
+    return entry;
+  };
+
+  // Re-instantiating a program with the same weights re-derives the same
+  // transformed constants, so the folded outputs are cached process-wide.
+  // The key combines the constant program's canonical form with the identity
+  // of each source buffer; an entry keeps its source buffers alive, so a
+  // buffer address can't be recycled for different contents while the entry
+  // can still be hit.  PLAIDML_CONST_CACHE=0 disables the cache.
+  std::shared_ptr<FoldedConstants> folded;
+  if (env::Get("PLAIDML_CONST_CACHE") == "0") {
+    folded = fold();
+  } else {
+    static LruCache<std::string, std::shared_ptr<FoldedConstants>> cache{32};
+    std::ostringstream key;
+    key << std::hex << stripe::CanonicalHash(*cprog);
+    for (const auto& name : in_const) {
+      key << ":" << state->const_bufs->buffers.at(name).get();
+    }
+    folded = cache.Lookup(key.str(), fold);
+  }
+  for (const auto& kvp : folded->outputs) {
+    state->const_bufs->buffers[kvp.first] = kvp.second;
   }
-  targets::cpu::JitExecute(*cprog, buffers);
-
-  // Unmap the views
-  views.clear();
 }
 
 namespace {
@@ -225,8 +225,8 @@ void LightCstrReduction(const AliasMap& alias_map, Block* block, const proto::Li
 
 static Polynomial<Rational> PolynomialIntToRational(const Polynomial<int64_t>& src) {
   Polynomial<Rational> dest;
-  const std::map<std::string, int64_t>& src_map = src.getMap();
-  std::map<std::string, Rational>& dest_map = dest.mutateMap();
+  const auto& src_map = src.getMap();
+  auto& dest_map = dest.mutateMap();
   for (const auto& element : src_map) {
     dest_map.emplace(element.first, Rational(element.second));
   }
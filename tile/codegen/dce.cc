@@ -5,8 +5,11 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/dynamic_bitset.hpp>
+
 #include "tile/codegen/deps.h"
 #include "tile/stripe/stripe.h"
 
@@ -184,37 +187,50 @@ void DeadCodeElimination(const AliasMap& alias_map, Block* block) {
   }
 
   ComputeDataflowDepsForBlock(block, alias_map);
-  // Map a statement to its uses
-  std::map<Statement*, std::vector<Statement*>> stmt_uses;
+
+  // Number the statements and build the use lists once: uses[d] holds the
+  // indices of the statements that consume statement d's results.  Deps
+  // always point at earlier statements, so every use index is greater than
+  // the index it uses.
+  std::size_t num_stmts = block->stmts.size();
+  std::unordered_map<const Statement*, std::size_t> stmt_idx;
+  stmt_idx.reserve(num_stmts);
+  std::size_t idx = 0;
+  for (const auto& stmt : block->stmts) {
+    stmt_idx.emplace(stmt.get(), idx++);
+  }
+  std::vector<std::vector<std::size_t>> uses(num_stmts);
+  idx = 0;
   for (const auto& stmt : block->stmts) {
     for (const auto& dep_stmt_it : stmt->deps) {
-      Statement* dep_stmt = dep_stmt_it->get();
-      stmt_uses[dep_stmt].push_back(stmt.get());
+      uses[stmt_idx.at(dep_stmt_it->get())].push_back(idx);
     }
+    idx++;
   }
 
-  // Traverse backward
+  // Liveness over the statement index.  A single backward sweep reaches the
+  // fixpoint: when statement d is visited, every statement in uses[d] has
+  // already settled.
+  boost::dynamic_bitset<> live(num_stmts);
+  idx = num_stmts;
   for (auto stmt_it = block->stmts.rbegin(); stmt_it != block->stmts.rend(); ++stmt_it) {
-    Statement* stmt = stmt_it->get();
-    bool stmt_is_used = IsResultBlockOutput(stmt, outputs);
-    if (!stmt_is_used) {
-      std::vector<Statement*>& stmt_list = stmt_uses[stmt];
-      stmt_is_used = std::any_of(stmt_list.begin(), stmt_list.end(),  //
-                                 [](Statement* stmt) { return !stmt->has_tag("removed"); });
-    }
+    idx--;
+    bool stmt_is_used = IsResultBlockOutput(stmt_it->get(), outputs);
     if (!stmt_is_used) {
-      // If the stmt's output is not either the block's output or
-      // used by a live stmt, remove it.
-      stmt->set_tag("removed");
+      const auto& use_list = uses[idx];
+      stmt_is_used = std::any_of(use_list.begin(), use_list.end(),  //
+                                 [&](std::size_t use) { return live[use]; });
     }
+    live[idx] = stmt_is_used;
   }
 
-  // Remove all marked "removed" statements
+  // Remove all dead statements
+  idx = 0;
   block->erase_stmts(            //
       std::remove_if(            //
           block->stmts.begin(),  //
           block->stmts.end(),    //
-          [](const auto& stmt) { return stmt->has_tag("removed"); }),
+          [&](const auto& stmt) { return !live[idx++]; }),
       block->stmts.end());
 
   // Clean up refinements
@@ -201,6 +201,10 @@ void ComputeDataflowDepsForBlock(stripe::Block* block, const AliasMap& alias_map
 
 void ComputeDepsForBlock(Block* block, const AliasMap& alias_map) {
   IVLOG(3, "ComputeDeps> " << block->name);
+  // Deps are iterators into this block's statement list; privatize any
+  // statements shared with another block (e.g. unroll siblings) before
+  // writing them.
+  MaterializeStmts(block, 0);
   Tracker tracker;
   std::unordered_map<StatementIt, std::set<StatementIt>> transitive_deps;
   for (auto it = block->stmts.begin(); it != block->stmts.end(); it++) {
@@ -237,7 +241,7 @@ void ComputeDepsForBlock(Block* block, const AliasMap& alias_map) {
 // Recomputes Statement dependencies within all matching Blocks.
 void ComputeDepsPass::Apply(CompilerState* state) const {
   auto reqs = stripe::FromProto(options_.reqs());
-  RunOnBlocks(state->entry(), reqs, [](const AliasMap& map, stripe::Block* block) {  //
+  RunOnBlocks(state, reqs, [](const AliasMap& map, stripe::Block* block) {  //
     ComputeDepsForBlock(block, map);
   });
 }
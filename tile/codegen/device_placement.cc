@@ -0,0 +1,141 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/device_placement.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tile/codegen/alias.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// One block being placed, with the tallies the cost model prices.
+struct Candidate {
+  Block* block = nullptr;
+  double ops = 0;                           // scalar ops across the whole subtree
+  std::map<std::string, double> ref_bytes;  // base buffer -> bytes at the block boundary
+  double io_bytes = 0;                      // bytes of program inputs/outputs touched
+  bool on_compute = false;
+};
+
+// Scalar operations executed by one run of the block, trip counts included.
+double TallyOps(const Block& block) {
+  double per_iter = 0;
+  for (const auto& stmt : block.stmts) {
+    switch (stmt->kind()) {
+      case StmtKind::Load:
+      case StmtKind::Store:
+      case StmtKind::Intrinsic:
+        per_iter += 1;
+        break;
+      case StmtKind::Block:
+        per_iter += TallyOps(*Block::Downcast(stmt));
+        break;
+      default:
+        break;
+    }
+  }
+  return per_iter * block.idxs_product();
+}
+
+}  // namespace
+
+void DevicePlacementPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  auto compute_loc = FromProto(options_.compute_loc());
+  auto memory_loc = FromProto(options_.memory_loc());
+
+  std::vector<Candidate> candidates;
+  RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, Block* block) {
+    Candidate cand;
+    cand.block = block;
+    cand.ops = TallyOps(*block);
+    for (const auto& ref : block->refs) {
+      double bytes = ref.interior_shape.byte_size();
+      const auto& ai = map.at(ref.into());
+      cand.ref_bytes[ai.base_name] += bytes;
+      if (ai.base_block == state->entry()) {
+        cand.io_bytes += bytes;
+      }
+    }
+    candidates.emplace_back(std::move(cand));
+  });
+  if (candidates.size() < 2) {
+    return;
+  }
+
+  // Which candidates touch each buffer, so the sweep can price transfers.
+  std::map<std::string, std::vector<size_t>> users;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    for (const auto& kvp : candidates[i].ref_bytes) {
+      users[kvp.first].push_back(i);
+    }
+  }
+
+  // Bytes of candidate i's buffers that some other user would hold on the
+  // opposite device under the given assignment.
+  auto cross_bytes = [&](size_t i, bool on_compute) {
+    double total = 0;
+    for (const auto& kvp : candidates[i].ref_bytes) {
+      for (size_t j : users.at(kvp.first)) {
+        if (j != i && candidates[j].on_compute != on_compute) {
+          total += kvp.second;
+          break;
+        }
+      }
+    }
+    return total;
+  };
+  auto cost = [&](size_t i, bool on_compute) {
+    const auto& cand = candidates[i];
+    if (on_compute) {
+      // Program I/O lives in host memory; the compute device pays to move
+      // it over, while the memory device reads it in place.
+      return cand.ops / options_.compute_speedup() +
+             options_.transfer_cost() * (cross_bytes(i, true) + cand.io_bytes);
+    }
+    return cand.ops + options_.transfer_cost() * cross_bytes(i, false);
+  };
+
+  // Everything starts on the memory device; greedy sweeps then migrate
+  // blocks while doing so lowers their modeled cost, which pulls connected
+  // compute-heavy chains across together instead of ping-ponging buffers.
+  for (size_t sweep = 0; sweep < 8; sweep++) {
+    bool changed = false;
+    for (size_t i = 0; i < candidates.size(); i++) {
+      bool cur = candidates[i].on_compute;
+      if (cost(i, !cur) < cost(i, cur)) {
+        candidates[i].on_compute = !cur;
+        changed = true;
+      }
+    }
+    if (!changed) {
+      break;
+    }
+  }
+
+  for (auto& cand : candidates) {
+    cand.block->location = cand.on_compute ? compute_loc : memory_loc;
+    cand.block->set_tag(cand.on_compute ? "placed_compute" : "placed_memory");
+    IVLOG(2, "Placed " << cand.block->name << " on " << (cand.on_compute ? "compute" : "memory")
+                       << " device: ops=" << cand.ops << " io_bytes=" << cand.io_bytes);
+  }
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<DevicePlacementPass, proto::DevicePlacementPass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
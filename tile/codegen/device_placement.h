@@ -0,0 +1,27 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+// Assigns each qualifying block to one of two device locations (typically a
+// discrete GPU and an integrated GPU sharing host memory) by a
+// transfer-aware cost model; see proto::DevicePlacementPass for the knobs.
+class DevicePlacementPass final : public CompilePass {
+ public:
+  explicit DevicePlacementPass(const proto::DevicePlacementPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::DevicePlacementPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
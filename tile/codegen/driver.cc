@@ -2,18 +2,38 @@
 
 #include "tile/codegen/driver.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include <boost/format.hpp>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 
 #include "base/config/config.h"
 #include "base/util/any_factory_map.h"
+#include "base/util/env.h"
+#include "base/util/thread_pool.h"
 #include "base/util/throw.h"
+#include "tile/base/lru_cache.h"
 #include "tile/codegen/alias.h"
 #include "tile/codegen/compile_pass.h"
 #include "tile/codegen/emitc.h"
 #include "tile/codegen/mlir_passes.h"
+#include "tile/codegen/tag_index.h"
 
 namespace vertexai {
 namespace tile {
@@ -23,27 +43,93 @@ using namespace stripe;  // NOLINT
 
 namespace {
 
+// Tracks, across the dumps of a single compile, which statements have already
+// been written in full to a delta dump and where, keyed by canonical hash.
+struct DeltaDumpState {
+  std::map<uint64_t, proto::ChunkReference> written;
+};
+
 void DumpProgram(const Block& program,            //
                  const OptimizeOptions& options,  //
                  const std::string& name,         //
-                 size_t counter) {
-  if (options.dump_passes || options.dump_passes_proto || options.dump_code) {
+                 size_t counter,                  //
+                 DeltaDumpState* deltas) {
+  if (options.dump_passes || options.dump_passes_proto || options.dump_passes_deltas || options.dump_code) {
     boost::filesystem::create_directories(options.dbg_dir);
     if (options.dump_passes) {
       auto filename = str(boost::format("%02zu_%s.txt") % counter % name);
       auto path = (options.dbg_dir / filename).string();
       std::ofstream fout(path);
-      fout << program << std::endl;
+      PrintProgram(fout, program);
+      fout << std::endl;
     }
     if (options.dump_passes_proto) {
       auto filename = str(boost::format("%02zu_%s.pb") % counter % name);
       auto path = (options.dbg_dir / filename).string();
       std::ofstream fout(path, std::ofstream::binary);
-      // Save without Buffers
+      // Save without Buffers; stream statement-by-statement so the dump
+      // costs O(kernel) peak memory instead of O(program).
       Program true_program;
       true_program.entry = std::make_shared<Block>(program);
-      auto proto = IntoProto(true_program);
-      proto.SerializeToOstream(&fout);
+      SerializeProgram(true_program, &fout);
+    }
+    if (options.dump_passes_deltas) {
+      auto filename = str(boost::format("%02zu_%s.pbz") % counter % name);
+      auto path = (options.dbg_dir / filename).string();
+      std::ofstream fout(path, std::ofstream::binary);
+      google::protobuf::io::OstreamOutputStream oos(&fout);
+      google::protobuf::io::GzipOutputStream gzos(&oos);
+      // The shell record is the program with the chunked block's statements
+      // cleared; the chunked block is the single inner block (i.e. main)
+      // when the program has the usual program->main shape.
+      Program shell;
+      shell.entry = std::make_shared<Block>(program);
+      const Block* source = &program;
+      std::shared_ptr<Block> inner;
+      if (shell.entry->stmts.size() == 1 && (inner = Block::Downcast(*shell.entry->stmts.begin()))) {
+        source = inner.get();
+        auto inner_shell = std::make_shared<Block>(*inner);
+        inner_shell->stmts.clear();
+        shell.entry->stmts = {inner_shell};
+      } else {
+        shell.entry->stmts.clear();
+      }
+      WriteRecord(IntoProto(shell), &gzos);
+      // One chunk per kernel; a kernel whose canonical form already appears
+      // in an earlier dump this compile is written as a back-reference.
+      std::unordered_map<Statement*, size_t> ids;
+      size_t sid = 0;
+      for (const auto& stmt : source->stmts) {
+        ids[stmt.get()] = sid;
+        proto::Chunk chunk;
+        std::vector<uint32_t> deps;
+        for (const auto& dep : stmt->deps) {
+          deps.push_back(ids[dep->get()]);
+        }
+        std::sort(deps.begin(), deps.end());
+        for (auto dep : deps) {
+          chunk.add_deps(dep);
+        }
+        uint64_t digest = 0;
+        auto block = Block::Downcast(stmt);
+        if (block) {
+          digest = CanonicalHash(*block);
+        }
+        auto it = block ? deltas->written.find(digest) : deltas->written.end();
+        if (it != deltas->written.end()) {
+          *chunk.mutable_ref() = it->second;
+        } else {
+          *chunk.mutable_full() = IntoProto(stmt, {});
+          if (block) {
+            proto::ChunkReference ref;
+            ref.set_pass(counter);
+            ref.set_index(sid);
+            deltas->written.emplace(digest, ref);
+          }
+        }
+        WriteRecord(chunk, &gzos);
+        ++sid;
+      }
     }
     if (options.dump_code) {
       auto filename = str(boost::format("%02zu_%s.c") % counter % name);
@@ -74,6 +160,85 @@ void ValidateBlock(Block* root) {
       true);
 }
 
+// The kBasic tier: catches gross corruption (a lost entry block, a detached
+// root refinement) without walking the tree.  Root refs are program
+// inputs/outputs, so the check is bounded by the program signature, not by
+// how far the pipeline has expanded the tree.
+void QuickValidateBlock(Block* root) {
+  if (!root) {
+    throw_with_trace(std::runtime_error("Program entry block missing after pass"));
+  }
+  for (const auto& ref : root->refs) {
+    if (ref.dir == RefDir::None && !ref.from.empty()) {
+      throw_with_trace(std::runtime_error(
+          str(boost::format("ref.dir == RefDir::None && !ref.from.empty(). ref: %1% in block: %2%") % ref.into() %
+              root->name)));
+    }
+    if (ref.from.empty() && ref.dir != RefDir::None) {
+      throw_with_trace(std::runtime_error(
+          str(boost::format("ref.from.empty() && ref.dir != RefDir::None. ref: %1% in block: %2%") % ref.into() %
+              root->name)));
+    }
+  }
+}
+
+// Latency mode (PLAIDML_LATENCY_MODE=1, exposed through the plaidml2
+// settings API like the other PLAIDML_* knobs): retunes the pipeline for
+// small-batch latency.  The per-target configs are tuned for throughput and
+// prefer a few large workgroups that amortize launch overhead; at batch 1
+// those leave most of the device idle behind a long serial tail.  The mode
+// rewrites the tiling, threading, and fusion pass options on a local copy of
+// the pass list — the configs themselves are untouched — to prefer many
+// small workgroups, cap per-kernel work, and fuse chains into fewer
+// launches.  Read per compile, so toggling the setting between compiles
+// takes effect without a restart.
+bool LatencyMode() { return env::Get("PLAIDML_LATENCY_MODE") == "1"; }
+
+void AdjustPassForLatencyMode(proto::Pass* pass) {
+  if (pass->pass().Is<proto::AutotilePass>()) {
+    proto::AutotilePass opts;
+    pass->pass().UnpackTo(&opts);
+    // Cap the inner loop count so no single workgroup runs long enough to
+    // serialize the kernel behind it.
+    constexpr int64_t kLatencyMaxInnerWork = 4096;
+    if (opts.max_sizes_product() == 0 || opts.max_sizes_product() > kLatencyMaxInnerWork) {
+      opts.set_max_sizes_product(kLatencyMaxInnerWork);
+    }
+    // On a near-tie, prefer the tiling with more tiles, so small shapes
+    // still fill the device.
+    if (opts.split_factor() > -0.001) {
+      opts.set_split_factor(-0.001);
+    }
+    pass->mutable_pass()->PackFrom(opts);
+  } else if (pass->pass().Is<proto::ThreadInnerPass>()) {
+    proto::ThreadInnerPass opts;
+    pass->pass().UnpackTo(&opts);
+    // Smaller workgroups: more of them resident at once, shorter tail.
+    constexpr int64_t kLatencyMaxThreads = 64;
+    if (opts.threads() > kLatencyMaxThreads) {
+      opts.set_threads(kLatencyMaxThreads);
+    }
+    pass->mutable_pass()->PackFrom(opts);
+  } else if (pass->pass().Is<proto::FusionPass>()) {
+    proto::FusionPass opts;
+    pass->pass().UnpackTo(&opts);
+    // Fewer launches beat lower register pressure at batch 1; lift the
+    // spill-avoidance cap so element-wise chains fuse through.
+    if (opts.max_live_scalars()) {
+      opts.set_max_live_scalars(0);
+      pass->mutable_pass()->PackFrom(opts);
+    }
+  }
+}
+
+// Resolves the checking tier for one pass: the pass's own validate flag,
+// overridden by PLAIDML_VALIDATE_PASSES=1, which restores the old
+// full-walk-after-every-pass behavior for debugging.
+Validation PassValidation(const proto::Pass& pass) {
+  static bool validate_all = env::Get("PLAIDML_VALIDATE_PASSES") == "1";
+  return (validate_all || pass.validate()) ? Validation::kFull : Validation::kBasic;
+}
+
 class ConfigsRegistry {
  public:
   static ConfigsRegistry* Instance() {
@@ -82,54 +247,352 @@ class ConfigsRegistry {
   }
 
   void Register(const std::string& name, const std::string& cfg_bytes) {  //
+    std::lock_guard<std::mutex> lock{mutex_};
     registry_[name] = cfg_bytes;
+    parsed_.erase(name);
   }
 
-  proto::Config Resolve(const std::string& name) {
+  const proto::Config& Resolve(const std::string& name) {
+    // Parse each config at most once per process; the parsed form is shared
+    // immutably, so repeated compiles stop paying the proto-parse cost.
+    // References stay valid across later insertions (node-based map), and
+    // Register() only ever runs during static initialization.
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto parsed = parsed_.find(name);
+    if (parsed != parsed_.end()) {
+      return parsed->second;
+    }
     auto it = registry_.find(name);
     if (it == registry_.end()) {
       throw_with_trace(std::runtime_error(str(boost::format("Could not find config: %s") % name)));
     }
-    return ParseConfig<proto::Config>(it->second);
+    return parsed_.emplace(name, ParseConfig<proto::Config>(it->second)).first->second;
   }
 
  private:
+  std::mutex mutex_;
   std::unordered_map<std::string, std::string> registry_;
+  std::unordered_map<std::string, proto::Config> parsed_;
+};
+
+// Partitions the pass list into sequential waves.  A pass joins the wave
+// being assembled only if every dependency it declares completed in an
+// earlier wave; a pass declaring no dependencies is a barrier and runs in a
+// wave of its own.  Waves are executed in order; passes within a wave may be
+// run concurrently.
+std::vector<std::vector<const proto::Pass*>> ComputeWaves(const Passes& passes) {
+  std::vector<std::vector<const proto::Pass*>> waves;
+  std::set<std::string> done;     // Passes completed in prior waves
+  std::set<std::string> current;  // Passes in the wave being assembled
+  bool wave_open = false;
+  for (const auto& pass : passes) {
+    bool barrier = pass.deps().empty();
+    bool ready = !barrier && std::all_of(pass.deps().begin(), pass.deps().end(),
+                                         [&](const std::string& dep) { return done.count(dep) != 0; });
+    if (!wave_open || !ready) {
+      done.insert(current.begin(), current.end());
+      current.clear();
+      waves.emplace_back();
+      wave_open = true;
+    }
+    waves.back().push_back(&pass);
+    current.insert(pass.name());
+    if (barrier) {
+      wave_open = false;
+    }
+  }
+  return waves;
+}
+
+// One row of the compile report: what a pass cost and what it left behind.
+struct PassTiming {
+  std::string name;
+  double wall_ms = 0.0;
+  size_t stmts = 0;
+  size_t blocks = 0;
+  int64_t peak_rss_kb = 0;
+};
+
+void CountNodes(const Block& block, size_t* stmts, size_t* blocks) {
+  ++*blocks;
+  for (const auto& stmt : block.stmts) {
+    ++*stmts;
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      CountNodes(*inner, stmts, blocks);
+    }
+  }
+}
+
+int64_t PeakRssKb() {
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru)) {
+    return 0;
+  }
+  return ru.ru_maxrss;
+#endif
+}
+
+// Collects per-pass wall time, IR node counts, and peak RSS during Optimize,
+// and emits a cumulative flame-style breakdown at the end of the compile.
+// The report goes to the file named by PLAIDML_COMPILE_REPORT when set, and
+// to the log at verbosity 1 otherwise, so a compile-time regression can be
+// bisected to a pass without a rebuild.
+class CompileReport {
+ public:
+  void Start() { start_ = std::chrono::steady_clock::now(); }
+
+  // entry may be null when the IR isn't in Stripe form after the pass, in
+  // which case the node counts are skipped.
+  void Finish(const std::string& name, const Block* entry) {
+    PassTiming timing;
+    timing.name = name;
+    timing.wall_ms =
+        std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::steady_clock::now() - start_)
+            .count();
+    if (entry) {
+      CountNodes(*entry, &timing.stmts, &timing.blocks);
+    }
+    timing.peak_rss_kb = PeakRssKb();
+    timings_.push_back(std::move(timing));
+  }
+
+  void Emit() const {
+    if (timings_.empty()) {
+      return;
+    }
+    double total_ms = 0.0;
+    for (const auto& timing : timings_) {
+      total_ms += timing.wall_ms;
+    }
+    std::ostringstream report;
+    report << "Compile pass breakdown (" << boost::format("%.1f") % total_ms << " ms total):\n";
+    report << boost::format("  %-40s %10s %8s %8s %8s %10s  %s\n")  //
+                  % "pass" % "ms" % "cum%" % "stmts" % "blocks" % "peakRSSkb" % "";
+    double cum_ms = 0.0;
+    for (const auto& timing : timings_) {
+      cum_ms += timing.wall_ms;
+      size_t bar = total_ms ? static_cast<size_t>(20.0 * timing.wall_ms / total_ms) : 0;
+      report << boost::format("  %-40s %10.1f %7.1f%% %8d %8d %10d  %s\n")  //
+                    % timing.name % timing.wall_ms % (100.0 * cum_ms / std::max(total_ms, 1e-9)) % timing.stmts %
+                    timing.blocks % timing.peak_rss_kb % std::string(bar, '#');
+    }
+    auto path = env::Get("PLAIDML_COMPILE_REPORT");
+    if (!path.empty()) {
+      std::ofstream fout(path, std::ofstream::app);
+      fout << report.str();
+    } else {
+      IVLOG(1, report.str());
+    }
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::vector<PassTiming> timings_;
 };
 
 }  // namespace
 
+#ifndef _WIN32
+// Runs the pass pipeline in a forked child and hands the optimized program
+// back through a pipe in stripe proto form, so a pipeline that OOMs or
+// crashes (we've seen unroll do both on degenerate programs) kills the
+// worker instead of the serving process.  Returns false when isolation
+// can't be used and the pipeline should run in-process; throws when the
+// worker dies, turning the crash into a failed compile.
+static bool OptimizeIsolated(CompilerState* state, const Passes& passes, const OptimizeOptions& options) {
+  if (env::Get("PLAIDML_ISOLATE_COMPILE") != "1") {
+    return false;
+  }
+  // Host-side constant buffers derived during the pipeline can't cross the
+  // process boundary; such programs compile in-process as usual.
+  if (state->const_bufs && !state->const_bufs->buffers.empty()) {
+    return false;
+  }
+  int fds[2];
+  if (pipe(fds)) {
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // Child: run the pipeline for real and stream the optimized entry back.
+    close(fds[0]);
+    env::Set("PLAIDML_ISOLATE_COMPILE", "0");
+    int status = 1;
+    try {
+      Optimize(state, passes, options);
+      if (IntoProto(*state->entry()).SerializeToFileDescriptor(fds[1])) {
+        status = 0;
+      }
+    } catch (const std::exception& ex) {
+      LOG(ERROR) << "Isolated compile failed: " << ex.what();
+    } catch (...) {
+      LOG(ERROR) << "Isolated compile failed";
+    }
+    close(fds[1]);
+    _exit(status);
+  }
+  close(fds[1]);
+  // Drain the pipe before reaping the child, so a large program can't
+  // deadlock against the pipe's buffer.
+  stripe::proto::Block entry_pb;
+  bool parsed = entry_pb.ParseFromFileDescriptor(fds[0]);
+  close(fds[0]);
+  int wstatus = 0;
+  waitpid(pid, &wstatus, 0);
+  if (!parsed || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
+    throw_with_trace(std::runtime_error("compile worker died during optimization (see worker log for the pass)"));
+  }
+  state->prog->entry = FromProto(entry_pb);
+  return true;
+}
+#else
+static bool OptimizeIsolated(CompilerState*, const Passes&, const OptimizeOptions&) { return false; }
+#endif
+
 void Optimize(CompilerState* state, const Passes& passes, const OptimizeOptions& options) {
+  if (OptimizeIsolated(state, passes, options)) {
+    return;
+  }
+  // In latency mode the pipeline runs with retuned tiling/threading/fusion
+  // options; the rewrite happens up front on a local copy so the dumps and
+  // the compile report reflect what actually ran.
+  Passes latency_passes;
+  const Passes* active_passes = &passes;
+  if (LatencyMode()) {
+    latency_passes = passes;
+    for (auto& pass : latency_passes) {
+      AdjustPassForLatencyMode(&pass);
+    }
+    active_passes = &latency_passes;
+  }
   size_t counter = 0;
-  DumpProgram(*state->entry(), options, "initial", counter++);
+  DeltaDumpState deltas;
+  CompileReport report;
+  DumpProgram(*state->entry(), options, "initial", counter++, &deltas);
+  // Full validation at pipeline entry; between trusted passes only the
+  // constant-time tier runs (see Pass.validate / PLAIDML_VALIDATE_PASSES).
+  ValidateBlock(state->entry());
   bool in_stripe = true;
-  for (const auto& pass : passes) {
-    IVLOG(1, "Optimization Pass " << pass.name());
-    std::unique_ptr<CompilePass> compile_pass =
-        AnyFactoryMap<CompilePass>::Instance()->MakeInstanceIfSupported(context::Context{}, pass.pass());
-    if (!compile_pass) {
-      throw_with_trace(std::runtime_error(
-          str(boost::format("Unsupported pass: %1% -> %2%") % pass.name() % pass.pass().type_url())));
-    }
-    bool wants_stripe = compile_pass->is_stripe();
-    if (!in_stripe && wants_stripe) {
-      ConvertFromMLIR(state);
-    } else if (in_stripe && !wants_stripe) {
-      ConvertIntoMLIR(state);
-    }
-    in_stripe = wants_stripe;
-    compile_pass->Apply(state);
-    if (in_stripe) {
-      DumpProgram(*state->entry(), options, pass.name(), counter);
-    } else {
-      // DUMP MLIR
+  std::unique_ptr<ThreadPool> pool;
+  if (options.parallel) {
+    pool = std::make_unique<ThreadPool>();
+  }
+  for (const auto& wave : ComputeWaves(*active_passes)) {
+    std::vector<std::pair<const proto::Pass*, std::unique_ptr<CompilePass>>> instances;
+    for (const proto::Pass* pass : wave) {
+      std::unique_ptr<CompilePass> compile_pass =
+          AnyFactoryMap<CompilePass>::Instance()->MakeInstanceIfSupported(context::Context{}, pass->pass());
+      if (!compile_pass) {
+        throw_with_trace(std::runtime_error(
+            str(boost::format("Unsupported pass: %1% -> %2%") % pass->name() % pass->pass().type_url())));
+      }
+      instances.emplace_back(pass, std::move(compile_pass));
+    }
+    bool concurrent = pool && instances.size() > 1 &&
+                      std::all_of(instances.begin(), instances.end(),
+                                  [](const std::pair<const proto::Pass*, std::unique_ptr<CompilePass>>& instance) {
+                                    return instance.second->is_stripe();
+                                  });
+    if (concurrent) {
+      // Every pass in the wave declared its dependencies complete; they run
+      // concurrently and must touch disjoint sub-blocks.
+      if (!in_stripe) {
+        ConvertFromMLIR(state);
+        in_stripe = true;
+      }
+      // The whole wave gets the strictest tier any member asked for.
+      state->validation = Validation::kBasic;
+      for (auto& instance : instances) {
+        if (PassValidation(*instance.first) == Validation::kFull) {
+          state->validation = Validation::kFull;
+        }
+      }
+      report.Start();
+      for (auto& instance : instances) {
+        IVLOG(1, "Optimization Pass " << instance.first->name() << " (concurrent)");
+        CompilePass* compile_pass = instance.second.get();
+        pool->Submit([compile_pass, state]() { compile_pass->Apply(state); });
+      }
+      pool->Wait();
+      if (!std::all_of(instances.begin(), instances.end(),
+                       [](const std::pair<const proto::Pass*, std::unique_ptr<CompilePass>>& instance) {
+                         return instance.second->preserves_aliasing();
+                       })) {
+        state->alias_cache->Clear();
+        state->tag_index->Clear();
+      }
+      report.Finish(str(boost::format("wave[%d]:%s") % instances.size() % instances.back().first->name()),
+                    state->entry());
+      DumpProgram(*state->entry(), options, instances.back().first->name(), counter, &deltas);
+      counter += instances.size();
+      if (state->validation == Validation::kFull) {
+        ValidateBlock(state->entry());
+      } else {
+        QuickValidateBlock(state->entry());
+      }
+      continue;
+    }
+    for (auto& instance : instances) {
+      const auto& pass = *instance.first;
+      IVLOG(1, "Optimization Pass " << pass.name());
+      // Any IR conversion the pass forces is billed to the pass.
+      report.Start();
+      bool wants_stripe = instance.second->is_stripe();
+      if (!in_stripe && wants_stripe) {
+        ConvertFromMLIR(state);
+      } else if (in_stripe && !wants_stripe) {
+        ConvertIntoMLIR(state);
+      }
+      in_stripe = wants_stripe;
+      state->validation = PassValidation(pass);
+      instance.second->Apply(state);
+      if (!instance.second->preserves_aliasing()) {
+        state->alias_cache->Clear();
+        state->tag_index->Clear();
+      }
+      report.Finish(pass.name(), in_stripe ? state->entry() : nullptr);
+      if (in_stripe) {
+        DumpProgram(*state->entry(), options, pass.name(), counter, &deltas);
+      } else {
+        // DUMP MLIR
+      }
+      counter++;
+      if (in_stripe) {
+        if (state->validation == Validation::kFull) {
+          ValidateBlock(state->entry());
+        } else {
+          QuickValidateBlock(state->entry());
+        }
+      }
     }
-    counter++;
-    ValidateBlock(state->entry());
   }
   if (!in_stripe) {
     ConvertFromMLIR(state);
   }
+  // Full validation at pipeline exit, so the HAL never sees a tree a cheaply
+  // checked pass corrupted.
+  ValidateBlock(state->entry());
+  // The HAL and any re-optimization see a fresh tree; don't let stale
+  // analysis outlive the pass pipeline.
+  state->alias_cache->Clear();
+  state->tag_index->Clear();
+  report.Emit();
+  // With PLAIDML_EMITC_OUTPUT set, also write the optimized program out as
+  // self-contained AOT C for targets that can't run a JIT; see EmitAotC.
+  auto aot_path = env::Get("PLAIDML_EMITC_OUTPUT");
+  if (aot_path.size()) {
+    std::ofstream fout(aot_path);
+    fout << EmitAotC(*state->entry(), "plaidml");
+  }
   // Remove constants that are no longer used
   if (state->const_bufs == nullptr) {
     return;
@@ -145,11 +608,49 @@ void Optimize(CompilerState* state, const Passes& passes, const OptimizeOptions&
   IVLOG(3, "All optimization passes complete");
 }
 
+void OptimizeCached(CompilerState* state, const std::string& cfg_key, const Passes& passes,
+                    const OptimizeOptions& options) {
+  bool dumping = options.dump_passes || options.dump_passes_proto || options.dump_passes_deltas || options.dump_code;
+  bool has_const_bufs = state->const_bufs && !state->const_bufs->buffers.empty();
+  if (dumping || has_const_bufs || env::Get("PLAIDML_OPTIMIZE_CACHE") == "0") {
+    Optimize(state, passes, options);
+    return;
+  }
+  static LruCache<std::string, std::shared_ptr<Block>> cache{16};
+  std::string passes_cfg;
+  for (const auto& pass : passes) {
+    passes_cfg += pass.SerializeAsString();
+  }
+  // Latency mode rewrites the pass options inside Optimize(), so it has to
+  // be part of the key: a throughput-tuned result must not be handed back to
+  // a latency-mode compile or vice versa.
+  auto key = str(boost::format("%s:%s:%016x:%016x") % cfg_key % (LatencyMode() ? "latency" : "throughput") %
+                 std::hash<std::string>{}(passes_cfg) % CanonicalHash(*state->entry()));
+  auto entry = cache.Lookup(key, [&]() {
+    Optimize(state, passes, options);
+    return CloneBlock(*state->entry());
+  });
+  // Hand out an independent copy; later passes and the HAL mutate the tree.
+  state->prog->entry = CloneBlock(*entry);
+}
+
+void Optimize(const context::Context& ctx, CompilerState* state, const Passes& passes,
+              const OptimizeOptions& options) {
+  state->ctx = ctx;
+  Optimize(state, passes, options);
+}
+
+void OptimizeCached(const context::Context& ctx, CompilerState* state, const std::string& cfg_key,
+                    const Passes& passes, const OptimizeOptions& options) {
+  state->ctx = ctx;
+  OptimizeCached(state, cfg_key, passes, options);
+}
+
 void Configs::Register(const std::string& name, const std::string& pb_bytes) {
   ConfigsRegistry::Instance()->Register(name, pb_bytes);
 }
 
-proto::Config Configs::Resolve(const std::string& name) {  //
+const proto::Config& Configs::Resolve(const std::string& name) {  //
   return ConfigsRegistry::Instance()->Resolve(name);
 }
 
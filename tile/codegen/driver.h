@@ -17,7 +17,15 @@ namespace codegen {
 struct OptimizeOptions {
   bool dump_passes = false;
   bool dump_passes_proto = false;
+  // Dump each pass as a compressed, chunked *.pbz delta: only kernels that
+  // changed since the previous dump are written in full (see Chunk in
+  // codegen.proto).  Cheap enough to leave enabled on production-size models;
+  // reconstruct any snapshot with `pmlc --expand-dump`.
+  bool dump_passes_deltas = false;
   bool dump_code = false;
+  // When set, passes whose declared dependencies (proto::Pass.deps) have all
+  // completed are run concurrently on a thread pool; see codegen.proto.
+  bool parallel = false;
   boost::filesystem::path dbg_dir;
 };
 
@@ -25,9 +33,33 @@ using Passes = google::protobuf::RepeatedPtrField<proto::Pass>;
 
 void Optimize(CompilerState* state, const Passes& passes, const OptimizeOptions& options);
 
+// As above, but threads the caller's context through the pipeline: its
+// cancellation gate and deadline are polled by the long-running searches
+// (autotile, scheduling), which settle for their best plan so far when the
+// context expires.  Every pass still runs, so the result is always a valid
+// program; only search effort is bounded.
+void Optimize(const context::Context& ctx, CompilerState* state, const Passes& passes,
+              const OptimizeOptions& options);
+
+// Memoizing wrapper around Optimize().  The cache is keyed on the pass
+// pipeline plus the canonical form of the unoptimized program, so compiling a
+// program whose structure and shapes match an earlier compile — rebuilding an
+// executable, or cycling through a small set of batch sizes — clones the
+// cached result instead of re-running the pipeline.  Falls back to Optimize()
+// when constant buffers are bound (const-propagation passes rewrite their
+// contents) or when pass dumping is requested.
+void OptimizeCached(CompilerState* state, const std::string& cfg_key, const Passes& passes,
+                    const OptimizeOptions& options);
+
+// As above, with the caller's context threaded through on a cache miss; see
+// the context-taking Optimize overload.
+void OptimizeCached(const context::Context& ctx, CompilerState* state, const std::string& cfg_key,
+                    const Passes& passes, const OptimizeOptions& options);
+
 struct Configs {
   static void Register(const std::string& name, const std::string& pb_bytes);
-  static proto::Config Resolve(const std::string& name);
+  // Returns the parsed config, memoized on first use and shared immutably.
+  static const proto::Config& Resolve(const std::string& name);
 };
 
 }  // namespace codegen
@@ -2,6 +2,7 @@
 
 #include "tile/codegen/emitc.h"
 
+#include <map>
 #include <vector>
 
 #include <boost/format.hpp>
@@ -18,9 +19,16 @@ namespace {
 
 class CodeGenerator {
  public:
-  CodeGenerator() {}
+  // A non-empty prefix selects the self-contained AOT flow: program
+  // inputs/outputs come from a named binding table instead of the heap, the
+  // body is wrapped in <prefix>_run(), pointers are restrict-qualified, and
+  // safe kernel loops get OpenMP annotations.
+  explicit CodeGenerator(const std::string& prefix = "") : prefix_(prefix) {}
 
   std::string EmitProgram(const Block& program) {
+    if (!prefix_.empty()) {
+      return EmitAotProgram(program);
+    }
     EmitLine("#include <stdint.h>");
     EmitLine("#include <stdlib.h>");
     EmitLine(R"(
@@ -45,6 +53,73 @@ float softmax(float x) {
     return oss_.str();
   }
 
+  std::string EmitAotProgram(const Block& program) {
+    EmitLine("/* Self-contained C for a compiled program.  Bind every buffer in");
+    EmitLine(format(" * %1%_bindings via %1%_bind(), then call %1%_run(). */") % prefix_);
+    EmitLine("#include <stdint.h>");
+    EmitLine("#include <stdlib.h>");
+    EmitLine("#include <string.h>");
+    EmitLine("#include <math.h>");
+    EmitLine(R"(
+static int min(int x, int y) {
+  return (x < y) ? x : y;
+}
+
+static int max(int x, int y) {
+  return (x < y) ? y : x;
+}
+
+static float softmax(float x) {
+  return x;
+}
+)");
+    // One binding slot per program input/output; intermediates stay
+    // internal to the run body.
+    EmitLine(format("typedef struct { const char* name; size_t size; void* data; } %1%_binding;") % prefix_);
+    EmitLine(format("%1%_binding %1%_bindings[] = {") % prefix_);
+    PushTab();
+    for (const auto& ref : program.refs) {
+      binding_idxs_.emplace(ref.into(), binding_idxs_.size());
+      EmitLine(format("{\"%1%\", %2%, 0},") % ref.into() % ref.interior_shape.byte_size());
+    }
+    PopTab();
+    EmitLine("};");
+    EmitLine(format("enum { %1%_nbindings = %2% };") % prefix_ % binding_idxs_.size());
+    EmitLine("");
+    EmitLine(format("int %1%_bind(const char* name, void* data) {") % prefix_);
+    PushTab();
+    EmitLine(format("for (size_t i = 0; i < %1%_nbindings; i++) {") % prefix_);
+    PushTab();
+    EmitLine(format("if (strcmp(%1%_bindings[i].name, name) == 0) {") % prefix_);
+    PushTab();
+    EmitLine(format("%1%_bindings[i].data = data;") % prefix_);
+    EmitLine("return 0;");
+    PopTab();
+    EmitLine("}");
+    PopTab();
+    EmitLine("}");
+    EmitLine("return 1;");
+    PopTab();
+    EmitLine("}");
+    EmitLine("");
+    EmitLine(format("int %1%_run(void) {") % prefix_);
+    PushTab();
+    EmitLine(format("for (size_t i = 0; i < %1%_nbindings; i++) {") % prefix_);
+    PushTab();
+    EmitLine(format("if (!%1%_bindings[i].data) {") % prefix_);
+    PushTab();
+    EmitLine("return 1;");
+    PopTab();
+    EmitLine("}");
+    PopTab();
+    EmitLine("}");
+    EmitBlock(program);
+    EmitLine("return 0;");
+    PopTab();
+    EmitLine("}");
+    return oss_.str();
+  }
+
  private:
   void EmitLoad(const Block& block, const Load& load) {
     auto ref = block.ref_by_into(load.from);
@@ -154,11 +229,18 @@ float softmax(float x) {
     }
     PushTab();
 
+    // In the AOT flow, run a kernel's outermost loop across threads when
+    // every write's address varies with it (a reduction over it would race).
+    bool omp_pending = !prefix_.empty() && block.has_tag("kernel");
     for (const auto& idx : block.idxs) {
       auto idx_name = UniqueName(idx.name);
       if (idx.range == 1) {
         EmitLine(format("int %1% = %2%;") % idx_name % ParentResolve(idx.affine));
       } else {
+        if (omp_pending && SafeToParallelize(block, idx.name)) {
+          EmitLine("#pragma omp parallel for");
+        }
+        omp_pending = false;
         EmitLine(format("for (int %1% = 0; %1% < %2%; %1%++) {") % idx_name % idx.range);
         PushTab();
       }
@@ -172,13 +254,21 @@ float softmax(float x) {
       EmitLine("}");
     }
 
+    const char* qual = prefix_.empty() ? "" : " restrict";
     for (const auto& ref : block.refs) {
       auto type = IntoC(ref.interior_shape.type);
       auto into = UniqueName(ref.into());
       if (ref.from.empty()) {
-        EmitLine(format("%1%* %2% = malloc(%3% * sizeof(%1%));") % type % into % ref.interior_shape.elem_size());
+        if (!prefix_.empty() && depth_ == 1) {
+          // Program I/O: the caller supplied this buffer via the binding table.
+          EmitLine(format("%1%*%2% %3% = (%1%*)%4%_bindings[%5%].data;")  //
+                   % type % qual % into % prefix_ % binding_idxs_.at(ref.into()));
+        } else {
+          EmitLine(format("%1%*%2% %3% = malloc(%4% * sizeof(%1%));") % type % qual % into %
+                   ref.interior_shape.elem_size());
+        }
       } else {
-        EmitLine(format("%1%* %2% = %3% + %4%;") % type % into % ParentName(ref.from) %
+        EmitLine(format("%1%*%2% %3% = %4% + %5%;") % type % qual % into % ParentName(ref.from) %
                  UniqueResolve(ref.FlatAccess()));
       }
     }
@@ -209,7 +299,7 @@ float softmax(float x) {
       }
     }
     for (const auto& ref : block.refs) {
-      if (ref.from.empty()) {
+      if (ref.from.empty() && (prefix_.empty() || depth_ != 1)) {
         EmitLine(format("free(%1%);") % UniqueName(ref.into()));
       }
     }
@@ -227,6 +317,26 @@ float softmax(float x) {
     Pop();
   }
 
+  bool SafeToParallelize(const Block& block, const std::string& idx_name) {
+    for (const auto& ref : block.refs) {
+      if (!IsWriteDir(ref.dir)) {
+        continue;
+      }
+      bool uses = false;
+      for (const auto& acc : ref.access) {
+        auto acc_map = acc.getMap();
+        auto it = acc_map.find(idx_name);
+        if (it != acc_map.end() && it->second != 0) {
+          uses = true;
+        }
+      }
+      if (!uses) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   std::string IntoC(const DataType& type) {
     switch (type) {
       case DataType::BOOLEAN:
@@ -310,6 +420,8 @@ float softmax(float x) {
   std::ostringstream oss_;
   size_t indent_ = 0;
   size_t depth_ = 0;
+  std::string prefix_;
+  std::map<std::string, size_t> binding_idxs_;
 };
 
 }  // namespace
@@ -319,6 +431,11 @@ std::string EmitC(const Block& program) {
   return gen.EmitProgram(program);
 }
 
+std::string EmitAotC(const Block& program, const std::string& prefix) {
+  CodeGenerator gen(prefix);
+  return gen.EmitProgram(program);
+}
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
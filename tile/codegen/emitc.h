@@ -12,6 +12,15 @@ namespace codegen {
 
 std::string EmitC(const stripe::Block& program);
 
+// Emits the program as self-contained C for ahead-of-time deployment on
+// targets with no JIT: restrict-qualified pointers, OpenMP annotations on
+// provably parallel kernel loops, and a tiny binding runtime —
+// <prefix>_bind(name, ptr) attaches caller buffers to the program's
+// inputs/outputs and <prefix>_run() executes it.  The output builds with
+// any C99 cross toolchain; OpenMP is optional (the pragmas are ignored
+// without it).
+std::string EmitAotC(const stripe::Block& program, const std::string& prefix);
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
@@ -3,6 +3,7 @@
 #include "tile/codegen/fuse.h"
 
 #include <algorithm>
+#include <chrono>
 #include <set>
 #include <utility>
 #include <vector>
@@ -368,6 +369,29 @@ std::shared_ptr<Block> FusionRefactor(const stripe::Block& orig,
   return outer;
 }
 
+size_t EstimateScalarPressure(const stripe::Block& block) {
+  // Backward liveness over the block's statements: a scalar becomes live at
+  // its last use and dies at its definition.  Sub-blocks contribute their
+  // own peak on top of whatever's live around them.
+  std::set<std::string> live;
+  size_t peak = 0;
+  for (auto it = block.stmts.rbegin(); it != block.stmts.rend(); ++it) {
+    auto inner = Block::Downcast(*it);
+    if (inner) {
+      peak = std::max(peak, live.size() + EstimateScalarPressure(*inner));
+      continue;
+    }
+    for (const auto& name : (*it)->scalar_uses()) {
+      live.insert(name);
+    }
+    peak = std::max(peak, live.size());
+    for (const auto& name : (*it)->scalar_defs()) {
+      live.erase(name);
+    }
+  }
+  return peak;
+}
+
 bool FuseBlocks(const AliasMap& scope, Block* block_a, Block* block_b) {
   // If indexes don't match, fail
   if (block_a->idxs != block_b->idxs) {
@@ -454,6 +478,10 @@ bool FuseBlocks(const AliasMap& scope, Block* block_a, Block* block_b) {
     return "";
   };
   // Now move across statements, updating references/scalars as we do:
+  // the rewrites below mutate leaf statements in place, so privatize any
+  // that are shared with another block (e.g. unroll siblings or a
+  // copy-on-write planning clone).
+  MaterializeStmts(block_b, 0);
   for (const auto& stmt : block_b->stmts) {
     switch (stmt->kind()) {
       case StmtKind::Load: {
@@ -645,13 +673,121 @@ void FusionInner(const AliasMap& scope, Block* block, TagFusionStrategy* strateg
   }
 }
 
-static void FusionPassRecurse(const AliasMap& map, stripe::Block* block, TagFusionStrategy* strategy) {
-  FusionInner(map, block, strategy, strategy->NoInner(), strategy->NoConstraints());
+namespace {
+
+// A tag strategy that additionally consults a precomputed fuse/skip decision
+// sequence: the Nth tag-matched fusion opportunity gets decisions[N], and
+// opportunities beyond the sequence fall back to the greedy default of
+// fusing.  Used by the planner to steer FusionInner down alternate plans.
+class PlannedFusionStrategy : public TagFusionStrategy {
+ public:
+  PlannedFusionStrategy(const proto::FusionPass& options, const std::vector<bool>& decisions)
+      : TagFusionStrategy(options), decisions_(decisions) {}
+
+  bool AttemptFuse(const stripe::Block& parent, const stripe::Block& a, const stripe::Block& b) final {
+    if (!TagFusionStrategy::AttemptFuse(parent, a, b)) {
+      return false;
+    }
+    auto n = seen_++;
+    if (n < decisions_.size()) {
+      return decisions_[n];
+    }
+    return true;
+  }
+
+  // The number of tag-matched opportunities encountered, i.e. the length of
+  // the decision space for this block.
+  size_t seen() const { return seen_; }
+
+ private:
+  std::vector<bool> decisions_;
+  size_t seen_ = 0;
+};
+
+// Estimates the memory traffic of running the block's statement list: the
+// total footprint of every sub-block refinement.  Fusing two blocks over a
+// shared buffer collapses its store/load pair into one refinement, so lower
+// is better.
+int64_t MemoryTraffic(const Block& block) {
+  int64_t total = 0;
+  for (const auto& stmt : block.stmts) {
+    auto inner = Block::Downcast(stmt);
+    if (!inner) {
+      continue;
+    }
+    for (const auto& ref : inner->refs) {
+      total += Codec::Resolve(ref.interior_shape)->byte_size();
+    }
+  }
+  return total;
+}
+
+// Searches over fuse/skip decision sequences for the block's fusion
+// opportunities, scoring each candidate plan's memory traffic on a clone,
+// and applies the cheapest plan found within the budget.  The search starts
+// from the greedy plan (fuse everything that matches) and hill-climbs on
+// single-decision flips; skipping one fusion reorders the downstream
+// opportunity sequence, which is exactly how a greedy early fusion can be
+// traded for a better later one.
+void PlanAndFuse(const AliasMap& outer, Block* block, const proto::FusionPass& options) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.plan_budget_ms());
+  auto simulate = [&](const std::vector<bool>& decisions, size_t* seen) {
+    // Copy-on-write: FuseBlocks privatizes the leaf statements it rewrites,
+    // so the planning clones only pay for the block skeletons.
+    auto clone = CloneBlock(*block, -1, /* share_leaves = */ true);
+    AliasMap clone_map(outer, clone.get());
+    PlannedFusionStrategy strategy(options, decisions);
+    FusionInner(clone_map, clone.get(), &strategy, options.no_inner(), options.no_constraints());
+    *seen = strategy.seen();
+    return MemoryTraffic(*clone);
+  };
+
+  std::vector<bool> best;
+  size_t opportunities = 0;
+  auto best_cost = simulate(best, &opportunities);
+  bool improved = true;
+  while (improved && std::chrono::steady_clock::now() < deadline) {
+    improved = false;
+    for (size_t i = 0; i < opportunities; i++) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      auto trial = best;
+      if (trial.size() <= i) {
+        trial.resize(i + 1, true);
+      }
+      trial[i] = !trial[i];
+      size_t trial_opportunities = 0;
+      auto cost = simulate(trial, &trial_opportunities);
+      if (cost < best_cost) {
+        IVLOG(2, "PlanAndFuse> improved traffic: " << best_cost << " -> " << cost << " on block: " << block->name);
+        best_cost = cost;
+        best = trial;
+        opportunities = trial_opportunities;
+        improved = true;
+      }
+    }
+  }
+
+  AliasMap map(outer, block);
+  PlannedFusionStrategy strategy(options, best);
+  FusionInner(map, block, &strategy, options.no_inner(), options.no_constraints());
+}
+
+}  // namespace
+
+static void FusionPassRecurse(const AliasMap& outer, const AliasMap& map, stripe::Block* block,
+                              TagFusionStrategy* strategy) {
+  if (strategy->Options().plan_budget_ms()) {
+    PlanAndFuse(outer, block, strategy->Options());
+  } else {
+    FusionInner(map, block, strategy, strategy->NoInner(), strategy->NoConstraints());
+  }
   for (const auto& stmt : block->stmts) {
     auto inner = Block::Downcast(stmt);
     if (inner) {
       AliasMap inner_map(map, inner.get());
-      FusionPassRecurse(inner_map, inner.get(), strategy);
+      FusionPassRecurse(map, inner_map, inner.get(), strategy);
     }
   }
 }
@@ -662,7 +798,7 @@ void FusionPass::Apply(CompilerState* state) const {
   AliasMap root_map(base, root);
   // Check if we should fuse this block
   TagFusionStrategy strategy(options_);
-  FusionPassRecurse(root_map, root, &strategy);
+  FusionPassRecurse(base, root_map, root, &strategy);
 }
 
 namespace {
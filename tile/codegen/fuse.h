@@ -42,6 +42,10 @@ std::shared_ptr<stripe::Block> FusionRefactor(const stripe::Block& block,
 // destructively modified.  Otherwise returns false and leave blocks unaltered.
 bool FuseBlocks(const AliasMap& scope, stripe::Block* a, stripe::Block* b);
 
+// Estimates the peak number of simultaneously-live scalars within a block,
+// a proxy for the register pressure of the kernel it lowers to.
+size_t EstimateScalarPressure(const stripe::Block& block);
+
 class FusionStrategy {
  public:
   // Called when candidate blocks for fusion are located, returns whether to attempt a fusion
@@ -68,6 +72,11 @@ class TagFusionStrategy : public FusionStrategy {
     if (options_.output_match() && a.idxs.size() != b.idxs.size()) {
       return false;
     }
+    if (options_.max_live_scalars() &&
+        EstimateScalarPressure(a) + EstimateScalarPressure(b) > options_.max_live_scalars()) {
+      // The fused chain would likely spill; leave the split at this boundary.
+      return false;
+    }
     return true;
   }
   void OnFailed() {}
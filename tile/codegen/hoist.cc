@@ -0,0 +1,94 @@
+// Copyright 2020, Intel Corporation
+
+#include "tile/codegen/hoist.h"
+
+#include <string>
+
+#include "tile/codegen/cache.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Whether every use of `from` inside `inner` reads it at an address that
+// doesn't vary with any of inner's own real loop indexes.  Constant taps
+// and passthrough indexes (affine of the parent's indexes) are fine: those
+// are the same for every inner iteration.  A write disqualifies the
+// refinement outright; a hoisted copy wouldn't see it.
+bool InvariantUses(const Block& inner, const std::string& from, bool* used) {
+  for (const auto& ref : inner.refs) {
+    if (ref.from != from) {
+      continue;
+    }
+    if (!IsReadDir(ref.dir)) {
+      return false;
+    }
+    *used = true;
+    for (const auto& access : ref.access) {
+      for (const auto& term : access.getMap()) {
+        if (term.first.empty()) {
+          continue;
+        }
+        const auto* idx = inner.idx_by_name(term.first);
+        if (idx && idx->affine == Affine() && idx->range > 1) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void HoistBlock(const AliasMap& map, Block* block, const proto::HoistPass& options) {
+  auto mem_loc = stripe::FromProto(options.mem_loc());
+  auto xfer_loc = stripe::FromProto(options.xfer_loc());
+  // ApplySimpleCache rewrites block->refs; walk a copy.
+  auto refs = block->refs;
+  for (const auto& ref : refs) {
+    if (!IsReadDir(ref.dir)) {
+      continue;
+    }
+    if (options.max_size() && ref.interior_shape.byte_size() > options.max_size()) {
+      continue;
+    }
+    bool used = false;
+    bool invariant = true;
+    for (const auto& stmt : block->stmts) {
+      auto inner = Block::Downcast(stmt);
+      if (inner && !InvariantUses(*inner, ref.into(), &used)) {
+        invariant = false;
+        break;
+      }
+    }
+    if (!invariant || !used) {
+      continue;
+    }
+    IVLOG(2, "Hoisting " << ref.into() << " out of the interior of " << block->name);
+    ApplySimpleCache(map, RefDir::In, block, ref.into(), mem_loc, xfer_loc,  //
+                     {"cache", "hoist_load"}, {"cache", "hoist_store"});
+  }
+}
+
+}  // namespace
+
+void HoistPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, Block* block) {  //
+    HoistBlock(map, block, options_);
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<HoistPass, proto::HoistPass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,27 @@
+// Copyright 2020, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+// Hoists small read-only refinements whose inner accesses are invariant
+// over the inner blocks' loop indexes into a copy at the matched block's
+// level; see proto::HoistPass.
+class HoistPass final : public CompilePass {
+ public:
+  explicit HoistPass(const proto::HoistPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::HoistPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
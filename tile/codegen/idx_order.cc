@@ -1,6 +1,10 @@
 // Copyright 2018, Intel Corporation
 
 #include "tile/codegen/idx_order.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "base/util/any_factory_map.h"
 #include "tile/codegen/tile.h"
 #include "tile/stripe/stripe.h"
@@ -86,11 +90,52 @@ void ReorderIndex(Block* block, bool global_only, bool apply_inner) {
   target->idxs = new_idxs;
 }
 
+// Estimated cache lines fetched per iteration of `idx` if it ran innermost,
+// summed over the block's refinements.  A stride of zero stays in the same
+// line; strides smaller than a line share one fetch across line/stride
+// iterations; strides of a line or more fetch a fresh line every iteration.
+double InnermostLineCost(Block* block, const Index& idx, uint64_t cache_line, bool global_only) {
+  double cost = 0.0;
+  for (const auto& ref : block->refs) {
+    if (IsRegisterRef(ref) || (global_only && !IsGlobalRef(ref))) {
+      continue;
+    }
+    auto stride = ref.FlatAccess().get(idx.name);
+    double bytes = std::abs(stride) * static_cast<double>(byte_width(ref.interior_shape.type));
+    if (bytes == 0) {
+      continue;
+    }
+    cost += std::min(1.0, bytes / cache_line);
+  }
+  return cost;
+}
+
+void ReorderIndexByReuse(Block* block, uint64_t cache_line, bool global_only, bool apply_inner) {
+  Block* target = apply_inner ? (block->SubBlock(0).get()) : block;
+  // Under a separable fetch model, total estimated fetches over all candidate
+  // orders is minimized by placing the cheapest-per-iteration index innermost,
+  // the next cheapest above it, and so on; a stable sort keeps the incoming
+  // order on ties.  Range-1 indexes never advance an access, so they float
+  // outward for free.
+  std::vector<Index> new_idxs = target->idxs;
+  std::stable_sort(new_idxs.begin(), new_idxs.end(),  //
+                   [&](const Index& a, const Index& b) {
+                     return InnermostLineCost(block, a, cache_line, global_only) >
+                            InnermostLineCost(block, b, cache_line, global_only);
+                   });
+  target->idxs = new_idxs;
+}
+
 void IdxOrderPass::Apply(CompilerState* state) const {
   auto reqs = stripe::FromProto(options_.reqs());
+  auto cache_line = options_.cache_line();
   RunOnBlocks(state->entry(), reqs,
-              [](const AliasMap& alias_map, stripe::Block* block) {  //
-                ReorderIndex(block, true, false);
+              [cache_line](const AliasMap& alias_map, stripe::Block* block) {
+                if (cache_line) {
+                  ReorderIndexByReuse(block, cache_line, true, false);
+                } else {
+                  ReorderIndex(block, true, false);
+                }
               },
               true);
 }
@@ -20,6 +20,11 @@ bool IsRegisterRef(const stripe::Refinement& ref);
 // apply_inner: Assume block is tiled. Order the index in the inner block
 void ReorderIndex(stripe::Block* block, bool global_only, bool apply_inner);
 
+// Reorder the index by estimated cache-line fetches: each index is scored by
+// the lines the block's refinements would touch per iteration with that index
+// innermost, and the minimizing order (cheapest innermost) is applied.
+void ReorderIndexByReuse(stripe::Block* block, uint64_t cache_line, bool global_only, bool apply_inner);
+
 class IdxOrderPass final : public CompilePass {
  public:
   explicit IdxOrderPass(const proto::IdxOrderPass& options) : options_{options} {}
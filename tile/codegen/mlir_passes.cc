@@ -15,7 +15,10 @@
 #include "pmlc/dialect/stripe/nop_pass.h"
 #include "pmlc/dialect/stripe/padding_pass.h"
 #include "pmlc/dialect/stripe/transcode.h"
+#include "pmlc/dialect/stripe/vectorize_pass.h"
+#include "tile/codegen/alias.h"
 #include "tile/codegen/compile_pass.h"
+#include "tile/codegen/tag_index.h"
 
 // N.B. We need to confine all definitions to MLIR here.
 // The reason is that when we mix Windows system headers with MLIR, we get
@@ -36,7 +39,11 @@ struct MLIRState {
 };
 
 CompilerState::CompilerState(std::shared_ptr<stripe::Program> prog)
-    : mlir(std::make_unique<MLIRState>()), prog(prog), const_bufs(nullptr) {}
+    : mlir(std::make_unique<MLIRState>()),
+      prog(prog),
+      const_bufs(nullptr),
+      alias_cache(std::make_shared<AliasMapCache>()),
+      tag_index(std::make_shared<TagIndex>()) {}
 
 CompilerState::~CompilerState() = default;
 
@@ -87,6 +94,7 @@ inline void RegisterPass() {
   RegisterPass<pmlc::dialect::stripe::AutoStencilPass, proto::MLIR_AutoStencilPass>();
   RegisterPass<pmlc::dialect::stripe::NopPass, proto::MLIR_NopPass>();
   RegisterPass<pmlc::dialect::stripe::PaddingPass, proto::MLIR_PadPass>();
+  RegisterPass<pmlc::dialect::stripe::VectorizePass, proto::MLIR_VectorizePass>();
   return 0;
 }();
 
@@ -236,6 +236,38 @@ void PrimeDimension(Block* block, const proto::PadPass& options) {
   }
 }
 
+// Round ragged index ranges up to the next multiple of the SIMD width so the
+// vectorizer sees full-width loops.  ModifyBlockIdxs supplies the epilogue
+// masking: the widened output lands in a zero-initialized scratch buffer and
+// only the valid region is copied back into the original shape.
+void AlignDimension(Block* block, const proto::PadPass& options) {
+  uint64_t align = options.align_multiple();
+  if (align < 2) {
+    return;
+  }
+  for (StatementIt stmt_it = block->stmts.begin(); stmt_it != block->stmts.end(); ++stmt_it) {
+    auto inner = Block::Downcast(*stmt_it);
+    if (!QualifiedBlock(inner.get())) {
+      continue;
+    }
+    std::map<std::string, size_t> new_idxs;
+    double overhead = 1.0;
+    for (auto& idx : inner->idxs) {
+      if (!(idx.affine == Affine()) || idx.range <= 1 || idx.range % align == 0) {
+        continue;
+      }
+      size_t padded = math::Align(idx.range, align);
+      overhead *= static_cast<double>(padded) / idx.range;
+      new_idxs.emplace(idx.name, padded);
+    }
+    // Only round when the extra iteration space stays within budget; for
+    // small ranges the rounding cost can easily exceed the vector win.
+    if (!new_idxs.empty() && overhead - 1.0 <= options.max_align_overhead()) {
+      ModifyBlockIdxs(inner.get(), new_idxs, block, stmt_it);
+    }
+  }
+}
+
 void Pad(Block* block, const AliasMap& map, const RefDefineMap& ref_def_map) {
   // Generate a map extents for possible padding candidates
   Extents extents;
@@ -423,6 +455,7 @@ void PadPass::Apply(CompilerState* state) const {
   auto reqs = stripe::FromProto(options_.reqs());
   RefDefineMap ref_def_map;
   PrimeDimension(root->SubBlock(0).get(), options_);
+  AlignDimension(root->SubBlock(0).get(), options_);
   CollectRefDefine(root->SubBlock(0).get(), &ref_def_map);
   RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, stripe::Block* block) {  //
     Pad(block, map, ref_def_map);
@@ -265,36 +265,29 @@ void PartitionBuffer(const AliasMap& alias_map,                          //
   PruneIndexes(block, {"$part"});
 }
 
-void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
-                     const AliasMap& alias_map,                    //
-                     Block* block,                                 //
-                     const proto::PartitionMemoryPass& options) {
-  IVLOG(2, "Partition> block: " << block->name);
-  if (block->ref_outs().size() != 1) {
-    IVLOG(1, boost::format("Partition> skipped '%1%' due to multiple outputs") % block->name);
-    return;  // Only work on blocks with a single output
-  }
-  // Get the (only) output
-  const Refinement* out_ref = block->ref_outs()[0];
-  // Find the largest input
-  size_t biggest = 0;
-  AliasInfo big_alias;
-  const Refinement* big_ref = nullptr;
-  for (const auto& ref : block->ref_ins()) {
-    // Get the source buffer size
-    const auto& alias_info = alias_map.at(ref->into());
-    size_t src_size = alias_info.base_ref->interior_shape.elem_size();
-    if (src_size > biggest) {
-      biggest = src_size;
-      big_ref = ref;
-      big_alias = alias_info;
+// Returns the bank model matching the buffer's location, if any device in the
+// location names a declared bank.
+const proto::BankModel* FindBankModel(const proto::PartitionMemoryPass& options, const Location& loc) {
+  for (const auto& bank : options.banks()) {
+    for (const auto& dev : loc.devs) {
+      if (dev.name == bank.name()) {
+        return &bank;
+      }
     }
   }
-  if (big_ref == nullptr) {
-    IVLOG(1, "Partition> skipped due to no inputs");
-    return;  // No inputs?  Skip this block
-  }
-  IVLOG(2, "  big_ref: " << PrintRefinement(*big_ref, block));
+  return nullptr;
+}
+
+// Attempts to set up banking for big_ref; returns false if this refinement
+// can't be banked (no usable index, complex banking, or a per-part footprint
+// that would spill the declared bank capacity).
+bool TryBankRef(std::map<std::string, BankInfo>* bank_infos,  //
+                const AliasMap& alias_map,                    //
+                Block* block,                                 //
+                const Refinement* big_ref,                    //
+                const Refinement* out_ref,                    //
+                const proto::PartitionMemoryPass& options) {
+  const auto& big_alias = alias_map.at(big_ref->into());
   // Find the evenest index that has a non-zero stride both on the large
   // input and on the output refinement
   std::string idx_name;
@@ -322,7 +315,7 @@ void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
   }
   if (best_tile == 0) {
     IVLOG(1, "Partition> skipped due to no valid indexes");
-    return;  // No valid indexes?  Skip this block
+    return false;  // No valid indexes?  Skip this refinement
   }
   // Determine the bank_dim for the split memory
   std::optional<size_t> dim_pos;
@@ -331,7 +324,7 @@ void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
     if (big_ref->access[i].get(idx_name)) {
       if (dim_pos) {
         IVLOG(1, "Partition> skipped due to complex banking");
-        return;
+        return false;
       }
       dim_pos = i;
     }
@@ -345,7 +338,17 @@ void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
   }
   if (!dim_pos) {
     IVLOG(1, "Could not find dimension to bank on for block: " << block->name << ", ref: " << *big_alias.base_ref);
-    return;
+    return false;
+  }
+  // With a declared capacity for the bank this buffer lives in, reject splits
+  // whose per-part footprint would spill it
+  auto part_shape = big_alias.base_ref->interior_shape;
+  part_shape.resize_dim(*dim_pos, math::RoundUp(part_shape.dims[*dim_pos].size, options.num_parts()));
+  auto model = FindBankModel(options, big_alias.base_ref->location);
+  if (model && model->size() && part_shape.byte_size() > model->size()) {
+    IVLOG(1, "Partition> skipped " << big_alias.base_name << ": per-part footprint " << part_shape.byte_size()
+                                   << " exceeds capacity " << model->size() << " of bank " << model->name());
+    return false;
   }
 
   auto& bank_info = (*bank_infos)[big_alias.base_name];
@@ -362,6 +365,46 @@ void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
   bank_info.banked_shape.resize_dim(bank_info.dim_pos, part_size);
   bank_info.num_banks = options.num_parts();
   base_ref->bank_dim = BankDimension{bank_info.dim_pos};
+  return true;
+}
+
+void CollectBankInfo(std::map<std::string, BankInfo>* bank_infos,  //
+                     const AliasMap& alias_map,                    //
+                     Block* block,                                 //
+                     const proto::PartitionMemoryPass& options) {
+  IVLOG(2, "Partition> block: " << block->name);
+  if (block->ref_outs().size() != 1) {
+    IVLOG(1, boost::format("Partition> skipped '%1%' due to multiple outputs") % block->name);
+    return;  // Only work on blocks with a single output
+  }
+  // Get the (only) output
+  const Refinement* out_ref = block->ref_outs()[0];
+  // Rank the inputs by the cost of streaming them unsplit: bytes moved over
+  // the relative bandwidth of the bank the buffer lives in.  With no bank
+  // models declared every bandwidth is 1.0 and this reduces to the largest
+  // input winning.
+  std::multimap<double, const Refinement*, std::greater<double>> candidates;
+  for (const auto& ref : block->ref_ins()) {
+    const auto& alias_info = alias_map.at(ref->into());
+    double cost = alias_info.base_ref->interior_shape.byte_size();
+    auto model = FindBankModel(options, alias_info.base_ref->location);
+    if (model && model->bandwidth() > 0) {
+      cost /= model->bandwidth();
+    }
+    candidates.emplace(cost, ref);
+  }
+  if (candidates.empty()) {
+    IVLOG(1, "Partition> skipped due to no inputs");
+    return;  // No inputs?  Skip this block
+  }
+  // Bank the hottest refinement that actually fits its bank
+  for (const auto& kvp : candidates) {
+    IVLOG(2, "  candidate: " << PrintRefinement(*kvp.second, block) << ", cost: " << kvp.first);
+    if (TryBankRef(bank_infos, alias_map, block, kvp.second, out_ref, options)) {
+      return;
+    }
+  }
+  IVLOG(1, boost::format("Partition> skipped '%1%' due to no bankable inputs") % block->name);
 }
 
 }  // namespace
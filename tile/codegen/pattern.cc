@@ -409,7 +409,7 @@ std::vector<std::string> to_string(const std::list<MatchResult>& results) {
 void PatternPass::Apply(CompilerState* state) const {
   auto reqs = FromProto(options_.reqs());
   auto pattern = pattern::Parse(options_.pattern());
-  RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, Block* block) {
+  RunOnBlocks(state, reqs, [&](const AliasMap& map, Block* block) {
     auto term = pattern::IntoTerm(*block);
     auto match = pattern::MatchFirst(pattern, term);
     if (match) {
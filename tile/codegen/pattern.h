@@ -104,6 +104,7 @@ std::vector<std::string> to_string(const std::list<MatchResult>& results);
 class PatternPass final : public CompilePass {
  public:
   explicit PatternPass(const proto::PatternPass& options) : options_{options} {}
+  bool preserves_aliasing() const final { return true; }
   void Apply(CompilerState* state) const final;
 
  private:
@@ -0,0 +1,265 @@
+// Copyright 2018, Intel Corporation
+
+#include "tile/codegen/phase_split.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/util/logging.h"
+#include "tile/codegen/alias.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Evaluate the min and lim (max + 1) a constraint polynomial may take on
+// over the index ranges visible from alias_map, as in cstr_reduction.
+void BoundConstraint(const Affine& constraint, const AliasMap& alias_map, int64_t* min_value, int64_t* lim_value) {
+  Affine poly = constraint.sym_eval(alias_map.idx_sources());
+  int64_t min = 0;
+  int64_t max = 0;
+  for (const auto& kvp : poly.getMap()) {
+    if (kvp.first == "") {
+      min += kvp.second;
+      max += kvp.second;
+      continue;
+    }
+    uint64_t range = alias_map.idx_ranges().at(kvp.first);
+    if (kvp.second >= 0) {
+      max += kvp.second * (range - 1);
+    } else {
+      min += kvp.second * (range - 1);
+    }
+  }
+  *min_value = min;
+  *lim_value = max + 1;
+}
+
+// The phase indexes of a block: literal indexes that appear in a constraint
+// and are small enough to enumerate.  Defract's residue-class digits always
+// qualify; an ordinary spatial index never does, since its range is a tensor
+// dimension.  Smallest ranges go first, and the list is cut off once the
+// product of ranges (the number of copies the split would make) would
+// exceed max_phases.
+std::vector<const Index*> ChoosePhaseIdxs(const Block& block, uint64_t max_phases) {
+  std::set<std::string> in_cons;
+  for (const auto& constraint : block.constraints) {
+    for (const auto& kvp : constraint.getMap()) {
+      if (kvp.first != "") {
+        in_cons.insert(kvp.first);
+      }
+    }
+  }
+  std::vector<const Index*> candidates;
+  for (const auto& idx : block.idxs) {
+    if (idx.affine == Affine{} && idx.range > 1 && idx.range <= max_phases && in_cons.count(idx.name)) {
+      candidates.push_back(&idx);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Index* lhs, const Index* rhs) { return lhs->range < rhs->range; });
+  std::vector<const Index*> chosen;
+  uint64_t total = 1;
+  for (const Index* idx : candidates) {
+    if (total * idx->range > max_phases) {
+      break;
+    }
+    total *= idx->range;
+    chosen.push_back(idx);
+  }
+  return chosen;
+}
+
+// Substitute the fixed index values through the block -- accesses,
+// constraints, locations, interior affines, load_index sources -- and drop
+// the now-constant indexes.
+void FixIndexes(Block* block, const std::map<std::string, int64_t>& fixed) {
+  block->location = PartialEval(block->location, fixed);
+  for (auto& ref : block->refs) {
+    ref.mut().location = PartialEval(ref.location, fixed);
+    for (auto& aff : ref.mut().access) {
+      aff = aff.partial_eval(fixed);
+    }
+    if (ref.cache_unit) {
+      ref.mut().cache_unit = ref.cache_unit->partial_eval(fixed);
+    }
+  }
+  for (auto& constraint : block->constraints) {
+    constraint = constraint.partial_eval(fixed);
+  }
+  for (const auto& stmt : block->stmts) {
+    if (auto load_index = LoadIndex::Downcast(stmt)) {
+      load_index->from = load_index->from.partial_eval(fixed);
+    }
+    if (auto inner = Block::Downcast(stmt)) {
+      for (auto& idx : inner->idxs) {
+        idx.affine = idx.affine.partial_eval(fixed);
+      }
+    }
+  }
+  for (auto it = block->idxs.begin(); it != block->idxs.end();) {
+    if (it->affine == Affine{} && fixed.count(it->name)) {
+      it = block->idxs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void PhaseSplit(Block* outer,                     //
+                Block* block,                     //
+                const AliasMap& outer_alias_map,  //
+                const StatementIt& it_stmt,       //
+                const proto::PhaseSplitPass& options) {
+  if (block->constraints.empty()) {
+    return;
+  }
+  auto phase_idxs = ChoosePhaseIdxs(*block, options.max_phases());
+  if (phase_idxs.empty()) {
+    return;
+  }
+  IVLOG(3, "PhaseSplit> " << block->name << " phase idxs: " << phase_idxs.size());
+
+  // Enumerate every assignment of the phase indexes.
+  std::vector<std::map<std::string, int64_t>> assignments{{}};
+  for (const Index* idx : phase_idxs) {
+    std::vector<std::map<std::string, int64_t>> next;
+    for (const auto& assignment : assignments) {
+      for (uint64_t value = 0; value < idx->range; value++) {
+        auto expanded = assignment;
+        expanded.emplace(idx->name, value);
+        next.push_back(std::move(expanded));
+      }
+    }
+    assignments = std::move(next);
+  }
+
+  auto phase_set = stripe::FromProto(options.phase_set());
+  std::vector<std::shared_ptr<Block>> phases;
+  // Extents written so far over the split, to detect when a later phase
+  // aggregates over memory an earlier phase wrote (cf. unroll).
+  std::map<std::string, std::vector<std::vector<Extent>>> ref_write_extents;
+  bool eliminated = false;
+  for (const auto& assignment : assignments) {
+    auto clone = CloneBlock(*block);
+    FixIndexes(clone.get(), assignment);
+    std::stringstream ss;
+    ss << "%phase";
+    for (const auto& kvp : assignment) {
+      ss << "_" << kvp.first << "_" << kvp.second;
+    }
+    clone->name += ss.str();
+    // With the phase pinned, drop the constraints it satisfies outright, and
+    // drop the whole phase when a constraint can never hold.
+    AliasMap clone_map{outer_alias_map, clone.get()};
+    bool dead = false;
+    for (auto it = clone->constraints.begin(); it != clone->constraints.end();) {
+      int64_t min_value, lim_value;
+      BoundConstraint(*it, clone_map, &min_value, &lim_value);
+      if (lim_value <= 0) {
+        IVLOG(4, "  " << clone->name << " infeasible: " << *it << " >= 0");
+        dead = true;
+        eliminated = true;
+        break;
+      }
+      if (min_value >= 0) {
+        IVLOG(4, "  " << clone->name << " drops: " << *it << " >= 0");
+        it = clone->constraints.erase(it);
+        eliminated = true;
+      } else {
+        ++it;
+      }
+    }
+    if (dead) {
+      continue;
+    }
+    clone->add_tags(phase_set);
+    for (auto& ref : clone->refs) {
+      if (!IsWriteDir(ref.dir)) {
+        continue;
+      }
+      const auto& ai = clone_map.at(ref.into());
+      if (ref.agg_op.size() && !IsReadDir(ref.dir)) {
+        // Aggregating over memory an earlier phase wrote; pick up the read
+        // direction so the earlier phase's result isn't discarded.
+        auto name_extents = ref_write_extents.find(ai.base_name);
+        if (name_extents != ref_write_extents.end()) {
+          for (const auto& extents : name_extents->second) {
+            if (CheckOverlap(ai.extents, extents)) {
+              ref.mut().dir = RefDir::InOut;
+              break;
+            }
+          }
+        }
+      }
+      ref_write_extents[ai.base_name].emplace_back(ai.extents);
+    }
+    phases.push_back(std::move(clone));
+  }
+
+  // A split that leaves every guard in place in every phase buys nothing and
+  // just multiplies kernels; keep the original block.
+  if (!eliminated) {
+    IVLOG(3, "PhaseSplit> " << block->name << " eliminates no constraints; skipping");
+    return;
+  }
+  for (auto& phase : phases) {
+    outer->stmts.emplace(it_stmt, std::move(phase));
+  }
+  outer->erase_stmt(it_stmt);
+}
+
+void SplitBlocks(Block* outer,                     //
+                 Block* block,                     //
+                 const AliasMap& outer_alias_map,  //
+                 const StatementIt& it_stmt,       //
+                 const Tags& reqs,                 //
+                 const proto::PhaseSplitPass& options) {
+  if (block->has_tags(reqs)) {
+    PhaseSplit(outer, block, outer_alias_map, it_stmt, options);
+  } else {
+    AliasMap alias_map{outer_alias_map, block};
+    PreIterate(block, [&](const StatementIt& it) {
+      auto inner = Block::Downcast(*it);
+      if (inner) {
+        SplitBlocks(block, inner.get(), alias_map, it, reqs, options);
+      }
+    });
+  }
+}
+
+}  // namespace
+
+void PhaseSplitPass::Apply(CompilerState* state) const {
+  auto reqs = stripe::FromProto(options_.reqs());
+  Block* root = state->entry();
+  AliasMap base_alias_map;
+  AliasMap alias_map{base_alias_map, root};
+  PreIterate(root, [&](const StatementIt& it) {
+    auto inner = Block::Downcast(*it);
+    if (inner) {
+      SplitBlocks(root, inner.get(), alias_map, it, reqs, options_);
+    }
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<PhaseSplitPass, proto::PhaseSplitPass>::Register();
+  return 0;
+}();
+}  // namespace
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,230 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/pipeline.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/util/logging.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Picks the loop index to pipeline over.  When the pass options name one, it
+// must exist, be a real (affine-free) index, and have an even range of at
+// least two; otherwise we take the largest such index that actually strides
+// an input refinement, since that's the index whose loads we want to hoist.
+Index* PickIndex(Block* block, const proto::PipelinePass& options) {
+  if (!options.idx().empty()) {
+    auto idx = block->idx_by_name(options.idx());
+    if (idx && idx->affine == Affine{} && idx->range >= 2 && idx->range % 2 == 0) {
+      return idx;
+    }
+    return nullptr;
+  }
+  Index* best = nullptr;
+  for (auto& idx : block->idxs) {
+    if (idx.affine != Affine{} || idx.range < 2 || idx.range % 2 != 0) {
+      continue;
+    }
+    bool strides_input = false;
+    for (const auto& ref : block->refs) {
+      if (ref.dir != RefDir::In) {
+        continue;
+      }
+      for (const auto& access : ref.access) {
+        if (access.get(idx.name) != 0) {
+          strides_input = true;
+        }
+      }
+    }
+    if (strides_input && (!best || idx.range > best->range)) {
+      best = &idx;
+    }
+  }
+  return best;
+}
+
+// Verifies that hoisting the cache loads of one iteration above the compute
+// and stores of the previous iteration cannot change what they read: every
+// load must read only In-dir refinements (never something another statement
+// in this block writes) and fill only local (None-dir) buffers we can
+// double-buffer.
+bool LoadsAreHoistable(Block* block) {
+  for (const auto& stmt : block->stmts) {
+    auto sub = Block::Downcast(stmt);
+    if (!sub || !sub->has_tag("cache_load")) {
+      continue;
+    }
+    for (const auto& ref : sub->refs) {
+      if (ref.from.empty()) {
+        continue;
+      }
+      auto block_ref = block->ref_by_into(ref.from, false);
+      if (block_ref == block->refs.end()) {
+        return false;
+      }
+      if (IsReadDir(ref.dir) && block_ref->dir != RefDir::In) {
+        return false;
+      }
+      if (IsWriteDir(ref.dir) && block_ref->dir != RefDir::None) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void PipelineBlock(Block* block, const proto::PipelinePass& options) {
+  // Every statement must be a sub-block: the transform reorders statements
+  // wholesale, and only blocks carry the tags that tell us which are loads.
+  bool has_load = false;
+  for (const auto& stmt : block->stmts) {
+    auto sub = Block::Downcast(stmt);
+    if (!sub) {
+      return;
+    }
+    if (sub->has_tag("cache_load")) {
+      has_load = true;
+    }
+  }
+  if (!has_load || !LoadsAreHoistable(block)) {
+    return;
+  }
+  Index* pidx = PickIndex(block, options);
+  if (!pidx) {
+    return;
+  }
+  const auto& pname = pidx->name;
+  // Constraints mentioning the index would need to be split per half; the
+  // cache pass doesn't generate such blocks, so just leave them alone.
+  for (const auto& constraint : block->constraints) {
+    if (constraint.get(pname) != 0) {
+      return;
+    }
+  }
+  // Rescale the block's refinement accesses from i to 2i and widen the
+  // accessed window by one stride, so the odd iteration's constant offset
+  // stays inside the interior shape.  Negative strides would move the window
+  // start instead, so bail on those.
+  std::map<std::string, std::vector<std::pair<size_t, int64_t>>> shifted;
+  for (const auto& ref : block->refs) {
+    for (size_t i = 0; i < ref.access.size(); i++) {
+      int64_t coeff = ref.access[i].get(pname);
+      if (coeff < 0) {
+        return;
+      }
+      if (coeff > 0) {
+        shifted[ref.into()].emplace_back(i, coeff);
+      }
+    }
+  }
+  for (const auto& item : shifted) {
+    auto& ref = block->ref_by_into(item.first)->mut();
+    for (const auto& dim_coeff : item.second) {
+      ref.access[dim_coeff.first].substitute(pname, Affine(pname, 2));
+      ref.interior_shape.dims[dim_coeff.first].size += dim_coeff.second;
+    }
+  }
+  pidx->range /= 2;
+  // Give the odd half its own copy of the buffers the cache loads fill, so
+  // its loads can land while the even half is still computing out of the
+  // originals.
+  std::map<std::string, std::string> double_buffered;
+  for (const auto& stmt : block->stmts) {
+    auto sub = Block::Downcast(stmt);
+    if (!sub->has_tag("cache_load")) {
+      continue;
+    }
+    for (const auto& ref : sub->refs) {
+      if (IsWriteDir(ref.dir) && !double_buffered.count(ref.from)) {
+        double_buffered[ref.from] = block->unique_ref_name(ref.from + "_next");
+      }
+    }
+  }
+  for (const auto& item : double_buffered) {
+    block->refs.emplace(block->ref_by_into(item.first)->WithInto(item.second));
+  }
+  // Build the odd half: clone each sub-block, point it at the alternate
+  // buffers, and add the original stride as a constant offset on every
+  // refinement the pipelined index used to move.
+  auto arena = std::make_shared<Arena>();
+  StatementList even_loads;
+  StatementList odd_loads;
+  StatementList even_rest;
+  StatementList odd_rest;
+  for (const auto& stmt : block->stmts) {
+    auto sub = Block::Downcast(stmt);
+    auto clone = CloneBlock(*sub, -1, arena, /* share_leaves = */ true);
+    for (auto& idx : sub->idxs) {
+      idx.affine.substitute(pname, Affine(pname, 2));
+    }
+    for (auto& idx : clone->idxs) {
+      idx.affine.substitute(pname, Affine(pname, 2) + Affine{1});
+    }
+    for (auto& ref : clone->refs) {
+      auto alt = double_buffered.find(ref.from);
+      if (alt != double_buffered.end()) {
+        ref.mut().from = alt->second;
+      }
+      auto shift = shifted.find(ref.from);
+      if (shift != shifted.end()) {
+        for (const auto& dim_coeff : shift->second) {
+          ref.mut().access[dim_coeff.first] += dim_coeff.second;
+        }
+      }
+    }
+    sub->name += "%" + pname + "_0";
+    clone->name += "%" + pname + "_1";
+    if (sub->has_tag("cache_load")) {
+      even_loads.emplace_back(stmt);
+      odd_loads.emplace_back(std::move(clone));
+    } else {
+      even_rest.emplace_back(stmt);
+      odd_rest.emplace_back(std::move(clone));
+    }
+  }
+  // Interleave so both halves' loads precede the even half's compute; the
+  // existing statement iterators in deps no longer apply, so clear them and
+  // let a later deps pass rebuild the dataflow.
+  block->stmts.clear();
+  block->stmts.splice(block->stmts.end(), even_loads);
+  block->stmts.splice(block->stmts.end(), odd_loads);
+  block->stmts.splice(block->stmts.end(), even_rest);
+  block->stmts.splice(block->stmts.end(), odd_rest);
+  for (const auto& stmt : block->stmts) {
+    stmt->deps.clear();
+  }
+  block->add_tags(FromProto(options.set()));
+  IVLOG(2, "Pipelined " << block->name << " over " << pname);
+}
+
+void PipelinePass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [this](const AliasMap& map, Block* block) {  //
+    PipelineBlock(block, options_);
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<PipelinePass, proto::PipelinePass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,27 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/alias.h"
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+void PipelineBlock(stripe::Block* block, const proto::PipelinePass& options);
+
+class PipelinePass final : public CompilePass {
+ public:
+  explicit PipelinePass(const proto::PipelinePass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::PipelinePass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
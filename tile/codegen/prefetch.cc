@@ -0,0 +1,60 @@
+// Copyright 2020, Intel Corporation
+
+#include "tile/codegen/prefetch.h"
+
+#include <cstdlib>
+
+#include "tile/codegen/tag_index.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+void Prefetch(Block* block, const proto::PrefetchPass& options) {
+  // The CPU JIT generates loops in index order, so the last plain index
+  // with an actual range is the innermost loop.
+  std::string inner_idx;
+  for (const auto& idx : block->idxs) {
+    if (idx.affine == Affine() && idx.range > 1) {
+      inner_idx = idx.name;
+    }
+  }
+  if (inner_idx.empty()) {
+    return;
+  }
+  for (auto& ref : block->refs) {
+    if (!IsReadDir(ref.dir)) {
+      continue;
+    }
+    // How far the flat access moves (in elements) per innermost iteration.
+    int64_t stride = ref.FlatAccess().get(inner_idx);
+    if (std::abs(stride) < static_cast<int64_t>(options.min_stride())) {
+      // Sequential and stationary accesses are covered by the hardware
+      // prefetchers; marking them just wastes issue slots.
+      continue;
+    }
+    ref.mut().set_attr("prefetch", static_cast<int64_t>(options.distance()) * stride);
+  }
+}
+
+void PrefetchPass::Apply(CompilerState* state) const {
+  auto reqs = stripe::FromProto(options_.reqs());
+  RunOnTaggedBlocks(state, reqs,
+                    [this](const AliasMap& alias_map, stripe::Block* block) {  //
+                      Prefetch(block, options_);
+                    },
+                    false);
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<PrefetchPass, proto::PrefetchPass>::Register();
+  return 0;
+}();
+}  // namespace
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,28 @@
+// Copyright 2020, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/alias.h"
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+void Prefetch(stripe::Block* block, const proto::PrefetchPass& options);
+
+class PrefetchPass final : public CompilePass {
+ public:
+  explicit PrefetchPass(const proto::PrefetchPass& options) : options_{options} {}
+  bool preserves_aliasing() const final { return true; }
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::PrefetchPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,133 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/prune_reshapes.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+
+#include "base/util/logging.h"
+#include "tile/codegen/alias.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Chases a buffer name through the rewrites accumulated so far, so chained
+// reshapes collapse onto the original source buffer.
+std::string Chase(const std::map<std::string, std::string>& rewrites, std::string name) {
+  for (;;) {
+    auto it = rewrites.find(name);
+    if (it == rewrites.end()) {
+      return name;
+    }
+    name = it->second;
+  }
+}
+
+}  // namespace
+
+void PruneReshapes(Block* block) {
+  // Count the writers of each buffer; an elided reshape output must have no
+  // writer other than the reshape itself, or the alias would clobber data.
+  std::map<std::string, size_t> writers;
+  for (const auto& stmt : block->stmts) {
+    for (const auto& name : stmt->buffer_writes()) {
+      writers[name]++;
+    }
+  }
+
+  std::map<std::string, std::string> rewrites;
+  std::set<const Statement*> to_remove;
+  for (const auto& stmt : block->stmts) {
+    auto special = Special::Downcast(stmt);
+    if (!special || special->name != "reshape") {
+      continue;
+    }
+    if (special->inputs.size() != 1 || special->outputs.size() != 1) {
+      continue;
+    }
+    const auto& out_name = special->outputs[0];
+    auto out_it = block->ref_by_into(out_name, false);
+    if (out_it == block->refs.end() || !out_it->has_tag("tmp")) {
+      // Program outputs must be written; keep the copy.
+      continue;
+    }
+    if (writers[out_name] != 1) {
+      continue;
+    }
+    auto in_name = Chase(rewrites, special->inputs[0]);
+    auto in_it = block->ref_by_into(in_name, false);
+    if (in_it == block->refs.end()) {
+      continue;
+    }
+    const auto& in_shape = in_it->interior_shape;
+    const auto& out_shape = out_it->interior_shape;
+    if (in_shape.byte_size() != out_shape.byte_size() || in_shape.elem_size() != out_shape.elem_size()) {
+      // Not a flat relabeling of the same bytes; keep the copy.
+      continue;
+    }
+    IVLOG(2, "PruneReshapes> eliding " << out_name << " -> " << in_name);
+    rewrites[out_name] = in_name;
+    to_remove.emplace(special.get());
+  }
+  if (rewrites.empty()) {
+    return;
+  }
+
+  // Redirect every remaining use of an elided buffer to its source.
+  for (auto& stmt : block->stmts) {
+    if (to_remove.count(stmt.get())) {
+      continue;
+    }
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      for (auto& ref : inner->refs) {
+        if (rewrites.count(ref.from)) {
+          ref.mut().from = Chase(rewrites, ref.from);
+        }
+      }
+      continue;
+    }
+    auto special = Special::Downcast(stmt);
+    if (special) {
+      for (auto& name : special->inputs) {
+        name = Chase(rewrites, name);
+      }
+      for (auto& name : special->outputs) {
+        name = Chase(rewrites, name);
+      }
+    }
+  }
+
+  // Drop the elided specials and their now-unreferenced temporaries.
+  block->erase_stmts(std::remove_if(block->stmts.begin(), block->stmts.end(),
+                                    [&to_remove](const auto& stmt) { return to_remove.count(stmt.get()); }),
+                     block->stmts.end());
+  for (const auto& rewrite : rewrites) {
+    block->refs.erase(block->ref_by_into(rewrite.first));
+  }
+}
+
+void PruneReshapesPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [](const AliasMap& map, Block* block) {  //
+    PruneReshapes(block);
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<PruneReshapesPass, proto::PruneReshapesPass>::Register();
+  return 0;
+}();
+}  // namespace
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,32 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+void PruneReshapes(stripe::Block* block);
+
+// PruneReshapes elides reshape specials whose output is an internal
+// temporary.  A reshape is a flat relabeling of the same bytes, so instead
+// of emitting a copy kernel, every later use of the output buffer is
+// redirected to the input buffer and the temporary disappears.  Reshapes
+// whose output is a program output (or whose buffers aren't byte-for-byte
+// compatible) keep their copy.
+class PruneReshapesPass final : public CompilePass {
+ public:
+  explicit PruneReshapesPass(const proto::PruneReshapesPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::PruneReshapesPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,42 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/reg_block.h"
+
+#include "tile/codegen/alias.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+void RegisterBlockingPass::Apply(CompilerState* state) const {
+  auto reqs = FromProto(options_.reqs());
+  RunOnBlocks(
+      state->entry(), reqs,
+      [&](const AliasMap& map, Block* block) {
+        for (auto& ref : block->refs) {
+          // Only local allocations are candidates: a refinement with a
+          // backing buffer is someone else's storage.
+          if (ref.dir != RefDir::None || !ref.from.empty()) {
+            continue;
+          }
+          if (ref.interior_shape.byte_size() > options_.max_bytes()) {
+            continue;
+          }
+          IVLOG(3, "RegisterBlockingPass> tagging " << ref.into() << " in block: " << block->name);
+          ref.mut().set_tag("register");
+        }
+      },
+      true);
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<RegisterBlockingPass, proto::RegisterBlockingPass>::Register();
+  return 0;
+}();
+}  // namespace
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
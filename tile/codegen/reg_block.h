@@ -0,0 +1,23 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+class RegisterBlockingPass final : public CompilePass {
+ public:
+  explicit RegisterBlockingPass(const proto::RegisterBlockingPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::RegisterBlockingPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -17,6 +17,9 @@ namespace codegen {
 using namespace stripe;  // NOLINT
 
 void Scalarize(Block* block, bool recursive) {
+  // Scalarization rewrites loads/stores/intrinsics in place; privatize any
+  // statements shared with another block first.
+  MaterializeStmts(block, 0);
   // First, find all potential scalarizable buffers
   std::set<std::string> sbufs;
   for (const auto& ref : block->refs) {
@@ -109,6 +112,109 @@ void Scalarize(Block* block, bool recursive) {
   }
 }
 
+void VectorWiden(Block* block, size_t width) {
+  if (width < 2 || block->has_tag("vector_widened")) {
+    return;
+  }
+  // Pick the innermost loop index as the lane dimension
+  Index* the_idx = nullptr;
+  for (auto& idx : block->idxs) {
+    if (idx.affine == Affine() && idx.range > 1) {
+      the_idx = &idx;  // idxs run outermost-first; the last real one wins
+    }
+  }
+  if (!the_idx || the_idx->range % width != 0) {
+    return;
+  }
+  // Lanes can't be predicated away by a constraint
+  for (const auto& con : block->constraints) {
+    if (con.get(the_idx->name)) {
+      return;
+    }
+  }
+  // Only straight-line load/intrinsic/store chains widen; inner blocks,
+  // primitives and index loads would see per-lane values
+  for (const auto& stmt : block->stmts) {
+    switch (stmt->kind()) {
+      case StmtKind::Load:
+      case StmtKind::Store:
+      case StmtKind::Intrinsic:
+      case StmtKind::Constant:
+        break;
+      default:
+        return;
+    }
+  }
+  // Every buffer must be contiguous (stride 1) or invariant (stride 0) along
+  // the index.  Invariant loads broadcast; an invariant store would reduce
+  // across lanes, which the emitters can't express.
+  std::set<std::string> wide_refs;
+  for (const auto& ref : block->refs) {
+    auto stride = ref.FlatAccess().get(the_idx->name);
+    if (stride == 1) {
+      wide_refs.emplace(ref.into());
+    } else if (stride != 0 || IsWriteDir(ref.dir)) {
+      return;
+    }
+  }
+  if (wide_refs.empty()) {
+    return;
+  }
+  // Widening rewrites statement attributes in place; privatize any statements
+  // shared with another block first.
+  MaterializeStmts(block, 0);
+  // Each iteration now covers 'width' consecutive elements
+  the_idx->range /= width;
+  for (auto& ref : block->refs) {
+    if (!wide_refs.count(ref.into())) {
+      continue;
+    }
+    for (auto& aff : ref.mut().access) {
+      auto& terms = aff.mutateMap();
+      auto it = terms.find(the_idx->name);
+      if (it != terms.end()) {
+        it->second *= width;
+      }
+    }
+  }
+  // Mark the statements that carry vector values: loads from widened buffers
+  // produce them, intrinsics propagate them, stores sink them
+  std::set<std::string> wide_scalars;
+  for (auto& stmt : block->stmts) {
+    switch (stmt->kind()) {
+      case StmtKind::Load: {
+        auto load = Load::Downcast(stmt);
+        if (wide_refs.count(load->from)) {
+          load->set_attr("vector_width", static_cast<int64_t>(width));
+          wide_scalars.emplace(load->into);
+        }
+      } break;
+      case StmtKind::Intrinsic: {
+        auto intr = Intrinsic::Downcast(stmt);
+        bool wide = false;
+        for (const auto& name : intr->inputs) {
+          wide |= (wide_scalars.count(name) != 0);
+        }
+        if (wide) {
+          intr->set_attr("vector_width", static_cast<int64_t>(width));
+          for (const auto& name : intr->outputs) {
+            wide_scalars.emplace(name);
+          }
+        }
+      } break;
+      case StmtKind::Store: {
+        auto store = Store::Downcast(stmt);
+        if (wide_refs.count(store->into)) {
+          store->set_attr("vector_width", static_cast<int64_t>(width));
+        }
+      } break;
+      default:
+        break;
+    }
+  }
+  block->set_tag("vector_widened");
+}
+
 void ScalarizePass::Apply(CompilerState* state) const {
   auto reqs = stripe::FromProto(options_.reqs());
   RunOnBlocks(state->entry(), reqs, [](const AliasMap& map, stripe::Block* block) {  //
@@ -116,9 +222,17 @@ void ScalarizePass::Apply(CompilerState* state) const {
   });
 }
 
+void VectorWidenPass::Apply(CompilerState* state) const {
+  auto reqs = stripe::FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [this](const AliasMap& map, stripe::Block* block) {  //
+    VectorWiden(block, options_.width());
+  });
+}
+
 namespace {
 [[gnu::unused]] char reg = []() -> char {
   CompilePassFactory<ScalarizePass, proto::ScalarizePass>::Register();
+  CompilePassFactory<VectorWidenPass, proto::VectorWidenPass>::Register();
   return 0;
 }();
 }  // namespace
@@ -12,6 +12,10 @@ namespace codegen {
 
 void Scalarize(stripe::Block* block, bool recursive = false);
 
+// If block's innermost loop is vectorizable by 'width', shorten it and mark
+// its statements for vector emission; otherwise leave the block untouched.
+void VectorWiden(stripe::Block* block, size_t width);
+
 class ScalarizePass final : public CompilePass {
  public:
   explicit ScalarizePass(const proto::ScalarizePass& options) : options_{options} {}
@@ -21,6 +25,15 @@ class ScalarizePass final : public CompilePass {
   proto::ScalarizePass options_;
 };
 
+class VectorWidenPass final : public CompilePass {
+ public:
+  explicit VectorWidenPass(const proto::VectorWidenPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::VectorWidenPass options_;
+};
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
@@ -0,0 +1,159 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/sliding_window.h"
+
+#include <map>
+#include <string>
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Where a buffer slides: the dimension and how many elements it advances
+// per run.
+struct Slide {
+  size_t dim = 0;
+  int64_t hop = 0;
+};
+
+// Extracts the single index driving an access affine; constant taps are
+// fine (a convolution window is still a translation), anything combining
+// two indexes is not.  Returns false when the access is too complex.
+bool SingleIndex(const Affine& access, std::string* idx_name, int64_t* coeff) {
+  idx_name->clear();
+  *coeff = 0;
+  for (const auto& kvp : access.getMap()) {
+    if (kvp.first.empty()) {
+      continue;
+    }
+    if (!idx_name->empty()) {
+      return false;
+    }
+    *idx_name = kvp.first;
+    *coeff = kvp.second;
+  }
+  return true;
+}
+
+}  // namespace
+
+void SlidingWindowPass::Apply(CompilerState* state) const {
+  if (!options_.hop()) {
+    return;
+  }
+  auto reqs = FromProto(options_.reqs());
+  auto main = state->entry()->SubBlock(0);
+
+  // Buffers known to slide between runs, seeded with the streaming input.
+  std::map<std::string, Slide> sliding;
+  sliding[options_.input()] = Slide{options_.dim(), static_cast<int64_t>(options_.hop())};
+  size_t marked = 0;
+
+  for (const auto& stmt : main->stmts) {
+    auto block = Block::Downcast(stmt);
+    if (!block || !block->has_tags(reqs)) {
+      continue;
+    }
+    // Work out the shift each index must undergo for this block to see the
+    // previous run's data; every sliding input must agree on it.
+    std::map<std::string, int64_t> idx_shift;
+    bool ok = true;
+    bool touches = false;
+    for (const auto& ref : block->ref_ins()) {
+      auto it = sliding.find(ref->from);
+      if (it == sliding.end()) {
+        continue;  // weights and other run-invariant inputs
+      }
+      touches = true;
+      std::string idx_name;
+      int64_t coeff;
+      if (!SingleIndex(ref->access[it->second.dim], &idx_name, &coeff) ||  //
+          idx_name.empty() || coeff == 0 || it->second.hop % coeff != 0) {
+        ok = false;
+        break;
+      }
+      int64_t shift = it->second.hop / coeff;
+      auto sit = idx_shift.find(idx_name);
+      if (sit != idx_shift.end() && sit->second != shift) {
+        ok = false;
+        break;
+      }
+      idx_shift.emplace(idx_name, shift);
+    }
+    if (!touches) {
+      continue;
+    }
+    // A constraint on a shifted index means the kernel's behavior depends
+    // on where the window sits, so its output is not a pure shift.
+    if (ok) {
+      for (const auto& con : block->constraints) {
+        for (const auto& kvp : con.getMap()) {
+          if (idx_shift.count(kvp.first)) {
+            ok = false;
+          }
+        }
+      }
+    }
+    if (!ok) {
+      // The block consumes a sliding buffer in a window-dependent way;
+      // whatever it writes must be recomputed in full each run.
+      for (const auto& ref : block->ref_outs()) {
+        sliding.erase(ref->from);
+      }
+      continue;
+    }
+    for (const auto& ref : block->ref_outs()) {
+      // Find the output dimension the shifted index drives; the output
+      // slides only if exactly one dimension does.
+      size_t out_dim = 0;
+      int64_t out_hop = 0;
+      bool found = false;
+      bool clean = true;
+      for (size_t i = 0; i < ref->access.size(); i++) {
+        for (const auto& kvp : ref->access[i].getMap()) {
+          auto sit = idx_shift.find(kvp.first);
+          if (kvp.first.empty() || sit == idx_shift.end()) {
+            continue;
+          }
+          if (found) {
+            clean = false;
+          }
+          found = true;
+          out_dim = i;
+          out_hop = sit->second * kvp.second;
+        }
+      }
+      if (!found || !clean) {
+        sliding.erase(ref->from);
+        continue;
+      }
+      sliding[ref->from] = Slide{out_dim, out_hop};
+      block->set_tag("sliding");
+      auto main_ref = main->ref_by_into(ref->from, false);
+      if (main_ref != main->refs.end()) {
+        main_ref->mut().set_tag("sliding");
+        main_ref->mut().set_tag("sliding_dim_" + std::to_string(out_dim));
+        main_ref->mut().set_tag("sliding_hop_" + std::to_string(out_hop));
+      }
+      marked++;
+      IVLOG(2, "Sliding kernel " << block->name << ": " << ref->from << " shifts " << out_hop << " along dim "
+                                 << out_dim);
+    }
+  }
+  IVLOG(1, "SlidingWindowPass: " << marked << " kernel outputs shift with input " << options_.input());
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<SlidingWindowPass, proto::SlidingWindowPass>::Register();
+  return 0;
+}();
+}  // namespace
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
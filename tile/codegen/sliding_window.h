@@ -0,0 +1,26 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+// Marks kernels whose outputs shift (rather than change) when a designated
+// program input slides between runs; see proto::SlidingWindowPass.
+class SlidingWindowPass final : public CompilePass {
+ public:
+  explicit SlidingWindowPass(const proto::SlidingWindowPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::SlidingWindowPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,225 @@
+// Copyright 2018, Intel Corporation
+
+#include "tile/codegen/split_reduction.h"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/util/logging.h"
+#include "tile/codegen/alias.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+using namespace math;    // NOLINT
+
+namespace {
+
+// Finds the contraction's single aggregating output, or nullptr when the
+// block's outputs don't fit the transform (multiple outputs, or an
+// aggregation other than add, whose partials we can't zero-initialize).
+const Refinement* FindAddOutput(Block* block) {
+  const Refinement* out = nullptr;
+  for (const auto& ref : block->refs) {
+    if (IsWriteDir(ref.dir)) {
+      if (out || ref.dir != RefDir::Out || ref.agg_op != Intrinsic::SUM) {
+        return nullptr;
+      }
+      out = &ref;
+    }
+  }
+  return out;
+}
+
+// Picks the largest pure-reduction index: a real loop index that does not
+// appear in the output's access, with range at least min_size.
+const Index* FindReductionIndex(Block* block, const Refinement& out, int64_t min_size) {
+  std::set<std::string> out_idxs;
+  for (const auto& aff : out.access) {
+    for (const auto& kvp : aff.getMap()) {
+      out_idxs.insert(kvp.first);
+    }
+  }
+  const Index* best = nullptr;
+  for (const auto& idx : block->idxs) {
+    if (idx.affine == Affine() && !out_idxs.count(idx.name) &&
+        idx.range >= static_cast<uint64_t>(min_size) &&  //
+        (!best || idx.range > best->range)) {
+      best = &idx;
+    }
+  }
+  return best;
+}
+
+// The largest divisor of range not exceeding num_parts, or 1 if none.
+uint64_t PickParts(uint64_t range, int64_t num_parts) {
+  for (uint64_t parts = std::min<uint64_t>(num_parts, range); parts > 1; parts--) {
+    if (range % parts == 0) {
+      return parts;
+    }
+  }
+  return 1;
+}
+
+// Splits the contraction's reduction index in place and returns the combine
+// kernel to insert after it, or nullptr when the block doesn't qualify.
+std::shared_ptr<Block> SplitContraction(Block* parent,                           //
+                                        StatementIt stmt_it,                     //
+                                        Block* inner,                            //
+                                        const proto::SplitReductionPass& options) {
+  const Refinement* out = FindAddOutput(inner);
+  if (!out) {
+    return nullptr;
+  }
+  const Index* red_idx = FindReductionIndex(inner, *out, options.min_size());
+  if (!red_idx) {
+    return nullptr;
+  }
+  uint64_t parts = PickParts(red_idx->range, options.num_parts());
+  if (parts < 2) {
+    return nullptr;
+  }
+  auto out_parent_it = parent->ref_by_into(out->from, false);
+  if (out_parent_it == parent->refs.end()) {
+    return nullptr;
+  }
+  uint64_t part_range = red_idx->range / parts;
+  IVLOG(2, "SplitReduction: " << inner->name << " idx " << red_idx->name  //
+                              << " range " << red_idx->range << " -> " << parts << " parts");
+
+  // Factor the reduction index: its range shrinks to one part, and a new
+  // parallel index selects the part.  Every access and constraint that used
+  // the index picks up the part term.
+  std::string part_idx = inner->unique_idx_name(red_idx->name + "_part");
+  std::string red_name = red_idx->name;
+  for (auto& idx : inner->idxs) {
+    if (idx.name == red_name) {
+      idx.range = part_range;
+    }
+  }
+  inner->idxs.emplace_back(part_idx, parts);
+  for (auto& ref : inner->refs) {
+    for (auto& aff : ref.mut().access) {
+      int64_t coeff = aff.get(red_name);
+      if (coeff) {
+        aff.mutateMap()[part_idx] = coeff * static_cast<int64_t>(part_range);
+      }
+    }
+  }
+  for (auto& cons : inner->constraints) {
+    int64_t coeff = cons.get(red_name);
+    if (coeff) {
+      cons.mutateMap()[part_idx] = coeff * static_cast<int64_t>(part_range);
+    }
+  }
+
+  // Each part accumulates into its own slice of a partials buffer, laid out
+  // as the output shape with the part number prepended.
+  const auto& base_shape = out_parent_it->interior_shape;
+  std::vector<size_t> part_sizes{parts};
+  for (const auto& dim : base_shape.dims) {
+    part_sizes.push_back(dim.size);
+  }
+  TensorShape part_shape = SimpleShape(base_shape.type, part_sizes);
+  std::string part_name = parent->unique_ref_name(out_parent_it->into() + "_part");
+  std::vector<Affine> part_parent_access(part_sizes.size());
+  Refinement part_ref(RefDir::None, "", part_name, part_parent_access, part_shape, "",
+                      out_parent_it->location, out_parent_it->offset, out_parent_it->bank_dim,
+                      out_parent_it->cache_unit);
+  part_ref.set_tag("tmp");
+  parent->refs.insert(part_ref);
+
+  // Retarget the contraction's output at the partials buffer.
+  TensorShape part_inner_shape = part_shape;
+  part_inner_shape.dims[0].size = 1;
+  for (size_t i = 0; i < out->interior_shape.dims.size(); i++) {
+    part_inner_shape.dims[i + 1].size = out->interior_shape.dims[i].size;
+  }
+  std::vector<Affine> part_access{Affine(part_idx)};
+  for (const auto& aff : out->access) {
+    part_access.push_back(aff);
+  }
+  Refinement new_out(RefDir::Out, part_name, out->into(), part_access, part_inner_shape, out->agg_op,  //
+                     out->location, out->offset, out->bank_dim, out->cache_unit);
+  inner->refs.erase(*out);
+  inner->refs.insert(new_out);
+
+  // The partials accumulate with add, so they start from zero.
+  auto zero = std::make_shared<Special>();
+  zero->name = "zero";
+  zero->outputs = {part_name};
+  parent->stmts.insert(stmt_it, zero);
+
+  // The combine kernel reduces the part dimension into the original output.
+  auto combine = std::make_shared<Block>();
+  combine->name = inner->name + "_combine";
+  combine->set_tag("kernel");
+  combine->set_tag("contraction");
+  combine->idxs.emplace_back(part_idx, parts);
+  std::vector<Affine> in_access{Affine(part_idx)};
+  std::vector<Affine> out_access;
+  for (size_t i = 0; i < base_shape.dims.size(); i++) {
+    std::string idx_name = "i" + std::to_string(i);
+    combine->idxs.emplace_back(idx_name, base_shape.dims[i].size);
+    in_access.emplace_back(idx_name);
+    out_access.emplace_back(idx_name);
+  }
+  TensorShape in_shape = part_shape;
+  for (auto& dim : in_shape.dims) {
+    dim.size = 1;
+  }
+  TensorShape out_shape = base_shape;
+  for (auto& dim : out_shape.dims) {
+    dim.size = 1;
+  }
+  Refinement in_ref(RefDir::In, part_name, part_name, in_access, in_shape, "",  //
+                    out_parent_it->location, out_parent_it->offset, out_parent_it->bank_dim,
+                    out_parent_it->cache_unit);
+  combine->refs.insert(in_ref);
+  Refinement comb_out(RefDir::Out, out_parent_it->into(), out_parent_it->into(), out_access, out_shape,
+                      Intrinsic::SUM, out_parent_it->location, out_parent_it->offset, out_parent_it->bank_dim,
+                      out_parent_it->cache_unit);
+  combine->refs.insert(comb_out);
+  combine->stmts.push_back(std::make_shared<Load>(part_name, "$part"));
+  combine->stmts.push_back(std::make_shared<Store>("$part", out_parent_it->into()));
+  return combine;
+}
+
+void SplitReductions(Block* parent, const proto::SplitReductionPass& options) {
+  for (auto it = parent->stmts.begin(); it != parent->stmts.end(); ++it) {
+    auto inner = Block::Downcast(*it);
+    if (!inner || !inner->has_tag("contraction")) {
+      continue;
+    }
+    auto combine = SplitContraction(parent, it, inner.get(), options);
+    if (combine) {
+      // Resume after the combine kernel.
+      it = parent->stmts.insert(std::next(it), combine);
+    }
+  }
+}
+
+}  // namespace
+
+void SplitReductionPass::Apply(CompilerState* state) const {
+  auto reqs = stripe::FromProto(options_.reqs());
+  RunOnBlocks(state->entry(), reqs, [&](const AliasMap& map, Block* block) {  //
+    SplitReductions(block, options_);
+  });
+}
+
+namespace {
+[[gnu::unused]] char reg = []() -> char {
+  CompilePassFactory<SplitReductionPass, proto::SplitReductionPass>::Register();
+  return 0;
+}();
+}  // namespace
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
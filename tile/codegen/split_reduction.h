@@ -0,0 +1,23 @@
+// Copyright 2018, Intel Corporation
+
+#pragma once
+
+#include "tile/codegen/codegen.pb.h"
+#include "tile/codegen/compile_pass.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+class SplitReductionPass final : public CompilePass {
+ public:
+  explicit SplitReductionPass(const proto::SplitReductionPass& options) : options_{options} {}
+  void Apply(CompilerState* state) const final;
+
+ private:
+  proto::SplitReductionPass options_;
+};
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,68 @@
+// Copyright 2019, Intel Corporation
+
+#include "tile/codegen/tag_index.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+// Collects the plain (valueless) tags on a block; valued attributes are
+// not tags for has_tag purposes and don't enter the index.
+class TagCollector final : public TagVisitor {
+ public:
+  std::vector<std::string> tags;
+
+  void Visit(const std::string& name) final { tags.push_back(name); }
+  void Visit(const std::string& name, bool value) final {}
+  void Visit(const std::string& name, int64_t value) final {}
+  void Visit(const std::string& name, double value) final {}
+  void Visit(const std::string& name, const std::string& value) final {}
+  void Visit(const std::string& name, const google::protobuf::Any& value) final {}
+};
+
+}  // namespace
+
+const std::vector<TagIndex::Node>& TagIndex::Find(Block* entry, const std::string& tag) {
+  std::lock_guard<std::mutex> lock{mu_};
+  if (!valid_) {
+    by_tag_.clear();
+    std::vector<Block*> path;
+    BuildLocked(entry, &path);
+    valid_ = true;
+  }
+  auto it = by_tag_.find(tag);
+  if (it == by_tag_.end()) {
+    return empty_;
+  }
+  return it->second;
+}
+
+void TagIndex::Clear() {
+  std::lock_guard<std::mutex> lock{mu_};
+  valid_ = false;
+  by_tag_.clear();
+}
+
+void TagIndex::BuildLocked(Block* block, std::vector<Block*>* path) {
+  path->push_back(block);
+  TagCollector collector;
+  block->visit_tags(&collector);
+  for (const auto& tag : collector.tags) {
+    by_tag_[tag].push_back(Node{block, *path});
+  }
+  for (auto& stmt : block->stmts) {
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      BuildLocked(inner.get(), path);
+    }
+  }
+  path->pop_back();
+}
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
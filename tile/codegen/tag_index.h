@@ -0,0 +1,99 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "tile/codegen/alias.h"
+#include "tile/codegen/compile_pass.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+
+// An index from tag to the blocks carrying it, built lazily with one tree
+// walk and answering every later query in O(matches).  Like the AliasMaps
+// memoized on CompilerState, the index describes the tree as it stood when
+// built: the driver drops it after any pass that doesn't declare
+// preserves_aliasing(), and a preserving pass that adds or removes tags
+// must Clear() it itself.
+class TagIndex {
+ public:
+  struct Node {
+    stripe::Block* block;
+    // The chain of blocks from the program entry down to (and including)
+    // block, for rebuilding scoped analysis such as AliasMaps.
+    std::vector<stripe::Block*> path;
+  };
+
+  // Returns the blocks tagged `tag` in pre-order, building the index from
+  // `entry` on first use.
+  const std::vector<Node>& Find(stripe::Block* entry, const std::string& tag);
+
+  // Drops the index; the next Find() rebuilds it.
+  void Clear();
+
+ private:
+  void BuildLocked(stripe::Block* block, std::vector<stripe::Block*>* path);
+
+  std::mutex mu_;
+  bool valid_ = false;
+  std::unordered_map<std::string, std::vector<Node>> by_tag_;
+  const std::vector<Node> empty_;
+};
+
+// Like the cached RunOnBlocks, but jumps straight to the tagged blocks
+// through state->tag_index instead of scanning the whole tree, keeping the
+// visit set and AliasMaps identical to the scan form.  The same contract as
+// that form applies: the pass must preserve aliasing or invalidate the
+// scopes it changes.
+template <typename F>
+void RunOnTaggedBlocks(CompilerState* state, const stripe::Tags& reqs, const F& func, bool rec_func = false) {
+  if (reqs.empty() || reqs.count("all")) {
+    RunOnBlocks(state, reqs, func, rec_func);
+    return;
+  }
+  // Drive from the rarest required tag; every hit re-checks the full
+  // requirement set, so the others only filter further.
+  auto* index = state->tag_index.get();
+  const std::vector<TagIndex::Node>* nodes = nullptr;
+  for (const auto& tag : reqs) {
+    const auto& found = index->Find(state->entry(), tag);
+    if (!nodes || found.size() < nodes->size()) {
+      nodes = &found;
+    }
+  }
+  auto* cache = state->alias_cache.get();
+  for (const auto& node : *nodes) {
+    if (!node.block->has_tags(reqs)) {
+      continue;
+    }
+    if (!rec_func) {
+      // The scan form stops descending at a match; skip blocks nested
+      // beneath another match so the visit set stays the same.
+      bool nested = false;
+      for (size_t i = 0; i + 1 < node.path.size(); i++) {
+        if (node.path[i]->has_tags(reqs)) {
+          nested = true;
+          break;
+        }
+      }
+      if (nested) {
+        continue;
+      }
+    }
+    auto entry = cache->Root();
+    for (auto* block : node.path) {
+      entry = cache->Lookup(entry, block);
+    }
+    func(entry->map, node.block);
+  }
+}
+
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -15,6 +15,9 @@ using namespace math;    // NOLINT
 // Mark #temp_var for the multiple used variables to explicitly delcare it
 // It avoids duplicated/redundant loads for the save variable
 void TempVar(const AliasMap& alias_map, Block* block, const proto::TempVarPass& options) {
+  // Tagging mutates the statements; privatize any that are shared with
+  // another block (e.g. unroll siblings) so each gets its own mark.
+  MaterializeStmts(block, 0);
   std::map<std::string, Statement*> var_def_stmt;
   std::map<Statement*, size_t> stmt_uses;
   for (const auto& stmt : block->stmts) {
@@ -70,7 +73,7 @@ void TempVar(const AliasMap& alias_map, Block* block, const proto::TempVarPass&
 
 void TempVarPass::Apply(CompilerState* state) const {
   auto reqs = stripe::FromProto(options_.reqs());
-  RunOnBlocks(state->entry(), reqs,
+  RunOnBlocks(state, reqs,
               [this](const AliasMap& alias_map, stripe::Block* block) {  //
                 TempVar(alias_map, block, options_);
               },
@@ -16,6 +16,7 @@ void TempVar(const AliasMap& alias_map, stripe::Block* block, const proto::TempV
 class TempVarPass final : public CompilePass {
  public:
   explicit TempVarPass(const proto::TempVarPass& options) : options_{options} {}
+  bool preserves_aliasing() const final { return true; }
   void Apply(CompilerState* state) const final;
 
  private:
@@ -0,0 +1,97 @@
+// Copyright 2019, Intel Corp.
+
+#include <gmock/gmock.h>
+
+#include "tile/codegen/prune_reshapes.h"
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace codegen {
+namespace test {
+
+using namespace stripe;  // NOLINT
+
+namespace {
+
+TensorShape FlatShape(size_t size) {
+  return TensorShape(DataType::FLOAT32, {TensorDimension{1, size}});
+}
+
+Refinement MakeRef(RefDir dir, const std::string& name, size_t size) {
+  return Refinement{dir, name, name, {Affine{}}, FlatShape(size)};
+}
+
+std::shared_ptr<Special> MakeReshape(const std::string& in, const std::string& out) {
+  auto reshape = std::make_shared<Special>();
+  reshape->name = "reshape";
+  reshape->inputs = {in};
+  reshape->outputs = {out};
+  return reshape;
+}
+
+// A main block holding: reshape A -> B, then a kernel reading B into C.
+std::shared_ptr<Block> MakeMain() {
+  auto main = std::make_shared<Block>();
+  main->name = "main";
+  main->set_tag("main");
+  main->refs.emplace(MakeRef(RefDir::In, "A", 16));
+  auto tmp = MakeRef(RefDir::None, "B", 16);
+  tmp.set_tag("tmp");
+  main->refs.emplace(std::move(tmp));
+  main->refs.emplace(MakeRef(RefDir::Out, "C", 16));
+  main->stmts.push_back(MakeReshape("A", "B"));
+  auto kernel = std::make_shared<Block>();
+  kernel->name = "kernel";
+  kernel->set_tag("kernel");
+  kernel->refs.emplace(MakeRef(RefDir::In, "B", 16));
+  kernel->refs.emplace(MakeRef(RefDir::Out, "C", 16));
+  main->stmts.push_back(kernel);
+  return main;
+}
+
+}  // namespace
+
+TEST(Codegen, PruneReshapesElidesTmp) {
+  auto main = MakeMain();
+  PruneReshapes(main.get());
+  // The reshape special and the temporary are gone; the kernel reads the
+  // reshape's source directly.
+  ASSERT_THAT(main->stmts.size(), testing::Eq(1));
+  auto kernel = Block::Downcast(main->stmts.front());
+  ASSERT_TRUE(kernel);
+  EXPECT_THAT(kernel->ref_by_into("B")->from, testing::Eq("A"));
+  EXPECT_THAT(main->ref_by_into("B", false), testing::Eq(main->refs.end()));
+}
+
+TEST(Codegen, PruneReshapesKeepsProgramOutputs) {
+  auto main = MakeMain();
+  // Add a reshape whose output is a program output; it must keep its copy.
+  main->stmts.push_back(MakeReshape("A", "C"));
+  PruneReshapes(main.get());
+  ASSERT_THAT(main->stmts.size(), testing::Eq(2));
+  auto reshape = Special::Downcast(main->stmts.back());
+  ASSERT_TRUE(reshape);
+  EXPECT_THAT(reshape->outputs[0], testing::Eq("C"));
+}
+
+TEST(Codegen, PruneReshapesCollapsesChains) {
+  auto main = MakeMain();
+  // Chain a second temporary off the first; both collapse onto A.
+  auto tmp = MakeRef(RefDir::None, "D", 16);
+  tmp.set_tag("tmp");
+  main->refs.emplace(std::move(tmp));
+  auto kernel = Block::Downcast(main->stmts.back());
+  main->stmts.pop_back();
+  main->stmts.push_back(MakeReshape("B", "D"));
+  kernel->ref_by_into("B")->mut().from = "D";
+  main->stmts.push_back(kernel);
+  PruneReshapes(main.get());
+  ASSERT_THAT(main->stmts.size(), testing::Eq(1));
+  EXPECT_THAT(Block::Downcast(main->stmts.front())->ref_by_into("B")->from, testing::Eq("A"));
+}
+
+}  // namespace test
+}  // namespace codegen
+}  // namespace tile
+}  // namespace vertexai
@@ -4,6 +4,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -13,6 +14,7 @@
 #include "base/util/logging.h"
 #include "base/util/throw.h"
 #include "tile/codegen/alias.h"
+#include "tile/codegen/tile.h"
 #include "tile/stripe/stripe.h"
 
 namespace vertexai {
@@ -261,43 +263,156 @@ void EvalInner(Block* outer,
   }
 }
 
-void UnrollBlock(Block* outer,                     //
+void ExpandBlock(Block* outer,                     //
                  Block* block,                     //
                  const AliasMap& outer_alias_map,  //
                  const StatementIt& it_stmt,       //
-                 const Tags& reqs,                 //
                  const proto::UnrollPass& options) {
-  if (block->has_tags(reqs)) {
-    RefMap ref_map;
-    std::vector<IndexValue> idxs;
-    idxs.reserve(block->idxs.size());
-    std::map<std::string, Affine> aff_idxs;
-    for (const auto& idx : block->idxs) {
-      if (idx.affine == Affine{}) {
-        idxs.emplace_back(IndexValue{&idx, 0});
+  RefMap ref_map;
+  std::vector<IndexValue> idxs;
+  idxs.reserve(block->idxs.size());
+  std::map<std::string, Affine> aff_idxs;
+  for (const auto& idx : block->idxs) {
+    if (idx.affine == Affine{}) {
+      idxs.emplace_back(IndexValue{&idx, 0});
+    } else {
+      aff_idxs[idx.name] = idx.affine;
+    }
+  }
+  std::map<std::string, std::vector<std::vector<Extent>>> ref_write_extents;
+  std::list<StatementList> cloned_statements;
+  // Unrolling clones the block once per index value; carve the clones out
+  // of a shared arena rather than paying a malloc per statement, and share
+  // the leaf statements across the clones -- EvalInner only rewrites
+  // blocks (names, indexes, refinements), never loads/stores/intrinsics,
+  // so only the block skeletons need to be private.  Downstream passes
+  // that mutate leaf statements in place privatize them first via
+  // MaterializeStmts.
+  auto arena = std::make_shared<Arena>();
+  EnumerateIndexes(idxs, 0, [&](const std::vector<IndexValue>& idxs) {
+    auto clone = CloneBlock(*block, -1, arena, /* share_leaves = */ true);
+    EvalInner(outer, clone.get(), &ref_map, idxs, outer_alias_map, &ref_write_extents, aff_idxs, options);
+    cloned_statements.emplace_back(std::move(clone->stmts));
+  });
+  while (cloned_statements.size()) {
+    for (auto cs_it = cloned_statements.begin(); cs_it != cloned_statements.end();) {
+      if (cs_it->size()) {
+        outer->stmts.emplace(it_stmt, std::move(cs_it->front()));
+        cs_it->pop_front();
+        ++cs_it;
       } else {
-        aff_idxs[idx.name] = idx.affine;
+        cs_it = cloned_statements.erase(cs_it);
       }
     }
-    std::map<std::string, std::vector<std::vector<Extent>>> ref_write_extents;
-    std::list<StatementList> cloned_statements;
-    EnumerateIndexes(idxs, 0, [&](const std::vector<IndexValue>& idxs) {
-      auto clone = CloneBlock(*block);
-      EvalInner(outer, clone.get(), &ref_map, idxs, outer_alias_map, &ref_write_extents, aff_idxs, options);
-      cloned_statements.emplace_back(std::move(clone->stmts));
-    });
-    while (cloned_statements.size()) {
-      for (auto cs_it = cloned_statements.begin(); cs_it != cloned_statements.end();) {
-        if (cs_it->size()) {
-          outer->stmts.emplace(it_stmt, std::move(cs_it->front()));
-          cs_it->pop_front();
-          ++cs_it;
-        } else {
-          cs_it = cloned_statements.erase(cs_it);
-        }
+  }
+  outer->erase_stmt(it_stmt);
+}
+
+// Rewrites every use of an index within the block -- refinement accesses,
+// constraints, interior block affines, and load_index sources.
+void SubstituteIndex(Block* block, const std::string& idx_name, const Affine& replacement) {
+  for (auto& ref : block->refs) {
+    for (auto& aff : ref.mut().access) {
+      aff.substitute(idx_name, replacement);
+    }
+  }
+  for (auto& constraint : block->constraints) {
+    constraint.substitute(idx_name, replacement);
+  }
+  for (const auto& stmt : block->stmts) {
+    if (stmt->kind() == StmtKind::LoadIndex) {
+      LoadIndex::Downcast(stmt)->from.substitute(idx_name, replacement);
+    }
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      for (auto& idx : inner->idxs) {
+        idx.affine.substitute(idx_name, replacement);
+      }
+    }
+  }
+}
+
+// Partially unrolls one index of the block by options.factor(): the index is
+// split into factor-sized chunks via ApplyTile and the chunk is expanded in
+// place, leaving a loop over the chunks.  A range the factor doesn't divide
+// gets a separately unrolled residue block for the tail iterations, so the
+// main loop stays free of bounds guards.  Returns false when no index is
+// larger than the factor; the caller then falls back to full expansion.
+bool PartialUnroll(Block* outer,                     //
+                   Block* block,                     //
+                   const AliasMap& outer_alias_map,  //
+                   const StatementIt& it_stmt,       //
+                   const proto::UnrollPass& options) {
+  size_t factor = options.factor();
+  const Index* target = nullptr;
+  for (const auto& idx : block->idxs) {
+    if (idx.affine != Affine{}) {
+      continue;
+    }
+    if (options.factor_idx().size()) {
+      if (idx.name == options.factor_idx()) {
+        target = &idx;
       }
+    } else if (idx.range > factor) {
+      target = &idx;
+    }
+  }
+  if (!target || target->range <= factor) {
+    return false;
+  }
+  std::string idx_name = target->name;
+  size_t range = target->range;
+  size_t chunks = range / factor;
+  size_t residue = range % factor;
+  IVLOG(2, "PartialUnroll> " << block->name << " idx: " << idx_name << " range: " << range << " factor: " << factor
+                             << " residue: " << residue);
+
+  // Splits off a factor-sized inner block and expands it in place, leaving
+  // the part as a loop over the unrolled chunk.
+  auto expand_part = [&](const std::shared_ptr<Block>& part, size_t chunk) {
+    TileShape shape;
+    for (const auto& idx : part->idxs) {
+      shape.push_back(idx.name == idx_name ? chunk : 1);
+    }
+    ApplyTile(part.get(), shape, false);
+    auto it_inner = part->stmts.begin();
+    auto inner = Block::Downcast(*it_inner);
+    AliasMap part_map{outer_alias_map, part.get()};
+    ExpandBlock(part.get(), inner.get(), part_map, it_inner, options);
+  };
+
+  auto main = CloneBlock(*block);
+  auto main_idx = main->idx_by_name(idx_name);
+  main_idx->range = chunks * factor;
+  expand_part(main, factor);
+  outer->stmts.emplace(it_stmt, main);
+
+  if (residue) {
+    auto tail = CloneBlock(*block);
+    tail->name += "_residue";
+    auto tail_idx = tail->idx_by_name(idx_name);
+    tail_idx->range = residue;
+    // The tail covers the last range % factor iterations; offset every use
+    // of the index past the main part's coverage.
+    SubstituteIndex(tail.get(), idx_name, Affine(idx_name) + int64_t(chunks * factor));
+    expand_part(tail, residue);
+    outer->stmts.emplace(it_stmt, tail);
+  }
+  outer->erase_stmt(it_stmt);
+  return true;
+}
+
+void UnrollBlock(Block* outer,                     //
+                 Block* block,                     //
+                 const AliasMap& outer_alias_map,  //
+                 const StatementIt& it_stmt,       //
+                 const Tags& reqs,                 //
+                 const proto::UnrollPass& options) {
+  if (block->has_tags(reqs)) {
+    if (options.factor() > 1 && PartialUnroll(outer, block, outer_alias_map, it_stmt, options)) {
+      return;
     }
-    outer->erase_stmt(it_stmt);
+    ExpandBlock(outer, block, outer_alias_map, it_stmt, options);
   } else {
     AliasMap alias_map{outer_alias_map, block};
     PreIterate(block, [&](const StatementIt& it) {
@@ -3,9 +3,15 @@
 #include "tile/codegen/vm.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <utility>
 
 #include <boost/format.hpp>
 
+#include "base/util/env.h"
+
 #include "base/util/lookup.h"
 #include "base/util/stream_container.h"
 #include "base/util/throw.h"
@@ -19,10 +25,25 @@ using namespace stripe;  // NOLINT
 
 namespace {
 
+std::map<std::string, std::function<float(float)>> UNARY_OPS = {
+    {"neg", [](float a) { return -a; }},
+    {"sqrt", [](float a) { return std::sqrt(a); }},
+    {"exp", [](float a) { return std::exp(a); }},
+    {"log", [](float a) { return std::log(a); }},
+    {"tanh", [](float a) { return std::tanh(a); }},
+    {"ident", [](float a) { return a; }},
+};
+
 std::map<std::string, std::function<float(float, float)>> BINARY_OPS = {
     {"add", [](float a, float b) { return a + b; }},
+    {"sub", [](float a, float b) { return a - b; }},
     {"mul", [](float a, float b) { return a * b; }},
+    {"div", [](float a, float b) { return a / b; }},
+    {"max", [](float a, float b) { return std::max(a, b); }},
+    {"min", [](float a, float b) { return std::min(a, b); }},
     {"cmp_lt", [](float a, float b) { return a < b; }},
+    {"cmp_gt", [](float a, float b) { return a > b; }},
+    {"cmp_eq", [](float a, float b) { return a == b; }},
 };
 
 std::map<std::string, std::function<float(float, float, float)>> TERNARY_OPS = {
@@ -174,21 +195,21 @@ class Scope {
         } break;
         case StmtKind::Intrinsic: {
           const auto& op = Intrinsic::Downcast(stmt);
+          // The eltwise dispatch is resolved once per Intrinsic and cached by
+          // statement identity, so the inner loop pays a pointer lookup
+          // instead of a string lookup every iteration.
           switch (op->inputs.size()) {
+            case 1: {
+              auto fn = LookupOp(UNARY_OPS, &unary_cache_, op.get(), "unary");
+              vars[op->outputs[0]] = (*fn)(vars[op->inputs[0]]);
+            } break;
             case 2: {
-              auto it = BINARY_OPS.find(op->name);
-              if (it == BINARY_OPS.end()) {
-                throw_with_trace(std::runtime_error(str(boost::format("Unsupported binary intrinsic: %s") % op->name)));
-              }
-              vars[op->outputs[0]] = it->second(vars[op->inputs[0]], vars[op->inputs[1]]);
+              auto fn = LookupOp(BINARY_OPS, &binary_cache_, op.get(), "binary");
+              vars[op->outputs[0]] = (*fn)(vars[op->inputs[0]], vars[op->inputs[1]]);
             } break;
             case 3: {
-              auto it = TERNARY_OPS.find(op->name);
-              if (it == TERNARY_OPS.end()) {
-                throw_with_trace(
-                    std::runtime_error(str(boost::format("Unsupported ternary intrinsic: %s") % op->name)));
-              }
-              vars[op->outputs[0]] = it->second(vars[op->inputs[0]], vars[op->inputs[1]], vars[op->inputs[2]]);
+              auto fn = LookupOp(TERNARY_OPS, &ternary_cache_, op.get(), "ternary");
+              vars[op->outputs[0]] = (*fn)(vars[op->inputs[0]], vars[op->inputs[1]], vars[op->inputs[2]]);
             } break;
             default:
               throw_with_trace(std::runtime_error(
@@ -219,12 +240,30 @@ class Scope {
 
   std::string Tab() const { return std::string(depth_ * 2, ' '); }
 
+  template <typename Fn>
+  const Fn* LookupOp(const std::map<std::string, Fn>& ops, std::map<const Intrinsic*, const Fn*>* cache,
+                     const Intrinsic* op, const char* arity) {
+    auto cached = cache->find(op);
+    if (cached != cache->end()) {
+      return cached->second;
+    }
+    auto it = ops.find(op->name);
+    if (it == ops.end()) {
+      throw_with_trace(std::runtime_error(str(boost::format("Unsupported %s intrinsic: %s") % arity % op->name)));
+    }
+    cache->emplace(op, &it->second);
+    return &it->second;
+  }
+
  private:
   Scope* outer_ = nullptr;
   size_t depth_ = 0;
   std::map<std::string, int64_t> idxs_;
   std::map<std::string, Buffer*> refs_;
   std::map<std::string, size_t> offsets_;
+  std::map<const Intrinsic*, const std::function<float(float)>*> unary_cache_;
+  std::map<const Intrinsic*, const std::function<float(float, float)>*> binary_cache_;
+  std::map<const Intrinsic*, const std::function<float(float, float, float)>*> ternary_cache_;
 };
 
 }  // namespace
@@ -234,6 +273,36 @@ void ExecuteProgram(const Block& program, std::map<std::string, Buffer>* buffers
   scope.ExecuteProgram(program, buffers);
 }
 
+TieredExecutor::TieredExecutor(const std::shared_ptr<Block>& program, size_t threshold)
+    : program_{program}, threshold_{threshold} {
+  auto env_threshold = env::Get("PLAIDML_VM_JIT_THRESHOLD");
+  if (env_threshold.size()) {
+    threshold_ = std::max(0, std::atoi(env_threshold.c_str()));
+  }
+}
+
+void TieredExecutor::Run(std::map<std::string, Buffer>* buffers) {
+  if (!native_ && runs_ >= threshold_) {
+    // This program is hot enough for compilation to pay for itself; compile
+    // once and serve every later run natively.
+    targets::cpu::Config config;
+    native_ = std::make_unique<targets::cpu::Native>();
+    native_->compile(*program_, config);
+  }
+  if (native_) {
+    // The JIT binds raw data pointers under the same names the interpreter
+    // uses; temporaries are the invoker's own business.
+    std::map<std::string, void*> raw;
+    for (auto& kvp : *buffers) {
+      raw[kvp.first] = kvp.second.data();
+    }
+    native_->run(raw);
+  } else {
+    ExecuteProgram(*program_, buffers);
+  }
+  runs_++;
+}
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
@@ -3,10 +3,12 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "tile/stripe/stripe.h"
+#include "tile/targets/cpu/jit.h"
 
 namespace vertexai {
 namespace tile {
@@ -16,6 +18,35 @@ using Buffer = std::vector<float>;
 
 void ExecuteProgram(const stripe::Block& program, std::map<std::string, Buffer>* buffers);
 
+// A tiered execution engine over one Stripe program.  The first few runs go
+// through the interpreter, so a one-shot evaluation (constant folding, a tiny
+// kernel, an interactive edsl experiment) gets its result in milliseconds
+// without paying for LLVM compilation; once the program has run often enough
+// for compilation to pay for itself it is promoted to the jit.cc native path
+// and stays there.  Buffers use the same name -> Buffer binding convention as
+// ExecuteProgram (one float per element), for both tiers.
+class TieredExecutor {
+ public:
+  // Promote after this many interpreted runs; PLAIDML_VM_JIT_THRESHOLD
+  // overrides it.
+  static constexpr size_t kDefaultThreshold = 3;
+
+  explicit TieredExecutor(const std::shared_ptr<stripe::Block>& program, size_t threshold = kDefaultThreshold);
+
+  // Executes the program against `buffers`, interpreting or running native
+  // code depending on how many times it has run.
+  void Run(std::map<std::string, Buffer>* buffers);
+
+  // True once runs are being served by the JIT.
+  bool jitted() const { return native_ != nullptr; }
+
+ private:
+  std::shared_ptr<stripe::Block> program_;
+  size_t threshold_;
+  size_t runs_ = 0;
+  std::unique_ptr<targets::cpu::Native> native_;
+};
+
 }  // namespace codegen
 }  // namespace tile
 }  // namespace vertexai
@@ -2,6 +2,7 @@
 
 #include "tile/hal/cm/compute_kernel.h"
 
+#include <sstream>
 #include <utility>
 
 #include "base/util/env.h"
@@ -11,6 +12,7 @@
 #include "tile/hal/cm/emitcm.h"
 #include "tile/hal/cm/err.h"
 #include "tile/hal/cm/event.h"
+#include "tile/hal/cm/group_tuner.h"
 #include "tile/hal/cm/mem_buffer.h"
 #include "tile/hal/cm/result.h"
 #include "tile/hal/cm/runtime.h"
@@ -96,8 +98,16 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
     }
   }
 
-  cm_result_check(pCmDev->CreateThreadGroupSpaceEx(g[0], g[1], g[2], nthreads[0] / g[0], nthreads[1] / g[1],
-                                                   nthreads[2] / g[2], pts_));
+  // Let the tuner refine the static heuristic: it sweeps alternative group
+  // geometries over the kernel's first runs and then sticks with the
+  // fastest, keyed so distinct thread spaces tune independently.
+  std::ostringstream tune_key;
+  tune_key << ki_.key << "/" << nthreads[0] << "x" << nthreads[1] << "x" << nthreads[2];
+  GroupTuner::Group group = GroupTuner::Instance()->Choose(
+      tune_key.str(), GroupTuner::Group{{nthreads[0], nthreads[1], nthreads[2]}}, GroupTuner::Group{{g[0], g[1], g[2]}});
+
+  cm_result_check(pCmDev->CreateThreadGroupSpaceEx(group[0], group[1], group[2], nthreads[0] / group[0],
+                                                   nthreads[1] / group[1], nthreads[2] / group[2], pts_));
 
   CmEvent* done = NULL;
   cm_result_check(pCmQueue->EnqueueWithGroup(pKernelArray_, done, pts_));
@@ -106,6 +116,11 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
   for (done->GetStatus(s); s != CM_STATUS_FINISHED; done->GetStatus(s)) {
   }
 
+  UINT64 execution_time = 0;
+  if (done->GetExecutionTime(execution_time) == CM_SUCCESS) {
+    GroupTuner::Instance()->Report(tune_key.str(), group, static_cast<int64_t>(execution_time));
+  }
+
   for (std::size_t i = 0; i < params.size(); ++i) {
     Buffer* buf = Buffer::Downcast(params[i].get());
     buf->ReleaseDeviceBuffer();
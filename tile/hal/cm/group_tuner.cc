@@ -0,0 +1,160 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/hal/cm/group_tuner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace cm {
+
+namespace {
+
+// The GEN command streamer dispatches at most this many threads per group;
+// it is also the cap the static heuristic used, so sweeps stay comparable.
+constexpr unsigned int kMaxGroupThreads = 64;
+
+// Bounds the sweep so a kernel settles within a reasonable number of runs.
+constexpr std::size_t kMaxCandidates = 24;
+
+std::vector<unsigned int> Divisors(unsigned int n) {
+  std::vector<unsigned int> divs;
+  for (unsigned int d = 1; d <= n; d++) {
+    if (n % d == 0) {
+      divs.push_back(d);
+    }
+  }
+  return divs;
+}
+
+}  // namespace
+
+GroupTuner* GroupTuner::Instance() {
+  static GroupTuner tuner(env::Get("PLAIDML_CM_GROUP_CACHE"));
+  return &tuner;
+}
+
+GroupTuner::GroupTuner(const std::string& filename) : filename_(filename) {
+  if (!filename_.empty()) {
+    Load();
+  }
+}
+
+GroupTuner::State& GroupTuner::GetState(const std::string& key, const Group& nthreads, const Group& dflt) {
+  auto it = states_.find(key);
+  if (it != states_.end()) {
+    return it->second;
+  }
+  State& state = states_[key];
+  // The group dims must divide the thread space exactly, so candidates are
+  // divisor triples; larger groups first, since occupancy losses come from
+  // dispatching too few threads per group.
+  state.candidates.push_back(dflt);
+  std::vector<Group> triples;
+  for (unsigned int g0 : Divisors(nthreads[0])) {
+    for (unsigned int g1 : Divisors(nthreads[1])) {
+      if (g0 * g1 > kMaxGroupThreads) {
+        break;
+      }
+      for (unsigned int g2 : Divisors(nthreads[2])) {
+        if (g0 * g1 * g2 > kMaxGroupThreads) {
+          break;
+        }
+        Group group = {{g0, g1, g2}};
+        if (group != dflt) {
+          triples.push_back(group);
+        }
+      }
+    }
+  }
+  std::stable_sort(triples.begin(), triples.end(), [](const Group& a, const Group& b) {
+    return a[0] * a[1] * a[2] > b[0] * b[1] * b[2];
+  });
+  for (const auto& group : triples) {
+    if (state.candidates.size() >= kMaxCandidates) {
+      break;
+    }
+    state.candidates.push_back(group);
+  }
+  return state;
+}
+
+GroupTuner::Group GroupTuner::Choose(const std::string& key, const Group& nthreads, const Group& dflt) {
+  std::lock_guard<std::mutex> lock{mu_};
+  State& state = GetState(key, nthreads, dflt);
+  if (state.done) {
+    return state.best;
+  }
+  if (state.next >= state.candidates.size()) {
+    // The sweep finished but nothing reported (profiling unavailable);
+    // fall back to the static mapping permanently.
+    state.best = state.best_ns >= 0 ? state.best : dflt;
+    state.done = true;
+    Save();
+    return state.best;
+  }
+  return state.candidates[state.next++];
+}
+
+void GroupTuner::Report(const std::string& key, const Group& group, int64_t duration_ns) {
+  if (duration_ns <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{mu_};
+  auto it = states_.find(key);
+  if (it == states_.end() || it->second.done) {
+    return;
+  }
+  State& state = it->second;
+  if (state.best_ns < 0 || duration_ns < state.best_ns) {
+    state.best_ns = duration_ns;
+    state.best = group;
+  }
+  if (state.next >= state.candidates.size()) {
+    state.done = true;
+    IVLOG(2, "GroupTuner: " << key << " -> " << state.best[0] << "x" << state.best[1] << "x" << state.best[2] << " ("
+                            << state.best_ns << " ns)");
+    Save();
+  }
+}
+
+void GroupTuner::Load() {
+  std::ifstream file(filename_);
+  if (!file) {
+    return;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    State state;
+    if (ss >> key >> state.best[0] >> state.best[1] >> state.best[2] >> state.best_ns) {
+      state.done = true;
+      states_.emplace(key, std::move(state));
+    }
+  }
+}
+
+void GroupTuner::Save() {
+  if (filename_.empty()) {
+    return;
+  }
+  std::ofstream file(filename_, std::ios::trunc);
+  for (const auto& kvp : states_) {
+    if (kvp.second.done && kvp.second.best_ns >= 0) {
+      file << kvp.first << " " << kvp.second.best[0] << " " << kvp.second.best[1] << " " << kvp.second.best[2] << " "
+           << kvp.second.best_ns << "\n";
+    }
+  }
+}
+
+}  // namespace cm
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,65 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace cm {
+
+// Picks the thread-group geometry used to dispatch a kernel.  The static
+// divisor heuristic maps every kernel the same way and underutilizes the
+// EUs on small layers, so the tuner sweeps candidate geometries over a
+// kernel's first runs, timing each dispatch, and settles on the fastest.
+// Results are keyed by the kernel's canonical key and persisted to the
+// file named by PLAIDML_CM_GROUP_CACHE (when set) -- the same
+// measure-once-and-remember approach lang::TileCache takes for tile
+// shapes -- so later processes start already tuned.
+class GroupTuner {
+ public:
+  using Group = std::array<unsigned int, 3>;
+
+  // Gets the singleton instance, loading PLAIDML_CM_GROUP_CACHE if set.
+  static GroupTuner* Instance();
+
+  explicit GroupTuner(const std::string& filename = "");
+
+  // Returns the geometry for this dispatch: the recorded best once the
+  // sweep is complete, or the next untried candidate while it runs.  The
+  // default geometry is always the first candidate, so an interrupted
+  // sweep never performs worse than the static mapping did.
+  Group Choose(const std::string& key, const Group& nthreads, const Group& dflt);
+
+  // Records the measured duration of a dispatch using the geometry that
+  // Choose returned for this key.
+  void Report(const std::string& key, const Group& group, int64_t duration_ns);
+
+ private:
+  struct State {
+    std::vector<Group> candidates;
+    std::size_t next = 0;
+    Group best = {{1, 1, 1}};
+    int64_t best_ns = -1;
+    bool done = false;
+  };
+
+  State& GetState(const std::string& key, const Group& nthreads, const Group& dflt);
+  void Load();
+  void Save();
+
+  std::mutex mu_;
+  std::string filename_;
+  std::map<std::string, State> states_;
+};
+
+}  // namespace cm
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -57,7 +57,7 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
                                                              const hal::proto::HardwareSettings& settings) {
   if (!kernels.size()) {
     return boost::make_ready_future(
-        std::unique_ptr<hal::Library>{std::make_unique<Library>(std::vector<std::shared_ptr<Kernel>>{})});
+        std::unique_ptr<hal::Library>{std::make_unique<Library>(device_, std::vector<std::shared_ptr<Kernel>>{})});
   }
 
   auto src = EmitCudaC(kernels);
@@ -121,7 +121,7 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
       result.emplace_back(std::make_shared<CodeKernel>(device_, ki, function));
     }
   }
-  std::unique_ptr<hal::Library> lib(new Library(std::move(result)));
+  std::unique_ptr<hal::Library> lib(new Library(device_, std::move(result)));
   return boost::make_ready_future(std::move(lib));
 }
 
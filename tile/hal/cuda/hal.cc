@@ -2,8 +2,11 @@
 
 #include "tile/hal/cuda/hal.h"
 
+#include <cstring>
+
 #include <boost/format.hpp>
 
+#include "base/util/env.h"
 #include "base/util/error.h"
 #include "base/util/factory.h"
 #include "tile/hal/cuda/error.h"
@@ -221,13 +224,138 @@ boost::future<std::vector<std::shared_ptr<hal::Result>>> Executor::WaitFor(
 
 void Executor::Flush() {}
 
-Executable::Executable(std::vector<std::shared_ptr<Kernel>> kernels) : kernels_{std::move(kernels)} {}
+Executable::Executable(Device* device, std::vector<std::shared_ptr<Kernel>> kernels)
+    : device_{device},                                             //
+      kernels_{std::move(kernels)},                                //
+      graphs_enabled_{env::Get("PLAIDML_CUDA_GRAPHS") != "0"},     //
+      graph_{std::make_shared<Graph>(device)}                      //
+{}
 
 std::shared_ptr<hal::Event> Executable::Run(const context::Context& ctx, std::size_t kernel_index,
                                             const std::vector<std::shared_ptr<Buffer>>& params,
                                             const std::vector<std::shared_ptr<Event>>& dependencies,
                                             bool enable_profiling = false) {
-  return kernels_[kernel_index]->Run(ctx, params, dependencies, enable_profiling);
+  auto& kernel = kernels_[kernel_index];
+  // Profiled launches need per-kernel timing, which a single graph launch
+  // can't provide, so they run through the synchronous path.
+  if (!graphs_enabled_ || enable_profiling) {
+    if (run_ && !run_->finished()) {
+      run_->Finish();
+    }
+    return kernel->Run(ctx, params, dependencies, enable_profiling);
+  }
+  // A finished run marks a program run boundary; the next launch opens a new
+  // one against the shared graph.
+  if (!run_ || run_->finished()) {
+    run_ = std::make_shared<GraphRun>(ctx, device_, graph_);
+  }
+  run_->Enqueue(kernel, params);
+  return std::make_shared<Event>(run_);
+}
+
+Graph::~Graph() { Discard(); }
+
+void Graph::Discard() {
+  if (exec || graph) {
+    device->SetCurrentContext();
+  }
+  if (exec) {
+    cuGraphExecDestroy(exec);
+    exec = nullptr;
+  }
+  if (graph) {
+    cuGraphDestroy(graph);
+    graph = nullptr;
+  }
+  nodes.clear();
+}
+
+GraphRun::GraphRun(const context::Context& ctx, Device* device, std::shared_ptr<Graph> graph)
+    : ctx_{ctx},                 //
+      device_{device},           //
+      graph_{std::move(graph)},  //
+      state_{graph_->nodes.empty() ? State::kRecording : State::kReplaying} {
+  if (state_ == State::kRecording && !graph_->graph) {
+    device_->SetCurrentContext();
+    Error err = cuGraphCreate(&graph_->graph, 0);
+    Error::Check(err, "cuGraphCreate() failed");
+  }
+}
+
+void GraphRun::Enqueue(const std::shared_ptr<Kernel>& kernel, const std::vector<std::shared_ptr<hal::Buffer>>& params) {
+  std::lock_guard<std::mutex> lock{mu_};
+  calls_.emplace_back(kernel, params);
+  device_->SetCurrentContext();
+  switch (state_) {
+    case State::kRecording: {
+      graph_->nodes.emplace_back(kernel.get(), std::vector<CUgraphNode>{});
+      tail_ = kernel->AddNodes(graph_->graph, tail_, params, &graph_->nodes.back().second);
+      break;
+    }
+    case State::kReplaying: {
+      if (cursor_ < graph_->nodes.size() && graph_->nodes[cursor_].first == kernel.get()) {
+        kernel->UpdateNodes(graph_->exec, graph_->nodes[cursor_].second, params);
+        cursor_++;
+        break;
+      }
+      // The launch sequence diverged from the recording; nothing replayed so
+      // far has actually executed, so issue the whole run eagerly and record
+      // afresh on the next run.
+      VLOG(1) << "CUDA graph replay diverged at launch " << calls_.size() << "; falling back to eager launches";
+      state_ = State::kEager;
+      graph_->Discard();
+      for (const auto& call : calls_) {
+        call.first->Launch(call.second);
+      }
+      break;
+    }
+    case State::kEager: {
+      kernel->Launch(params);
+      break;
+    }
+  }
+}
+
+std::shared_ptr<hal::Result> GraphRun::Finish() {
+  std::lock_guard<std::mutex> lock{mu_};
+  if (finished_) {
+    return result_;
+  }
+  device_->SetCurrentContext();
+  auto start = std::chrono::high_resolution_clock::now();
+  switch (state_) {
+    case State::kRecording: {
+      Error err = cuGraphInstantiate(&graph_->exec, graph_->graph, nullptr, nullptr, 0);
+      Error::Check(err, "cuGraphInstantiate() failed");
+      err = cuGraphLaunch(graph_->exec, nullptr);
+      Error::Check(err, "cuGraphLaunch() failed");
+      break;
+    }
+    case State::kReplaying: {
+      if (cursor_ == graph_->nodes.size()) {
+        Error err = cuGraphLaunch(graph_->exec, nullptr);
+        Error::Check(err, "cuGraphLaunch() failed");
+      } else {
+        // The run stopped short of the recording; as in the divergence case,
+        // nothing has executed yet, so run it eagerly and re-record later.
+        graph_->Discard();
+        for (const auto& call : calls_) {
+          call.first->Launch(call.second);
+        }
+      }
+      break;
+    }
+    case State::kEager: {
+      // Launches were already issued as they arrived.
+      break;
+    }
+  }
+  Error err = cuCtxSynchronize();
+  Error::Check(err, "cuCtxSynchronize() failed");
+  auto end = std::chrono::high_resolution_clock::now();
+  result_ = std::make_shared<Result>(ctx_, "tile::hal::cuda::Executable::RunGraph", start, end);
+  finished_ = true;
+  return result_;
 }
 
 ComputeKernel::ComputeKernel(Device* device, const lang::KernelInfo& ki, CUfunction function)
@@ -240,6 +368,16 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
                                                const std::vector<std::shared_ptr<hal::Buffer>>& params,  //
                                                const std::vector<std::shared_ptr<hal::Event>>& deps,     //
                                                bool enable_profiling) {
+  auto start = std::chrono::high_resolution_clock::now();
+  Launch(params);
+  Error err = cuCtxSynchronize();
+  Error::Check(err, "cuCtxSynchronize() failed");
+  auto end = std::chrono::high_resolution_clock::now();
+  std::shared_ptr<hal::Result> result = std::make_shared<Result>(ctx, "tile::hal::cuda::Kernel::Run", start, end);
+  return std::make_shared<Event>(std::move(result));
+}
+
+void ComputeKernel::Launch(const std::vector<std::shared_ptr<hal::Buffer>>& params) {
   size_t shared_bytes = 0;
 
   lang::GridSize block{{
@@ -261,7 +399,6 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
 
   device_->SetCurrentContext();
 
-  auto start = std::chrono::high_resolution_clock::now();
   Error err = cuLaunchKernel(function_,     // f
                              grid[0],       // gridDimX
                              grid[1],       // gridDimY
@@ -274,11 +411,59 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
                              args.data(),   // kernelParams
                              nullptr);      // extra
   Error::Check(err, "cuLaunchKernel() failed");
-  err = cuCtxSynchronize();
-  Error::Check(err, "cuCtxSynchronize() failed");
-  auto end = std::chrono::high_resolution_clock::now();
-  std::shared_ptr<hal::Result> result = std::make_shared<Result>(ctx, "tile::hal::cuda::Kernel::Run", start, end);
-  return std::make_shared<Event>(std::move(result));
+}
+
+CUDA_KERNEL_NODE_PARAMS ComputeKernel::NodeParams(const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                                                  std::vector<CUdeviceptr>* dptrs, std::vector<void*>* args) {
+  lang::GridSize block{{
+      ki_.lwork[0] ? ki_.lwork[0] : 1,  //
+      ki_.lwork[1] ? ki_.lwork[1] : 1,  //
+      ki_.lwork[2] ? ki_.lwork[2] : 1   //
+  }};
+
+  // The driver copies argument values out during the AddNodes/UpdateNodes
+  // call, so the caller-provided vectors only need to outlive that call.
+  dptrs->reserve(params.size());
+  args->reserve(params.size());
+  for (const auto& param : params) {
+    dptrs->push_back(DeviceBuffer::Downcast(param)->dptr());
+    args->push_back(&dptrs->back());
+  }
+
+  CUDA_KERNEL_NODE_PARAMS node_params = {};
+  node_params.func = function_;
+  node_params.gridDimX = ki_.gwork[0] / block[0];
+  node_params.gridDimY = ki_.gwork[1] / block[1];
+  node_params.gridDimZ = ki_.gwork[2] / block[2];
+  node_params.blockDimX = block[0];
+  node_params.blockDimY = block[1];
+  node_params.blockDimZ = block[2];
+  node_params.sharedMemBytes = 0;
+  node_params.kernelParams = args->data();
+  node_params.extra = nullptr;
+  return node_params;
+}
+
+CUgraphNode ComputeKernel::AddNodes(CUgraph graph, CUgraphNode tail,
+                                    const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                                    std::vector<CUgraphNode>* nodes) {
+  std::vector<CUdeviceptr> dptrs;
+  std::vector<void*> args;
+  auto node_params = NodeParams(params, &dptrs, &args);
+  CUgraphNode node;
+  Error err = cuGraphAddKernelNode(&node, graph, tail ? &tail : nullptr, tail ? 1 : 0, &node_params);
+  Error::Check(err, "cuGraphAddKernelNode() failed");
+  nodes->push_back(node);
+  return node;
+}
+
+void ComputeKernel::UpdateNodes(CUgraphExec exec, const std::vector<CUgraphNode>& nodes,
+                                const std::vector<std::shared_ptr<hal::Buffer>>& params) {
+  std::vector<CUdeviceptr> dptrs;
+  std::vector<void*> args;
+  auto node_params = NodeParams(params, &dptrs, &args);
+  Error err = cuGraphExecKernelNodeSetParams(exec, nodes[0], &node_params);
+  Error::Check(err, "cuGraphExecKernelNodeSetParams() failed");
 }
 
 ZeroKernel::ZeroKernel(Device* device, const lang::KernelInfo& ki)  //
@@ -290,38 +475,154 @@ std::shared_ptr<hal::Event> ZeroKernel::Run(const context::Context& ctx,
                                             const std::vector<std::shared_ptr<hal::Buffer>>& params,
                                             const std::vector<std::shared_ptr<hal::Event>>& deps,
                                             bool enable_profiling) {
+  auto start = std::chrono::high_resolution_clock::now();
+  Launch(params);
+  Error err = cuCtxSynchronize();
+  Error::Check(err, "cuCtxSynchronize() failed");
+  auto end = std::chrono::high_resolution_clock::now();
+  std::shared_ptr<hal::Result> result = std::make_shared<Result>(ctx, "tile::hal::cuda::ZeroKernel::Run", start, end);
+  return std::make_shared<Event>(std::move(result));
+}
+
+void ZeroKernel::Launch(const std::vector<std::shared_ptr<hal::Buffer>>& params) {
   auto buf = DeviceBuffer::Downcast(params[0]);
   auto dptr = buf->dptr();
 
   device_->SetCurrentContext();
 
-  auto start = std::chrono::high_resolution_clock::now();
-
-  Error err = cuMemsetD8(dptr, 0, buf->size());
-  Error::Check(err, "cuMemsetD8() failed");
+  // The fill pattern, when present, is the little-endian encoding of one
+  // element of the aggregation identity (e.g. -inf for a float max); an
+  // empty pattern means plain zeroes.  Element widths of 1, 2, and 4 bytes
+  // map directly onto the memset family; 8-byte patterns are written as two
+  // interleaved 32-bit columns via the pitched memset.
+  const std::string& fill = ki_.info.zero().fill();
+  Error err = CUDA_SUCCESS;
+  if (fill.empty()) {
+    err = cuMemsetD8(dptr, 0, buf->size());
+  } else if (fill.size() == 1) {
+    err = cuMemsetD8(dptr, static_cast<unsigned char>(fill[0]), buf->size());
+  } else if (fill.size() == 2) {
+    unsigned short pattern;  // NOLINT(runtime/int)
+    memcpy(&pattern, fill.data(), sizeof(pattern));
+    err = cuMemsetD16(dptr, pattern, buf->size() / sizeof(pattern));
+  } else if (fill.size() == 4) {
+    unsigned int pattern;
+    memcpy(&pattern, fill.data(), sizeof(pattern));
+    err = cuMemsetD32(dptr, pattern, buf->size() / sizeof(pattern));
+  } else if (fill.size() == 8) {
+    unsigned int lo;
+    unsigned int hi;
+    memcpy(&lo, fill.data(), sizeof(lo));
+    memcpy(&hi, fill.data() + sizeof(lo), sizeof(hi));
+    err = cuMemsetD2D32(dptr, fill.size(), lo, 1, buf->size() / fill.size());
+    if (!err) {
+      err = cuMemsetD2D32(dptr + sizeof(lo), fill.size(), hi, 1, buf->size() / fill.size());
+    }
+  } else {
+    throw std::runtime_error("Unsupported fill pattern width: " + std::to_string(fill.size()));
+  }
+  Error::Check(err, "device memset failed");
+}
+
+std::vector<CUDA_MEMSET_NODE_PARAMS> ZeroKernel::NodeParams(CUdeviceptr dptr, std::uint64_t size) {
+  // The same fill encoding as Launch(), expressed as graph memset nodes; the
+  // 8-byte case again becomes two interleaved 32-bit columns.
+  const std::string& fill = ki_.info.zero().fill();
+  std::vector<CUDA_MEMSET_NODE_PARAMS> ret;
+  CUDA_MEMSET_NODE_PARAMS node_params = {};
+  node_params.dst = dptr;
+  node_params.pitch = 0;
+  node_params.height = 1;
+  if (fill.empty()) {
+    node_params.elementSize = 1;
+    node_params.value = 0;
+    node_params.width = size;
+    ret.push_back(node_params);
+  } else if (fill.size() == 1) {
+    node_params.elementSize = 1;
+    node_params.value = static_cast<unsigned char>(fill[0]);
+    node_params.width = size;
+    ret.push_back(node_params);
+  } else if (fill.size() == 2) {
+    unsigned short pattern;  // NOLINT(runtime/int)
+    memcpy(&pattern, fill.data(), sizeof(pattern));
+    node_params.elementSize = 2;
+    node_params.value = pattern;
+    node_params.width = size / sizeof(pattern);
+    ret.push_back(node_params);
+  } else if (fill.size() == 4) {
+    unsigned int pattern;
+    memcpy(&pattern, fill.data(), sizeof(pattern));
+    node_params.elementSize = 4;
+    node_params.value = pattern;
+    node_params.width = size / sizeof(pattern);
+    ret.push_back(node_params);
+  } else if (fill.size() == 8) {
+    unsigned int lo;
+    unsigned int hi;
+    memcpy(&lo, fill.data(), sizeof(lo));
+    memcpy(&hi, fill.data() + sizeof(lo), sizeof(hi));
+    node_params.elementSize = 4;
+    node_params.pitch = fill.size();
+    node_params.width = 1;
+    node_params.height = size / fill.size();
+    node_params.value = lo;
+    ret.push_back(node_params);
+    node_params.dst = dptr + sizeof(lo);
+    node_params.value = hi;
+    ret.push_back(node_params);
+  } else {
+    throw std::runtime_error("Unsupported fill pattern width: " + std::to_string(fill.size()));
+  }
+  return ret;
+}
 
-  err = cuCtxSynchronize();
-  Error::Check(err, "cuCtxSynchronize() failed");
+CUgraphNode ZeroKernel::AddNodes(CUgraph graph, CUgraphNode tail,
+                                 const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                                 std::vector<CUgraphNode>* nodes) {
+  auto buf = DeviceBuffer::Downcast(params[0]);
+  for (const auto& node_params : NodeParams(buf->dptr(), buf->size())) {
+    CUgraphNode node;
+    Error err = cuGraphAddMemsetNode(&node, graph, tail ? &tail : nullptr, tail ? 1 : 0, &node_params,
+                                     device_->context());
+    Error::Check(err, "cuGraphAddMemsetNode() failed");
+    nodes->push_back(node);
+    tail = node;
+  }
+  return tail;
+}
 
-  auto end = std::chrono::high_resolution_clock::now();
-  std::shared_ptr<hal::Result> result = std::make_shared<Result>(ctx, "tile::hal::cuda::ZeroKernel::Run", start, end);
-  return std::make_shared<Event>(std::move(result));
+void ZeroKernel::UpdateNodes(CUgraphExec exec, const std::vector<CUgraphNode>& nodes,
+                             const std::vector<std::shared_ptr<hal::Buffer>>& params) {
+  auto buf = DeviceBuffer::Downcast(params[0]);
+  auto node_params = NodeParams(buf->dptr(), buf->size());
+  for (std::size_t i = 0; i < node_params.size(); i++) {
+    Error err = cuGraphExecMemsetNodeSetParams(exec, nodes[i], &node_params[i], device_->context());
+    Error::Check(err, "cuGraphExecMemsetNodeSetParams() failed");
+  }
 }
 
-Library::Library(std::vector<std::shared_ptr<Kernel>> kernels) : kernels_{std::move(kernels)} {}
+Library::Library(Device* device, std::vector<std::shared_ptr<Kernel>> kernels)
+    : device_{device},            //
+      kernels_{std::move(kernels)}  //
+{}
 
 Library* Library::Downcast(hal::Library* library) {  //
   return dynamic_cast<Library*>(library);
 }
 
 boost::future<std::unique_ptr<hal::Executable>> Library::Prepare() {
-  return boost::make_ready_future<std::unique_ptr<hal::Executable>>(std::make_unique<Executable>(kernels_));
+  return boost::make_ready_future<std::unique_ptr<hal::Executable>>(std::make_unique<Executable>(device_, kernels_));
 }
 
 Event::Event(std::shared_ptr<hal::Result> result)  //
     : result_(std::move(result))                   //
 {}
 
+Event::Event(std::shared_ptr<GraphRun> run)  //
+    : run_(std::move(run))                   //
+{}
+
 std::shared_ptr<Event> Event::Downcast(const std::shared_ptr<hal::Event>& event) {
   auto evt = std::dynamic_pointer_cast<Event>(event);
   if (!evt) {
@@ -347,7 +648,12 @@ boost::future<std::vector<std::shared_ptr<hal::Result>>> Event::WaitFor(
   return results;
 }
 
-boost::shared_future<std::shared_ptr<hal::Result>> Event::GetFuture() {  //
+boost::shared_future<std::shared_ptr<hal::Result>> Event::GetFuture() {
+  // Deferred runs execute when first waited on.
+  if (run_) {
+    result_ = run_->Finish();
+    run_.reset();
+  }
   return boost::make_ready_future(result_);
 }
 
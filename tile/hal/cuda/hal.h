@@ -2,7 +2,10 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cuda/include/cuda.h"
@@ -82,6 +85,8 @@ class Device final : public hal::Device {
   void SetCurrentContext();
   hal::proto::HardwareInfo GetHardwareInfo();
 
+  CUcontext context() const { return context_; }
+
  private:
   std::unique_ptr<hal::Compiler> compiler_;
   std::unique_ptr<hal::Executor> executor_;
@@ -176,11 +181,78 @@ class Kernel {
                                           const std::vector<std::shared_ptr<hal::Buffer>>& params,
                                           const std::vector<std::shared_ptr<hal::Event>>& dependencies,
                                           bool enable_profiling) = 0;
+
+  // Launches the kernel asynchronously; completion is observed via a later
+  // context synchronize.
+  virtual void Launch(const std::vector<std::shared_ptr<hal::Buffer>>& params) = 0;
+
+  // Appends this kernel's node(s) to a graph, chained after tail; returns the
+  // new tail.
+  virtual CUgraphNode AddNodes(CUgraph graph, CUgraphNode tail,
+                               const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                               std::vector<CUgraphNode>* nodes) = 0;
+
+  // Rebinds the buffer arguments of this kernel's node(s) on an instantiated
+  // graph.
+  virtual void UpdateNodes(CUgraphExec exec, const std::vector<CUgraphNode>& nodes,
+                           const std::vector<std::shared_ptr<hal::Buffer>>& params) = 0;
+};
+
+// The recorded launch sequence of a program, shared across its runs.
+struct Graph {
+  explicit Graph(Device* device) : device{device} {}
+  ~Graph();
+
+  void Discard();
+
+  Device* device;
+  CUgraph graph = nullptr;
+  CUgraphExec exec = nullptr;
+  std::vector<std::pair<Kernel*, std::vector<CUgraphNode>>> nodes;
+};
+
+// GraphRun accumulates the kernel launches of one program run.  The first run
+// is recorded into a CUDA graph, one node per launch, chained in issue order;
+// subsequent runs rebind buffer arguments on the instantiated graph node by
+// node and replay the whole sequence with a single cuGraphLaunch().
+// Execution is deferred until Finish(), which the events returned by
+// Executable::Run() invoke when first waited on; a run whose launch sequence
+// diverges from the recording falls back to eager launches and the graph is
+// re-recorded on the next run.
+class GraphRun {
+ public:
+  GraphRun(const context::Context& ctx, Device* device, std::shared_ptr<Graph> graph);
+
+  // Records or replays one kernel launch.
+  void Enqueue(const std::shared_ptr<Kernel>& kernel, const std::vector<std::shared_ptr<hal::Buffer>>& params);
+
+  // Executes any deferred work and waits for it; idempotent.
+  std::shared_ptr<hal::Result> Finish();
+
+  bool finished() const { return finished_; }
+
+ private:
+  enum class State {
+    kRecording,
+    kReplaying,
+    kEager,
+  };
+
+  context::Context ctx_;
+  Device* device_;
+  std::shared_ptr<Graph> graph_;
+  State state_;
+  CUgraphNode tail_ = nullptr;
+  std::vector<std::pair<std::shared_ptr<Kernel>, std::vector<std::shared_ptr<hal::Buffer>>>> calls_;
+  std::size_t cursor_ = 0;
+  bool finished_ = false;
+  std::shared_ptr<hal::Result> result_;
+  std::mutex mu_;
 };
 
 class Executable final : public hal::Executable {
  public:
-  explicit Executable(std::vector<std::unique_ptr<hal::Kernel>> kernels);
+  Executable(Device* device, std::vector<std::shared_ptr<Kernel>> kernels);
 
   std::shared_ptr<hal::Event> Run(const context::Context& ctx, std::size_t kernel_index,
                                   const std::vector<std::shared_ptr<hal::Buffer>>& params,
@@ -188,7 +260,11 @@ class Executable final : public hal::Executable {
                                   bool enable_profiling = false) final;
 
  private:
+  Device* device_;
   std::vector<std::shared_ptr<Kernel>> kernels_;
+  bool graphs_enabled_;
+  std::shared_ptr<Graph> graph_;
+  std::shared_ptr<GraphRun> run_;
 };
 
 class ComputeKernel final : public Kernel {
@@ -199,7 +275,18 @@ class ComputeKernel final : public Kernel {
                                   const std::vector<std::shared_ptr<hal::Event>>& dependencies,
                                   bool enable_profiling) final;
 
+  void Launch(const std::vector<std::shared_ptr<hal::Buffer>>& params) final;
+
+  CUgraphNode AddNodes(CUgraph graph, CUgraphNode tail, const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                       std::vector<CUgraphNode>* nodes) final;
+
+  void UpdateNodes(CUgraphExec exec, const std::vector<CUgraphNode>& nodes,
+                   const std::vector<std::shared_ptr<hal::Buffer>>& params) final;
+
  private:
+  CUDA_KERNEL_NODE_PARAMS NodeParams(const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                                     std::vector<CUdeviceptr>* dptrs, std::vector<void*>* args);
+
   lang::KernelInfo ki_;
   CUfunction function_;
   Device* device_;
@@ -213,7 +300,17 @@ class ZeroKernel final : public Kernel {
                                   const std::vector<std::shared_ptr<hal::Event>>& dependencies,
                                   bool enable_profiling) final;
 
+  void Launch(const std::vector<std::shared_ptr<hal::Buffer>>& params) final;
+
+  CUgraphNode AddNodes(CUgraph graph, CUgraphNode tail, const std::vector<std::shared_ptr<hal::Buffer>>& params,
+                       std::vector<CUgraphNode>* nodes) final;
+
+  void UpdateNodes(CUgraphExec exec, const std::vector<CUgraphNode>& nodes,
+                   const std::vector<std::shared_ptr<hal::Buffer>>& params) final;
+
  private:
+  std::vector<CUDA_MEMSET_NODE_PARAMS> NodeParams(CUdeviceptr dptr, std::uint64_t size);
+
   lang::KernelInfo ki_;
   Device* device_;
 };
@@ -222,19 +319,21 @@ class Library final : public hal::Library {
  public:
   static Library* Downcast(hal::Library* library);
 
-  explicit Library(std::vector<std::shared_ptr<Kernel>> kernels);
+  Library(Device* device, std::vector<std::shared_ptr<Kernel>> kernels);
 
   std::string Serialize() final { return ""; }
 
   boost::future<std::unique_ptr<hal::Executable>> Prepare();
 
  private:
+  Device* device_;
   std::vector<std::shared_ptr<Kernel>> kernels_;
 };
 
 class Event final : public hal::Event {
  public:
   explicit Event(std::shared_ptr<hal::Result> result);
+  explicit Event(std::shared_ptr<GraphRun> run);
 
   static std::shared_ptr<Event> Downcast(const std::shared_ptr<hal::Event>& event);
 
@@ -244,6 +343,7 @@ class Event final : public hal::Event {
   boost::shared_future<std::shared_ptr<hal::Result>> GetFuture() final;
 
  private:
+  std::shared_ptr<GraphRun> run_;
   std::shared_ptr<hal::Result> result_;
 };
 
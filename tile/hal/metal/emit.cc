@@ -371,6 +371,21 @@ class Emitter : public sem::Visitor {
   }
 
   void Visit(const sem::SpecialStmt& node) {
+    if (node.name.rfind("vstore", 0) == 0) {
+      // Vector stores from the widening pass; the prelude supplies
+      // OpenCL-style vstoren templates.
+      emitTab();
+      emit(node.name);
+      emit("(");
+      for (size_t i = 0; i < node.params.size(); i++) {
+        if (i) {
+          emit(", ");
+        }
+        node.params[i]->Accept(*this);
+      }
+      emit(");\n");
+      return;
+    }
     throw std::runtime_error("Metal code emitter special statement not defined!");
   }
 
@@ -89,6 +89,57 @@ id<MTLCommandQueue> Device::queue() {
   return queue_;
 }
 
+namespace {
+
+// Commit the shared command buffer after this many encodings even if nothing
+// is waiting, so work starts flowing to the GPU on long schedules.
+constexpr std::size_t kMaxBatchedKernels = 64;
+
+std::size_t BatchLimit() {
+  if (env::Get("PLAIDML_METAL_BATCH") == "0") {
+    return 1;  // A limit of one commit-per-launch restores the old behavior
+  }
+  return kMaxBatchedKernels;
+}
+
+}  // namespace
+
+id<MTLCommandBuffer> Device::batch() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!queue_) {
+    queue_ = [device_ newCommandQueue];
+  }
+  if (!batch_cmdbuf_) {
+    batch_cmdbuf_ = [queue_ commandBuffer];
+    batch_encodings_ = 0;
+  }
+  batch_encodings_++;
+  return batch_cmdbuf_;
+}
+
+void Device::FlushBatch() {
+  id<MTLCommandBuffer> cmdbuf;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    cmdbuf = batch_cmdbuf_;
+    batch_cmdbuf_ = nil;
+    batch_encodings_ = 0;
+  }
+  if (cmdbuf) {
+    [cmdbuf commit];
+  }
+}
+
+void Device::MaybeFlushBatch() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!batch_cmdbuf_ || batch_encodings_ < BatchLimit()) {
+      return;
+    }
+  }
+  FlushBatch();
+}
+
 Memory::Memory(Device* device)  //
     : device_(device)           //
 {}
@@ -106,7 +157,52 @@ std::shared_ptr<hal::Buffer> Memory::MakeBuffer(std::uint64_t size, BufferAccess
 }
 
 std::shared_ptr<hal::Arena> Memory::MakeArena(std::uint64_t size, BufferAccessMask access) {
-  throw error::Unimplemented("Not implemented: Memory::MakeArena");
+  if ((access & BufferAccessMask::LOCATION_MASK) != BufferAccessMask::DEVICE) {
+    // Heaps are private storage; host-visible memory stays on the
+    // discrete-buffer path.
+    throw error::Unimplemented("Not implemented: Memory::MakeArena for host-accessible memory");
+  }
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    MTLHeapDescriptor* desc = [[MTLHeapDescriptor alloc] init];
+    desc.type = MTLHeapTypePlacement;
+    desc.storageMode = MTLStorageModePrivate;
+    // The placer only overlaps allocations whose lifetimes the schedule
+    // keeps apart, but the schedule's dependency edges are what enforce
+    // that; keep Metal's hazard tracking across the aliased buffers rather
+    // than promising untracked access.
+    desc.hazardTrackingMode = MTLHazardTrackingModeTracked;
+    desc.size = size;
+    id<MTLHeap> heap = [device_->dev() newHeapWithDescriptor:desc];
+    if (!heap) {
+      throw error::ResourceExhausted{"Unable to allocate Metal heap"};
+    }
+    return std::make_shared<Arena>(device_, heap, size);
+  }
+  throw error::Unimplemented("Not implemented: Memory::MakeArena (requires placement heap support)");
+}
+
+Arena::Arena(Device* device,       //
+             id<MTLHeap> heap,     //
+             std::uint64_t size)   //
+    : device_(device),             //
+      heap_(heap),                 //
+      size_(size)                  //
+{}
+
+std::shared_ptr<hal::Buffer> Arena::MakeBuffer(std::uint64_t offset, std::uint64_t size) {
+  if (size_ < offset || size_ < size || size_ < (offset + size)) {
+    throw error::OutOfRange{"Requesting memory outside arena bounds"};
+  }
+  id<MTLBuffer> buf = nil;
+  if (@available(macOS 10.15, iOS 13.0, *)) {
+    buf = [heap_ newBufferWithLength:size options:MTLResourceStorageModePrivate offset:offset];
+  }
+  if (!buf) {
+    throw error::ResourceExhausted{"Unable to place buffer in Metal heap"};
+  }
+  // The MTLBuffer retains its heap, so the aliased storage lives as long as
+  // any buffer placed in it.
+  return std::make_shared<Buffer>(device_, buf, size, BufferAccessMask::DEVICE_RW);
 }
 
 Buffer::Buffer(Device* device,           //
@@ -135,6 +231,9 @@ boost::future<void*> Buffer::MapCurrent(const std::vector<std::shared_ptr<hal::E
   auto handler = [buffer = buffer_, promise](id<MTLCommandBuffer> cmdbuf) mutable {
     promise->set_value([buffer contents]);
   };
+  // The queue executes command buffers in commit order; committing the
+  // batched kernels first makes the sync blit see their output.
+  device_->FlushBatch();
   @autoreleasepool {
     auto cmdbuf = [device_->queue() commandBuffer];
     auto encoder = [cmdbuf blitCommandEncoder];
@@ -157,6 +256,7 @@ std::shared_ptr<hal::Event> Buffer::Unmap(const context::Context& ctx) {
   if ((access_ & BufferAccessMask::LOCATION_MASK) == BufferAccessMask::DEVICE) {
     throw error::Unimplemented("Not Implemented: Buffer::Unmap for device-only accessible memory");
   }
+  device_->FlushBatch();
   @autoreleasepool {
     [buffer_ didModifyRange:NSMakeRange(0, size_)];
     // NOTE: This encoder which seems to do nothing appears to be required for some Metal devices.
@@ -186,6 +286,19 @@ std::string WithLineNumbers(const std::string& src) {
   return ss_out.str();
 }
 
+// OpenCL-style vector transfers for kernels produced by the vector widening
+// pass.  Metal vectors top out at 4 lanes.
+const char* k_vector_transfers = R"***(
+template <typename T> inline vec<T, 2> vload2(size_t o, const device T* p) { return *(const device vec<T, 2>*)(p + o * 2); }
+template <typename T> inline vec<T, 4> vload4(size_t o, const device T* p) { return *(const device vec<T, 4>*)(p + o * 4); }
+template <typename T> inline vec<T, 2> vload2(size_t o, const threadgroup T* p) { return *(const threadgroup vec<T, 2>*)(p + o * 2); }
+template <typename T> inline vec<T, 4> vload4(size_t o, const threadgroup T* p) { return *(const threadgroup vec<T, 4>*)(p + o * 4); }
+template <typename T> inline void vstore2(vec<T, 2> v, size_t o, device T* p) { *(device vec<T, 2>*)(p + o * 2) = v; }
+template <typename T> inline void vstore4(vec<T, 4> v, size_t o, device T* p) { *(device vec<T, 4>*)(p + o * 4) = v; }
+template <typename T> inline void vstore2(vec<T, 2> v, size_t o, threadgroup T* p) { *(threadgroup vec<T, 2>*)(p + o * 2) = v; }
+template <typename T> inline void vstore4(vec<T, 4> v, size_t o, threadgroup T* p) { *(threadgroup vec<T, 4>*)(p + o * 4) = v; }
+)***";
+
 }  // namespace
 
 boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Context& ctx,
@@ -202,6 +315,7 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
   std::map<std::string, std::string> seen;
   std::stringstream src;
   src << "using namespace metal;\n\n";
+  src << k_vector_transfers << "\n";
   std::string out_dir = env::Get("PLAIDML_METAL_OUTPUT");
   for (const auto& ki : kernel_infos) {
     auto it = seen.find(ki.kname);
@@ -215,7 +329,7 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
         fs::path out_path = out_dir;
         fs::path src_path = (out_path / ki.kname).replace_extension("metal");
         std::stringstream output;
-        output << "using namespace metal;\n\n" << ki.comments;
+        output << "using namespace metal;\n\n" << k_vector_transfers << "\n" << ki.comments;
         output << "// gid: " << ki.gwork[0] << " " << ki.gwork[1] << " " << ki.gwork[2] << "\n";
         output << "// lid: " << ki.lwork[0] << " " << ki.lwork[1] << " " << ki.lwork[2] << "\n";
         output << kernel_src << "\n\n";
@@ -303,10 +417,20 @@ boost::future<std::unique_ptr<hal::Executable>> Library::Prepare() {
     auto kernel_id = kbuild.ctx().activity_id();
 
     if (kctx.ki.ktype == lang::KernelType::kZero) {
-      // kinfo.set_src("// Builtin zero kernel");
-      kernels.emplace_back(
-          boost::make_ready_future(std::unique_ptr<Kernel>(std::make_unique<ZeroKernel>(device_, kctx.ki, kernel_id))));
-      continue;
+      // The blit encoder can only fill with a single repeated byte; when the
+      // aggregation-identity pattern is wider than that (e.g. -inf for a
+      // float max), fall through and run the emitted fill kernel instead.
+      const std::string& fill = kctx.ki.info.zero().fill();
+      bool uniform = true;
+      for (char byte : fill) {
+        uniform &= (byte == fill[0]);
+      }
+      if (uniform) {
+        // kinfo.set_src("// Builtin zero kernel");
+        kernels.emplace_back(boost::make_ready_future(
+            std::unique_ptr<Kernel>(std::make_unique<ZeroKernel>(device_, kctx.ki, kernel_id))));
+        continue;
+      }
     }
     if (kctx.ki.ktype == lang::KernelType::kCopy) {
       kernels.emplace_back(
@@ -354,7 +478,8 @@ boost::future<std::unique_ptr<hal::Executable>> Library::Prepare() {
 }
 
 Executor::Executor(Device* device)       //
-    : info_(device->GetHardwareInfo()),  //
+    : device_(device),                   //
+      info_(device->GetHardwareInfo()),  //
       memory_(new Memory(device))        //
 {}
 
@@ -373,8 +498,14 @@ boost::future<std::unique_ptr<hal::Executable>> Executor::Prepare(hal::Library*
   return lib->Prepare();
 }
 
+void Executor::Flush() {  //
+  device_->FlushBatch();
+}
+
 boost::future<std::vector<std::shared_ptr<hal::Result>>> Executor::WaitFor(
     const std::vector<std::shared_ptr<hal::Event>>& events) {
+  // Event futures only resolve once their command buffer is committed
+  device_->FlushBatch();
   std::vector<boost::shared_future<std::shared_ptr<hal::Result>>> futures;
   for (auto& event : events) {
     futures.emplace_back(event->GetFuture());
@@ -437,25 +568,29 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
     MTLSize groups = MTLSizeMake(ki_.gwork[0] / threads.width,   //
                                  ki_.gwork[1] / threads.height,  //
                                  ki_.gwork[2] / threads.depth);
-    auto cmdbuf = [device_->queue() commandBuffer];
-    auto encoder = [cmdbuf computeCommandEncoder];
-    [encoder setComputePipelineState:state_];
-    for (size_t i = 0; i < params.size(); i++) {
-      auto buf = Buffer::Downcast(params[i]);
-      [encoder setBuffer:buf->buffer()  //
-                  offset:0
-                 atIndex:i];
-    }
-    [encoder dispatchThreadgroups:groups threadsPerThreadgroup:threads];
-    [encoder endEncoding];
-    context::Activity activity{ctx, "tile::hal::opencl::Kernel::Run"};
-    if (ctx.is_logging_events()) {
-      opencl::proto::RunInfo rinfo;
-      *rinfo.mutable_kernel_id() = kernel_id_;
-      activity.AddMetadata(rinfo);
+    std::shared_ptr<Event> event;
+    {
+      std::lock_guard<std::mutex> guard(device_->encode_mutex());
+      auto cmdbuf = device_->batch();
+      auto encoder = [cmdbuf computeCommandEncoder];
+      [encoder setComputePipelineState:state_];
+      for (size_t i = 0; i < params.size(); i++) {
+        auto buf = Buffer::Downcast(params[i]);
+        [encoder setBuffer:buf->buffer()  //
+                    offset:0
+                   atIndex:i];
+      }
+      [encoder dispatchThreadgroups:groups threadsPerThreadgroup:threads];
+      [encoder endEncoding];
+      context::Activity activity{ctx, "tile::hal::opencl::Kernel::Run"};
+      if (ctx.is_logging_events()) {
+        opencl::proto::RunInfo rinfo;
+        *rinfo.mutable_kernel_id() = kernel_id_;
+        activity.AddMetadata(rinfo);
+      }
+      event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
     }
-    auto event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
-    [cmdbuf commit];
+    device_->MaybeFlushBatch();
     return event;
   }
 }
@@ -473,24 +608,28 @@ std::shared_ptr<hal::Event> CopyKernel::Run(const context::Context& ctx,
                                             const std::vector<std::shared_ptr<hal::Event>>& deps,
                                             bool enable_profiling) {
   @autoreleasepool {
-    auto cmdbuf = [device_->queue() commandBuffer];
-    auto encoder = [cmdbuf blitCommandEncoder];
-    auto dst_buf = Buffer::Downcast(params[0]);
-    auto src_buf = Buffer::Downcast(params[1]);
-    [encoder copyFromBuffer:src_buf->buffer()
-               sourceOffset:0
-                   toBuffer:dst_buf->buffer()
-          destinationOffset:0
-                       size:src_buf->size()];
-    [encoder endEncoding];
-    context::Activity activity{ctx, "tile::hal::opencl::Buffer::Copy"};
-    if (ctx.is_logging_events()) {
-      opencl::proto::RunInfo rinfo;
-      *rinfo.mutable_kernel_id() = kernel_id_;
-      activity.AddMetadata(rinfo);
+    std::shared_ptr<Event> event;
+    {
+      std::lock_guard<std::mutex> guard(device_->encode_mutex());
+      auto cmdbuf = device_->batch();
+      auto encoder = [cmdbuf blitCommandEncoder];
+      auto dst_buf = Buffer::Downcast(params[0]);
+      auto src_buf = Buffer::Downcast(params[1]);
+      [encoder copyFromBuffer:src_buf->buffer()
+                 sourceOffset:0
+                     toBuffer:dst_buf->buffer()
+            destinationOffset:0
+                         size:src_buf->size()];
+      [encoder endEncoding];
+      context::Activity activity{ctx, "tile::hal::opencl::Buffer::Copy"};
+      if (ctx.is_logging_events()) {
+        opencl::proto::RunInfo rinfo;
+        *rinfo.mutable_kernel_id() = kernel_id_;
+        activity.AddMetadata(rinfo);
+      }
+      event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
     }
-    auto event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
-    [cmdbuf commit];
+    device_->MaybeFlushBatch();
     return event;
   }
 }
@@ -508,21 +647,29 @@ std::shared_ptr<hal::Event> ZeroKernel::Run(const context::Context& ctx,
                                             const std::vector<std::shared_ptr<hal::Event>>& deps,
                                             bool enable_profiling) {
   @autoreleasepool {
-    auto cmdbuf = [device_->queue() commandBuffer];
-    auto encoder = [cmdbuf blitCommandEncoder];
-    auto buf = Buffer::Downcast(params[0]);
-    [encoder fillBuffer:buf->buffer()  //
-                  range:NSMakeRange(0, buf->size())
-                  value:0];
-    [encoder endEncoding];
-    context::Activity activity{ctx, "tile::hal::opencl::Buffer::Fill"};
-    if (ctx.is_logging_events()) {
-      opencl::proto::RunInfo rinfo;
-      *rinfo.mutable_kernel_id() = kernel_id_;
-      activity.AddMetadata(rinfo);
+    std::shared_ptr<Event> event;
+    {
+      std::lock_guard<std::mutex> guard(device_->encode_mutex());
+      auto cmdbuf = device_->batch();
+      auto encoder = [cmdbuf blitCommandEncoder];
+      auto buf = Buffer::Downcast(params[0]);
+      // Library::Prepare only routes here when the fill pattern repeats a
+      // single byte (or is empty, meaning plain zeroes).
+      const std::string& fill = ki_.info.zero().fill();
+      uint8_t value = fill.empty() ? 0 : static_cast<uint8_t>(fill[0]);
+      [encoder fillBuffer:buf->buffer()  //
+                    range:NSMakeRange(0, buf->size())
+                    value:value];
+      [encoder endEncoding];
+      context::Activity activity{ctx, "tile::hal::opencl::Buffer::Fill"};
+      if (ctx.is_logging_events()) {
+        opencl::proto::RunInfo rinfo;
+        *rinfo.mutable_kernel_id() = kernel_id_;
+        activity.AddMetadata(rinfo);
+      }
+      event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
     }
-    auto event = std::make_shared<Event>(activity.ctx(), cmdbuf, "tile::hal::opencl::Executing");
-    [cmdbuf commit];
+    device_->MaybeFlushBatch();
     return event;
   }
 }
@@ -7,6 +7,7 @@
 #include <Metal/MTLCommandQueue.h>
 #include <Metal/MTLComputePipeline.h>
 #include <Metal/MTLDevice.h>
+#include <Metal/MTLHeap.h>
 #include <Metal/MTLLibrary.h>
 
 #include <string>
@@ -66,6 +67,17 @@ class Device final : public hal::Device {
   id<MTLDevice> dev() const { return device_; }
   id<MTLCommandQueue> queue();
 
+  // Kernel launches encode into a shared command buffer instead of
+  // committing one buffer per launch; the per-buffer overhead dominates
+  // small kernels.  The shared buffer is committed when a batch fills up
+  // (MaybeFlushBatch) or when something needs the results (FlushBatch):
+  // a wait, a map, or an explicit executor flush.  Encoding is serialized
+  // by encode_mutex(); a command buffer admits one active encoder.
+  std::mutex& encode_mutex() { return encode_mutex_; }
+  id<MTLCommandBuffer> batch();
+  void FlushBatch();
+  void MaybeFlushBatch();
+
  private:
   id<MTLDevice> device_;
   id<MTLCommandQueue> queue_;
@@ -73,6 +85,9 @@ class Device final : public hal::Device {
   std::unique_ptr<hal::Executor> executor_;
   const std::unordered_map<std::string, std::unique_ptr<hal::Loader>> il_loader_map_;
   std::mutex mutex_;
+  std::mutex encode_mutex_;
+  id<MTLCommandBuffer> batch_cmdbuf_ = nil;
+  std::size_t batch_encodings_ = 0;
 };
 
 class Memory final : public hal::Memory {
@@ -90,6 +105,22 @@ class Memory final : public hal::Memory {
   Device* device_;
 };
 
+// An Arena implemented with a placement MTLHeap: the placer hands out byte
+// offsets with temporally-disjoint lifetimes overlapping, and each
+// MakeBuffer suballocates at its offset, so schedule temporaries alias one
+// device allocation instead of each holding a discrete MTLBuffer.
+class Arena final : public hal::Arena {
+ public:
+  Arena(Device* device, id<MTLHeap> heap, std::uint64_t size);
+
+  std::shared_ptr<hal::Buffer> MakeBuffer(std::uint64_t offset, std::uint64_t size) final;
+
+ private:
+  Device* device_;
+  id<MTLHeap> heap_;
+  std::uint64_t size_;
+};
+
 class Buffer : public hal::Buffer {
  public:
   Buffer(Device* device,        //
@@ -151,11 +182,10 @@ class Executor : public hal::Executor {
   boost::future<std::vector<std::shared_ptr<hal::Result>>> WaitFor(
       const std::vector<std::shared_ptr<hal::Event>>& events) final;
 
-  void Flush() final {
-    // NOP
-  }
+  void Flush() final;
 
  private:
+  Device* device_;
   const hal::proto::HardwareInfo info_;
   std::unique_ptr<hal::Memory> memory_;
 };
@@ -0,0 +1,90 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/hal/opencl/cl_mem_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/util/logging.h"
+#include "tile/hal/opencl/cl_mem_buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+namespace {
+
+std::uint64_t RoundUpPo2(std::uint64_t value) {
+  std::uint64_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+CLMemPool::CLMemPool(const std::shared_ptr<DeviceState>& device_state, std::uint64_t alignment)
+    : device_state_{device_state},
+      // Every size class is a power of two at least this large, so region
+      // origins automatically satisfy the device's base address alignment.
+      min_bytes_{RoundUpPo2(std::max<std::uint64_t>(alignment, 1024))} {}
+
+std::shared_ptr<hal::Buffer> CLMemPool::MakeBuffer(std::uint64_t size) {
+  auto bytes = RoundUpPo2(std::max(size, min_bytes_));
+  if (bytes > kMaxPooledBytes) {
+    return nullptr;
+  }
+  Region region;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto& free_list = free_lists_[bytes];
+    if (!free_list.empty()) {
+      region = std::move(free_list.back());
+      free_list.pop_back();
+    } else {
+      if (slab_used_ + bytes > kSlabBytes) {
+        Err err;
+        CLObj<cl_mem> slab =
+            ocl::CreateBuffer(device_state_->cl_ctx().get(), CL_MEM_READ_WRITE, kSlabBytes, nullptr, err.ptr());
+        if (err) {
+          IVLOG(1, "CLMemPool: unable to allocate a new slab: " << err.str());
+          return nullptr;
+        }
+        slabs_.emplace_back(std::move(slab));
+        slab_used_ = 0;
+      }
+      region = Region{slabs_.back(), slab_used_, bytes};
+      slab_used_ += bytes;
+    }
+  }
+  Err err;
+  cl_buffer_region cl_region;
+  cl_region.origin = region.offset;
+  cl_region.size = region.size;
+  CLObj<cl_mem> mem = ocl::CreateSubBuffer(region.slab.get(), 0, CL_BUFFER_CREATE_TYPE_REGION, &cl_region, err.ptr());
+  if (err) {
+    IVLOG(1, "CLMemPool: unable to create a sub-buffer: " << err.str());
+    Release(region);
+    return nullptr;
+  }
+  // The deleter hands the region back to the free list once the buffer (and
+  // with it the sub-buffer cl_mem) is gone.
+  auto self = shared_from_this();
+  return std::shared_ptr<CLMemBuffer>(new CLMemBuffer(device_state_, size, std::move(mem)),
+                                      [self, region](CLMemBuffer* buffer) {
+                                        delete buffer;
+                                        self->Release(region);
+                                      });
+}
+
+void CLMemPool::Release(const Region& region) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  free_lists_[region.size].emplace_back(region);
+}
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
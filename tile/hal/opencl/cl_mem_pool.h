@@ -0,0 +1,63 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tile/base/hal.h"
+#include "tile/hal/opencl/device_state.h"
+#include "tile/hal/opencl/ocl.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+// Pools device allocations as power-of-two sub-buffers carved from large
+// slabs.  Each clCreateBuffer is a driver round trip and fragments the
+// driver-side heap; suballocating with clCreateSubBuffer makes per-run
+// temporary allocation a free-list pop instead.  Regions return to the pool
+// when their buffer is released; slabs live as long as anything carved from
+// them does.
+class CLMemPool final : public std::enable_shared_from_this<CLMemPool> {
+ public:
+  CLMemPool(const std::shared_ptr<DeviceState>& device_state, std::uint64_t alignment);
+
+  // Returns a pooled buffer of at least `size` bytes, or nullptr when the
+  // request is too large to pool (or the driver refuses the sub-buffer), in
+  // which case the caller should fall back to a standalone allocation.
+  std::shared_ptr<hal::Buffer> MakeBuffer(std::uint64_t size);
+
+ private:
+  // A power-of-two span within a slab.  Holding the slab's cl_mem keeps the
+  // slab alive until every region carved from it has been released.
+  struct Region {
+    CLObj<cl_mem> slab;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+  };
+
+  // Suballocation is bounded: requests above kMaxPooledBytes go straight to
+  // the driver, since large buffers are rare and pooling them would mostly
+  // pin memory.
+  static constexpr std::uint64_t kSlabBytes = 32 * 1024 * 1024;
+  static constexpr std::uint64_t kMaxPooledBytes = 8 * 1024 * 1024;
+
+  void Release(const Region& region);
+
+  const std::shared_ptr<DeviceState> device_state_;
+  std::uint64_t min_bytes_;
+  std::mutex mutex_;
+  std::vector<CLObj<cl_mem>> slabs_;
+  std::uint64_t slab_used_ = kSlabBytes;  // Current slab's bump offset; starts "full" so the first request makes a slab
+  std::map<std::uint64_t, std::vector<Region>> free_lists_;  // Size class -> released regions
+};
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
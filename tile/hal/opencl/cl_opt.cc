@@ -1,7 +1,15 @@
 #include "tile/hal/opencl/cl_opt.h"
 
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/util/env.h"
 #include "tile/lang/exprtype.h"
 #include "tile/lang/sembuilder.h"
+#include "tile/lang/semprinter.h"
 
 namespace vertexai {
 namespace tile {
@@ -147,11 +155,507 @@ class InsnOptimizer : public sem::Visitor {
   lang::Scope<sem::Type>* scope_;
 };
 
+// Widens innermost unit-stride loops so each iteration moves several elements
+// through vloadn/vstoren instead of one scalar access at a time. vloadn and
+// vstoren only require their pointer to be aligned to the *element* size, so
+// unit-stride accesses are always legal to widen regardless of the refinement
+// offsets; no alignment guards are needed. A loop qualifies when its body is
+// straight-line declares and stores whose subscript offsets are affine in the
+// loop variable, every widened access has stride exactly one, and nothing
+// reads the raw loop variable as a value.
+class Vectorizer : public sem::Visitor {
+ public:
+  explicit Vectorizer(uint64_t width) : width_{width} {}
+
+  void Visit(const sem::IntConst& node) override {}
+
+  void Visit(const sem::FloatConst& node) override {}
+
+  void Visit(const sem::LookupLVal& node) override {}
+
+  void Visit(const sem::LoadExpr& node) override {}
+
+  void Visit(const sem::StoreStmt& node) override {}
+
+  void Visit(const sem::SubscriptLVal& node) override {}
+
+  void Visit(const sem::DeclareStmt& node) override { scope_->Bind(node.name, node.type); }
+
+  void Visit(const sem::UnaryExpr& node) override {}
+
+  void Visit(const sem::BinaryExpr& node) override {}
+
+  void Visit(const sem::CondExpr& node) override {}
+
+  void Visit(const sem::SelectExpr& node) override {}
+
+  void Visit(const sem::ClampExpr& node) override {}
+
+  void Visit(const sem::CastExpr& node) override {}
+
+  void Visit(const sem::CallExpr& node) override {}
+
+  void Visit(const sem::LimitConst& node) override {}
+
+  void Visit(const sem::IndexExpr& node) override {}
+
+  void Visit(const sem::Block& node) override {
+    WithScope([&]() {
+      for (const auto& stmt : node.statements) {
+        EvalStmt(stmt);
+      }
+    });
+  }
+
+  void Visit(const sem::IfStmt& node) override {
+    if (node.iftrue) {
+      EvalStmt(node.iftrue);
+    }
+    if (node.iffalse) {
+      EvalStmt(node.iffalse);
+    }
+  }
+
+  void Visit(const sem::ForStmt& node) override {
+    WithScope([&]() {
+      scope_->Bind(node.var, sem::Type{sem::Type::INDEX});
+      EvalStmt(node.inner);
+      TryWiden(const_cast<sem::ForStmt&>(node));
+    });
+  }
+
+  void Visit(const sem::WhileStmt& node) override {
+    WithScope([&]() { EvalStmt(node.inner); });
+  }
+
+  void Visit(const sem::BarrierStmt& node) override {}
+
+  void Visit(const sem::ReturnStmt& node) override {}
+
+  void Visit(const sem::SpecialStmt& node) override {}
+
+  void Visit(const sem::Function& node) override {
+    lang::Scope<sem::Type> scope;
+    scope_ = &scope;
+    for (const auto& p : node.params) {
+      scope.Bind(p.second, p.first);
+    }
+    EvalStmt(node.body);
+  }
+
+ private:
+  void WithScope(std::function<void()> fn) {
+    auto previous_scope = scope_;
+    lang::Scope<sem::Type> scope{scope_};
+    scope_ = &scope;
+    fn();
+    scope_ = previous_scope;
+  }
+
+  void EvalStmt(const sem::StmtPtr& stmt) { stmt->Accept(*this); }
+
+  void TryWiden(sem::ForStmt& loop) {
+    auto body = std::dynamic_pointer_cast<sem::Block>(loop.inner);
+    if (!body || loop.step != 1) {
+      return;
+    }
+    for (uint64_t width = width_; width > 1; width /= 2) {
+      if (loop.num % width == 0 && WidenLoop(&loop, *body, width)) {
+        return;
+      }
+    }
+  }
+
+  bool WidenLoop(sem::ForStmt* loop, const sem::Block& body, uint64_t width) {
+    var_ = loop->var;
+    width_attempt_ = width;
+    coeffs_.clear();
+    vec_temps_.clear();
+    stored_offsets_.clear();
+    widened_ = false;
+
+    // First pass: check that the body is straight-line declares and stores,
+    // record the offsets written through each buffer (so loads can be
+    // checked for cross-lane dependences), and pick up any loop-carried
+    // increments ("off = off + c") that strength reduction left behind.
+    std::set<std::string> local_values;
+    std::set<std::string> local_indexes;
+    for (const auto& stmt : body.statements) {
+      if (auto decl = std::dynamic_pointer_cast<sem::DeclareStmt>(stmt)) {
+        if (decl->type.array || decl->type.vec_width != 1) {
+          return false;
+        }
+        if (decl->type.base == sem::Type::INDEX) {
+          local_indexes.insert(decl->name);
+        } else if (decl->type.base == sem::Type::VALUE) {
+          local_values.insert(decl->name);
+        } else {
+          return false;
+        }
+      } else if (auto store = std::dynamic_pointer_cast<sem::StoreStmt>(stmt)) {
+        if (auto lhs = std::dynamic_pointer_cast<sem::LookupLVal>(store->lhs)) {
+          if (local_values.count(lhs->name)) {
+            continue;  // Redefinition of a widened temporary; rewritten below.
+          }
+          int64_t delta;
+          if (local_indexes.count(lhs->name) || !MatchIncrement(*store, lhs->name, &delta) ||
+              coeffs_.count(lhs->name)) {
+            return false;
+          }
+          coeffs_[lhs->name] = delta;
+        } else if (auto lhs = std::dynamic_pointer_cast<sem::SubscriptLVal>(store->lhs)) {
+          auto buf = std::dynamic_pointer_cast<sem::LookupLVal>(lhs->ptr);
+          if (!buf) {
+            return false;
+          }
+          auto& offsets = stored_offsets_[buf->name];
+          offsets.insert(sem::Print(*lhs->offset).str());
+          if (offsets.size() > 1) {
+            // Two distinct store offsets into one buffer; the lanes of the
+            // two stores could overlap, so leave the loop alone.
+            return false;
+          }
+        } else {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+
+    // Second pass: rebuild the body. Index declarations keep their scalar
+    // form (the loop variable now holds the lane-0 value), value
+    // declarations become vector temporaries, and qualifying subscript
+    // accesses turn into vloadn/vstoren.
+    std::vector<sem::StmtPtr> stmts;
+    for (const auto& stmt : body.statements) {
+      if (auto decl = std::dynamic_pointer_cast<sem::DeclareStmt>(stmt)) {
+        if (decl->type.base == sem::Type::INDEX) {
+          int64_t coeff;
+          if (decl->init.get() == nullptr || !Stride(decl->init, &coeff)) {
+            return false;
+          }
+          coeffs_[decl->name] = coeff;
+          stmts.push_back(stmt);
+        } else {
+          sem::ExprPtr init;
+          if (decl->init) {
+            init = Widen(decl->init);
+            if (init.get() == nullptr) {
+              return false;
+            }
+          }
+          auto ty = decl->type;
+          ty.vec_width = width;
+          vec_temps_.insert(decl->name);
+          stmts.push_back(std::make_shared<sem::DeclareStmt>(ty, decl->name, init));
+        }
+        continue;
+      }
+      auto store = std::static_pointer_cast<sem::StoreStmt>(stmt);
+      if (auto lhs = std::dynamic_pointer_cast<sem::LookupLVal>(store->lhs)) {
+        if (vec_temps_.count(lhs->name)) {
+          auto rhs = Widen(store->rhs);
+          if (rhs.get() == nullptr) {
+            return false;
+          }
+          stmts.push_back(std::make_shared<sem::StoreStmt>(store->lhs, rhs));
+        } else {
+          // A carried increment advances once per iteration; scale it to
+          // the widened step.
+          auto delta = coeffs_.at(lhs->name) * static_cast<int64_t>(width);
+          auto rhs = std::make_shared<sem::BinaryExpr>("+", std::make_shared<sem::LoadExpr>(store->lhs),
+                                                       sem::builder::_Const(delta));
+          stmts.push_back(std::make_shared<sem::StoreStmt>(store->lhs, rhs));
+        }
+        continue;
+      }
+      auto lhs = std::static_pointer_cast<sem::SubscriptLVal>(store->lhs);
+      auto buf = std::static_pointer_cast<sem::LookupLVal>(lhs->ptr);
+      sem::Type elem;
+      int64_t coeff;
+      if (!ElementType(buf->name, &elem) || !Stride(lhs->offset, &coeff) || coeff != 1) {
+        return false;
+      }
+      auto rhs = Widen(store->rhs);
+      if (rhs.get() == nullptr) {
+        return false;
+      }
+      // Materialize the stored value so the usual declare-time conversions
+      // apply, then write all lanes at once.
+      elem.vec_width = width;
+      auto tmp = var_ + "_w" + std::to_string(next_tmp_++);
+      stmts.push_back(std::make_shared<sem::DeclareStmt>(elem, tmp, rhs));
+      auto ptr = std::make_shared<sem::BinaryExpr>("+", std::make_shared<sem::LoadExpr>(lhs->ptr), lhs->offset);
+      std::vector<sem::ExprPtr> params = {std::make_shared<sem::LoadExpr>(std::make_shared<sem::LookupLVal>(tmp)),
+                                          sem::builder::_Const(0), ptr};
+      stmts.push_back(std::make_shared<sem::SpecialStmt>("vstore" + std::to_string(width), params));
+      widened_ = true;
+    }
+    if (!widened_) {
+      return false;
+    }
+    loop->inner = std::make_shared<sem::Block>(stmts);
+    loop->num /= width;
+    loop->step = width;
+    return true;
+  }
+
+  // Matches "name = name + <int>" (either operand order), the carried
+  // increment form strength reduction produces.
+  bool MatchIncrement(const sem::StoreStmt& store, const std::string& name, int64_t* delta) {
+    auto add = std::dynamic_pointer_cast<sem::BinaryExpr>(store.rhs);
+    if (add.get() == nullptr || add->op != "+") {
+      return false;
+    }
+    auto match = [&](const sem::ExprPtr& lhs, const sem::ExprPtr& rhs) {
+      auto load = std::dynamic_pointer_cast<sem::LoadExpr>(lhs);
+      if (load.get() == nullptr) {
+        return false;
+      }
+      auto lookup = std::dynamic_pointer_cast<sem::LookupLVal>(load->inner);
+      auto value = std::dynamic_pointer_cast<sem::IntConst>(rhs);
+      if (!lookup || lookup->name != name || value.get() == nullptr) {
+        return false;
+      }
+      *delta = value->value;
+      return true;
+    };
+    return match(add->lhs, add->rhs) || match(add->rhs, add->lhs);
+  }
+
+  // Looks up a buffer and extracts its scalar element type. Half floats are
+  // left alone: the emitter already rewrites their loads and stores.
+  bool ElementType(const std::string& name, sem::Type* elem) {
+    auto ty = scope_->Lookup(name);
+    if (!ty || (ty->base != sem::Type::POINTER_MUT && ty->base != sem::Type::POINTER_CONST)) {
+      return false;
+    }
+    if (ty->vec_width != 1 || ty->dtype == DataType::BOOLEAN || ty->dtype == DataType::FLOAT16) {
+      return false;
+    }
+    *elem = sem::Type{sem::Type::VALUE, ty->dtype};
+    return true;
+  }
+
+  // Determines how much expr advances when the loop variable advances by
+  // one; fails when the expression isn't affine in the loop variable.
+  bool Stride(const sem::ExprPtr& expr, int64_t* coeff) {
+    if (std::dynamic_pointer_cast<sem::IntConst>(expr) ||       //
+        std::dynamic_pointer_cast<sem::LimitConst>(expr) ||     //
+        std::dynamic_pointer_cast<sem::IndexExpr>(expr)) {
+      *coeff = 0;
+      return true;
+    }
+    if (auto load = std::dynamic_pointer_cast<sem::LoadExpr>(expr)) {
+      auto lookup = std::dynamic_pointer_cast<sem::LookupLVal>(load->inner);
+      if (!lookup || vec_temps_.count(lookup->name)) {
+        return false;
+      }
+      if (lookup->name == var_) {
+        *coeff = 1;
+        return true;
+      }
+      auto it = coeffs_.find(lookup->name);
+      *coeff = it == coeffs_.end() ? 0 : it->second;
+      return true;
+    }
+    if (auto unary = std::dynamic_pointer_cast<sem::UnaryExpr>(expr)) {
+      if (unary->op != "-" && unary->op != "+") {
+        return false;
+      }
+      if (!Stride(unary->inner, coeff)) {
+        return false;
+      }
+      if (unary->op == "-") {
+        *coeff = -*coeff;
+      }
+      return true;
+    }
+    if (auto cast = std::dynamic_pointer_cast<sem::CastExpr>(expr)) {
+      return Stride(cast->val, coeff);
+    }
+    if (auto binary = std::dynamic_pointer_cast<sem::BinaryExpr>(expr)) {
+      int64_t lhs;
+      int64_t rhs;
+      if (!Stride(binary->lhs, &lhs) || !Stride(binary->rhs, &rhs)) {
+        return false;
+      }
+      if (binary->op == "+") {
+        *coeff = lhs + rhs;
+        return true;
+      }
+      if (binary->op == "-") {
+        *coeff = lhs - rhs;
+        return true;
+      }
+      if (binary->op == "*") {
+        if (lhs == 0 && rhs == 0) {
+          *coeff = 0;
+          return true;
+        }
+        if (auto value = std::dynamic_pointer_cast<sem::IntConst>(binary->lhs)) {
+          *coeff = value->value * rhs;
+          return true;
+        }
+        if (auto value = std::dynamic_pointer_cast<sem::IntConst>(binary->rhs)) {
+          *coeff = value->value * lhs;
+          return true;
+        }
+        return false;
+      }
+      if ((binary->op == "/" || binary->op == "%") && lhs == 0 && rhs == 0) {
+        *coeff = 0;
+        return true;
+      }
+      return false;
+    }
+    return false;
+  }
+
+  // Rewrites a value expression for the widened loop, or returns nullptr if
+  // it can't be done. Scalars broadcast across the lanes implicitly, so
+  // loop-invariant subexpressions pass through untouched.
+  sem::ExprPtr Widen(const sem::ExprPtr& expr) {
+    if (std::dynamic_pointer_cast<sem::IntConst>(expr) ||    //
+        std::dynamic_pointer_cast<sem::FloatConst>(expr) ||  //
+        std::dynamic_pointer_cast<sem::LimitConst>(expr) ||  //
+        std::dynamic_pointer_cast<sem::IndexExpr>(expr)) {
+      return expr;
+    }
+    if (auto load = std::dynamic_pointer_cast<sem::LoadExpr>(expr)) {
+      if (auto sub = std::dynamic_pointer_cast<sem::SubscriptLVal>(load->inner)) {
+        auto buf = std::dynamic_pointer_cast<sem::LookupLVal>(sub->ptr);
+        sem::Type elem;
+        int64_t coeff;
+        if (!buf || !ElementType(buf->name, &elem) || !Stride(sub->offset, &coeff)) {
+          return nullptr;
+        }
+        auto stored = stored_offsets_.find(buf->name);
+        if (stored != stored_offsets_.end() && !stored->second.count(sem::Print(*sub->offset).str())) {
+          // The loop also stores through this buffer at a different offset;
+          // lanes could read elements another lane just wrote.
+          return nullptr;
+        }
+        if (coeff == 0) {
+          return expr;
+        }
+        if (coeff != 1) {
+          return nullptr;
+        }
+        using namespace sem::builder;  // NOLINT
+        auto ptr = std::make_shared<sem::BinaryExpr>("+", std::make_shared<sem::LoadExpr>(sub->ptr), sub->offset);
+        widened_ = true;
+        return _("vload" + std::to_string(width_attempt_))(_Const(0), ptr);
+      }
+      if (auto lookup = std::dynamic_pointer_cast<sem::LookupLVal>(load->inner)) {
+        if (lookup->name == var_) {
+          return nullptr;  // The raw index differs per lane.
+        }
+        auto it = coeffs_.find(lookup->name);
+        if (it != coeffs_.end() && it->second != 0) {
+          return nullptr;
+        }
+        return expr;  // An invariant scalar or an already-widened temporary.
+      }
+      return nullptr;
+    }
+    if (auto unary = std::dynamic_pointer_cast<sem::UnaryExpr>(expr)) {
+      auto inner = Widen(unary->inner);
+      if (inner.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::UnaryExpr>(unary->op, inner);
+    }
+    if (auto binary = std::dynamic_pointer_cast<sem::BinaryExpr>(expr)) {
+      auto lhs = Widen(binary->lhs);
+      auto rhs = Widen(binary->rhs);
+      if (lhs.get() == nullptr || rhs.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::BinaryExpr>(binary->op, lhs, rhs);
+    }
+    if (auto cond = std::dynamic_pointer_cast<sem::CondExpr>(expr)) {
+      auto c = Widen(cond->cond);
+      auto t = Widen(cond->tcase);
+      auto f = Widen(cond->fcase);
+      if (c.get() == nullptr || t.get() == nullptr || f.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::CondExpr>(c, t, f, cond->type);
+    }
+    if (auto select = std::dynamic_pointer_cast<sem::SelectExpr>(expr)) {
+      auto c = Widen(select->cond);
+      auto t = Widen(select->tcase);
+      auto f = Widen(select->fcase);
+      if (c.get() == nullptr || t.get() == nullptr || f.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::SelectExpr>(c, t, f, select->type);
+    }
+    if (auto clamp = std::dynamic_pointer_cast<sem::ClampExpr>(expr)) {
+      auto val = Widen(clamp->val);
+      auto min = Widen(clamp->min);
+      auto max = Widen(clamp->max);
+      if (val.get() == nullptr || min.get() == nullptr || max.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::ClampExpr>(val, min, max);
+    }
+    if (auto cast = std::dynamic_pointer_cast<sem::CastExpr>(expr)) {
+      auto val = Widen(cast->val);
+      if (val.get() == nullptr) {
+        return nullptr;
+      }
+      return std::make_shared<sem::CastExpr>(cast->type, val);
+    }
+    if (auto call = std::dynamic_pointer_cast<sem::CallExpr>(expr)) {
+      // The math builtins all operate lane-wise on vectors.
+      auto copy = std::make_shared<sem::CallExpr>(*call);
+      for (auto& val : copy->vals) {
+        val = Widen(val);
+        if (val.get() == nullptr) {
+          return nullptr;
+        }
+      }
+      return copy;
+    }
+    return nullptr;
+  }
+
+ private:
+  uint64_t width_;
+  lang::Scope<sem::Type>* scope_;
+  // Per-attempt rewrite state.
+  uint64_t width_attempt_ = 0;
+  std::string var_;
+  std::map<std::string, int64_t> coeffs_;
+  std::set<std::string> vec_temps_;
+  std::map<std::string, std::set<std::string>> stored_offsets_;
+  bool widened_ = false;
+  size_t next_tmp_ = 0;
+};
+
+// The widest vloadn/vstoren to attempt. Defaults to the hardware vector
+// size; PLAIDML_OPENCL_VLOAD_WIDTH overrides it in either direction.
+uint64_t VectorWidth(const hal::proto::HardwareSettings& settings) {
+  auto override_width = env::Get("PLAIDML_OPENCL_VLOAD_WIDTH");
+  if (!override_width.empty()) {
+    return std::atoi(override_width.c_str());
+  }
+  return settings.vec_size();
+}
+
 }  // namespace
 
 void OptimizeKernel(const lang::KernelInfo& ki, bool cl_khr_fp16, const hal::proto::HardwareSettings& settings) {
   InsnOptimizer opt(cl_khr_fp16, settings);
   ki.kfunc->Accept(opt);
+  auto width = VectorWidth(settings);
+  if (width > 1) {
+    Vectorizer vec(width);
+    ki.kfunc->Accept(vec);
+  }
 }
 
 }  // namespace opencl
@@ -3,14 +3,19 @@
 #include "tile/hal/opencl/compiler.h"
 
 #include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
+#include <boost/uuid/uuid_io.hpp>
 #include <boost/bind.hpp>
 #include <boost/asio.hpp>
 
@@ -23,6 +28,7 @@
 #include "tile/hal/opencl/cl_opt.h"
 #include "tile/hal/opencl/emitocl.h"
 #include "tile/hal/opencl/library.h"
+#include "tile/hal/opencl/occupancy.h"
 #include "tile/lang/semprinter.h"
 
 namespace fs = boost::filesystem;
@@ -33,16 +39,60 @@ namespace hal {
 namespace opencl {
 namespace {
 
+// Process-wide cache of built cl_program objects, keyed by the emitted
+// kernel source under the owning cl_context (program objects are
+// context-bound).  Multi-model deployments emit many byte-identical
+// kernels across separate Programs; handing out the already-built program
+// skips both the rebuild and the duplicate device code memory.  Set
+// PLAIDML_OPENCL_SHARE_KERNELS=0 to disable.
+class KernelRepo {
+ public:
+  static KernelRepo* Instance() {
+    static KernelRepo repo;
+    return &repo;
+  }
+
+  CLObj<cl_program> Lookup(cl_context ctx, const std::string& src) {
+    if (!enabled_) {
+      return CLObj<cl_program>();
+    }
+    std::lock_guard<std::mutex> lock{mu_};
+    auto& table = tables_[ctx];
+    auto it = table.find(src);
+    if (it == table.end()) {
+      return CLObj<cl_program>();
+    }
+    return it->second;
+  }
+
+  void Insert(cl_context ctx, const std::string& src, const CLObj<cl_program>& program) {
+    if (!enabled_) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock{mu_};
+    tables_[ctx].emplace(src, program);
+  }
+
+ private:
+  KernelRepo() : enabled_{env::Get("PLAIDML_OPENCL_SHARE_KERNELS") != "0"} {}
+
+  bool enabled_;
+  std::mutex mu_;
+  std::map<cl_context, std::unordered_map<std::string, CLObj<cl_program>>> tables_;
+};
+
 struct BuildState;
 
 // Represents a build-in-flight
 class Build {
  public:
-  Build(context::Activity activity, const std::shared_ptr<DeviceState>& device_state, 
+  Build(context::Activity activity, const std::shared_ptr<DeviceState>& device_state,
         const std::map<std::string, CLObj<cl_program>>& program,
         const std::vector<lang::KernelInfo>& kernel_info,
         const std::map<std::string, proto::BuildInfo>& binfo,
-        std::vector<context::proto::ActivityID> kernel_ids);
+        std::vector<context::proto::ActivityID> kernel_ids,
+        std::map<std::string, fs::path> binary_paths,
+        std::set<std::string> prebuilt);
 
   boost::future<std::unique_ptr<hal::Library>> Start();
   std::unique_ptr<Library>& library() { return library_; }
@@ -58,6 +108,12 @@ class Build {
   std::unique_ptr<Library> library_;
   boost::promise<std::unique_ptr<hal::Library>> prom_;
   std::map<std::string, proto::BuildInfo> binfo_;
+  // Programs built from source whose device binaries should be written to
+  // the on-disk cache once the build succeeds.
+  std::map<std::string, fs::path> binary_paths_;
+  // Programs taken already-built from the process-wide KernelRepo; these
+  // skip compilation entirely.
+  std::set<std::string> prebuilt_;
 };
 
 struct BuildState {
@@ -94,6 +150,9 @@ boost::future<std::unique_ptr<hal::Library>> Build::Start() {
   auto& program_map = library_->program();
   clock_t build_start = clock();
   for (auto& prog_it : program_map) {
+    if (prebuilt_.count(prog_it.first)) {
+      continue;
+    }
     auto bs = std::make_shared<BuildState>(this, prog_it.first);
     io_service.post(boost::bind(&(Build::CompileKernel), bs));
   }
@@ -119,11 +178,15 @@ Build::Build(context::Activity activity, const std::shared_ptr<DeviceState>& dev
              const std::map<std::string, CLObj<cl_program>>& program,
              const std::vector<lang::KernelInfo>& kernel_info,
              const std::map<std::string, proto::BuildInfo>& binfo,
-             std::vector<context::proto::ActivityID> kernel_ids)
+             std::vector<context::proto::ActivityID> kernel_ids,
+             std::map<std::string, fs::path> binary_paths,
+             std::set<std::string> prebuilt)
     : activity_{std::move(activity)},
       device_state_{device_state},
       library_{std::make_unique<Library>(device_state, std::move(program), kernel_info, std::move(kernel_ids))},
-      binfo_{std::move(binfo)} {}
+      binfo_{std::move(binfo)},
+      binary_paths_{std::move(binary_paths)},
+      prebuilt_{std::move(prebuilt)} {}
 
 void Build::OnBuildComplete(cl_program program, void* handle) noexcept {
   BuildState* build_state = static_cast<BuildState *>(handle);
@@ -142,6 +205,39 @@ void Build::OnBuildComplete(cl_program program, void* handle) noexcept {
       LOG(WARNING) << "Failed to build program " << build_state->current;
       build->binfo_[build_state->current].set_cl_build_status(status);
       build->OnError(build_state->current);
+    } else {
+      // Publish the built program so later Programs emitting the same
+      // kernel source reuse it instead of rebuilding.
+      auto prog_it = build->library()->program().find(build_state->current);
+      KernelRepo::Instance()->Insert(build->device_state()->cl_ctx().get(),
+                                     build->binfo_[build_state->current].src(), prog_it->second);
+    }
+    auto path_it = build->binary_paths_.find(build_state->current);
+    if (path_it != build->binary_paths_.end()) {
+      // Built from source with the binary cache enabled: save the device
+      // binary so later processes skip this build entirely.
+      auto prog_it = build->library()->program().find(build_state->current);
+      std::size_t size;
+      Err::Check(ocl::GetProgramInfo(prog_it->second.get(), CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, nullptr),
+                 "Unable to compute binary size for " + build_state->current);
+      std::string binary;
+      binary.resize(size);
+      const char* datum = binary.data();
+      Err::Check(ocl::GetProgramInfo(prog_it->second.get(), CL_PROGRAM_BINARIES, sizeof(datum), &datum, nullptr),
+                 "Unable to serialize binary for " + build_state->current);
+      VLOG(1) << "Writing OpenCL binary to cache: " << path_it->second;
+      // Write via a uniquely-named temp file and rename so a concurrent
+      // process never observes a torn binary; rename within a directory is
+      // atomic on the filesystems we care about.
+      auto tmp_path = path_it->second;
+      tmp_path += "." + to_string(GetRandomUUID()) + ".tmp";
+      WriteFile(tmp_path, binary, /* binary = */ true);
+      boost::system::error_code ec;
+      fs::rename(tmp_path, path_it->second, ec);
+      if (ec) {
+        LOG(WARNING) << "Unable to publish cached OpenCL binary " << path_it->second << ": " << ec.message();
+        fs::remove(tmp_path, ec);
+      }
     }
     build->activity_.AddMetadata(build->binfo_[build_state->current]);
   } catch (...) {
@@ -228,6 +324,11 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
     header << k_subgroup_microkernels;
   }
 
+  bool cl_khr_subgroups = device_state_->HasDeviceExtension("cl_khr_subgroups");
+  if (cl_khr_subgroups) {
+    header << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+  }
+
   auto env_cache = env::Get("PLAIDML_OPENCL_CACHE");
   fs::path cache_dir;
   if (env_cache.length()) {
@@ -238,6 +339,8 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
 
   std::map<std::string, CLObj<cl_program>> program_map;
   std::map<std::string, proto::BuildInfo> binfo_map;
+  std::map<std::string, fs::path> binary_paths;
+  std::set<std::string> prebuilt;
 
   for (const auto& ki : kernel_info) {
     std::ostringstream code;
@@ -293,10 +396,70 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
         fs::path src_path = (out_path / ki.kname).replace_extension("cl");
         WriteFile(src_path, code.str());
       }
-      Err err;
-      CLObj<cl_program> program = ocl::CreateProgramWithSource(device_state_->cl_ctx().get(), 1, &buf, nullptr, err.ptr());
+      CLObj<cl_program> program = KernelRepo::Instance()->Lookup(device_state_->cl_ctx().get(), code.str());
+      fs::path bin_path;
+      if (program) {
+        VLOG(1) << "Sharing already-built OpenCL program for " << ki.kname;
+        prebuilt.insert(ki.kname);
+      } else if (is_directory(cache_dir)) {
+        // Try the program binary cache before paying for a source build.
+        // The key covers the full source and the device's identity and
+        // driver version, so a stale or foreign binary never loads.
+        auto key = std::hash<std::string>{}(device_state_->info().SerializeAsString() + code.str());
+        bin_path = cache_dir / (ki.kname + "_" + std::to_string(key) + ".clbin");
+        if (fs::is_regular_file(bin_path)) {
+          auto binary = ReadFile(bin_path, /* binary = */ true);
+          const unsigned char* data = reinterpret_cast<const unsigned char*>(binary.data());
+          size_t length = binary.size();
+          cl_device_id did = device_state_->did();
+          cl_int binary_status = CL_SUCCESS;
+          Err bin_err;
+          program = ocl::CreateProgramWithBinary(device_state_->cl_ctx().get(), 1, &did, &length, &data,
+                                                 &binary_status, bin_err.ptr());
+          if (program && binary_status == CL_SUCCESS) {
+            VLOG(1) << "Reading OpenCL binary from cache: " << bin_path;
+          } else {
+            VLOG(1) << "Ignoring unusable cached OpenCL binary: " << bin_path;
+            program = CLObj<cl_program>();
+          }
+        }
+      }
+      if (!program && is_directory(cache_dir) && device_state_->SupportsProgramIL()) {
+        // An offline-compiled SPIR-V module alongside the cached source lets
+        // us hand the driver IL and skip its OpenCL C frontend, which
+        // dominates build time on some drivers.  Missing or rejected IL just
+        // falls through to the source build.
+        fs::path il_path = (cache_dir / ki.kname).replace_extension("spv");
+        if (fs::is_regular_file(il_path)) {
+          auto il = ReadFile(il_path, /* binary = */ true);
+          try {
+            Err il_err;
+            program = ocl::CreateProgramWithIL(device_state_->cl_ctx().get(), il.data(), il.size(), il_err.ptr());
+            if (program) {
+              VLOG(1) << "Reading SPIR-V IL from cache: " << il_path;
+            } else {
+              LOG(WARNING) << "Unable to create program from SPIR-V IL " << il_path << ": " << il_err;
+            }
+          } catch (const ocl::ApiUnavailable& ex) {
+            LOG(WARNING) << "Device reports IL support but the loader lacks clCreateProgramWithIL; "
+                         << "building from source instead";
+          }
+          if (program && !bin_path.empty()) {
+            // Cache the resulting device binary too, so later runs skip even
+            // the IL ingestion.
+            binary_paths.emplace(ki.kname, bin_path);
+          }
+        }
+      }
       if (!program) {
-        throw std::runtime_error(std::string("Creating an OpenCL program object for ") + ki.kname + ": " + err.str());
+        Err err;
+        program = ocl::CreateProgramWithSource(device_state_->cl_ctx().get(), 1, &buf, nullptr, err.ptr());
+        if (!program) {
+          throw std::runtime_error(std::string("Creating an OpenCL program object for ") + ki.kname + ": " + err.str());
+        }
+        if (!bin_path.empty()) {
+          binary_paths.emplace(ki.kname, bin_path);
+        }
       }
       program_map.emplace(ki.kname, std::move(program));
       binfo_map.emplace(ki.kname, std::move(binfo));
@@ -305,11 +468,20 @@ boost::future<std::unique_ptr<hal::Library>> Compiler::Build(const context::Cont
     }
 
     *(kinfo.mutable_kinfo()) = ki.info;
+    if (ki.ktype == lang::KernelType::kFunction) {
+      // Audit the launch shape against the device limits and attach the
+      // verdict, so underfilled kernels show up in the profiling stream
+      // without vendor tooling.
+      auto occupancy = AnalyzeOccupancy(ki, settings, device_state_->info());
+      WarnLowOccupancy(ki.kname, occupancy);
+      *(kinfo.mutable_kinfo()->mutable_occupancy()) = std::move(occupancy);
+    }
     kbuild.AddMetadata(kinfo);
 
     kernel_ids.emplace_back(kbuild.ctx().activity_id());
   }
-  opencl::Build build(std::move(activity), device_state_, std::move(program_map), kernel_info, std::move(binfo_map), std::move(kernel_ids));
+  opencl::Build build(std::move(activity), device_state_, std::move(program_map), kernel_info, std::move(binfo_map),
+                      std::move(kernel_ids), std::move(binary_paths), std::move(prebuilt));
   return build.Start();
 }
 
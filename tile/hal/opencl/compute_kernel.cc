@@ -2,12 +2,16 @@
 
 #include "tile/hal/opencl/compute_kernel.h"
 
+#include <memory>
+#include <sstream>
 #include <utility>
 
 #include "base/util/error.h"
+#include "base/util/perf_counter.h"
 #include "base/util/uuid.h"
 #include "tile/hal/opencl/buffer.h"
 #include "tile/hal/opencl/event.h"
+#include "tile/hal/opencl/local_size_tuner.h"
 #include "tile/hal/opencl/result.h"
 
 namespace vertexai {
@@ -15,9 +19,47 @@ namespace tile {
 namespace hal {
 namespace opencl {
 
+static PerfCounter kernel_launches("opencl_kernel_launches");
+
+namespace {
+
+// User data for the tuning completion callback: which sweep measurement
+// this dispatch was.
+struct TuneReport {
+  std::string key;
+  LocalSizeTuner::Size size;
+};
+
+// Reads the dispatch's profiling span once it completes and reports it to
+// the tuner.  Runs on a driver thread; the event is valid for the duration
+// of the callback.
+void CL_CALLBACK OnTunedKernelComplete(cl_event event, cl_int status, void* user_data) {
+  std::unique_ptr<TuneReport> report{static_cast<TuneReport*>(user_data)};
+  if (status != CL_COMPLETE) {
+    return;
+  }
+  cl_ulong start_time = 0;
+  cl_ulong end_time = 0;
+  if (ocl::GetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start_time), &start_time, nullptr) !=
+          CL_SUCCESS ||
+      ocl::GetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end_time), &end_time, nullptr) != CL_SUCCESS) {
+    return;
+  }
+  LocalSizeTuner::Instance()->Report(report->key, report->size, static_cast<int64_t>(end_time - start_time));
+}
+
+}  // namespace
+
 ComputeKernel::ComputeKernel(const std::shared_ptr<DeviceState>& device_state, CLObj<cl_kernel> kernel,
                              const lang::KernelInfo& info, context::proto::ActivityID kernel_id)
     : device_state_{device_state}, kernel_{std::move(kernel)}, ki_(info), kernel_id_(kernel_id) {
+  if (LocalSizeTuner::Enabled()) {
+    size_t work_group_size = 0;
+    if (ocl::GetKernelWorkGroupInfo(kernel_.get(), device_state_->did(), CL_KERNEL_WORK_GROUP_SIZE,
+                                    sizeof(work_group_size), &work_group_size, nullptr) == CL_SUCCESS) {
+      max_group_size_ = work_group_size;
+    }
+  }
   if (VLOG_IS_ON(3)) {
     size_t work_group_size;
     Err::Check(ocl::GetKernelWorkGroupInfo(kernel_.get(), device_state_->did(), CL_KERNEL_WORK_GROUP_SIZE,
@@ -57,7 +99,22 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
                                                const std::vector<std::shared_ptr<hal::Buffer>>& params,
                                                const std::vector<std::shared_ptr<hal::Event>>& dependencies,
                                                bool enable_profiling) {
-  const auto& queue = device_state_->cl_queue(enable_profiling);
+  // When tuning is enabled, the tuner picks this dispatch's local size;
+  // sweep measurements run on the profiling queue so their spans can be
+  // read regardless of the caller's profiling setting.
+  lang::GridSize lwork = ki_.lwork;
+  bool measuring = false;
+  std::string tune_key;
+  if (LocalSizeTuner::Enabled() && ki_.lwork[0] && max_group_size_) {
+    std::ostringstream key;
+    key << ki_.key << "/" << ki_.gwork[0] << "x" << ki_.gwork[1] << "x" << ki_.gwork[2];
+    tune_key = key.str();
+    std::tie(lwork, measuring) = LocalSizeTuner::Instance()->Choose(
+        tune_key, LocalSizeTuner::Size{{ki_.gwork[0], ki_.gwork[1], ki_.gwork[2]}},
+        LocalSizeTuner::Size{{ki_.lwork[0], ki_.lwork[1], ki_.lwork[2]}}, max_group_size_);
+  }
+
+  const auto& queue = device_state_->cl_queue(enable_profiling || measuring);
   auto deps = Event::Downcast(dependencies, device_state_->cl_ctx(), queue);
   VLOG(4) << "Running kernel " << ki_.kname;
 
@@ -82,7 +139,7 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
     activity.AddMetadata(rinfo);
   }
   CLObj<cl_event> done;
-  auto local_work_size = ki_.lwork[0] ? ki_.lwork.data() : nullptr;
+  auto local_work_size = lwork[0] ? lwork.data() : nullptr;
   auto event_wait_list = deps.size() ? deps.data() : nullptr;
   IVLOG(4, "Running kernel,  gwork = " << ki_.gwork << ", lwork = " << (local_work_size ? local_work_size[0] : 0));
   Err err = ocl::EnqueueNDRangeKernel(queue.cl_queue.get(),  // command_queue
@@ -95,6 +152,16 @@ std::shared_ptr<hal::Event> ComputeKernel::Run(const context::Context& ctx,
                                       event_wait_list,       // event_wait_list
                                       done.LvaluePtr());     // event
   Err::Check(err, "unable to run OpenCL kernel " + ki_.kname);
+  kernel_launches.inc();
+
+  if (measuring && done) {
+    auto report = std::make_unique<TuneReport>();
+    report->key = tune_key;
+    report->size = LocalSizeTuner::Size{{lwork[0], lwork[1], lwork[2]}};
+    if (ocl::SetEventCallback(done.get(), CL_COMPLETE, OnTunedKernelComplete, report.get()) == CL_SUCCESS) {
+      report.release();
+    }
+  }
 
   VLOG(4) << "  Produced dep: " << done.get();
 
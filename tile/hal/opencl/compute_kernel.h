@@ -31,6 +31,9 @@ class ComputeKernel final : public Kernel {
   CLObj<cl_kernel> kernel_;
   lang::KernelInfo ki_;
   context::proto::ActivityID kernel_id_;
+  // The device's work-group size limit for this kernel; only read (and used)
+  // when local-size tuning is enabled.  See LocalSizeTuner.
+  std::size_t max_group_size_ = 0;
 };
 
 }  // namespace opencl
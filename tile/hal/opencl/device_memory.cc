@@ -4,6 +4,7 @@
 
 #include <utility>
 
+#include "base/util/env.h"
 #include "tile/hal/opencl/cl_mem_arena.h"
 #include "tile/hal/opencl/cl_mem_buffer.h"
 
@@ -12,9 +13,23 @@ namespace tile {
 namespace hal {
 namespace opencl {
 
-DeviceMemory::DeviceMemory(const std::shared_ptr<DeviceState>& device_state) : device_state_{device_state} {}
+DeviceMemory::DeviceMemory(const std::shared_ptr<DeviceState>& device_state) : device_state_{device_state} {
+  // Small allocations are suballocated from pooled slabs by default; each
+  // standalone clCreateBuffer is a driver round trip and fragments the
+  // driver-side heap.  Set PLAIDML_OPENCL_BUFFER_POOL=0 to always allocate
+  // standalone buffers.
+  if (env::Get("PLAIDML_OPENCL_BUFFER_POOL") != "0") {
+    pool_ = std::make_shared<CLMemPool>(device_state, device_state->info().mem_base_addr_align());
+  }
+}
 
 std::shared_ptr<hal::Buffer> DeviceMemory::MakeBuffer(std::uint64_t size, BufferAccessMask /* access */) {
+  if (pool_) {
+    auto buffer = pool_->MakeBuffer(size);
+    if (buffer) {
+      return buffer;
+    }
+  }
   Err err;
   CLObj<cl_mem> mem = ocl::CreateBuffer(device_state_->cl_ctx().get(), CL_MEM_READ_WRITE, size, nullptr, err.ptr());
   Err::Check(err, "Unable to allocate device-local memory");
@@ -6,6 +6,7 @@
 #include <memory>
 
 #include "tile/base/hal.h"
+#include "tile/hal/opencl/cl_mem_pool.h"
 #include "tile/hal/opencl/device_state.h"
 #include "tile/hal/opencl/ocl.h"
 
@@ -30,6 +31,7 @@ class DeviceMemory final : public Memory {
 
  private:
   std::shared_ptr<DeviceState> device_state_;
+  std::shared_ptr<CLMemPool> pool_;
 };
 
 }  // namespace opencl
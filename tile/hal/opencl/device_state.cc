@@ -2,10 +2,12 @@
 
 #include "tile/hal/opencl/device_state.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/util/env.h"
 #include "base/util/error.h"
 #include "tile/hal/opencl/info.h"
 #include "tile/hal/util/selector.h"
@@ -16,6 +18,9 @@ namespace hal {
 namespace opencl {
 namespace {
 
+// Default number of queues kernel launches rotate across.
+constexpr std::size_t kDefaultQueueCount = 4;
+
 DeviceState::Queue MakeQueue(cl_device_id did, const CLObj<cl_context>& cl_ctx,
                              const hal::proto::HardwareSettings& settings,
                              cl_command_queue_properties extra_properties = 0) {
@@ -50,12 +55,25 @@ DeviceState::DeviceState(const context::Context& ctx, const CLObj<cl_context>& c
     : did_{did}, info_{std::move(info)}, cl_ctx_{cl_ctx}, clock_{}, id_{ctx.activity_id()} {}
 
 void DeviceState::Initialize(const hal::proto::HardwareSettings& settings) {
-  cl_normal_queue_ = std::make_unique<Queue>(MakeQueue(did_, cl_ctx_, settings));
+  // A pool of queues lets independent kernels execute concurrently on
+  // devices with spare capacity; cross-queue ordering comes from event wait
+  // lists.  Synchronous configs keep a single queue, and
+  // PLAIDML_OPENCL_QUEUES overrides the pool size.
+  std::size_t num_queues = settings.is_synchronous() ? 1 : kDefaultQueueCount;
+  auto queues_env = env::Get("PLAIDML_OPENCL_QUEUES");
+  if (!queues_env.empty()) {
+    num_queues = std::max(1, std::atoi(queues_env.c_str()));
+  }
+  for (std::size_t i = 0; i < num_queues; ++i) {
+    cl_normal_queues_.emplace_back(std::make_unique<Queue>(MakeQueue(did_, cl_ctx_, settings)));
+  }
   cl_profiling_queue_ = std::make_unique<Queue>(MakeQueue(did_, cl_ctx_, settings, CL_QUEUE_PROFILING_ENABLE));
 }
 
 void DeviceState::FlushCommandQueue() {
-  cl_normal_queue_->Flush();
+  for (const auto& queue : cl_normal_queues_) {
+    queue->Flush();
+  }
   cl_profiling_queue_->Flush();
 }
 
@@ -68,6 +86,16 @@ bool DeviceState::HasDeviceExtension(const char* extension) {
   return false;
 }
 
+bool DeviceState::SupportsProgramIL() {
+  if (HasDeviceExtension("cl_khr_il_program")) {
+    return true;
+  }
+  // Core as of OpenCL 2.1; some 2.1+ drivers omit the extension string.
+  const auto& version = info_.version();
+  return version.compare(0, 10, "OpenCL 2.1") == 0 || version.compare(0, 10, "OpenCL 2.2") == 0 ||
+         version.compare(0, 8, "OpenCL 3") == 0;
+}
+
 cl_map_flags DeviceState::map_discard_flags() const {
   // TODO: parse this string out into different parts and then check major/minor directly
   if (info_.version() == "OpenCL 1.1 ") {
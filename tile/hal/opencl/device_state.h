@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "base/context/context.h"
 #include "tile/hal/opencl/ocl.h"
@@ -31,13 +33,20 @@ class DeviceState {
   const cl_device_id did() const { return did_; }
   const CLObj<cl_context>& cl_ctx() const { return cl_ctx_; }
   const proto::DeviceInfo& info() const { return info_; }
-  const Queue& cl_normal_queue() const { return *cl_normal_queue_; }
+  const Queue& cl_normal_queue() const { return *cl_normal_queues_.front(); }
   const Queue& cl_profiling_queue() const { return *cl_profiling_queue_; }
+
+  // Returns the queue the next kernel launch should use.  Launches rotate
+  // across the queue pool, so schedule steps with no dependency between them
+  // can execute concurrently; ordering between steps on different queues is
+  // preserved by their event wait lists (see Event::Downcast).
+  const Queue& cl_kernel_queue() const { return *cl_normal_queues_[next_queue_++ % cl_normal_queues_.size()]; }
+
   const Queue& cl_queue(bool enable_profiling) const {
     if (enable_profiling) {
       return cl_profiling_queue();
     }
-    return cl_normal_queue();
+    return cl_kernel_queue();
   }
   const context::Clock& clock() const { return clock_; }
   const context::proto::ActivityID& id() const { return id_; }
@@ -48,12 +57,17 @@ class DeviceState {
 
   bool HasDeviceExtension(const char* extension);
 
+  // Whether the device can take intermediate-language (SPIR-V) programs via
+  // clCreateProgramWithIL, either as OpenCL 2.1+ core or via cl_khr_il_program.
+  bool SupportsProgramIL();
+
  private:
   const cl_device_id did_;
   const proto::DeviceInfo info_;
   const CLObj<cl_context> cl_ctx_;
-  std::unique_ptr<const Queue> cl_normal_queue_;
+  std::vector<std::unique_ptr<const Queue>> cl_normal_queues_;
   std::unique_ptr<const Queue> cl_profiling_queue_;
+  mutable std::atomic<std::size_t> next_queue_{0};
   const context::Clock clock_;
   const context::proto::ActivityID id_;
 };
@@ -3,6 +3,7 @@
 #include "tile/hal/opencl/emitocl.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <map>
 #include <utility>
@@ -19,6 +20,104 @@ namespace opencl {
 static std::map<std::string, std::string> FuncNameMap = {
     {"recip", "native_recip"}, {"exp", "native_exp"}, {"log", "native_log"}, {"sqrt", "native_sqrt"}};
 
+namespace {
+
+// A literal must recur at least this often before it's worth a pool slot; a
+// handful of immediates is cheaper than a constant-cache load.
+constexpr size_t kMinConstPoolUses = 4;
+
+// Counts the occurrences of each float literal in a kernel, so repeated
+// constants (e.g. a quantization scale applied at every use site) can be
+// pooled instead of re-materialized as immediates throughout the ISA.
+class FloatConstCounter final : public sem::Visitor {
+ public:
+  const std::map<double, size_t>& counts() const { return counts_; }
+
+  void Visit(const sem::IntConst& n) final {}
+  void Visit(const sem::FloatConst& n) final { counts_[n.value]++; }
+  void Visit(const sem::LookupLVal& n) final {}
+  void Visit(const sem::LoadExpr& n) final { n.inner->Accept(*this); }
+  void Visit(const sem::StoreStmt& n) final {
+    n.lhs->Accept(*this);
+    n.rhs->Accept(*this);
+  }
+  void Visit(const sem::SubscriptLVal& n) final {
+    n.ptr->Accept(*this);
+    n.offset->Accept(*this);
+  }
+  void Visit(const sem::DeclareStmt& n) final {
+    if (n.init) {
+      n.init->Accept(*this);
+    }
+  }
+  void Visit(const sem::UnaryExpr& n) final { n.inner->Accept(*this); }
+  void Visit(const sem::BinaryExpr& n) final {
+    n.lhs->Accept(*this);
+    n.rhs->Accept(*this);
+  }
+  void Visit(const sem::CondExpr& n) final {
+    n.cond->Accept(*this);
+    n.tcase->Accept(*this);
+    n.fcase->Accept(*this);
+  }
+  void Visit(const sem::SelectExpr& n) final {
+    n.cond->Accept(*this);
+    n.tcase->Accept(*this);
+    n.fcase->Accept(*this);
+  }
+  void Visit(const sem::ClampExpr& n) final {
+    n.val->Accept(*this);
+    n.min->Accept(*this);
+    n.max->Accept(*this);
+  }
+  void Visit(const sem::CastExpr& n) final { n.val->Accept(*this); }
+  void Visit(const sem::CallExpr& n) final {
+    for (const auto& val : n.vals) {
+      val->Accept(*this);
+    }
+  }
+  void Visit(const sem::LimitConst& n) final {}
+  void Visit(const sem::IndexExpr& n) final {}
+  void Visit(const sem::Block& n) final {
+    for (const auto& stmt : n.statements) {
+      stmt->Accept(*this);
+    }
+  }
+  void Visit(const sem::IfStmt& n) final {
+    if (n.cond) {
+      n.cond->Accept(*this);
+    }
+    if (n.iftrue) {
+      n.iftrue->Accept(*this);
+    }
+    if (n.iffalse) {
+      n.iffalse->Accept(*this);
+    }
+  }
+  void Visit(const sem::ForStmt& n) final { n.inner->Accept(*this); }
+  void Visit(const sem::WhileStmt& n) final {
+    n.cond->Accept(*this);
+    n.inner->Accept(*this);
+  }
+  void Visit(const sem::BarrierStmt& n) final {}
+  void Visit(const sem::ReturnStmt& n) final {
+    if (n.value) {
+      n.value->Accept(*this);
+    }
+  }
+  void Visit(const sem::SpecialStmt& n) final {
+    for (const auto& param : n.params) {
+      param->Accept(*this);
+    }
+  }
+  void Visit(const sem::Function& n) final { n.body->Accept(*this); }
+
+ private:
+  std::map<double, size_t> counts_;
+};
+
+}  // namespace
+
 void Emit::Visit(const sem::LoadExpr& n) {
   auto ty = TypeOf(n.inner);
   auto inner = std::dynamic_pointer_cast<sem::SubscriptLVal>(n.inner);
@@ -251,6 +350,15 @@ void Emit::Visit(const sem::IndexExpr& n) {
     case sem::IndexExpr::LOCAL:
       emit("get_local_id(" + std::to_string(n.dim) + ")");
       break;
+    case sem::IndexExpr::SUBGROUP:
+      emit("get_sub_group_id()");
+      break;
+    case sem::IndexExpr::SUBGROUP_LOCAL:
+      emit("get_sub_group_local_id()");
+      break;
+    case sem::IndexExpr::NUM_SUBGROUPS:
+      emit("get_num_sub_groups()");
+      break;
     default:
       throw std::runtime_error("Invalid IndexExpr type");
   }
@@ -282,7 +390,49 @@ void Emit::Visit(const sem::BarrierStmt& n) {
   }
 }
 
+void Emit::Visit(const sem::FloatConst& n) {
+  auto it = const_pool_.find(n.value);
+  if (it != const_pool_.end()) {
+    emit(const_pool_name_ + "[" + std::to_string(it->second) + "]");
+    return;
+  }
+  EmitC::Visit(n);
+}
+
+void Emit::SetupConstPool(const sem::Function& fn) {
+  const_pool_.clear();
+  const_pool_name_ = fn.name + "_cpool";
+
+  FloatConstCounter counter;
+  fn.Accept(counter);
+  for (const auto& kvp : counter.counts()) {
+    // Non-finite values have no literal spelling to pool.
+    if (kvp.second >= kMinConstPoolUses && std::isfinite(kvp.first)) {
+      size_t idx = const_pool_.size();
+      const_pool_.emplace(kvp.first, idx);
+    }
+  }
+  if (const_pool_.empty()) {
+    return;
+  }
+
+  // FloatConst always emits as a single-precision literal, so a float pool
+  // is exactly type-equivalent to the immediates it replaces.
+  emit("__constant float " + const_pool_name_ + "[" + std::to_string(const_pool_.size()) + "] = {");
+  bool first = true;
+  for (const auto& kvp : const_pool_) {
+    if (!first) {
+      emit(", ");
+    }
+    first = false;
+    // N.B. The qualified call emits the literal itself, bypassing the pool.
+    EmitC::Visit(sem::FloatConst{kvp.first});
+  }
+  emit("};\n");
+}
+
 void Emit::Visit(const sem::Function& n) {
+  SetupConstPool(n);
   if (n.subgroup_size) {
     emit("__attribute__((intel_reqd_sub_group_size(" + std::to_string(n.subgroup_size) + ")))");
   }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -18,6 +19,7 @@ class Emit : public lang::EmitC {
   explicit Emit(bool cl_khr_fp16, bool cl_khr_fp64)
       : cl_khr_fp16_{cl_khr_fp16}, cl_khr_fp64_{cl_khr_fp64}, scope_{nullptr} {}
 
+  void Visit(const sem::FloatConst&) final;
   void Visit(const sem::LoadExpr&) final;
   void Visit(const sem::StoreStmt&) final;
   void Visit(const sem::DeclareStmt&) final;
@@ -43,9 +45,16 @@ class Emit : public lang::EmitC {
                                bool force_conversion = false);
   void emitType(const sem::Type& t) final;
 
+  // Deduplicates the function's repeated float literals into a per-kernel
+  // __constant array, emitted ahead of the kernel; uses then index the array
+  // instead of re-materializing the immediate.  See Visit(sem::FloatConst).
+  void SetupConstPool(const sem::Function& fn);
+
   bool cl_khr_fp16_;
   bool cl_khr_fp64_;
   lang::Scope<sem::Type>* scope_;
+  std::map<double, size_t> const_pool_;
+  std::string const_pool_name_;
 };
 
 }  // namespace opencl
@@ -7,6 +7,7 @@
 
 #include "base/util/compat.h"
 #include "base/util/error.h"
+#include "base/util/perf_counter.h"
 #include "tile/hal/opencl/buffer.h"
 #include "tile/hal/opencl/compute_kernel.h"
 #include "tile/hal/opencl/device_memory.h"
@@ -23,6 +24,8 @@ namespace tile {
 namespace hal {
 namespace opencl {
 
+static PerfCounter bytes_transferred("opencl_bytes_transferred");
+
 Executor::Executor(const std::shared_ptr<DeviceState>& device_state)
     : device_state_{device_state}, info_{GetHardwareInfo(device_state->info())} {
   InitSharedMemory();
@@ -49,6 +52,7 @@ std::shared_ptr<hal::Event> Executor::Copy(const context::Context& ctx, const st
   }
 
   context::Activity activity{ctx, "tile::hal::opencl::Copy"};
+  bytes_transferred.add(length);
 
   auto from_base = from_buf->base();
   auto from_ptr = from_buf->mem();
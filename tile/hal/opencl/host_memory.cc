@@ -4,6 +4,7 @@
 
 #include <utility>
 
+#include "base/util/env.h"
 #include "tile/hal/opencl/cl_mem_arena.h"
 #include "tile/hal/opencl/cl_mem_buffer.h"
 
@@ -12,14 +13,81 @@ namespace tile {
 namespace hal {
 namespace opencl {
 
-HostMemory::HostMemory(const std::shared_ptr<DeviceState>& device_state) : device_state_{device_state} {}
+namespace {
 
-std::shared_ptr<hal::Buffer> HostMemory::MakeBuffer(std::uint64_t size, BufferAccessMask /* access */) {
+// Allocations below this size skip the pool; pinning small buffers is cheap
+// relative to the transfer, and pooling them would fragment pinned memory.
+constexpr std::uint64_t kPoolThreshold = 64 * std::kilo::num;
+
+// The pool stops retaining returned allocations past this total; pinned
+// memory is a scarce, unswappable system resource.
+constexpr std::uint64_t kMaxPooledBytes = 256 * std::mega::num;
+
+bool PoolEnabled() { return env::Get("PLAIDML_OPENCL_PINNED_POOL") != "0"; }
+
+CLObj<cl_mem> MakePinned(const std::shared_ptr<DeviceState>& device_state, std::uint64_t size) {
   Err err;
-  CLObj<cl_mem> mem = ocl::CreateBuffer(device_state_->cl_ctx().get(), CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size,
+  CLObj<cl_mem> mem = ocl::CreateBuffer(device_state->cl_ctx().get(), CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size,
                                         nullptr, err.ptr());
   Err::Check(err, "Unable to allocate host-local memory");
-  return std::make_shared<CLMemBuffer>(device_state_, size, std::move(mem));
+  return mem;
+}
+
+}  // namespace
+
+PinnedMemoryPool::PinnedMemoryPool(const std::shared_ptr<DeviceState>& device_state) : device_state_{device_state} {}
+
+std::uint64_t PinnedMemoryPool::AllocSize(std::uint64_t size) {
+  std::uint64_t alloc_size = kPoolThreshold;
+  while (alloc_size < size) {
+    alloc_size <<= 1;
+  }
+  return alloc_size;
+}
+
+CLObj<cl_mem> PinnedMemoryPool::Alloc(std::uint64_t size) {
+  auto alloc_size = AllocSize(size);
+  {
+    std::lock_guard<std::mutex> lock{mu_};
+    auto it = free_.find(alloc_size);
+    if (it != free_.end() && !it->second.empty()) {
+      CLObj<cl_mem> mem = std::move(it->second.back());
+      it->second.pop_back();
+      pooled_bytes_ -= alloc_size;
+      return mem;
+    }
+  }
+  return MakePinned(device_state_, alloc_size);
+}
+
+void PinnedMemoryPool::Free(std::uint64_t alloc_size, CLObj<cl_mem> mem) {
+  std::lock_guard<std::mutex> lock{mu_};
+  if (pooled_bytes_ + alloc_size > kMaxPooledBytes) {
+    return;  // Dropping `mem` releases the allocation
+  }
+  pooled_bytes_ += alloc_size;
+  free_[alloc_size].emplace_back(std::move(mem));
+}
+
+HostMemory::HostMemory(const std::shared_ptr<DeviceState>& device_state)
+    : device_state_{device_state}, pool_{std::make_shared<PinnedMemoryPool>(device_state)} {}
+
+std::shared_ptr<hal::Buffer> HostMemory::MakeBuffer(std::uint64_t size, BufferAccessMask /* access */) {
+  if (size < kPoolThreshold || !PoolEnabled()) {
+    return std::make_shared<CLMemBuffer>(device_state_, size, MakePinned(device_state_, size));
+  }
+  // Staging transfers dominate for large buffers, so draw those from the
+  // pinned pool; the release of the returned buffer recycles the allocation
+  // rather than unpinning it.
+  auto alloc_size = PinnedMemoryPool::AllocSize(size);
+  CLObj<cl_mem> mem = pool_->Alloc(size);
+  CLObj<cl_mem> retained = mem;
+  auto pool = pool_;
+  return std::shared_ptr<CLMemBuffer>(new CLMemBuffer(device_state_, size, std::move(mem)),
+                                      [pool, retained, alloc_size](CLMemBuffer* buf) mutable {
+                                        delete buf;
+                                        pool->Free(alloc_size, std::move(retained));
+                                      });
 }
 
 std::shared_ptr<hal::Arena> HostMemory::MakeArena(std::uint64_t size, BufferAccessMask /* access */) {
@@ -3,7 +3,10 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "tile/base/hal.h"
 #include "tile/hal/opencl/device_state.h"
@@ -14,6 +17,34 @@ namespace tile {
 namespace hal {
 namespace opencl {
 
+// A pool of pinned (CL_MEM_ALLOC_HOST_PTR) staging allocations, segregated
+// into power-of-two size classes.  Pinning is expensive and unpinned
+// transfers run at a fraction of PCIe bandwidth on discrete devices, so
+// staging buffers above a size threshold are drawn from here and returned on
+// release instead of being created and pinned ad hoc per allocation.
+class PinnedMemoryPool {
+ public:
+  explicit PinnedMemoryPool(const std::shared_ptr<DeviceState>& device_state);
+
+  // The number of bytes actually allocated for a request of the given size:
+  // the containing power-of-two size class.
+  static std::uint64_t AllocSize(std::uint64_t size);
+
+  // Returns a pinned allocation of AllocSize(size) bytes, reusing a pooled
+  // one when available.
+  CLObj<cl_mem> Alloc(std::uint64_t size);
+  // Returns an allocation to the pool (or releases it, if the pool is at
+  // capacity).  alloc_size must be the AllocSize() the allocation was made
+  // with.
+  void Free(std::uint64_t alloc_size, CLObj<cl_mem> mem);
+
+ private:
+  const std::shared_ptr<DeviceState> device_state_;
+  std::mutex mu_;
+  std::map<std::uint64_t, std::vector<CLObj<cl_mem>>> free_;  // keyed by class size
+  std::uint64_t pooled_bytes_ = 0;
+};
+
 class HostMemory final : public Memory {
  public:
   explicit HostMemory(const std::shared_ptr<DeviceState>& device_state);
@@ -33,6 +64,7 @@ class HostMemory final : public Memory {
 
  private:
   std::shared_ptr<DeviceState> device_state_;
+  std::shared_ptr<PinnedMemoryPool> pool_;
 };
 
 }  // namespace opencl
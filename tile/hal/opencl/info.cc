@@ -91,6 +91,13 @@ hal::proto::HardwareInfo GetHardwareInfo(const proto::DeviceInfo& info) {
   // Enable input/output buffer aliasing by default.  This may be overridden.
   settings->set_disable_io_aliasing(false);
 
+  // Lower reductions via subgroup shuffles when the device supports them.
+  for (const auto& ext : info.extension()) {
+    if (ext == "cl_khr_subgroups") {
+      settings->set_subgroup_reduce(true);
+    }
+  }
+
   return result;
 }
 
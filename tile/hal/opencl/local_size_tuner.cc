@@ -0,0 +1,166 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/hal/opencl/local_size_tuner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+namespace {
+
+// Bounds the sweep so a kernel settles within a reasonable number of runs.
+constexpr std::size_t kMaxCandidates = 16;
+
+// Local sizes must divide the global work size exactly; divisors above the
+// device's work-group limit can never be part of a legal size.
+std::vector<std::size_t> Divisors(std::size_t n, std::size_t limit) {
+  std::vector<std::size_t> divs;
+  for (std::size_t d = 1; d <= n && d <= limit; d++) {
+    if (n % d == 0) {
+      divs.push_back(d);
+    }
+  }
+  return divs;
+}
+
+}  // namespace
+
+bool LocalSizeTuner::Enabled() {
+  static bool enabled = env::Get("PLAIDML_LOCAL_SIZE_TUNE") == "1";
+  return enabled;
+}
+
+LocalSizeTuner* LocalSizeTuner::Instance() {
+  static LocalSizeTuner tuner(env::Get("PLAIDML_LOCAL_SIZE_CACHE"));
+  return &tuner;
+}
+
+LocalSizeTuner::LocalSizeTuner(const std::string& filename) : filename_(filename) {
+  if (!filename_.empty()) {
+    Load();
+  }
+}
+
+LocalSizeTuner::State& LocalSizeTuner::GetState(const std::string& key, const Size& gwork, const Size& dflt,
+                                                std::size_t max_group) {
+  auto it = states_.find(key);
+  if (it != states_.end()) {
+    return it->second;
+  }
+  State& state = states_[key];
+  state.candidates.push_back(dflt);
+  // Letting the driver pick is often what the vendor tuned for, so it's
+  // always in the sweep.
+  state.candidates.push_back(Size{{0, 0, 0}});
+  // The rest are divisor triples of the global work size, preferring larger
+  // work-groups (and so warp/wavefront-multiple widths) first.
+  std::vector<Size> triples;
+  for (std::size_t l0 : Divisors(gwork[0], max_group)) {
+    for (std::size_t l1 : Divisors(gwork[1], max_group)) {
+      if (l0 * l1 > max_group) {
+        break;
+      }
+      for (std::size_t l2 : Divisors(gwork[2], max_group)) {
+        if (l0 * l1 * l2 > max_group) {
+          break;
+        }
+        Size size = {{l0, l1, l2}};
+        if (size != dflt) {
+          triples.push_back(size);
+        }
+      }
+    }
+  }
+  std::stable_sort(triples.begin(), triples.end(),
+                   [](const Size& a, const Size& b) { return a[0] * a[1] * a[2] > b[0] * b[1] * b[2]; });
+  for (const auto& size : triples) {
+    if (state.candidates.size() >= kMaxCandidates) {
+      break;
+    }
+    state.candidates.push_back(size);
+  }
+  return state;
+}
+
+std::pair<LocalSizeTuner::Size, bool> LocalSizeTuner::Choose(const std::string& key, const Size& gwork,
+                                                             const Size& dflt, std::size_t max_group) {
+  std::lock_guard<std::mutex> lock{mu_};
+  State& state = GetState(key, gwork, dflt, max_group);
+  if (state.done) {
+    return {state.best, false};
+  }
+  if (state.next >= state.candidates.size()) {
+    // The sweep finished but nothing reported (profiling unavailable);
+    // fall back to the compile-time size permanently.
+    state.best = state.best_ns >= 0 ? state.best : dflt;
+    state.done = true;
+    Save();
+    return {state.best, false};
+  }
+  return {state.candidates[state.next++], true};
+}
+
+void LocalSizeTuner::Report(const std::string& key, const Size& size, int64_t duration_ns) {
+  if (duration_ns <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{mu_};
+  auto it = states_.find(key);
+  if (it == states_.end() || it->second.done) {
+    return;
+  }
+  State& state = it->second;
+  if (state.best_ns < 0 || duration_ns < state.best_ns) {
+    state.best_ns = duration_ns;
+    state.best = size;
+  }
+  if (state.next >= state.candidates.size()) {
+    state.done = true;
+    IVLOG(2, "LocalSizeTuner: " << key << " -> " << state.best[0] << "x" << state.best[1] << "x" << state.best[2]
+                                << " (" << state.best_ns << " ns)");
+    Save();
+  }
+}
+
+void LocalSizeTuner::Load() {
+  std::ifstream file(filename_);
+  if (!file) {
+    return;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    State state;
+    if (ss >> key >> state.best[0] >> state.best[1] >> state.best[2] >> state.best_ns) {
+      state.done = true;
+      states_.emplace(key, std::move(state));
+    }
+  }
+}
+
+void LocalSizeTuner::Save() {
+  if (filename_.empty()) {
+    return;
+  }
+  std::ofstream file(filename_, std::ios::trunc);
+  for (const auto& kvp : states_) {
+    if (kvp.second.done && kvp.second.best_ns >= 0) {
+      file << kvp.first << " " << kvp.second.best[0] << " " << kvp.second.best[1] << " " << kvp.second.best[2] << " "
+           << kvp.second.best_ns << "\n";
+    }
+  }
+}
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,75 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+// Picks the local work size used to dispatch a kernel.  Tile planning fixes
+// local sizes at compile time from the cost model, but drivers often prefer
+// a different geometry than the model predicts; the tuner sweeps candidate
+// sizes consistent with the kernel's global work size over its first runs,
+// timing each dispatch via the queue's profiling events, and settles on the
+// fastest.  Results are keyed by the kernel's canonical key plus its work
+// space and persisted to the file named by PLAIDML_LOCAL_SIZE_CACHE (when
+// set) -- the same measure-once-and-remember approach lang::TileCache takes
+// for tile shapes -- so later processes start already tuned.  Enable with
+// PLAIDML_LOCAL_SIZE_TUNE=1; off by default, since the sweep perturbs a
+// kernel's first dispatches.
+class LocalSizeTuner {
+ public:
+  // A local size triple; all zeros means the driver chooses.
+  using Size = std::array<std::size_t, 3>;
+
+  // Whether PLAIDML_LOCAL_SIZE_TUNE enables tuning for this process.
+  static bool Enabled();
+
+  // Gets the singleton instance, loading PLAIDML_LOCAL_SIZE_CACHE if set.
+  static LocalSizeTuner* Instance();
+
+  explicit LocalSizeTuner(const std::string& filename = "");
+
+  // Returns the local size for this dispatch and whether it is a sweep
+  // measurement the caller should profile and Report.  The recorded best is
+  // returned once the sweep is complete; while it runs, the next untried
+  // candidate.  The compile-time size is always the first candidate, so an
+  // interrupted sweep never performs worse than the static plan did.
+  // max_group bounds the work-group size per the kernel's device limit.
+  std::pair<Size, bool> Choose(const std::string& key, const Size& gwork, const Size& dflt, std::size_t max_group);
+
+  // Records the measured duration of a dispatch using the size that Choose
+  // returned for this key.
+  void Report(const std::string& key, const Size& size, int64_t duration_ns);
+
+ private:
+  struct State {
+    std::vector<Size> candidates;
+    std::size_t next = 0;
+    Size best = {{0, 0, 0}};
+    int64_t best_ns = -1;
+    bool done = false;
+  };
+
+  State& GetState(const std::string& key, const Size& gwork, const Size& dflt, std::size_t max_group);
+  void Load();
+  void Save();
+
+  std::mutex mu_;
+  std::string filename_;
+  std::map<std::string, State> states_;
+};
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,104 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/hal/opencl/occupancy.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+namespace {
+
+// Devices stop scheduling further work-groups onto a compute unit well
+// before resources run out; 16 resident groups is a typical architectural
+// ceiling and keeps the estimate from claiming a tiny kernel fills a unit.
+constexpr uint64_t kMaxResidentGroups = 16;
+
+}  // namespace
+
+lang::proto::OccupancyInfo AnalyzeOccupancy(const lang::KernelInfo& ki,                  //
+                                            const hal::proto::HardwareSettings& settings,  //
+                                            const proto::DeviceInfo& info) {
+  lang::proto::OccupancyInfo result;
+  uint64_t wg_size = ki.lwork[0] * ki.lwork[1] * ki.lwork[2];
+  uint64_t workgroups = 1;
+  for (size_t i = 0; i < 3; i++) {
+    workgroups *= ki.gwork[i] / std::max<size_t>(ki.lwork[i], 1);
+  }
+  const auto& perf = ki.info.perf_stats();
+  result.set_workgroup_size(wg_size);
+  result.set_workgroups(workgroups);
+  result.set_local_mem_bytes(perf.shared_mem());
+  result.set_reg_bytes(perf.out_regs());
+
+  uint64_t max_wg = info.max_work_group_size() ? info.max_work_group_size() : settings.threads();
+  if (!max_wg || !wg_size) {
+    // A builtin (zero/copy) kernel or a device that reports no limits;
+    // nothing meaningful to audit.
+    result.set_occupancy(1.0);
+    return result;
+  }
+
+  // How many work-groups can be resident on one compute unit at once, bound
+  // by each resource in turn; the tightest bound names the limiter.
+  uint64_t resident = std::max<uint64_t>(max_wg / wg_size, 1);
+  std::string limiter = "workgroup_size";
+  if (resident > kMaxResidentGroups) {
+    resident = kMaxResidentGroups;
+    limiter = "resident_groups";
+  }
+  if (settings.max_mem() && perf.shared_mem()) {
+    uint64_t by_lmem = settings.max_mem() / perf.shared_mem();
+    if (by_lmem < resident) {
+      resident = by_lmem;
+      limiter = "local_mem";
+    }
+  }
+  if (settings.max_regs() && perf.out_regs()) {
+    uint64_t by_regs = settings.max_regs() / perf.out_regs();
+    if (by_regs < resident) {
+      resident = by_regs;
+      limiter = "registers";
+    }
+  }
+
+  // Per-unit occupancy: the fraction of the unit's thread capacity the
+  // resident work-groups can cover.
+  double unit_occ = std::min(1.0, static_cast<double>(resident * wg_size) / static_cast<double>(max_wg));
+  // Launch occupancy: whether there are enough work-groups to reach the
+  // device's full-occupancy point at all (goal_groups when the settings
+  // provide one, otherwise one group per compute unit).
+  uint64_t goal = settings.goal_groups() ? settings.goal_groups() : std::max<uint32_t>(info.max_compute_units(), 1);
+  double launch_occ = std::min(1.0, static_cast<double>(workgroups) / static_cast<double>(goal));
+  if (launch_occ < unit_occ) {
+    limiter = "workgroup_count";
+  }
+  result.set_occupancy(std::min(unit_occ, launch_occ));
+  result.set_limiter(limiter);
+  return result;
+}
+
+void WarnLowOccupancy(const std::string& kname, const lang::proto::OccupancyInfo& occupancy) {
+  static double threshold = [] {
+    auto value = env::Get("PLAIDML_OCCUPANCY_WARN");
+    return value.empty() ? 0.0 : std::stod(value);
+  }();
+  if (threshold <= 0.0 || occupancy.occupancy() >= threshold) {
+    return;
+  }
+  LOG(WARNING) << "Kernel " << kname << " estimated occupancy " << occupancy.occupancy()  //
+               << " (limited by " << occupancy.limiter() << "): wg_size=" << occupancy.workgroup_size()
+               << " workgroups=" << occupancy.workgroups() << " local_mem=" << occupancy.local_mem_bytes()
+               << "B regs=" << occupancy.reg_bytes() << "B";
+}
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,33 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <string>
+
+#include "tile/hal/opencl/opencl.pb.h"
+#include "tile/lang/generate.h"
+#include "tile/proto/hal.pb.h"
+
+namespace vertexai {
+namespace tile {
+namespace hal {
+namespace opencl {
+
+// Computes the theoretical occupancy of a generated kernel on the device it
+// is being built for: how full the device's compute units can run given the
+// kernel's work-group size, local memory use, and estimated register
+// footprint, and whether the launch has enough work-groups to fill the
+// device at all.  The verdict names the limiting resource so an underfilled
+// kernel can be traced to a tiling decision without vendor tooling.
+lang::proto::OccupancyInfo AnalyzeOccupancy(const lang::KernelInfo& ki,                  //
+                                            const hal::proto::HardwareSettings& settings,  //
+                                            const proto::DeviceInfo& info);
+
+// Logs kernels whose estimated occupancy falls below the threshold set by
+// PLAIDML_OCCUPANCY_WARN (a fraction in [0, 1]; unset or 0 disables).
+void WarnLowOccupancy(const std::string& kname, const lang::proto::OccupancyInfo& occupancy);
+
+}  // namespace opencl
+}  // namespace hal
+}  // namespace tile
+}  // namespace vertexai
@@ -9,7 +9,9 @@
 #include "base/util/compat.h"
 #include "base/util/env.h"
 #include "base/util/error.h"
+#include "tile/base/kernel_profile.h"
 #include "tile/lang/semprinter.h"
+#include "tile/lang/tile_cache.h"
 
 namespace vertexai {
 namespace tile {
@@ -128,6 +130,16 @@ void KernelResult::LogStatistics() const {
     VLOG(3) << ki_.comments;
     VLOG(1) << "Ran " << ki_.kname << ": dur=" << duration << " GFL/s=" << ki_.tot_flops / duration
             << " GBP/s=" << ki_.tot_bytes / duration;
+    KernelProfile::Instance()->Record(ki_.kname, duration, info_->start_time - info_->queued_time, ki_.tot_bytes);
+    if (!ki_.key.empty()) {
+      // Feed the measured time back to the autotile profile cache; keep only
+      // the best observation per plan so the backing file stays small.
+      auto* cache = lang::TileCache::Instance();
+      auto prior = cache->GetDuration(ki_.key, ki_.settings, ki_.tile.shape);
+      if (prior < 0 || duration < prior) {
+        cache->AddEntry(ki_.key, ki_.settings, ki_.tile.shape, duration);
+      }
+    }
     LogActivity(ctx_, device_state_, *info_);
   }
 }
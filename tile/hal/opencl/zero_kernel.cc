@@ -45,7 +45,13 @@ std::shared_ptr<hal::Event> ZeroKernel::Run(const context::Context& ctx,
   cl_ulong long_pattern = 0;
   void* pattern = &long_pattern;
   size_t pattern_size = sizeof(long_pattern);
-  if (buf->size() % sizeof(long_pattern) != 0) {
+  const std::string& fill = kinfo_.info.zero().fill();
+  if (!fill.empty()) {
+    // Aggregation-identity fill (e.g. -inf for a float max): the pattern
+    // is the little-endian encoding of one element.
+    pattern = const_cast<char*>(fill.data());
+    pattern_size = fill.size();
+  } else if (buf->size() % sizeof(long_pattern) != 0) {
     pattern = &char_pattern;
     pattern_size = sizeof(char_pattern);
   }
@@ -67,6 +67,8 @@ lang::HardwareSettings ToHardwareSettings(const proto::HardwareSettings& setting
   result.goal_flops_per_byte = settings.goal_flops_per_byte();
   result.goal_dimension_sizes = std::move(dim_sizes);
   result.disable_io_aliasing = settings.disable_io_aliasing();
+  result.subgroup_reduce = settings.subgroup_reduce();
+  result.batch_work_limit = settings.batch_work_limit();
 
   return result;
 }
@@ -4,8 +4,11 @@
 
 #include <map>
 #include <memory>
+#include <sstream>
 #include <stack>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <boost/format.hpp>
 
@@ -37,7 +40,17 @@ class ComputeUses : public AstVisitor<void> {
     }
   }
 
-  const std::vector<UseInfo>& uses(const Expr* expr) const { return uses_.at(expr); }
+  const std::vector<UseInfo>& uses(const Expr* expr) const {
+    static const std::vector<UseInfo> kNone;
+    auto it = uses_.find(expr);
+    return it == uses_.end() ? kNone : it->second;
+  }
+
+  const std::vector<ExprPtr>& operands(const Expr* expr) const {
+    static const std::vector<ExprPtr> kNone;
+    auto it = operands_.find(expr);
+    return it == operands_.end() ? kNone : it->second;
+  }
 
  private:
   void Visit(const CallExpr& expr) final {
@@ -71,6 +84,7 @@ class ComputeUses : public AstVisitor<void> {
     IVLOG(4, "ComputeUses::Push> user: " << &user << ", used: " << used << ", idx: " << idx);
     auto ptr = std::const_pointer_cast<Expr>(user.as_ptr());
     uses_[used.get()].emplace_back(UseInfo{ptr, idx});
+    operands_[&user].push_back(used);
     stack_.push(used);
   }
 
@@ -78,15 +92,207 @@ class ComputeUses : public AstVisitor<void> {
   std::stack<ExprPtr> stack_;
   std::unordered_set<const Expr*> seen_;
   std::unordered_map<const Expr*, std::vector<UseInfo>> uses_;
+  std::unordered_map<const Expr*, std::vector<ExprPtr>> operands_;
+};
+
+// Clones forward-pass ops reachable from a derivative reference, stopping at
+// checkpoints, parameters, and constants, so the backward graph recomputes
+// the intermediate activations from the checkpoints instead of keeping every
+// one live until its gradient is consumed.  Clones are memoized, so each
+// rematerialized op is computed once no matter how many derivatives use it.
+class Rematerializer {
+ public:
+  explicit Rematerializer(const std::vector<ExprPtr>& checkpoints) {
+    for (const auto& expr : checkpoints) {
+      stops_.insert(expr.get());
+    }
+  }
+
+  bool enabled() const { return !stops_.empty(); }
+  bool is_clone(const Expr* expr) const { return clones_.count(expr); }
+
+  ExprPtr Remat(const ExprPtr& expr) {
+    if (!enabled() || stops_.count(expr.get())) {
+      return expr;
+    }
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) {
+      return it->second;
+    }
+    ExprPtr result = expr;
+    if (auto call_expr = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      std::vector<ExprPtr> args;
+      args.reserve(call_expr->args.size());
+      for (const auto& arg : call_expr->args) {
+        args.push_back(Remat(arg));
+      }
+      auto clone = std::make_shared<CallExpr>(call_expr->fn, args);
+      clone->name = call_expr->name;
+      clone->shape = call_expr->shape;
+      clones_.insert(clone.get());
+      result = clone;
+    } else if (auto cion_expr = std::dynamic_pointer_cast<ContractionExpr>(expr)) {
+      auto clone = std::make_shared<ContractionExpr>();
+      clone->name = cion_expr->name;
+      clone->shape = cion_expr->shape;
+      clone->agg_op = cion_expr->agg_op;
+      clone->combo_op = cion_expr->combo_op;
+      clone->sink_idxs = cion_expr->sink_idxs;
+      clone->sink_dims = cion_expr->sink_dims;
+      clone->constraints = cion_expr->constraints;
+      clone->no_defract = cion_expr->no_defract;
+      for (const auto& src : cion_expr->srcs) {
+        clone->srcs.push_back(std::make_shared<IndexMapExpr>(Remat(src->ref), src->idxs));
+      }
+      if (cion_expr->use_default) {
+        clone->use_default = Remat(cion_expr->use_default);
+      }
+      clones_.insert(clone.get());
+      result = clone;
+    }
+    // Anything else (parameters, constants, dims) is live regardless, so
+    // reference it directly.
+    memo_.emplace(expr.get(), result);
+    return result;
+  }
+
+ private:
+  std::unordered_set<const Expr*> stops_;
+  std::unordered_set<const Expr*> clones_;
+  std::unordered_map<const Expr*, ExprPtr> memo_;
+};
+
+// Hash-conses an expression DAG: structurally identical calls, contractions,
+// and constants collapse to a single node.  Derivative construction emits one
+// subtree per use of each forward op, so without this the backward graph
+// repeats large subtrees once per fan-out.
+class ExprInterner {
+ public:
+  explicit ExprInterner(const Rematerializer* remat) : remat_{remat} {}
+
+  ExprPtr Intern(const ExprPtr& expr) {
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) {
+      return it->second;
+    }
+    ExprPtr result = expr;
+    // Rematerialized clones are deliberate duplicates of forward ops;
+    // folding them back into the originals would undo the checkpointing.
+    if (!remat_->is_clone(expr.get())) {
+      if (auto int_const = std::dynamic_pointer_cast<IntConst>(expr)) {
+        result = Lookup("int|" + std::to_string(int_const->value), expr);
+      } else if (auto float_const = std::dynamic_pointer_cast<FloatConst>(expr)) {
+        result = Lookup("float|" + std::to_string(float_const->value), expr);
+      } else if (auto call_expr = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        bool changed = false;
+        std::vector<ExprPtr> args;
+        args.reserve(call_expr->args.size());
+        for (const auto& arg : call_expr->args) {
+          args.push_back(Intern(arg));
+          changed |= (args.back() != arg);
+        }
+        if (changed) {
+          auto clone = std::make_shared<CallExpr>(call_expr->fn, args);
+          clone->name = call_expr->name;
+          clone->shape = call_expr->shape;
+          result = clone;
+        }
+        std::ostringstream key;
+        key << "call|" << call_expr->fn;
+        for (const auto& arg : args) {
+          key << "|" << arg.get();
+        }
+        result = Lookup(key.str(), result);
+      } else if (auto cion_expr = std::dynamic_pointer_cast<ContractionExpr>(expr)) {
+        bool changed = false;
+        std::vector<ExprPtr> refs;
+        refs.reserve(cion_expr->srcs.size());
+        for (const auto& src : cion_expr->srcs) {
+          refs.push_back(Intern(src->ref));
+          changed |= (refs.back() != src->ref);
+        }
+        ExprPtr use_default = cion_expr->use_default;
+        if (use_default) {
+          use_default = Intern(use_default);
+          changed |= (use_default != cion_expr->use_default);
+        }
+        if (changed) {
+          auto clone = std::make_shared<ContractionExpr>();
+          clone->name = cion_expr->name;
+          clone->shape = cion_expr->shape;
+          clone->agg_op = cion_expr->agg_op;
+          clone->combo_op = cion_expr->combo_op;
+          clone->sink_idxs = cion_expr->sink_idxs;
+          clone->sink_dims = cion_expr->sink_dims;
+          clone->constraints = cion_expr->constraints;
+          clone->no_defract = cion_expr->no_defract;
+          for (size_t i = 0; i < refs.size(); i++) {
+            clone->srcs.push_back(std::make_shared<IndexMapExpr>(refs[i], cion_expr->srcs[i]->idxs));
+          }
+          clone->use_default = use_default;
+          result = clone;
+        }
+        std::ostringstream key;
+        key << "cion|" << static_cast<int>(cion_expr->agg_op) << "|" << static_cast<int>(cion_expr->combo_op);
+        key << "|" << cion_expr->no_defract;
+        for (size_t i = 0; i < refs.size(); i++) {
+          key << "|" << refs[i].get();
+          for (const auto& idx : cion_expr->srcs[i]->idxs) {
+            key << "," << idx->str();
+          }
+        }
+        key << "|sink";
+        for (const auto& idx : cion_expr->sink_idxs->idxs) {
+          key << "," << idx->str();
+        }
+        for (const auto& dim : cion_expr->sink_dims->dims) {
+          key << ";" << dim->str();
+        }
+        for (const auto& constraint : cion_expr->constraints) {
+          key << "|" << constraint->str();
+        }
+        key << "|" << use_default.get();
+        result = Lookup(key.str(), result);
+      }
+      // Parameters and the remaining node types are interned by identity.
+    }
+    memo_.emplace(expr.get(), result);
+    return result;
+  }
+
+ private:
+  ExprPtr Lookup(const std::string& key, const ExprPtr& expr) {  //
+    return table_.emplace(key, expr).first->second;
+  }
+
+  const Rematerializer* remat_;
+  std::unordered_map<const Expr*, ExprPtr> memo_;
+  std::unordered_map<std::string, ExprPtr> table_;
 };
 
 class Gradient {
  public:
-  explicit Gradient(const ExprPtr& err) : uses_(err) {
+  Gradient(const ExprPtr& err, Rematerializer* remat) : err_(err), uses_(err), remat_(remat) {
     IVLOG(4, "Gradient::Gradient> err: " << err);
     seen_[err.get()] = std::make_shared<FloatConst>(1.0);
   }
 
+  // Computes the derivatives for every expr in `wrts` in one batch: the
+  // subgraph lying between the wrts and the loss is swept once in reverse
+  // topological order (each op after all of its users), so every node's
+  // derivative is finalized exactly once with the derivatives of all its
+  // users already in hand, instead of being pulled recursively per wrt.
+  std::vector<ExprPtr> GetDerivatives(const std::vector<ExprPtr>& wrts) {
+    MarkNeeded(wrts);
+    Sweep();
+    std::vector<ExprPtr> ret(wrts.size());
+    for (size_t i = 0; i < wrts.size(); i++) {
+      ret[i] = GetDerivative(wrts[i]);
+    }
+    return ret;
+  }
+
+ private:
   ExprPtr GetDerivative(const ExprPtr& expr) {
     IVLOG(4, "Gradient::GetDerivative> " << expr);
     auto it = seen_.find(expr.get());
@@ -94,6 +300,59 @@ class Gradient {
       IVLOG(5, "  returning: " << it->second);
       return it->second;
     }
+    // Not covered by the sweep, i.e. the loss makes no use of this expr.
+    return Finalize(expr);
+  }
+
+  // Marks the exprs whose derivatives feed a requested one: the closure of
+  // the wrts under "is used by".  Only these get finalized by the sweep;
+  // forward ops the wrts never flow through are skipped entirely, exactly as
+  // the demand-driven recursion skipped them.
+  void MarkNeeded(const std::vector<ExprPtr>& wrts) {
+    std::stack<const Expr*> stack;
+    for (const auto& wrt : wrts) {
+      stack.push(wrt.get());
+    }
+    while (stack.size()) {
+      auto expr = stack.top();
+      stack.pop();
+      if (needed_.insert(expr).second) {
+        for (const auto& use : uses_.uses(expr)) {
+          stack.push(use.expr.get());
+        }
+      }
+    }
+  }
+
+  // Processes the marked subgraph in reverse topological order, starting
+  // from the loss.  A node becomes ready once every one of its uses has been
+  // finalized; since the marked set is closed under "is used by", counting
+  // all uses is the right readiness test.
+  void Sweep() {
+    std::unordered_map<const Expr*, size_t> pending;
+    for (const auto* expr : needed_) {
+      pending[expr] = uses_.uses(expr).size();
+    }
+    std::stack<ExprPtr> ready;
+    ready.push(err_);
+    while (ready.size()) {
+      auto expr = ready.top();
+      ready.pop();
+      if (needed_.count(expr.get()) && !seen_.count(expr.get())) {
+        Finalize(expr);
+      }
+      for (const auto& operand : uses_.operands(expr.get())) {
+        auto it = pending.find(operand.get());
+        if (it != pending.end() && --it->second == 0) {
+          ready.push(operand);
+        }
+      }
+    }
+  }
+
+  // Computes an expr's total derivative by summing the contribution from
+  // each of its uses; every user's derivative must already be available.
+  ExprPtr Finalize(const ExprPtr& expr) {
     ExprPtr total;
     for (const auto& use : uses_.uses(expr.get())) {
       ExprPtr dop;
@@ -108,7 +367,7 @@ class Gradient {
       } else if (auto cion_expr = std::dynamic_pointer_cast<ContractionExpr>(use.expr)) {
         dop = DeriveContraction(dout, cion_expr, use.idx);
       } else {
-        throw std::runtime_error("Invalid operation type in Gradient::GetDerivative");
+        throw std::runtime_error("Invalid operation type in Gradient::Finalize");
       }
       if (!total) {
         total = dop;
@@ -121,12 +380,10 @@ class Gradient {
     } else if (total->shape.dims.size()) {
       total = MakeCall("simple_reduce", {total, expr});
     }
-    IVLOG(4, "  Gradient::GetDerivative, final result -> " << total);
+    IVLOG(4, "  Gradient::Finalize, final result -> " << total);
     seen_.emplace(expr.get(), total);
     return total;
   }
-
- private:
   ExprPtr DeriveContraction(const ExprPtr& dout, const std::shared_ptr<ContractionExpr>& expr, size_t idx) {
     if (expr->use_default && idx == expr->srcs.size()) {
       return dout;
@@ -157,7 +414,13 @@ class Gradient {
       }
       return MakeCall("reshape", args);
     }
-    auto deriv = DerivRegistry::Instance()->Resolve(op->fn);
+    const auto& deriv = DerivRegistry::Instance()->Resolve(op->fn);
+    if (remat_->enabled()) {
+      // Hand the derivative builder the rematerialized forward op, so any
+      // activations it references are recomputed rather than stored.
+      auto y = std::dynamic_pointer_cast<CallExpr>(remat_->Remat(op));
+      return deriv.fn(y, dout, y->args, deriv.user_fn, deriv.user_ctx)[idx];
+    }
     return deriv.fn(op, dout, op->args, deriv.user_fn, deriv.user_ctx)[idx];
   }
 
@@ -179,7 +442,7 @@ class Gradient {
         switch (op->combo_op) {
           case CombinationOp::MULTIPLY:
             // For *, we multiply by the other (non-differentiated) input
-            dop->srcs.push_back(op->srcs[i]);
+            dop->srcs.push_back(RematSrc(op->srcs[i]));
             dop->combo_op = CombinationOp::MULTIPLY;
             break;
           case CombinationOp::PLUS:
@@ -222,8 +485,8 @@ class Gradient {
     dop->constraints = op->constraints;
     // Anywhere the forward pass hits the default, the derivative w.r.t. any other tensor is 0;
     // thus, for the corresponding gradient, the default is everywhere zero i.e. the standard unspecified default
-    dop->srcs.push_back(input);
-    dop->srcs.push_back(std::make_shared<IndexMapExpr>(op, op->sink_idxs->idxs));
+    dop->srcs.push_back(RematSrc(input));
+    dop->srcs.push_back(std::make_shared<IndexMapExpr>(remat_->Remat(op), op->sink_idxs->idxs));
     dop->srcs.push_back(std::make_shared<IndexMapExpr>(dout, op->sink_idxs->idxs));
     dop->sink_idxs = std::make_shared<IndexMapExpr>(nullptr, input->idxs);
     dop->sink_dims = std::make_shared<SizeMapExpr>(input->ref->shape.dims_as_exprs());
@@ -231,14 +494,189 @@ class Gradient {
     return dop;
   }
 
+  // Builds a contraction source that reads `src`'s underlying tensor,
+  // rematerializing it from the checkpoints when checkpointing is enabled.
+  std::shared_ptr<IndexMapExpr> RematSrc(const std::shared_ptr<IndexMapExpr>& src) {
+    auto ref = remat_->Remat(src->ref);
+    if (ref == src->ref) {
+      return src;
+    }
+    return std::make_shared<IndexMapExpr>(ref, src->idxs);
+  }
+
  private:
+  ExprPtr err_;
   ComputeUses uses_;
+  Rematerializer* remat_;
+  std::map<const Expr*, ExprPtr> seen_;
+  std::unordered_set<const Expr*> needed_;
+};
+
+// Forward-mode companion to Gradient: pushes tangents from the wrts toward
+// the output instead of pulling derivatives back from a loss.  Tangents are
+// memoized per forward op, so shared subgraphs are differentiated once; an
+// op no wrt flows into has a structural zero tangent (represented as an
+// empty ExprPtr) and drops out of the emitted sums entirely.
+class Tangent {
+ public:
+  Tangent(const std::vector<ExprPtr>& wrts, const std::vector<ExprPtr>& tangents) {
+    for (size_t i = 0; i < wrts.size(); i++) {
+      seen_[wrts[i].get()] = tangents[i];
+    }
+  }
+
+  ExprPtr TangentOf(const ExprPtr& expr) {
+    auto it = seen_.find(expr.get());
+    if (it != seen_.end()) {
+      return it->second;
+    }
+    ExprPtr result;
+    if (auto call_expr = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      result = CallTangent(call_expr);
+    } else if (auto cion_expr = std::dynamic_pointer_cast<ContractionExpr>(expr)) {
+      result = ContractionTangent(cion_expr);
+    } else if (std::dynamic_pointer_cast<GradOverrideExpr>(expr)) {
+      throw std::runtime_error("Forward-mode differentiation through a gradient override is not supported");
+    }
+    // Parameters, constants, and dims not named as wrts are constant along
+    // the tangent direction.
+    seen_.emplace(expr.get(), result);
+    return result;
+  }
+
+ private:
+  ExprPtr ContractionTangent(const std::shared_ptr<ContractionExpr>& op) {
+    IVLOG(4, "Tangent::ContractionTangent> op=" << op);
+    if (op->combo_op == CombinationOp::EQ) {
+      return ExprPtr();
+    }
+    if (op->agg_op == AggregationOp::MIN || op->agg_op == AggregationOp::MAX) {
+      return ExtremeTangent(op);
+    }
+    if (op->agg_op == AggregationOp::PROD) {
+      throw std::runtime_error("PROD AggregationOp does not support differentiation");
+    }
+    if (op->use_default && TangentOf(op->use_default)) {
+      throw std::runtime_error("Forward-mode differentiation through use_default is not supported");
+    }
+    // SUM/ASSIGN: the product rule across the srcs -- one clone of the
+    // contraction per src that has a tangent, with that src's tensor
+    // replaced by the tangent.  For PLUS combinations the other srcs drop
+    // out instead, mirroring DeriveSum.
+    ExprPtr total;
+    for (size_t i = 0; i < op->srcs.size(); i++) {
+      auto dref = TangentOf(op->srcs[i]->ref);
+      if (!dref) {
+        continue;
+      }
+      auto dop = std::make_shared<ContractionExpr>();
+      dop->agg_op = op->agg_op;
+      dop->constraints = op->constraints;
+      dop->no_defract = op->no_defract;
+      dop->sink_idxs = op->sink_idxs;
+      dop->sink_dims = op->sink_dims;
+      switch (op->combo_op) {
+        case CombinationOp::MULTIPLY:
+          dop->combo_op = CombinationOp::MULTIPLY;
+          for (size_t j = 0; j < op->srcs.size(); j++) {
+            auto ref = (i == j) ? dref : op->srcs[j]->ref;
+            dop->srcs.push_back(std::make_shared<IndexMapExpr>(ref, op->srcs[j]->idxs));
+          }
+          break;
+        case CombinationOp::PLUS:
+        case CombinationOp::NONE:
+          dop->combo_op = CombinationOp::NONE;
+          dop->srcs.push_back(std::make_shared<IndexMapExpr>(dref, op->srcs[i]->idxs));
+          break;
+        case CombinationOp::COND:
+          throw std::runtime_error("Forward-mode differentiation of conditional combinations not supported");
+        default:
+          throw std::runtime_error("Failed to recognize combination op during differentiation");
+      }
+      dop->ComputeShape(op->shape.layout);
+      total = total ? MakeCall("add", {total, dop}) : ExprPtr(dop);
+    }
+    return total;
+  }
+
+  // Given `O(oidxs) >= I(iidxs);` (or a MIN aggregation), the tangent
+  // follows the selected element:
+  //   ```dO(oidxs) += (I(iidxs) == O(oidxs)) ? dI(iidxs);```
+  // the forward counterpart of DeriveExtreme.
+  ExprPtr ExtremeTangent(const std::shared_ptr<ContractionExpr>& op) {
+    IVLOG(4, "Tangent::ExtremeTangent> op=" << op);
+    auto input = op->srcs[0];
+    auto din = TangentOf(input->ref);
+    if (!din) {
+      return ExprPtr();
+    }
+    auto dop = std::make_shared<ContractionExpr>();
+    dop->agg_op = AggregationOp::SUM;
+    dop->combo_op = CombinationOp::COND;
+    dop->constraints = op->constraints;
+    dop->srcs.push_back(input);
+    dop->srcs.push_back(std::make_shared<IndexMapExpr>(op, op->sink_idxs->idxs));
+    dop->srcs.push_back(std::make_shared<IndexMapExpr>(din, input->idxs));
+    dop->sink_idxs = op->sink_idxs;
+    dop->sink_dims = op->sink_dims;
+    dop->ComputeShape(op->shape.layout);
+    return dop;
+  }
+
+  ExprPtr CallTangent(const std::shared_ptr<CallExpr>& op) {
+    IVLOG(4, "Tangent::CallTangent> op=" << op << ", fn=" << op->fn);
+    if (op->fn == "reshape") {
+      auto dx = TangentOf(op->args[0]);
+      if (!dx) {
+        return ExprPtr();
+      }
+      std::vector<ExprPtr> args = {dx};
+      for (size_t i = 1; i < op->args.size(); i++) {
+        args.push_back(op->args[i]);
+      }
+      return MakeCall("reshape", args);
+    }
+    if (op->fn == "gather") {
+      auto dx = TangentOf(op->args[0]);
+      if (!dx) {
+        return ExprPtr();
+      }
+      return MakeCall("gather", {dx, op->args[1]});
+    }
+    if (op->fn == "index" || op->fn == "shape") {
+      // Discrete outputs; constant along any tangent direction.
+      return ExprPtr();
+    }
+    // The registered reverse rule for input i computes dout * (dy/dx_i)
+    // elementwise; that product commutes, so feeding the input's tangent in
+    // as dout yields exactly the forward contribution (dy/dx_i) * dx_i.
+    // This holds for the elementwise ops the registry covers; ops where the
+    // reverse rule moves data (reshape, gather) are special-cased above.
+    ExprPtr total;
+    const auto& deriv = DerivRegistry::Instance()->Resolve(op->fn);
+    for (size_t i = 0; i < op->args.size(); i++) {
+      auto dx = TangentOf(op->args[i]);
+      if (!dx) {
+        continue;
+      }
+      auto dop = deriv.fn(op, dx, op->args, deriv.user_fn, deriv.user_ctx)[i];
+      total = total ? MakeCall("add", {total, dop}) : dop;
+    }
+    return total;
+  }
+
+ private:
   std::map<const Expr*, ExprPtr> seen_;
 };
 
 }  // namespace
 
 std::vector<ExprPtr> ComputeGradients(const std::vector<ExprPtr>& wrts, const ExprPtr& loss) {
+  return ComputeGradients(wrts, loss, {});
+}
+
+std::vector<ExprPtr> ComputeGradients(const std::vector<ExprPtr>& wrts, const ExprPtr& loss,
+                                      const std::vector<ExprPtr>& checkpoints) {
   ExprPtr value = loss;
   auto ndims = loss->shape.dims.size();
   if (ndims) {
@@ -255,14 +693,33 @@ std::vector<ExprPtr> ComputeGradients(const std::vector<ExprPtr>& wrts, const Ex
     cion->ComputeShape("");
     value = cion;
   }
-  Gradient grad(value);
-  std::vector<ExprPtr> ret(wrts.size());
-  for (size_t i = 0; i < wrts.size(); i++) {
-    ret[i] = grad.GetDerivative(wrts[i]);
+  Rematerializer remat(checkpoints);
+  Gradient grad(value, &remat);
+  auto ret = grad.GetDerivatives(wrts);
+  // Hash-cons the emitted derivatives so subtrees repeated across uses (and
+  // across the requested gradients) collapse into a shared DAG.
+  ExprInterner interner(&remat);
+  for (auto& expr : ret) {
+    expr = interner.Intern(expr);
   }
   return ret;
 }
 
+ExprPtr ComputeJvp(const ExprPtr& output, const std::vector<ExprPtr>& wrts, const std::vector<ExprPtr>& tangents) {
+  if (wrts.size() != tangents.size()) {
+    throw std::runtime_error("ComputeJvp requires exactly one tangent per wrt");
+  }
+  Tangent tangent(wrts, tangents);
+  auto ret = tangent.TangentOf(output);
+  if (!ret) {
+    // The output doesn't depend on any wrt; the directional derivative is zero.
+    return std::make_shared<FloatConst>(0.0);
+  }
+  Rematerializer remat({});
+  ExprInterner interner(&remat);
+  return interner.Intern(ret);
+}
+
 }  // namespace ast
 }  // namespace lang
 }  // namespace tile
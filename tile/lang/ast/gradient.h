@@ -22,26 +22,51 @@ class DerivRegistry {
   }
 
   void Register(const std::string& name, const ExprDeriv& fn, void* user_fn, void* user_ctx) {  //
-    if (registry_.count(name)) {
+    if (ids_.count(name)) {
       throw std::runtime_error("Attempted to register deriv '" + name + "', which was already in the DerivRegistry");
     }
-    registry_[name] = ExprDerivEntry{fn, user_fn, user_ctx};
+    ids_.emplace(name, entries_.size());
+    entries_.push_back(ExprDerivEntry{fn, user_fn, user_ctx});
   }
 
-  ExprDerivEntry Resolve(const std::string& name) const {
-    auto it = registry_.find(name);
-    if (it == registry_.end()) {
+  // Maps a derivative name to its dense id, assigned in registration order.
+  // Callers that resolve the same op repeatedly can hold the id and index
+  // straight into the entry table, skipping the string lookup.
+  size_t ResolveId(const std::string& name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
       throw std::runtime_error("Invalid derivative: Unknown function " + name);
     }
     return it->second;
   }
 
+  // Entries are append-only, so the returned reference stays valid.
+  const ExprDerivEntry& Resolve(size_t id) const { return entries_[id]; }
+
+  const ExprDerivEntry& Resolve(const std::string& name) const { return entries_[ResolveId(name)]; }
+
  private:
-  std::unordered_map<std::string, ExprDerivEntry> registry_;
+  std::unordered_map<std::string, size_t> ids_;
+  std::vector<ExprDerivEntry> entries_;
 };
 
 std::vector<ExprPtr> ComputeGradients(const std::vector<ExprPtr>& wrts, const ExprPtr& loss);
 
+// As above, but treats each expr in `checkpoints` as a recomputation
+// boundary: forward intermediates are rematerialized from the checkpoints in
+// the derivative graph instead of being referenced, so only the checkpointed
+// activations (and the program inputs) stay live into the backward pass.
+std::vector<ExprPtr> ComputeGradients(const std::vector<ExprPtr>& wrts, const ExprPtr& loss,
+                                      const std::vector<ExprPtr>& checkpoints);
+
+// Forward-mode differentiation: propagates the tangent of each expr in
+// `wrts` (given pairwise in `tangents`) through the ops between the wrts and
+// `output`, returning the Jacobian-vector product in a single forward sweep.
+// Contractions differentiate structurally; calls reuse the reverse-mode
+// rules in the DerivRegistry, which coincide with the forward rules for the
+// elementwise ops the registry covers.
+ExprPtr ComputeJvp(const ExprPtr& output, const std::vector<ExprPtr>& wrts, const std::vector<ExprPtr>& tangents);
+
 }  // namespace ast
 }  // namespace lang
 }  // namespace tile
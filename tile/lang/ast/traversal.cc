@@ -2,10 +2,16 @@
 
 #include "tile/lang/ast/traversal.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "base/util/env.h"
 #include "base/util/stream_container.h"
+#include "base/util/thread_pool.h"
 #include "tile/lang/ast/fold.h"
 
 namespace vertexai {
@@ -94,6 +100,55 @@ std::vector<ExprPtr> FlattenAst(const ProgramMutations& mutations) {
   return traversal.flat();
 }
 
+namespace {
+
+// Don't spin up workers for graphs small enough to walk in one pass
+constexpr size_t kParallelAstThreshold = 512;
+
+// Lists the direct children of an expression: the nodes its rewrite reads
+// through Translate.  Mirrors the push logic in AstTraversal.
+class AstChildren : public AstVisitor<void> {
+ public:
+  static std::vector<ExprPtr> Of(Expr& expr) {  // NOLINT(runtime/references)
+    AstChildren children;
+    expr.Accept(&children);
+    return children.children_;
+  }
+
+ private:
+  void Visit(const CallExpr& expr) final {
+    for (const auto& arg : expr.args) {
+      children_.push_back(arg);
+    }
+  }
+
+  void Visit(const ContractionExpr& expr) final {
+    for (const auto& src : expr.srcs) {
+      children_.push_back(src->ref);
+    }
+    if (expr.use_default) {
+      children_.push_back(expr.use_default);
+    }
+  }
+
+  void Visit(const GradOverrideExpr& expr) final {
+    for (const auto& in : expr.ins) {
+      children_.push_back(in);
+    }
+    children_.push_back(expr.out);
+  }
+
+  void Visit(const DimExprExpr& expr) final {}
+  void Visit(const FloatConst& expr) final {}
+  void Visit(const IntConst& expr) final {}
+  void Visit(const ParamExpr& expr) final {}
+
+ private:
+  std::vector<ExprPtr> children_;
+};
+
+}  // namespace
+
 class AstPassRunner : AstVisitor<void> {
  public:
   AstPassRunner(                          //
@@ -101,8 +156,12 @@ class AstPassRunner : AstVisitor<void> {
       const ProgramMutations& mutations,  //
       AstPass* pass)
       : pass_(pass) {
-    for (const auto& expr : ast) {
-      expr->Accept(this);
+    if (ast.size() >= kParallelAstThreshold && env::Get("PLAIDML_PARALLEL_AST") != "0") {
+      RunWaves(ast);
+    } else {
+      for (const auto& expr : ast) {
+        expr->Accept(this);
+      }
     }
     mutations_.originals = mutations.originals;
     for (const auto& output : mutations.outputs) {
@@ -177,11 +236,57 @@ class AstPassRunner : AstVisitor<void> {
   }
 
  private:
+  // Partition the flattened graph into topological waves (every node's
+  // children land in an earlier wave) and rewrite each wave's nodes
+  // concurrently.  During a wave, Translate only reads rewrites from
+  // earlier waves; new rewrites are buffered and merged at the join, so
+  // the map is never mutated while workers read it.  The pass's Visit
+  // must be reentrant; ours are stateless.
+  void RunWaves(const std::vector<ExprPtr>& ast) {
+    std::unordered_map<const Expr*, size_t> levels;
+    std::vector<std::vector<ExprPtr>> waves;
+    for (const auto& expr : ast) {
+      size_t level = 0;
+      for (const auto& child : AstChildren::Of(*expr)) {
+        level = std::max(level, levels[child.get()] + 1);
+      }
+      levels[expr.get()] = level;
+      if (level >= waves.size()) {
+        waves.resize(level + 1);
+      }
+      waves[level].push_back(expr);
+    }
+    ThreadPool pool;
+    for (const auto& wave : waves) {
+      if (wave.size() < 2) {
+        for (const auto& expr : wave) {
+          expr->Accept(this);
+        }
+        continue;
+      }
+      std::vector<std::pair<const Expr*, ExprPtr>> results;
+      wave_out_ = &results;
+      for (const auto& expr : wave) {
+        pool.Submit([this, expr]() { expr->Accept(this); });
+      }
+      pool.Wait();
+      wave_out_ = nullptr;
+      for (auto& kvp : results) {
+        rewrites_.emplace(kvp.first, std::move(kvp.second));
+      }
+    }
+  }
+
   template <typename T>
   void GenericVisit(const T& old_expr, const T& expr) {
     auto new_expr = pass_->Visit(expr);
     if (new_expr.get() != &old_expr) {
-      rewrites_.emplace(&old_expr, new_expr);
+      if (wave_out_) {
+        std::lock_guard<std::mutex> lock{mu_};
+        wave_out_->emplace_back(&old_expr, new_expr);
+      } else {
+        rewrites_.emplace(&old_expr, new_expr);
+      }
     }
   }
 
@@ -197,6 +302,8 @@ class AstPassRunner : AstVisitor<void> {
   AstPass* pass_;
   std::unordered_map<const Expr*, ExprPtr> rewrites_;
   ProgramMutations mutations_;
+  std::mutex mu_;
+  std::vector<std::pair<const Expr*, ExprPtr>>* wave_out_ = nullptr;
 };
 
 ProgramMutations RunAstPass(const ProgramMutations& mutations, AstPass* pass) {
@@ -1,7 +1,11 @@
 #include "tile/lang/compile.h"
 
 #include <cinttypes>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
 
 #include "tile/lang/bound.h"
 #include "tile/lang/defract.h"
@@ -16,8 +20,62 @@ namespace lang {
 
 using namespace math;  // NOLINT
 
-FlatContraction Compile(const Contraction& c, const std::vector<TensorShape>& shapes,
-                        std::vector<Polynomial<Rational>>* out_poly) {
+namespace {
+
+// A flattened contraction together with the output polynomials callers ask
+// for; interned so that identical layers share one stored copy.
+struct FlatEntry {
+  FlatContraction flat;
+  std::vector<Polynomial<Rational>> out_poly;
+};
+
+// Flatten results keyed by the pre-flatten contraction text plus input
+// shapes.  Identical layer shapes recur constantly both within a network and
+// across the programs a process compiles, and reduce/defract/flatten is a
+// large slice of front-end compile time; the cache is process-wide so batch
+// compiles share it too.  Entries are small, but the cache is flushed at a
+// generous bound so long-lived processes compiling many distinct programs
+// don't grow without limit.
+class FlatCache {
+ public:
+  static FlatCache* Instance() {
+    static FlatCache cache;
+    return &cache;
+  }
+
+  std::shared_ptr<const FlatEntry> Lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock{mu_};
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+
+  void Insert(const std::string& key, const std::shared_ptr<const FlatEntry>& entry) {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.emplace(key, entry);
+  }
+
+ private:
+  static constexpr std::size_t kMaxEntries = 4096;
+  std::mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<const FlatEntry>> entries_;
+};
+
+std::string FlatCacheKey(const Contraction& c, const std::vector<TensorShape>& shapes) {
+  std::ostringstream key;
+  // to_string() covers the specs, ops, and constraints; no_defract changes
+  // the pipeline below but isn't part of the printed form.
+  key << to_string(c) << '|' << c.no_defract;
+  for (const auto& shape : shapes) {
+    key << '|' << shape;
+  }
+  return key.str();
+}
+
+FlatContraction CompileUncached(const Contraction& c, const std::vector<TensorShape>& shapes,
+                                std::vector<Polynomial<Rational>>* out_poly) {
   if (c.specs.size() != 2 && c.specs.size() != 3 && c.specs.size() != 4) {
     throw std::runtime_error("Currently, we only support 1, 2, or 3 element Contractions");
   }
@@ -58,6 +116,24 @@ FlatContraction Compile(const Contraction& c, const std::vector<TensorShape>& sh
   return flat;
 }
 
+}  // namespace
+
+FlatContraction Compile(const Contraction& c, const std::vector<TensorShape>& shapes,
+                        std::vector<Polynomial<Rational>>* out_poly) {
+  auto key = FlatCacheKey(c, shapes);
+  auto entry = FlatCache::Instance()->Lookup(key);
+  if (!entry) {
+    auto fresh = std::make_shared<FlatEntry>();
+    fresh->flat = CompileUncached(c, shapes, &fresh->out_poly);
+    FlatCache::Instance()->Insert(key, fresh);
+    entry = std::move(fresh);
+  }
+  if (out_poly) {
+    *out_poly = entry->out_poly;
+  }
+  return entry->flat;
+}
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
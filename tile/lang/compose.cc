@@ -1,6 +1,7 @@
 #include "tile/lang/compose.h"
 
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <stack>
 
@@ -28,6 +29,11 @@ std::shared_ptr<IConstValue> IConstValue::make(const int64_t& val) {
 struct IDMap {
   std::mutex mu;
   std::map<std::weak_ptr<Value>, std::set<std::string>, std::owner_less<std::weak_ptr<Value>>> ids;
+  // Set (and never cleared) once any ids exist.  Checked without the mutex so
+  // that composition stays lock-free in the common case where no provenance
+  // ids are being tracked; entries are only ever added, so a stale false just
+  // means the value predates any ids and has nothing to look up.
+  std::atomic<bool> has_ids{false};
 };
 
 IDMap* GetIDMap() {
@@ -338,8 +344,11 @@ std::shared_ptr<Value> ContractionValue::make(CombinationOp comb_op, Aggregation
 }
 
 BoundFunction::BoundFunction(const std::string& code, const std::string& id) {
+  // Front ends rebuild identical function bodies constantly (the keras
+  // bridge emits the same couple hundred snippets per model), so go through
+  // the parse cache rather than the parser itself.
   Parser p;
-  prog_ = p.Parse(code, id);
+  prog_ = p.ParseCached(code, id);
   for (size_t i = 0; i < prog_.inputs.size(); i++) {
     in_pos_[prog_.inputs[i].name] = i;
   }
@@ -738,7 +747,7 @@ std::string BoundFunction::Apply(const std::shared_ptr<Value>& val) {
   std::string name = ValueVisitor<std::string>::Apply(val);
   IVLOG(4, "  Constructed new name " << name << " for " << *val);
   auto* idmap = GetIDMap();
-  if (prog_.ops.size()) {
+  if (prog_.ops.size() && idmap->has_ids.load(std::memory_order_acquire)) {
     std::unique_lock<std::mutex> lk{idmap->mu};
     auto it2 = idmap->ids.find(val);
     if (it2 != idmap->ids.end()) {
@@ -1039,6 +1048,7 @@ void FunctionApplication::SetDone() {
           for (const auto& s : attr.params()) {
             idmap->ids[bindings_[o.output]].emplace(s);
           }
+          idmap->has_ids.store(true, std::memory_order_release);
         }
       }
     }
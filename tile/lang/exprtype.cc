@@ -3,63 +3,66 @@
 #include "tile/lang/exprtype.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdlib>
 
 namespace vertexai {
 namespace tile {
 namespace lang {
 namespace {
 
+// The arithmetic conversion ranks as a table over the DataType encoding,
+// built once at compile time; 0 marks types with no rank.  Promotion is
+// on the critical path of every kernel emission, so it should be a load,
+// not a switch cascade.
+constexpr size_t kRankTableSize = 0x41;
+
+constexpr std::array<uint8_t, kRankTableSize> BuildRankTable() {
+  std::array<uint8_t, kRankTableSize> table{};
+  table[static_cast<size_t>(DataType::BOOLEAN)] = 2;
+  table[static_cast<size_t>(DataType::INT8)] = 3;
+  table[static_cast<size_t>(DataType::UINT8)] = 4;
+  table[static_cast<size_t>(DataType::INT16)] = 5;
+  table[static_cast<size_t>(DataType::UINT16)] = 6;
+  table[static_cast<size_t>(DataType::INT32)] = 7;
+  table[static_cast<size_t>(DataType::UINT32)] = 8;
+  table[static_cast<size_t>(DataType::INT64)] = 9;
+  table[static_cast<size_t>(DataType::UINT64)] = 10;
+  table[static_cast<size_t>(DataType::FLOAT16)] = 11;
+  table[static_cast<size_t>(DataType::FLOAT32)] = 12;
+  table[static_cast<size_t>(DataType::FLOAT64)] = 13;
+  return table;
+}
+
+constexpr std::array<uint8_t, kRankTableSize> kRankTable = BuildRankTable();
+
 // Returns the Plaid arithmetic conversion rank of a type.
 unsigned Rank(sem::Type ty) {
   if (ty.base != sem::Type::VALUE && ty.base != sem::Type::INDEX) {
     return 1;
   }
-  auto dtype = ty.dtype;
-  if (ty.base == sem::Type::INDEX) {
-    dtype = DataType::INT32;
-  }
-  switch (dtype) {
-    case DataType::BOOLEAN:
-      return 2;
-    case DataType::INT8:
-      return 3;
-    case DataType::UINT8:
-      return 4;
-    case DataType::INT16:
-      return 5;
-    case DataType::UINT16:
-      return 6;
-    case DataType::INT32:
-      return 7;
-    case DataType::UINT32:
-      return 8;
-    case DataType::INT64:
-      return 9;
-    case DataType::UINT64:
-      return 10;
-    case DataType::FLOAT16:
-      return 11;
-    case DataType::FLOAT32:
-      return 12;
-    case DataType::FLOAT64:
-      return 13;
-    default:
-      throw std::logic_error{"Invalid type found in typecheck"};
+  auto idx = static_cast<size_t>(ty.base == sem::Type::INDEX ? DataType::INT32 : ty.dtype);
+  unsigned rank = idx < kRankTableSize ? kRankTable[idx] : 0;
+  if (!rank) {
+    throw std::logic_error{"Invalid type found in typecheck"};
   }
+  return rank;
 }
 
 }  // namespace
 
 sem::Type ExprType::TypeOf(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic,
                            const sem::ExprPtr& expr) {
-  ExprType et{scope, enable_fp16, use_int_for_logic};
+  Memo memo;
+  ExprType et{scope, enable_fp16, use_int_for_logic, &memo};
   expr->Accept(et);
   return et.ty_;
 }
 
 sem::Type ExprType::TypeOf(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic,
                            const sem::LValPtr& lvalue) {
-  ExprType et{scope, enable_fp16, use_int_for_logic};
+  Memo memo;
+  ExprType et{scope, enable_fp16, use_int_for_logic, &memo};
   lvalue->Accept(et);
   return et.ty_;
 }
@@ -227,7 +230,18 @@ void ExprType::Visit(const sem::CallExpr& n) {
   for (auto val : n.vals) {
     types.push_back(TypeOf(val));
   }
-  ty_ = Promote(types);
+  if (n.name.size() > 5 && n.name.compare(0, 5, "vload") == 0 && '0' <= n.name[5] && n.name[5] <= '9' &&
+      types.size() == 2) {
+    // vloadn(offset, ptr) returns an n-element vector of the pointer's
+    // element type; promotion would yield the pointer type itself.
+    ty_ = types[1];
+    ty_.base = sem::Type::VALUE;
+    ty_.region = sem::Type::NORMAL;
+    ty_.array = 0;
+    ty_.vec_width = std::atoi(n.name.c_str() + 5);
+  } else {
+    ty_ = Promote(types);
+  }
   IVLOG(5, "ExprType(CallExpr): " << ty_);
 }
 
@@ -258,12 +272,17 @@ void ExprType::Visit(const sem::SpecialStmt&) { throw std::logic_error{"Unexpect
 
 void ExprType::Visit(const sem::Function&) { throw std::logic_error{"Unexpected expression component"}; }
 
-ExprType::ExprType(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic)
-    : scope_{scope}, enable_fp16_{enable_fp16}, use_int_for_logic_{use_int_for_logic} {}
+ExprType::ExprType(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic, Memo* memo)
+    : scope_{scope}, enable_fp16_{enable_fp16}, use_int_for_logic_{use_int_for_logic}, memo_{memo} {}
 
 sem::Type ExprType::TypeOf(const sem::ExprPtr& expr) {
-  ExprType et{scope_, enable_fp16_, use_int_for_logic_};
+  auto it = memo_->find(expr.get());
+  if (it != memo_->end()) {
+    return it->second;
+  }
+  ExprType et{scope_, enable_fp16_, use_int_for_logic_, memo_};
   expr->Accept(et);
+  memo_->emplace(expr.get(), et.ty_);
   return et.ty_;
 }
 
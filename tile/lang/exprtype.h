@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 
 #include "tile/lang/scope.h"
@@ -49,7 +50,13 @@ class ExprType : public sem::Visitor {
   void Visit(const sem::Function&) final;
 
  private:
-  ExprType(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic);
+  // Types already computed during this query, keyed by node.  Builders
+  // share subtrees freely, so without this the walk is exponential on
+  // deeply-reused expressions; the memo lives only for one top-level
+  // TypeOf, since a rebind between statements can change lookups.
+  using Memo = std::unordered_map<const sem::Node*, sem::Type>;
+
+  ExprType(const lang::Scope<sem::Type>* scope, bool enable_fp16, bool use_int_for_logic, Memo* memo);
 
   sem::Type TypeOf(const sem::ExprPtr& expr);
 
@@ -58,6 +65,7 @@ class ExprType : public sem::Visitor {
   const lang::Scope<sem::Type>* scope_;
   bool enable_fp16_;
   bool use_int_for_logic_;
+  Memo* memo_;
   sem::Type ty_;
 };
 
@@ -0,0 +1,371 @@
+#include "tile/lang/gen_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/util/logging.h"
+#include "tile/lang/sembuilder.h"
+
+namespace vertexai {
+namespace tile {
+namespace lang {
+
+namespace {
+
+// Scans a kernel body for constructs that make it unsafe to relaunch on a
+// wider grid: any use of grid dimensions other than dimension zero.  Batched
+// kernels run with a segment index in grid dimension one, so a body that
+// reads the upper dimensions would observe different values than it did in
+// its original launch.
+class UpperDimScan final : public sem::Visitor {
+ public:
+  bool found() const { return found_; }
+
+  void Visit(const sem::IntConst&) final {}
+  void Visit(const sem::FloatConst&) final {}
+  void Visit(const sem::LookupLVal&) final {}
+  void Visit(const sem::LoadExpr& n) final { Check(n.inner); }
+  void Visit(const sem::StoreStmt& n) final {
+    Check(n.lhs);
+    Check(n.rhs);
+  }
+  void Visit(const sem::SubscriptLVal& n) final {
+    Check(n.ptr);
+    Check(n.offset);
+  }
+  void Visit(const sem::DeclareStmt& n) final { Check(n.init); }
+  void Visit(const sem::UnaryExpr& n) final { Check(n.inner); }
+  void Visit(const sem::BinaryExpr& n) final {
+    Check(n.lhs);
+    Check(n.rhs);
+  }
+  void Visit(const sem::CondExpr& n) final {
+    Check(n.cond);
+    Check(n.tcase);
+    Check(n.fcase);
+  }
+  void Visit(const sem::SelectExpr& n) final {
+    Check(n.cond);
+    Check(n.tcase);
+    Check(n.fcase);
+  }
+  void Visit(const sem::ClampExpr& n) final {
+    Check(n.val);
+    Check(n.min);
+    Check(n.max);
+  }
+  void Visit(const sem::CastExpr& n) final { Check(n.val); }
+  void Visit(const sem::CallExpr& n) final {
+    for (const auto& val : n.vals) {
+      Check(val);
+    }
+  }
+  void Visit(const sem::LimitConst&) final {}
+  void Visit(const sem::IndexExpr& n) final {
+    if (n.dim != 0) {
+      found_ = true;
+    }
+  }
+  void Visit(const sem::Block& n) final {
+    for (const auto& stmt : n.statements) {
+      Check(stmt);
+    }
+  }
+  void Visit(const sem::IfStmt& n) final {
+    Check(n.cond);
+    Check(n.iftrue);
+    Check(n.iffalse);
+  }
+  void Visit(const sem::ForStmt& n) final { Check(n.inner); }
+  void Visit(const sem::WhileStmt& n) final {
+    Check(n.cond);
+    Check(n.inner);
+  }
+  void Visit(const sem::BarrierStmt&) final {}
+  void Visit(const sem::ReturnStmt& n) final { Check(n.value); }
+  void Visit(const sem::SpecialStmt& n) final {
+    for (const auto& param : n.params) {
+      Check(param);
+    }
+  }
+  void Visit(const sem::Function& n) final { Check(n.body); }
+
+ private:
+  template <typename P>
+  void Check(const P& node) {
+    if (node && !found_) {
+      node->Accept(*this);
+    }
+  }
+
+  bool found_ = false;
+};
+
+bool SameType(const sem::Type& a, const sem::Type& b) {
+  return a.base == b.base && a.dtype == b.dtype && a.vec_width == b.vec_width && a.array == b.array &&
+         a.region == b.region;
+}
+
+// A kernel parameter together with the program variable bound to it; the
+// HAL binds parameters positionally as (outputs..., inputs...).
+struct BoundParam {
+  sem::Type type;
+  std::string name;
+  std::string buffer;
+  bool is_output;
+};
+
+std::vector<BoundParam> BindParams(const KernelInfo& ki) {
+  std::vector<BoundParam> bound;
+  std::size_t pidx = 0;
+  for (const auto& out : ki.outputs) {
+    bound.push_back(BoundParam{ki.kfunc->params[pidx].first, ki.kfunc->params[pidx].second, out, true});
+    pidx++;
+  }
+  for (const auto& in : ki.inputs) {
+    bound.push_back(BoundParam{ki.kfunc->params[pidx].first, ki.kfunc->params[pidx].second, in, false});
+    pidx++;
+  }
+  return bound;
+}
+
+// Accumulates a batch of mergeable kernels, tracking the buffers and
+// parameter names in use so that each additional kernel can be checked for
+// independence before it's admitted.
+class BatchBuilder {
+ public:
+  bool TryAdd(std::size_t kidx, const KernelInfo& ki) {
+    auto bound = BindParams(ki);
+    for (const auto& param : bound) {
+      if (param.is_output) {
+        // Outputs must be entirely private to their segment.
+        if (inputs_.count(param.buffer) || outputs_.count(param.buffer)) {
+          return false;
+        }
+        if (param_names_.count(param.name)) {
+          return false;
+        }
+      } else {
+        if (outputs_.count(param.buffer)) {
+          return false;
+        }
+        auto it = registry_.find(param.buffer);
+        if (it == registry_.end()) {
+          // A fresh input; its name must not shadow an unrelated parameter.
+          if (param_names_.count(param.name)) {
+            return false;
+          }
+        } else if (!SameType(it->second.first, param.type)) {
+          // Shared input seen with a different parameter type (e.g. a
+          // different vectorization); don't try to paper over it.
+          return false;
+        }
+      }
+    }
+    if (members_.size() && ki.lwork[0] != lwork0_) {
+      return false;
+    }
+    // All checks passed; admit the kernel.
+    lwork0_ = ki.lwork[0];
+    for (const auto& param : bound) {
+      if (param.is_output) {
+        outputs_.insert(param.buffer);
+      } else {
+        inputs_.insert(param.buffer);
+      }
+      if (!registry_.count(param.buffer)) {
+        registry_.emplace(param.buffer, std::make_pair(param.type, param.name));
+        param_names_.insert(param.name);
+      }
+    }
+    members_.push_back(kidx);
+    return true;
+  }
+
+  // True if running 'ki' between this batch's members and its merge point
+  // would change program semantics, i.e. the batch can't be extended past it.
+  bool ConflictsWith(const KernelInfo& ki) const {
+    for (const auto& out : ki.outputs) {
+      if (inputs_.count(out) || outputs_.count(out)) {
+        return true;
+      }
+    }
+    for (const auto& in : ki.inputs) {
+      if (outputs_.count(in)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const std::vector<std::size_t>& members() const { return members_; }
+
+ private:
+  std::vector<std::size_t> members_;
+  std::set<std::string> outputs_;
+  std::set<std::string> inputs_;
+  std::set<std::string> param_names_;
+  std::map<std::string, std::pair<sem::Type, std::string>> registry_;
+  std::uint64_t lwork0_ = 0;
+};
+
+bool IsBatchable(const KernelInfo& ki, std::uint64_t work_limit) {
+  if (ki.ktype != KernelType::kFunction || !ki.info.has_element()) {
+    return false;
+  }
+  if (ki.gwork[1] != 1 || ki.gwork[2] != 1 || ki.lwork[1] > 1 || ki.lwork[2] > 1) {
+    return false;
+  }
+  if (ki.lwork[0] == 0 || ki.gwork[0] % ki.lwork[0] != 0) {
+    return false;
+  }
+  if (ki.gwork[0] > work_limit) {
+    return false;
+  }
+  if (ki.kfunc->params.size() != ki.outputs.size() + ki.inputs.size()) {
+    return false;
+  }
+  UpperDimScan scan;
+  ki.kfunc->Accept(scan);
+  return !scan.found();
+}
+
+KernelInfo MergeBatch(const std::vector<KernelInfo>& kernels, const std::vector<std::size_t>& members) {
+  using namespace sem::builder;  // NOLINT
+
+  const KernelInfo& first = kernels[members[0]];
+  KernelInfo merged;
+  merged.kname = "batch_" + first.kname;
+  merged.settings = first.settings;
+  merged.ktype = KernelType::kFunction;
+  merged.lwork = {{first.lwork[0], 1, 1}};
+  merged.gwork = {{0, members.size(), 1}};
+  merged.tot_bytes = 0;
+  merged.tot_flops = 0;
+
+  auto body = std::make_shared<sem::Block>();
+  sem::Function::params_t out_params;
+  sem::Function::params_t in_params;
+  std::set<std::string> seen_inputs;
+  auto element_pb = merged.info.mutable_element();
+
+  for (std::size_t seg = 0; seg < members.size(); seg++) {
+    const KernelInfo& ki = kernels[members[seg]];
+    merged.gwork[0] = std::max(merged.gwork[0], ki.gwork[0]);
+    merged.tot_bytes += ki.tot_bytes;
+    merged.tot_flops += ki.tot_flops;
+    for (const auto& op : ki.info.element().ops()) {
+      element_pb->add_ops(op);
+    }
+    if (merged.comments.size()) {
+      merged.comments += "\n";
+    }
+    merged.comments += "// Batched: " + ki.kname + "\n" + ki.comments;
+
+    auto segment = std::make_shared<sem::Block>();
+    for (const auto& param : BindParams(ki)) {
+      if (param.is_output) {
+        merged.outputs.push_back(param.buffer);
+        out_params.emplace_back(param.type, param.name);
+      } else if (seen_inputs.emplace(param.buffer).second) {
+        merged.inputs.push_back(param.buffer);
+        in_params.emplace_back(param.type, param.name);
+      }
+    }
+    segment->append(ki.kfunc->body);
+
+    // Dispatch on the segment index in grid dimension one; surplus groups in
+    // dimension zero (present when this segment's grid is narrower than the
+    // widest segment's) skip the body entirely.  Both conditions are uniform
+    // across a workgroup, so interior barriers remain safe.
+    sem::ExprPtr seg_idx = _Index(sem::IndexExpr::GROUP, 1);
+    sem::ExprPtr cond = seg_idx == static_cast<int64_t>(seg);
+    if (ki.gwork[0] < merged.gwork[0]) {
+      sem::ExprPtr group_idx = _Index(sem::IndexExpr::GROUP, 0);
+      cond = _LogicalAnd(cond, group_idx < static_cast<int64_t>(ki.gwork[0] / ki.lwork[0]));
+    }
+    body->append(_If(cond, segment));
+  }
+
+  auto func = std::make_shared<sem::Function>();
+  func->name = merged.kname;
+  func->ret = sem::Type{sem::Type::TVOID};
+  func->params = out_params;
+  func->params.insert(func->params.end(), in_params.begin(), in_params.end());
+  func->body = body;
+  merged.kfunc = func;
+
+  // N.B. We deliberately leave safe_self_aliases empty: an output aliasing
+  // an input is only safe when no other segment reads that input, and the
+  // in-place win on sub-threshold kernels isn't worth tracking that.
+  merged.info.set_flops(merged.tot_flops);
+  merged.info.set_bytes(merged.tot_bytes);
+  return merged;
+}
+
+}  // namespace
+
+void BatchEltwiseKernels(KernelList* kl, const HardwareSettings& settings) {
+  if (!settings.batch_work_limit) {
+    return;
+  }
+
+  // Sweep the kernel list, greedily growing a batch out of eligible kernels
+  // until a conflicting kernel pins it down; each batch is merged in place
+  // of its last member, so members only ever move later, which the conflict
+  // check keeps safe.
+  std::vector<std::vector<std::size_t>> batches;
+  BatchBuilder builder;
+  for (std::size_t i = 0; i < kl->kernels.size(); i++) {
+    const KernelInfo& ki = kl->kernels[i];
+    if (IsBatchable(ki, settings.batch_work_limit) && builder.TryAdd(i, ki)) {
+      continue;
+    }
+    if (builder.ConflictsWith(ki)) {
+      if (builder.members().size() > 1) {
+        batches.push_back(builder.members());
+      }
+      builder = BatchBuilder();
+      // The kernel that closed the previous batch may open the next one.
+      if (IsBatchable(ki, settings.batch_work_limit)) {
+        builder.TryAdd(i, ki);
+      }
+    }
+  }
+  if (builder.members().size() > 1) {
+    batches.push_back(builder.members());
+  }
+  if (batches.empty()) {
+    return;
+  }
+
+  std::vector<KernelInfo> result;
+  result.reserve(kl->kernels.size());
+  std::map<std::size_t, const std::vector<std::size_t>*> merge_points;
+  std::set<std::size_t> batched;
+  for (const auto& batch : batches) {
+    IVLOG(2, "Batching " << batch.size() << " eltwise kernels into one launch, first: "
+                         << kl->kernels[batch.front()].kname);
+    merge_points.emplace(batch.back(), &batch);
+    batched.insert(batch.begin(), batch.end());
+  }
+  for (std::size_t i = 0; i < kl->kernels.size(); i++) {
+    auto it = merge_points.find(i);
+    if (it != merge_points.end()) {
+      result.push_back(MergeBatch(kl->kernels, *it->second));
+    } else if (!batched.count(i)) {
+      result.push_back(std::move(kl->kernels[i]));
+    }
+  }
+  kl->kernels = std::move(result);
+}
+
+}  // namespace lang
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "tile/lang/generate.h"
+
+namespace vertexai {
+namespace tile {
+namespace lang {
+
+// Concatenates runs of small independent elementwise kernels into single
+// launches, dispatching on the second grid dimension, to amortize per-launch
+// overhead on devices where it dominates tiny kernels.  A kernel is eligible
+// when its total work-item count is at most settings.batch_work_limit; a
+// limit of zero disables batching entirely.
+void BatchEltwiseKernels(KernelList* kl, const HardwareSettings& settings);
+
+}  // namespace lang
+}  // namespace tile
+}  // namespace vertexai
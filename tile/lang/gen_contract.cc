@@ -8,6 +8,7 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include "base/util/env.h"
 #include "base/util/logging.h"
 #include "tile/lang/compile.h"
 #include "tile/lang/flat.h"
@@ -58,6 +59,45 @@ static sem::ExprPtr combine(const CombinationOp& co, sem::ExprPtr rhs, sem::Expr
   return e;
 }
 
+// True when the merge phase can be lowered to subgroup shuffle reductions:
+// every thread holds exactly one partial (no output threading, no register
+// threading) and the aggregation maps onto a sub_group_reduce_* builtin.
+static bool UseSubgroupReduce(const DirectSettings& settings, const FlatContraction& op, uint64_t out_threads,
+                              uint64_t comp_threads, uint64_t threads) {
+  if (!settings.subgroup_reduce) {
+    return false;
+  }
+  if (out_threads != 1 || comp_threads != threads || op.agg_vec != 1) {
+    return false;
+  }
+  if (op.agg_op != AggregationOp::SUM && op.agg_op != AggregationOp::MAX && op.agg_op != AggregationOp::MIN) {
+    return false;
+  }
+  switch (op.agg_type) {
+    case DataType::INT32:
+    case DataType::UINT32:
+    case DataType::INT64:
+    case DataType::UINT64:
+    case DataType::FLOAT16:
+    case DataType::FLOAT32:
+    case DataType::FLOAT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static sem::CallExpr::Function SubgroupReduceFn(const AggregationOp& op) {
+  switch (op) {
+    case AggregationOp::MAX:
+      return sem::CallExpr::Function::SUB_GROUP_REDUCE_MAX;
+    case AggregationOp::MIN:
+      return sem::CallExpr::Function::SUB_GROUP_REDUCE_MIN;
+    default:
+      return sem::CallExpr::Function::SUB_GROUP_REDUCE_ADD;
+  }
+}
+
 static sem::ExprPtr aggregate(const AggregationOp& op, sem::ExprPtr lhs, sem::ExprPtr rhs) {
   using namespace sem::builder;  // NOLINT
   switch (op) {
@@ -79,6 +119,53 @@ static sem::ExprPtr aggregate(const AggregationOp& op, sem::ExprPtr lhs, sem::Ex
   }
 }
 
+// Picks the element type of the kernel's accumulator.  fp16 outputs normally
+// accumulate in fp16, which runs at double rate on most iGPUs; but fp16
+// round-to-nearest summation has a worst-case relative error that grows with
+// the number of addends (roughly n * 2^-11 for a length-n sum), so reductions
+// longer than PLAIDML_FP16_ACC_MAX_REDUCE elements (default 1024) accumulate
+// in fp32 and convert on the final store.  Set PLAIDML_FP16_ACC=0 to always
+// accumulate fp16 data in fp32.  8-bit integer sums accumulate in 32 bits.
+static DataType AggAccumulatorType(const FlatContraction& op) {
+  if (!op.generate_contraction) {
+    return op.agg_type;
+  }
+  if (op.agg_op != AggregationOp::SUM && op.agg_op != AggregationOp::PROD) {
+    // MAX/MIN/ASSIGN just select values; the accumulator width never
+    // affects the result.
+    return op.agg_type;
+  }
+  // Quantized contractions: sum 8-bit data into a 32-bit accumulator and
+  // narrow on the final store.  An i8 accumulator wraps after a handful of
+  // products, and the widened multiply-accumulate is also what the CPU and
+  // GPU backends need to see to use their 8-bit dot-product hardware.
+  // PLAIDML_I8_ACC_WIDE=0 restores the old wrapping behavior.
+  if (op.agg_type == DataType::INT8 && env::Get("PLAIDML_I8_ACC_WIDE") != "0") {
+    return DataType::INT32;
+  }
+  if (op.agg_type == DataType::UINT8 && env::Get("PLAIDML_I8_ACC_WIDE") != "0") {
+    return DataType::UINT32;
+  }
+  if (op.agg_type != DataType::FLOAT16) {
+    return op.agg_type;
+  }
+  if (env::Get("PLAIDML_FP16_ACC") == "0") {
+    return DataType::FLOAT32;
+  }
+  uint64_t reduce_elems = 1;
+  for (size_t i = 0; i < op.ranges.size(); i++) {
+    if (op.access[0].strides[i] == 0) {
+      reduce_elems *= op.ranges[i];
+    }
+  }
+  uint64_t max_reduce = 1024;
+  auto threshold = env::Get("PLAIDML_FP16_ACC_MAX_REDUCE");
+  if (!threshold.empty()) {
+    max_reduce = std::stoull(threshold);
+  }
+  return reduce_elems <= max_reduce ? DataType::FLOAT16 : DataType::FLOAT32;
+}
+
 KernelInfo GenContract(const string& kname, const DirectSettings& settings, const FlatContraction& op,
                        const std::vector<uint64_t>& tile, const Bindings& vars, const std::vector<std::string>& inputs,
                        const proto::PerfStats& perf) {
@@ -86,6 +173,10 @@ KernelInfo GenContract(const string& kname, const DirectSettings& settings, cons
   // Get size
   size_t sz = op.names.size();
 
+  // The accumulator may be wider than the output (see AggAccumulatorType);
+  // the final store narrows it back down.
+  DataType agg_dtype = AggAccumulatorType(op);
+
   if (op.agg_op == AggregationOp::ASSIGN) {
     for (size_t i = 0; i < sz; i++) {
       if (op.access[0].strides[i] == 0) {
@@ -197,11 +288,11 @@ KernelInfo GenContract(const string& kname, const DirectSettings& settings, cons
     // local shared memory variables.
 
     // Make agg_type + and string
-    sem::Type type = {sem::Type::VALUE, op.agg_type, op.agg_vec};
+    sem::Type type = {sem::Type::VALUE, agg_dtype, op.agg_vec};
 
     // Initalize local output variable to correct value based on agg_type
     auto tc = INITIAL_VALUES[op.agg_op];
-    sem::ExprPtr agg_base = _LimitConst(tc, op.agg_type);
+    sem::ExprPtr agg_base = _LimitConst(tc, agg_dtype);
     if (type.vec_width > 1) {
       agg_base = _Cast(type, agg_base);
     }
@@ -423,21 +514,44 @@ KernelInfo GenContract(const string& kname, const DirectSettings& settings, cons
     uint64_t comp_threads = threads / rthreads;
     if (out_threads < comp_threads) {
       auto mblock = _Block({});
-      sem::Type ltype = {sem::Type::VALUE, op.access[0].type, op.access[0].vector, threads, sem::Type::LOCAL};
+      sem::Type ltype = {sem::Type::VALUE, agg_dtype, op.access[0].vector, threads, sem::Type::LOCAL};
 
       // OpenCL requires that __local variables be defined at kernel function scope.
       auto merge_shared = _Declare(kblock, ltype, "merge_shared", sem::ExprPtr());
 
-      mblock->append(merge_shared[tid] = agg[_Const(0)]);
-      uint64_t x = comp_threads;
-      while (x > out_threads) {
+      if (UseSubgroupReduce(settings, op, out_threads, comp_threads, threads)) {
+        // Each subgroup folds its partials with shuffles (no barrier), parks
+        // one value per subgroup in local memory, and thread 0 combines the
+        // parked values: one barrier instead of a log2(threads) barrier tree.
+        sem::Type vtype = {sem::Type::VALUE, agg_dtype, op.agg_vec};
+        auto sg_reduce = std::make_shared<sem::CallExpr>(SubgroupReduceFn(op.agg_op),
+                                                         std::vector<sem::ExprPtr>{agg[_Const(0)]});
+        mblock->append(_Declare(vtype, "sg_val", sg_reduce));
+        auto sg_lid = _Declare(mblock, {sem::Type::INDEX}, "sg_lid", _Index(sem::IndexExpr::SUBGROUP_LOCAL, 0));
+        mblock->append(_If(sg_lid == _Const(0), merge_shared[_Index(sem::IndexExpr::SUBGROUP, 0)] = _("sg_val")));
+        mblock->append(_Barrier());
+        auto fold = _Block({});
+        fold->append(_Declare({sem::Type::INDEX}, "sg_i", _Const(1)));
+        fold->append(_Declare(vtype, "sg_tot", merge_shared[_Const(0)]));
+        auto fold_body = _Block({});
+        fold_body->append(_("sg_tot") = aggregate(op.agg_op, _("sg_tot"), merge_shared[_("sg_i")]));
+        fold_body->append(_("sg_i") = _("sg_i") + 1);
+        fold->append(_While(_("sg_i") < _Index(sem::IndexExpr::NUM_SUBGROUPS, 0), fold_body));
+        fold->append(agg[_Const(0)] = _("sg_tot"));
+        mblock->append(_If(tid == _Const(0), fold));
+        mblock->append(_Barrier());
+      } else {
+        mblock->append(merge_shared[tid] = agg[_Const(0)]);
+        uint64_t x = comp_threads;
+        while (x > out_threads) {
+          mblock->append(_Barrier());
+          x /= 2;
+          auto merge_agg = aggregate(op.agg_op, merge_shared[tid], merge_shared[tid + x]);
+          mblock->append(_If(tid < x, merge_shared[tid] = merge_agg));
+        }
         mblock->append(_Barrier());
-        x /= 2;
-        auto merge_agg = aggregate(op.agg_op, merge_shared[tid], merge_shared[tid + x]);
-        mblock->append(_If(tid < x, merge_shared[tid] = merge_agg));
+        mblock->append(_If(tid < out_threads, agg[_Const(0)] = merge_shared[tid]));
       }
-      mblock->append(_Barrier());
-      mblock->append(_If(tid < out_threads, agg[_Const(0)] = merge_shared[tid]));
       kblock->push_back(mblock);
     }
   } else {
@@ -454,10 +568,10 @@ KernelInfo GenContract(const string& kname, const DirectSettings& settings, cons
   if (op.generate_contraction) {
     // There was a contraction; this value comes from aggregation.
     LValueHolder agg_out = agg[out_plan.regIndex()];
-    sem::ExprPtr agg_min = _LimitConst(sem::LimitConst::MIN, op.agg_type);
-    sem::ExprPtr agg_zero = _LimitConst(sem::LimitConst::ZERO, op.agg_type);
+    sem::ExprPtr agg_min = _LimitConst(sem::LimitConst::MIN, agg_dtype);
+    sem::ExprPtr agg_zero = _LimitConst(sem::LimitConst::ZERO, agg_dtype);
     if (op.agg_vec > 1) {
-      sem::Type type = {sem::Type::VALUE, op.agg_type, op.agg_vec};
+      sem::Type type = {sem::Type::VALUE, agg_dtype, op.agg_vec};
       agg_min = _Cast(type, agg_min);
       agg_zero = _Cast(type, agg_zero);
     }
@@ -1,11 +1,13 @@
 
 #include "tile/lang/gen_special.h"
 
+#include <algorithm>
 #include <exception>
 #include <map>
 #include <memory>
 #include <utility>
 
+#include "base/util/env.h"
 #include "base/util/logging.h"
 #include "tile/lang/gid.h"
 #include "tile/lang/ops.h"
@@ -16,9 +18,132 @@ namespace vertexai {
 namespace tile {
 namespace lang {
 
+// A gather planned for coalescing: one workgroup per index entry, with
+// consecutive threads copying consecutive elements of that entry's data row,
+// so both the read from `data` and the write to `out` hit full cache lines.
+// Chosen from index-tensor statistics when rows are wide enough to occupy a
+// workgroup; the one-thread-per-element kernel keeps winning for narrow rows,
+// where mostly-idle groups would waste the machine.
+static void GenGatherCoalesced(KernelList& r, const Op& op, const Bindings& bindings,  // NOLINT(runtime/references)
+                               const std::string& kname, const HardwareSettings& settings) {
+  using namespace vertexai::tile::sem::builder;  // NOLINT
+  IVLOG(3, "Making a coalesced gather");
+
+  // Extract shapes to locals
+  const TensorShape out_shape = bindings.at(op.output).shape;
+  const TensorShape data_shape = bindings.at(op.inputs[0]).shape;
+  const TensorShape idx_shape = bindings.at(op.inputs[1]).shape;
+
+  size_t threads = std::max<size_t>(settings.threads, 1);
+  uint64_t row_elems = 1;
+  for (size_t i = 1; i < data_shape.dims.size(); i++) {
+    row_elems *= data_shape.dims[i].size;
+  }
+  uint64_t idx_count = 1;
+  for (const auto& d : idx_shape.dims) {
+    idx_count *= d.size;
+  }
+
+  auto idx_type = sem::Type(sem::Type::INDEX);
+  auto body = _Block({});
+  body->append(_Declare(idx_type, "group", _Index(sem::IndexExpr::GROUP, 0)));
+  body->append(_Declare(idx_type, "lid", _Index(sem::IndexExpr::LOCAL, 0)));
+
+  // Decompose the group id into the index tensor's dimensions (row-major)
+  // to locate this group's index element and its slice of the output.
+  sem::ExprPtr idx_offset = _Const(0);
+  sem::ExprPtr out_base = _Const(0);
+  sem::ExprPtr rem = _("group");
+  for (int i = static_cast<int>(idx_shape.dims.size()) - 1; i >= 0; i--) {
+    std::string var = "iidx" + std::to_string(i);
+    if (i > 0) {
+      body->append(_Declare(idx_type, var, rem % idx_shape.dims[i].size));
+      std::string rvar = "grem" + std::to_string(i);
+      body->append(_Declare(idx_type, rvar, rem / idx_shape.dims[i].size));
+      rem = _(rvar);
+    } else {
+      body->append(_Declare(idx_type, var, rem));
+    }
+    idx_offset = idx_offset + _(var) * idx_shape.dims[i].stride;
+    out_base = out_base + _(var) * out_shape.dims[i].stride;
+  }
+  body->append(_Declare(idx_type, "idx_off", idx_offset));
+  body->append(_Declare(idx_type, "row", _Clamp(_("idx")[_("idx_off")], _Const(0), _Const(data_shape.dims[0].size - 1))));
+  body->append(_Declare(idx_type, "out_base", out_base));
+
+  // Stride the workgroup across the row: thread t copies elements t,
+  // t + threads, ... so each generation of loads and stores is contiguous.
+  body->append(_Declare(idx_type, "e", _("lid")));
+  auto loop = _Block({});
+  sem::ExprPtr data_off = _("row") * data_shape.dims[0].stride;
+  sem::ExprPtr out_off = _("out_base");
+  sem::ExprPtr erem = _("e");
+  for (int i = static_cast<int>(data_shape.dims.size()) - 1; i >= 1; i--) {
+    std::string var = "didx" + std::to_string(i);
+    if (i > 1) {
+      loop->append(_Declare(idx_type, var, erem % data_shape.dims[i].size));
+      std::string rvar = "erem" + std::to_string(i);
+      loop->append(_Declare(idx_type, rvar, erem / data_shape.dims[i].size));
+      erem = _(rvar);
+    } else {
+      loop->append(_Declare(idx_type, var, erem));
+    }
+    data_off = data_off + _(var) * data_shape.dims[i].stride;
+    out_off = out_off + _(var) * out_shape.dims[idx_shape.dims.size() + i - 1].stride;
+  }
+  loop->append(_("out")[out_off] = _("data")[data_off]);
+  loop->append(_("e") = _("e") + threads);
+  body->append(_While(_("e") < row_elems, loop));
+
+  // Build function params
+  sem::Function::params_t params;
+  params.push_back(std::make_pair(sem::Type(sem::Type::POINTER_MUT, out_shape.type, 1, 0, sem::Type::GLOBAL), "out"));
+  params.push_back(
+      std::make_pair(sem::Type(sem::Type::POINTER_CONST, data_shape.type, 1, 0, sem::Type::GLOBAL), "data"));
+  params.push_back(std::make_pair(sem::Type(sem::Type::POINTER_CONST, idx_shape.type, 1, 0, sem::Type::GLOBAL), "idx"));
+
+  // Set kernel info
+  KernelInfo ki;
+  ki.kname = kname;
+  ki.outputs.push_back(op.output);
+  ki.inputs.push_back(r.var_rewrites.Lookup(op.inputs[0]));
+  ki.inputs.push_back(r.var_rewrites.Lookup(op.inputs[1]));
+  ki.kfunc = std::make_shared<sem::Function>(kname, sem::Type(sem::Type::TVOID), params, body);
+  uint64_t out_size = out_shape.elem_size();
+  ki.gwork = {{idx_count * threads, 1, 1}};
+  ki.lwork = {{threads, 1, 1}};
+  ki.tot_bytes = out_size * ((bit_width(out_shape.type) + 7) / 8);
+  ki.tot_flops = out_size;
+  auto pb = ki.info.mutable_special();
+  pb->set_fn(op.f.fn);
+  ki.info.set_flops(ki.tot_flops);
+  ki.info.set_bytes(ki.tot_bytes);
+
+  // Dump the code
+  sem::Print dump(*ki.kfunc);
+  IVLOG(4, "CODE:\n" << dump.str());
+  IVLOG(4, "gwork: " << ki.gwork << ", lwork: " << ki.lwork);
+  // Add to kernel list
+  r.kernels.push_back(ki);
+}
+
 static void GenGather(KernelList& r, const Op& op, const Bindings& bindings,  // NOLINT(runtime/references)
                       const std::string& kname, const HardwareSettings& settings) {
   using namespace vertexai::tile::sem::builder;  // NOLINT
+
+  // Plan the lowering from index-tensor statistics: rows wide enough to
+  // occupy a workgroup get the coalesced group-per-index kernel.
+  {
+    const TensorShape& data_shape = bindings.at(op.inputs[0]).shape;
+    uint64_t row_elems = 1;
+    for (size_t i = 1; i < data_shape.dims.size(); i++) {
+      row_elems *= data_shape.dims[i].size;
+    }
+    if (row_elems >= std::max<size_t>(settings.threads, 1) && env::Get("PLAIDML_COALESCED_GATHER") != "0") {
+      GenGatherCoalesced(r, op, bindings, kname, settings);
+      return;
+    }
+  }
   IVLOG(3, "Making a gather");
 
   // Extract shapes to locals
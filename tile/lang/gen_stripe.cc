@@ -1,6 +1,10 @@
 #include "tile/lang/gen_stripe.h"
 
+#include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,6 +24,60 @@ using namespace stripe;  // NOLINT
 
 namespace {
 
+// The bounds-phase result for one contraction: the defracted form and the
+// index bounds the ILP solver derived for it; interned so repeated layers
+// share one stored copy.
+struct CionEntry {
+  Contraction cion;
+  IndexBounds bounds;
+  std::vector<SimpleConstraint> simple_cons;
+};
+
+// Bounds-phase results keyed by the contraction text plus input shapes.
+// Networks repeat layer patterns constantly, and reduce/defract plus the
+// bounds ILP dominates GenerateStripe time on deep models; symbolically
+// identical contractions at the same sizes resolve to one entry, while the
+// residual distinct-size instances still warm start from the ILP solver's
+// own tableau cache.  Process-wide so batch compiles share it, and flushed
+// at a generous bound like FlatCache in compile.cc.
+class CionCache {
+ public:
+  static CionCache* Instance() {
+    static CionCache cache;
+    return &cache;
+  }
+
+  std::shared_ptr<const CionEntry> Lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock{mu_};
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+
+  void Insert(const std::string& key, const std::shared_ptr<const CionEntry>& entry) {
+    std::lock_guard<std::mutex> lock{mu_};
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.emplace(key, entry);
+  }
+
+ private:
+  static constexpr std::size_t kMaxEntries = 4096;
+  std::mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<const CionEntry>> entries_;
+};
+
+std::string CionCacheKey(const Contraction& cion, const std::vector<TensorShape>& shapes) {
+  std::ostringstream key;
+  // to_string() covers the specs, ops, and constraints; no_defract changes
+  // the pipeline below but isn't part of the printed form.
+  key << to_string(cion) << '|' << cion.no_defract;
+  for (const auto& shape : shapes) {
+    key << '|' << shape;
+  }
+  return key.str();
+}
+
 class StripeGenerator {
  public:
   explicit StripeGenerator(const RunInfo& runinfo, bool i8_mode)
@@ -28,7 +86,7 @@ class StripeGenerator {
     if (!runinfo.from_edsl) {
       if (runinfo_.program.ops.empty()) {
         Parser parser;
-        runinfo_.program = parser.Parse(runinfo_.code);
+        runinfo_.program = parser.ParseCached(runinfo_.code);
       }
       runinfo_.vars = BindProgram(&runinfo_.program, runinfo_.input_shapes, runinfo_.output_shapes);
       EnforceSpecifiedShapes();
@@ -164,7 +222,7 @@ class StripeGenerator {
   std::shared_ptr<Block> InitBuffer(Block* main, const Op& op, const TensorShape& shape) {
     auto stmt = std::make_shared<Block>();
     stmt->set_tag("kernel");
-    TensorShape interior_shape{shape.type, std::vector<TensorDimension>(shape.dims.size(), TensorDimension{1, 1})};
+    TensorShape interior_shape{shape.type, TensorDimensions(shape.dims.size(), TensorDimension{1, 1})};
     std::vector<Affine> dst_access;
     for (std::size_t idx = 0; idx < shape.dims.size(); ++idx) {
       if (shape.dims[idx].size == 1) {
@@ -215,20 +273,26 @@ class StripeGenerator {
       IVLOG(3, "Contraction output " << op.output << " size==0; skipping");
       return;
     }
-    Contraction cion;
-    std::vector<math::RangeConstraint> range_cons;
     auto shapes = MakeShapes(op.c);
-    std::tie(cion, range_cons) = CompileContraction(op.c, shapes);
-
-    // Compute bounds
-    IndexBounds bounds;
-    std::vector<SimpleConstraint> simple_cons;
-    try {
-      std::tie(bounds, simple_cons) = ComputeBounds(range_cons);
-    } catch (const std::runtime_error& ex) {
-      LOG(WARNING) << "Unable to compute bounds for contraction: " << to_string(cion);
-      throw;
+    auto key = CionCacheKey(op.c, shapes);
+    auto entry = CionCache::Instance()->Lookup(key);
+    if (!entry) {
+      auto fresh = std::make_shared<CionEntry>();
+      std::vector<math::RangeConstraint> range_cons;
+      std::tie(fresh->cion, range_cons) = CompileContraction(op.c, shapes);
+      // Compute bounds
+      try {
+        std::tie(fresh->bounds, fresh->simple_cons) = ComputeBounds(range_cons);
+      } catch (const std::runtime_error& ex) {
+        LOG(WARNING) << "Unable to compute bounds for contraction: " << to_string(fresh->cion);
+        throw;
+      }
+      CionCache::Instance()->Insert(key, fresh);
+      entry = std::move(fresh);
     }
+    const Contraction& cion = entry->cion;
+    const IndexBounds& bounds = entry->bounds;
+    const std::vector<SimpleConstraint>& simple_cons = entry->simple_cons;
 
     auto kernel = AddKernel(main, op);
     auto agg_op = GetAggOp(cion.agg_op);
@@ -797,6 +861,24 @@ std::shared_ptr<stripe::Program> GenerateStripe(const RunInfo& runinfo, bool i8_
   return StripeGenerator(runinfo, i8_mode).Run();
 }
 
+std::vector<std::shared_ptr<stripe::Program>> GenerateStripeBatch(const std::vector<RunInfo>& runinfos, bool i8_mode) {
+  // Pre-parse each distinct source once so the per-RunInfo generators
+  // below all hit the parse cache, whatever order they run in.
+  Parser parser;
+  std::set<std::string> seen;
+  for (const auto& runinfo : runinfos) {
+    if (!runinfo.from_edsl && runinfo.program.ops.empty() && seen.insert(runinfo.code).second) {
+      parser.ParseCached(runinfo.code);
+    }
+  }
+  std::vector<std::shared_ptr<stripe::Program>> programs;
+  programs.reserve(runinfos.size());
+  for (const auto& runinfo : runinfos) {
+    programs.push_back(GenerateStripe(runinfo, i8_mode));
+  }
+  return programs;
+}
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
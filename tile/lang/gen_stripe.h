@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "tile/lang/runinfo.h"
 #include "tile/stripe/stripe.h"
@@ -12,6 +13,14 @@ namespace lang {
 
 std::shared_ptr<stripe::Program> GenerateStripe(const RunInfo& runinfo, bool i8_mode = false);
 
+// Lowers a batch of closely-related programs in one call, sharing the
+// parse across RunInfos with identical source (e.g. one network
+// instantiated at several batch sizes); binding and lowering still run
+// per RunInfo, since they depend on the concrete shapes.  Returns one
+// stripe Program per RunInfo, in order.
+std::vector<std::shared_ptr<stripe::Program>> GenerateStripeBatch(const std::vector<RunInfo>& runinfos,
+                                                                  bool i8_mode = false);
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
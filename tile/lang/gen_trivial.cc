@@ -1,5 +1,6 @@
 #include "tile/lang/gen_trivial.h"
 
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -76,6 +77,118 @@ KernelInfo GenZero(const TensorShape& shape, const std::string& bname, const std
   return ki;
 }
 
+namespace {
+
+// The little-endian encoding of one element of the aggregation identity,
+// for HALs with hardware fill support.  An empty pattern means the
+// identity is all-zero bytes and the plain zero path applies.
+std::string IdentityBytes(const std::string& agg_op, DataType type) {
+  size_t bits = bit_width(type);
+  size_t width = (bits + 7) / 8;
+  auto encode = [width](uint64_t pattern) {
+    std::string out(width, '\0');
+    for (size_t i = 0; i < width; i++) {
+      out[i] = static_cast<char>((pattern >> (8 * i)) & 0xFF);
+    }
+    return out;
+  };
+  if (agg_op == "mul") {
+    switch (type) {
+      case DataType::FLOAT16:
+        return encode(0x3C00);
+      case DataType::FLOAT32: {
+        float one = 1.0f;
+        uint32_t pattern;
+        memcpy(&pattern, &one, sizeof(pattern));
+        return encode(pattern);
+      }
+      case DataType::FLOAT64: {
+        double one = 1.0;
+        uint64_t pattern;
+        memcpy(&pattern, &one, sizeof(pattern));
+        return encode(pattern);
+      }
+      default:
+        return encode(1);
+    }
+  }
+  if (agg_op == "max") {
+    switch (type) {
+      case DataType::FLOAT16:
+        return encode(0xFC00);  // -inf
+      case DataType::FLOAT32:
+        return encode(0xFF800000ull);  // -inf
+      case DataType::FLOAT64:
+        return encode(0xFFF0000000000000ull);  // -inf
+      default:
+        if (is_int(type)) {
+          return encode(1ull << (bits - 1));  // signed min
+        }
+        return "";  // unsigned/bool min is zero
+    }
+  }
+  if (agg_op == "min") {
+    switch (type) {
+      case DataType::FLOAT16:
+        return encode(0x7C00);  // +inf
+      case DataType::FLOAT32:
+        return encode(0x7F800000ull);  // +inf
+      case DataType::FLOAT64:
+        return encode(0x7FF0000000000000ull);  // +inf
+      default:
+        if (is_int(type)) {
+          return encode((1ull << (bits - 1)) - 1);  // signed max
+        }
+        return encode(~0ull);  // unsigned/bool max is all-ones
+    }
+  }
+  return "";  // "add" (and anything unrecognized): zero-fill
+}
+
+}  // namespace
+
+KernelInfo GenFill(const TensorShape& shape, const std::string& bname, const std::string& kname,
+                   const std::string& agg_op) {
+  using namespace sem::builder;  // NOLINT
+  uint64_t size = shape.elem_size();
+  IVLOG(2, "Making a " << agg_op << " identity fill for " << bname.c_str() << ", of size " << size);
+  sem::Function::params_t params;
+  sem::Type paramtype{sem::Type::POINTER_MUT, shape.type};
+  paramtype.region = sem::Type::GLOBAL;
+  params.push_back(std::make_pair(paramtype, "out"));
+  sem::Type voidret{sem::Type::TVOID};
+  sem::ExprPtr val;
+  if (agg_op == "mul") {
+    val = _LimitConst(sem::LimitConst::ONE, shape.type);
+  } else if (agg_op == "max") {
+    val = _LimitConst(sem::LimitConst::MIN, shape.type);
+  } else if (agg_op == "min") {
+    val = _LimitConst(sem::LimitConst::MAX, shape.type);
+  } else {
+    val = _Const(0);
+  }
+  sem::StmtPtr body = _Block({_("out")[_Index(sem::IndexExpr::GLOBAL, 0)] = val});
+  auto func = std::make_shared<sem::Function>(kname, voidret, params, body);
+
+  KernelInfo ki;
+  ki.kname = kname;
+  ki.kfunc = func;
+  ki.outputs.push_back(bname);
+  ki.gwork[0] = size;
+  ki.gwork[1] = 1;
+  ki.gwork[2] = 1;
+  ki.lwork[0] = ki.lwork[1] = ki.lwork[2] = 0;
+  ki.tot_bytes = size * ((bit_width(shape.type) + 7) / 8);
+  ki.tot_flops = size;
+  auto pb = ki.info.mutable_zero();
+  pb->set_copy(false);
+  pb->set_fill(IdentityBytes(agg_op, shape.type));
+  ki.info.set_flops(ki.tot_flops);
+  ki.info.set_bytes(ki.tot_bytes);
+  ki.ktype = KernelType::kZero;
+  return ki;
+}
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
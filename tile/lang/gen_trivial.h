@@ -12,6 +12,12 @@ namespace lang {
 KernelInfo GenCopy(const TensorShape& shape, const std::string& oname, const std::string& iname,
                    const std::string& kname);
 KernelInfo GenZero(const TensorShape& shape, const std::string& bname, const std::string& kname);
+// Like GenZero, but fills the buffer with the identity of the given
+// aggregation op ("add", "mul", "min" or "max") instead of zero, e.g. -inf
+// for a float max.  The kernel's ZeroInfo carries the element pattern so
+// HALs with hardware fill support can skip the kernel entirely.
+KernelInfo GenFill(const TensorShape& shape, const std::string& bname, const std::string& kname,
+                   const std::string& agg_op);
 
 }  // namespace lang
 }  // namespace tile
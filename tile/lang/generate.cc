@@ -14,6 +14,7 @@
 #include "tile/lang/compile.h"
 #include "tile/lang/flat.h"
 #include "tile/lang/fpconv.h"
+#include "tile/lang/gen_batch.h"
 #include "tile/lang/gen_contract.h"
 #include "tile/lang/gen_special.h"
 #include "tile/lang/gen_trivial.h"
@@ -998,6 +999,9 @@ KernelList GenerateProgram(const Program& prog, const ShapeMap& inputs, const Sh
   KernelList result;
   result = Compile(prog, inputs, outputs, settings, kid, tile_trials, optimizer);
   Simplify(result.kernels);
+  StrengthReduce(result.kernels);
+  EliminateCommonSubexpr(result.kernels);
+  BatchEltwiseKernels(&result, settings);
   return result;
 }
 
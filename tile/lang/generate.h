@@ -29,6 +29,9 @@ struct DirectSettings {
   bool use_global;   // Use only global memory? (No local)
   // Memory width effects cache estimates and kernel loop orders
   uint64_t mem_width;  // How wide is a cache line
+  // Lower reductions via subgroup shuffle intrinsics where the pattern
+  // allows.  Not serialized: it changes kernel lowering, not tiling.
+  bool subgroup_reduce = false;
 
   TRANSFER_OBJECT {
     VERSION(0);
@@ -49,6 +52,9 @@ struct HardwareSettings : public DirectSettings {
   uint64_t goal_flops_per_byte;                   // Where do we hit the ceiling on flops/byte
   std::vector<std::size_t> goal_dimension_sizes;  // How big to make each dimension in a work group
   bool disable_io_aliasing;
+  // Elementwise kernels with at most this many work items are batched into
+  // shared launches to amortize launch overhead; zero disables batching.
+  uint64_t batch_work_limit = 0;
 };
 
 typedef std::array<size_t, 3> GridSize;
@@ -1,6 +1,7 @@
 #include <utility>
 
 #include "base/util/catch.h"
+#include "tile/base/lru_cache.h"
 #include "tile/lang/parser.h"
 #include "tile/lang/parser.y.h"
 #include "tile/lang/parser_lex.h"
@@ -35,6 +36,14 @@ Program Parser::Parse(const std::string& code, const std::string& id) const {
   return parse_helper(code, 0, id).program;
 }
 
+Program Parser::ParseCached(const std::string& code, const std::string& id) const {
+  // Sized to hold the distinct function bodies of a large front-end model
+  // (keras-scale networks emit a few hundred), so a model rebuild is all
+  // cache hits.
+  static LruCache<std::pair<std::string, std::string>, Program> cache{500};
+  return cache.Lookup(std::make_pair(code, id), [&]() { return Parse(code, id); });
+}
+
 Program Parser::ParseExpr(const std::string& code, int64_t start_tmp) const {
   return parse_helper("expression " + code + ";", start_tmp).program;
 }
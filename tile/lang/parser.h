@@ -11,6 +11,10 @@ namespace lang {
 class Parser final {
  public:
   Program Parse(const std::string& code, const std::string& id = "") const;
+  // Like Parse, but memoizes the result in a process-wide cache keyed
+  // by (code, id).  Closely-related programs -- e.g. the same network
+  // compiled at several batch sizes -- share a single parse.
+  Program ParseCached(const std::string& code, const std::string& id = "") const;
   Program ParseExpr(const std::string& code, int64_t start_tmp = 0) const;
   math::Polynomial<math::Rational> ParsePolynomial(const std::string& poly) const;
   Contraction ParseContraction(const std::string& contract) const;
@@ -240,6 +240,15 @@ void Print::Visit(const IndexExpr& n) {
     case sem::IndexExpr::LOCAL:
       emit("get_local_id(" + std::to_string(n.dim) + ")");
       break;
+    case sem::IndexExpr::SUBGROUP:
+      emit("get_sub_group_id()");
+      break;
+    case sem::IndexExpr::SUBGROUP_LOCAL:
+      emit("get_sub_group_local_id()");
+      break;
+    case sem::IndexExpr::NUM_SUBGROUPS:
+      emit("get_num_sub_groups()");
+      break;
     default:
       throw std::runtime_error("Invalid IndexExpr type");
   }
@@ -76,6 +76,9 @@ CallExpr::CallExpr(Function f, const std::vector<ExprPtr>& v) : function(f), val
       {Function::POW, "pow"},   {Function::ROUND, "round"},
       {Function::SIN, "sin"},   {Function::SINH, "sinh"},
       {Function::SQRT, "sqrt"}, {Function::SUB_GROUP_BROADCAST, "sub_group_broadcast"},
+      {Function::SUB_GROUP_REDUCE_ADD, "sub_group_reduce_add"},
+      {Function::SUB_GROUP_REDUCE_MAX, "sub_group_reduce_max"},
+      {Function::SUB_GROUP_REDUCE_MIN, "sub_group_reduce_min"},
       {Function::TAN, "tan"},   {Function::TANH, "tanh"},
   };
   name = names.at(f);
@@ -105,6 +108,9 @@ CallExpr::CallExpr(ExprPtr f, const std::vector<ExprPtr>& v) : vals(v) {
       {"pow", Function::POW},   {"round", Function::ROUND},
       {"sin", Function::SIN},   {"sinh", Function::SINH},
       {"sqrt", Function::SQRT}, {"sub_group_broadcast", Function::SUB_GROUP_BROADCAST},
+      {"sub_group_reduce_add", Function::SUB_GROUP_REDUCE_ADD},
+      {"sub_group_reduce_max", Function::SUB_GROUP_REDUCE_MAX},
+      {"sub_group_reduce_min", Function::SUB_GROUP_REDUCE_MIN},
       {"tan", Function::TAN},   {"tanh", Function::TANH},
   };
   auto it = functions.find(name);
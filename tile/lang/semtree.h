@@ -196,6 +196,9 @@ struct CallExpr : public Expression {
     SINH,
     SQRT,
     SUB_GROUP_BROADCAST,
+    SUB_GROUP_REDUCE_ADD,
+    SUB_GROUP_REDUCE_MAX,
+    SUB_GROUP_REDUCE_MIN,
     TAN,
     TANH,
   };
@@ -220,7 +223,7 @@ struct LimitConst : public Expression {
 
 // Represents an thread/grid id value
 struct IndexExpr : public Expression {
-  enum Type { GLOBAL, GROUP, LOCAL };
+  enum Type { GLOBAL, GROUP, LOCAL, SUBGROUP, SUBGROUP_LOCAL, NUM_SUBGROUPS };
   Type type;
   size_t dim;
   IndexExpr(Type _type, size_t _dim) : type(_type), dim(_dim) {}
@@ -1,8 +1,17 @@
 #include "tile/lang/simplifier.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "tile/lang/exprtype.h"
+#include "tile/lang/fnv1a64.h"
 #include "tile/lang/scope.h"
 #include "tile/lang/sembuilder.h"
 #include "tile/lang/semprinter.h"
@@ -456,6 +465,792 @@ class Simplifier : public Visitor {
   lang::Scope<Symbol>* scope_;
 };
 
+// Strength reduction and loop-invariant hoisting for index math.
+//
+// gen_contract emits per-element offset declarations that recompute
+// multi-term affine expressions on every loop iteration; constant folding
+// alone leaves several integer multiplies per element in the inner loops.
+// This pass rewrites index declarations in a loop body that are affine in the
+// loop variable into an induction variable: the base value is hoisted above
+// the loop and a constant-stride increment is appended to the bottom of the
+// body.  Fully loop-invariant index declarations are hoisted out entirely.
+
+namespace {
+
+void CollectNames(const StmtPtr& stmt, std::map<std::string, int>* declared, std::set<std::string>* stored) {
+  if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+    for (const auto& inner : block->statements) {
+      CollectNames(inner, declared, stored);
+    }
+  } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+    if (if_stmt->iftrue) {
+      CollectNames(if_stmt->iftrue, declared, stored);
+    }
+    if (if_stmt->iffalse) {
+      CollectNames(if_stmt->iffalse, declared, stored);
+    }
+  } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+    CollectNames(for_stmt->inner, declared, stored);
+  } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+    CollectNames(while_stmt->inner, declared, stored);
+  } else if (auto decl = std::dynamic_pointer_cast<DeclareStmt>(stmt)) {
+    (*declared)[decl->name]++;
+  } else if (auto store = std::dynamic_pointer_cast<StoreStmt>(stmt)) {
+    // Only a store to the bare variable modifies it; a store through a
+    // subscript writes memory, not the name.
+    if (auto lookup = std::dynamic_pointer_cast<LookupLVal>(store->lhs)) {
+      stored->insert(lookup->name);
+    }
+  }
+}
+
+// Whether the expression is safe to evaluate before the loop and yields the
+// same value on every iteration.  Conservative: only simple arithmetic over
+// constants, thread indexes, and variables the loop body doesn't modify (no
+// division, which could trap when hoisted past a zero-trip loop).
+bool IsInvariant(const ExprPtr& expr, const std::set<std::string>& banned) {
+  if (std::dynamic_pointer_cast<IntConst>(expr) || std::dynamic_pointer_cast<FloatConst>(expr) ||
+      std::dynamic_pointer_cast<LimitConst>(expr) || std::dynamic_pointer_cast<IndexExpr>(expr)) {
+    return true;
+  }
+  if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+    auto lookup = std::dynamic_pointer_cast<LookupLVal>(load->inner);
+    return lookup && !banned.count(lookup->name);
+  }
+  if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+    return unary->op == "-" && IsInvariant(unary->inner, banned);
+  }
+  if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+    return (binary->op == "+" || binary->op == "-" || binary->op == "*") &&
+           IsInvariant(binary->lhs, banned) && IsInvariant(binary->rhs, banned);
+  }
+  if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+    return IsInvariant(cast->val, banned);
+  }
+  return false;
+}
+
+// Expression combiners over "nullptr means zero" parts, folding constants as
+// they go so the common all-constant strides don't need a re-simplify.
+ExprPtr AddParts(const ExprPtr& lhs, const ExprPtr& rhs) {
+  if (lhs.get() == nullptr) {
+    return rhs;
+  }
+  if (rhs.get() == nullptr) {
+    return lhs;
+  }
+  auto lhs_int = std::dynamic_pointer_cast<IntConst>(lhs);
+  auto rhs_int = std::dynamic_pointer_cast<IntConst>(rhs);
+  if (lhs_int && rhs_int) {
+    return std::make_shared<IntConst>(lhs_int->value + rhs_int->value);
+  }
+  return std::make_shared<BinaryExpr>("+", lhs, rhs);
+}
+
+ExprPtr SubParts(const ExprPtr& lhs, const ExprPtr& rhs) {
+  if (rhs.get() == nullptr) {
+    return lhs;
+  }
+  auto rhs_int = std::dynamic_pointer_cast<IntConst>(rhs);
+  if (lhs.get() == nullptr) {
+    if (rhs_int) {
+      return std::make_shared<IntConst>(-rhs_int->value);
+    }
+    return std::make_shared<UnaryExpr>("-", rhs);
+  }
+  auto lhs_int = std::dynamic_pointer_cast<IntConst>(lhs);
+  if (lhs_int && rhs_int) {
+    return std::make_shared<IntConst>(lhs_int->value - rhs_int->value);
+  }
+  return std::make_shared<BinaryExpr>("-", lhs, rhs);
+}
+
+ExprPtr MulParts(const ExprPtr& lhs, const ExprPtr& rhs) {
+  if (lhs.get() == nullptr || rhs.get() == nullptr) {
+    return ExprPtr();
+  }
+  auto lhs_int = std::dynamic_pointer_cast<IntConst>(lhs);
+  auto rhs_int = std::dynamic_pointer_cast<IntConst>(rhs);
+  if (lhs_int && rhs_int) {
+    return std::make_shared<IntConst>(lhs_int->value * rhs_int->value);
+  }
+  if (lhs_int && lhs_int->value == 1) {
+    return rhs;
+  }
+  if (rhs_int && rhs_int->value == 1) {
+    return lhs;
+  }
+  return std::make_shared<BinaryExpr>("*", lhs, rhs);
+}
+
+// Decomposes `expr` as (coeff * var + base) with both parts loop-invariant;
+// either part comes back nullptr when it's zero.
+bool Decompose(const ExprPtr& expr, const std::string& var, const std::set<std::string>& banned,  //
+               ExprPtr* coeff, ExprPtr* base) {
+  if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+    auto lookup = std::dynamic_pointer_cast<LookupLVal>(load->inner);
+    if (lookup && lookup->name == var) {
+      *coeff = std::make_shared<IntConst>(1);
+      *base = ExprPtr();
+      return true;
+    }
+  }
+  if (IsInvariant(expr, banned)) {
+    *coeff = ExprPtr();
+    *base = expr;
+    return true;
+  }
+  auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr);
+  if (binary.get() == nullptr) {
+    return false;
+  }
+  ExprPtr lhs_coeff;
+  ExprPtr lhs_base;
+  ExprPtr rhs_coeff;
+  ExprPtr rhs_base;
+  if (binary->op == "+" || binary->op == "-") {
+    if (!Decompose(binary->lhs, var, banned, &lhs_coeff, &lhs_base) ||
+        !Decompose(binary->rhs, var, banned, &rhs_coeff, &rhs_base)) {
+      return false;
+    }
+    if (binary->op == "+") {
+      *coeff = AddParts(lhs_coeff, rhs_coeff);
+      *base = AddParts(lhs_base, rhs_base);
+    } else {
+      *coeff = SubParts(lhs_coeff, rhs_coeff);
+      *base = SubParts(lhs_base, rhs_base);
+    }
+    return true;
+  }
+  if (binary->op == "*") {
+    if (IsInvariant(binary->lhs, banned) && Decompose(binary->rhs, var, banned, &rhs_coeff, &rhs_base)) {
+      *coeff = MulParts(binary->lhs, rhs_coeff);
+      *base = MulParts(binary->lhs, rhs_base);
+      return true;
+    }
+    if (IsInvariant(binary->rhs, banned) && Decompose(binary->lhs, var, banned, &lhs_coeff, &lhs_base)) {
+      *coeff = MulParts(lhs_coeff, binary->rhs);
+      *base = MulParts(lhs_base, binary->rhs);
+      return true;
+    }
+  }
+  return false;
+}
+
+void RenameLoads(const LValPtr& lval, const std::string& from, const std::string& to);
+void RenameLoads(const StmtPtr& stmt, const std::string& from, const std::string& to);
+
+void RenameLoads(const ExprPtr& expr, const std::string& from, const std::string& to) {
+  if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+    RenameLoads(load->inner, from, to);
+  } else if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+    RenameLoads(unary->inner, from, to);
+  } else if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+    RenameLoads(binary->lhs, from, to);
+    RenameLoads(binary->rhs, from, to);
+  } else if (auto cond = std::dynamic_pointer_cast<CondExpr>(expr)) {
+    RenameLoads(cond->cond, from, to);
+    RenameLoads(cond->tcase, from, to);
+    RenameLoads(cond->fcase, from, to);
+  } else if (auto select = std::dynamic_pointer_cast<SelectExpr>(expr)) {
+    RenameLoads(select->cond, from, to);
+    RenameLoads(select->tcase, from, to);
+    RenameLoads(select->fcase, from, to);
+  } else if (auto clamp = std::dynamic_pointer_cast<ClampExpr>(expr)) {
+    RenameLoads(clamp->val, from, to);
+    RenameLoads(clamp->min, from, to);
+    RenameLoads(clamp->max, from, to);
+  } else if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+    RenameLoads(cast->val, from, to);
+  } else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+    for (const auto& val : call->vals) {
+      RenameLoads(val, from, to);
+    }
+  }
+}
+
+void RenameLoads(const LValPtr& lval, const std::string& from, const std::string& to) {
+  if (auto lookup = std::dynamic_pointer_cast<LookupLVal>(lval)) {
+    if (lookup->name == from) {
+      lookup->name = to;
+    }
+  } else if (auto subscript = std::dynamic_pointer_cast<SubscriptLVal>(lval)) {
+    RenameLoads(subscript->ptr, from, to);
+    RenameLoads(subscript->offset, from, to);
+  }
+}
+
+void RenameLoads(const StmtPtr& stmt, const std::string& from, const std::string& to) {
+  if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+    for (const auto& inner : block->statements) {
+      RenameLoads(inner, from, to);
+    }
+  } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+    RenameLoads(if_stmt->cond, from, to);
+    if (if_stmt->iftrue) {
+      RenameLoads(if_stmt->iftrue, from, to);
+    }
+    if (if_stmt->iffalse) {
+      RenameLoads(if_stmt->iffalse, from, to);
+    }
+  } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+    if (for_stmt->var != from) {
+      RenameLoads(for_stmt->inner, from, to);
+    }
+  } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+    RenameLoads(while_stmt->cond, from, to);
+    RenameLoads(while_stmt->inner, from, to);
+  } else if (auto store = std::dynamic_pointer_cast<StoreStmt>(stmt)) {
+    RenameLoads(store->lhs, from, to);
+    RenameLoads(store->rhs, from, to);
+  } else if (auto decl = std::dynamic_pointer_cast<DeclareStmt>(stmt)) {
+    if (decl->init) {
+      RenameLoads(decl->init, from, to);
+    }
+  } else if (auto ret = std::dynamic_pointer_cast<ReturnStmt>(stmt)) {
+    if (ret->value) {
+      RenameLoads(ret->value, from, to);
+    }
+  } else if (auto special = std::dynamic_pointer_cast<SpecialStmt>(stmt)) {
+    for (const auto& param : special->params) {
+      RenameLoads(param, from, to);
+    }
+  }
+}
+
+class StrengthReducer {
+ public:
+  void Process(const StmtPtr& stmt) {
+    if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+      ProcessBlock(block.get());
+    } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+      if (if_stmt->iftrue) {
+        Process(if_stmt->iftrue);
+      }
+      if (if_stmt->iffalse) {
+        Process(if_stmt->iffalse);
+      }
+    } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+      // A loop not directly inside a block has nowhere to hoist to; just
+      // process its body.
+      Process(for_stmt->inner);
+    } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+      Process(while_stmt->inner);
+    }
+  }
+
+ private:
+  void ProcessBlock(Block* block) {
+    std::vector<StmtPtr> out;
+    out.reserve(block->statements.size());
+    for (const auto& stmt : block->statements) {
+      if (auto loop = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+        Process(loop->inner);
+        ReduceLoop(loop.get(), &out);
+      } else {
+        Process(stmt);
+      }
+      out.push_back(stmt);
+    }
+    block->statements.swap(out);
+  }
+
+  void ReduceLoop(ForStmt* loop, std::vector<StmtPtr>* out) {
+    auto body = std::dynamic_pointer_cast<Block>(loop->inner);
+    if (!body) {
+      return;
+    }
+    std::map<std::string, int> declared;
+    std::set<std::string> stored;
+    CollectNames(loop->inner, &declared, &stored);
+    std::set<std::string> banned{loop->var};
+    for (const auto& kvp : declared) {
+      banned.insert(kvp.first);
+    }
+    banned.insert(stored.begin(), stored.end());
+    std::vector<StmtPtr> new_body;
+    new_body.reserve(body->statements.size());
+    std::vector<StmtPtr> increments;
+    for (const auto& stmt : body->statements) {
+      auto decl = std::dynamic_pointer_cast<DeclareStmt>(stmt);
+      // Only reduce single, unmodified index declarations at the top level
+      // of the body; anything shadowed or stored-to stays as-is.
+      if (!decl || decl->type.base != Type::INDEX || decl->type.array || decl->init.get() == nullptr ||  //
+          stored.count(decl->name) || declared[decl->name] != 1) {
+        new_body.push_back(stmt);
+        continue;
+      }
+      ExprPtr coeff;
+      ExprPtr base;
+      if (!Decompose(decl->init, loop->var, banned, &coeff, &base)) {
+        new_body.push_back(stmt);
+        continue;
+      }
+      auto name = decl->name + "_sr" + std::to_string(next_id_++);
+      out->push_back(std::make_shared<DeclareStmt>(decl->type, name, base ? base : std::make_shared<IntConst>(0)));
+      if (coeff) {
+        auto step = MulParts(coeff, std::make_shared<IntConst>(loop->step));
+        auto lval = std::make_shared<LookupLVal>(name);
+        auto next = std::make_shared<BinaryExpr>("+", std::make_shared<LoadExpr>(lval), step);
+        increments.push_back(std::make_shared<StoreStmt>(lval, next));
+      }
+      RenameLoads(loop->inner, decl->name, name);
+      // The hoisted variable varies with the loop; later declarations in
+      // this body must not treat it as invariant.
+      banned.insert(name);
+    }
+    if (new_body.size() == body->statements.size()) {
+      return;
+    }
+    new_body.insert(new_body.end(), increments.begin(), increments.end());
+    body->statements.swap(new_body);
+  }
+
+  size_t next_id_ = 0;
+};
+
+void CollectLoopVars(const StmtPtr& stmt, std::map<std::string, int>* vars) {
+  if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+    for (const auto& inner : block->statements) {
+      CollectLoopVars(inner, vars);
+    }
+  } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+    if (if_stmt->iftrue) {
+      CollectLoopVars(if_stmt->iftrue, vars);
+    }
+    if (if_stmt->iffalse) {
+      CollectLoopVars(if_stmt->iffalse, vars);
+    }
+  } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+    (*vars)[for_stmt->var]++;
+    CollectLoopVars(for_stmt->inner, vars);
+  } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+    CollectLoopVars(while_stmt->inner, vars);
+  }
+}
+
+// Structural facts about an expression, gathered in one bottom-up walk: an
+// fnv1a64 value-numbering hash, the operation count, and whether the
+// expression always yields the same value for the same variable bindings
+// (i.e. reads only names that are never reassigned, and can't trap if
+// evaluated speculatively - so no division).
+struct ExprFacts {
+  std::uint64_t hash = fnv1a64::basis;
+  size_t ops = 0;
+  bool pure = false;
+};
+
+class CseReducer {
+ public:
+  explicit CseReducer(const std::shared_ptr<Function>& func) : func_{func} {}
+
+  void Run() {
+    std::map<std::string, int> declared;
+    std::map<std::string, int> loop_vars;
+    CollectNames(func_->body, &declared, &excluded_);
+    CollectLoopVars(func_->body, &loop_vars);
+    for (const auto& kvp : declared) {
+      used_names_.insert(kvp.first);
+      // Shadowed names make textually identical loads ambiguous; leave them
+      // alone.
+      if (kvp.second > 1 || loop_vars.count(kvp.first)) {
+        excluded_.insert(kvp.first);
+      }
+    }
+    for (const auto& kvp : loop_vars) {
+      used_names_.insert(kvp.first);
+      if (kvp.second > 1) {
+        excluded_.insert(kvp.first);
+      }
+    }
+    CountStmt(func_->body);
+    auto body = std::dynamic_pointer_cast<Block>(func_->body);
+    if (!body) {
+      return;
+    }
+    ProcessBlock(body.get(), func_->params);
+  }
+
+ private:
+  struct Entry {
+    std::string repr;
+    std::string name;
+  };
+
+  struct Frame {
+    std::vector<StmtPtr>* out = nullptr;
+    std::map<std::uint64_t, std::vector<Entry>> exprs;
+    std::map<std::string, Type> vars;
+    std::unique_ptr<lang::Scope<Type>> scope;
+  };
+
+  static std::uint64_t HashWord(std::uint64_t h, std::uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+      h = (h ^ (v & 0xff)) * fnv1a64::prime;
+      v >>= 8;
+    }
+    return h;
+  }
+
+  static std::uint64_t HashString(std::uint64_t h, const std::string& s) {
+    for (char c : s) {
+      h = (h ^ static_cast<unsigned char>(c)) * fnv1a64::prime;
+    }
+    return h;
+  }
+
+  ExprFacts Facts(const ExprPtr& expr) {
+    ExprFacts facts;
+    if (auto int_const = std::dynamic_pointer_cast<IntConst>(expr)) {
+      facts.hash = HashWord(fnv1a64::hashlit("int"), static_cast<std::uint64_t>(int_const->value));
+      facts.pure = true;
+    } else if (auto float_const = std::dynamic_pointer_cast<FloatConst>(expr)) {
+      std::uint64_t bits;
+      std::memcpy(&bits, &float_const->value, sizeof(bits));
+      facts.hash = HashWord(fnv1a64::hashlit("float"), bits);
+      facts.pure = true;
+    } else if (auto limit = std::dynamic_pointer_cast<LimitConst>(expr)) {
+      facts.hash = HashWord(HashWord(fnv1a64::hashlit("limit"), limit->which), static_cast<std::uint64_t>(limit->type));
+      facts.pure = true;
+    } else if (auto index = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+      facts.hash = HashWord(HashWord(fnv1a64::hashlit("index"), index->type), index->dim);
+      facts.pure = true;
+    } else if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+      auto lookup = std::dynamic_pointer_cast<LookupLVal>(load->inner);
+      if (lookup) {
+        facts.hash = HashString(fnv1a64::hashlit("load"), lookup->name);
+        facts.pure = !excluded_.count(lookup->name);
+      }
+    } else if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+      auto inner = Facts(unary->inner);
+      facts.hash = HashWord(HashString(fnv1a64::hashlit("unary"), unary->op), inner.hash);
+      facts.ops = inner.ops + 1;
+      facts.pure = inner.pure && unary->op != "++" && unary->op != "--";
+    } else if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+      auto lhs = Facts(binary->lhs);
+      auto rhs = Facts(binary->rhs);
+      facts.hash = HashWord(HashWord(HashString(fnv1a64::hashlit("binary"), binary->op), lhs.hash), rhs.hash);
+      facts.ops = lhs.ops + rhs.ops + 1;
+      facts.pure = lhs.pure && rhs.pure && binary->op != "/" && binary->op != "%";
+    } else if (auto cond = std::dynamic_pointer_cast<CondExpr>(expr)) {
+      facts = TernaryFacts("cond", cond->cond, cond->tcase, cond->fcase);
+    } else if (auto select = std::dynamic_pointer_cast<SelectExpr>(expr)) {
+      facts = TernaryFacts("select", select->cond, select->tcase, select->fcase);
+    } else if (auto clamp = std::dynamic_pointer_cast<ClampExpr>(expr)) {
+      facts = TernaryFacts("clamp", clamp->val, clamp->min, clamp->max);
+    } else if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+      auto val = Facts(cast->val);
+      auto h = HashWord(fnv1a64::hashlit("cast"), cast->type.base);
+      h = HashWord(h, static_cast<std::uint64_t>(cast->type.dtype));
+      h = HashWord(h, cast->type.vec_width);
+      facts.hash = HashWord(h, val.hash);
+      facts.ops = val.ops;
+      facts.pure = val.pure;
+    } else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      auto h = HashString(fnv1a64::hashlit("call"), call->name);
+      facts.ops = 1;
+      facts.pure = true;
+      for (const auto& val : call->vals) {
+        auto arg = Facts(val);
+        h = HashWord(h, arg.hash);
+        facts.ops += arg.ops;
+        facts.pure = facts.pure && arg.pure;
+      }
+      facts.hash = h;
+    }
+    return facts;
+  }
+
+  ExprFacts TernaryFacts(const char* tag, const ExprPtr& a, const ExprPtr& b, const ExprPtr& c) {
+    auto fa = Facts(a);
+    auto fb = Facts(b);
+    auto fc = Facts(c);
+    ExprFacts facts;
+    facts.hash = HashWord(HashWord(HashWord(HashString(fnv1a64::basis, tag), fa.hash), fb.hash), fc.hash);
+    facts.ops = fa.ops + fb.ops + fc.ops + 1;
+    facts.pure = fa.pure && fb.pure && fc.pure;
+    return facts;
+  }
+
+  bool Candidate(const ExprFacts& facts) { return facts.pure && facts.ops >= 2; }
+
+  // -- Occurrence counting pass ------------------------------------------
+
+  void CountExpr(const ExprPtr& expr) {
+    if (expr.get() == nullptr) {
+      return;
+    }
+    auto facts = Facts(expr);
+    if (Candidate(facts)) {
+      counts_[facts.hash]++;
+    }
+    if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+      if (auto sub = std::dynamic_pointer_cast<SubscriptLVal>(load->inner)) {
+        CountExpr(sub->offset);
+      }
+    } else if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+      CountExpr(unary->inner);
+    } else if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+      CountExpr(binary->lhs);
+      CountExpr(binary->rhs);
+    } else if (auto cond = std::dynamic_pointer_cast<CondExpr>(expr)) {
+      CountExpr(cond->cond);
+      CountExpr(cond->tcase);
+      CountExpr(cond->fcase);
+    } else if (auto select = std::dynamic_pointer_cast<SelectExpr>(expr)) {
+      CountExpr(select->cond);
+      CountExpr(select->tcase);
+      CountExpr(select->fcase);
+    } else if (auto clamp = std::dynamic_pointer_cast<ClampExpr>(expr)) {
+      CountExpr(clamp->val);
+      CountExpr(clamp->min);
+      CountExpr(clamp->max);
+    } else if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+      CountExpr(cast->val);
+    } else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      for (const auto& val : call->vals) {
+        CountExpr(val);
+      }
+    }
+  }
+
+  void CountStmt(const StmtPtr& stmt) {
+    if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+      for (const auto& inner : block->statements) {
+        CountStmt(inner);
+      }
+    } else if (auto decl = std::dynamic_pointer_cast<DeclareStmt>(stmt)) {
+      CountExpr(decl->init);
+    } else if (auto store = std::dynamic_pointer_cast<StoreStmt>(stmt)) {
+      if (auto sub = std::dynamic_pointer_cast<SubscriptLVal>(store->lhs)) {
+        CountExpr(sub->offset);
+      }
+      CountExpr(store->rhs);
+    } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+      CountExpr(if_stmt->cond);
+      CountStmt(if_stmt->iftrue);
+      CountStmt(if_stmt->iffalse);
+    } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+      CountStmt(for_stmt->inner);
+    } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+      CountExpr(while_stmt->cond);
+      CountStmt(while_stmt->inner);
+    } else if (auto ret = std::dynamic_pointer_cast<ReturnStmt>(stmt)) {
+      CountExpr(ret->value);
+    } else if (auto special = std::dynamic_pointer_cast<SpecialStmt>(stmt)) {
+      for (const auto& param : special->params) {
+        CountExpr(param);
+      }
+    }
+  }
+
+  // -- Rewrite pass ------------------------------------------------------
+
+  void ProcessBlock(Block* block, const std::vector<std::pair<Type, std::string>>& bindings) {
+    auto frame = std::make_unique<Frame>();
+    auto parent_scope = frames_.empty() ? nullptr : frames_.back()->scope.get();
+    frame->scope = std::make_unique<lang::Scope<Type>>(parent_scope);
+    std::vector<StmtPtr> out;
+    out.reserve(block->statements.size());
+    frame->out = &out;
+    for (const auto& binding : bindings) {
+      frame->vars[binding.second] = binding.first;
+      if (!frame->scope->Defines(binding.second)) {
+        frame->scope->Bind(binding.second, binding.first);
+      }
+    }
+    frames_.push_back(std::move(frame));
+    for (const auto& stmt : block->statements) {
+      ProcessStmt(stmt);
+      frames_.back()->out->push_back(stmt);
+    }
+    block->statements.swap(out);
+    frames_.pop_back();
+  }
+
+  void ProcessStmt(const StmtPtr& stmt) {
+    if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+      ProcessBlock(block.get(), {});
+    } else if (auto decl = std::dynamic_pointer_cast<DeclareStmt>(stmt)) {
+      if (decl->init) {
+        decl->init = Rewrite(decl->init);
+      }
+      frames_.back()->vars[decl->name] = decl->type;
+      if (!frames_.back()->scope->Defines(decl->name)) {
+        frames_.back()->scope->Bind(decl->name, decl->type);
+      }
+    } else if (auto store = std::dynamic_pointer_cast<StoreStmt>(stmt)) {
+      if (auto sub = std::dynamic_pointer_cast<SubscriptLVal>(store->lhs)) {
+        sub->offset = Rewrite(sub->offset);
+      }
+      store->rhs = Rewrite(store->rhs);
+    } else if (auto if_stmt = std::dynamic_pointer_cast<IfStmt>(stmt)) {
+      if_stmt->cond = Rewrite(if_stmt->cond);
+      if (if_stmt->iftrue) {
+        ProcessStmt(if_stmt->iftrue);
+      }
+      if (if_stmt->iffalse) {
+        ProcessStmt(if_stmt->iffalse);
+      }
+    } else if (auto for_stmt = std::dynamic_pointer_cast<ForStmt>(stmt)) {
+      if (auto body = std::dynamic_pointer_cast<Block>(for_stmt->inner)) {
+        ProcessBlock(body.get(), {{Type{Type::INDEX}, for_stmt->var}});
+      }
+    } else if (auto while_stmt = std::dynamic_pointer_cast<WhileStmt>(stmt)) {
+      while_stmt->cond = Rewrite(while_stmt->cond);
+      ProcessStmt(while_stmt->inner);
+    } else if (auto ret = std::dynamic_pointer_cast<ReturnStmt>(stmt)) {
+      if (ret->value) {
+        ret->value = Rewrite(ret->value);
+      }
+    } else if (auto special = std::dynamic_pointer_cast<SpecialStmt>(stmt)) {
+      for (auto& param : special->params) {
+        param = Rewrite(param);
+      }
+    }
+  }
+
+  // The outermost frame where all of the expression's inputs are bound -
+  // the natural place to compute it once.
+  size_t HomeLevel(const ExprPtr& expr) {
+    size_t level = 0;
+    VisitLoads(expr, [&](const std::string& name) {
+      for (size_t i = frames_.size(); i > 0; i--) {
+        if (frames_[i - 1]->vars.count(name)) {
+          level = std::max(level, i - 1);
+          return;
+        }
+      }
+    });
+    return level;
+  }
+
+  template <typename F>
+  void VisitLoads(const ExprPtr& expr, const F& fn) {
+    if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+      if (auto lookup = std::dynamic_pointer_cast<LookupLVal>(load->inner)) {
+        fn(lookup->name);
+      }
+    } else if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+      VisitLoads(unary->inner, fn);
+    } else if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+      VisitLoads(binary->lhs, fn);
+      VisitLoads(binary->rhs, fn);
+    } else if (auto cond = std::dynamic_pointer_cast<CondExpr>(expr)) {
+      VisitLoads(cond->cond, fn);
+      VisitLoads(cond->tcase, fn);
+      VisitLoads(cond->fcase, fn);
+    } else if (auto select = std::dynamic_pointer_cast<SelectExpr>(expr)) {
+      VisitLoads(select->cond, fn);
+      VisitLoads(select->tcase, fn);
+      VisitLoads(select->fcase, fn);
+    } else if (auto clamp = std::dynamic_pointer_cast<ClampExpr>(expr)) {
+      VisitLoads(clamp->val, fn);
+      VisitLoads(clamp->min, fn);
+      VisitLoads(clamp->max, fn);
+    } else if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+      VisitLoads(cast->val, fn);
+    } else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      for (const auto& val : call->vals) {
+        VisitLoads(val, fn);
+      }
+    }
+  }
+
+  ExprPtr Rewrite(const ExprPtr& expr) {
+    auto facts = Facts(expr);
+    if (!Candidate(facts) || counts_[facts.hash] < 2) {
+      return RewriteChildren(expr);
+    }
+    auto repr = Print(*expr).str();
+    for (size_t i = frames_.size(); i > 0; i--) {
+      auto it = frames_[i - 1]->exprs.find(facts.hash);
+      if (it == frames_[i - 1]->exprs.end()) {
+        continue;
+      }
+      for (const auto& entry : it->second) {
+        if (entry.repr == repr) {
+          return std::make_shared<LoadExpr>(std::make_shared<LookupLVal>(entry.name));
+        }
+      }
+    }
+    size_t level = HomeLevel(expr);
+    if (!frames_[level]->out) {
+      return RewriteChildren(expr);
+    }
+    Type type;
+    try {
+      type = lang::ExprType::TypeOf(frames_.back()->scope.get(), true, true, expr);
+    } catch (const std::exception&) {
+      return RewriteChildren(expr);
+    }
+    if (type.base != Type::VALUE && type.base != Type::INDEX) {
+      return RewriteChildren(expr);
+    }
+    auto init = RewriteChildren(expr);
+    auto name = FreshName();
+    frames_[level]->out->push_back(std::make_shared<DeclareStmt>(type, name, init));
+    frames_[level]->exprs[facts.hash].push_back(Entry{repr, name});
+    frames_[level]->vars[name] = type;
+    frames_[level]->scope->Bind(name, type);
+    return std::make_shared<LoadExpr>(std::make_shared<LookupLVal>(name));
+  }
+
+  ExprPtr RewriteChildren(const ExprPtr& expr) {
+    if (auto load = std::dynamic_pointer_cast<LoadExpr>(expr)) {
+      if (auto sub = std::dynamic_pointer_cast<SubscriptLVal>(load->inner)) {
+        return std::make_shared<LoadExpr>(std::make_shared<SubscriptLVal>(sub->ptr, Rewrite(sub->offset)));
+      }
+      return expr;
+    }
+    if (auto unary = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+      return std::make_shared<UnaryExpr>(unary->op, Rewrite(unary->inner));
+    }
+    if (auto binary = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+      return std::make_shared<BinaryExpr>(binary->op, Rewrite(binary->lhs), Rewrite(binary->rhs));
+    }
+    if (auto cond = std::dynamic_pointer_cast<CondExpr>(expr)) {
+      return std::make_shared<CondExpr>(Rewrite(cond->cond), Rewrite(cond->tcase), Rewrite(cond->fcase), cond->type);
+    }
+    if (auto select = std::dynamic_pointer_cast<SelectExpr>(expr)) {
+      return std::make_shared<SelectExpr>(Rewrite(select->cond), Rewrite(select->tcase), Rewrite(select->fcase),
+                                          select->type);
+    }
+    if (auto clamp = std::dynamic_pointer_cast<ClampExpr>(expr)) {
+      return std::make_shared<ClampExpr>(Rewrite(clamp->val), Rewrite(clamp->min), Rewrite(clamp->max));
+    }
+    if (auto cast = std::dynamic_pointer_cast<CastExpr>(expr)) {
+      return std::make_shared<CastExpr>(cast->type, Rewrite(cast->val));
+    }
+    if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+      auto copy = std::make_shared<CallExpr>(*call);
+      for (auto& val : copy->vals) {
+        val = Rewrite(val);
+      }
+      return copy;
+    }
+    return expr;
+  }
+
+  std::string FreshName() {
+    std::string name;
+    do {
+      name = "cse" + std::to_string(next_id_++);
+    } while (used_names_.count(name));
+    used_names_.insert(name);
+    return name;
+  }
+
+  std::shared_ptr<Function> func_;
+  std::set<std::string> excluded_;
+  std::set<std::string> used_names_;
+  std::map<std::uint64_t, size_t> counts_;
+  std::vector<std::unique_ptr<Frame>> frames_;
+  size_t next_id_ = 0;
+};
+
+}  // namespace
+
 }  // namespace sem
 
 namespace lang {
@@ -486,6 +1281,48 @@ void Simplify(const std::vector<KernelInfo>& kernels) {
   }
 }
 
+void StrengthReduce(sem::StmtPtr stmt) {
+  sem::StrengthReducer reducer;
+  reducer.Process(stmt);
+}
+
+void StrengthReduce(const std::vector<KernelInfo>& kernels) {
+  for (const auto& ki : kernels) {
+    {
+      sem::StrengthReducer reducer;
+      reducer.Process(ki.kfunc->body);
+    }
+    for (auto& candidate : ki.candidates) {
+      sem::StrengthReducer reducer;
+      reducer.Process(candidate.kfunc->body);
+    }
+    if (VLOG_IS_ON(4)) {
+      sem::Print emit_debug(*ki.kfunc);
+      VLOG(4) << "Generic debug kernel after strength reduction:";
+      VLOG(4) << emit_debug.str();
+    }
+  }
+}
+
+void EliminateCommonSubexpr(const std::shared_ptr<sem::Function>& func) {
+  sem::CseReducer reducer{func};
+  reducer.Run();
+}
+
+void EliminateCommonSubexpr(const std::vector<KernelInfo>& kernels) {
+  for (const auto& ki : kernels) {
+    EliminateCommonSubexpr(ki.kfunc);
+    for (auto& candidate : ki.candidates) {
+      EliminateCommonSubexpr(candidate.kfunc);
+    }
+    if (VLOG_IS_ON(4)) {
+      sem::Print emit_debug(*ki.kfunc);
+      VLOG(4) << "Generic debug kernel after common subexpression elimination:";
+      VLOG(4) << emit_debug.str();
+    }
+  }
+}
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "tile/lang/generate.h"
@@ -12,6 +13,22 @@ namespace lang {
 void Simplify(sem::StmtPtr stmt);
 void Simplify(const std::vector<KernelInfo>& kernels);
 
+// Rewrites index declarations that are affine in an enclosing loop variable
+// into induction variables (hoisted base + per-iteration increment), and
+// hoists fully loop-invariant index declarations out of the loop.  Intended
+// to run after Simplify, which does the constant folding this relies on.
+void StrengthReduce(sem::StmtPtr stmt);
+void StrengthReduce(const std::vector<KernelInfo>& kernels);
+
+// Value-numbers pure expressions across statements and replaces repeated
+// occurrences with a single declared temporary, placed in the outermost
+// block where the expression's inputs are all bound - so index guards that
+// recur inside a loop body are computed once per iteration (or hoisted out
+// of the loop entirely when they don't involve the loop variable).
+// Intended to run after StrengthReduce.
+void EliminateCommonSubexpr(const std::shared_ptr<sem::Function>& func);
+void EliminateCommonSubexpr(const std::vector<KernelInfo>& kernels);
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
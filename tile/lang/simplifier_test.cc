@@ -346,6 +346,99 @@ TestParam Contraction() {
 
 INSTANTIATE_TEST_CASE_P(Samples, SimplifierTest, ::testing::Values(Basic(), Contraction()));
 
+TEST(StrengthReduceTest, InductionVariable) {
+  using namespace sem::builder;  // NOLINT
+
+  auto A = _("A");
+  auto C = _("C");
+  auto i = _("i");
+  auto j = _("j");
+  auto off = _("off");
+  auto off_sr0 = _("off_sr0");
+
+  sem::Type index_type{sem::Type::INDEX};
+
+  // void kernel(...) {
+  //   int j = get_local_id(0);
+  //   for (int i = 0; i < 4; i += 1) {
+  //     int off = ((3 * i) + j);
+  //     C[off] = A[off];
+  //   }
+  // }
+  auto before_body = _Block({});
+  before_body->append(_Declare(index_type, "off", (3 * i) + j));
+  before_body->append(C[off] = A[off]);
+  auto before = _Block({});
+  before->append(_Declare(index_type, "j", _Index(sem::IndexExpr::LOCAL, 0)));
+  before->append(_For("i", 4, 1, before_body));
+
+  // The affine declaration becomes an induction variable: its base is hoisted
+  // above the loop and the per-iteration stride is added at the bottom.
+  auto after_body = _Block({});
+  after_body->append(C[off_sr0] = A[off_sr0]);
+  after_body->append(off_sr0 = off_sr0 + 3);
+  auto after = _Block({});
+  after->append(_Declare(index_type, "j", _Index(sem::IndexExpr::LOCAL, 0)));
+  after->append(_Declare(index_type, "off_sr0", j));
+  after->append(_For("i", 4, 1, after_body));
+
+  KernelInfo ki;
+  ki.kfunc = _Function("kernel", sem::Type{}, {}, {before});
+  std::vector<KernelInfo> kernels{ki};
+  StrengthReduce(kernels);
+
+  sem::Print actual(*ki.kfunc);
+  sem::Print expected(*_Function("kernel", sem::Type{}, {}, {after}));
+  EXPECT_EQ(actual.str(), expected.str());
+}
+
+TEST(EliminateCommonSubexprTest, HoistGuard) {
+  using namespace sem::builder;  // NOLINT
+
+  auto A = _("A");
+  auto B = _("B");
+  auto C = _("C");
+  auto i = _("i");
+  auto j = _("j");
+  auto cse0 = _("cse0");
+  auto cse1 = _("cse1");
+
+  sem::Type index_type{sem::Type::INDEX};
+
+  // void kernel(...) {
+  //   int j = get_local_id(0);
+  //   for (int i = 0; i < 4; i += 1) {
+  //     C[clamp((i + j), 0, ((4 * j) + 3))] =
+  //         (A[clamp((i + j), 0, ((4 * j) + 3))] + B[clamp((i + j), 0, ((4 * j) + 3))]);
+  //   }
+  // }
+  auto guard = [&]() { return _Clamp(i + j, _Const(0), (4 * j) + 3); };
+  auto before_body = _Block({});
+  before_body->append(C[guard()] = A[guard()] + B[guard()]);
+  auto before = _Block({});
+  before->append(_Declare(index_type, "j", _Index(sem::IndexExpr::LOCAL, 0)));
+  before->append(_For("i", 4, 1, before_body));
+
+  // The loop-invariant limit is computed once before the loop; the guard
+  // itself depends on the loop variable, so it's computed once per iteration.
+  auto after_body = _Block({});
+  after_body->append(_Declare(index_type, "cse1", _Clamp(i + j, _Const(0), cse0)));
+  after_body->append(C[cse1] = A[cse1] + B[cse1]);
+  auto after = _Block({});
+  after->append(_Declare(index_type, "j", _Index(sem::IndexExpr::LOCAL, 0)));
+  after->append(_Declare(index_type, "cse0", (4 * j) + 3));
+  after->append(_For("i", 4, 1, after_body));
+
+  KernelInfo ki;
+  ki.kfunc = _Function("kernel", sem::Type{}, {}, {before});
+  std::vector<KernelInfo> kernels{ki};
+  EliminateCommonSubexpr(kernels);
+
+  sem::Print actual(*ki.kfunc);
+  sem::Print expected(*_Function("kernel", sem::Type{}, {}, {after}));
+  EXPECT_EQ(actual.str(), expected.str());
+}
+
 }  // namespace lang
 }  // namespace tile
 }  // namespace vertexai
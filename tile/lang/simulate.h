@@ -65,7 +65,7 @@ DataType GetDataType<double>() {
 
 template <class T, size_t dims>
 TensorShape ShapeOf(const Tensor<T, dims>& t) {
-  std::vector<TensorDimension> ndims;
+  TensorDimensions ndims;
   for (size_t i = 0; i < dims; i++) {
     ndims.emplace_back(t.strides()[i], t.shape()[i]);
   }
@@ -1,19 +1,48 @@
 
 #include "tile/lang/tile_cache.h"
 
+#include <boost/filesystem.hpp>
+
 #include "base/util/env.h"
 #include "base/util/json_transfer.h"
 
+namespace fs = boost::filesystem;
+
 namespace vertexai {
 namespace tile {
 namespace lang {
 
+namespace {
+
+// A name for this node, used to give each node its own publication file in
+// the shared cache directory.
+std::string NodeName() {
+  auto name = env::Get("HOSTNAME");
+  if (!name.length()) {
+    name = env::Get("COMPUTERNAME");
+  }
+  if (!name.length()) {
+    name = "node";
+  }
+  return name;
+}
+
+}  // namespace
+
 TileCache::TileCache(const std::string& filename, bool use_env) {
   std::string openname = filename;
   if (filename == "") {
     if (!use_env) {
       return;
     }
+    auto shared_dir = env::Get("PLAIDML_TILE_CACHE_DIR");
+    if (shared_dir.length()) {
+      // Fetch the fleet's measurements before opening our own stores, then
+      // publish this node's measurements under a per-node file.
+      LoadPeerEntries(shared_dir);
+      auto node_file = (fs::path(shared_dir) / (NodeName() + ".tcache")).string();
+      shared_file_.open(node_file, std::ofstream::out | std::ofstream::app);
+    }
     openname = env::Get("PLAIDML_TILE_CACHE");
     if (!openname.length()) {
       return;
@@ -32,6 +61,27 @@ TileCache::TileCache(const std::string& filename, bool use_env) {
   file_.exceptions(std::fstream::failbit | std::fstream::badbit);
 }
 
+void TileCache::LoadPeerEntries(const std::string& dir) {
+  boost::system::error_code ec;
+  fs::directory_iterator it(dir, ec);
+  for (fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+    if (it->path().extension() != ".tcache") {
+      continue;
+    }
+    std::ifstream in(it->path().string());
+    std::string line;
+    while (std::getline(in, line)) {
+      try {
+        Entry e = inline_json_deserialize<Entry>(line);
+        AddEntry(e.key, e.subkey, e.value);
+      } catch (...) {
+        // A peer may be mid-append; skip torn rows rather than losing the
+        // rest of the file.
+      }
+    }
+  }
+}
+
 TileCache* TileCache::Instance() {
   static TileCache instance("", true);
   return &instance;
@@ -39,20 +89,30 @@ TileCache* TileCache::Instance() {
 
 void TileCache::AddEntry(const std::string& key, const DirectSettings& settings, const std::vector<uint64_t>& tile_size,
                          int64_t dur) {
+  std::lock_guard<std::mutex> lock{mu_};
   Entry e;
   e.key = key;
   e.subkey = Subkey(settings, tile_size);
   e.value = dur;
   AddEntry(key, e.subkey, dur);
-  if (file_.is_open()) {
+  if (file_.is_open() || shared_file_.is_open()) {
     std::string row = json_serialize(e);
-    file_.write(row.data(), row.size());
-    file_.flush();
+    if (file_.is_open()) {
+      file_.write(row.data(), row.size());
+      file_.flush();
+    }
+    if (shared_file_.is_open()) {
+      // Publish for peer nodes; flushed per row so a freshly started node
+      // sees measurements from nodes that are still running.
+      shared_file_.write(row.data(), row.size());
+      shared_file_.flush();
+    }
   }
 }
 
 int64_t TileCache::GetDuration(const std::string& key, const DirectSettings& settings,
                                const std::vector<uint64_t>& tile_size) {
+  std::lock_guard<std::mutex> lock{mu_};
   auto it = cache_.find(key);
   if (it == cache_.end()) {
     return -1;
@@ -64,6 +124,15 @@ int64_t TileCache::GetDuration(const std::string& key, const DirectSettings& set
   return it2->second;
 }
 
+std::vector<uint64_t> TileCache::GetBestTile(const std::string& key) {
+  std::lock_guard<std::mutex> lock{mu_};
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
+    return {};
+  }
+  return it->second.best.tile_size;
+}
+
 void TileCache::AddEntry(const std::string& key, const Subkey& subkey, int64_t dur) {
   PerFC& p = cache_[key];
   p.times[subkey] = dur;
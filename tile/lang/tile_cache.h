@@ -4,6 +4,7 @@
 #include <fstream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -18,13 +19,20 @@ class TileCache {
  public:
   // Construct a cache, if given a filename, use that for storage
   explicit TileCache(const std::string& filename = "", bool use_env = false);
-  // Get the 'singlton' instance, loads for PLAIDML_TILE_CACHE if set
+  // Get the 'singlton' instance, loads for PLAIDML_TILE_CACHE if set.
+  // If PLAIDML_TILE_CACHE_DIR names a directory shared between nodes (e.g.
+  // over NFS), entries published there by peers are fetched at startup and
+  // this node's measurements are appended to its own per-node file in the
+  // directory, so across a fleet running identical models only the first
+  // node pays the tile search cost; misses still fall back to local search.
   static TileCache* Instance();
   // Add a new entry with a duration
   void AddEntry(const std::string& key, const DirectSettings& settings, const std::vector<uint64_t>& tile_size,
                 int64_t dur);
   // Checks for an exact matching entry (to skip tile scan for repeats), or -1 if not found
   int64_t GetDuration(const std::string& key, const DirectSettings& settings, const std::vector<uint64_t>& tile_size);
+  // Returns the lowest-measured tile for key, or empty if nothing recorded
+  std::vector<uint64_t> GetBestTile(const std::string& key);
 
  private:
   struct Subkey {
@@ -61,10 +69,20 @@ class TileCache {
   };
 
   void AddEntry(const std::string& key, const Subkey& subkey, int64_t dur);
+  // Load entries published by peer nodes into the shared directory, skipping
+  // rows a peer may still be mid-append on.
+  void LoadPeerEntries(const std::string& dir);
 
+  // Entries are added from HAL completion callbacks as well as compile
+  // threads, so accesses are serialized.
+  std::mutex mu_;
   std::map<const std::string, PerFC> cache_;
 
   std::fstream file_;
+  // This node's append-only publication file in PLAIDML_TILE_CACHE_DIR.
+  // Each node writes only its own file, so the shared directory needs no
+  // cross-node locking.
+  std::ofstream shared_file_;
 };
 
 }  // namespace lang
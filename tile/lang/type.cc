@@ -140,7 +140,7 @@ static double ConstantPropagate(const std::string& op, const std::vector<double>
   throw std::runtime_error("Unknown op " + op + " during constant propagation");
 }
 
-std::string to_string(const std::vector<TensorDimension>& dims) {
+std::string to_string(const TensorDimensions& dims) {
   std::string result = "[";
   bool first = true;
   for (const auto& dim : dims) {
@@ -157,8 +157,8 @@ std::string to_string(const std::vector<TensorDimension>& dims) {
 
 namespace {
 
-bool BroadcastTo(std::vector<TensorDimension>* dims, std::string* dims_source,
-                 const std::vector<TensorDimension>& vdims, const std::string& vdims_source) {
+bool BroadcastTo(TensorDimensions* dims, std::string* dims_source,
+                 const TensorDimensions& vdims, const std::string& vdims_source) {
   if (vdims.size() != 0) {
     if (dims->size() == 0) {
       *dims = vdims;
@@ -728,7 +728,7 @@ void TypeCheck(Program* prog, Bindings* vars) {
       }
 
       // Validate all sizes either match, are broadcast-compatible, or are 0-dim
-      std::vector<TensorDimension> dims;
+      TensorDimensions dims;
       std::string dims_source;
       bool did_broadcast = false;
       for (const std::string& in : op.inputs) {
@@ -867,7 +867,7 @@ Bindings BindProgram(Program* p, const ShapeMap& inputs, const ShapeMap& outputs
     if (it == vars.end()) {
       throw std::runtime_error("No type deduced for output " + kvp.first);
     }
-    std::vector<TensorDimension> dims{it->second.shape.dims};
+    TensorDimensions dims{it->second.shape.dims};
     std::string src = "program variable";
     BroadcastTo(&dims, &src, kvp.second.dims, "program input");
     // if (!(kvp.second == it->second.shape)) {
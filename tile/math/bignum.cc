@@ -8,6 +8,15 @@ namespace tile {
 namespace math {
 
 Integer Floor(const Rational& x) {
+  if (x.is_small()) {
+    int64_t num = x.small_num();
+    int64_t den = x.small_den();
+    int64_t q = num / den;
+    if (num % den != 0 && num < 0) {
+      q -= 1;
+    }
+    return Integer(q);
+  }
   if (x < 0) {
     return (numerator(x) - denominator(x) + 1) / denominator(x);
   } else {
@@ -15,9 +24,26 @@ Integer Floor(const Rational& x) {
   }
 }
 
-Integer Ceil(const Rational& x) { return Floor(Rational(numerator(x) - 1, denominator(x))) + 1; }
+Integer Ceil(const Rational& x) {
+  if (x.is_small()) {
+    int64_t num = x.small_num();
+    int64_t den = x.small_den();
+    int64_t q = num / den;
+    if (num % den != 0 && num > 0) {
+      q += 1;
+    }
+    return Integer(q);
+  }
+  return Floor(Rational(numerator(x) - 1, denominator(x))) + 1;
+}
 
 int ToInteger(const Rational& x) {
+  if (x.is_small()) {
+    if (x.small_den() != 1) {
+      throw std::runtime_error("Non-integer rational.");
+    }
+    return static_cast<int>(x.small_num());
+  }
   if (Floor(x) != Ceil(x)) {
     throw std::runtime_error("Non-integer rational.");
   }
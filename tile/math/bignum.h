@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -11,9 +16,262 @@ namespace math {
 typedef boost::multiprecision::cpp_int_backend<> IntegerBackend;
 typedef boost::multiprecision::rational_adaptor<IntegerBackend> RationalBackend;
 typedef boost::multiprecision::number<IntegerBackend, boost::multiprecision::et_off> Integer;
-typedef boost::multiprecision::number<RationalBackend, boost::multiprecision::et_off> Rational;
+// The arbitrary-precision rational that Rational promotes to when a value
+// outgrows a machine word.
+typedef boost::multiprecision::number<RationalBackend, boost::multiprecision::et_off> BigRational;
 
 inline std::string to_string(const Integer& x) { return x.str(); }
+
+#if defined(__SIZEOF_INT128__)
+#define TILE_MATH_BIGNUM_INT128 1
+#endif
+
+// A rational number with a small-value fast path.  Values whose numerator and
+// denominator fit in an int64 (the overwhelming majority of everything the
+// bound/defract pipeline touches) are kept inline as a reduced int64 pair and
+// use machine arithmetic; anything wider is promoted to a heap-backed
+// BigRational.  Results demote back to the inline form whenever they fit, so
+// a transient wide intermediate doesn't pin a value into the slow path.  The
+// interface mirrors the boost rational this typedef used to name:
+// numerator()/denominator() free functions returning Integer, mixed
+// arithmetic with Integer and machine ints, and "n/d" formatting.
+class Rational {
+ public:
+  Rational() = default;
+  Rational(int64_t num) : num_(num) {}  // NOLINT(runtime/explicit)
+  Rational(int num) : num_(num) {}      // NOLINT(runtime/explicit)
+  Rational(uint64_t num) {              // NOLINT(runtime/explicit)
+    if (num <= static_cast<uint64_t>(INT64_MAX)) {
+      num_ = static_cast<int64_t>(num);
+    } else {
+      big_.reset(new BigRational(num));
+    }
+  }
+  Rational(int64_t num, int64_t den) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    *this = FromWide(num, den);
+#else
+    *this = FromBig(BigRational(num, den));
+#endif
+  }
+  Rational(const Integer& num) {  // NOLINT(runtime/explicit)
+    if (FitsSmall(num)) {
+      num_ = static_cast<int64_t>(num);
+    } else {
+      big_.reset(new BigRational(num));
+    }
+  }
+  Rational(const Integer& num, const Integer& den) { *this = FromBig(BigRational(num, den)); }
+  explicit Rational(const BigRational& big) { *this = FromBig(BigRational(big)); }
+
+  Rational(const Rational& rhs) : num_(rhs.num_), den_(rhs.den_) {
+    if (rhs.big_) {
+      big_.reset(new BigRational(*rhs.big_));
+    }
+  }
+  Rational(Rational&& rhs) = default;
+  Rational& operator=(const Rational& rhs) {
+    num_ = rhs.num_;
+    den_ = rhs.den_;
+    big_.reset(rhs.big_ ? new BigRational(*rhs.big_) : nullptr);
+    return *this;
+  }
+  Rational& operator=(Rational&& rhs) = default;
+
+  // True when the value lives in the inline int64 representation.
+  bool is_small() const { return !big_; }
+  int64_t small_num() const { return num_; }
+  int64_t small_den() const { return den_; }
+  BigRational to_big() const { return big_ ? *big_ : BigRational(num_, den_); }
+
+  explicit operator bool() const { return big_ ? (*big_ != 0) : num_ != 0; }
+  // Truncates toward zero, matching the boost rational conversion.
+  explicit operator int64_t() const { return big_ ? big_->convert_to<int64_t>() : num_ / den_; }
+
+  std::string str() const {
+    if (big_) {
+      return big_->str();
+    }
+    if (den_ == 1) {
+      return std::to_string(num_);
+    }
+    return std::to_string(num_) + "/" + std::to_string(den_);
+  }
+
+  Rational& operator+=(const Rational& rhs) { return *this = *this + rhs; }
+  Rational& operator-=(const Rational& rhs) { return *this = *this - rhs; }
+  Rational& operator*=(const Rational& rhs) { return *this = *this * rhs; }
+  Rational& operator/=(const Rational& rhs) { return *this = *this / rhs; }
+
+  // The operators are hidden friends, findable only through ADL on a
+  // Rational operand: at namespace scope they'd be injected wherever a TU
+  // says `using namespace math;`, where unqualified operator lookup would
+  // stop at them and shadow unrelated operators at enclosing scopes (e.g.
+  // the semtree builder's).
+  friend Rational operator+(const Rational& a, const Rational& b) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small() && b.is_small()) {
+      Wide n = static_cast<Wide>(a.num_) * b.den_ + static_cast<Wide>(b.num_) * a.den_;
+      Wide d = static_cast<Wide>(a.den_) * b.den_;
+      return FromWide(n, d);
+    }
+#endif
+    return FromBig(a.to_big() + b.to_big());
+  }
+
+  friend Rational operator-(const Rational& a, const Rational& b) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small() && b.is_small()) {
+      Wide n = static_cast<Wide>(a.num_) * b.den_ - static_cast<Wide>(b.num_) * a.den_;
+      Wide d = static_cast<Wide>(a.den_) * b.den_;
+      return FromWide(n, d);
+    }
+#endif
+    return FromBig(a.to_big() - b.to_big());
+  }
+
+  friend Rational operator-(const Rational& a) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small()) {
+      return FromWide(-static_cast<Wide>(a.num_), a.den_);
+    }
+#endif
+    return FromBig(-a.to_big());
+  }
+
+  friend Rational operator*(const Rational& a, const Rational& b) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small() && b.is_small()) {
+      return FromWide(static_cast<Wide>(a.num_) * b.num_, static_cast<Wide>(a.den_) * b.den_);
+    }
+#endif
+    return FromBig(a.to_big() * b.to_big());
+  }
+
+  friend Rational operator/(const Rational& a, const Rational& b) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small() && b.is_small()) {
+      return FromWide(static_cast<Wide>(a.num_) * b.den_, static_cast<Wide>(a.den_) * b.num_);
+    }
+#endif
+    return FromBig(a.to_big() / b.to_big());
+  }
+
+  friend bool operator==(const Rational& a, const Rational& b) {
+    if (a.is_small() && b.is_small()) {
+      // Both sides are canonical, so equality is member-wise.
+      return a.num_ == b.num_ && a.den_ == b.den_;
+    }
+    if (a.is_small() != b.is_small()) {
+      // A promoted value never fits the inline form, so it can't equal one.
+      return false;
+    }
+    return a.to_big() == b.to_big();
+  }
+
+  friend bool operator<(const Rational& a, const Rational& b) {
+#ifdef TILE_MATH_BIGNUM_INT128
+    if (a.is_small() && b.is_small()) {
+      return static_cast<Wide>(a.num_) * b.den_ < static_cast<Wide>(b.num_) * a.den_;
+    }
+#endif
+    return a.to_big() < b.to_big();
+  }
+
+  friend bool operator!=(const Rational& a, const Rational& b) { return !(a == b); }
+  friend bool operator>(const Rational& a, const Rational& b) { return b < a; }
+  friend bool operator<=(const Rational& a, const Rational& b) { return !(b < a); }
+  friend bool operator>=(const Rational& a, const Rational& b) { return !(a < b); }
+
+  friend std::ostream& operator<<(std::ostream& os, const Rational& x) { return os << x.str(); }
+
+ private:
+#ifdef TILE_MATH_BIGNUM_INT128
+  typedef __int128 Wide;
+
+  // Reduces n/d (products of int64s always fit in 128 bits) and returns the
+  // inline form when the result fits, promoting otherwise.
+  static Rational FromWide(Wide n, Wide d) {
+    if (d == 0) {
+      throw std::overflow_error("Rational: division by zero");
+    }
+    if (d < 0) {
+      n = -n;
+      d = -d;
+    }
+    Wide g = WideGcd(n < 0 ? -n : n, d);
+    if (g > 1) {
+      n /= g;
+      d /= g;
+    }
+    if (n >= INT64_MIN && n <= INT64_MAX && d <= INT64_MAX) {
+      Rational result;
+      result.num_ = static_cast<int64_t>(n);
+      result.den_ = static_cast<int64_t>(d);
+      return result;
+    }
+    Rational result;
+    result.big_.reset(new BigRational(WideToInteger(n), WideToInteger(d)));
+    return result;
+  }
+
+  static Wide WideGcd(Wide a, Wide b) {
+    while (b) {
+      Wide t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+
+  static Integer WideToInteger(Wide v) {
+    bool neg = v < 0;
+    unsigned __int128 u = neg ? -static_cast<unsigned __int128>(v) : static_cast<unsigned __int128>(v);
+    Integer result = static_cast<uint64_t>(u >> 64);
+    result <<= 64;
+    result += static_cast<uint64_t>(u);
+    return neg ? Integer(-result) : result;
+  }
+#endif
+
+  static bool FitsSmall(const Integer& x) { return x >= INT64_MIN && x <= INT64_MAX; }
+
+  // Demotes a BigRational back to the inline form when it fits.
+  static Rational FromBig(BigRational&& big) {
+    const Integer& num = boost::multiprecision::numerator(big);
+    const Integer& den = boost::multiprecision::denominator(big);
+    if (FitsSmall(num) && FitsSmall(den)) {
+      Rational result;
+      result.num_ = static_cast<int64_t>(num);
+      result.den_ = static_cast<int64_t>(den);
+      return result;
+    }
+    Rational result;
+    result.big_.reset(new BigRational(std::move(big)));
+    return result;
+  }
+
+  int64_t num_ = 0;
+  int64_t den_ = 1;  // > 0; (num_, den_) is always fully reduced
+  std::unique_ptr<BigRational> big_;
+};
+
+inline Integer numerator(const Rational& x) {
+  if (x.is_small()) {
+    return Integer(x.small_num());
+  }
+  return boost::multiprecision::numerator(x.to_big());
+}
+
+inline Integer denominator(const Rational& x) {
+  if (x.is_small()) {
+    return Integer(x.small_den());
+  }
+  return boost::multiprecision::denominator(x.to_big());
+}
+
+inline Rational abs(const Rational& x) { return x < 0 ? -x : x; }
+
 inline std::string to_string(const Rational& x) { return x.str(); }
 
 // Finds greatest int that is <= x
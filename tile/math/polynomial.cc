@@ -135,17 +135,23 @@ T Polynomial<T>::operator[](const std::string& var) const {
 }
 
 template <typename T>
-const std::map<std::string, T>& Polynomial<T>::getMap() const {
+const typename Polynomial<T>::CoeffMap& Polynomial<T>::getMap() const {
   return map_;
 }
 
 template <typename T>
-std::map<std::string, T>& Polynomial<T>::mutateMap() {
+typename Polynomial<T>::CoeffMap& Polynomial<T>::mutateMap() {
   return map_;
 }
 
 template <typename T>
 Polynomial<T>& Polynomial<T>::operator+=(const Polynomial<T>& rhs) {
+  if (this == &rhs) {
+    // Self-addition would otherwise iterate map_ while inserting into it,
+    // which the inline-vector storage doesn't tolerate the way a node-based
+    // map did.
+    return *this *= T(2);
+  }
   for (const auto& kvp : rhs.map_) {
     T new_val = (map_[kvp.first] += kvp.second);
     if (new_val == 0) {
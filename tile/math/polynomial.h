@@ -11,6 +11,7 @@
 
 #include "base/util/logging.h"
 #include "tile/math/bignum.h"
+#include "tile/math/small_map.h"
 
 namespace vertexai {
 namespace tile {
@@ -23,6 +24,10 @@ class Polynomial : boost::additive<Polynomial<T>>,
                    boost::dividable<Polynomial<T>, T>,
                    boost::equality_comparable<Polynomial<T>> {
  public:
+  // The coefficient container: terms inline for the common small case, in
+  // sorted order so iteration matches the old std::map exactly.
+  using CoeffMap = SmallMap<std::string, T>;
+
   // Construct Polynomial<T>s
   Polynomial();  // Zero Polynomial
   // clang-format off
@@ -31,9 +36,9 @@ class Polynomial : boost::additive<Polynomial<T>>,
   //cppcheck-suppress noExplicitConstructor  // NOLINT
   Polynomial(const std::string& i, const T& c = 1);  // Monomial  // NOLINT
   // clang-format on
-  T operator[](const std::string& var) const;      // Quick coefficent access
-  const std::map<std::string, T>& getMap() const;  // Get inner map
-  std::map<std::string, T>& mutateMap();           // Get inner map for editing
+  T operator[](const std::string& var) const;  // Quick coefficent access
+  const CoeffMap& getMap() const;              // Get inner map
+  CoeffMap& mutateMap();                       // Get inner map for editing
   bool operator==(const Polynomial& rhs) const;    // Equality
   bool operator<(const Polynomial& rhs) const;     // Lexigraphical order
   Polynomial& operator+=(const Polynomial& rhs);   // Addition
@@ -67,7 +72,7 @@ class Polynomial : boost::additive<Polynomial<T>>,
  private:
   // Map from index -> coefficient
   // Constant offset is a coefficent of empty string
-  std::map<std::string, T> map_;
+  CoeffMap map_;
 };
 
 extern template class Polynomial<Rational>;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/container/small_vector.hpp>
+
+namespace vertexai {
+namespace tile {
+namespace math {
+
+// A sorted associative container exposing the subset of the std::map
+// interface the compiler uses, backed by a small_vector so the handful of
+// entries in a typical affine polynomial live inline in the object instead
+// of in one heap node per term.  Lookup is a binary search over the sorted
+// storage; insertion shifts the tail, which is cheap at these sizes.
+// Iteration order and the comparison operators match std::map exactly.
+template <typename K, typename V, std::size_t N = 4>
+class SmallMap {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using storage_type = boost::container::small_vector<value_type, N>;
+  using iterator = typename storage_type::iterator;
+  using const_iterator = typename storage_type::const_iterator;
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear() { entries_.clear(); }
+  void swap(SmallMap& rhs) { entries_.swap(rhs.entries_); }
+
+  iterator find(const K& key) {
+    auto it = LowerBound(key);
+    return (it != entries_.end() && it->first == key) ? it : entries_.end();
+  }
+
+  const_iterator find(const K& key) const {
+    auto it = LowerBound(key);
+    return (it != entries_.end() && it->first == key) ? it : entries_.end();
+  }
+
+  std::size_t count(const K& key) const { return find(key) == end() ? 0 : 1; }
+
+  V& at(const K& key) {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("SmallMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  const V& at(const K& key) const {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("SmallMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  V& operator[](const K& key) {
+    auto it = LowerBound(key);
+    if (it == entries_.end() || it->first != key) {
+      it = entries_.insert(it, value_type{key, V()});
+    }
+    return it->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    auto it = LowerBound(value.first);
+    if (it != entries_.end() && it->first == value.first) {
+      return {it, false};
+    }
+    return {entries_.insert(it, value), true};
+  }
+
+  template <typename KeyArg, typename... Args>
+  std::pair<iterator, bool> emplace(KeyArg&& key_arg, Args&&... args) {
+    K key(std::forward<KeyArg>(key_arg));
+    auto it = LowerBound(key);
+    if (it != entries_.end() && it->first == key) {
+      return {it, false};
+    }
+    it = entries_.insert(it, value_type{std::move(key), V(std::forward<Args>(args)...)});
+    return {it, true};
+  }
+
+  std::size_t erase(const K& key) {
+    auto it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    entries_.erase(it);
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) { return entries_.erase(pos); }
+
+  bool operator==(const SmallMap& rhs) const { return entries_ == rhs.entries_; }
+  bool operator!=(const SmallMap& rhs) const { return !(*this == rhs); }
+  bool operator<(const SmallMap& rhs) const { return entries_ < rhs.entries_; }
+
+ private:
+  iterator LowerBound(const K& key) {
+    return std::lower_bound(entries_.begin(), entries_.end(), key,
+                            [](const value_type& entry, const K& k) { return entry.first < k; });
+  }
+
+  const_iterator LowerBound(const K& key) const {
+    return std::lower_bound(entries_.begin(), entries_.end(), key,
+                            [](const value_type& entry, const K& k) { return entry.first < k; });
+  }
+
+  storage_type entries_;
+};
+
+}  // namespace math
+}  // namespace tile
+}  // namespace vertexai
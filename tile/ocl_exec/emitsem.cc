@@ -3,6 +3,7 @@
 #include "tile/ocl_exec/emitsem.h"
 
 #include <algorithm>
+#include <sstream>
 #include <utility>
 
 #include "tile/lang/gen_special.h"
@@ -159,6 +160,12 @@ void SemtreeEmitter::Visit(const stripe::Load& stmt) {
   auto type = scope_->at(stmt.from).shape.type;
   if (stmt.has_tag("vector_tx")) {
     cur_->push_back(_Declare({sem::Type::VALUE, type}, scalar_name(stmt.into), _("vector_load")(lval)));
+  } else if (stmt.has_attr("vector_width")) {
+    // Widened load: vloadn pulls the whole lane group from the element base
+    auto width = stmt.get_attr_int("vector_width");
+    auto ptr = _(ref_buf(stmt.from)) + _(ref_idx(stmt.from));
+    auto vload = _("vload" + std::to_string(width))(_Const(0), ptr);
+    cur_->push_back(_Declare({sem::Type::VALUE, type, static_cast<uint64_t>(width)}, scalar_name(stmt.into), vload));
   } else {
     cur_->push_back(_Declare({sem::Type::VALUE, type}, scalar_name(stmt.into), lval));
   }
@@ -187,10 +194,18 @@ void SemtreeEmitter::Visit(const stripe::Store& stmt) {
   auto lval = _(ref_buf(stmt.into))[_(ref_idx(stmt.into))];
   std::string agg_op = scope_->this_block()->ref_by_into(stmt.into)->agg_op;
   auto rval = _(scalar_name(stmt.from));
-  sem::ExprPtr agg = DoAgg(agg_op, lval, rval);
   if (stmt.has_tag("vector_tx")) {
+    sem::ExprPtr agg = DoAgg(agg_op, lval, rval);
     cur_->push_back(_Special("vector_store", {lval, agg}));
+  } else if (stmt.has_attr("vector_width")) {
+    // Widened store: aggregate against the current lane group, then write it
+    // back with vstoren
+    auto width = std::to_string(stmt.get_attr_int("vector_width"));
+    auto ptr = _(ref_buf(stmt.into)) + _(ref_idx(stmt.into));
+    sem::ExprPtr agg = DoAgg(agg_op, _("vload" + width)(_Const(0), ptr), rval);
+    cur_->push_back(_Special("vstore" + width, {agg, _Const(0), ptr}));
   } else {
+    sem::ExprPtr agg = DoAgg(agg_op, lval, rval);
     cur_->push_back(lval = agg);
   }
   if (agg_op != "" && agg_op != "assign") {
@@ -228,6 +243,14 @@ void SemtreeEmitter::Visit(const stripe::Special& spec) {
     kernels_.kernels.push_back(lang::GenZero(scope_->at(spec.outputs[0]).shape, spec.outputs[0], kname));
     return;
   }
+  if (spec.name.rfind("agg_init_", 0) == 0) {
+    // Aggregation output initialization: a fill kernel carrying the
+    // identity pattern, so HALs with hardware fill run it as a memset-like
+    // operation instead of a scalar loop.
+    kernels_.kernels.push_back(
+        lang::GenFill(scope_->at(spec.outputs[0]).shape, spec.outputs[0], kname, spec.name.substr(9)));
+    return;
+  }
   // Try to call GenSpecial as a fallback by making a fake 'op'
   lang::Op op;
   op.tag = lang::Op::FUNCTION;
@@ -259,7 +282,8 @@ void SemtreeEmitter::Visit(const stripe::Intrinsic& in) {
     opexpr = default_intrinsic_emitter(in);
   }
   tot_ops_ += loop_mul_;
-  cur_->push_back(_Declare({sem::Type::VALUE, in.type}, scalar_name(in.outputs[0]), opexpr));
+  uint64_t width = in.has_attr("vector_width") ? in.get_attr_int("vector_width") : 1;
+  cur_->push_back(_Declare({sem::Type::VALUE, in.type, width}, scalar_name(in.outputs[0]), opexpr));
 }
 
 sem::StmtPtr SemtreeEmitter::add_loops(const stripe::Block& block) {
@@ -371,6 +395,16 @@ void SemtreeEmitter::do_gids(const stripe::Block& block) {
   lang::KernelInfo& ki = kernels_.kernels.back();
   ki.kname = "kernel_" + std::to_string(kernels_.kernels.size());
   ki.comments = "//" + block.name + "\n//" + block.comments + "\n";
+  if (block.has_attr("tile_key")) {
+    // Autotile's profile key and plan ride along so the HAL can record the
+    // kernel's measured time against the tiling that produced it.
+    ki.key = block.get_attr_str("tile_key");
+    std::istringstream plan(block.get_attr_str("tile_plan"));
+    std::string dim;
+    while (std::getline(plan, dim, ',')) {
+      ki.tile.shape.push_back(std::stoull(dim));
+    }
+  }
   std::vector<sem::Function::param_t> params;
   // Do not use block.ref_outs() because we need also InOut refs
   for (const auto& ref : block.refs) {
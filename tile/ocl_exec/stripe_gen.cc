@@ -22,6 +22,15 @@ lang::KernelList GenerateProgram(                    //
     const std::string& cfg_name,                     //
     const std::string& out_dir,                      //
     ConstBufferManager* const_bufs) {
+  return GenerateProgram(context::Context{}, stripe, cfg_name, out_dir, const_bufs);
+}
+
+lang::KernelList GenerateProgram(                    //
+    const context::Context& ctx,                     //
+    const std::shared_ptr<stripe::Program>& stripe,  //
+    const std::string& cfg_name,                     //
+    const std::string& out_dir,                      //
+    ConstBufferManager* const_bufs) {
   codegen::OptimizeOptions options;
   options.dump_passes = !out_dir.empty();
   options.dump_passes_proto = !out_dir.empty();
@@ -30,12 +39,13 @@ lang::KernelList GenerateProgram(                    //
     IVLOG(2, "Write passes to: " << options.dbg_dir);
   }
   IVLOG(2, *stripe->entry);
-  const auto& cfgs = targets::GetConfigs();
-  const auto& cfg = cfgs.configs().at(cfg_name);
+  std::string cfg_version;
+  auto cfgs = targets::GetConfigs(&cfg_version);
+  const auto& cfg = cfgs->configs().at(cfg_name);
   const auto& stage = cfg.stages().at("default");
   codegen::CompilerState state(stripe);
   state.const_bufs = const_bufs;
-  codegen::Optimize(&state, stage.passes(), options);
+  codegen::OptimizeCached(ctx, &state, cfg_name + "@" + cfg_version, stage.passes(), options);
   IVLOG(2, *stripe->entry);
   codegen::SemtreeEmitter emit(codegen::AliasMap{}, 256);
   emit.Visit(*stripe->entry);
@@ -77,11 +87,20 @@ KernelList GenerateProgram(       //
     const std::string& cfg_name,  //
     const std::string& out_dir,   //
     ConstBufferManager* const_bufs) {
+  return GenerateProgram(context::Context{}, runinfo, cfg_name, out_dir, const_bufs);
+}
+
+KernelList GenerateProgram(       //
+    const context::Context& ctx,  //
+    const RunInfo& runinfo,       //
+    const std::string& cfg_name,  //
+    const std::string& out_dir,   //
+    ConstBufferManager* const_bufs) {
   IVLOG(2, runinfo.input_shapes);
   IVLOG(2, runinfo.output_shapes);
   IVLOG(2, to_string(runinfo.program));
   auto stripe = GenerateStripe(runinfo);
-  return GenerateProgram(stripe, cfg_name, out_dir, const_bufs);
+  return GenerateProgram(ctx, stripe, cfg_name, out_dir, const_bufs);
 }
 
 }  // End namespace codegen
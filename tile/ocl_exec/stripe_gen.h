@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "base/context/context.h"
 #include "tile/base/buffer.h"
 #include "tile/lang/generate.h"
 #include "tile/lang/runinfo.h"
@@ -24,6 +25,23 @@ lang::KernelList GenerateProgram(                     //
     const std::string& out_dir = "",                  //
     ConstBufferManager* const_bufs = {});
 
+// As above, but with the caller's context threaded into the pass pipeline:
+// its cancellation gate and deadline bound the compile's search effort.  See
+// the context-taking Optimize overload in codegen/driver.h.
+lang::KernelList GenerateProgram(     //
+    const context::Context& ctx,      //
+    const lang::RunInfo& runinfo,     //
+    const std::string& cfg_name,      //
+    const std::string& out_dir = "",  //
+    ConstBufferManager* const_bufs = {});
+
+lang::KernelList GenerateProgram(                     //
+    const context::Context& ctx,                      //
+    const std::shared_ptr<stripe::Program>& program,  //
+    const std::string& cfg_name,                      //
+    const std::string& out_dir = "",                  //
+    ConstBufferManager* const_bufs = {});
+
 }  // End namespace codegen
 }  // End namespace tile
 }  // End namespace vertexai
@@ -0,0 +1,117 @@
+// Copyright 2019 Intel Corporation.
+
+#include "tile/platform/local_machine/binding_audit.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+namespace {
+
+constexpr std::size_t kRingSize = 4096;
+
+std::uint64_t ParseRate(const char* var) {
+  auto value = env::Get(var);
+  if (value.empty()) {
+    return 0;
+  }
+  return std::strtoull(value.c_str(), nullptr, 10);
+}
+
+}  // namespace
+
+BindingAudit* BindingAudit::Instance() {
+  static BindingAudit audit;
+  return &audit;
+}
+
+BindingAudit::BindingAudit()
+    : enabled_{env::Get("PLAIDML_BINDING_AUDIT") != "0"},
+      hash_rate_{ParseRate("PLAIDML_BINDING_AUDIT_HASH_RATE")},
+      slots_(enabled_ ? kRingSize : 0) {}
+
+bool BindingAudit::SampleContents() {
+  if (!enabled_ || !hash_rate_) {
+    return false;
+  }
+  return runs_.fetch_add(1, std::memory_order_relaxed) % hash_rate_ == 0;
+}
+
+void BindingAudit::LogBinding(const void* shim, const void* program, std::uint32_t alloc_idx, const std::string& name,
+                              const MemChunk* chunk, std::uint64_t content_hash, bool on_exit) {
+  if (!enabled_) {
+    return;
+  }
+  auto ticket = next_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = slots_[ticket % slots_.size()];
+  slot.ticket = ticket + 1;
+  slot.shim = shim;
+  slot.program = program;
+  slot.alloc_idx = alloc_idx;
+  std::strncpy(slot.name, name.c_str(), sizeof(slot.name) - 1);
+  slot.name[sizeof(slot.name) - 1] = '\0';
+  slot.chunk = chunk;
+  slot.size = chunk ? chunk->size() : 0;
+  slot.content_hash = content_hash;
+  slot.on_exit = on_exit;
+}
+
+std::uint64_t BindingAudit::HashContents(const context::Context& ctx, MemChunk* chunk) {
+  try {
+    auto view = chunk->MapCurrent(ctx).get();
+    // FNV-1a; cheap, and collisions only matter across the handful of
+    // chunks alive in one trace window.
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < view->size(); ++i) {
+      hash = (hash ^ static_cast<unsigned char>((*view)[i])) * 0x100000001b3ull;
+    }
+    // Reserve 0 to mean "not sampled".
+    return hash ? hash : 1;
+  } catch (const std::exception& ex) {
+    // A chunk whose producer failed can't be mapped; the binding record is
+    // still worth keeping.
+    VLOG(1) << "Binding audit could not hash chunk contents: " << ex.what();
+    return 0;
+  }
+}
+
+void BindingAudit::Dump(std::ostream& os) {
+  if (!enabled_) {
+    os << "binding audit disabled\n";
+    return;
+  }
+  // Racy reads by design: the dump runs post-mortem, when writers are
+  // quiescent; at worst a slot being overwritten prints torn.
+  std::vector<const Record*> window;
+  window.reserve(slots_.size());
+  for (const auto& slot : slots_) {
+    if (slot.ticket) {
+      window.push_back(&slot);
+    }
+  }
+  std::sort(window.begin(), window.end(),
+            [](const Record* lhs, const Record* rhs) { return lhs->ticket < rhs->ticket; });
+  for (const auto* rec : window) {
+    os << "#" << rec->ticket << " shim=" << rec->shim << " program=" << rec->program
+       << (rec->on_exit ? " exit " : " entry ") << "alloc[" << rec->alloc_idx << "]";
+    if (rec->name[0]) {
+      os << " '" << rec->name << "'";
+    }
+    os << " -> chunk=" << rec->chunk << " size=" << rec->size;
+    if (rec->content_hash) {
+      os << " hash=" << std::hex << rec->content_hash << std::dec;
+    }
+    os << "\n";
+  }
+}
+
+void DumpBindingAudit(std::ostream& os) { BindingAudit::Instance()->Dump(os); }
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,84 @@
+// Copyright 2019 Intel Corporation.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/context/context.h"
+#include "tile/platform/local_machine/mem_chunk.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// An always-on audit trail of program buffer bindings.
+//
+// Each run's Shim records which chunk every alloc was bound to into a
+// fixed-size in-memory ring; the hot path is one relaxed atomic increment
+// plus a handful of scalar stores, so the trail stays enabled in production
+// without perturbing timing the way VLOG-based tracing does.  A sampled
+// fraction of runs additionally content-hashes their input and output
+// chunks, giving misbinding bugs (two refs silently aliased to the same
+// chunk, or an output remapped to a stale chunk) a durable signature.
+//
+// The retained window can be dumped post-mortem: Shim dumps it
+// automatically when a launch fails, and DumpBindingAudit is exposed for
+// debuggers and test harnesses.  PLAIDML_BINDING_AUDIT=0 disables the
+// trail entirely; PLAIDML_BINDING_AUDIT_HASH_RATE=N hashes roughly one run
+// in N (default 0 = never).
+class BindingAudit {
+ public:
+  static BindingAudit* Instance();
+
+  // One recorded binding.  Plain scalars only, so recording never
+  // allocates; the ref name is truncated to fit.
+  struct Record {
+    std::uint64_t ticket = 0;  // 1-based claim order; 0 = slot never used
+    const void* shim = nullptr;
+    const void* program = nullptr;
+    std::uint32_t alloc_idx = 0;
+    char name[24] = {};
+    const void* chunk = nullptr;
+    std::uint64_t size = 0;
+    std::uint64_t content_hash = 0;  // 0 = contents not sampled
+    bool on_exit = false;            // false: bound at entry; true: output remap
+  };
+
+  bool enabled() const { return enabled_; }
+
+  // Decides whether this run's chunk contents should be hashed; called once
+  // per Shim so a sampled run hashes both its entry and exit bindings.
+  bool SampleContents();
+
+  // Appends a binding record; hash is 0 when contents were not sampled.
+  void LogBinding(const void* shim, const void* program, std::uint32_t alloc_idx, const std::string& name,
+                  const MemChunk* chunk, std::uint64_t content_hash, bool on_exit);
+
+  // Computes the content hash of a chunk by mapping it; waits for pending
+  // writes, so this is only called on sampled runs.
+  static std::uint64_t HashContents(const context::Context& ctx, MemChunk* chunk);
+
+  // Writes the retained window, oldest record first.
+  void Dump(std::ostream& os);
+
+ private:
+  BindingAudit();
+
+  bool enabled_;
+  std::uint64_t hash_rate_;
+  std::atomic<std::uint64_t> runs_{0};
+  std::vector<Record> slots_;
+  std::atomic<std::uint64_t> next_{0};
+};
+
+// Writes the process-wide binding audit trail; see BindingAudit::Dump.
+void DumpBindingAudit(std::ostream& os);
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -2,6 +2,8 @@
 
 #include "tile/platform/local_machine/block_placer.h"
 
+#include <unordered_map>
+
 #include <boost/dynamic_bitset.hpp>
 
 #include "base/util/compat.h"
@@ -67,6 +69,27 @@ void AddOutputStep(schedule::Schedule* schedule) {
   schedule->steps.emplace_back(std::move(step));
 }
 
+inline std::uint64_t HashCombine(std::uint64_t digest, std::uint64_t value) {
+  return (digest ^ value) * 0x100000001B3ull;  // FNV-1a step
+}
+
+// Computes a canonical signature per step: what kind of work it does and
+// how many buffers it touches, but nothing about which allocs those are.
+// Steps instantiated from the same subgraph hash equal.
+std::vector<std::uint64_t> BuildStepSignatures(const schedule::Schedule& schedule) {
+  std::vector<std::uint64_t> sigs;
+  sigs.reserve(schedule.steps.size());
+  for (const auto& step : schedule.steps) {
+    std::uint64_t sig = 0xCBF29CE484222325ull;
+    sig = HashCombine(sig, static_cast<std::uint64_t>(step.tag));
+    sig = HashCombine(sig, step.kidx);
+    sig = HashCombine(sig, step.outputs.size());
+    sig = HashCombine(sig, step.inputs.size());
+    sigs.push_back(sig);
+  }
+  return sigs;
+}
+
 // Given a schedule, returns a vector of bitsets, one bit and bitset
 // for each step.  In each step's bitset, bit N is set iff the step
 // has a transitive dependency on step N.
@@ -279,36 +302,64 @@ BlockPlacement::BlockPlacement(const tile::proto::Program& program, schedule::Sc
     return lhs->byte_size > rhs->byte_size;
   });
 
+  auto try_assign = [&](AllocInfo* alloc_info, TmpInfo* tmp_info, bool is_output) {
+    if (is_output && (alloc_info->byte_size != tmp_info->byte_size)) {
+      // Require output buffer reuse to be identical size.
+      return false;
+    }
+    if (alloc_info->byte_size < tmp_info->byte_size) {
+      return false;
+    }
+    if (alloc_info->read_only) {
+      return false;
+    }
+    for (TmpInfo* assigned_tmp : alloc_info->assigned_tmps) {
+      if (!IsCompatible(deps, accessors, assigned_tmp, tmp_info)) {
+        return false;
+      }
+    }
+    add_to_alloc(tmp_info, alloc_info);
+    return true;
+  };
+
+  // Memoized placement for repeated subgraphs: a model that repeats the
+  // same layer block produces runs of temporaries whose size and relative
+  // accessor pattern are identical, one run per layer.  Hash that pattern
+  // and try the alloc the previous instance landed in before scanning;
+  // the full compatibility check still runs, so a hint that doesn't hold
+  // (e.g. at the seam between repetitions) just falls through to the
+  // general search.
+  auto step_sigs = BuildStepSignatures(*schedule);
+  auto tmp_signature = [&](const TmpInfo* tmp_info) {
+    std::uint64_t sig = 0xCBF29CE484222325ull;
+    sig = HashCombine(sig, tmp_info->byte_size);
+    sig = HashCombine(sig, tmp_info->output.length() ? 1 : 0);
+    const auto& bits = accessors[tmp_info->aidx];
+    for (auto bit = bits.find_first(); bit != boost::dynamic_bitset<>::npos; bit = bits.find_next(bit)) {
+      sig = HashCombine(sig, bit - tmp_info->sidx_first);
+      sig = HashCombine(sig, step_sigs[bit]);
+    }
+    return sig;
+  };
+  std::unordered_map<std::uint64_t, AllocInfo*> pattern_hints;
+
   // Create tmp->alloc assignments.  When assigning temporaries, we first try to reuse
   // existing temporary allocs, then try using IO memory, and finally create new
   // allocations when we need one.
   for (TmpInfo* tmp_info : tmp_infos) {
     bool is_output = tmp_info->output.length();
-    for (bool consider_io_allocs = is_output;; consider_io_allocs = true) {
+    std::uint64_t sig = tmp_signature(tmp_info);
+    auto hint = pattern_hints.find(sig);
+    if (hint != pattern_hints.end()) {
+      try_assign(hint->second, tmp_info, is_output);
+    }
+    for (bool consider_io_allocs = is_output; !tmp_info->assignment; consider_io_allocs = true) {
       for (auto& alloc_info : alloc_infos_) {
         bool is_io_alloc = alloc_info.input.length() || alloc_info.output.length();
         if ((!consider_io_allocs && is_io_alloc) || (consider_io_allocs && !is_io_alloc)) {
           continue;
         }
-        if (is_output && (alloc_info.byte_size != tmp_info->byte_size)) {
-          // Require output buffer reuse to be identical size.
-          continue;
-        }
-        if (alloc_info.byte_size < tmp_info->byte_size) {
-          continue;
-        }
-        if (alloc_info.read_only) {
-          continue;
-        }
-        bool compatible = true;
-        for (TmpInfo* assigned_tmp : alloc_info.assigned_tmps) {
-          if (!IsCompatible(deps, accessors, assigned_tmp, tmp_info)) {
-            compatible = false;
-            break;
-          }
-        }
-        if (compatible) {
-          add_to_alloc(tmp_info, &alloc_info);
+        if (try_assign(&alloc_info, tmp_info, is_output)) {
           break;
         }
       }
@@ -321,6 +372,7 @@ BlockPlacement::BlockPlacement(const tile::proto::Program& program, schedule::Sc
         break;
       }
     }
+    pattern_hints[sig] = tmp_info->assignment;
   }
 
   // Remove the synthetic initial and final steps.
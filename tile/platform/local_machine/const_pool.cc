@@ -0,0 +1,46 @@
+// Copyright 2019 Intel Corporation.
+
+#include "tile/platform/local_machine/const_pool.h"
+
+#include <cstring>
+
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+std::shared_ptr<tile::Buffer> ConstPool::Intern(const context::Context& ctx, const std::shared_ptr<tile::Buffer>& buf) {
+  auto view = buf->MapCurrent(ctx).get();
+  uint64_t hash = 0xcbf29ce484222325ull;
+  const char* data = view->data();
+  for (size_t i = 0; i < view->size(); i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ull;
+  }
+  Key key{buf->size(), hash};
+
+  std::lock_guard<std::mutex> lock{mu_};
+  auto& chain = entries_[key];
+  for (auto it = chain.begin(); it != chain.end();) {
+    auto resident = it->lock();
+    if (!resident) {
+      it = chain.erase(it);
+      continue;
+    }
+    if (resident == buf) {
+      return resident;
+    }
+    auto resident_view = resident->MapCurrent(ctx).get();
+    if (resident_view->size() == view->size() && !std::memcmp(resident_view->data(), data, view->size())) {
+      IVLOG(2, "ConstPool> sharing resident constant, " << buf->size() << " bytes");
+      return resident;
+    }
+    ++it;
+  }
+  chain.emplace_back(buf);
+  return buf;
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
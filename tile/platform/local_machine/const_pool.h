@@ -0,0 +1,42 @@
+// Copyright 2019 Intel Corporation.
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "base/context/context.h"
+#include "tile/base/buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// A per-device pool of constant tensors, keyed by content.  Programs
+// compiled against the same device (e.g. several signatures over one set of
+// weights) each propagate their own copies of constant buffers; interning
+// them here keeps a single resident copy per distinct content.  Residency is
+// refcounted naturally: the pool holds weak references, so a constant stays
+// on the device exactly as long as some live Program maps it into its
+// inputs.
+class ConstPool {
+ public:
+  // Returns a resident buffer whose contents match buf, registering buf as
+  // the resident copy if there is none.  Contents are verified on hash
+  // matches, so a hash collision costs a comparison, never a wrong buffer.
+  std::shared_ptr<tile::Buffer> Intern(const context::Context& ctx, const std::shared_ptr<tile::Buffer>& buf);
+
+ private:
+  // (byte size, FNV-1a content hash)
+  using Key = std::pair<uint64_t, uint64_t>;
+
+  std::mutex mu_;
+  std::map<Key, std::list<std::weak_ptr<tile::Buffer>>> entries_;
+};
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,125 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/platform/local_machine/cpath_scheduler.h"
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/util/factory.h"
+#include "tile/platform/local_machine/block_placer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+namespace {
+
+// Estimates the cost of executing a single step, in arbitrary units.  Run
+// steps are charged the kernel's estimated flops plus bytes moved; copy
+// steps are charged their byte count.  The floor of one keeps zero-cost
+// steps from disappearing off the critical path entirely.
+std::uint64_t StepCost(const schedule::Step& step, const lang::KernelList& kl) {
+  std::uint64_t cost = 0;
+  switch (step.tag) {
+    case schedule::Step::Tag::kRun: {
+      const auto& ki = kl.kernels[step.kidx];
+      cost = ki.tot_flops + ki.tot_bytes;
+      break;
+    }
+    case schedule::Step::Tag::kCopy:
+      cost = step.byte_count;
+      break;
+    default:
+      break;
+  }
+  return std::max<std::uint64_t>(cost, 1);
+}
+
+}  // namespace
+
+CriticalPathScheduler::CriticalPathScheduler(const std::shared_ptr<Placer>& placer) : placer_{placer} {}
+
+schedule::Schedule CriticalPathScheduler::BuildSchedule(const tile::proto::Program& program,
+                                                        const lang::KernelList& kl) {
+  schedule::Schedule schedule = ToScheduleSteps(program, kl);
+  AddDataflowDeps(&schedule);
+
+  // Weight each step with its downstream critical-path length: the step's
+  // own cost plus the heaviest weight among the steps that depend on it.
+  // Dependencies always point at earlier steps, so a single reverse pass
+  // sees every step after all of its dependents.
+  std::unordered_map<schedule::Step*, std::uint64_t> weight;
+  std::unordered_map<schedule::Step*, std::list<schedule::Step>::iterator> locs;
+  for (auto it = schedule.steps.begin(); it != schedule.steps.end(); ++it) {
+    weight[&*it] = StepCost(*it, kl);
+    locs[&*it] = it;
+  }
+  std::unordered_map<schedule::Step*, std::vector<schedule::Step*>> successors;
+  for (auto it = schedule.steps.rbegin(); it != schedule.steps.rend(); ++it) {
+    for (schedule::Step* dep : it->deps) {
+      weight[dep] = std::max(weight[dep], StepCost(*dep, kl) + weight[&*it]);
+      successors[dep].push_back(&*it);
+    }
+  }
+
+  // List-schedule: issue the ready step with the heaviest downstream path,
+  // breaking ties in favor of the original order for determinism.
+  std::unordered_map<schedule::Step*, std::size_t> remaining;
+  std::vector<schedule::Step*> ready;
+  auto heavier = [&](schedule::Step* lhs, schedule::Step* rhs) {
+    if (weight[lhs] != weight[rhs]) {
+      return weight[lhs] > weight[rhs];
+    }
+    return lhs->idx < rhs->idx;
+  };
+  for (auto& step : schedule.steps) {
+    remaining[&step] = step.deps.size();
+    if (step.deps.empty()) {
+      ready.push_back(&step);
+    }
+  }
+  std::list<schedule::Step> ordered;
+  while (!ready.empty()) {
+    auto best = std::min_element(ready.begin(), ready.end(), heavier);
+    schedule::Step* step = *best;
+    ready.erase(best);
+    ordered.splice(ordered.end(), schedule.steps, locs[step]);
+    for (schedule::Step* successor : successors[step]) {
+      if (--remaining[successor] == 0) {
+        ready.push_back(successor);
+      }
+    }
+  }
+  schedule.steps = std::move(ordered);
+  schedule.Reindex();
+
+  placer_->PlaceSchedule(program, &schedule)->Apply();
+  return schedule;
+}
+
+const char* CriticalPathScheduler::name() const { return "CriticalPath"; }
+
+namespace {
+
+class Factory final : public SchedulerFactory {
+ public:
+  std::shared_ptr<Scheduler> MakeScheduler(const SchedulerParams& params) final {
+    return std::make_shared<CriticalPathScheduler>(std::make_shared<BlockPlacer>(params.alignment));
+  }
+};
+
+[[gnu::unused]] char reg = []() -> char {
+  FactoryRegistrar<SchedulerFactory>::Instance()->Register(
+      "cpath",  //
+      [](const context::Context& ctx) { return std::make_unique<Factory>(); },  //
+      FactoryPriority::LOW);
+  return 0;
+}();
+
+}  // namespace
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
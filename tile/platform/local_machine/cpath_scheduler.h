@@ -0,0 +1,38 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <memory>
+
+#include "tile/platform/local_machine/placer.h"
+#include "tile/platform/local_machine/scheduler.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// A list scheduler that orders steps by downstream critical-path length.
+//
+// Each step is weighted by its own cost estimate (from the kernel cost
+// estimates in lang::KernelInfo) plus the heaviest chain of steps that
+// depend on it; ready steps are then issued heaviest-path-first.  On
+// branchy graphs this starts the long dependence chains early instead of
+// letting an arbitrary issue order serialize them behind short ones,
+// reducing makespan where FifoScheduler's locality heuristics pick badly.
+//
+// Selected at runtime via PLAIDML_SCHEDULER=cpath.
+class CriticalPathScheduler final : public Scheduler {
+ public:
+  explicit CriticalPathScheduler(const std::shared_ptr<Placer>& placer);
+
+  schedule::Schedule BuildSchedule(const tile::proto::Program& program, const lang::KernelList& kl) final;
+
+  const char* name() const final;
+
+ private:
+  std::shared_ptr<Placer> placer_;
+};
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,412 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/platform/local_machine/cpu_ops.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/context/context.h"
+#include "base/util/env.h"
+#include "base/util/logging.h"
+#include "tile/base/hal.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+namespace {
+
+// Walks a set of dimensions as a mixed-radix counter, tracking the linear
+// element offset implied by the strides.  A rank-zero odometer holds the
+// single offset zero; callers visit the current offset before advancing, so
+// every shape yields at least one element.
+class Odometer {
+ public:
+  explicit Odometer(const TensorDimensions& dims) : dims_(dims), coords_(dims.size(), 0) {}
+
+  int64_t offset() const { return offset_; }
+
+  // Advances to the next coordinate; returns false once every coordinate has
+  // been visited.
+  bool Next() {
+    for (size_t i = dims_.size(); i > 0; i--) {
+      auto& coord = coords_[i - 1];
+      const auto& dim = dims_[i - 1];
+      offset_ += dim.stride;
+      if (++coord < dim.size) {
+        return true;
+      }
+      offset_ -= static_cast<int64_t>(dim.size) * dim.stride;
+      coord = 0;
+    }
+    return false;
+  }
+
+ private:
+  TensorDimensions dims_;
+  std::vector<uint64_t> coords_;
+  int64_t offset_ = 0;
+};
+
+// Whether the dimensions are dense and row-major, i.e. a single memcpy can
+// stand in for walking them element-by-element.
+bool DenseRowMajor(const TensorDimensions& dims) {
+  int64_t expect = 1;
+  for (size_t i = dims.size(); i > 0; i--) {
+    if (dims[i - 1].stride != expect) {
+      return false;
+    }
+    expect *= dims[i - 1].size;
+  }
+  return true;
+}
+
+uint64_t ElemCount(const TensorDimensions& dims) {
+  uint64_t count = 1;
+  for (const auto& dim : dims) {
+    count *= dim.size;
+  }
+  return count;
+}
+
+bool IndexTypeSupported(DataType type) {
+  switch (type) {
+    case DataType::INT8:
+    case DataType::INT16:
+    case DataType::INT32:
+    case DataType::INT64:
+    case DataType::UINT8:
+    case DataType::UINT16:
+    case DataType::UINT32:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t ReadIndex(const void* base, DataType type, int64_t elem) {
+  switch (type) {
+    case DataType::INT8:
+      return static_cast<const int8_t*>(base)[elem];
+    case DataType::INT16:
+      return static_cast<const int16_t*>(base)[elem];
+    case DataType::INT32:
+      return static_cast<const int32_t*>(base)[elem];
+    case DataType::INT64:
+      return static_cast<const int64_t*>(base)[elem];
+    case DataType::UINT8:
+      return static_cast<const uint8_t*>(base)[elem];
+    case DataType::UINT16:
+      return static_cast<const uint16_t*>(base)[elem];
+    case DataType::UINT32:
+      return static_cast<const uint32_t*>(base)[elem];
+    default:
+      throw std::runtime_error("Unsupported index datatype for host execution");
+  }
+}
+
+// out[I, T] = data[clamp(idx[I]), T]: the host counterpart of GenGather,
+// with the same clamp-to-first-dimension semantics.  I ranges over the index
+// tensor's coordinates, T over the data tensor's trailing dimensions.
+void RunGather(const TensorShape& out_shape, const TensorShape& data_shape, const TensorShape& idx_shape,  //
+               void* out, const void* data, const void* idx) {
+  const size_t elem_bytes = byte_width(data_shape.type);
+  const int64_t row_limit = static_cast<int64_t>(data_shape.dims[0].size) - 1;
+  const size_t idx_rank = idx_shape.dims.size();
+
+  TensorDimensions out_head(out_shape.dims.begin(), out_shape.dims.begin() + idx_rank);
+  TensorDimensions out_tail(out_shape.dims.begin() + idx_rank, out_shape.dims.end());
+  TensorDimensions data_tail(data_shape.dims.begin() + 1, data_shape.dims.end());
+
+  const bool rows_dense = DenseRowMajor(data_tail) && DenseRowMajor(out_tail);
+  const size_t row_bytes = ElemCount(data_tail) * elem_bytes;
+
+  Odometer idx_it(idx_shape.dims);
+  Odometer dst_it(out_head);
+  do {
+    int64_t row = ReadIndex(idx, idx_shape.type, idx_it.offset());
+    row = std::min(std::max<int64_t>(row, 0), row_limit);
+    const char* src_base = static_cast<const char*>(data) + row * data_shape.dims[0].stride * elem_bytes;
+    char* dst_base = static_cast<char*>(out) + dst_it.offset() * elem_bytes;
+    if (rows_dense) {
+      std::memcpy(dst_base, src_base, row_bytes);
+    } else {
+      Odometer src_elem(data_tail);
+      Odometer dst_elem(out_tail);
+      do {
+        std::memcpy(dst_base + dst_elem.offset() * elem_bytes, src_base + src_elem.offset() * elem_bytes, elem_bytes);
+      } while (src_elem.Next() && dst_elem.Next());
+    }
+  } while (idx_it.Next() && dst_it.Next());
+}
+
+// out[clamp(idx[I]), T] += expn[I, T]: the host counterpart of GenScatter.
+// Accumulates into the output's prior contents, matching the device kernel,
+// which relies on an earlier step having zeroed the buffer.
+template <typename T>
+void RunScatterTyped(const TensorShape& out_shape, const TensorShape& expn_shape, const TensorShape& idx_shape,  //
+                     void* out, const void* expn, const void* idx) {
+  const int64_t row_limit = static_cast<int64_t>(out_shape.dims[0].size) - 1;
+  const size_t idx_rank = idx_shape.dims.size();
+
+  TensorDimensions expn_head(expn_shape.dims.begin(), expn_shape.dims.begin() + idx_rank);
+  TensorDimensions expn_tail(expn_shape.dims.begin() + idx_rank, expn_shape.dims.end());
+  TensorDimensions out_tail(out_shape.dims.begin() + 1, out_shape.dims.end());
+
+  T* out_t = static_cast<T*>(out);
+  const T* expn_t = static_cast<const T*>(expn);
+
+  Odometer idx_it(idx_shape.dims);
+  Odometer src_it(expn_head);
+  do {
+    int64_t row = ReadIndex(idx, idx_shape.type, idx_it.offset());
+    row = std::min(std::max<int64_t>(row, 0), row_limit);
+    const int64_t out_base = row * out_shape.dims[0].stride;
+    Odometer src_elem(expn_tail);
+    Odometer dst_elem(out_tail);
+    do {
+      out_t[out_base + dst_elem.offset()] += expn_t[src_it.offset() + src_elem.offset()];
+    } while (src_elem.Next() && dst_elem.Next());
+  } while (idx_it.Next() && src_it.Next());
+}
+
+bool ScatterTypeSupported(DataType type) {
+  switch (type) {
+    case DataType::INT8:
+    case DataType::INT16:
+    case DataType::INT32:
+    case DataType::INT64:
+    case DataType::UINT8:
+    case DataType::UINT16:
+    case DataType::UINT32:
+    case DataType::UINT64:
+    case DataType::FLOAT32:
+    case DataType::FLOAT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void RunScatter(const TensorShape& out_shape, const TensorShape& expn_shape, const TensorShape& idx_shape,  //
+                void* out, const void* expn, const void* idx) {
+  switch (out_shape.type) {
+    case DataType::INT8:
+      return RunScatterTyped<int8_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::INT16:
+      return RunScatterTyped<int16_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::INT32:
+      return RunScatterTyped<int32_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::INT64:
+      return RunScatterTyped<int64_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::UINT8:
+      return RunScatterTyped<uint8_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::UINT16:
+      return RunScatterTyped<uint16_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::UINT32:
+      return RunScatterTyped<uint32_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::UINT64:
+      return RunScatterTyped<uint64_t>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::FLOAT32:
+      return RunScatterTyped<float>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    case DataType::FLOAT64:
+      return RunScatterTyped<double>(out_shape, expn_shape, idx_shape, out, expn, idx);
+    default:
+      throw std::runtime_error("Unsupported scatter datatype for host execution");
+  }
+}
+
+// A native host implementation of one special kernel, bound to its shapes.
+struct HostOp {
+  // Invoked with one raw host pointer per kernel parameter, outputs first,
+  // matching run-step parameter order.
+  std::function<void(const std::vector<void*>&)> run;
+  std::vector<TensorShape> shapes;  // one per parameter, outputs first
+  // Whether the op reads its output's prior contents (scatter accumulates
+  // into a previously-zeroed buffer).
+  bool reads_output = false;
+};
+
+std::shared_ptr<HostOp> MakeHostOp(const lang::KernelInfo& ki, const ShapeMap& types) {
+  std::vector<TensorShape> shapes;
+  for (const auto& name : ki.outputs) {
+    auto it = types.find(name);
+    if (it == types.end()) {
+      return nullptr;
+    }
+    shapes.push_back(it->second);
+  }
+  for (const auto& name : ki.inputs) {
+    auto it = types.find(name);
+    if (it == types.end()) {
+      return nullptr;
+    }
+    shapes.push_back(it->second);
+  }
+
+  const auto& fn = ki.info.special().fn();
+  if (fn == "gather") {
+    // Parameters: out, data, idx.
+    if (shapes.size() != 3 || shapes[1].dims.empty() || shapes[2].dims.size() > shapes[0].dims.size() ||
+        !IndexTypeSupported(shapes[2].type)) {
+      return nullptr;
+    }
+    auto op = std::make_shared<HostOp>();
+    op->shapes = shapes;
+    op->run = [shapes](const std::vector<void*>& bufs) {
+      RunGather(shapes[0], shapes[1], shapes[2], bufs[0], bufs[1], bufs[2]);
+    };
+    return op;
+  }
+  if (fn == "scatter") {
+    // Parameters: out, expn, idx.
+    if (shapes.size() != 3 || shapes[0].dims.empty() || shapes[2].dims.size() > shapes[1].dims.size() ||
+        !IndexTypeSupported(shapes[2].type) || !ScatterTypeSupported(shapes[0].type)) {
+      return nullptr;
+    }
+    auto op = std::make_shared<HostOp>();
+    op->shapes = shapes;
+    op->reads_output = true;
+    op->run = [shapes](const std::vector<void*>& bufs) {
+      RunScatter(shapes[0], shapes[1], shapes[2], bufs[0], bufs[1], bufs[2]);
+    };
+    return op;
+  }
+  return nullptr;
+}
+
+// Times one run of the host implementation on zero-filled scratch buffers at
+// the kernel's actual shapes (zero indices are in-range after clamping).
+// Memoized per function-and-shape signature, so recompiles and repeated
+// shapes don't re-measure.
+std::chrono::nanoseconds MeasuredHostTime(const std::string& fn, const HostOp& op) {
+  std::ostringstream key;
+  key << fn;
+  for (const auto& shape : op.shapes) {
+    key << "|" << shape;
+  }
+
+  static std::mutex mu;
+  static std::map<std::string, std::chrono::nanoseconds> measured;
+  std::lock_guard<std::mutex> lock{mu};
+  auto it = measured.find(key.str());
+  if (it != measured.end()) {
+    return it->second;
+  }
+
+  std::vector<std::vector<char>> storage;
+  std::vector<void*> bufs;
+  storage.reserve(op.shapes.size());
+  for (const auto& shape : op.shapes) {
+    storage.emplace_back(std::max<uint64_t>(shape.byte_size(), 1), 0);
+    bufs.push_back(storage.back().data());
+  }
+  // One warming run faults the pages in; the second run is the measurement.
+  op.run(bufs);
+  auto start = std::chrono::high_resolution_clock::now();
+  op.run(bufs);
+  auto elapsed =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start);
+  measured[key.str()] = elapsed;
+  return elapsed;
+}
+
+}  // namespace
+
+void ApplyCpuOpAffinity(schedule::Schedule* schedule, const lang::KernelList& kernel_list) {
+  auto spec = env::Get("PLAIDML_CPU_OPS");
+  if (spec.empty() || spec == "0" || spec == "none") {
+    return;
+  }
+  bool auto_select = false;
+  std::set<std::string> pinned;
+  std::istringstream tokens{spec};
+  std::string token;
+  while (std::getline(tokens, token, ',')) {
+    if (token == "auto") {
+      auto_select = true;
+    } else if (!token.empty()) {
+      pinned.insert(token);
+    }
+  }
+  std::chrono::nanoseconds threshold = std::chrono::microseconds{20};
+  auto threshold_env = env::Get("PLAIDML_CPU_OPS_THRESHOLD");
+  if (!threshold_env.empty()) {
+    threshold = std::chrono::microseconds{std::stoull(threshold_env)};
+  }
+
+  for (auto& step : schedule->steps) {
+    if (step.tag != schedule::Step::Tag::kRun || step.kidx >= kernel_list.kernels.size()) {
+      continue;
+    }
+    const auto& ki = kernel_list.kernels[step.kidx];
+    if (ki.info.kernel_type_case() != lang::proto::KernelInfo::kSpecial) {
+      continue;
+    }
+    const auto& fn = ki.info.special().fn();
+    if (!auto_select && !pinned.count(fn)) {
+      continue;
+    }
+    if (step.outputs.size() != ki.outputs.size() || step.inputs.size() != ki.inputs.size()) {
+      continue;
+    }
+    auto op = MakeHostOp(ki, kernel_list.types);
+    if (!op) {
+      IVLOG(2, "CpuOps: no host implementation for " << ki.kname << " (" << fn << "); leaving it on the device");
+      continue;
+    }
+    if (!pinned.count(fn)) {
+      auto elapsed = MeasuredHostTime(fn, *op);
+      if (elapsed > threshold) {
+        IVLOG(2, "CpuOps: " << ki.kname << " (" << fn << ") measured " << elapsed.count()
+                            << "ns on the host; leaving it on the device");
+        continue;
+      }
+      IVLOG(2, "CpuOps: " << ki.kname << " (" << fn << ") measured " << elapsed.count() << "ns on the host");
+    }
+
+    const bool reads_output = op->reads_output;
+    const size_t output_count = step.outputs.size();
+    step.tag = schedule::Step::Tag::kCallback;
+    step.callback_name = "cpu:" + ki.kname;
+    step.callback = [op, reads_output, output_count](const std::vector<std::shared_ptr<hal::Buffer>>& params) {
+      std::vector<void*> bufs(params.size());
+      for (size_t i = 0; i < params.size(); i++) {
+        // Scatter reads its output's prior contents, so its output maps
+        // current rather than discard.  The schedule's dependencies have
+        // already resolved by the time a callback runs, so no events.
+        if (i < output_count && !reads_output) {
+          bufs[i] = params[i]->MapDiscard({}).get();
+        } else {
+          bufs[i] = params[i]->MapCurrent({}).get();
+        }
+      }
+      op->run(bufs);
+      // Dependent steps wait on the callback's completion rather than on
+      // the unmaps, and the device's view is inconsistent until an unmap's
+      // event completes, so resolve the unmaps before returning.
+      context::Context ctx;
+      std::vector<std::shared_ptr<hal::Event>> unmaps;
+      unmaps.reserve(params.size());
+      for (const auto& param : params) {
+        unmaps.emplace_back(param->Unmap(ctx));
+      }
+      for (const auto& unmap : unmaps) {
+        unmap->GetFuture().get();
+      }
+    };
+    IVLOG(1, "CpuOps: pinned " << ki.kname << " (" << fn << ") to the host");
+  }
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
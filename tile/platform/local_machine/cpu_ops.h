@@ -0,0 +1,33 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include "tile/base/schedule.h"
+#include "tile/lang/generate.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// Rewrites run steps whose kernels are special-function lowerings (gather,
+// scatter) into host callback steps backed by native CPU implementations.
+// Index-chasing ops see little parallelism on the device, so for small
+// tensors the launch and synchronization overhead dominates; running them on
+// the host turns the step into a map/compute/unmap on already-resolved
+// dependencies, with the surrounding schedule unchanged.
+//
+// Controlled by PLAIDML_CPU_OPS: a comma-separated list of special function
+// names to pin to the host, and/or "auto" to decide per kernel by
+// microbenchmarking the host implementation at the kernel's actual shapes
+// and taking the host when it beats the device launch-overhead floor
+// (PLAIDML_CPU_OPS_THRESHOLD, in microseconds).  Unset disables rewriting.
+//
+// Kernels whose datatypes have no host implementation are left on the
+// device.  The schedule replay cache never persists callback schedules, so
+// the rewrite is applied after replay, keeping cached and fresh plans
+// equivalent.
+void ApplyCpuOpAffinity(schedule::Schedule* schedule, const lang::KernelList& kernel_list);
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -24,15 +24,18 @@ CpuProgram::CpuProgram(            //
   codegen::OptimizeOptions options = {
       !out_dir.empty(),    // dump_passes
       false,               // dump_passes_proto
+      false,               // dump_passes_deltas
       false,               // dump_code
+      false,               // parallel
       out_dir / "passes",  // dbg_dir
   };
-  const auto& cfgs = targets::GetConfigs();
-  const auto& cfg = cfgs.configs().at(target);
+  std::string cfg_version;
+  auto cfgs = targets::GetConfigs(&cfg_version);
+  const auto& cfg = cfgs->configs().at(target);
   const auto& stage = cfg.stages().at("default");
   codegen::CompilerState state(stripe);
   state.const_bufs = const_bufs;
-  codegen::Optimize(&state, stage.passes(), options);
+  codegen::OptimizeCached(&state, target + "@" + cfg_version, stage.passes(), options);
   targets::cpu::Config config;
   if (!env::Get("PLAIDML_CPU_PROFILE").empty()) {
     config.profile_block_execution = true;
@@ -50,15 +53,18 @@ CpuProgram::CpuProgram(                              //
   codegen::OptimizeOptions options = {
       !out_dir.empty(),    // dump_passes
       false,               // dump_passes_proto
+      false,               // dump_passes_deltas
       false,               // dump_code
+      false,               // parallel
       out_dir / "passes",  // dbg_dir
   };
-  const auto& cfgs = targets::GetConfigs();
-  const auto& cfg = cfgs.configs().at(target);
+  std::string cfg_version;
+  auto cfgs = targets::GetConfigs(&cfg_version);
+  const auto& cfg = cfgs->configs().at(target);
   const auto& stage = cfg.stages().at("default");
   codegen::CompilerState state(stripe);
   state.const_bufs = const_bufs;
-  codegen::Optimize(&state, stage.passes(), options);
+  codegen::OptimizeCached(&state, target + "@" + cfg_version, stage.passes(), options);
   targets::cpu::Config config;
   if (!env::Get("PLAIDML_CPU_PROFILE").empty()) {
     config.profile_block_execution = true;
@@ -77,7 +83,14 @@ boost::future<void> CpuProgram::Run(  //
   // map in the input buffers, preserving contents
   for (auto& kvp : inputs) {
     IVLOG(2, "Input: " << kvp.first);
-    auto view = kvp.second->MapCurrent(ctx).get();
+    // CPU-device buffers are plain host memory, so the synchronous fast
+    // path skips the per-buffer future/condition-variable round trip that
+    // dominated small-model latency; anything else falls back to the full
+    // machinery.
+    auto view = kvp.second->MapCurrentSync(ctx);
+    if (!view) {
+      view = kvp.second->MapCurrent(ctx).get();
+    }
     buffers.emplace(kvp.first, view->data());
   }
   // map in output buffers, discarding contents
@@ -5,6 +5,8 @@
 #include <memory>
 
 #include "tile/base/hal.h"
+#include "tile/platform/local_machine/const_pool.h"
+#include "tile/platform/local_machine/submit_queue.h"
 
 namespace vertexai {
 namespace tile {
@@ -15,6 +17,11 @@ struct DevInfo {
   const std::shared_ptr<hal::DeviceSet> devset;
   const std::shared_ptr<hal::Device> dev;
   const hal::proto::HardwareSettings settings;
+  // Constants resident on this device, shared across its Programs.
+  const std::shared_ptr<ConstPool> const_pool = std::make_shared<ConstPool>();
+  // Orders kernel enqueues across this device's Programs by priority and
+  // fair share; see SubmitQueue.
+  const std::shared_ptr<SubmitQueue> submit_queue = std::make_shared<SubmitQueue>();
 };
 
 }  // namespace local_machine
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "base/util/error.h"
+#include "base/util/factory.h"
 
 namespace vertexai {
 namespace tile {
@@ -715,6 +716,12 @@ FifoScheduler::FifoScheduler(std::size_t alignment, std::uint64_t size_goal,
   }
 }
 
+std::shared_ptr<Scheduler> FifoScheduler::WithSizeGoal(std::uint64_t size_goal) const {
+  auto copy = std::make_shared<FifoScheduler>(*this);
+  copy->size_goal_ = size_goal;
+  return copy;
+}
+
 schedule::Schedule FifoScheduler::BuildSchedule(const tile::proto::Program& program, const lang::KernelList& kl) {
   schedule::Schedule start = ToScheduleSteps(program, kl);
   IVLOG(4, "Scheduling program:\n" << program.code());
@@ -982,6 +989,24 @@ void StepPlan::Apply(Build* b) {
   }
 }
 
+namespace {
+
+class Factory final : public SchedulerFactory {
+ public:
+  std::shared_ptr<Scheduler> MakeScheduler(const SchedulerParams& params) final {
+    return std::make_shared<FifoScheduler>(params.alignment, params.size_goal, params.settings);
+  }
+};
+
+[[gnu::unused]] char reg = []() -> char {
+  FactoryRegistrar<SchedulerFactory>::Instance()->Register(
+      "fifo",  //
+      [](const context::Context& ctx) { return std::make_unique<Factory>(); });
+  return 0;
+}();
+
+}  // namespace
+
 }  // namespace fifo_scheduler
 }  // namespace local_machine
 }  // namespace tile
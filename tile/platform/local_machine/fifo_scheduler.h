@@ -119,6 +119,8 @@ class FifoScheduler final : public Scheduler {
 
   schedule::Schedule BuildSchedule(const tile::proto::Program& program, const lang::KernelList& kl) final;
 
+  std::shared_ptr<Scheduler> WithSizeGoal(std::uint64_t size_goal) const final;
+
   const char* name() const final;
 
  private:
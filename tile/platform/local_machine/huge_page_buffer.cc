@@ -0,0 +1,147 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/platform/local_machine/huge_page_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <ratio>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "base/util/env.h"
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+namespace {
+
+#ifdef __linux__
+
+constexpr std::uint64_t kHugePageSize = 2 * std::mega::num;
+
+bool HugePagesEnabled() { return env::Get("PLAIDML_HUGE_PAGES") != "0"; }
+
+std::uint64_t HugePageThreshold() {
+  auto value = env::Get("PLAIDML_HUGE_PAGE_THRESHOLD");
+  if (value.size()) {
+    auto parsed = std::atoll(value.c_str());
+    if (parsed > 0) {
+      return parsed;
+    }
+  }
+  return kHugePageSize;
+}
+
+class HugePageBuffer final : public tile::Buffer, public std::enable_shared_from_this<HugePageBuffer> {
+  class HugePageView final : public View {
+   public:
+    HugePageView(char* data, std::size_t size) : View(data, size) {}
+    void WriteBack(const context::Context& ctx) final {}
+  };
+
+ public:
+  explicit HugePageBuffer(std::uint64_t size) : size_{size} {
+    if (HugePagesEnabled() && size_ >= HugePageThreshold()) {
+      map_size_ = ((size_ + kHugePageSize - 1) / kHugePageSize) * kHugePageSize;
+#ifdef MAP_HUGETLB
+      // Explicit huge pages come from the reserved pool and never split
+      // under memory pressure, so try them first; the mmap fails cleanly
+      // when no pool is configured.
+      void* data = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<char*>(data);
+        return;
+      }
+      IVLOG(2, "MAP_HUGETLB failed for " << map_size_ << " bytes; falling back to THP");
+#endif  // MAP_HUGETLB
+      // No reserved pool: take an ordinary mapping over-allocated by one
+      // huge page, trim it to huge-page alignment, and ask the kernel to
+      // back it with transparent huge pages.
+      void* raw = mmap(nullptr, map_size_ + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw == MAP_FAILED) {
+        throw std::runtime_error("Unable to allocate CPU device memory");
+      }
+      auto base = reinterpret_cast<std::uintptr_t>(raw);
+      auto aligned = (base + kHugePageSize - 1) & ~(kHugePageSize - 1);
+      if (aligned != base) {
+        munmap(raw, aligned - base);
+      }
+      auto tail = aligned + map_size_;
+      auto end = base + map_size_ + kHugePageSize;
+      if (tail != end) {
+        munmap(reinterpret_cast<void*>(tail), end - tail);
+      }
+      data_ = reinterpret_cast<char*>(aligned);
+#ifdef MADV_HUGEPAGE
+      madvise(data_, map_size_, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+      return;
+    }
+    map_size_ = size_;
+    void* data = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("Unable to allocate CPU device memory");
+    }
+    data_ = static_cast<char*>(data);
+  }
+
+  ~HugePageBuffer() { munmap(data_, map_size_); }
+
+  uint64_t size() const final { return size_; }
+
+  boost::future<std::unique_ptr<View>> MapCurrent(const context::Context& ctx) final {
+    std::unique_ptr<View> view(new HugePageView(data_, size_));
+    return boost::make_ready_future(std::move(view));
+  }
+
+  std::unique_ptr<View> MapCurrentSync(const context::Context& ctx) final {
+    return std::make_unique<HugePageView>(data_, size_);
+  }
+
+  std::unique_ptr<View> MapDiscard(const context::Context& ctx) final {
+    return std::make_unique<HugePageView>(data_, size_);
+  }
+
+  BufferPtr Clone() final {
+    auto copy = std::make_shared<HugePageBuffer>(size_);
+    std::copy(data_, data_ + size_, copy->data_);
+    return copy;
+  }
+
+ private:
+  char* data_ = nullptr;
+  std::uint64_t size_;
+  std::uint64_t map_size_ = 0;
+};
+
+#endif  // __linux__
+
+}  // namespace
+
+tile::BufferPtr MakeHugePageBuffer(std::uint64_t size) {
+#ifdef __linux__
+  return std::make_shared<HugePageBuffer>(size);
+#else
+  return std::make_shared<SimpleBuffer>(size);
+#endif
+}
+
+void AdviseHugePages(void* base, std::uint64_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (HugePagesEnabled() && size >= HugePageThreshold()) {
+    madvise(base, size, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
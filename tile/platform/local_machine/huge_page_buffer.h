@@ -0,0 +1,31 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <cstdint>
+
+#include "tile/base/buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// Allocates a host buffer for the CPU (JIT) device, backing allocations at
+// or above the huge-page threshold (default one 2 MiB page, override with
+// PLAIDML_HUGE_PAGE_THRESHOLD) with huge pages to cut dTLB misses on large
+// weight tensors: explicit MAP_HUGETLB pages when the system has a reserved
+// pool, otherwise a huge-page-aligned mapping advised MADV_HUGEPAGE so
+// transparent huge pages can back it.  Set PLAIDML_HUGE_PAGES=0 to disable.
+// All buffers are page-aligned, so JIT'd kernels may assume at least
+// 64-byte-aligned bases.  On platforms without huge-page support the result
+// is an ordinary host buffer.
+tile::BufferPtr MakeHugePageBuffer(std::uint64_t size);
+
+// Advises the kernel to back an existing mapping with transparent huge
+// pages, applying the same enable/threshold policy as MakeHugePageBuffer.
+// A no-op on platforms without THP.
+void AdviseHugePages(void* base, std::uint64_t size);
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -4,24 +4,97 @@
 
 #include <utility>
 
+#include "base/util/perf_counter.h"
+
 namespace vertexai {
 namespace tile {
 namespace local_machine {
 
+static PerfCounter cache_hits("mem_cache_hits");
+static PerfCounter cache_misses("mem_cache_misses");
+// Bytes currently pinned by the freelists; a gauge, not a monotonic
+// count.  Serving processes watch this to decide when recycling has
+// turned into fragmentation worth flushing.
+static PerfCounter cache_bytes("mem_cache_bytes");
+static PerfCounter cache_flushes("mem_cache_flushes");
+
+namespace {
+
+class SpinGuard {
+ public:
+  explicit SpinGuard(std::atomic_flag* lock) : lock_{lock} {
+    while (lock_->test_and_set(std::memory_order_acquire)) {
+    }
+  }
+  ~SpinGuard() { lock_->clear(std::memory_order_release); }
+
+  SpinGuard(const SpinGuard&) = delete;
+  SpinGuard& operator=(const SpinGuard&) = delete;
+
+ private:
+  std::atomic_flag* lock_;
+};
+
+}  // namespace
+
+std::size_t MemCache::SizeClass(std::size_t size) {
+  if (size <= (1ull << kMinClassBits)) {
+    return 0;
+  }
+  std::size_t msb = 63 - __builtin_clzll(size);
+  // Quarter-steps between powers of two, rounding up; a step of four
+  // lands on the same class as the next power of two's step zero.
+  std::size_t quarter = 1ull << (msb - 2);
+  std::size_t step = (size - (1ull << msb) + quarter - 1) / quarter;
+  return (msb - kMinClassBits) * 4 + step;
+}
+
+std::size_t MemCache::ClassSize(std::size_t cls) {
+  std::size_t msb = kMinClassBits + cls / 4;
+  return (1ull << msb) + (cls % 4) * (1ull << (msb - 2));
+}
+
+std::size_t MemCache::AllocSize(std::size_t size) { return ClassSize(SizeClass(size)); }
+
 std::shared_ptr<hal::Buffer> MemCache::TryAlloc(std::size_t size) {
-  std::lock_guard<std::mutex> lock{mu_};
-  auto& l = mem_[size];
-  if (l.size()) {
-    std::shared_ptr<hal::Buffer> result{std::move(l.top())};
-    l.pop();
-    return result;
+  auto& cls = classes_[SizeClass(size)];
+  SpinGuard guard{&cls.lock};
+  if (cls.free.empty()) {
+    cache_misses.inc();
+    return std::shared_ptr<hal::Buffer>{};
   }
-  return std::shared_ptr<hal::Buffer>{};
+  std::shared_ptr<hal::Buffer> result{std::move(cls.free.back())};
+  cls.free.pop_back();
+  cache_hits.inc();
+  cache_bytes.add(-static_cast<int64_t>(AllocSize(size)));
+  return result;
 }
 
 void MemCache::Free(std::size_t size, std::shared_ptr<hal::Buffer> mem) {
-  std::lock_guard<std::mutex> lock{mu_};
-  mem_[size].push(std::move(mem));
+  auto& cls = classes_[SizeClass(size)];
+  SpinGuard guard{&cls.lock};
+  cls.free.push_back(std::move(mem));
+  cache_bytes.add(AllocSize(size));
+}
+
+std::size_t MemCache::Flush() {
+  std::size_t released = 0;
+  for (std::size_t idx = 0; idx < kNumClasses; idx++) {
+    auto& cls = classes_[idx];
+    // Drop the buffers outside the spinlock: releasing a HAL buffer may
+    // call back into the driver, which is too long to spin under.
+    std::vector<std::shared_ptr<hal::Buffer>> drained;
+    {
+      SpinGuard guard{&cls.lock};
+      drained.swap(cls.free);
+    }
+    released += drained.size() * ClassSize(idx);
+  }
+  if (released) {
+    cache_bytes.add(-static_cast<int64_t>(released));
+    cache_flushes.inc();
+  }
+  return released;
 }
 
 }  // namespace local_machine
@@ -2,11 +2,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
-#include <mutex>
-#include <stack>
-#include <unordered_map>
+#include <vector>
 
 #include "tile/base/hal.h"
 
@@ -15,14 +15,53 @@ namespace tile {
 namespace local_machine {
 
 // Caches device memory allocations.
+//
+// Requests are segregated into size classes (quarter-steps between
+// powers of two, so rounding waste stays under 25%), and each class
+// keeps its own freelist behind its own spinlock.  Concurrent
+// Program::Run invocations recycling buffers of different sizes touch
+// different classes and proceed without serializing on a global lock;
+// the per-class critical sections are a couple of instructions.
+//
+// The freelists pin their allocations on the device indefinitely, so a
+// long-running process whose workload mix shifts can fail a large
+// allocation while plenty of memory sits cached in other classes.
+// Flush() releases everything cached back to the device; the
+// "mem_cache_bytes" perf counter reports how much is currently pinned
+// so callers can decide when that's worthwhile.
 class MemCache {
  public:
+  // The number of bytes to actually allocate for a request of the
+  // given size: the containing size class's size.  Allocating at class
+  // granularity is what makes freed buffers reusable for any request
+  // mapping to the same class.
+  static std::size_t AllocSize(std::size_t size);
+
   std::shared_ptr<hal::Buffer> TryAlloc(std::size_t size);
   void Free(std::size_t size, std::shared_ptr<hal::Buffer>);
 
+  // Releases every cached buffer back to the device, returning the
+  // number of bytes released.  Cached buffers are by definition not in
+  // use, so this is safe at any time; live chunks keep their own
+  // references.
+  std::size_t Flush();
+
  private:
-  std::mutex mu_;
-  std::unordered_map<std::size_t, std::stack<std::shared_ptr<hal::Buffer>>> mem_;
+  static std::size_t SizeClass(std::size_t size);
+  static std::size_t ClassSize(std::size_t cls);
+
+  // Four classes per power of two, starting at 256 bytes; 64-bit sizes
+  // need at most (63 - 8) * 4 + 4 + 1 classes.
+  static constexpr std::size_t kMinClassBits = 8;
+  static constexpr std::size_t kNumClasses = 226;
+
+  // Padded to a cache line so classes don't false-share.
+  struct alignas(64) Class {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::vector<std::shared_ptr<hal::Buffer>> free;
+  };
+
+  std::array<Class, kNumClasses> classes_;
 };
 
 }  // namespace local_machine
@@ -8,25 +8,43 @@ namespace vertexai {
 namespace tile {
 namespace local_machine {
 
-void MemDeps::GetReadDependencies(std::vector<std::shared_ptr<hal::Event>>* deps) {
+namespace {
+
+// Computes the exclusive end of [offset, offset+size), saturating instead of wrapping.
+std::uint64_t RangeEnd(std::uint64_t offset, std::uint64_t size) {
+  if (size > MemDeps::kWholeChunk - offset) {
+    return MemDeps::kWholeChunk;
+  }
+  return offset + size;
+}
+
+}  // namespace
+
+constexpr std::uint64_t MemDeps::kWholeChunk;
+
+void MemDeps::GetReadDependencies(std::vector<std::shared_ptr<hal::Event>>* deps, std::uint64_t offset,
+                                  std::uint64_t size) {
+  std::uint64_t end = RangeEnd(offset, size);
   std::lock_guard<std::mutex> lock{mu_};
   if (ep_) {
     std::rethrow_exception(ep_);
   }
   deps->reserve(deps->size() + events_.size());
-  for (const auto& evt : events_) {
-    deps->emplace_back(evt);
+  for (const auto& dep : events_) {
+    if (dep.begin < end && offset < dep.end) {
+      deps->emplace_back(dep.event);
+    }
   }
 }
 
-void MemDeps::AddReadDependency(std::shared_ptr<hal::Event> event) {
+void MemDeps::AddReadDependency(std::shared_ptr<hal::Event> event, std::uint64_t offset, std::uint64_t size) {
   boost::shared_future<std::shared_ptr<hal::Result>> fut;
-  std::list<std::shared_ptr<hal::Event>>::iterator it;
+  std::list<Dep>::iterator it;
   {
     std::lock_guard<std::mutex> lock{mu_};
     ep_ = std::exception_ptr{};
     fut = event->GetFuture();
-    it = events_.emplace(events_.end(), std::move(event));
+    it = events_.emplace(events_.end(), Dep{std::move(event), offset, RangeEnd(offset, size)});
   }
   fut.then([self = shared_from_this(), it](boost::shared_future<std::shared_ptr<hal::Result>> future) {
     future.get();
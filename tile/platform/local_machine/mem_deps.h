@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <exception>
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "tile/base/hal.h"
@@ -16,23 +19,44 @@ namespace local_machine {
 
 // Records the liveness of a particular chunk of memory -- the set of events that need to reach a final state in
 // order to know whether the memory's contents to be valid, and whether the memory's contents are valid at all.
+//
+// Dependencies are recorded per byte range, so accesses to disjoint ranges of a chunk (e.g. partial copies) don't
+// serialize against each other; the unranged entrypoints cover the whole chunk.
 class MemDeps final : public std::enable_shared_from_this<MemDeps> {
  public:
+  // Covers every byte of the chunk, regardless of its size.
+  static constexpr std::uint64_t kWholeChunk = std::numeric_limits<std::uint64_t>::max();
+
   // Get the current read dependencies, adding them to the supplied vector.  This will raise an exception if the
   // MemDeps has been poisoned.
-  void GetReadDependencies(std::vector<std::shared_ptr<hal::Event>>* deps);
+  void GetReadDependencies(std::vector<std::shared_ptr<hal::Event>>* deps) {
+    GetReadDependencies(deps, 0, kWholeChunk);
+  }
+
+  // As above, but only gathers dependencies whose recorded ranges overlap [offset, offset+size).
+  void GetReadDependencies(std::vector<std::shared_ptr<hal::Event>>* deps, std::uint64_t offset, std::uint64_t size);
 
   // Adds to this memory chunk's read dependency, blocking read operations from taking place until the supplied event
   // has reached a final state.  This also clears the poison state of the MemDeps.
-  void AddReadDependency(std::shared_ptr<hal::Event> event);
+  void AddReadDependency(std::shared_ptr<hal::Event> event) { AddReadDependency(std::move(event), 0, kWholeChunk); }
+
+  // As above, but records the event as covering only [offset, offset+size); reads of disjoint ranges won't wait
+  // on it.
+  void AddReadDependency(std::shared_ptr<hal::Event> event, std::uint64_t offset, std::uint64_t size);
 
   // Poisons the memory chunk, if not already poisoned.  This causes the indicated exception to be thrown from
   // subsequent calls to Capture.
   void Poison(std::exception_ptr ep) noexcept;
 
  private:
+  struct Dep {
+    std::shared_ptr<hal::Event> event;
+    std::uint64_t begin;
+    std::uint64_t end;
+  };
+
   std::mutex mu_;
-  std::list<std::shared_ptr<hal::Event>> events_;
+  std::list<Dep> events_;
   std::exception_ptr ep_;
 };
 
@@ -0,0 +1,155 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/platform/local_machine/multi_program.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "base/util/error.h"
+#include "tile/platform/local_machine/buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+namespace {
+
+void CopyBytes(const context::Context& ctx, tile::Buffer* src, uint64_t src_off, tile::Buffer* dst, uint64_t dst_off,
+               uint64_t bytes, bool discard_dst) {
+  auto src_view = src->MapCurrent(ctx).get();
+  auto dst_view = discard_dst ? dst->MapDiscard(ctx) : dst->MapCurrent(ctx).get();
+  std::memcpy(dst_view->data() + dst_off, src_view->data() + src_off, bytes);
+  dst_view->WriteBack(ctx);
+}
+
+}  // namespace
+
+bool MultiProgram::IsBatchMajor(const TensorShape& shape, uint64_t batch) {
+  if (batch < 2 || shape.dims.empty()) {
+    return false;
+  }
+  const auto& outer = shape.dims[0];
+  if (outer.size != batch || outer.stride <= 0) {
+    return false;
+  }
+  for (size_t i = 1; i < shape.dims.size(); i++) {
+    if (std::abs(shape.dims[i].stride) > outer.stride) {
+      return false;
+    }
+  }
+  return true;
+}
+
+MultiProgram::MultiProgram(const tile::proto::Program& program, uint64_t batch, std::vector<Shard> shards)
+    : batch_{batch}, shards_{std::move(shards)}, replicas_(shards_.size()) {
+  for (const auto& kvp : program.inputs()) {
+    BufferSpec spec;
+    spec.shape = FromProto(kvp.second.shape());
+    spec.split = IsBatchMajor(spec.shape, batch_);
+    if (spec.split) {
+      spec.row_bytes = spec.shape.dims[0].stride * byte_width(spec.shape.type);
+    }
+    inputs_.emplace(kvp.first, std::move(spec));
+  }
+  for (const auto& kvp : program.outputs()) {
+    BufferSpec spec;
+    spec.shape = FromProto(kvp.second.shape());
+    spec.split = IsBatchMajor(spec.shape, batch_);
+    if (spec.split) {
+      spec.row_bytes = spec.shape.dims[0].stride * byte_width(spec.shape.type);
+    }
+    outputs_.emplace(kvp.first, std::move(spec));
+  }
+}
+
+std::shared_ptr<tile::Buffer> MultiProgram::MakeShardBuffer(const Shard& shard, uint64_t size) {
+  return std::make_shared<Buffer>(shard.program->devinfo(), shard.program->output_mem_strategy(), size);
+}
+
+std::shared_ptr<tile::Buffer> MultiProgram::GetReplica(const context::Context& ctx, size_t shard_idx,
+                                                       const std::string& name,
+                                                       const std::shared_ptr<tile::Buffer>& src) {
+  std::lock_guard<std::mutex> lock{mu_};
+  auto& entry = replicas_[shard_idx][name];
+  if (entry.first != src.get() || !entry.second) {
+    auto replica = MakeShardBuffer(shards_[shard_idx], src->size());
+    CopyBytes(ctx, src.get(), 0, replica.get(), 0, src->size(), true);
+    entry = std::make_pair(src.get(), std::move(replica));
+  }
+  return entry.second;
+}
+
+boost::future<void> MultiProgram::Run(  //
+    const context::Context& ctx,        //
+    std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
+    std::map<std::string, std::shared_ptr<tile::Buffer>> outputs) {
+  struct OutputCopy {
+    std::shared_ptr<tile::Buffer> shard_buf;
+    std::shared_ptr<tile::Buffer> full_buf;
+    uint64_t offset;
+    uint64_t bytes;
+  };
+  auto copies = std::make_shared<std::vector<OutputCopy>>();
+  std::vector<boost::future<void>> runs;
+  for (size_t i = 0; i < shards_.size(); i++) {
+    const auto& shard = shards_[i];
+    std::map<std::string, std::shared_ptr<tile::Buffer>> shard_inputs;
+    for (const auto& kvp : inputs) {
+      const auto& spec = inputs_.at(kvp.first);
+      if (spec.split) {
+        auto buf = MakeShardBuffer(shard, spec.row_bytes * shard.count);
+        CopyBytes(ctx, kvp.second.get(), shard.begin * spec.row_bytes, buf.get(), 0, spec.row_bytes * shard.count,
+                  true);
+        shard_inputs.emplace(kvp.first, std::move(buf));
+      } else {
+        shard_inputs.emplace(kvp.first, GetReplica(ctx, i, kvp.first, kvp.second));
+      }
+    }
+    std::map<std::string, std::shared_ptr<tile::Buffer>> shard_outputs;
+    for (const auto& kvp : outputs) {
+      const auto& spec = outputs_.at(kvp.first);
+      if (spec.split) {
+        auto buf = MakeShardBuffer(shard, spec.row_bytes * shard.count);
+        copies->push_back(OutputCopy{buf, kvp.second, shard.begin * spec.row_bytes, spec.row_bytes * shard.count});
+        shard_outputs.emplace(kvp.first, std::move(buf));
+      } else {
+        // Every shard computes an unsharded output; keep shard zero's copy.
+        auto buf = MakeShardBuffer(shard, spec.shape.byte_size());
+        if (i == 0) {
+          copies->push_back(OutputCopy{buf, kvp.second, 0, spec.shape.byte_size()});
+        }
+        shard_outputs.emplace(kvp.first, std::move(buf));
+      }
+    }
+    runs.push_back(shard.program->Run(ctx, std::move(shard_inputs), std::move(shard_outputs)));
+  }
+  return boost::when_all(runs.begin(), runs.end())
+      .then([ctx, copies](boost::future<std::vector<boost::future<void>>> results) {
+        for (auto& result : results.get()) {
+          result.get();
+        }
+        for (const auto& copy : *copies) {
+          CopyBytes(ctx, copy.shard_buf.get(), 0, copy.full_buf.get(), copy.offset, copy.bytes, false);
+        }
+      });
+}
+
+std::size_t MultiProgram::MaxAvailableMemory() {
+  std::size_t result = std::numeric_limits<std::size_t>::max();
+  for (const auto& shard : shards_) {
+    result = std::min(result, shard.program->MaxAvailableMemory());
+  }
+  return result;
+}
+
+void MultiProgram::Release() {
+  for (const auto& shard : shards_) {
+    shard.program->Release();
+  }
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
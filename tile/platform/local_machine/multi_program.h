@@ -0,0 +1,81 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tile/base/program.h"
+#include "tile/platform/local_machine/program.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// MultiProgram executes a program data-parallel across several devices.  It
+// holds one per-device Program compiled for a slice of the batch (outermost)
+// dimension; each Run splits the batch-major inputs across the shards,
+// dispatches the shard runs concurrently through each device's own
+// scheduler, and reassembles the sharded outputs.
+//
+// An input or output is considered batch-major when its outermost dimension
+// equals the program's batch size and is its highest-stride, contiguous
+// dimension.  Other inputs (weights) are replicated to each device; the
+// device-resident replica is reused across runs as long as the caller passes
+// the same buffer object, so steady-state inference only transfers the
+// sharded activations.
+class MultiProgram final : public tile::Program {
+ public:
+  struct Shard {
+    // Qualified: inside the class, the injected-class-name makes a bare
+    // Program mean the tile::Program base rather than the local-machine one.
+    std::shared_ptr<local_machine::Program> program;
+    uint64_t begin = 0;  // First batch row handled by this shard
+    uint64_t count = 0;  // Number of batch rows handled by this shard
+  };
+
+  MultiProgram(const tile::proto::Program& program, uint64_t batch, std::vector<Shard> shards);
+
+  // True iff the shape's outermost dimension covers the batch and is the
+  // contiguous, highest-stride dimension, so a batch slice is a contiguous
+  // byte range.
+  static bool IsBatchMajor(const TensorShape& shape, uint64_t batch);
+
+  boost::future<void> Run(          //
+      const context::Context& ctx,  //
+      std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
+      std::map<std::string, std::shared_ptr<tile::Buffer>> outputs) final;
+
+  std::size_t MaxAvailableMemory() final;
+
+  void Release() final;
+
+ private:
+  struct BufferSpec {
+    TensorShape shape;
+    bool split = false;      // Shard across the batch dimension?
+    uint64_t row_bytes = 0;  // Bytes per batch row when split
+  };
+
+  std::shared_ptr<tile::Buffer> MakeShardBuffer(const Shard& shard, uint64_t size);
+  std::shared_ptr<tile::Buffer> GetReplica(const context::Context& ctx, size_t shard_idx, const std::string& name,
+                                           const std::shared_ptr<tile::Buffer>& src);
+
+  uint64_t batch_;
+  std::vector<Shard> shards_;
+  std::map<std::string, BufferSpec> inputs_;
+  std::map<std::string, BufferSpec> outputs_;
+
+  std::mutex mu_;
+  // Per-shard device-resident copies of replicated (unsharded) inputs,
+  // keyed by argument name and tagged with the source buffer they mirror.
+  std::vector<std::map<std::string, std::pair<tile::Buffer*, std::shared_ptr<tile::Buffer>>>> replicas_;
+};
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,115 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#include "tile/platform/local_machine/numa_buffer.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "base/util/logging.h"
+#include "tile/platform/local_machine/huge_page_buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+namespace {
+
+#ifdef __linux__
+
+// Zeroes the buffer a page at a time from several threads, round-robin by
+// page index, so consecutive pages are faulted in by different threads and
+// first-touch placement spreads them across the nodes those threads run on.
+void FirstTouchInterleaved(char* base, std::size_t size) {
+  std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t npages = (size + page - 1) / page;
+  std::size_t nthreads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), npages);
+  if (nthreads < 2) {
+    std::fill(base, base + size, '\0');
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < nthreads; t++) {
+    threads.emplace_back([=]() {
+      for (std::size_t p = t; p < npages; p += nthreads) {
+        char* lo = base + p * page;
+        char* hi = std::min(lo + page, base + size);
+        std::fill(lo, hi, '\0');
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+class NumaBuffer final : public tile::Buffer, public std::enable_shared_from_this<NumaBuffer> {
+  class NumaView final : public View {
+   public:
+    NumaView(char* data, std::size_t size) : View(data, size) {}
+    void WriteBack(const context::Context& ctx) final {}
+  };
+
+ public:
+  explicit NumaBuffer(std::uint64_t size) : size_{size} {
+    void* data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("Unable to allocate CPU device memory");
+    }
+    data_ = static_cast<char*>(data);
+    // With THP the interleave granularity becomes one huge page per node,
+    // which is still fine spreading for the large tensors this targets.
+    AdviseHugePages(data_, size_);
+    FirstTouchInterleaved(data_, size_);
+  }
+
+  ~NumaBuffer() { munmap(data_, size_); }
+
+  uint64_t size() const final { return size_; }
+
+  boost::future<std::unique_ptr<View>> MapCurrent(const context::Context& ctx) final {
+    std::unique_ptr<View> view(new NumaView(data_, size_));
+    return boost::make_ready_future(std::move(view));
+  }
+
+  std::unique_ptr<View> MapCurrentSync(const context::Context& ctx) final {
+    return std::make_unique<NumaView>(data_, size_);
+  }
+
+  std::unique_ptr<View> MapDiscard(const context::Context& ctx) final {
+    return std::make_unique<NumaView>(data_, size_);
+  }
+
+  BufferPtr Clone() final {
+    auto copy = std::make_shared<NumaBuffer>(size_);
+    std::copy(data_, data_ + size_, copy->data_);
+    return copy;
+  }
+
+ private:
+  char* data_ = nullptr;
+  std::uint64_t size_;
+};
+
+#endif  // __linux__
+
+}  // namespace
+
+tile::BufferPtr MakeNumaInterleavedBuffer(std::uint64_t size) {
+#ifdef __linux__
+  return std::make_shared<NumaBuffer>(size);
+#else
+  return std::make_shared<SimpleBuffer>(size);
+#endif
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
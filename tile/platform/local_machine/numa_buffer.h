@@ -0,0 +1,23 @@
+// Copyright 2017-2018 Intel Corporation.
+
+#pragma once
+
+#include <cstdint>
+
+#include "tile/base/buffer.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// Allocates a host buffer for the CPU (JIT) device whose pages are
+// first-touched in parallel from a spread of worker threads.  Under the
+// kernel's default first-touch placement policy this interleaves the pages
+// across the NUMA nodes where the JIT's worker pool runs, instead of landing
+// the whole buffer on the allocating thread's node.  On platforms without
+// page-granularity placement the result is an ordinary host buffer.
+tile::BufferPtr MakeNumaInterleavedBuffer(std::uint64_t size);
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
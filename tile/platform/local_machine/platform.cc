@@ -2,19 +2,24 @@
 
 #include "tile/platform/local_machine/platform.h"
 
+#include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include <boost/process/environment.hpp>
 
 #include "base/util/compat.h"
+#include "base/util/env.h"
 #include "base/util/error.h"
 #include "base/util/factory.h"
 #include "base/util/logging.h"
 #include "base/util/type_url.h"
+#include "tile/base/artifact_cache.h"
 #include "tile/hal/util/selector.h"
 #include "tile/hal/util/settings.h"
 #include "tile/lang/parser.h"
@@ -23,7 +28,10 @@
 #include "tile/platform/local_machine/cpu_program.h"
 #include "tile/platform/local_machine/direct_mem_strategy.h"
 #include "tile/platform/local_machine/fifo_scheduler.h"
+#include "tile/platform/local_machine/huge_page_buffer.h"
 #include "tile/platform/local_machine/loose_scheduler.h"
+#include "tile/platform/local_machine/multi_program.h"
+#include "tile/platform/local_machine/numa_buffer.h"
 #include "tile/platform/local_machine/program.h"
 #include "tile/platform/local_machine/tdep_scheduler.h"
 #include "tile/platform/local_machine/tmp_mem_strategy.h"
@@ -70,82 +78,209 @@ bool MatchConfig(const proto::Platform& config, const hal::proto::HardwareInfo&
   return false;
 }
 
+std::string AutoprobeCacheDir() {
+  auto dir = env::Get("PLAIDML_AUTOPROBE_CACHE");
+  if (dir.size()) {
+    return dir;
+  }
+  auto home = env::Get("HOME");
+  if (home.empty()) {
+    home = env::Get("USERPROFILE");
+  }
+  if (home.empty()) {
+    return std::string();
+  }
+  return home + "/.plaidml/autoprobe";
+}
+
+std::uint64_t FloorPow2(std::uint64_t value) {
+  std::uint64_t result = 1;
+  while (result * 2 <= value) {
+    result *= 2;
+  }
+  return result;
+}
+
+// When no hardware_config matches a GPU, PLAIDML_AUTOPROBE (on by default;
+// set it to 0 to disable) probes a configuration from the shape the HAL
+// reported -- workgroup limits, local memory size, cacheline width -- so new
+// hardware runs with reasonable settings instead of being shelved as
+// experimental.  The result is validated and cached per device id under
+// PLAIDML_AUTOPROBE_CACHE (default ~/.plaidml/autoprobe), so later processes
+// skip the probe.
+bool AutoprobeConfig(const std::string& id, const hal::proto::HardwareInfo& info,
+                     hal::proto::HardwareSettings* settings) {
+  if (env::Get("PLAIDML_AUTOPROBE") == "0") {
+    return false;
+  }
+  if (info.type() != hal::proto::HardwareType::GPU) {
+    return false;
+  }
+  static ArtifactCache cache{AutoprobeCacheDir()};
+  std::string cached;
+  if (cache.TryGet(id, &cached)) {
+    hal::proto::HardwareSettings probed;
+    if (google::protobuf::TextFormat::ParseFromString(cached, &probed)) {
+      *settings = probed;
+      return true;
+    }
+  }
+  // Start from whatever the HAL filled in and bring the launch-related knobs
+  // into the ranges the optimizer expects: a power-of-two workgroup size no
+  // wider than the device allows, and nonzero goals for the tile planner.
+  hal::proto::HardwareSettings probed = *settings;
+  std::uint64_t max_threads = probed.dim_sizes_size() ? probed.dim_sizes(0) : 256;
+  probed.set_threads(FloorPow2(std::max<std::uint64_t>(1, std::min<std::uint64_t>(max_threads, 256))));
+  if (!probed.vec_size()) {
+    probed.set_vec_size(1);
+  }
+  if (probed.mem_width() < 8 || (probed.mem_width() & (probed.mem_width() - 1))) {
+    probed.set_mem_width(64);
+  }
+  if (probed.max_mem() < 1024) {
+    probed.set_max_mem(16384);
+  }
+  if (!probed.goal_groups()) {
+    probed.set_goal_groups(16);
+  }
+  if (!probed.goal_flops_per_byte()) {
+    probed.set_goal_flops_per_byte(50);
+  }
+  try {
+    hal::settings::Validate(probed);
+  } catch (const std::exception& ex) {
+    VLOG(1) << "Autoprobe produced invalid settings for " << id << ": " << ex.what();
+    return false;
+  }
+  std::string text;
+  google::protobuf::TextFormat::PrintToString(probed, &text);
+  cache.Put(id, text);
+  VLOG(1) << "Autoprobed settings for unconfigured device " << id;
+  *settings = probed;
+  return true;
+}
+
 }  // namespace
 
 Platform::Platform() {
-  context::Context ctx;
   auto env = boost::this_process::environment();
   if (env.count("PLAIDML_DEBUG")) {
     LOG(INFO) << "Press any key after attaching a debugger to pid: " << boost::this_process::get_id();
     std::getchar();
   }
+  if (env.count("PLAIDML_CPU_NUMA_POLICY") && env.at("PLAIDML_CPU_NUMA_POLICY").to_string() == "interleave") {
+    cpu_numa_policy_ = proto::Platform::INTERLEAVE;
+  }
+
+  // Drivers are probed lazily: looking up a pinned device creates drivers in
+  // priority order only until the device appears, and listing devices forces
+  // the full probe.  This keeps a broken ICD behind an unrelated driver from
+  // stalling startup when the configuration pins one device; the CPU device
+  // never probes a driver at all.  PLAIDML_LAZY_HAL=0 restores the eager
+  // probe, and PLAIDML_HAL=<name> restricts probing to one driver.
+  if (env::Get("PLAIDML_LAZY_HAL") == "0") {
+    std::lock_guard<std::mutex> lock{probe_mu_};
+    ProbeAllDrivers();
+  }
+}
 
-  for (auto& item : FactoryRegistrar<hal::Driver>::Instance()->Factories()) {
+bool Platform::ProbeNextDriver() {
+  auto factories = FactoryRegistrar<hal::Driver>::Instance()->Factories();
+  auto filter = env::Get("PLAIDML_HAL");
+  size_t idx = 0;
+  for (auto& item : factories) {
+    if (idx++ < next_factory_) {
+      continue;
+    }
+    next_factory_ = idx;
+    if (!filter.empty() && item.second.name != filter) {
+      VLOG(1) << "Skipping HAL (PLAIDML_HAL): " << item.second.name;
+      continue;
+    }
+    context::Context ctx;
     try {
       VLOG(1) << "Creating HAL: " << item.second.name;
       auto driver = item.second.factory(ctx);
+      InitDriverDevices(ctx, driver.get());
       drivers_.emplace_back(std::move(driver));
     } catch (const std::exception& ex) {
       VLOG(1) << "Failed to initialize HAL: " << ex.what();
+      continue;
     }
+    return true;
   }
+  return false;
+}
 
-  for (const auto& driver : drivers_) {
-    for (const auto& devset : driver->device_sets()) {
-      for (const auto& dev : devset->devices()) {
-        if (dev->executor()) {
-          const hal::proto::HardwareInfo& info = dev->executor()->info();
-          hal::proto::HardwareSettings settings = info.settings();
-
-          // Loop over identical devices and ensure each one gets a unique id
-          int ididx = 0;
-          std::string id;
-          do {
-            std::stringstream ss;
-            ss << info.name() << "." << ididx++;
-            id = ss.str();
-            std::replace(id.begin(), id.end(), ' ', '_');
-            std::transform(id.begin(), id.end(), id.begin(), ::tolower);
-          } while (devs_.find(id) != devs_.end());
-
-          try {
-            dev->Initialize(settings);
-          } catch (const std::exception& e) {
-            VLOG(1) << "Failed to initialize device " << info.name() << ": " << e.what();
-            continue;
-          } catch (...) {
-            VLOG(1) << "Failed to initialize device " << info.name();
-            continue;
-          }
-          auto devinfo = std::make_shared<DevInfo>(DevInfo{devset, dev, settings});
-          PlatformDev pd{id, devinfo};
-          VLOG(2) << settings.DebugString();
-          GetMemStrategy(devinfo, &pd);
+void Platform::ProbeAllDrivers() {
+  while (ProbeNextDriver()) {
+  }
+}
 
-          auto memory = (dev->executor() && dev->executor()->device_memory() ? dev->executor()->device_memory()
-                                                                             : devset->host_memory());
-          if (dev->executor() && dev->executor()->is_synchronous()) {
-            IVLOG(2, "Device is synchronous");
-          }
-          auto size_goal = memory->size_goal() * kGoalMemPercentage;
-          IVLOG(2, "Using fifo scheduler; size_goal=" << size_goal);
-          pd.scheduler = std::make_shared<fifo_scheduler::FifoScheduler>(memory->ArenaBufferAlignment(),
-                                                                         std::lround(std::floor(size_goal)), settings);
-          devs_[id] = std::move(pd);
+void Platform::InitDriverDevices(const context::Context& ctx, hal::Driver* driver) {
+  for (const auto& devset : driver->device_sets()) {
+    for (const auto& dev : devset->devices()) {
+      if (dev->executor()) {
+        const hal::proto::HardwareInfo& info = dev->executor()->info();
+        hal::proto::HardwareSettings settings = info.settings();
+
+        // Loop over identical devices and ensure each one gets a unique id
+        int ididx = 0;
+        std::string id;
+        do {
+          std::stringstream ss;
+          ss << info.name() << "." << ididx++;
+          id = ss.str();
+          std::replace(id.begin(), id.end(), ' ', '_');
+          std::transform(id.begin(), id.end(), id.begin(), ::tolower);
+        } while (devs_.find(id) != devs_.end());
+
+        try {
+          dev->Initialize(settings);
+        } catch (const std::exception& e) {
+          VLOG(1) << "Failed to initialize device " << info.name() << ": " << e.what();
+          continue;
+        } catch (...) {
+          VLOG(1) << "Failed to initialize device " << info.name();
+          continue;
+        }
+        auto devinfo = std::make_shared<DevInfo>(DevInfo{devset, dev, settings});
+        PlatformDev pd{id, devinfo};
+        VLOG(2) << settings.DebugString();
+        GetMemStrategy(devinfo, &pd);
+
+        auto memory = (dev->executor() && dev->executor()->device_memory() ? dev->executor()->device_memory()
+                                                                           : devset->host_memory());
+        if (dev->executor() && dev->executor()->is_synchronous()) {
+          IVLOG(2, "Device is synchronous");
         }
+        auto size_goal = memory->size_goal() * kGoalMemPercentage;
+        SchedulerParams sched_params{memory->ArenaBufferAlignment(),
+                                     static_cast<std::uint64_t>(std::lround(std::floor(size_goal))), settings};
+        pd.scheduler = MakeRegisteredScheduler(context::Context{}, env::Get("PLAIDML_SCHEDULER"), sched_params);
+        IVLOG(2, "Using " << pd.scheduler->name() << " scheduler; size_goal=" << size_goal);
+        devs_[id] = std::move(pd);
       }
     }
   }
 }
 
-Platform::Platform(const context::Context& ctx, const proto::Platform& config) {
+Platform::Platform(const context::Context& ctx, const proto::Platform& config) : cpu_numa_policy_{config.cpu_numa_policy()} {
   auto env = boost::this_process::environment();
   if (env.count("PLAIDML_DEBUG")) {
     LOG(INFO) << "Press any key after attaching a debugger to pid: " << boost::this_process::get_id();
     std::getchar();
   }
+  if (env.count("PLAIDML_CPU_NUMA_POLICY") && env.at("PLAIDML_CPU_NUMA_POLICY").to_string() == "interleave") {
+    cpu_numa_policy_ = proto::Platform::INTERLEAVE;
+  }
 
-  for (auto& item : FactoryRegistrar<hal::Driver>::Instance()->Factories()) {
+  // The config-driven path probes eagerly: it needs every device's hardware
+  // info to match against the config's selectors.  Mark every factory
+  // consumed so the lazy probe never re-creates a driver.
+  auto factories = FactoryRegistrar<hal::Driver>::Instance()->Factories();
+  next_factory_ = factories.size();
+  for (auto& item : factories) {
     try {
       VLOG(1) << "Creating HAL: " << item.second.name;
       auto driver = item.second.factory(ctx);
@@ -175,6 +310,9 @@ Platform::Platform(const context::Context& ctx, const proto::Platform& config) {
           } while (devs_.find(id) != devs_.end());
 
           bool found_hardware_config = MatchConfig(config, info, &settings);
+          if (!found_hardware_config) {
+            found_hardware_config = AutoprobeConfig(id, info, &settings);
+          }
           try {
             dev->Initialize(settings);
           } catch (const std::exception& e) {
@@ -199,9 +337,10 @@ Platform::Platform(const context::Context& ctx, const proto::Platform& config) {
             IVLOG(2, "Device is synchronous");
           }
           auto size_goal = memory->size_goal() * kGoalMemPercentage;
-          IVLOG(2, "Using fifo scheduler; size_goal=" << size_goal);
-          pd.scheduler = std::make_shared<fifo_scheduler::FifoScheduler>(memory->ArenaBufferAlignment(),
-                                                                         std::lround(std::floor(size_goal)), settings);
+          SchedulerParams sched_params{memory->ArenaBufferAlignment(),
+                                       static_cast<std::uint64_t>(std::lround(std::floor(size_goal))), settings};
+          pd.scheduler = MakeRegisteredScheduler(ctx, env::Get("PLAIDML_SCHEDULER"), sched_params);
+          IVLOG(2, "Using " << pd.scheduler->name() << " scheduler; size_goal=" << size_goal);
           devs_[id] = std::move(pd);
         }
       }
@@ -214,12 +353,28 @@ void Platform::RegisterCostModel(const lang::TileCostFunction& cost_fn) { tile_o
 std::shared_ptr<tile::Buffer> Platform::MakeBuffer(const context::Context& ctx, const std::string& device_id,
                                                    std::uint64_t size) {
   if (device_id == kCpuDevice) {
-    return std::make_shared<SimpleBuffer>(size);
+    if (cpu_numa_policy_ == proto::Platform::INTERLEAVE) {
+      return MakeNumaInterleavedBuffer(size);
+    }
+    return MakeHugePageBuffer(size);
   }
   auto& platform_dev = LookupDevice(device_id);
   return std::make_shared<Buffer>(platform_dev.devinfo, platform_dev.mem_strategy, size);
 }
 
+std::shared_ptr<tile::Buffer> Platform::MakeHostBuffer(const context::Context& ctx, const std::string& device_id,
+                                                       void* data, std::uint64_t size) {
+  if (device_id == kCpuDevice) {
+    // The JIT reads and writes caller memory in place; no staging copy.
+    return std::make_shared<AdoptedBuffer>(data, size);
+  }
+  // Accelerator devices go through per-device memory strategies that own
+  // their allocations; mapping caller memory in place would need host-ptr
+  // support plumbed through the HAL.
+  throw std::runtime_error(
+      std::string{"Zero-copy host buffer binding is not supported for device: "} + device_id);
+}
+
 std::shared_ptr<tile::Program> Platform::MakeProgram(  //
     const context::Context& ctx,                       //
     const tile::proto::Program& program,               //
@@ -233,6 +388,10 @@ std::shared_ptr<tile::Program> Platform::MakeProgram(  //
     runinfo.program_name = "stripe_program";
     return std::make_shared<CpuProgram>("llvm_cpu", runinfo, const_bufs);
   }
+  auto multi = MakeMultiProgram(ctx, program, const_bufs);
+  if (multi) {
+    return multi;
+  }
   const auto& platform_dev = LookupDevice(program.dev_id());
   auto tmp_strategy = std::make_shared<TmpMemStrategy>(platform_dev.devinfo, platform_dev.tmp_mem_source);
   return std::make_shared<Program>(  //
@@ -247,6 +406,77 @@ std::shared_ptr<tile::Program> Platform::MakeProgram(  //
       const_bufs);
 }
 
+std::shared_ptr<tile::Program> Platform::MakeMultiProgram(  //
+    const context::Context& ctx,                            //
+    const tile::proto::Program& program,                    //
+    ConstBufferManager* const_bufs) {
+  std::vector<std::string> dev_ids;
+  std::istringstream dp_env{env::Get("PLAIDML_DP_DEVICES")};
+  std::string dev_id;
+  while (std::getline(dp_env, dev_id, ',')) {
+    if (!dev_id.empty()) {
+      dev_ids.push_back(dev_id);
+    }
+  }
+  if (dev_ids.size() < 2) {
+    return nullptr;
+  }
+  // The batch size is the outermost dimension shared by all outputs; every
+  // output must be batch-major for the shards' results to be reassembled.
+  uint64_t batch = 0;
+  bool shardable = !program.outputs().empty();
+  for (const auto& kvp : program.outputs()) {
+    auto shape = FromProto(kvp.second.shape());
+    if (!batch && !shape.dims.empty()) {
+      batch = shape.dims[0].size;
+    }
+    if (!MultiProgram::IsBatchMajor(shape, batch)) {
+      shardable = false;
+      break;
+    }
+  }
+  if (!shardable || batch < dev_ids.size()) {
+    LOG(WARNING) << "PLAIDML_DP_DEVICES is set, but the program is not batch-shardable; "
+                 << "running on " << program.dev_id();
+    return nullptr;
+  }
+  std::vector<MultiProgram::Shard> shards;
+  uint64_t begin = 0;
+  for (size_t i = 0; i < dev_ids.size(); i++) {
+    uint64_t count = batch / dev_ids.size() + (i < batch % dev_ids.size() ? 1 : 0);
+    tile::proto::Program shard_proto = program;
+    shard_proto.set_dev_id(dev_ids[i]);
+    for (auto& kvp : *shard_proto.mutable_inputs()) {
+      auto* shape = kvp.second.mutable_shape();
+      if (MultiProgram::IsBatchMajor(FromProto(*shape), batch)) {
+        shape->mutable_dims(0)->set_size(count);
+      }
+    }
+    for (auto& kvp : *shard_proto.mutable_outputs()) {
+      auto* shape = kvp.second.mutable_shape();
+      if (MultiProgram::IsBatchMajor(FromProto(*shape), batch)) {
+        shape->mutable_dims(0)->set_size(count);
+      }
+    }
+    const auto& platform_dev = LookupDevice(dev_ids[i]);
+    auto tmp_strategy = std::make_shared<TmpMemStrategy>(platform_dev.devinfo, platform_dev.tmp_mem_source);
+    auto shard_program = std::make_shared<Program>(  //
+        ctx,                                         //
+        shard_proto,                                 //
+        platform_dev.devinfo,                        //
+        platform_dev.scheduler,                      //
+        platform_dev.mem_strategy,                   //
+        tmp_strategy,                                //
+        platform_dev.tmp_mem_source,                 //
+        tile_optimizer_,                             //
+        const_bufs);
+    shards.push_back(MultiProgram::Shard{std::move(shard_program), begin, count});
+    begin += count;
+  }
+  IVLOG(1, "Data-parallel execution across " << dev_ids.size() << " devices, batch " << batch);
+  return std::make_shared<MultiProgram>(program, batch, std::move(shards));
+}
+
 std::shared_ptr<tile::Program> Platform::MakeProgram(  //
     const context::Context& ctx,                       //
     const std::string& device,                         //
@@ -288,6 +518,10 @@ void Platform::ListDevices(                          //
     const context::Context& ctx,                     //
     const tile::proto::ListDevicesRequest& request,  //
     tile::proto::ListDevicesResponse* response) {
+  {
+    std::lock_guard<std::mutex> lock{probe_mu_};
+    ProbeAllDrivers();
+  }
   tile::proto::Device* dev = response->add_devices();
   dev->set_dev_id(kCpuDevice);
   dev->set_description("CPU (via LLVM)");
@@ -300,6 +534,10 @@ void Platform::ListDevices(                          //
 }
 
 std::vector<std::string> Platform::ListDevices() {
+  {
+    std::lock_guard<std::mutex> lock{probe_mu_};
+    ProbeAllDrivers();
+  }
   std::vector<std::string> device_ids{kCpuDevice};
   for (const auto& kvp : devs_) {
     device_ids.push_back(kvp.first);
@@ -309,12 +547,21 @@ std::vector<std::string> Platform::ListDevices() {
 
 const Platform::PlatformDev& Platform::LookupDevice(const std::string& id) {
   if (!id.length()) {
+    std::lock_guard<std::mutex> lock{probe_mu_};
+    ProbeAllDrivers();
     if (!devs_.size()) {
       throw error::NotFound{"No Tile compute devices available"};
     }
     IVLOG(1, "Using first device found: " << devs_.begin()->first);
     return devs_.begin()->second;
   }
+  {
+    // Probe drivers in priority order just until the requested device
+    // appears; a pinned configuration never touches the drivers past it.
+    std::lock_guard<std::mutex> lock{probe_mu_};
+    while (devs_.find(id) == devs_.end() && ProbeNextDriver()) {
+    }
+  }
   auto it = devs_.find(id);
   if (it == devs_.end()) {
     throw error::NotFound{std::string("Unable to find Tile device \"") + id + "\""};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -43,11 +44,25 @@ class Platform : public tile::Platform {
       const std::string& device,             //
       std::uint64_t size) final;
 
+  std::shared_ptr<tile::Buffer> MakeHostBuffer(  //
+      const context::Context& ctx,               //
+      const std::string& device,                 //
+      void* data,                                //
+      std::uint64_t size) final;
+
   std::shared_ptr<tile::Program> MakeProgram(  //
       const context::Context& ctx,             //
       const tile::proto::Program& program,     //
       ConstBufferManager* const_bufs) final;
 
+  // Builds a data-parallel MultiProgram across the devices listed in
+  // PLAIDML_DP_DEVICES, or returns nullptr when the variable is unset or
+  // the program's batch dimension cannot be sharded.
+  std::shared_ptr<tile::Program> MakeMultiProgram(  //
+      const context::Context& ctx,                  //
+      const tile::proto::Program& program,          //
+      ConstBufferManager* const_bufs);
+
   std::shared_ptr<tile::Program> MakeProgram(           //
       const context::Context& ctx,                      //
       const std::string& device,                        //
@@ -65,7 +80,23 @@ class Platform : public tile::Platform {
  private:
   const PlatformDev& LookupDevice(const std::string& id);
 
+  // Creates the next registered HAL driver (skipping any excluded by
+  // PLAIDML_HAL) and initializes its devices into devs_.  Returns false
+  // once every registered factory has been consumed.  Callers must hold
+  // probe_mu_.
+  bool ProbeNextDriver();
+
+  // Creates any drivers not yet probed.  Callers must hold probe_mu_.
+  void ProbeAllDrivers();
+
+  // Assigns ids to the driver's devices, initializes them, and records
+  // them in devs_.
+  void InitDriverDevices(const context::Context& ctx, hal::Driver* driver);
+
   std::vector<std::unique_ptr<hal::Driver>> drivers_;
+  std::mutex probe_mu_;
+  size_t next_factory_ = 0;
+  proto::Platform::CpuNumaPolicy cpu_numa_policy_ = proto::Platform::NONE;
   std::unordered_map<std::string, PlatformDev> devs_;
   std::unordered_map<std::string, PlatformDev> unmatched_devs_;
   std::shared_ptr<Scheduler> scheduler_;
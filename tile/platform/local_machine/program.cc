@@ -4,23 +4,30 @@
 
 #include <algorithm>
 #include <forward_list>
+#include <functional>
 #include <limits>
 #include <numeric>
 #include <set>
+#include <sstream>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <google/protobuf/text_format.h>
+
 #include "base/util/env.h"
 #include "base/util/error.h"
 #include "base/util/perf_counter.h"
+#include "tile/base/artifact_cache.h"
 #include "tile/hal/util/settings.h"
 #include "tile/lang/parser.h"
 #include "tile/lang/tile_cache.h"
 #include "tile/ocl_exec/stripe_gen.h"
 #include "tile/platform/local_machine/buffer.h"
+#include "tile/platform/local_machine/cpu_ops.h"
 #include "tile/platform/local_machine/run_request.h"
 #include "tile/proto/support.h"
+#include "tile/targets/targets.h"
 
 namespace vertexai {
 namespace tile {
@@ -36,6 +43,12 @@ std::mutex mutex;
 
 static PerfCounter pre_scan_time("pre_scan_time");
 static PerfCounter post_scan_time("post_scan_time");
+static PerfCounter program_compiles("program_compiles");
+
+// How many fallback schedules to plan at successively halved budgets.
+constexpr size_t kMaxFallbackSchedules = 2;
+// Consecutive successful runs at a degraded level before climbing back.
+constexpr size_t kSchedulePromoteRuns = 16;
 
 void AllocateBuffers(const std::vector<std::string>& names, const ShapeMap& types, hal::Memory* memory,
                      std::vector<std::shared_ptr<hal::Buffer>>* buffers) {
@@ -82,6 +95,37 @@ int64_t TryKernel(const context::Context& ctx, const lang::KernelInfo& ki,
   return std::numeric_limits<int64_t>::max();
 }
 
+// Gets the schedule replay cache, enabled by pointing PLAIDML_SCHEDULE_CACHE
+// at a directory.  Replays are strictly an optimization; a miss or a stale
+// entry falls back to running the scheduler.
+ArtifactCache* ScheduleReplayCache() {
+  static ArtifactCache cache{env::Get("PLAIDML_SCHEDULE_CACHE")};
+  return cache.enabled() ? &cache : nullptr;
+}
+
+// Digests everything the schedule depends on: the program's bindings, the
+// generated kernels, the device settings, and the scheduler that planned
+// it.  Text-format proto printing is used because it's deterministic (map
+// entries print sorted), unlike binary serialization.  The digest isn't
+// collision-resistant, so replayed schedules are always re-validated.
+std::string ScheduleReplayKey(const tile::proto::Program& program, const lang::KernelList& kl,
+                              const hal::proto::HardwareSettings& settings, const char* scheduler_name) {
+  std::string program_text;
+  google::protobuf::TextFormat::PrintToString(program, &program_text);
+  std::string settings_text;
+  google::protobuf::TextFormat::PrintToString(settings, &settings_text);
+  std::ostringstream digest;
+  // The target config version guards against reusing a schedule planned for
+  // kernels an older (hot-reloaded) config generated.
+  digest << scheduler_name << '|' << targets::ConfigsVersion() << '|' << settings_text << '|' << program_text;
+  for (const auto& ki : kl.kernels) {
+    digest << '|' << ki.kname << ':' << ki.key << ':' << ki.tot_bytes;
+  }
+  std::ostringstream key;
+  key << "schedule-" << std::hex << std::hash<std::string>{}(digest.str());
+  return key.str();
+}
+
 lang::KernelList CompileProgram(           //
     const tile::proto::Program& program,   //
     const DevInfo& devinfo,                //
@@ -97,7 +141,7 @@ lang::KernelList CompileProgram(           //
 
   context::Context ctx;
   lang::Parser parser;
-  auto parsed = parser.Parse(program.code());
+  auto parsed = parser.ParseCached(program.code());
   auto inputs = FromProto(program.inputs());
   auto outputs = FromProto(program.outputs());
 
@@ -119,7 +163,7 @@ lang::KernelList CompileProgram(           //
         runinfo.const_inputs.emplace(kvp.first);
       }
     }
-    return codegen::GenerateProgram(runinfo, stripe_cfg, out_path, const_bufs);
+    return codegen::GenerateProgram(ctx, runinfo, stripe_cfg, out_path, const_bufs);
   }
 
   auto settings = hal::settings::ToHardwareSettings(devinfo.settings);
@@ -196,8 +240,10 @@ Program::Program(                                             //
   // request and mark the output buffers somehow to indicate that they're not just not ready due to hal events, they're
   // not ready due to compilation futures (which can't be waited on simultaneously).  There's a relatively
   // straightforward dataflow-ish way to describe the resulting system, but it's more complicated than just
-  // compiling everything synchronously, so we just do everything synchronously for now.
+  // compiling everything synchronously, so we just do kernel generation synchronously here; the HAL build of the
+  // generated kernels does run concurrently with scheduling (see Initialize), with the first run blocking on it.
 
+  program_compiles.inc();
   kernel_list_ = CompileProgram(program, *devinfo_.get(), optimizer, const_bufs);
   const_bufs_ = const_bufs->buffers;
 
@@ -218,16 +264,27 @@ Program::Program(                                             //
       output_mem_strategy_{output_mem_strategy},
       tmp_mem_strategy_{tmp_mem_strategy},
       num_runs_{0} {
+  program_compiles.inc();
   auto out_path = env::Get("PLAIDML_STRIPE_OUTPUT");
-  kernel_list_ = codegen::GenerateProgram(stripe, target, out_path, const_bufs);
+  kernel_list_ = codegen::GenerateProgram(ctx, stripe, target, out_path, const_bufs);
   const_bufs_ = const_bufs->buffers;
 
   tile::proto::Program program;
   *program.mutable_inputs() = IntoProtoInput(stripe->input_shapes);
   *program.mutable_outputs() = IntoProtoOutput(stripe->output_shapes);
+  for (const auto& name : stripe->donated_inputs) {
+    auto it = program.mutable_inputs()->find(name);
+    if (it != program.mutable_inputs()->end()) {
+      // The caller won't read this input again, so the placer may fold an
+      // output into its allocation and skip the copy-back.
+      it->second.set_consumed(true);
+    }
+  }
   Initialize(ctx, program, scheduler);
 }
 
+Program::~Program() = default;
+
 void Program::Initialize(          //
     const context::Context& ctx,   //
     tile::proto::Program program,  //
@@ -240,6 +297,13 @@ void Program::Initialize(          //
                  ? devinfo_->dev->executor()->device_memory()
                  : devinfo_->devset->host_memory());
 
+  // Share identical constants (e.g. weights common to several compiled
+  // signatures) with the other programs on this device, instead of keeping
+  // and uploading a copy per program.
+  for (auto& kvp : const_bufs_) {
+    kvp.second = devinfo_->const_pool->Intern(ctx, kvp.second);
+  }
+
   for (const auto& kvp : const_bufs_) {
     if (!program.inputs().count(kvp.first)) {
       auto shape = kernel_list_.types.at(kvp.first);
@@ -250,9 +314,41 @@ void Program::Initialize(          //
   }
 
   context::Activity activity{ctx, "tile::local_machine::Compile"};
-  auto lib = devinfo_->dev->compiler()->Build(activity.ctx(), kernel_list_.kernels, devinfo_->settings).get();
-  executable_ = devinfo_->dev->executor()->Prepare(lib.get()).get();
-  schedule_ = scheduler->BuildSchedule(program, kernel_list_);
+  // Launch the HAL build immediately, but don't wait for it: the driver
+  // compiles kernels while we build and validate the schedule, and the first
+  // caller that needs the executable blocks on whatever's still outstanding.
+  library_future_ = devinfo_->dev->compiler()->Build(activity.ctx(), kernel_list_.kernels, devinfo_->settings);
+
+  // Replay a previously-planned schedule when one is cached, skipping the
+  // scheduler, placer, and fallback planning on process restart.  The
+  // replay is still validated against this program's kernels, so a stale or
+  // colliding entry degrades to a fresh plan instead of a miscompile.
+  ArtifactCache* replay_cache = ScheduleReplayCache();
+  std::string replay_key;
+  bool replayed = false;
+  if (replay_cache) {
+    replay_key = ScheduleReplayKey(program, kernel_list_, devinfo_->settings, scheduler->name());
+    std::string serialized;
+    proto::ScheduleReplay replay;
+    if (replay_cache->TryGet(replay_key, &serialized) && replay.ParseFromString(serialized)) {
+      try {
+        auto sched = schedule::ScheduleFromProto(replay.schedule());
+        ValidateSchedule(program, kernel_list_, sched);
+        schedule_ = std::move(sched);
+        for (const auto& fb : replay.fallbacks()) {
+          fallback_schedules_.emplace_back(schedule::ScheduleFromProto(fb));
+        }
+        replayed = true;
+      } catch (const std::exception& ex) {
+        IVLOG(1, "Discarding stale schedule replay: " << ex.what());
+        fallback_schedules_.clear();
+      }
+    }
+  }
+
+  if (!replayed) {
+    schedule_ = scheduler->BuildSchedule(program, kernel_list_);
+  }
 
   if (activity.ctx().is_logging_events()) {
     hal::proto::CompilationInfo cinfo;
@@ -270,7 +366,139 @@ void Program::Initialize(          //
     activity.AddMetadata(sched_pb);
   }
 
-  ValidateSchedule(program, kernel_list_, schedule_);
+  if (!replayed) {
+    ValidateSchedule(program, kernel_list_, schedule_);
+    PruneTransitiveDeps(&schedule_);
+  }
+
+  // Plan fallback schedules at decreasing budgets, so run-time allocation
+  // failures under memory pressure degrade to a smaller schedule instead of
+  // aborting.  PLAIDML_ADAPTIVE_SCHEDULES=0 disables the fallbacks.
+  if (!replayed && env::Get("PLAIDML_ADAPTIVE_SCHEDULES") != "0") {
+    auto alignment = memory_->ArenaBufferAlignment();
+    auto last_size = TotalAllocSize(schedule_, alignment);
+    std::uint64_t budget = MaxAvailableMemory();
+    for (size_t i = 0; i < kMaxFallbackSchedules; i++) {
+      budget /= 2;
+      auto sub_scheduler = scheduler->WithSizeGoal(budget);
+      if (!sub_scheduler) {
+        break;
+      }
+      try {
+        auto sched = sub_scheduler->BuildSchedule(program, kernel_list_);
+        ValidateSchedule(program, kernel_list_, sched);
+        PruneTransitiveDeps(&sched);
+        auto size = TotalAllocSize(sched, alignment);
+        if (size < last_size) {
+          IVLOG(1, "Fallback schedule at budget " << budget << ": " << size << " bytes");
+          fallback_schedules_.emplace_back(std::move(sched));
+          last_size = size;
+        }
+      } catch (const std::exception& ex) {
+        IVLOG(1, "No fallback schedule at budget " << budget << ": " << ex.what());
+        break;
+      }
+    }
+  }
+
+  if (!replayed && replay_cache) {
+    // Callback steps can't be rebound from a replay, so only plain
+    // kernel/copy schedules are persisted.
+    bool has_callbacks = false;
+    for (const auto& step : schedule_.steps) {
+      has_callbacks |= step.tag == schedule::Step::Tag::kCallback;
+    }
+    if (!has_callbacks) {
+      proto::ScheduleReplay replay;
+      schedule::ScheduleToProto(replay.mutable_schedule(), schedule_);
+      for (const auto& sched : fallback_schedules_) {
+        schedule::ScheduleToProto(replay.add_fallbacks(), sched);
+      }
+      replay_cache->Put(replay_key, replay.SerializeAsString());
+    }
+  }
+
+  // Applied after the replay block so the persisted plan stays callback-free
+  // (callback schedules aren't cached) and replayed plans get the same
+  // rewrite as fresh ones.
+  ApplyCpuOpAffinity(&schedule_, kernel_list_);
+  for (auto& sched : fallback_schedules_) {
+    ApplyCpuOpAffinity(&sched, kernel_list_);
+  }
+
+  if (env::Get("PLAIDML_ASYNC_COMPILE") == "0") {
+    executable();
+  }
+
+  // Warm one run arena now so the first submission doesn't pay for the
+  // per-step working storage either.
+  auto arena = std::make_unique<RunArena>();
+  arena->Prepare(schedule_);
+  arena->Reset();
+  arenas_.emplace_back(std::move(arena));
+}
+
+std::unique_ptr<RunArena> Program::AcquireArena() {
+  std::lock_guard<std::mutex> lock{arena_mu_};
+  if (arenas_.empty()) {
+    return std::make_unique<RunArena>();
+  }
+  auto arena = std::move(arenas_.back());
+  arenas_.pop_back();
+  return arena;
+}
+
+void Program::ReleaseArena(std::unique_ptr<RunArena> arena) {
+  arena->Reset();
+  std::lock_guard<std::mutex> lock{arena_mu_};
+  arenas_.emplace_back(std::move(arena));
+}
+
+const std::unique_ptr<hal::Executable>& Program::executable() const {
+  std::call_once(executable_ready_, [this]() {
+    auto lib = library_future_.get();
+    executable_ = devinfo_->dev->executor()->Prepare(lib.get()).get();
+  });
+  return executable_;
+}
+
+const schedule::Schedule& Program::schedule() const {
+  std::lock_guard<std::mutex> lock{sched_mu_};
+  return sched_level_ ? fallback_schedules_[sched_level_ - 1] : schedule_;
+}
+
+bool Program::DegradeSchedule(const schedule::Schedule* attempted) {
+  std::lock_guard<std::mutex> lock{sched_mu_};
+  const schedule::Schedule* current = sched_level_ ? &fallback_schedules_[sched_level_ - 1] : &schedule_;
+  if (attempted != current) {
+    // Another run already moved the selection; retry with its choice.
+    return true;
+  }
+  if (sched_level_ >= fallback_schedules_.size()) {
+    return false;
+  }
+  sched_level_++;
+  sched_successes_ = 0;
+  LOG(WARNING) << "Memory pressure: falling back to reduced-memory schedule " << sched_level_;
+  return true;
+}
+
+void Program::NoteScheduleSuccess() {
+  std::lock_guard<std::mutex> lock{sched_mu_};
+  if (!sched_level_) {
+    return;
+  }
+  if (++sched_successes_ >= kSchedulePromoteRuns) {
+    sched_level_--;
+    sched_successes_ = 0;
+    IVLOG(1, "Memory pressure eased: climbing back to schedule " << sched_level_);
+  }
+}
+
+void Program::Reserve() {
+  std::lock_guard<std::mutex> guard(mutex);
+  avail_mem = (avail_mem >= alloc_mem_) ? avail_mem - alloc_mem_ : 0;
+  ++num_runs_;
 }
 
 void Program::Release() {
@@ -293,8 +521,19 @@ boost::future<void> Program::Run(const context::Context& ctx,
   // This is the first program instance. Initialize the available memory and sync variables.
   std::call_once(first_run, [&]() { avail_mem = MaxAvailableMemory(); });
 
-  alloc_mem_ = TotalAllocSize(schedule_, memory_->ArenaBufferAlignment());
-  if (alloc_mem_ <= MaxAvailableMemory()) {
+  // If even the device-memory goal can't hold the selected schedule, fall
+  // back through the reduced-budget family before giving up.
+  alloc_mem_ = TotalAllocSize(schedule(), memory_->ArenaBufferAlignment());
+  while (alloc_mem_ > MaxAvailableMemory()) {
+    const auto& attempted = schedule();
+    if (!DegradeSchedule(&attempted)) {
+      throw std::runtime_error(
+          str(boost::format("No enough memory for the current schedule: required %1%, available %2%") % alloc_mem_ %
+              MaxAvailableMemory()));
+    }
+    alloc_mem_ = TotalAllocSize(schedule(), memory_->ArenaBufferAlignment());
+  }
+  {
     std::unique_lock<std::mutex> guard(mutex);
     // TODO: could be asynchronous later
     // Wait for enough memory
@@ -302,10 +541,6 @@ boost::future<void> Program::Run(const context::Context& ctx,
     // Reduce the available memory
     avail_mem -= alloc_mem_;
     ++num_runs_;
-  } else {
-    throw std::runtime_error(
-        str(boost::format("No enough memory for the current schedule: required %1%, available %2%") % alloc_mem_ %
-            MaxAvailableMemory()));
   }
 
   IVLOG(2, "  Inputs:");
@@ -10,6 +10,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "tile/base/buffer.h"
 #include "tile/base/program.h"
@@ -18,6 +19,7 @@
 #include "tile/platform/local_machine/devinfo.h"
 #include "tile/platform/local_machine/mem_strategy.h"
 #include "tile/platform/local_machine/scheduler.h"
+#include "tile/platform/local_machine/submit_queue.h"
 #include "tile/proto/tile.pb.h"
 #include "tile/stripe/stripe.h"
 
@@ -25,6 +27,8 @@ namespace vertexai {
 namespace tile {
 namespace local_machine {
 
+class RunArena;
+
 // The percentage of the device's memory that programs will try to use.
 // This value seems to work pretty well on most devices.
 // TODO: Either autotune this, or move it to the per-device configuration.
@@ -47,6 +51,10 @@ class Program final : public tile::Program, public std::enable_shared_from_this<
           hal::Memory* tmp_memory,                                  //
           ConstBufferManager* const_bufs);
 
+  // Out of line so the pooled arenas can be destroyed where RunArena is
+  // complete.
+  ~Program();
+
   boost::future<void> Run(          //
       const context::Context& ctx,  //
       std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
@@ -59,11 +67,46 @@ class Program final : public tile::Program, public std::enable_shared_from_this<
   void Release() final;
 
   const std::shared_ptr<DevInfo>& devinfo() const { return devinfo_; }
+  // The program's submission priority, captured from
+  // PLAIDML_PROGRAM_PRIORITY at construction time.
+  SubmitQueue::Priority priority() const { return priority_; }
   const std::shared_ptr<MemStrategy>& output_mem_strategy() const { return output_mem_strategy_; }
   const std::shared_ptr<MemStrategy>& tmp_mem_strategy() const { return tmp_mem_strategy_; }
-  const schedule::Schedule& schedule() const { return schedule_; }
   const lang::KernelList& kernel_list() const { return kernel_list_; }
-  const std::unique_ptr<hal::Executable>& executable() const { return executable_; }
+
+  // The currently selected schedule.  When fallback schedules exist, this is
+  // the one at the current degradation level; runs should capture the
+  // reference once and use it for the whole attempt.
+  const schedule::Schedule& schedule() const;
+
+  // Steps down to the next-smaller schedule after `attempted` failed to get
+  // memory.  Returns true when a retry is worthwhile: either the selection
+  // moved to a smaller schedule, or another run already degraded it.
+  // Returns false when no smaller schedule remains.
+  bool DegradeSchedule(const schedule::Schedule* attempted);
+
+  // Records a successful run for the hysteresis policy: after enough
+  // consecutive successes at a degraded level, the selection climbs back
+  // toward the full-budget schedule.
+  void NoteScheduleSuccess();
+
+  // Re-reserves the memory accounting a Shim's destructor released, used
+  // when a degraded retry discards a partially-launched attempt.
+  void Reserve();
+
+  // Gets a pooled per-run working-storage arena, creating one only when all
+  // pooled arenas are in use by concurrent runs; steady-state submissions
+  // reuse the capacity established by earlier runs.
+  std::unique_ptr<RunArena> AcquireArena();
+
+  // Returns an arena to the pool once its run has been enqueued.
+  void ReleaseArena(std::unique_ptr<RunArena> arena);
+
+  // Gets the program's executable, blocking until the HAL build launched at
+  // construction time has finished.  Compilation runs concurrently with
+  // scheduling and memory planning; only the first run pays for whatever's
+  // still outstanding.
+  const std::unique_ptr<hal::Executable>& executable() const;
 
  private:
   void Initialize(                   //
@@ -77,11 +120,22 @@ class Program final : public tile::Program, public std::enable_shared_from_this<
   std::shared_ptr<MemStrategy> tmp_mem_strategy_;
   lang::KernelList kernel_list_;
   schedule::Schedule schedule_;
+  // Schedules planned at successively halved memory budgets, tried in order
+  // when allocation fails at run time.
+  std::vector<schedule::Schedule> fallback_schedules_;
+  mutable std::mutex sched_mu_;
+  std::size_t sched_level_ = 0;
+  std::size_t sched_successes_ = 0;
   std::map<std::string, std::shared_ptr<tile::Buffer>> const_bufs_;
-  std::unique_ptr<hal::Executable> executable_;
+  mutable boost::future<std::unique_ptr<hal::Library>> library_future_;
+  mutable std::once_flag executable_ready_;
+  mutable std::unique_ptr<hal::Executable> executable_;
   std::size_t alloc_mem_;
   std::size_t num_runs_;
   hal::Memory* memory_;
+  std::mutex arena_mu_;
+  std::vector<std::unique_ptr<RunArena>> arenas_;
+  SubmitQueue::Priority priority_ = SubmitQueue::FromEnv();
 };
 
 }  // namespace local_machine
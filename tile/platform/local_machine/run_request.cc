@@ -2,10 +2,12 @@
 
 #include "tile/platform/local_machine/run_request.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
 
 #include "base/util/error.h"
+#include "tile/base/kernel_profile.h"
 #include "tile/platform/local_machine/shim.h"
 
 namespace vertexai {
@@ -13,30 +15,69 @@ namespace tile {
 namespace local_machine {
 namespace {
 
-// Runs the schedule for a particular program.
+// The result reported for a host callback step.
+class CallbackResult final : public hal::Result {
+ public:
+  explicit CallbackResult(std::chrono::high_resolution_clock::duration duration) : duration_{duration} {}
+
+  std::chrono::high_resolution_clock::duration GetDuration() const final { return duration_; }
+  void LogStatistics() const final {}
+
+ private:
+  std::chrono::high_resolution_clock::duration duration_;
+};
+
+// A host-completed event, used to sequence callback steps.  These must never
+// be handed to the HAL: device HAL implementations validate that dependency
+// events came from their own implementation, so callback completions are
+// instead resolved on the host before their dependents are enqueued.
+class CallbackEvent final : public hal::Event {
+ public:
+  explicit CallbackEvent(boost::shared_future<std::shared_ptr<hal::Result>> future) : future_{std::move(future)} {}
+
+  boost::shared_future<std::shared_ptr<hal::Result>> GetFuture() final { return future_; }
+
+ private:
+  boost::shared_future<std::shared_ptr<hal::Result>> future_;
+};
+
+// Runs the schedule for a particular program.  The arena supplies the
+// per-step working storage; its capacity persists across runs.
 boost::future<std::vector<std::shared_ptr<hal::Result>>> RunSchedule(  //
-    const context::Context& ctx, RunRequest* req, Shim* shim) {
-  std::vector<std::shared_ptr<hal::Event>> deps;
-  deps.resize(req->program()->schedule().steps.size());
-  std::unordered_set<std::shared_ptr<hal::Event>> dep_set;
+    const context::Context& ctx, RunRequest* req, Shim* shim, RunArena* arena,
+    SubmitQueue::Ticket* ticket) {
+  auto& deps = arena->deps;
+  auto& dep_set = arena->dep_set;
+  auto& host_events = arena->host_events;
 
-  for (const auto& step : req->program()->schedule().steps) {
+  for (const auto& step : req->schedule().steps) {
+    // A kernel-boundary preemption point: concurrent runs on this device
+    // are admitted by priority and fair share; see SubmitQueue.
+    ticket->Yield();
     IVLOG(2, "Queueing s" << step.idx << ": " << step);
-    std::vector<std::shared_ptr<hal::Event>> current_deps;
-    std::vector<std::shared_ptr<hal::Buffer>> current_params;
-    std::vector<std::shared_ptr<MemChunk>> current_dep_chunks;
+    auto& current_deps = arena->current_deps;
+    auto& current_params = arena->current_params;
+    auto& current_dep_chunks = arena->current_dep_chunks;
+    current_deps.clear();
+    current_params.clear();
+    current_dep_chunks.clear();
 
-    auto add_chunk_param = [shim, &current_deps](std::size_t sidx, schedule::Alloc* alloc) {
+    // Copy steps touch only the leading byte_count bytes of each parameter;
+    // restricting their recorded range lets later steps that touch only the
+    // remainder of a chunk skip the wait.  Run steps conservatively cover
+    // the whole chunk, since kernels don't carry sub-range information.
+    std::uint64_t access_limit =
+        step.tag == schedule::Step::Tag::kCopy ? step.byte_count : MemDeps::kWholeChunk;
+
+    auto add_chunk_param = [shim, &current_deps, access_limit](std::size_t sidx, schedule::Alloc* alloc) {
       std::shared_ptr<MemChunk> chunk = shim->LookupAlloc(sidx, alloc);
-      chunk->deps()->GetReadDependencies(&current_deps);
+      chunk->deps()->GetReadDependencies(&current_deps, 0, access_limit);
       return chunk;
     };
 
     for (const auto& dep : step.deps) {
       current_deps.emplace_back(deps[dep->idx]);
     }
-    current_params.reserve(step.outputs.size() + step.inputs.size());
-    current_dep_chunks.reserve(step.outputs.size());
     for (const auto& out : step.outputs) {
       std::shared_ptr<MemChunk> chunk = add_chunk_param(step.idx, out.allocp);
       current_params.emplace_back(chunk->hal_buffer());
@@ -47,26 +88,75 @@ boost::future<std::vector<std::shared_ptr<hal::Result>>> RunSchedule(  //
     for (const auto& in : step.inputs) {
       current_params.emplace_back(add_chunk_param(step.idx, in)->hal_buffer());
     }
+
+    // Host-completed events can't be passed to the HAL, so split them out;
+    // they're resolved on the host at the point where a dependent is
+    // enqueued.  Device work already in flight is unaffected.
+    std::vector<boost::shared_future<std::shared_ptr<hal::Result>>> host_deps;
+    {
+      auto& device_deps = arena->device_deps;
+      device_deps.clear();
+      for (auto& dep : current_deps) {
+        if (host_events.count(dep.get())) {
+          host_deps.emplace_back(dep->GetFuture());
+        } else {
+          device_deps.emplace_back(dep);
+        }
+      }
+      current_deps.swap(device_deps);
+    }
+
     std::shared_ptr<hal::Event> event;
     switch (step.tag) {
       case schedule::Step::Tag::kRun:
+        for (auto& host_dep : host_deps) {
+          host_dep.get();
+        }
         // NOTE: VLOG_IS_ON(1) is needed here because LogResults depends on profiling
         // being enabled in order to print durations.
         event = req->program()->executable()->Run(ctx, step.kidx, current_params, current_deps,
-                                                  ctx.is_logging_events() || VLOG_IS_ON(1));
+                                                  ctx.is_logging_events() || VLOG_IS_ON(1) ||  //
+                                                      KernelProfile::Instance()->enabled());
         break;
       case schedule::Step::Tag::kCopy:
         if (current_params.size() != 2) {
           throw error::Internal{"Invalid parameter count for copy step s" + std::to_string(step.idx)};
         }
+        for (auto& host_dep : host_deps) {
+          host_dep.get();
+        }
         event = req->program()->devinfo()->dev->executor()->Copy(ctx, current_params[1], 0, current_params[0], 0,
                                                                  step.byte_count, current_deps);
         break;
+      case schedule::Step::Tag::kCallback: {
+        if (!step.callback) {
+          throw error::Internal{"No callback bound for callback step s" + std::to_string(step.idx)};
+        }
+        boost::future<std::vector<std::shared_ptr<hal::Result>>> ready;
+        if (current_deps.empty()) {
+          ready = boost::make_ready_future<std::vector<std::shared_ptr<hal::Result>>>();
+        } else {
+          ready = req->program()->devinfo()->dev->executor()->WaitFor(current_deps);
+        }
+        auto done = ready.then([callback = step.callback, host_deps = std::move(host_deps),
+                                current_params](decltype(ready) fut) -> std::shared_ptr<hal::Result> {
+          fut.get();
+          for (auto& host_dep : host_deps) {
+            host_dep.get();
+          }
+          auto start = std::chrono::high_resolution_clock::now();
+          callback(current_params);
+          return std::make_shared<CallbackResult>(std::chrono::high_resolution_clock::now() - start);
+        });
+        event = std::make_shared<CallbackEvent>(done.share());
+        host_events.insert(event.get());
+        break;
+      }
       default:
         throw error::Internal{"Invalid schedule step s" + std::to_string(step.idx)};
     }
     for (const auto& chunk : current_dep_chunks) {
-      chunk->deps()->AddReadDependency(event);
+      chunk->deps()->AddReadDependency(event, 0, access_limit);
     }
     dep_set.insert(event);
     for (const auto& dep : current_deps) {
@@ -77,17 +167,33 @@ boost::future<std::vector<std::shared_ptr<hal::Result>>> RunSchedule(  //
 
   boost::future<std::vector<std::shared_ptr<hal::Result>>> results;
 
-  if (!dep_set.size()) {
-    results = boost::make_ready_future<std::vector<std::shared_ptr<hal::Result>>>();
-  } else {
-    std::vector<std::shared_ptr<hal::Event>> terminal_deps;
-    terminal_deps.reserve(dep_set.size());
-    for (const auto& dep : dep_set) {
+  // As above: terminal host-completed events go to the HAL's WaitFor by way
+  // of their futures, not as events.
+  auto& terminal_deps = arena->terminal_deps;
+  terminal_deps.clear();
+  std::vector<boost::shared_future<std::shared_ptr<hal::Result>>> terminal_host_deps;
+  for (const auto& dep : dep_set) {
+    if (host_events.count(dep.get())) {
+      terminal_host_deps.emplace_back(dep->GetFuture());
+    } else {
       terminal_deps.emplace_back(dep);
     }
-    results = req->program()->devinfo()->dev->executor()->WaitFor(std::move(terminal_deps));
   }
-  if (ctx.is_logging_events() || VLOG_IS_ON(1)) {
+  if (!terminal_deps.size()) {
+    results = boost::make_ready_future<std::vector<std::shared_ptr<hal::Result>>>();
+  } else {
+    results = req->program()->devinfo()->dev->executor()->WaitFor(terminal_deps);
+  }
+  if (terminal_host_deps.size()) {
+    results = results.then([terminal_host_deps = std::move(terminal_host_deps)](decltype(results) fut) {
+      auto results = fut.get();
+      for (auto& dep : terminal_host_deps) {
+        results.push_back(dep.get());
+      }
+      return results;
+    });
+  }
+  if (ctx.is_logging_events() || VLOG_IS_ON(1) || KernelProfile::Instance()->enabled()) {
     // We want to return results for *all* of the steps.
     std::vector<boost::shared_future<std::shared_ptr<hal::Result>>> dep_futures;
     for (const auto& dep : deps) {
@@ -109,6 +215,31 @@ boost::future<std::vector<std::shared_ptr<hal::Result>>> RunSchedule(  //
 
 }  // namespace
 
+void RunArena::Prepare(const schedule::Schedule& schedule) {
+  Reset();
+  deps.assign(schedule.steps.size(), nullptr);
+  std::size_t max_params = 0;
+  std::size_t max_outputs = 0;
+  for (const auto& step : schedule.steps) {
+    max_params = std::max(max_params, step.outputs.size() + step.inputs.size());
+    max_outputs = std::max(max_outputs, step.outputs.size());
+  }
+  current_params.reserve(max_params);
+  current_dep_chunks.reserve(max_outputs);
+  terminal_deps.reserve(schedule.steps.size());
+}
+
+void RunArena::Reset() {
+  deps.clear();
+  current_deps.clear();
+  device_deps.clear();
+  current_params.clear();
+  current_dep_chunks.clear();
+  terminal_deps.clear();
+  dep_set.clear();
+  host_events.clear();
+}
+
 boost::future<void> RunRequest::Run(          //
     const context::Context& ctx,              //
     const std::shared_ptr<Program>& program,  //
@@ -116,19 +247,44 @@ boost::future<void> RunRequest::Run(          //
     std::map<std::string, std::shared_ptr<tile::Buffer>> outputs) {
   LogRequest(program, inputs, outputs);
 
-  RunRequest req{program};
-
   context::Activity running{ctx, "tile::local_machine::Program::Run"};
   boost::future<void> complete;
-  auto shim = std::make_unique<Shim>(running.ctx(), program, std::move(inputs), std::move(outputs));
+  std::unique_ptr<Shim> shim;
+  auto arena = program->AcquireArena();
+  SubmitQueue::Ticket ticket{program->devinfo()->submit_queue.get(), program->priority()};
+
+  // Each attempt runs against a single schedule captured up front; if the
+  // device can't supply memory for it, the program degrades to a
+  // smaller-footprint schedule (when one exists) and the launch is retried.
+  for (;;) {
+    const schedule::Schedule& schedule = program->schedule();
+    RunRequest req{program, &schedule};
+    arena->Prepare(schedule);
+
+    try {
+      shim = std::make_unique<Shim>(running.ctx(), program, schedule, inputs, outputs);
+    } catch (...) {
+      // The shim never finished constructing, so the run's reservation is
+      // still held; just retry against the degraded schedule.
+      if (program->DegradeSchedule(&schedule)) {
+        continue;
+      }
+      throw;
+    }
 
-  {
     context::Activity queueing{running.ctx(), "tile::local_machine::Program::Enqueue"};
     boost::future<std::vector<std::shared_ptr<hal::Result>>> results;
 
     try {
-      results = RunSchedule(queueing.ctx(), &req, shim.get());
+      results = RunSchedule(queueing.ctx(), &req, shim.get(), arena.get(), &ticket);
     } catch (...) {
+      if (program->DegradeSchedule(&schedule)) {
+        // Discard the partially-launched attempt; the shim's destructor
+        // releases the run's reservation, so re-take it for the retry.
+        shim.reset();
+        program->Reserve();
+        continue;
+      }
       shim->SetLaunchException(std::current_exception());
       // If this happens, it's probably an OOM.
       // TODO: Synchronize with the HAL to ensure all ongoing activity is complete,
@@ -136,9 +292,15 @@ boost::future<void> RunRequest::Run(          //
       return boost::make_ready_future();
     }
     shim->OnLaunchSuccess();
+    program->NoteScheduleSuccess();
     complete = req.LogResults(queueing.ctx(), std::move(results));
+    break;
   }
 
+  // The run is fully enqueued; return the working storage to the pool for
+  // the next submission.
+  program->ReleaseArena(std::move(arena));
+
   // Keep the shim and activity referenced until the program is complete.
   // N.B. It's important to keep the shim referenced because it's the thing that's actually holding
   // onto all of our chunk references; if those go away, unfortunate things happen.
@@ -184,7 +346,7 @@ boost::future<void> RunRequest::LogResults(  //
   context::Context ctx_copy{ctx};
   return results.then([ctx = std::move(ctx_copy)](decltype(results) future) {
     auto results = future.get();
-    if (VLOG_IS_ON(1) || ctx.is_logging_events()) {
+    if (VLOG_IS_ON(1) || ctx.is_logging_events() || KernelProfile::Instance()->enabled()) {
       std::chrono::high_resolution_clock::duration total{std::chrono::high_resolution_clock::duration::zero()};
       for (const auto& result : results) {
         total += result->GetDuration();
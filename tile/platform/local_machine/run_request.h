@@ -5,17 +5,41 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "base/context/context.h"
 #include "tile/base/buffer.h"
 #include "tile/base/hal.h"
+#include "tile/platform/local_machine/mem_chunk.h"
 #include "tile/platform/local_machine/program.h"
 
 namespace vertexai {
 namespace tile {
 namespace local_machine {
 
+// Per-run working storage for enqueueing a schedule.  Arenas are pooled on
+// the Program and reused across runs, so a steady-state fixed-shape serving
+// loop runs at the capacity high-water marks established by earlier runs
+// instead of reallocating the step structures every submission.
+class RunArena {
+ public:
+  // Sizes the storage for a schedule; capacity from prior runs is kept.
+  void Prepare(const schedule::Schedule& schedule);
+  // Drops all event/buffer references while keeping capacity, so a pooled
+  // arena doesn't extend the lifetime of the last run's resources.
+  void Reset();
+
+  std::vector<std::shared_ptr<hal::Event>> deps;
+  std::vector<std::shared_ptr<hal::Event>> current_deps;
+  std::vector<std::shared_ptr<hal::Event>> device_deps;
+  std::vector<std::shared_ptr<hal::Buffer>> current_params;
+  std::vector<std::shared_ptr<MemChunk>> current_dep_chunks;
+  std::vector<std::shared_ptr<hal::Event>> terminal_deps;
+  std::unordered_set<std::shared_ptr<hal::Event>> dep_set;
+  std::unordered_set<hal::Event*> host_events;
+};
+
 // Represents the state of a Program::Run request.
 class RunRequest {
  public:
@@ -28,6 +52,7 @@ class RunRequest {
   void AddProgramDoneDep(const std::shared_ptr<hal::Event>& event);
 
   const Program* program() const { return program_.get(); }
+  const schedule::Schedule& schedule() const { return *schedule_; }
 
  private:
   struct KernelLogInfo {
@@ -37,7 +62,8 @@ class RunRequest {
     std::size_t tot_flops;
   };
 
-  explicit RunRequest(const std::shared_ptr<Program>& program) : program_{program} {}
+  RunRequest(const std::shared_ptr<Program>& program, const schedule::Schedule* schedule)
+      : program_{program}, schedule_{schedule} {}
 
   static void LogRequest(                       //
       const std::shared_ptr<Program>& program,  //
@@ -49,6 +75,7 @@ class RunRequest {
       boost::future<std::vector<std::shared_ptr<hal::Result>>> results);
 
   const std::shared_ptr<Program> program_;
+  const schedule::Schedule* schedule_;
 };
 
 }  // namespace local_machine
@@ -2,6 +2,7 @@
 
 #include "tile/platform/local_machine/scheduler.h"
 
+#include <cstdlib>
 #include <iterator>
 #include <map>
 #include <set>
@@ -10,7 +11,9 @@
 #include <boost/dynamic_bitset.hpp>
 
 #include "base/util/compat.h"
+#include "base/util/env.h"
 #include "base/util/error.h"
+#include "base/util/factory.h"
 
 namespace vertexai {
 namespace tile {
@@ -46,10 +49,47 @@ std::vector<AllocInfo> GetAllocContents(const tile::proto::Program& program, con
   return alloc_infos;
 }
 
+// The batch size to annotate schedules with for deferred-bounds rebinding,
+// from PLAIDML_SCHEDULE_BATCH; zero disables annotation.
+std::uint64_t ScheduleBatch() {
+  auto str = env::Get("PLAIDML_SCHEDULE_BATCH");
+  if (str.empty()) {
+    return 0;
+  }
+  try {
+    return std::stoull(str);
+  } catch (const std::exception&) {
+    return 0;
+  }
+}
+
+// Bytes by which the shape grows per batch row: nonzero only when the
+// shape's outermost (highest-stride) dimension covers the batch, so
+// dropping rows drops a contiguous slab off the end.
+std::uint64_t BatchUnitBytes(const TensorShape& shape, std::uint64_t batch) {
+  if (batch < 2 || shape.dims.empty()) {
+    return 0;
+  }
+  std::size_t major = 0;
+  for (std::size_t i = 1; i < shape.dims.size(); i++) {
+    if (std::abs(shape.dims[i].stride) > std::abs(shape.dims[major].stride)) {
+      major = i;
+    }
+  }
+  if (shape.dims[major].size != batch) {
+    return 0;
+  }
+  return shape.byte_size() / batch;
+}
+
 }  // namespace
 
 schedule::Schedule ToScheduleSteps(const tile::proto::Program& program, const lang::KernelList& kl) {
   schedule::Schedule schedule;
+  auto sched_batch = ScheduleBatch();
+  if (sched_batch) {
+    schedule.planned_batch = sched_batch;
+  }
 
   // Figure out the set of program inputs and outputs that will be
   // accessed directly (i.e. without a copy).  These do not require
@@ -77,6 +117,7 @@ schedule::Schedule ToScheduleSteps(const tile::proto::Program& program, const la
     }
     schedule::Alloc alloc;
     alloc.byte_size = ty.second.byte_size();
+    alloc.unit_bytes = BatchUnitBytes(ty.second, sched_batch);
     auto ait = schedule.allocs.emplace(schedule.allocs.end(), std::move(alloc));
     tmps[ty.first].allocp = &*ait;
   }
@@ -91,6 +132,7 @@ schedule::Schedule ToScheduleSteps(const tile::proto::Program& program, const la
     schedule::Alloc alloc;
     alloc.input = input.first;
     alloc.byte_size = tyit->second.byte_size();
+    alloc.unit_bytes = BatchUnitBytes(tyit->second, sched_batch);
     auto ait = schedule.allocs.emplace(schedule.allocs.end(), std::move(alloc));
     tmps[input.first].allocp = &*ait;
   }
@@ -107,6 +149,7 @@ schedule::Schedule ToScheduleSteps(const tile::proto::Program& program, const la
     schedule::Alloc alloc;
     alloc.output = output;
     alloc.byte_size = tyit->second.byte_size();
+    alloc.unit_bytes = BatchUnitBytes(tyit->second, sched_batch);
     auto ait = schedule.allocs.emplace(schedule.allocs.end(), std::move(alloc));
     tmps[output].allocp = &*ait;
     program_outputs.insert(output);
@@ -202,6 +245,31 @@ void AddDataflowDeps(schedule::Schedule* schedule) {
   }
 }
 
+void PruneTransitiveDeps(schedule::Schedule* schedule) {
+  std::vector<boost::dynamic_bitset<>> transitive_deps{schedule->steps.size(),
+                                                       boost::dynamic_bitset<>(schedule->steps.size())};
+  for (auto& step : schedule->steps) {
+    auto& tdeps = transitive_deps[step.idx];
+    // Everything this step already reaches through its direct deps' own
+    // dependency chains.
+    for (const schedule::Step* dep : step.deps) {
+      tdeps |= transitive_deps[dep->idx];
+    }
+    // A direct dep that's also reachable transitively is redundant: waiting
+    // on the nearer dep's event already orders the step after it.  On deep
+    // sequential models this collapses each step's wait list to a single
+    // event instead of a chain that grows with program depth.
+    for (auto it = step.deps.begin(); it != step.deps.end();) {
+      if (tdeps.test((*it)->idx)) {
+        it = step.deps.erase(it);
+      } else {
+        tdeps.set((*it)->idx);
+        ++it;
+      }
+    }
+  }
+}
+
 void AddLinearDeps(schedule::Schedule* schedule, std::size_t delta) {
   if (schedule->steps.size() <= delta) {
     return;
@@ -285,6 +353,15 @@ void ValidateSchedule(const tile::proto::Program& program, const lang::KernelLis
         new_contents.emplace_back(contents);
         break;
       }
+      case schedule::Step::Tag::kCallback: {
+        // Callback outputs carry host-produced contents the kernel list knows
+        // nothing about; synthesize names so downstream liveness checks see
+        // them as defined.
+        for (std::size_t oidx = 0; oidx < step.outputs.size(); ++oidx) {
+          new_contents.emplace_back("callback:s" + std::to_string(sidx) + ":" + std::to_string(oidx));
+        }
+        break;
+      }
       default:
         throw error::Internal{"In validation: step " + std::to_string(sidx) + " has an invalid tag"};
     }
@@ -447,6 +524,23 @@ void SummarizeSchedule(hal::proto::CompilationInfo* cinfo, const tile::proto::Pr
   IVLOG(1, "Total memory required: " << total_bytes << " bytes");
 }
 
+std::shared_ptr<Scheduler> MakeRegisteredScheduler(const context::Context& ctx, const std::string& name,
+                                                   const SchedulerParams& params) {
+  auto factories = FactoryRegistrar<SchedulerFactory>::Instance()->Factories();
+  if (factories.empty()) {
+    throw error::NotFound{"No schedulers have been registered"};
+  }
+  if (!name.empty()) {
+    for (auto& item : factories) {
+      if (item.second.name == name) {
+        return item.second.factory(ctx)->MakeScheduler(params);
+      }
+    }
+    LOG(WARNING) << "Unknown scheduler \"" << name << "\"; using the default scheduler";
+  }
+  return factories.begin()->second.factory(ctx)->MakeScheduler(params);
+}
+
 }  // namespace local_machine
 }  // namespace tile
 }  // namespace vertexai
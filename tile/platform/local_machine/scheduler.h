@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
+#include "base/context/context.h"
 #include "tile/base/schedule.h"
 #include "tile/lang/generate.h"
 #include "tile/platform/local_machine/local_machine.pb.h"
@@ -20,9 +22,38 @@ class Scheduler {
 
   virtual schedule::Schedule BuildSchedule(const tile::proto::Program& program, const lang::KernelList& kl) = 0;
 
+  // Returns a scheduler of the same kind that plans against a smaller memory
+  // budget, or nullptr when the implementation cannot replan.  Programs use
+  // this to build fallback schedules for memory-pressure degradation.
+  virtual std::shared_ptr<Scheduler> WithSizeGoal(std::uint64_t size_goal) const { return nullptr; }
+
   virtual const char* name() const = 0;
 };
 
+// The per-device parameters a scheduler implementation is built with.
+struct SchedulerParams {
+  std::size_t alignment = 1;
+  std::uint64_t size_goal = 0;
+  hal::proto::HardwareSettings settings;
+};
+
+// Builds Scheduler instances for a device.  Implementations register
+// themselves with FactoryRegistrar<SchedulerFactory> (base/util/factory.h)
+// under the name used to select them via PLAIDML_SCHEDULER; the
+// highest-priority registration is the default.
+class SchedulerFactory {
+ public:
+  virtual ~SchedulerFactory() {}
+
+  virtual std::shared_ptr<Scheduler> MakeScheduler(const SchedulerParams& params) = 0;
+};
+
+// Instantiates the named registered scheduler, or the highest-priority
+// registration when the name is empty or unrecognized.  Throws
+// error::NotFound if no schedulers have been registered at all.
+std::shared_ptr<Scheduler> MakeRegisteredScheduler(const context::Context& ctx, const std::string& name,
+                                                   const SchedulerParams& params);
+
 // Creates a basic schedule with the steps defined by the supplied
 // KernelList, but with no dependency information.  The result isn't
 // suitable for execution, but makes a useful starting point for other
@@ -36,6 +67,13 @@ void AddDataflowDeps(schedule::Schedule* schedule);
 // Adds linear dependencies to a schedule, with the given delta.
 void AddLinearDeps(schedule::Schedule* schedule, std::size_t delta);
 
+// Removes dependencies that are implied transitively by a step's other
+// dependencies.  Running a schedule turns each dependency into an event
+// wait, so redundant edges cost real per-run driver time; requires steps to
+// be indexed and deps to point at earlier steps (as ValidateSchedule
+// checks).
+void PruneTransitiveDeps(schedule::Schedule* schedule);
+
 // Validates a schedule -- i.e. for the supplied kernel list, validate that:
 // * All kernels are run exactly once,
 // * All kernels have the correct number of outputs and inputs,
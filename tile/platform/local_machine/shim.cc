@@ -2,10 +2,13 @@
 
 #include "tile/platform/local_machine/shim.h"
 
+#include <sstream>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "base/util/error.h"
+#include "tile/platform/local_machine/binding_audit.h"
 #include "tile/platform/local_machine/buffer.h"
 
 namespace vertexai {
@@ -13,15 +16,33 @@ namespace tile {
 namespace local_machine {
 namespace {
 
+// Migrates an input living on another device of the same device set onto
+// the program's device with a single device-to-device HAL copy.  Devices in
+// an OpenCL device set share a context, so the copy runs peer-to-peer over
+// the bus instead of bouncing the tensor through host memory.
+std::shared_ptr<MemChunk> MigrateChunk(const context::Context& ctx, const Program* program,
+                                       const std::shared_ptr<Buffer>& input_buffer) {
+  input_buffer->EnsureChunk(ctx);
+  auto src = input_buffer->chunk();
+  auto chunk = program->tmp_mem_strategy()->MakeChunk(ctx, src->size());
+  std::vector<std::shared_ptr<hal::Event>> deps;
+  src->deps()->GetReadDependencies(&deps);
+  auto event = program->devinfo()->dev->executor()->Copy(ctx, src->hal_buffer(), 0, chunk->hal_buffer(), 0,
+                                                         src->size(), deps);
+  src->deps()->AddReadDependency(event);
+  chunk->deps()->AddReadDependency(event);
+  return chunk;
+}
+
 // Builds a memory allocation map for a particular program run.
 std::pair<std::vector<std::shared_ptr<MemChunk>>, std::list<Shim::AliasUpdate>> BuildChunkMap(
-    const context::Context& ctx, const Program* program,
+    const context::Context& ctx, const Program* program, const schedule::Schedule& schedule,
     const std::map<std::string, std::shared_ptr<tile::Buffer>>& inputs,
     const std::map<std::string, std::shared_ptr<tile::Buffer>>& outputs) {
   std::vector<std::shared_ptr<MemChunk>> chunk_infos;
   std::list<Shim::AliasUpdate> updates;
-  chunk_infos.reserve(program->schedule().allocs.size());
-  for (const auto& alloc : program->schedule().allocs) {
+  chunk_infos.reserve(schedule.allocs.size());
+  for (const auto& alloc : schedule.allocs) {
     std::shared_ptr<MemChunk> chunk;
     if (alloc.is_input()) {
       // This is a program input.  If the input has a chunk, we have to use it --
@@ -33,9 +54,20 @@ std::pair<std::vector<std::shared_ptr<MemChunk>>, std::list<Shim::AliasUpdate>>
       if (iit == inputs.end()) {
         throw error::NotFound{"Missing program input: " + alloc.input};
       }
-      std::shared_ptr<Buffer> input_buffer = Buffer::Downcast(iit->second, program->devinfo());
-      input_buffer->EnsureChunk(ctx);
-      chunk = input_buffer->chunk();
+      std::shared_ptr<Buffer> input_buffer = std::dynamic_pointer_cast<Buffer>(iit->second);
+      if (!input_buffer) {
+        throw error::InvalidArgument("incompatible buffer type");
+      }
+      if (input_buffer->devinfo() == program->devinfo()) {
+        input_buffer->EnsureChunk(ctx);
+        chunk = input_buffer->chunk();
+      } else if (input_buffer->devinfo()->devset == program->devinfo()->devset) {
+        // The input lives on a sibling device in the same device set; pull it
+        // over with a peer copy rather than rejecting it.
+        chunk = MigrateChunk(ctx, program, input_buffer);
+      } else {
+        throw error::InvalidArgument("incompatible buffer for device");
+      }
 
       if (alloc.is_output()) {
         // The chunk is also being used as a program output; the corresponding output buffer
@@ -46,7 +78,7 @@ std::pair<std::vector<std::shared_ptr<MemChunk>>, std::list<Shim::AliasUpdate>>
           throw error::NotFound{"Missing program output: " + alloc.output};
         }
         std::shared_ptr<Buffer> output_buffer = Buffer::Downcast(oit->second, program->devinfo());
-        updates.emplace_back(Shim::AliasUpdate{std::move(output_buffer), chunk});
+        updates.emplace_back(Shim::AliasUpdate{std::move(output_buffer), chunk, alloc.output});
       }
     } else if (alloc.is_output()) {
       // This is a program output, but not a program input.  So we'll be creating a new chunk
@@ -58,7 +90,7 @@ std::pair<std::vector<std::shared_ptr<MemChunk>>, std::list<Shim::AliasUpdate>>
       }
       std::shared_ptr<Buffer> output_buffer = Buffer::Downcast(oit->second, program->devinfo());
       chunk = program->output_mem_strategy()->MakeChunk(ctx, output_buffer->size());
-      updates.emplace_back(Shim::AliasUpdate{std::move(output_buffer), chunk});
+      updates.emplace_back(Shim::AliasUpdate{std::move(output_buffer), chunk, alloc.output});
     } else {
       // This is neither a program input nor a program output; the alloc is purely internal
       // to the program.  Make a temporary buffer for it.
@@ -75,10 +107,28 @@ std::pair<std::vector<std::shared_ptr<MemChunk>>, std::list<Shim::AliasUpdate>>
 Shim::Shim(                                   //
     const context::Context& ctx,              //
     const std::shared_ptr<Program>& program,  //
+    const schedule::Schedule& schedule,       //
     std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
     std::map<std::string, std::shared_ptr<tile::Buffer>> outputs)
-    : program_{program} {
-  std::tie(chunk_infos_, updates_) = BuildChunkMap(ctx, program.get(), inputs, outputs);
+    : ctx_{ctx}, program_{program} {
+  std::tie(chunk_infos_, updates_) = BuildChunkMap(ctx, program.get(), schedule, inputs, outputs);
+  auto* audit = BindingAudit::Instance();
+  if (audit->enabled()) {
+    audit_hash_ = audit->SampleContents();
+    std::size_t idx = 0;
+    for (const auto& alloc : schedule.allocs) {
+      const auto& chunk = chunk_infos_[idx];
+      std::uint64_t hash = 0;
+      if (audit_hash_ && alloc.is_input() && chunk) {
+        // Sampled run: fingerprint the input contents as bound, so a later
+        // misbinding report can say what data actually went in.
+        hash = BindingAudit::HashContents(ctx, chunk.get());
+      }
+      audit->LogBinding(this, program_.get(), idx, alloc.is_input() ? alloc.input : alloc.output, chunk.get(), hash,
+                        /* on_exit = */ false);
+      ++idx;
+    }
+  }
 }
 
 Shim::~Shim() {
@@ -94,6 +144,13 @@ std::shared_ptr<MemChunk> Shim::LookupAlloc(std::size_t /* sidx */, schedule::Al
 }
 
 void Shim::SetLaunchException(std::exception_ptr ep) const noexcept {
+  // A failed launch is exactly when the binding trail matters: dump the
+  // retained window before poisoning the outputs.
+  if (BindingAudit::Instance()->enabled()) {
+    std::ostringstream ss;
+    DumpBindingAudit(ss);
+    LOG(ERROR) << "Program launch failed; recent buffer bindings:\n" << ss.str();
+  }
   // Any error in the launch poisons all output buffers.
   for (const auto& chunk : chunk_infos_) {
     chunk->deps()->Poison(ep);
@@ -102,7 +159,16 @@ void Shim::SetLaunchException(std::exception_ptr ep) const noexcept {
 
 void Shim::OnLaunchSuccess() noexcept {
   // Apply updates to outputs.
+  auto* audit = BindingAudit::Instance();
   for (const auto& update : updates_) {
+    if (audit->enabled()) {
+      std::uint64_t hash = 0;
+      if (audit_hash_) {
+        // Waits for the output's producer; only sampled runs pay this.
+        hash = BindingAudit::HashContents(ctx_, update.chunk.get());
+      }
+      audit->LogBinding(this, program_.get(), 0, update.name, update.chunk.get(), hash, /* on_exit = */ true);
+    }
     update.buffer->RemapTo(std::move(update.chunk));
   }
 }
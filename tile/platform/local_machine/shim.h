@@ -28,13 +28,16 @@ class Shim {
   struct AliasUpdate {
     std::shared_ptr<Buffer> buffer;
     std::shared_ptr<MemChunk> chunk;
+    std::string name;  // the program output being remapped
   };
 
   // Construct the Shim.  This should be done at the start of queueing
-  // the program's steps.
+  // the program's steps.  The schedule must be the one the run executes
+  // (a program may carry several at different memory budgets).
   Shim(                                         //
       const context::Context& ctx,              //
       const std::shared_ptr<Program>& program,  //
+      const schedule::Schedule& schedule,       //
       std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
       std::map<std::string, std::shared_ptr<tile::Buffer>> outputs);
 
@@ -53,9 +56,12 @@ class Shim {
   void OnLaunchSuccess() noexcept;
 
  private:
+  context::Context ctx_;
   std::vector<std::shared_ptr<MemChunk>> chunk_infos_;
   std::list<AliasUpdate> updates_;
   std::shared_ptr<Program> program_;
+  // True when this run was picked for content hashing by the binding audit.
+  bool audit_hash_ = false;
 };
 
 }  // namespace local_machine
@@ -0,0 +1,61 @@
+// Copyright 2020, Intel Corporation.
+
+#include "tile/platform/local_machine/submit_queue.h"
+
+#include <algorithm>
+
+#include "base/util/env.h"
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+SubmitQueue::Priority SubmitQueue::FromEnv() {
+  auto value = env::Get("PLAIDML_PROGRAM_PRIORITY");
+  if (value == "high") {
+    return Priority{2, 16};
+  }
+  if (value == "low") {
+    return Priority{0, 1};
+  }
+  return Priority{1, 4};
+}
+
+SubmitQueue::Ticket::Ticket(SubmitQueue* queue, Priority priority)  //
+    : queue_(queue), priority_(priority) {
+  std::lock_guard<std::mutex> lock{queue_->mu_};
+  vtime_ = queue_->clock_;
+}
+
+void SubmitQueue::Ticket::Yield() {
+  std::unique_lock<std::mutex> lock{queue_->mu_};
+  queue_->waiting_.insert(this);
+  queue_->cv_.wait(lock, [&]() { return queue_->IsHead(this); });
+  queue_->waiting_.erase(this);
+  // Charge one kernel at this ticket's weight; catching the virtual clock
+  // up first keeps a run that sat idle from replaying its unused share.
+  vtime_ = std::max(vtime_, queue_->clock_);
+  queue_->clock_ = vtime_;
+  vtime_ += 1.0 / priority_.weight;
+  queue_->cv_.notify_all();
+}
+
+bool SubmitQueue::IsHead(Ticket* ticket) {
+  for (auto* other : waiting_) {
+    if (other == ticket) {
+      continue;
+    }
+    if (other->priority_.cls > ticket->priority_.cls) {
+      return false;
+    }
+    if (other->priority_.cls == ticket->priority_.cls &&
+        (other->vtime_ < ticket->vtime_ || (other->vtime_ == ticket->vtime_ && other < ticket))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,70 @@
+// Copyright 2020, Intel Corporation.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+namespace vertexai {
+namespace tile {
+namespace local_machine {
+
+// A cooperative submission scheduler for a device shared by several
+// Programs.  Without it, concurrent runs race their kernel enqueues and the
+// driver interleaves them arbitrarily, so a latency-critical program can
+// starve behind a batch job's deep queue.  Each run holds a Ticket and
+// yields it at every kernel boundary; the queue admits the waiting ticket
+// with the highest priority class, breaking ties by weighted-fair virtual
+// time.  A higher-class run therefore waits for at most one kernel of a
+// lower-class run (the preemption grain), while equal-class runs share the
+// device in proportion to their weights.  Admission orders enqueues only;
+// the device still executes asynchronously behind the HAL queues.
+class SubmitQueue {
+ public:
+  // A priority class and its fair-share weight within the class's
+  // competition against equal-class runs.
+  struct Priority {
+    int cls;
+    std::uint64_t weight;
+  };
+
+  // Reads PLAIDML_PROGRAM_PRIORITY ("high", "normal" (default), or "low"),
+  // letting a process class its programs as they're built.
+  static Priority FromEnv();
+
+  // One run's claim on the queue, held for the duration of a submission.
+  class Ticket {
+   public:
+    Ticket(SubmitQueue* queue, Priority priority);
+    Ticket(const Ticket&) = delete;
+    Ticket& operator=(const Ticket&) = delete;
+
+    // Blocks until this run may enqueue its next step: the preemption
+    // point at a kernel boundary.
+    void Yield();
+
+   private:
+    friend class SubmitQueue;
+
+    SubmitQueue* queue_;
+    Priority priority_;
+    double vtime_;
+  };
+
+ private:
+  bool IsHead(Ticket* ticket);
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::set<Ticket*> waiting_;
+  // The virtual time of the most recent admission; newly-created and idle
+  // tickets are brought forward to it so a long-idle run can't claim the
+  // device for its whole backlog at once.
+  double clock_ = 0.0;
+};
+
+}  // namespace local_machine
+}  // namespace tile
+}  // namespace vertexai
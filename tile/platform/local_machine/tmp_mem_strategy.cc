@@ -61,8 +61,21 @@ TmpMemStrategy::TmpMemStrategy(const std::shared_ptr<DevInfo>& devinfo, hal::Mem
 std::shared_ptr<MemChunk> TmpMemStrategy::MakeChunk(const context::Context& ctx, std::uint64_t size) const {
   auto hal_buffer = cache_->TryAlloc(size);
   if (!hal_buffer) {
-    auto buffer = source_->MakeBuffer(size, hal::BufferAccessMask::DEVICE_RW);
-    hal_buffer = buffer;
+    // Allocate at size-class granularity so the buffer is reusable for
+    // any later request in the same class.
+    std::size_t alloc_size = MemCache::AllocSize(size);
+    try {
+      hal_buffer = source_->MakeBuffer(alloc_size, hal::BufferAccessMask::DEVICE_RW);
+    } catch (...) {
+      // The device may be out of memory only because the cache's
+      // freelists have pinned allocations in other size classes.  Hand
+      // everything cached back to the device and try once more before
+      // reporting failure.
+      if (!cache_->Flush()) {
+        throw;
+      }
+      hal_buffer = source_->MakeBuffer(alloc_size, hal::BufferAccessMask::DEVICE_RW);
+    }
   }
   return std::make_shared<TmpMemChunk>(size, cache_, std::move(hal_buffer));
 }
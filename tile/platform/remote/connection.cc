@@ -0,0 +1,174 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/platform/remote/connection.h"
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+#ifndef _WIN32
+
+namespace {
+
+constexpr size_t kMaxFrameSize = 1ull << 31;  // Large enough for any tensor we ship.
+
+}  // namespace
+
+std::shared_ptr<Connection> Connection::Connect(const std::string& address) {
+  auto colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    throw std::runtime_error("remote: address must be host:port, got \"" + address + "\"");
+  }
+  std::string host = address.substr(0, colon);
+  std::string port = address.substr(colon + 1);
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* result = nullptr;
+  int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+  if (rc != 0) {
+    throw std::runtime_error("remote: unable to resolve \"" + address + "\": " + gai_strerror(rc));
+  }
+
+  int fd = -1;
+  for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  if (fd < 0) {
+    throw std::runtime_error("remote: unable to connect to \"" + address + "\"");
+  }
+
+  // Frames are already batched; don't let Nagle delay small control frames.
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  return std::make_shared<Connection>(fd);
+}
+
+Connection::Connection(int fd) : fd_{fd} {}
+
+Connection::~Connection() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void Connection::WriteAll(const char* buf, size_t len) {
+  while (len) {
+    ssize_t n = write(fd_, buf, len);
+    if (n <= 0) {
+      throw std::runtime_error("remote: connection write failed: " + std::string(strerror(errno)));
+    }
+    buf += n;
+    len -= n;
+  }
+}
+
+bool Connection::ReadAll(char* buf, size_t len) {
+  size_t got = 0;
+  while (got < len) {
+    ssize_t n = read(fd_, buf + got, len - got);
+    if (n == 0) {
+      if (got == 0) {
+        return false;  // Clean shutdown at a frame boundary.
+      }
+      throw std::runtime_error("remote: connection closed mid-frame");
+    }
+    if (n < 0) {
+      throw std::runtime_error("remote: connection read failed: " + std::string(strerror(errno)));
+    }
+    got += n;
+  }
+  return true;
+}
+
+void Connection::Send(const google::protobuf::MessageLite& msg) {
+  std::string payload;
+  if (!msg.SerializeToString(&payload)) {
+    throw std::runtime_error("remote: unable to serialize message");
+  }
+  char hdr[4];
+  uint32_t len = payload.size();
+  hdr[0] = len & 0xFF;
+  hdr[1] = (len >> 8) & 0xFF;
+  hdr[2] = (len >> 16) & 0xFF;
+  hdr[3] = (len >> 24) & 0xFF;
+  WriteAll(hdr, sizeof(hdr));
+  WriteAll(payload.data(), payload.size());
+}
+
+bool Connection::Recv(google::protobuf::MessageLite* msg) {
+  char hdr[4];
+  if (!ReadAll(hdr, sizeof(hdr))) {
+    return false;
+  }
+  uint32_t len = static_cast<uint8_t>(hdr[0]) | (static_cast<uint8_t>(hdr[1]) << 8) |
+                 (static_cast<uint8_t>(hdr[2]) << 16) | (static_cast<uint8_t>(hdr[3]) << 24);
+  if (len >= kMaxFrameSize) {
+    throw std::runtime_error("remote: oversized frame");
+  }
+  std::vector<char> payload(len);
+  if (!ReadAll(payload.data(), payload.size())) {
+    throw std::runtime_error("remote: connection closed mid-frame");
+  }
+  if (!msg->ParseFromArray(payload.data(), payload.size())) {
+    throw std::runtime_error("remote: unable to parse message");
+  }
+  return true;
+}
+
+void Connection::Roundtrip(const proto::Request& req, proto::Response* resp) {
+  std::lock_guard<std::mutex> lock{mu_};
+  Send(req);
+  if (!Recv(resp)) {
+    throw std::runtime_error("remote: server closed the connection");
+  }
+  if (!resp->error().empty()) {
+    throw std::runtime_error("remote: " + resp->error());
+  }
+}
+
+#else  // _WIN32
+
+std::shared_ptr<Connection> Connection::Connect(const std::string& address) {
+  throw std::runtime_error("remote: not supported on this platform");
+}
+
+Connection::Connection(int fd) : fd_{fd} {}
+Connection::~Connection() {}
+void Connection::WriteAll(const char* buf, size_t len) {}
+bool Connection::ReadAll(char* buf, size_t len) { return false; }
+void Connection::Send(const google::protobuf::MessageLite& msg) {}
+bool Connection::Recv(google::protobuf::MessageLite* msg) { return false; }
+void Connection::Roundtrip(const proto::Request& req, proto::Response* resp) {}
+
+#endif  // _WIN32
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
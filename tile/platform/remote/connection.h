@@ -0,0 +1,55 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "tile/platform/remote/remote.pb.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+// A framed protobuf channel over a stream socket.  Frames are a
+// little-endian uint32 payload length followed by the encoded message.
+// Send/Recv are individually safe to call from one thread each; Roundtrip
+// serializes whole request/response exchanges so multiple buffers and
+// programs can share one session.
+class Connection {
+ public:
+  // Connects to a "host:port" address.  Throws std::runtime_error on
+  // resolution or connection failure.
+  static std::shared_ptr<Connection> Connect(const std::string& address);
+
+  // Takes ownership of an already-connected socket (server side).
+  explicit Connection(int fd);
+  ~Connection();
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  // Sends one framed message.  Throws std::runtime_error on I/O failure.
+  void Send(const google::protobuf::MessageLite& msg);
+
+  // Receives one framed message.  Returns false on clean remote shutdown;
+  // throws std::runtime_error on I/O or decode failure.
+  bool Recv(google::protobuf::MessageLite* msg);
+
+  // Sends a request and waits for its response as one atomic exchange.
+  // Throws std::runtime_error on transport failure or if the server
+  // reports an error.
+  void Roundtrip(const proto::Request& req, proto::Response* resp);
+
+ private:
+  void WriteAll(const char* buf, size_t len);
+  bool ReadAll(char* buf, size_t len);
+
+  int fd_ = -1;
+  std::mutex mu_;
+};
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,24 @@
+// Copyright 2019, Intel Corporation.
+
+#include "base/util/any_factory_map.h"
+#include "base/util/compat.h"
+#include "tile/platform/remote/platform.h"
+#include "tile/platform/remote/remote.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+std::unique_ptr<tile::Platform> PlatformFactory::MakeTypedInstance(const context::Context& ctx,
+                                                                   const proto::Platform& config) {
+  return std::make_unique<Platform>(config);
+}
+
+[[gnu::unused]] char reg = []() -> char {
+  AnyFactoryMap<tile::Platform>::Instance()->Register(std::make_unique<PlatformFactory>());
+  return 0;
+}();
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,229 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/platform/remote/platform.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+namespace {
+
+// A host-side shadow of a remote buffer's bytes; WriteBack ships the whole
+// contents back to the server.
+class RemoteView final : public View {
+ public:
+  RemoteView(const std::shared_ptr<Connection>& conn, uint64_t id, std::vector<char> data)
+      : conn_{conn}, id_{id}, data_{std::move(data)} {
+    set_contents(data_.data(), data_.size());
+  }
+
+  void WriteBack(const context::Context& ctx) final {
+    proto::Request req;
+    req.mutable_write_buffer()->set_id(id_);
+    req.mutable_write_buffer()->set_data(data_.data(), data_.size());
+    proto::Response resp;
+    conn_->Roundtrip(req, &resp);
+  }
+
+ private:
+  std::shared_ptr<Connection> conn_;
+  uint64_t id_;
+  std::vector<char> data_;
+};
+
+uint64_t AllocRemote(const std::shared_ptr<Connection>& conn, const std::string& device, uint64_t size) {
+  proto::Request req;
+  req.mutable_alloc_buffer()->set_device(device);
+  req.mutable_alloc_buffer()->set_size(size);
+  proto::Response resp;
+  conn->Roundtrip(req, &resp);
+  return resp.buffer_allocated().id();
+}
+
+void FreeRemote(const std::shared_ptr<Connection>& conn, uint64_t id) noexcept {
+  try {
+    proto::Request req;
+    req.mutable_free_buffer()->set_id(id);
+    proto::Response resp;
+    conn->Roundtrip(req, &resp);
+  } catch (const std::exception& ex) {
+    // The session teardown will reclaim the buffer; don't propagate from here.
+    IVLOG(1, "remote: failed to free buffer " << id << ": " << ex.what());
+  }
+}
+
+}  // namespace
+
+Platform::Platform(const proto::Platform& config) : conn_{Connection::Connect(config.address())} {}
+
+std::shared_ptr<tile::Buffer> Platform::MakeBuffer(  //
+    const context::Context& ctx,                     //
+    const std::string& device,                       //
+    std::uint64_t size) {
+  return std::make_shared<RemoteBuffer>(conn_, AllocRemote(conn_, device, size), size);
+}
+
+std::shared_ptr<tile::Program> Platform::MakeProgram(  //
+    const context::Context& ctx,                       //
+    const tile::proto::Program& program,               //
+    ConstBufferManager* const_bufs) {
+  proto::Request req;
+  *req.mutable_make_program()->mutable_program() = program;
+  proto::Response resp;
+  conn_->Roundtrip(req, &resp);
+  return std::make_shared<RemoteProgram>(conn_, resp.program_made().id(), resp.program_made().max_available_memory());
+}
+
+void Platform::ListDevices(                          //
+    const context::Context& ctx,                     //
+    const tile::proto::ListDevicesRequest& request,  //
+    tile::proto::ListDevicesResponse* response) {
+  proto::Request req;
+  *req.mutable_list_devices()->mutable_request() = request;
+  proto::Response resp;
+  conn_->Roundtrip(req, &resp);
+  *response = resp.devices().response();
+}
+
+void Platform::RegisterCostModel(const lang::TileCostFunction& cost_fn) {
+  // Compilation happens on the server against the server's own cost model;
+  // there's no sound way to ship an arbitrary callback across the wire.
+  IVLOG(1, "remote: ignoring client-side cost model");
+}
+
+std::vector<std::string> Platform::ListDevices() {
+  tile::proto::ListDevicesRequest request;
+  tile::proto::ListDevicesResponse response;
+  context::Context ctx;
+  ListDevices(ctx, request, &response);
+  std::vector<std::string> result;
+  for (const auto& device : response.devices()) {
+    result.push_back(device.dev_id());
+  }
+  return result;
+}
+
+std::shared_ptr<tile::Program> Platform::MakeProgram(  //
+    const context::Context& ctx,                       //
+    const std::string& device,                         //
+    const std::string& target,                         //
+    const std::shared_ptr<stripe::Program>& program,   //
+    ConstBufferManager* const_bufs) {
+  throw std::runtime_error("remote: stripe program submission is not implemented");
+}
+
+RemoteBuffer::RemoteBuffer(const std::shared_ptr<Connection>& conn, uint64_t id, uint64_t size)
+    : conn_{conn}, id_{id}, size_{size} {}
+
+RemoteBuffer::~RemoteBuffer() { FreeRemote(conn_, id_); }
+
+boost::future<std::unique_ptr<View>> RemoteBuffer::MapCurrent(const context::Context& ctx) {
+  proto::Request req;
+  req.mutable_read_buffer()->set_id(id_);
+  proto::Response resp;
+  conn_->Roundtrip(req, &resp);
+  const auto& data = resp.buffer_data().data();
+  std::vector<char> bytes(data.begin(), data.end());
+  bytes.resize(size_);
+  std::unique_ptr<View> view{std::make_unique<RemoteView>(conn_, id_, std::move(bytes))};
+  return boost::make_ready_future(std::move(view));
+}
+
+std::unique_ptr<View> RemoteBuffer::MapDiscard(const context::Context& ctx) {
+  return std::make_unique<RemoteView>(conn_, id_, std::vector<char>(size_));
+}
+
+RemoteProgram::RemoteProgram(const std::shared_ptr<Connection>& conn, uint64_t id, std::size_t max_available_memory)
+    : conn_{conn}, id_{id}, max_available_memory_{max_available_memory} {}
+
+boost::future<void> RemoteProgram::Run(  //
+    const context::Context& ctx,         //
+    std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
+    std::map<std::string, std::shared_ptr<tile::Buffer>> outputs) {
+  try {
+    proto::Request req;
+    auto* run = req.mutable_run_program();
+    run->set_id(id_);
+
+    // Bindings backed by remote buffers ship as bare handles.  Anything
+    // else (e.g. adopted host memory) is staged through a transient remote
+    // buffer for the duration of the run.
+    struct Staged {
+      std::shared_ptr<tile::Buffer> local;
+      uint64_t remote_id;
+    };
+    std::vector<Staged> staged_outputs;
+    std::vector<uint64_t> transients;
+
+    auto bind = [&](const std::pair<const std::string, std::shared_ptr<tile::Buffer>>& kvp, bool is_input) {
+      auto remote = std::dynamic_pointer_cast<RemoteBuffer>(kvp.second);
+      if (remote && remote->conn() == conn_) {
+        return remote->id();
+      }
+      uint64_t rid = AllocRemote(conn_, "", kvp.second->size());
+      transients.push_back(rid);
+      if (is_input) {
+        auto view = kvp.second->MapCurrent(ctx).get();
+        proto::Request wreq;
+        wreq.mutable_write_buffer()->set_id(rid);
+        wreq.mutable_write_buffer()->set_data(view->data(), view->size());
+        proto::Response wresp;
+        conn_->Roundtrip(wreq, &wresp);
+      } else {
+        staged_outputs.push_back(Staged{kvp.second, rid});
+      }
+      return rid;
+    };
+
+    for (const auto& kvp : inputs) {
+      (*run->mutable_inputs())[kvp.first] = bind(kvp, true);
+    }
+    for (const auto& kvp : outputs) {
+      (*run->mutable_outputs())[kvp.first] = bind(kvp, false);
+    }
+
+    proto::Response resp;
+    conn_->Roundtrip(req, &resp);
+
+    for (const auto& out : staged_outputs) {
+      proto::Request rreq;
+      rreq.mutable_read_buffer()->set_id(out.remote_id);
+      proto::Response rresp;
+      conn_->Roundtrip(rreq, &rresp);
+      auto view = out.local->MapDiscard(ctx);
+      const auto& data = rresp.buffer_data().data();
+      std::memcpy(view->data(), data.data(), std::min<size_t>(data.size(), view->size()));
+      view->WriteBack(ctx);
+    }
+    for (uint64_t rid : transients) {
+      FreeRemote(conn_, rid);
+    }
+    return boost::make_ready_future();
+  } catch (...) {
+    boost::promise<void> prom;
+    prom.set_exception(boost::current_exception());
+    return prom.get_future();
+  }
+}
+
+void RemoteProgram::Release() {
+  try {
+    proto::Request req;
+    req.mutable_release_program()->set_id(id_);
+    proto::Response resp;
+    conn_->Roundtrip(req, &resp);
+  } catch (const std::exception& ex) {
+    IVLOG(1, "remote: failed to release program " << id_ << ": " << ex.what());
+  }
+}
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,102 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tile/base/platform.h"
+#include "tile/platform/remote/connection.h"
+#include "tile/platform/remote/remote.pb.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+// The remote Platform implementation.
+//
+// Platform proxies every operation over one persistent session to a tile
+// server (see server.h), so a single coordinator process can drive devices
+// on other hosts: programs are submitted once in serialized form, buffers
+// live on the server for their whole lifetime, and Run() ships only buffer
+// handles.  Tensor bytes cross the wire only when a buffer is explicitly
+// mapped on this side, or when a Run() binding is backed by host memory
+// rather than a remote buffer.
+class Platform final : public tile::Platform {
+ public:
+  explicit Platform(const proto::Platform& config);
+
+  std::shared_ptr<tile::Buffer> MakeBuffer(  //
+      const context::Context& ctx,           //
+      const std::string& device,             //
+      std::uint64_t size) final;
+
+  std::shared_ptr<tile::Program> MakeProgram(  //
+      const context::Context& ctx,             //
+      const tile::proto::Program& program,     //
+      ConstBufferManager* const_bufs) final;
+
+  void ListDevices(                                    //
+      const context::Context& ctx,                     //
+      const tile::proto::ListDevicesRequest& request,  //
+      tile::proto::ListDevicesResponse* response) final;
+
+  void RegisterCostModel(const lang::TileCostFunction& cost_fn) final;
+
+  std::vector<std::string> ListDevices() final;
+
+  std::shared_ptr<tile::Program> MakeProgram(          //
+      const context::Context& ctx,                     //
+      const std::string& device,                       //
+      const std::string& target,                       //
+      const std::shared_ptr<stripe::Program>& program, //
+      ConstBufferManager* const_bufs) final;
+
+ private:
+  std::shared_ptr<Connection> conn_;
+};
+
+// A buffer resident on the server, identified by its session handle.
+// Mapping transfers the whole contents; Run() bindings transfer nothing.
+class RemoteBuffer final : public tile::Buffer {
+ public:
+  RemoteBuffer(const std::shared_ptr<Connection>& conn, uint64_t id, uint64_t size);
+  ~RemoteBuffer();
+
+  uint64_t size() const final { return size_; }
+  boost::future<std::unique_ptr<View>> MapCurrent(const context::Context& ctx) final;
+  std::unique_ptr<View> MapDiscard(const context::Context& ctx) final;
+
+  uint64_t id() const { return id_; }
+  const std::shared_ptr<Connection>& conn() const { return conn_; }
+
+ private:
+  std::shared_ptr<Connection> conn_;
+  uint64_t id_;
+  uint64_t size_;
+};
+
+// A program compiled and held by the server.
+class RemoteProgram final : public tile::Program {
+ public:
+  RemoteProgram(const std::shared_ptr<Connection>& conn, uint64_t id, std::size_t max_available_memory);
+
+  boost::future<void> Run(        //
+      const context::Context& ctx,  //
+      std::map<std::string, std::shared_ptr<tile::Buffer>> inputs,
+      std::map<std::string, std::shared_ptr<tile::Buffer>> outputs) final;
+
+  std::size_t MaxAvailableMemory() final { return max_available_memory_; }
+  void Release() final;
+
+ private:
+  std::shared_ptr<Connection> conn_;
+  uint64_t id_;
+  std::size_t max_available_memory_;
+};
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,23 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <memory>
+
+#include "base/util/any_factory.h"
+#include "tile/base/platform.h"
+#include "tile/platform/remote/remote.pb.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+class PlatformFactory final : public TypedAnyFactory<tile::Platform, proto::Platform> {
+ public:
+  std::unique_ptr<tile::Platform> MakeTypedInstance(const context::Context& ctx,
+                                                    const proto::Platform& config) override;
+};
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,176 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/platform/remote/server.h"
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "base/util/logging.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+// Per-connection state: the session's buffer and program handle tables.
+class Server::Session {
+ public:
+  Session(const std::shared_ptr<tile::Platform>& platform, const std::shared_ptr<Connection>& conn)
+      : platform_{platform}, conn_{conn} {}
+
+  void Run() {
+    proto::Request req;
+    while (conn_->Recv(&req)) {
+      proto::Response resp;
+      try {
+        Dispatch(req, &resp);
+      } catch (const std::exception& ex) {
+        resp.Clear();
+        resp.set_error(ex.what());
+      }
+      conn_->Send(resp);
+    }
+  }
+
+ private:
+  void Dispatch(const proto::Request& req, proto::Response* resp) {
+    context::Context ctx;
+    switch (req.op_case()) {
+      case proto::Request::kAllocBuffer: {
+        uint64_t id = next_id_++;
+        buffers_[id] = platform_->MakeBuffer(ctx, req.alloc_buffer().device(), req.alloc_buffer().size());
+        resp->mutable_buffer_allocated()->set_id(id);
+        break;
+      }
+      case proto::Request::kFreeBuffer:
+        buffers_.erase(req.free_buffer().id());
+        resp->mutable_done();
+        break;
+      case proto::Request::kWriteBuffer: {
+        auto view = Buffer(req.write_buffer().id())->MapDiscard(ctx);
+        const auto& data = req.write_buffer().data();
+        std::memcpy(view->data(), data.data(), std::min<size_t>(data.size(), view->size()));
+        view->WriteBack(ctx);
+        resp->mutable_done();
+        break;
+      }
+      case proto::Request::kReadBuffer: {
+        auto view = Buffer(req.read_buffer().id())->MapCurrent(ctx).get();
+        resp->mutable_buffer_data()->set_data(view->data(), view->size());
+        break;
+      }
+      case proto::Request::kMakeProgram: {
+        ConstBufferManager cbm;
+        auto program = platform_->MakeProgram(ctx, req.make_program().program(), &cbm);
+        uint64_t id = next_id_++;
+        programs_[id] = program;
+        resp->mutable_program_made()->set_id(id);
+        resp->mutable_program_made()->set_max_available_memory(program->MaxAvailableMemory());
+        break;
+      }
+      case proto::Request::kReleaseProgram: {
+        auto it = programs_.find(req.release_program().id());
+        if (it != programs_.end()) {
+          it->second->Release();
+          programs_.erase(it);
+        }
+        resp->mutable_done();
+        break;
+      }
+      case proto::Request::kRunProgram: {
+        auto it = programs_.find(req.run_program().id());
+        if (it == programs_.end()) {
+          throw std::runtime_error("no such program: " + std::to_string(req.run_program().id()));
+        }
+        std::map<std::string, std::shared_ptr<tile::Buffer>> inputs;
+        for (const auto& kvp : req.run_program().inputs()) {
+          inputs[kvp.first] = Buffer(kvp.second);
+        }
+        std::map<std::string, std::shared_ptr<tile::Buffer>> outputs;
+        for (const auto& kvp : req.run_program().outputs()) {
+          outputs[kvp.first] = Buffer(kvp.second);
+        }
+        it->second->Run(ctx, std::move(inputs), std::move(outputs)).get();
+        resp->mutable_done();
+        break;
+      }
+      case proto::Request::kListDevices:
+        platform_->ListDevices(ctx, req.list_devices().request(), resp->mutable_devices()->mutable_response());
+        break;
+      default:
+        throw std::runtime_error("unrecognized request");
+    }
+  }
+
+  std::shared_ptr<tile::Buffer> Buffer(uint64_t id) {
+    auto it = buffers_.find(id);
+    if (it == buffers_.end()) {
+      throw std::runtime_error("no such buffer: " + std::to_string(id));
+    }
+    return it->second;
+  }
+
+  std::shared_ptr<tile::Platform> platform_;
+  std::shared_ptr<Connection> conn_;
+  uint64_t next_id_ = 1;
+  std::map<uint64_t, std::shared_ptr<tile::Buffer>> buffers_;
+  std::map<uint64_t, std::shared_ptr<tile::Program>> programs_;
+};
+
+Server::Server(const std::shared_ptr<tile::Platform>& platform) : platform_{platform} {}
+
+void Server::HandleSession(const std::shared_ptr<Connection>& conn) {
+  try {
+    Session{platform_, conn}.Run();
+  } catch (const std::exception& ex) {
+    LOG(WARNING) << "remote: session ended: " << ex.what();
+  }
+}
+
+#ifndef _WIN32
+
+void Server::Serve(uint16_t port) {
+  int fd = socket(AF_INET6, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw std::runtime_error("remote: unable to create listening socket");
+  }
+  int zero = 0;
+  setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in6 addr = {};
+  addr.sin6_family = AF_INET6;
+  addr.sin6_addr = in6addr_any;
+  addr.sin6_port = htons(port);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+    close(fd);
+    throw std::runtime_error("remote: unable to listen on port " + std::to_string(port));
+  }
+  LOG(INFO) << "remote: serving on port " << port;
+  for (;;) {
+    int client = accept(fd, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    auto conn = std::make_shared<Connection>(client);
+    std::thread{[this, conn]() { HandleSession(conn); }}.detach();
+  }
+}
+
+#else  // _WIN32
+
+void Server::Serve(uint16_t port) { throw std::runtime_error("remote: not supported on this platform"); }
+
+#endif  // _WIN32
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,40 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "tile/base/platform.h"
+#include "tile/platform/remote/connection.h"
+#include "tile/platform/remote/remote.pb.h"
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+
+// Serves a local Platform to remote coordinators.
+//
+// Each accepted connection is a persistent session handled on its own
+// thread; buffer and program handles are scoped to the session and released
+// when it ends, so a dropped coordinator can't leak device memory.
+class Server final {
+ public:
+  explicit Server(const std::shared_ptr<tile::Platform>& platform);
+
+  // Accepts and serves connections on the given port; does not return.
+  // Throws std::runtime_error if the listening socket can't be set up.
+  void Serve(uint16_t port);
+
+  // Serves one session until the peer disconnects.  Exposed for testing.
+  void HandleSession(const std::shared_ptr<Connection>& conn);
+
+ private:
+  class Session;
+
+  std::shared_ptr<tile::Platform> platform_;
+};
+
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,72 @@
+// Copyright 2019, Intel Corporation.
+
+// Serves a locally-configured Platform to remote coordinators; see
+// server.h for the session model and remote.proto for the wire format.
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <google/protobuf/any.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <boost/program_options.hpp>
+
+#include "base/util/any_factory_map.h"
+#include "base/util/file.h"
+#include "base/util/logging.h"
+#include "tile/platform/remote/server.h"
+
+namespace po = boost::program_options;
+
+namespace vertexai {
+namespace tile {
+namespace remote {
+namespace {
+
+int Main(int argc, char* argv[]) {
+  po::options_description opts{"Allowed options"};
+  opts.add_options()                                                                                    //
+      ("help,h", "produce help message")                                                                //
+      ("port", po::value<uint16_t>()->default_value(41600), "port to listen on")                        //
+      ("config", po::value<std::string>()->required(),
+       "path to a text-format google.protobuf.Any platform config (as in the \"platform\" field of a "
+       "PlaidML config file)");
+  po::variables_map args;
+  po::store(po::command_line_parser(argc, argv).options(opts).run(), args);
+  if (args.count("help")) {
+    std::cout << opts << std::endl;
+    return 0;
+  }
+  po::notify(args);
+
+  google::protobuf::Any config;
+  auto text = ReadFile(args["config"].as<std::string>());
+  if (!google::protobuf::TextFormat::ParseFromString(text, &config)) {
+    throw std::runtime_error("unable to parse platform config");
+  }
+
+  context::Context ctx;
+  std::shared_ptr<tile::Platform> platform{AnyFactoryMap<tile::Platform>::Instance()->MakeInstance(ctx, config)};
+  Server server{platform};
+  server.Serve(args["port"].as<uint16_t>());
+  return 0;
+}
+
+}  // namespace
+}  // namespace remote
+}  // namespace tile
+}  // namespace vertexai
+
+int main(int argc, char* argv[]) {
+  try {
+    START_EASYLOGGINGPP(argc, argv);
+    return vertexai::tile::remote::Main(argc, argv);
+  } catch (const std::exception& ex) {
+    std::cerr << "Caught unhandled exception: " << ex.what() << std::endl;
+    return -1;
+  } catch (...) {
+    std::cerr << "Caught unhandled exception" << std::endl;
+    return -1;
+  }
+}
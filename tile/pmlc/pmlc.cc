@@ -2,10 +2,19 @@
 
 #include "tile/pmlc/pmlc.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <list>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 
 #include "base/config/config.h"
 #include "base/util/file.h"
@@ -15,6 +24,7 @@
 #include "tile/lib/tests.h"
 #ifdef ENABLE_LLVM_BITCODE
 #include "tile/targets/cpu/jit.h"
+#include "tile/targets/cpu/profile_report.h"
 #endif
 #include "tile/util/tile_file.h"
 
@@ -49,6 +59,10 @@ bool App::parse(int argc, char* argv[]) {
   if (args.count("verbose")) {
     el::Loggers::setVerboseLevel(args["verbose"].as<int>());
   }
+  if (args.count("expand-dump")) {
+    // Reconstruction mode; the compile options aren't required
+    return true;
+  }
   args.notify();
   return true;
 }
@@ -66,8 +80,19 @@ bool App::parse(int argc, char* argv[]) {
       ("internal", "input specifies an internally defined network")                       //
       ("dump-passes", "dump passes in *.txt format")                                      //
       ("dump-passes-proto", "dump passes in *.pb format")                                 //
+      ("dump-passes-deltas", "dump passes as compressed *.pbz deltas")                    //
+      ("expand-dump", po::value<fs::path>(), "expand a *.pbz pass dump to *.txt")         //
 #ifdef ENABLE_LLVM_BITCODE
-      ("llvm", "enable LLVM bitcode output")  //
+      ("llvm", "enable LLVM bitcode output")                                           //
+      ("profile", "run the CPU JIT with block profiling and write profile.txt")        //
+      ("profile-clock-ghz", po::value<double>()->default_value(0.0),                   //
+       "TSC rate used to turn profile cycles into time/throughput (0 = cycles only)")  //
+      ("profile-peak-gbps", po::value<double>()->default_value(0.0),                   //
+       "memory bandwidth peak, e.g. a measured STREAM number, for profile ratios")     //
+      ("bench", po::value<size_t>(),                                                   //
+       "run the compiled program N times on the CPU JIT and report the median")        //
+      ("bench-flush-mb", po::value<size_t>()->default_value(64),                       //
+       "stream this many MB between timed runs to flush caches (0 = hot-cache)")       //
 #endif
       ;  // NOLINT
   return 0;
@@ -84,6 +109,27 @@ lang::RunInfo LoadTile(const fs::path& filename, bool is_internal) {
   return util::TileFile(filename).Load();
 }
 
+#ifdef ENABLE_LLVM_BITCODE
+// Allocate a buffer per top-level refinement, seeded from any data sections
+// the input supplied (zeroed otherwise).
+std::map<std::string, void*> AllocateBuffers(const Program& program, std::list<std::vector<char>>* storage) {
+  std::map<std::string, void*> buffers;
+  for (const auto& ref : program.entry->refs) {
+    storage->emplace_back(ref.interior_shape.byte_size());
+    auto& buf = storage->back();
+    auto buf_it = program.buffers.find(ref.into());
+    if (buf_it != program.buffers.end()) {
+      auto sec_it = buf_it->second.sections.find("data");
+      if (sec_it != buf_it->second.sections.end() && sec_it->second.size() <= buf.size()) {
+        std::copy(sec_it->second.begin(), sec_it->second.end(), buf.begin());
+      }
+    }
+    buffers[ref.into()] = buf.data();
+  }
+  return buffers;
+}
+#endif
+
 std::shared_ptr<Program> DefaultStage(const App& app,                      //
                                       const fs::path& input_path,          //
                                       const fs::path& out_dir,             //
@@ -123,10 +169,147 @@ std::shared_ptr<Program> DefaultStage(const App& app,                      //
     native.compile(*program->entry, config);
     native.save((out_dir / "stripe.bc").string());
   }
+  if (app.args.count("profile")) {
+    // Run the JIT with block instrumentation enabled.
+    std::list<std::vector<char>> storage;
+    auto buffers = AllocateBuffers(*program, &storage);
+    targets::cpu::JitProfile(program->entry.get(), buffers);
+    targets::cpu::ProfileReportOptions report_options;
+    report_options.clock_ghz = app.args["profile-clock-ghz"].as<double>();
+    report_options.peak_gbps = app.args["profile-peak-gbps"].as<double>();
+    WriteFile(out_dir / "profile.txt", false, [&](std::ofstream& fout) {  //
+      targets::cpu::WriteProfileReport(*program->entry, report_options, fout);
+    });
+  }
+  if (app.args.count("bench")) {
+    size_t runs = std::max<size_t>(1, app.args["bench"].as<size_t>());
+    std::list<std::vector<char>> storage;
+    auto buffers = AllocateBuffers(*program, &storage);
+    // Compile once so the timed loop measures execution, not the JIT.
+    targets::cpu::Native native;
+    targets::cpu::Config config;
+    native.compile(*program->entry, config);
+    native.run(buffers);  // warmup; faults in the buffers and code
+    std::vector<char> flush(app.args["bench-flush-mb"].as<size_t>() << 20);
+    std::vector<double> times_us;
+    times_us.reserve(runs);
+    for (size_t i = 0; i < runs; i++) {
+      // Stream over a buffer larger than the LLC so each timed run starts
+      // cold, the way a kernel does in the middle of a real network.
+      for (size_t j = 0; j < flush.size(); j += 64) {
+        flush[j]++;
+      }
+      auto start = std::chrono::steady_clock::now();
+      native.run(buffers);
+      std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+      times_us.push_back(elapsed.count());
+    }
+    std::sort(times_us.begin(), times_us.end());
+    // Nonparametric 95% confidence interval on the median: the order
+    // statistics at ranks n/2 -/+ 1.96*sqrt(n)/2.
+    double delta = 1.96 * std::sqrt(static_cast<double>(runs)) / 2.0;
+    size_t lo = static_cast<size_t>(std::max(0.0, std::floor(runs / 2.0 - delta)));
+    size_t hi = std::min(runs - 1, static_cast<size_t>(std::ceil(runs / 2.0 + delta)));
+    auto summary = str(boost::format("median %1% us, 95%% CI [%2%, %3%] us over %4% runs")  //
+                       % times_us[runs / 2] % times_us[lo] % times_us[hi] % runs);
+    std::cout << summary << std::endl;
+    WriteFile(out_dir / "bench.txt", false, [&](std::ofstream& fout) {
+      fout << summary << std::endl;
+      for (const auto& time_us : times_us) {
+        fout << time_us << std::endl;
+      }
+    });
+  }
 #endif
   return program;
 }
 
+namespace {
+
+// One *.pbz pass dump: a program shell plus its chunk records
+struct PassDump {
+  stripe::proto::Program shell;
+  std::vector<codegen::proto::Chunk> chunks;
+};
+
+PassDump ReadPassDump(const fs::path& path) {
+  std::ifstream fin(path.string(), std::ifstream::binary);
+  if (!fin) {
+    throw std::runtime_error(str(boost::format("Unable to open pass dump: %1%") % path));
+  }
+  google::protobuf::io::IstreamInputStream iis(&fin);
+  google::protobuf::io::GzipInputStream gzis(&iis);
+  PassDump ret;
+  if (!ReadRecord(&ret.shell, &gzis)) {
+    throw std::runtime_error(str(boost::format("Missing program record in pass dump: %1%") % path));
+  }
+  codegen::proto::Chunk chunk;
+  while (ReadRecord(&chunk, &gzis)) {
+    ret.chunks.emplace_back(std::move(chunk));
+    chunk.Clear();
+  }
+  return ret;
+}
+
+fs::path FindPassDump(const fs::path& dir, size_t pass) {
+  auto prefix = str(boost::format("%02zu_") % pass);
+  for (const auto& entry : fs::directory_iterator(dir)) {
+    auto filename = entry.path().filename().string();
+    if (entry.path().extension() == ".pbz" && filename.compare(0, prefix.size(), prefix) == 0) {
+      return entry.path();
+    }
+  }
+  throw std::runtime_error(str(boost::format("Pass dump %1% not found in %2%") % pass % dir));
+}
+
+}  // namespace
+
+void ExpandPassDump(const fs::path& input) {
+  auto dir = input.parent_path();
+  auto dump = ReadPassDump(input);
+  auto program = FromProto(dump.shell);
+  // Chunks belong to the single inner block (i.e. main) when the program has
+  // the usual program->main shape; see DumpProgram in tile/codegen/driver.cc.
+  Block* into = program->entry.get();
+  std::shared_ptr<Block> inner;
+  if (into->stmts.size() == 1 && (inner = Block::Downcast(*into->stmts.begin()))) {
+    into = inner.get();
+  }
+  // Resolve back-references against their source dumps, loading each
+  // referenced dump at most once
+  std::map<size_t, PassDump> sources;
+  std::vector<StatementIt> stmts;
+  for (const auto& chunk : dump.chunks) {
+    const stripe::proto::Statement* pb_stmt;
+    if (chunk.has_ref()) {
+      auto it = sources.find(chunk.ref().pass());
+      if (it == sources.end()) {
+        auto source = ReadPassDump(FindPassDump(dir, chunk.ref().pass()));
+        it = sources.emplace(chunk.ref().pass(), std::move(source)).first;
+      }
+      const auto& ref_chunk = it->second.chunks.at(chunk.ref().index());
+      if (!ref_chunk.has_full()) {
+        throw std::runtime_error(
+            str(boost::format("Back-reference in pass dump %1% does not point at a full statement") % input));
+      }
+      pb_stmt = &ref_chunk.full();
+    } else {
+      pb_stmt = &chunk.full();
+    }
+    auto stmt = FromProto(*pb_stmt);
+    stmts.push_back(into->stmts.emplace(into->stmts.end(), stmt));
+    for (auto dep_idx : chunk.deps()) {
+      stmt->deps.push_back(stmts[dep_idx]);
+    }
+    SetAttributes(stmt.get(), pb_stmt->attrs());
+  }
+  auto out_path = input;
+  out_path.replace_extension(".txt");
+  WriteFile(out_path, false, [&program](std::ofstream& fout) {  //
+    fout << *program->entry << std::endl;
+  });
+}
+
 codegen::proto::Configs LoadConfigs() {
   auto app = App::Instance();
   auto config_path = app->args["config"].as<fs::path>();
@@ -136,6 +319,10 @@ codegen::proto::Configs LoadConfigs() {
 
 std::shared_ptr<Program> Main() {
   auto app = App::Instance();
+  if (app->args.count("expand-dump")) {
+    ExpandPassDump(app->args["expand-dump"].as<fs::path>());
+    return nullptr;
+  }
   auto input_path = app->args["input"].as<fs::path>();
   auto out_dir = app->args["outdir"].as<fs::path>();
   auto configs = LoadConfigs();
@@ -150,6 +337,10 @@ std::shared_ptr<Program> Main() {
     options.dump_passes_proto = true;
     options.dbg_dir = out_dir / "passes";
   }
+  if (app->args.count("dump-passes-deltas")) {
+    options.dump_passes_deltas = true;
+    options.dbg_dir = out_dir / "passes";
+  }
   return DefaultStage(*app, input_path, out_dir, stage, options);
 }
 
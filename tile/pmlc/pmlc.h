@@ -29,6 +29,9 @@ class App {
 };
 
 vertexai::tile::lang::RunInfo LoadTile(const boost::filesystem::path& filename, bool is_internal);
+// Reconstructs a *.pbz chunked pass dump (see --dump-passes-deltas) into the
+// Stripe text snapshot for that pass, written alongside the dump as *.txt
+void ExpandPassDump(const boost::filesystem::path& input);
 std::shared_ptr<stripe::Program> Main();
 codegen::proto::Configs LoadConfigs();
 
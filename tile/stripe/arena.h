@@ -0,0 +1,73 @@
+// Copyright 2019, Intel Corporation
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace vertexai {
+namespace tile {
+namespace stripe {
+
+// A monotonic allocation arena.  Objects are carved out of large chunks with
+// a bump pointer, so allocating a statement costs a pointer increment instead
+// of a malloc, and all chunks are released together when the arena dies.
+// Objects allocated here must be destroyed without being individually freed;
+// see ArenaDeleter below.
+class Arena {
+ public:
+  explicit Arena(size_t chunk_size = kDefaultChunkSize) : chunk_size_(chunk_size) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(size_t size, size_t align) {
+    size_t padding = (align - (reinterpret_cast<uintptr_t>(ptr_) & (align - 1))) & (align - 1);
+    if (!ptr_ || avail_ < size + padding) {
+      size_t chunk_size = std::max(chunk_size_, size + align);
+      chunks_.emplace_back(new char[chunk_size]);
+      ptr_ = chunks_.back().get();
+      avail_ = chunk_size;
+      padding = (align - (reinterpret_cast<uintptr_t>(ptr_) & (align - 1))) & (align - 1);
+    }
+    char* result = ptr_ + padding;
+    ptr_ = result + size;
+    avail_ -= size + padding;
+    total_ += size;
+    return result;
+  }
+
+  template <typename T, typename... Args>
+  T* Make(Args&&... args) {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // The total payload bytes handed out (excluding alignment and chunk slop).
+  size_t bytes_allocated() const { return total_; }
+
+ private:
+  static constexpr size_t kDefaultChunkSize = 1 << 20;
+
+  size_t chunk_size_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char* ptr_ = nullptr;
+  size_t avail_ = 0;
+  size_t total_ = 0;
+};
+
+// A shared_ptr deleter for arena-allocated objects: runs the destructor but
+// leaves the storage to the arena, which it keeps alive.  This lets
+// arena-backed statements flow through the same std::shared_ptr<Statement>
+// plumbing the rest of the compiler uses.
+template <typename T>
+struct ArenaDeleter {
+  std::shared_ptr<Arena> arena;
+  void operator()(T* ptr) const { ptr->~T(); }
+};
+
+}  // namespace stripe
+}  // namespace tile
+}  // namespace vertexai
@@ -3,9 +3,12 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <variant>
 
+#include "base/util/intern.h"
 #include "tile/stripe/stripe.h"
 
 namespace vertexai {
@@ -44,8 +47,47 @@ inline std::ostream& operator<<(std::ostream& os, const AttrValue& value) {
   return os;
 }
 
+// An identifier interned process-wide: each distinct spelling is stored
+// once, so the thousands of blocks tagged e.g. "kernel" share one copy of
+// the text, equal symbols compare with a pointer test, and copying a
+// Taggable copies handles instead of strings.
+class Symbol : public Interned<Symbol> {
+ public:
+  explicit Symbol(const std::string& str) : str_(str) {}
+  const std::string& str() const { return str_; }
+
+ private:
+  std::string str_;
+};
+
+using SymbolPtr = std::shared_ptr<Symbol>;
+
+// Orders symbols by spelling (keeping tag print order, and thus the
+// canonical form, stable) with a pointer-equality fast path; transparent
+// so queries with a std::string don't have to intern first.
+struct SymbolLess {
+  using is_transparent = void;
+  bool operator()(const SymbolPtr& lhs, const SymbolPtr& rhs) const {
+    if (lhs == rhs) {
+      return false;
+    }
+    return lhs->str() < rhs->str();
+  }
+  bool operator()(const SymbolPtr& lhs, const std::string& rhs) const { return lhs->str() < rhs; }
+  bool operator()(const std::string& lhs, const SymbolPtr& rhs) const { return lhs < rhs->str(); }
+};
+
 struct Taggable::Impl {
-  std::map<std::string, AttrValue> attrs;
+  std::map<SymbolPtr, AttrValue, SymbolLess> attrs;
+
+  // at()-style lookup by spelling; std::map::at is not transparent
+  const AttrValue& attr(const std::string& name) const {
+    auto it = attrs.find(name);
+    if (it == attrs.end()) {
+      throw std::out_of_range("Missing attribute: " + name);
+    }
+    return it->second;
+  }
 };
 
 struct Accessor {
@@ -1,5 +1,8 @@
 // Copyright 2018, Intel Corporation
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
 #include "tile/stripe/stripe.h"
 
 #include "tile/stripe/impl.h"
@@ -338,7 +341,7 @@ proto::Refinement IntoProto(const Refinement& ref) {
   // }
   AttrValueVisitor visitor;
   for (const auto& attr : Accessor::impl(ref)->attrs) {
-    (*ret.mutable_attrs())[attr.first] = std::visit(visitor, attr.second);
+    (*ret.mutable_attrs())[attr.first->str()] = std::visit(visitor, attr.second);
   }
   return ret;
 }
@@ -416,7 +419,7 @@ proto::Statement IntoProto(const std::shared_ptr<Statement>& stmt, const std::ve
   }
   AttrValueVisitor visitor;
   for (const auto& attr : Accessor::impl(*stmt)->attrs) {
-    (*ret.mutable_attrs())[attr.first] = std::visit(visitor, attr.second);
+    (*ret.mutable_attrs())[attr.first->str()] = std::visit(visitor, attr.second);
   }
   switch (stmt->kind()) {
     case StmtKind::Load:
@@ -451,7 +454,7 @@ proto::Index IntoProto(const Index& idx) {
   *ret.mutable_affine() = IntoProto(idx.affine);
   AttrValueVisitor visitor;
   for (const auto& attr : Accessor::impl(idx)->attrs) {
-    (*ret.mutable_attrs())[attr.first] = std::visit(visitor, attr.second);
+    (*ret.mutable_attrs())[attr.first->str()] = std::visit(visitor, attr.second);
   }
   return ret;
 }
@@ -502,7 +505,79 @@ proto::Program IntoProto(const Program& program) {
   }
   AttrValueVisitor visitor;
   for (const auto& attr : Accessor::impl(*program.entry)->attrs) {
-    (*entry->mutable_attrs())[attr.first] = std::visit(visitor, attr.second);
+    (*entry->mutable_attrs())[attr.first->str()] = std::visit(visitor, attr.second);
+  }
+  return ret;
+}
+
+// Writes one length-delimited message to the stream.
+void WriteRecord(const google::protobuf::Message& msg, google::protobuf::io::ZeroCopyOutputStream* zos) {
+  google::protobuf::io::CodedOutputStream cos(zos);
+  cos.WriteVarint32(msg.ByteSizeLong());
+  msg.SerializeWithCachedSizes(&cos);
+  if (cos.HadError()) {
+    throw std::runtime_error("Error writing Stripe program stream");
+  }
+}
+
+// Reads one length-delimited message; returns false on a clean EOF.
+bool ReadRecord(google::protobuf::Message* msg, google::protobuf::io::ZeroCopyInputStream* zis) {
+  // A fresh CodedInputStream per record keeps the per-stream byte limit from
+  // accumulating across an arbitrarily long program.
+  google::protobuf::io::CodedInputStream cis(zis);
+  uint32_t size;
+  if (!cis.ReadVarint32(&size)) {
+    return false;
+  }
+  auto limit = cis.PushLimit(size);
+  if (!msg->ParseFromCodedStream(&cis) || !cis.ConsumedEntireMessage()) {
+    throw std::runtime_error("Error reading Stripe program stream");
+  }
+  cis.PopLimit(limit);
+  return true;
+}
+
+void SerializeProgram(const Program& program, std::ostream* os) {
+  google::protobuf::io::OstreamOutputStream zos(os);
+  // The shell record is the program minus the entry block's statements.
+  {
+    Program shell = program;
+    shell.entry = std::make_shared<Block>(*program.entry);
+    shell.entry->stmts.clear();
+    WriteRecord(IntoProto(shell), &zos);
+  }
+  // One record per top-level statement, so only a single kernel's proto
+  // tree is resident at any point.
+  std::unordered_map<Statement*, size_t> deps_by_stmt;
+  size_t sid = 0;
+  for (const auto& stmt : program.entry->stmts) {
+    deps_by_stmt[stmt.get()] = sid++;
+    std::vector<uint32_t> deps;
+    for (auto dep : stmt->deps) {
+      deps.push_back(deps_by_stmt[dep->get()]);
+    }
+    std::sort(deps.begin(), deps.end());
+    WriteRecord(IntoProto(stmt, deps), &zos);
+  }
+}
+
+std::shared_ptr<Program> DeserializeProgram(std::istream* is) {
+  google::protobuf::io::IstreamInputStream zis(is);
+  proto::Program shell;
+  if (!ReadRecord(&shell, &zis)) {
+    throw std::runtime_error("Missing program record in Stripe program stream");
+  }
+  auto ret = FromProto(shell);
+  std::vector<StatementIt> stmts;
+  proto::Statement pb_stmt;
+  while (ReadRecord(&pb_stmt, &zis)) {
+    auto stmt = FromProto(pb_stmt);
+    stmts.push_back(ret->entry->stmts.emplace(ret->entry->stmts.end(), stmt));
+    for (size_t dep_idx : pb_stmt.deps()) {
+      stmt->deps.push_back(stmts[dep_idx]);
+    }
+    SetAttributes(stmt.get(), pb_stmt.attrs());
+    pb_stmt.Clear();
   }
   return ret;
 }
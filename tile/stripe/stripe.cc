@@ -3,14 +3,20 @@
 #include "tile/stripe/stripe.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <regex>
 #include <sstream>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "boost/format.hpp"
 #include "google/protobuf/text_format.h"
 
+#include "base/util/env.h"
 #include "base/util/stream_container.h"
+#include "base/util/thread_pool.h"
 #include "base/util/throw.h"
 #include "tile/stripe/impl.h"
 
@@ -78,13 +84,13 @@ void PrintPreStmt(std::ostream& os,       //
     for (const auto& attr : impl->attrs) {
       os << "#";
       if (std::holds_alternative<Void>(attr.second)) {
-        os << attr.first;
+        os << attr.first->str();
       } else {
-        os << attr.first << "=" << attr.second;
+        os << attr.first->str() << "=" << attr.second;
       }
       os << " ";
     }
-    os << std::endl;
+    os << '\n';
     PrintTab(os, depth);
   }
 }
@@ -97,21 +103,19 @@ void PrintRefinements(std::ostream& os, const Block& block, size_t depth) {
     }
     for (const auto& kvp : sorted) {
       PrintTab(os, depth + 2);
-      os << PrintRefinement{*kvp.second, &block} << std::endl;
+      os << PrintRefinement{*kvp.second, &block} << '\n';
     }
   } else {
     for (const auto& ref : block.refs) {
       PrintTab(os, depth + 2);
-      os << PrintRefinement{ref, &block} << std::endl;
+      os << PrintRefinement{ref, &block} << '\n';
     }
   }
 }
 
-void PrintBlock(std::ostream& os,    //
-                const Block& block,  //
-                size_t depth,        //
-                size_t block_idx,    //
-                const DepsMap& block_deps) {
+// Everything ahead of the block's statement list: the header line through
+// the opening "{" of the statement scope.
+void PrintBlockOpen(std::ostream& os, const Block& block, size_t depth) {
   os << "block";
   if (!block.location.empty()) {
     os << "<" << block.location << ">";
@@ -127,23 +131,31 @@ void PrintBlock(std::ostream& os,    //
   if (!block.name.empty()) {
     os << " // " << block.name;
   }
-  os << std::endl;
+  os << '\n';
 
   if (!block.comments.empty()) {
     std::stringstream ss(block.comments);
     for (std::string line; std::getline(ss, line, '\n');) {
       PrintTab(os, depth + 2);
-      os << "// " << line << std::endl;
+      os << "// " << line << '\n';
     }
   }
   for (const auto& constraint : block.constraints) {
     PrintTab(os, depth + 2);
     os << constraint.toString() << " >= 0";
-    os << std::endl;
+    os << '\n';
   }
   PrintRefinements(os, block, depth);
   PrintTab(os, depth);
-  os << ") {" << std::endl;
+  os << ") {" << '\n';
+}
+
+void PrintBlock(std::ostream& os,    //
+                const Block& block,  //
+                size_t depth,        //
+                size_t block_idx,    //
+                const DepsMap& block_deps) {
+  PrintBlockOpen(os, block, depth);
   std::size_t idx = 0;
   DepsMap deps;
   for (const auto& stmt : block.stmts) {
@@ -151,7 +163,7 @@ void PrintBlock(std::ostream& os,    //
     deps[stmt.get()] = idx++;
   }
   PrintTab(os, depth);
-  os << "}" << std::endl;
+  os << "}" << '\n';
 }
 
 void PrintStmt(std::ostream& os,       //
@@ -162,22 +174,22 @@ void PrintStmt(std::ostream& os,       //
   PrintPreStmt(os, depth, stmt, idx, deps);
   switch (stmt.kind()) {
     case StmtKind::Load:
-      os << *dynamic_cast<const Load*>(&stmt) << std::endl;
+      os << *dynamic_cast<const Load*>(&stmt) << '\n';
       break;
     case StmtKind::Store:
-      os << *dynamic_cast<const Store*>(&stmt) << std::endl;
+      os << *dynamic_cast<const Store*>(&stmt) << '\n';
       break;
     case StmtKind::LoadIndex:
-      os << *dynamic_cast<const LoadIndex*>(&stmt) << std::endl;
+      os << *dynamic_cast<const LoadIndex*>(&stmt) << '\n';
       break;
     case StmtKind::Intrinsic:
-      os << *dynamic_cast<const Intrinsic*>(&stmt) << std::endl;
+      os << *dynamic_cast<const Intrinsic*>(&stmt) << '\n';
       break;
     case StmtKind::Special:
-      os << *dynamic_cast<const Special*>(&stmt) << std::endl;
+      os << *dynamic_cast<const Special*>(&stmt) << '\n';
       break;
     case StmtKind::Constant:
-      os << *dynamic_cast<const Constant*>(&stmt) << std::endl;
+      os << *dynamic_cast<const Constant*>(&stmt) << '\n';
       break;
     case StmtKind::Block:
       PrintBlock(os, *dynamic_cast<const Block*>(&stmt), depth, idx, deps);
@@ -216,6 +228,68 @@ struct DefaultCodec : Codec {
   std::optional<size_t> sparse_dim() const final { return std::nullopt; }
 };
 
+// The planning-time density bound for the sparse codecs: the fraction of
+// elements assumed nonzero when sizing buffers.  Pruned models know their
+// density; callers set PLAIDML_SPARSE_DENSITY to match.
+double SparseDensity() {
+  auto str = env::Get("PLAIDML_SPARSE_DENSITY", "0.1");
+  try {
+    return std::min(1.0, std::max(std::stod(str), 0.0));
+  } catch (const std::exception&) {
+    return 0.1;
+  }
+}
+
+// Common machinery for the sparse codecs: both compress along the innermost
+// (smallest-stride) dimension and size their value arrays by the density
+// bound.
+struct SparseCodec : Codec {
+  explicit SparseCodec(const TensorShape* shape) : Codec(shape) {}
+
+  std::optional<size_t> sparse_dim() const final {
+    std::optional<size_t> ret;
+    for (size_t i = 0; i < shape_->dims.size(); i++) {
+      const auto& dim = shape_->dims[i];
+      if (dim.stride && (!ret || std::abs(dim.stride) < std::abs(shape_->dims[*ret].stride))) {
+        ret = i;
+      }
+    }
+    return ret;
+  }
+
+  int64_t nonzeros() const {
+    auto elems = shape_->sizes_product();
+    return static_cast<int64_t>(std::ceil(elems * SparseDensity()));
+  }
+};
+
+// A CSR-like layout: per-row offsets into packed (index, value) pairs, with
+// rows running over everything but the sparse dimension.
+struct SparseCsrCodec : SparseCodec {
+  explicit SparseCsrCodec(const TensorShape* shape) : SparseCodec(shape) {}
+
+  int64_t byte_size() const final {
+    auto dim = sparse_dim();
+    if (!dim) {
+      return shape_->sizes_product_bytes();
+    }
+    int64_t rows = shape_->sizes_product() / std::max(shape_->dims[*dim].size, uint64_t{1});
+    int64_t offset_bytes = (rows + 1) * sizeof(uint32_t);
+    int64_t entry_bytes = nonzeros() * (sizeof(uint32_t) + byte_width(shape_->type));
+    return offset_bytes + entry_bytes;
+  }
+};
+
+// A bitmap-masked layout: one presence bit per element plus packed values.
+struct SparseBitmapCodec : SparseCodec {
+  explicit SparseBitmapCodec(const TensorShape* shape) : SparseCodec(shape) {}
+
+  int64_t byte_size() const final {
+    int64_t mask_bytes = (shape_->sizes_product() + 7) / 8;
+    return mask_bytes + nonzeros() * byte_width(shape_->type);
+  }
+};
+
 class CodecRegistry {
  public:
   static CodecRegistry* Instance() {
@@ -234,6 +308,8 @@ class CodecRegistry {
  private:
   CodecRegistry() {
     registry_[""] = [](auto shape) { return std::make_unique<stripe::DefaultCodec>(shape); };
+    registry_["sparse_csr"] = [](auto shape) { return std::make_unique<stripe::SparseCsrCodec>(shape); };
+    registry_["sparse_bitmap"] = [](auto shape) { return std::make_unique<stripe::SparseBitmapCodec>(shape); };
   }
 
  private:
@@ -253,21 +329,26 @@ Taggable& Taggable::operator=(const Taggable& rhs) {
   return *this;
 }
 
-void Taggable::set_tag(const std::string& tag) { impl_->attrs.emplace(tag, Void{}); }
+void Taggable::set_tag(const std::string& tag) { impl_->attrs.emplace(Symbol::make(tag), Void{}); }
 
 void Taggable::add_tags(const Tags& to_add) {
   for (const auto& tag : to_add) {
-    impl_->attrs.emplace(tag, Void{});
+    impl_->attrs.emplace(Symbol::make(tag), Void{});
   }
 }
 
 void Taggable::clear_tags() { impl_->attrs.clear(); }
 
-void Taggable::remove_tag(const std::string& tag) { impl_->attrs.erase(tag); }
+void Taggable::remove_tag(const std::string& tag) {
+  auto it = impl_->attrs.find(tag);
+  if (it != impl_->attrs.end()) {
+    impl_->attrs.erase(it);
+  }
+}
 
 void Taggable::remove_tags(const Tags& to_remove) {
   for (const auto& tag : to_remove) {
-    impl_->attrs.erase(tag);
+    remove_tag(tag);
   }
 }
 
@@ -314,22 +395,24 @@ void Taggable::visit_tags(TagVisitor* visitor) const {
   TagVisitorVisitor outer;
   outer.inner = visitor;
   for (const auto& kvp : impl_->attrs) {
-    outer.name = kvp.first;
+    outer.name = kvp.first->str();
     std::visit(outer, kvp.second);
   }
 }
 
-void Taggable::set_attr(const std::string& name) { impl_->attrs.emplace(name, Void{}); }
+void Taggable::set_attr(const std::string& name) { impl_->attrs.emplace(Symbol::make(name), Void{}); }
 
-void Taggable::set_attr(const std::string& name, bool value) { impl_->attrs.emplace(name, value); }
+void Taggable::set_attr(const std::string& name, bool value) { impl_->attrs.emplace(Symbol::make(name), value); }
 
-void Taggable::set_attr(const std::string& name, int64_t value) { impl_->attrs.emplace(name, value); }
+void Taggable::set_attr(const std::string& name, int64_t value) { impl_->attrs.emplace(Symbol::make(name), value); }
 
-void Taggable::set_attr(const std::string& name, double value) { impl_->attrs.emplace(name, value); }
+void Taggable::set_attr(const std::string& name, double value) { impl_->attrs.emplace(Symbol::make(name), value); }
 
-void Taggable::set_attr(const std::string& name, const std::string& value) { impl_->attrs.emplace(name, value); }
+void Taggable::set_attr(const std::string& name, const std::string& value) {
+  impl_->attrs.emplace(Symbol::make(name), value);
+}
 
-void Taggable::set_attr(const std::string& name, const Any& value) { impl_->attrs.emplace(name, value); }
+void Taggable::set_attr(const std::string& name, const Any& value) { impl_->attrs.emplace(Symbol::make(name), value); }
 
 bool Taggable::has_attr(const std::string& name) const { return impl_->attrs.count(name); }
 
@@ -339,15 +422,17 @@ void Taggable::set_attrs(const Taggable& rhs) {
   }
 }
 
-bool Taggable::get_attr_bool(const std::string& name) const { return std::get<bool>(impl_->attrs[name]); }
+bool Taggable::get_attr_bool(const std::string& name) const { return std::get<bool>(impl_->attr(name)); }
 
-int64_t Taggable::get_attr_int(const std::string& name) const { return std::get<int64_t>(impl_->attrs[name]); }
+int64_t Taggable::get_attr_int(const std::string& name) const { return std::get<int64_t>(impl_->attr(name)); }
 
-double Taggable::get_attr_float(const std::string& name) const { return std::get<double>(impl_->attrs[name]); }
+double Taggable::get_attr_float(const std::string& name) const { return std::get<double>(impl_->attr(name)); }
 
-std::string Taggable::get_attr_str(const std::string& name) const { return std::get<std::string>(impl_->attrs[name]); }
+std::string Taggable::get_attr_str(const std::string& name) const {
+  return std::get<std::string>(impl_->attr(name));
+}
 
-Any Taggable::get_attr_any(const std::string& name) const { return std::get<Any>(impl_->attrs[name]); }
+Any Taggable::get_attr_any(const std::string& name) const { return std::get<Any>(impl_->attr(name)); }
 
 bool Taggable::get_attr_bool(const std::string& name, bool def) const {
   return has_attr(name) ? get_attr_bool(name) : def;
@@ -537,7 +622,7 @@ std::ostream& operator<<(std::ostream& os, const PrintRefinement& printer) {
   auto impl = Accessor::impl(ref);
   if (impl->attrs.size()) {
     for (const auto& attr : impl->attrs) {
-      os << "#" << attr.first << " ";
+      os << "#" << attr.first->str() << " ";
     }
   }
   os << to_string(ref.dir);
@@ -611,6 +696,43 @@ std::ostream& operator<<(std::ostream& os, const Block& block) {
   return os;
 }
 
+void PrintProgram(std::ostream& os, const Block& program) {
+  std::shared_ptr<Block> main;
+  if (program.stmts.size() != 1 || !(main = Block::Downcast(*program.stmts.begin()))) {
+    os << program;
+    return;
+  }
+  DepsMap no_deps;
+  PrintPreStmt(os, 0, program, 0, no_deps);
+  PrintBlockOpen(os, program, 0);
+  PrintPreStmt(os, 1, *main, 0, no_deps);
+  PrintBlockOpen(os, *main, 1);
+  // Statement indexes are assigned in order and a statement's deps always
+  // refer to earlier statements, so the full index map can be built up front
+  // and shared read-only across the workers.
+  DepsMap deps;
+  size_t idx = 0;
+  for (const auto& stmt : main->stmts) {
+    deps[stmt.get()] = idx++;
+  }
+  std::vector<std::ostringstream> bufs(main->stmts.size());
+  ThreadPool pool;
+  idx = 0;
+  for (const auto& stmt : main->stmts) {
+    auto* buf = &bufs[idx];
+    const auto* raw = stmt.get();
+    size_t stmt_idx = idx++;
+    pool.Submit([buf, raw, stmt_idx, &deps]() { PrintStmt(*buf, *raw, 2, stmt_idx, deps); });
+  }
+  pool.Wait();
+  for (const auto& buf : bufs) {
+    os << buf.str();
+  }
+  PrintTab(os, 1);
+  os << "}" << '\n';
+  os << "}" << '\n';
+}
+
 std::vector<size_t> Block::sorted_idx_ranges() {
   std::vector<size_t> ranges;
   for (const auto& idx : idxs) {
@@ -733,7 +855,7 @@ std::ostream& operator<<(std::ostream& os, const Index& idx) {
   if (impl->attrs.size()) {
     os << "(";
     for (const auto& attr : impl->attrs) {
-      os << "#" << attr.first << " ";
+      os << "#" << attr.first->str() << " ";
     }
   }
   os << idx.name;
@@ -913,41 +1035,375 @@ Location PartialEval(const Location& loc, const std::map<std::string, std::int64
 
 class CloneVisitor : RewriteStmtVisitor {
  public:
-  explicit CloneVisitor(int depth) : depth_(depth) {}
-  Load* Visit(const Load& x) { return new Load(x); }
-  Store* Visit(const Store& x) { return new Store(x); }
-  LoadIndex* Visit(const LoadIndex& x) { return new LoadIndex(x); }
-  Constant* Visit(const Constant& x) { return new Constant(x); }
-  Special* Visit(const Special& x) { return new Special(x); }
-  Intrinsic* Visit(const Intrinsic& x) { return new Intrinsic(x); }
+  explicit CloneVisitor(int depth, const std::shared_ptr<Arena>& arena = {}, bool share_leaves = false)
+      : depth_(depth), arena_(arena), share_leaves_(share_leaves) {}
+  Load* Visit(const Load& x) { return Make(x); }
+  Store* Visit(const Store& x) { return Make(x); }
+  LoadIndex* Visit(const LoadIndex& x) { return Make(x); }
+  Constant* Visit(const Constant& x) { return Make(x); }
+  Special* Visit(const Special& x) { return Make(x); }
+  Intrinsic* Visit(const Intrinsic& x) { return Make(x); }
   Block* Visit(const Block& x) {
-    auto ret = new Block(x);
+    auto ret = Make(x);
     if (depth_ == 0) {
       return ret;
     }
     depth_--;
     std::unordered_map<Statement*, StatementIt> dep_map;  // src-block ptr -> clone-block StatementIt
     for (StatementIt sit = ret->stmts.begin(); sit != ret->stmts.end(); ++sit) {
+      if (share_leaves_ && (*sit)->kind() != StmtKind::Block && (*sit)->deps.empty()) {
+        // Share the leaf with the source block; ret->stmts already holds
+        // the original shared_ptr.  (Leaves with deps are copied: their dep
+        // iterators point into the source block's statement list.)
+        dep_map[sit->get()] = sit;
+        continue;
+      }
       Statement* clone = (*sit)->Accept(this);
       for (auto& dit : clone->deps) {
         dit = dep_map.at(dit->get());
       }
       dep_map[sit->get()] = sit;
-      sit->reset(clone);
+      *sit = Wrap(clone);
     }
     depth_++;
     return ret;
   }
 
+  std::shared_ptr<Statement> Wrap(Statement* stmt) {
+    if (arena_) {
+      return std::shared_ptr<Statement>(stmt, ArenaDeleter<Statement>{arena_});
+    }
+    return std::shared_ptr<Statement>(stmt);
+  }
+
+  std::shared_ptr<Statement> CloneStmt(const std::shared_ptr<Statement>& stmt) { return Wrap(stmt->Accept(this)); }
+
  private:
+  template <typename T>
+  T* Make(const T& x) {
+    return arena_ ? arena_->Make<T>(x) : new T(x);
+  }
+
   int depth_;
+  std::shared_ptr<Arena> arena_;
+  bool share_leaves_;
+};
+
+namespace {
+
+// Streams the canonical structure of statements into either an FNV-1a
+// digest or a byte buffer (for exact comparison).  Block indexes are
+// alpha-renamed to their (scope depth, declaration order), so index naming
+// doesn't affect the result; comments are ignored.  Everything else --
+// statements, refinements, shapes, locations, and Taggable tags and
+// attributes -- is folded in field by field, length-prefixed so the byte
+// stream is unambiguous.
+class Canonicalizer final : public ConstStmtVisitor, public TagVisitor {
+ public:
+  explicit Canonicalizer(std::string* out = nullptr) : out_(out) {}
+
+  uint64_t digest() const { return digest_; }
+
+  void Visit(const Load& x) final {
+    Mark('L');
+    Meta(x);
+    Str(x.from);
+    Str(x.into);
+  }
+
+  void Visit(const Store& x) final {
+    Mark('S');
+    Meta(x);
+    Str(x.from);
+    Str(x.into);
+  }
+
+  void Visit(const LoadIndex& x) final {
+    Mark('X');
+    Meta(x);
+    Aff(x.from);
+    Str(x.into);
+  }
+
+  void Visit(const Constant& x) final {
+    Mark('C');
+    Meta(x);
+    Str(x.name);
+    if (x.type == ConstType::Integer) {
+      Mark('i');
+      Int(x.iconst);
+    } else {
+      Mark('f');
+      Bytes(&x.fconst, sizeof(x.fconst));
+    }
+  }
+
+  void Visit(const Special& x) final {
+    Mark('P');
+    Meta(x);
+    Str(x.name);
+    StrVec(x.inputs);
+    StrVec(x.outputs);
+    Int(x.int_params.size());
+    for (const auto& kvp : x.int_params) {
+      Str(kvp.first);
+      Int(kvp.second);
+    }
+    Int(x.str_params.size());
+    for (const auto& kvp : x.str_params) {
+      Str(kvp.first);
+      Str(kvp.second);
+    }
+  }
+
+  void Visit(const Intrinsic& x) final {
+    Mark('I');
+    Meta(x);
+    Str(x.name);
+    Int(static_cast<int64_t>(x.type));
+    StrVec(x.inputs);
+    StrVec(x.outputs);
+  }
+
+  void Visit(const Block& x) final {
+    Mark('B');
+    Meta(x);
+    // Block names are significant: generated code embeds them as symbols.
+    Str(x.name);
+    scopes_.emplace_back();
+    auto& scope = scopes_.back();
+    for (const auto& idx : x.idxs) {
+      scope.emplace(idx.name, scope.size());
+    }
+    Int(x.idxs.size());
+    for (const auto& idx : x.idxs) {
+      Meta(idx);
+      Int(idx.range);
+      Aff(idx.affine);
+    }
+    Int(x.constraints.size());
+    for (const auto& con : x.constraints) {
+      Aff(con);
+    }
+    Int(x.refs.size());
+    for (const auto& ref : x.refs) {
+      Ref(ref);
+    }
+    Loc(x.location);
+    // Deps are folded in positionally; iterators mean nothing across blocks.
+    std::unordered_map<const Statement*, size_t> order;
+    for (const auto& stmt : x.stmts) {
+      order.emplace(stmt.get(), order.size());
+    }
+    Int(x.stmts.size());
+    for (const auto& stmt : x.stmts) {
+      Int(stmt->deps.size());
+      for (const auto& dep : stmt->deps) {
+        Int(order.at(dep->get()));
+      }
+      stmt->Accept(this);
+    }
+    scopes_.pop_back();
+  }
+
+  // TagVisitor: tags and attributes arrive in deterministic (map) order.
+  void Visit(const std::string& name) final {
+    Mark('t');
+    Str(name);
+  }
+  void Visit(const std::string& name, bool value) final {
+    Mark('b');
+    Str(name);
+    Int(value);
+  }
+  void Visit(const std::string& name, int64_t value) final {
+    Mark('n');
+    Str(name);
+    Int(value);
+  }
+  void Visit(const std::string& name, double value) final {
+    Mark('d');
+    Str(name);
+    Bytes(&value, sizeof(value));
+  }
+  void Visit(const std::string& name, const std::string& value) final {
+    Mark('s');
+    Str(name);
+    Str(value);
+  }
+  void Visit(const std::string& name, const google::protobuf::Any& value) final {
+    Mark('a');
+    Str(name);
+    Str(value.type_url());
+    Str(value.value());
+  }
+
+ private:
+  void Mark(char c) { Bytes(&c, 1); }
+
+  void Int(int64_t v) { Bytes(&v, sizeof(v)); }
+
+  void Str(const std::string& s) {
+    Int(s.size());
+    Bytes(s.data(), s.size());
+  }
+
+  void StrVec(const std::vector<std::string>& v) {
+    Int(v.size());
+    for (const auto& s : v) {
+      Str(s);
+    }
+  }
+
+  void Bytes(const void* data, size_t size) {
+    if (out_) {
+      out_->append(static_cast<const char*>(data), size);
+      return;
+    }
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      digest_ ^= bytes[i];
+      digest_ *= 0x100000001B3ull;
+    }
+  }
+
+  void Meta(const Taggable& x) {
+    x.visit_tags(this);
+    Mark('.');
+  }
+
+  void Aff(const Affine& aff) {
+    // Canonical term order: alpha-renamed indexes by (depth, ordinal), then
+    // names from outside the hashed subtree lexically, constant last.
+    std::vector<std::tuple<int64_t, int64_t, std::string, int64_t>> terms;
+    for (const auto& kvp : aff.getMap()) {
+      if (kvp.first.empty()) {
+        terms.emplace_back(2, 0, std::string(), kvp.second);
+        continue;
+      }
+      bool renamed = false;
+      for (size_t depth = scopes_.size(); depth-- > 0;) {
+        auto it = scopes_[depth].find(kvp.first);
+        if (it != scopes_[depth].end()) {
+          auto id = (static_cast<int64_t>(scopes_.size() - depth) << 32) | static_cast<int64_t>(it->second);
+          terms.emplace_back(0, id, std::string(), kvp.second);
+          renamed = true;
+          break;
+        }
+      }
+      if (!renamed) {
+        terms.emplace_back(1, 0, kvp.first, kvp.second);
+      }
+    }
+    std::sort(terms.begin(), terms.end());
+    Int(terms.size());
+    for (const auto& term : terms) {
+      Int(std::get<0>(term));
+      Int(std::get<1>(term));
+      Str(std::get<2>(term));
+      Int(std::get<3>(term));
+    }
+  }
+
+  void Ref(const Refinement& ref) {
+    Meta(ref);
+    Int(static_cast<int64_t>(ref.dir));
+    Str(ref.from);
+    Str(ref.into());
+    Int(ref.access.size());
+    for (const auto& acc : ref.access) {
+      Aff(acc);
+    }
+    Shape(ref.interior_shape);
+    Str(ref.agg_op);
+    Loc(ref.location);
+    Int(ref.offset);
+    Int(ref.bank_dim ? static_cast<int64_t>(ref.bank_dim->dim_pos) : -1);
+    if (ref.cache_unit) {
+      Mark('u');
+      Aff(*ref.cache_unit);
+    } else {
+      Mark('-');
+    }
+  }
+
+  void Shape(const TensorShape& shape) {
+    Int(static_cast<int64_t>(shape.type));
+    Int(shape.is_const);
+    Str(shape.codec);
+    Str(shape.layout);
+    Int(shape.dims.size());
+    for (const auto& dim : shape.dims) {
+      Int(dim.stride);
+      Int(dim.size);
+    }
+  }
+
+  void Loc(const Location& loc) {
+    Int(loc.devs.size());
+    for (const auto& dev : loc.devs) {
+      Str(dev.name);
+      Int(dev.units.size());
+      for (const auto& unit : dev.units) {
+        Aff(unit);
+      }
+    }
+  }
+
+  std::string* out_;
+  uint64_t digest_ = 0xCBF29CE484222325ull;
+  std::vector<std::map<std::string, size_t>> scopes_;
 };
 
-std::shared_ptr<Block> CloneBlock(const Block& orig, int depth) {
-  CloneVisitor visitor(depth);
+}  // namespace
+
+uint64_t CanonicalHash(const Block& block) {
+  Canonicalizer hasher;
+  hasher.Visit(block);
+  return hasher.digest();
+}
+
+bool StructurallyEqual(const Block& lhs, const Block& rhs) {
+  std::string lbuf;
+  std::string rbuf;
+  Canonicalizer lc(&lbuf);
+  Canonicalizer rc(&rbuf);
+  lc.Visit(lhs);
+  rc.Visit(rhs);
+  return lbuf == rbuf;
+}
+
+std::shared_ptr<Block> CloneBlock(const Block& orig, int depth, bool share_leaves) {
+  CloneVisitor visitor(depth, {}, share_leaves);
   return std::shared_ptr<Block>(visitor.Visit(orig));
 }
 
+std::shared_ptr<Block> CloneBlock(const Block& orig, int depth, const std::shared_ptr<Arena>& arena,
+                                  bool share_leaves) {
+  CloneVisitor visitor(depth, arena, share_leaves);
+  Block* clone = visitor.Visit(orig);
+  if (arena) {
+    return std::shared_ptr<Block>(clone, ArenaDeleter<Block>{arena});
+  }
+  return std::shared_ptr<Block>(clone);
+}
+
+void MaterializeStmts(Block* block, int depth) {
+  CloneVisitor visitor(0);
+  for (auto& stmt : block->stmts) {
+    auto inner = Block::Downcast(stmt);
+    if (inner) {
+      if (depth != 0) {
+        MaterializeStmts(inner.get(), depth - 1);
+      }
+      continue;
+    }
+    if (stmt.use_count() > 1) {
+      stmt = visitor.CloneStmt(stmt);
+    }
+  }
+}
+
 const Index* Block::idx_by_name(const std::string& name) const {
   auto it = std::find_if(idxs.begin(), idxs.end(), [&name](const Index& idx) { return idx.name == name; });
   if (it == idxs.end()) {
@@ -1080,7 +1536,7 @@ TensorShape Block::exterior_shape(const std::string& into) const {
   for (const auto& idx : idxs) {
     idx_ranges.emplace(idx.name, idx.range);
   }
-  return it->ApplyTile(idx_ranges);
+  return it->CachedApplyTile(idx_ranges);
 }
 
 Affine Refinement::FlatAccess() const {
@@ -1146,6 +1602,26 @@ TensorShape Refinement::ApplyTile(const std::map<std::string, size_t>& tile_by_n
   return shape;
 }
 
+const TensorShape& Refinement::CachedApplyTile(const std::map<std::string, size_t>& tile_by_name) const {
+  // The drop in mut() is only a fast path; a few passes retain Refinement
+  // pointers and mutate fields directly, so the memo is validated against
+  // the actual inputs of the derivation.  The compares are still far
+  // cheaper than redoing the shape arithmetic (and its allocations).
+  if (shape_cache_ &&                          //
+      shape_cache_->ranges == tile_by_name &&  //
+      shape_cache_->access == access &&        //
+      shape_cache_->interior == interior_shape) {
+    return shape_cache_->shape;
+  }
+  auto cache = std::make_shared<ShapeCache>();
+  cache->shape = ApplyTile(tile_by_name);
+  cache->ranges = tile_by_name;
+  cache->access = access;
+  cache->interior = interior_shape;
+  shape_cache_ = std::move(cache);
+  return shape_cache_->shape;
+}
+
 const Block* FindBlockByTag(const Block& block, const std::string& tag) {
   if (block.has_tag(tag)) {
     return &block;
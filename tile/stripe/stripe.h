@@ -12,8 +12,11 @@
 #include <unordered_map>
 #include <vector>
 
+#include <google/protobuf/io/zero_copy_stream.h>
+
 #include "tile/base/shape.h"
 #include "tile/math/polynomial.h"
+#include "tile/stripe/arena.h"
 #include "tile/stripe/stripe.pb.h"
 
 namespace vertexai {
@@ -279,14 +282,36 @@ struct Refinement : Taggable {
   std::vector<Extent> Extents(const std::vector<Index>& idxs) const;
   TensorShape ApplyTile(const std::map<std::string, size_t>& tile_by_name) const;
 
+  // As ApplyTile, but memoized against the last set of tile ranges used.
+  // Passes interrogate the same refinement with the same ranges over and
+  // over (e.g. via Block::exterior_shape), and the shape arithmetic is hot
+  // in compile profiles; the memo turns the repeats into a map compare.
+  const TensorShape& CachedApplyTile(const std::map<std::string, size_t>& tile_by_name) const;
+
   // Returns a mutable Refinement from a const Refinement.  This is
   // useful when processing a set<Refinement>, since for safety
   // reasons, the normal accessors only return access to const
-  // Refinements.
-  Refinement& mut() const { return const_cast<Refinement&>(*this); }
+  // Refinements.  Handing out mutable access may change anything the
+  // derived shape depends on, so it also drops the memo.
+  Refinement& mut() const {
+    shape_cache_.reset();
+    return const_cast<Refinement&>(*this);
+  }
 
  private:
+  // Memoized CachedApplyTile result, along with the inputs it was derived
+  // from.  The node is immutable once built and replaced wholesale on a
+  // miss, so copying a Refinement just copies the pointer.  Mutable since
+  // the memo doesn't affect the refinement's logical value.
+  struct ShapeCache {
+    TensorShape shape;
+    std::map<std::string, size_t> ranges;
+    std::vector<Affine> access;
+    TensorShape interior;
+  };
+
   std::string into_;
+  mutable std::shared_ptr<const ShapeCache> shape_cache_;
 };
 
 }  // namespace stripe
@@ -488,6 +513,10 @@ struct Program {
   std::shared_ptr<Block> entry;
   ShapeMap input_shapes;
   ShapeMap output_shapes;
+  // Inputs whose buffers the caller has donated to the program: their
+  // contents may be discarded once read, so the scheduler is free to fold an
+  // output into the same allocation instead of keeping the pair distinct.
+  std::set<std::string> donated_inputs;
 };
 
 std::string to_string(RefDir dir);
@@ -566,9 +595,17 @@ std::ostream& operator<<(std::ostream& os, const Refinement& ref);
 std::ostream& operator<<(std::ostream& os, const PrintRefinement& ref);
 std::ostream& operator<<(std::ostream& os, const Block& block);
 
+// Writes `program` in the same text form as operator<<, but formats the
+// top-level statements of the entry's single inner block (the kernels under
+// main, for the usual program->main shape) into per-statement buffers in
+// parallel before writing them out in order.  Other shapes fall back to the
+// plain serial printer.
+void PrintProgram(std::ostream& os, const Block& program);
+
 bool FromProtoText(const std::string& pbtxt, proto::Program* into);
 std::shared_ptr<Program> FromProto(const proto::Program& program);
 std::shared_ptr<Block> FromProto(const proto::Block& block);
+std::shared_ptr<Statement> FromProto(const proto::Statement& stmt);
 Affine FromProto(const proto::Affine& affine);
 Device FromProto(const proto::Device& dev);
 std::vector<Device> FromProto(const google::protobuf::RepeatedPtrField<proto::Device>& devs);
@@ -578,8 +615,55 @@ Tags FromProto(const google::protobuf::RepeatedPtrField<std::string>& pb_tags);
 
 proto::Block IntoProto(const Block& block);
 proto::Program IntoProto(const Program& program);
-
-std::shared_ptr<Block> CloneBlock(const Block& orig, int depth = -1);
+proto::Statement IntoProto(const std::shared_ptr<Statement>& stmt, const std::vector<uint32_t>& deps);
+
+void SetAttributes(Taggable* into, const google::protobuf::Map<std::string, proto::Attribute>& attrs);
+
+// Streaming (de)serialization.  The program is written as a length-delimited
+// shell record (the program minus the entry block's statements) followed by
+// one length-delimited proto::Statement record per top-level statement, so
+// only a single kernel's proto tree is in memory at a time instead of the
+// whole program's.
+void SerializeProgram(const Program& program, std::ostream* os);
+std::shared_ptr<Program> DeserializeProgram(std::istream* is);
+
+// Length-delimited record framing used by the streaming (de)serializers;
+// exposed so other formats (e.g. the chunked pass dumps) can share it.
+// ReadRecord returns false on a clean EOF.
+void WriteRecord(const google::protobuf::Message& msg, google::protobuf::io::ZeroCopyOutputStream* zos);
+bool ReadRecord(google::protobuf::Message* msg, google::protobuf::io::ZeroCopyInputStream* zis);
+
+// Computes a structural fingerprint of a block for use as a cache key.
+// Statements, refinements, shapes, locations, and Taggable tags/attributes
+// are folded in field by field, with block indexes alpha-renamed to their
+// (scope depth, declaration order), so two blocks differing only in index
+// naming (or in comments/formatting) hash equal.  Block names are
+// significant: generated code embeds them as symbols.  Pair with
+// StructurallyEqual to rule out collisions.
+uint64_t CanonicalHash(const Block& block);
+
+// Exact equality under the same canonicalization CanonicalHash uses.
+bool StructurallyEqual(const Block& lhs, const Block& rhs);
+
+// Clones a block to the given depth (-1 for the whole subtree).  With
+// 'share_leaves' set, non-block statements without dependency edges are
+// shared with the original instead of copied -- copy-on-write: interior
+// blocks stay private (so refinements, indexes and nesting may be rewritten
+// freely) while the leaf loads/stores/intrinsics, which dominate the
+// statement count, cost nothing.  Shared leaves must not be mutated in
+// place while aliased; passes that rewrite leaf statements call
+// MaterializeStmts first.
+std::shared_ptr<Block> CloneBlock(const Block& orig, int depth = -1, bool share_leaves = false);
+// As above, but every cloned statement is carved out of the given arena
+// instead of being individually heap-allocated; the returned pointers keep
+// the arena alive.  Useful for passes that clone heavily and then discard
+// most of the clones.
+std::shared_ptr<Block> CloneBlock(const Block& orig, int depth, const std::shared_ptr<Arena>& arena,
+                                  bool share_leaves = false);
+// Replaces each statement in 'block' (to 'depth' levels) that is aliased
+// outside the block -- e.g. a leaf shared via CloneBlock(share_leaves) --
+// with a privately owned copy, making in-place mutation safe again.
+void MaterializeStmts(Block* block, int depth = -1);
 const Block* FindBlockByTag(const Block& block, const std::string& tag);
 void FindBlocksByTag(std::vector<const Block*>* into, const Block& block, const std::string& tag);
 const Index* FindIndexByTag(const Block& block, const std::string& tag);
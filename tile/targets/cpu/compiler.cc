@@ -8,13 +8,16 @@
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/MC/SubtargetFeature.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <memory>
 #include <utility>
@@ -22,6 +25,7 @@
 
 #include <half.hpp>
 
+#include "base/util/env.h"
 #include "base/util/lookup.h"
 #include "tile/stripe/stripe.h"
 #include "tile/targets/cpu/executable.h"
@@ -60,7 +64,25 @@ ProgramModule Compiler::CompileProgram(const stripe::Block& program) {
   auto targetTriple = llvm::sys::getProcessTriple();
   std::string errorMessage;
   auto target = llvm::TargetRegistry::lookupTarget(targetTriple, errorMessage);
-  std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(targetTriple, "generic", "", {}, {}));
+  // Target the host CPU and its full feature set rather than a generic
+  // machine: with F16C/AVX-512 (and AVX512-BF16 where present) visible, the
+  // loop and SLP vectorizers below turn scalar half<->float conversion loops
+  // into hardware conversion instructions instead of per-element libcalls.
+  // When the config pins an arch, use that CPU's own feature set instead, so
+  // the module stays portable across a fleet with that baseline.
+  std::string cpu = config_.arch;
+  llvm::StringMap<bool> feature_map;
+  llvm::SubtargetFeatures subtarget_features;
+  if (cpu.empty()) {
+    cpu = llvm::sys::getHostCPUName().str();
+    if (llvm::sys::getHostCPUFeatures(feature_map)) {
+      for (const auto& feature : feature_map) {
+        subtarget_features.AddFeature(feature.first(), feature.second);
+      }
+    }
+  }
+  std::unique_ptr<llvm::TargetMachine> machine(
+      target->createTargetMachine(targetTriple, cpu, subtarget_features.getString(), {}, {}));
   module_->setDataLayout(machine->createDataLayout());
   module_->setTargetTriple(targetTriple);
 
@@ -151,6 +173,16 @@ void Compiler::GenerateInvoker(const stripe::Block& program, llvm::Function* mai
       builder_.CreateStore(builder_.CreateBitCast(buffer, arenatype), arena_gval);
       allocs.push_back(buffer);
     }
+    // PLAIDML_CPU_ALIGN_ASSUME promises the optimizer that user buffer
+    // bases are at least this aligned, so the vectorizer can emit aligned
+    // loads.  The platform's CPU allocator mmaps its buffers (page-aligned
+    // or better), making 64 safe unless external host memory is adopted
+    // with a weaker alignment -- hence opt-in.
+    unsigned align_assume = 0;
+    auto align_env = env::Get("PLAIDML_CPU_ALIGN_ASSUME");
+    if (align_env.size()) {
+      align_assume = std::max(0, std::atoi(align_env.c_str()));
+    }
     unsigned i = 0;
     for (auto& ref : program.refs) {
       if (ref.has_tag("user")) {
@@ -161,6 +193,9 @@ void Compiler::GenerateInvoker(const stripe::Block& program, llvm::Function* mai
         llvm::Value* elval = builder_.CreateLoad(elptr, ref.into());
         llvm::Type* eltype = CType(ref.interior_shape.type)->getPointerTo();
         args.push_back(builder_.CreateBitCast(elval, eltype));
+        if (align_assume) {
+          builder_.CreateAlignmentAssumption(module_->getDataLayout(), args.back(), align_assume);
+        }
       } else if (ref.has_tag("tmp")) {
         // Allocate a temporary buffer for this refinement
         auto buffer = Malloc(ref.interior_shape.byte_size());
@@ -485,7 +520,7 @@ const XSMMDispatch Compiler::GetXSMMDispatch(const stripe::Block& block) {
   return xsmmDispatch;
 }
 
-llvm::Function* Compiler::CompileThreadedBlock(const stripe::Block& block) {
+llvm::Function* Compiler::CompileThreadedBlock(const stripe::Block& block, std::size_t fixed_trip) {
   // Generate a function implementing the body of this block.
   // Buffers (refinements) will be passed in as function parameters, as will
   // the initial value for each index.
@@ -500,6 +535,9 @@ llvm::Function* Compiler::CompileThreadedBlock(const stripe::Block& block) {
   // create the LLVM function which will implement the Stripe block
   auto linkage = llvm::Function::ExternalLinkage;
   auto name = block.name;
+  if (fixed_trip) {
+    name += "$trip" + std::to_string(fixed_trip);
+  }
   auto func_type = BlockType(block);
   auto function = llvm::Function::Create(func_type, linkage, name, module_);
   // create a basic block; configure the builder to start there
@@ -534,12 +572,20 @@ llvm::Function* Compiler::CompileThreadedBlock(const stripe::Block& block) {
   // Third parameter is the composite index range begin.
   // Fourth parameter is the composite index range end.
   // We will use these to replace the init & limit values for index 0.
+  // A specialized version ignores the range end: its trip count is the
+  // compile-time constant fixed_trip, which lets LLVM unroll and
+  // vectorize the joint loop.  The caller guarantees the slice is exactly
+  // fixed_trip iterations long.
+  llvm::Value* limit = function->getArg(3);
+  if (fixed_trip) {
+    limit = builder_.CreateAdd(function->getArg(2), IndexConst(fixed_trip));
+  }
 
   // Construct the joint index loop
   Loop joint_loop;
   llvm::Value* joint_idx = builder_.CreateAlloca(IndexType());
   CreateLoop(&joint_loop, "joint_idx");
-  EnterLoop(&joint_loop, joint_idx, function->getArg(2), function->getArg(3));
+  EnterLoop(&joint_loop, joint_idx, function->getArg(2), limit);
 
   // Extract into specific index values
   llvm::Value* cur = builder_.CreateLoad(joint_idx);
@@ -581,6 +627,86 @@ llvm::Function* Compiler::CompileThreadedBlock(const stripe::Block& block) {
   return function;
 }
 
+llvm::Function* Compiler::CompileThreadedDispatch(const stripe::Block& block) {
+  // The joint loop over a thread's slice has runtime bounds, so the generic
+  // version loses the unrolling and vectorization that constant-range loops
+  // get.  Emit specialized versions of the block with fixed trip counts
+  // alongside the generic one, plus a stub with the same signature that
+  // strip-mines a slice through the specialized bodies, largest first, and
+  // hands any remainder to the generic version.  ParallelFor invokes the
+  // stub, so selection costs one compare per chunk, not per iteration.
+  static const std::size_t kTripSizes[] = {32, 8};
+  size_t total_range = 1;
+  for (auto& idx : block.idxs) {
+    total_range *= idx.range;
+  }
+  std::vector<std::pair<std::size_t, llvm::Function*>> versions;
+  if (!block.idxs.empty() && env::Get("PLAIDML_CPU_MULTIVERSION") != "0") {
+    for (std::size_t trip : kTripSizes) {
+      if (trip > total_range) {
+        continue;
+      }
+      Compiler nested(&context_, module_, config_);
+      auto version = nested.CompileThreadedBlock(block, trip);
+      for (auto& fptr_iter : nested.external_funcptrs_) {
+        external_funcptrs_.emplace(fptr_iter);
+      }
+      versions.emplace_back(trip, version);
+    }
+  }
+  Compiler nested(&context_, module_, config_);
+  auto generic = nested.CompileThreadedBlock(block);
+  for (auto& fptr_iter : nested.external_funcptrs_) {
+    external_funcptrs_.emplace(fptr_iter);
+  }
+  if (versions.empty()) {
+    return generic;
+  }
+
+  auto linkage = llvm::Function::ExternalLinkage;
+  auto func_type = BlockType(block);
+  auto stub = llvm::Function::Create(func_type, linkage, block.name + "$dispatch", module_);
+  auto bb = llvm::BasicBlock::Create(context_, "entry", stub);
+  builder_.SetInsertPoint(bb);
+  llvm::Value* refs = stub->getArg(0);
+  llvm::Value* inits = stub->getArg(1);
+  llvm::Value* end = stub->getArg(3);
+  llvm::Value* begin_var = builder_.CreateAlloca(IndexType());
+  begin_var->setName("begin");
+  builder_.CreateStore(stub->getArg(2), begin_var);
+  for (auto& version : versions) {
+    std::size_t trip = version.first;
+    // while (begin + trip <= end) { version(refs, inits, begin, begin + trip); begin += trip; }
+    std::string suffix = "_trip" + std::to_string(trip);
+    auto test = llvm::BasicBlock::Create(context_, "test" + suffix, stub);
+    auto body = llvm::BasicBlock::Create(context_, "body" + suffix, stub);
+    auto done = llvm::BasicBlock::Create(context_, "done" + suffix, stub);
+    builder_.CreateBr(test);
+    builder_.SetInsertPoint(test);
+    llvm::Value* begin = builder_.CreateLoad(begin_var);
+    llvm::Value* next = builder_.CreateAdd(begin, IndexConst(trip));
+    llvm::Value* go = builder_.CreateICmpULE(next, end);
+    builder_.CreateCondBr(go, body, done);
+    builder_.SetInsertPoint(body);
+    builder_.CreateCall(version.second, {refs, inits, begin, next});
+    builder_.CreateStore(next, begin_var);
+    builder_.CreateBr(test);
+    builder_.SetInsertPoint(done);
+  }
+  // Any remaining iterations run through the generic version
+  auto remainder = llvm::BasicBlock::Create(context_, "remainder", stub);
+  auto exit = llvm::BasicBlock::Create(context_, "exit", stub);
+  llvm::Value* begin = builder_.CreateLoad(begin_var);
+  llvm::Value* any = builder_.CreateICmpULT(begin, end);
+  builder_.CreateCondBr(any, remainder, exit);
+  builder_.SetInsertPoint(remainder);
+  builder_.CreateCall(generic, {refs, inits, begin, end});
+  builder_.CreateBr(exit);
+  builder_.SetInsertPoint(exit);
+  builder_.CreateRetVoid();
+  return stub;
+}
+
 llvm::Function* Compiler::CompileBlock(const stripe::Block& block) {
   CompileFor compileFor = getCompileFor(block);
   if (compileFor == XSMM_BLOCK) {
@@ -592,7 +718,7 @@ llvm::Function* Compiler::CompileBlock(const stripe::Block& block) {
       return CompileXSMMBlock(block, xsmmDispatch, xsmmCallData);
     }
   } else if (compileFor == THREADED_BLOCK) {
-    return CompileThreadedBlock(block);
+    return CompileThreadedDispatch(block);
   }
 
   // Generate a function implementing the body of this block.
@@ -709,6 +835,16 @@ void Compiler::Visit(const stripe::Load& load) {
   // Load the value from that address and use it to redefine the
   // destination scalar.
   llvm::Value* element = ElementPtr(from);
+  if (from.refinement->has_attr("prefetch")) {
+    // The prefetch pass stored how many elements this access advances over
+    // the next several innermost iterations; hint that address now so the
+    // line is resident by the time the loop reaches it.
+    std::vector<llvm::Value*> deltaList{IndexConst(from.refinement->get_attr_int("prefetch"))};
+    llvm::Value* ahead = builder_.CreateGEP(element, deltaList, load.from + "[ahead]");
+    llvm::Value* addr = builder_.CreateBitCast(ahead, builder_.getInt8PtrTy());
+    builder_.CreateIntrinsic(llvm::Intrinsic::prefetch, {addr->getType()},
+                             {addr, builder_.getInt32(0), builder_.getInt32(3), builder_.getInt32(1)});
+  }
   llvm::Value* value = builder_.CreateLoad(element, load.into);
   scalars_[load.into] = Scalar{value, from.refinement->interior_shape.type};
 }
@@ -929,6 +1065,11 @@ void Compiler::Visit(const stripe::Block& block) {
         auto baseArenaAddress = builder_.CreateLoad(arena);
         std::vector<llvm::Value*> idxList{IndexConst(ref.offset)};
         buffer = builder_.CreateGEP(baseArenaAddress, idxList);
+      } else if (ref.has_tag("register")) {
+        // A register-blocked scratch buffer (tagged by RegisterBlockingPass):
+        // keep it on the stack where SROA/mem2reg can promote the elements
+        // into registers, instead of a heap round-trip per invocation.
+        buffer = StackAlloc(ref.interior_shape.byte_size());
       } else {
         // Allocate new storage for the buffer.
         buffer = Malloc(ref.interior_shape.byte_size());
@@ -1469,13 +1610,27 @@ void Compiler::BitRight(const stripe::Intrinsic& stmt) {
 
 void Compiler::Sqrt(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "sqrtf", "sqrt"); }
 
-void Compiler::Exp(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "expf", "exp"); }
+void Compiler::Exp(const stripe::Intrinsic& stmt) {
+  if (config_.fast_math && stmt.type == DataType::FLOAT32 && stmt.inputs.size() == 1) {
+    Scalar op = Cast(scalars_[stmt.inputs[0]], stmt.type);
+    OutputType(EmitFastExpF32(op.value), stmt);
+    return;
+  }
+  CallIntrinsicFunc(stmt, "expf", "exp");
+}
 
 void Compiler::Log(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "logf", "log"); }
 
 void Compiler::Pow(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "powf", "pow", 2); }
 
-void Compiler::Tanh(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "tanhf", "tanh"); }
+void Compiler::Tanh(const stripe::Intrinsic& stmt) {
+  if (config_.fast_math && stmt.type == DataType::FLOAT32 && stmt.inputs.size() == 1) {
+    Scalar op = Cast(scalars_[stmt.inputs[0]], stmt.type);
+    OutputType(EmitFastTanhF32(op.value), stmt);
+    return;
+  }
+  CallIntrinsicFunc(stmt, "tanhf", "tanh");
+}
 
 void Compiler::Cos(const stripe::Intrinsic& stmt) { CallIntrinsicFunc(stmt, "cosf", "cos"); }
 
@@ -1655,8 +1810,50 @@ void Compiler::AggInitMax(const stripe::Special& agg_init) {
 
 void Compiler::AggInit(const Buffer& dest, llvm::Value* init_val) {
   // The initialization value depends on the refinement's agg_op.
-  // Iterate over each dimension and write to each element.
   auto& dest_shape = dest.refinement->interior_shape;
+  if (!init_val) {
+    throw Error("Undefined agg_op init for " + to_string(dest_shape.type));
+  }
+
+  // Dense interiors initialize as a flat span: a memset when the fill
+  // pattern is one repeated byte (zero for add, all-ones for an unsigned
+  // min, ...), otherwise a single unit-stride loop the LLVM vectorizer
+  // turns into wide stores.  Strided interiors fall through to the
+  // general per-dimension loop nest below.
+  size_t total = dest_shape.sizes_product();
+  if (total && dest_shape.elem_size() == total) {
+    llvm::APInt pattern;
+    bool have_pattern = false;
+    if (auto cint = llvm::dyn_cast<llvm::ConstantInt>(init_val)) {
+      pattern = cint->getValue();
+      have_pattern = true;
+    } else if (auto cfp = llvm::dyn_cast<llvm::ConstantFP>(init_val)) {
+      pattern = cfp->getValueAPF().bitcastToAPInt();
+      have_pattern = true;
+    }
+    if (have_pattern && pattern.getBitWidth() % 8 == 0) {
+      uint8_t byte = pattern.extractBits(8, 0).getZExtValue();
+      bool splat = true;
+      for (unsigned bit = 8; splat && bit < pattern.getBitWidth(); bit += 8) {
+        splat = pattern.extractBits(8, bit).getZExtValue() == byte;
+      }
+      if (splat) {
+        size_t size = total * byte_width(dest_shape.type);
+        builder_.CreateMemSet(dest.base, builder_.getInt8(byte), size, llvm::MaybeAlign(0));
+        return;
+      }
+    }
+    llvm::Value* idx_var = builder_.CreateAlloca(IndexType(), nullptr, "agg_init_idx");
+    Loop loop;
+    CreateLoop(&loop, "agg_init");
+    EnterLoop(&loop, idx_var, IndexConst(0), IndexConst(total));
+    llvm::Value* idx_val = builder_.CreateLoad(idx_var);
+    builder_.CreateStore(init_val, builder_.CreateGEP(dest.base, idx_val));
+    LeaveLoop(&loop, idx_var);
+    return;
+  }
+
+  // Iterate over each dimension and write to each element.
   size_t dest_ndims = dest_shape.dims.size();
 
   // Generate the limit value for each dimension.
@@ -1680,10 +1877,6 @@ void Compiler::AggInit(const Buffer& dest, llvm::Value* init_val) {
     EnterLoop(&loops[i], idx_vars[i], IndexConst(0), limits[i]);
   }
 
-  if (!init_val) {
-    throw Error("Undefined agg_op init for " + to_string(dest_shape.type));
-  }
-
   // Compute the element offset for these indexes.
   llvm::Value* dest_idx = IndexConst(0);
   for (size_t i = 0; i < dest_ndims; ++i) {
@@ -2066,6 +2259,75 @@ void Compiler::CallIntrinsicFunc(const stripe::Intrinsic& stmt, const char* name
   OutputType(ret, stmt);
 }
 
+// Emits a Cephes-style polynomial expf directly as IR.  Unlike a libm
+// call, the result is straight-line arithmetic (the clamps are
+// selects), so the loop and SLP vectorizers can widen eltwise blocks
+// that use it.  Accuracy is a few ulp over the clamped range.
+llvm::Value* Compiler::EmitFastExpF32(llvm::Value* x) {
+  auto f32 = builder_.getFloatTy();
+  auto i32 = builder_.getInt32Ty();
+  auto cst = [&](float v) { return llvm::ConstantFP::get(f32, v); };
+
+  // Clamp to the range where the result is finite and normal.
+  llvm::Value* hi = cst(88.3762626647949f);
+  llvm::Value* lo = cst(-87.3365478515625f);
+  x = builder_.CreateSelect(builder_.CreateFCmpOLT(x, hi), x, hi);
+  x = builder_.CreateSelect(builder_.CreateFCmpOGT(x, lo), x, lo);
+
+  // n = floor(x * log2(e) + 0.5); reduce x by n * ln(2) in two steps.
+  llvm::Value* fx = builder_.CreateFAdd(builder_.CreateFMul(x, cst(1.44269504088896341f)), cst(0.5f));
+  fx = builder_.CreateUnaryIntrinsic(llvm::Intrinsic::floor, fx);
+  x = builder_.CreateFSub(x, builder_.CreateFMul(fx, cst(0.693359375f)));
+  x = builder_.CreateFSub(x, builder_.CreateFMul(fx, cst(-2.12194440e-4f)));
+
+  // Polynomial for e^x on the reduced range.
+  llvm::Value* z = builder_.CreateFMul(x, x);
+  llvm::Value* y = cst(1.9875691500e-4f);
+  y = builder_.CreateFAdd(builder_.CreateFMul(y, x), cst(1.3981999507e-3f));
+  y = builder_.CreateFAdd(builder_.CreateFMul(y, x), cst(8.3334519073e-3f));
+  y = builder_.CreateFAdd(builder_.CreateFMul(y, x), cst(4.1665795894e-2f));
+  y = builder_.CreateFAdd(builder_.CreateFMul(y, x), cst(1.6666665459e-1f));
+  y = builder_.CreateFAdd(builder_.CreateFMul(y, x), cst(5.0000001201e-1f));
+  y = builder_.CreateFAdd(builder_.CreateFAdd(builder_.CreateFMul(y, z), x), cst(1.0f));
+
+  // Scale by 2^n via exponent-field bit twiddling.
+  llvm::Value* n = builder_.CreateFPToSI(fx, i32);
+  llvm::Value* pow2n = builder_.CreateBitCast(
+      builder_.CreateShl(builder_.CreateAdd(n, llvm::ConstantInt::get(i32, 127)), 23), f32);
+  return builder_.CreateFMul(y, pow2n);
+}
+
+// Emits a rational-polynomial tanhf as straight-line IR; same
+// vectorization rationale as EmitFastExpF32.
+llvm::Value* Compiler::EmitFastTanhF32(llvm::Value* x) {
+  auto f32 = builder_.getFloatTy();
+  auto cst = [&](float v) { return llvm::ConstantFP::get(f32, v); };
+
+  // tanh saturates to +/-1 just past 9; clamping there also keeps the
+  // rational approximation in its accurate range.
+  llvm::Value* hi = cst(9.0f);
+  llvm::Value* lo = cst(-9.0f);
+  x = builder_.CreateSelect(builder_.CreateFCmpOLT(x, hi), x, hi);
+  x = builder_.CreateSelect(builder_.CreateFCmpOGT(x, lo), x, lo);
+
+  llvm::Value* x2 = builder_.CreateFMul(x, x);
+  llvm::Value* p = cst(-2.76076847742355e-16f);
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(2.00018790482477e-13f));
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(-8.60467152213735e-11f));
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(5.12229709037114e-08f));
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(1.48572235717979e-05f));
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(6.37261928875436e-04f));
+  p = builder_.CreateFAdd(builder_.CreateFMul(p, x2), cst(4.89352455891786e-03f));
+  p = builder_.CreateFMul(p, x);
+
+  llvm::Value* q = cst(1.19825839466702e-06f);
+  q = builder_.CreateFAdd(builder_.CreateFMul(q, x2), cst(1.18534705686654e-04f));
+  q = builder_.CreateFAdd(builder_.CreateFMul(q, x2), cst(2.26843463243900e-03f));
+  q = builder_.CreateFAdd(builder_.CreateFMul(q, x2), cst(4.89352518554385e-03f));
+
+  return builder_.CreateFDiv(p, q);
+}
+
 llvm::Type* Compiler::IndexType() {
   unsigned archbits = module_->getDataLayout().getPointerSizeInBits();
   return llvm::IntegerType::get(context_, archbits);
@@ -2192,6 +2454,18 @@ void Compiler::EmitRunTimeLogEntry(const std::string& str, const std::string& ex
   builder_.CreateCall(RunTimeLogEntry(), log_args, "");
 }
 
+llvm::Value* Compiler::StackAlloc(size_t size) {
+  // Emit the alloca in the function's entry block so it's allocated once
+  // per call rather than once per loop iteration, and so SROA/mem2reg can
+  // promote the elements into registers.
+  auto func = builder_.GetInsertBlock()->getParent();
+  auto& entry = func->getEntryBlock();
+  llvm::IRBuilder<> entry_builder(&entry, entry.begin());
+  auto alloc = entry_builder.CreateAlloca(llvm::ArrayType::get(entry_builder.getInt8Ty(), size));
+  alloc->setAlignment(llvm::MaybeAlign(64));
+  return entry_builder.CreateBitCast(alloc, builder_.getInt8PtrTy());
+}
+
 void Compiler::Free(llvm::Value* buffer) {
   llvm::Type* ptrtype = builder_.getInt8PtrTy();
   std::vector<llvm::Type*> argtypes{ptrtype};
@@ -66,7 +66,8 @@ class Compiler : private stripe::ConstStmtVisitor {
   void GenerateArena(const stripe::Block& block);
   llvm::Function* CompileXSMMBlock(const stripe::Block& block, const XSMMDispatch xsmmDispatch,
                                    const XSMMCallData& xsmmCallData);
-  llvm::Function* CompileThreadedBlock(const stripe::Block& block);
+  llvm::Function* CompileThreadedBlock(const stripe::Block& block, std::size_t fixed_trip = 0);
+  llvm::Function* CompileThreadedDispatch(const stripe::Block& block);
   llvm::Function* CompileBlock(const stripe::Block& block);
   void Visit(const stripe::Load&) override;
   void Visit(const stripe::Store&) override;
@@ -168,6 +169,8 @@ class Compiler : private stripe::ConstStmtVisitor {
   void OutputBool(llvm::Value* ret, const stripe::Intrinsic&);
   void CallIntrinsicFunc(const stripe::Intrinsic&, const char* name_f32, const char* name_f64,
                          const size_t numParams = 1);
+  llvm::Value* EmitFastExpF32(llvm::Value* x);
+  llvm::Value* EmitFastTanhF32(llvm::Value* x);
   llvm::Type* IndexType();
   llvm::Value* IndexConst(ssize_t val);
   llvm::FunctionType* BlockType(const stripe::Block&);
@@ -175,6 +178,7 @@ class Compiler : private stripe::ConstStmtVisitor {
                                     llvm::Type* bPtrType, llvm::Type* cPtrType, const std::string& funcionName);
   llvm::Value* Malloc(size_t size);
   void Free(llvm::Value* buffer);
+  llvm::Value* StackAlloc(size_t size);
   llvm::Value* PrngStepFunction();
   llvm::Value* ReadCycleCounter();
   void ProfileBlockEnter(const stripe::Block& block);
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "base/util/env.h"
 #include "tile/stripe/stripe.h"
 
 namespace vertexai {
@@ -23,6 +24,18 @@ typedef std::function<void*(std::vector<DataType>*, DataType*)> External;
 struct Config {
   bool profile_block_execution = false;
   bool profile_loop_body = false;
+  // Inline polynomial approximations for f32 exp/tanh instead of
+  // calling scalar libm.  The emitted IR is branch- and call-free, so
+  // the loop vectorizer can widen whole eltwise blocks; accuracy is a
+  // few ulp over the clamped range.
+  bool fast_math = env::Get("PLAIDML_FAST_MATH") == "1";
+  // Target CPU for code generation, as an LLVM cpu name (e.g. "haswell",
+  // "skylake-avx512").  Empty targets the build host's CPU and full feature
+  // set.  Saved artifacts destined for a heterogeneous fleet should pin the
+  // fleet's baseline here, so that IR-level vectorization doesn't bake in
+  // vector widths the deployment machines lack; the deployment machine's
+  // own JIT still schedules for its exact CPU when it compiles the module.
+  std::string arch = env::Get("PLAIDML_CPU_ARCH");
   bool print_llvm_ir_simple = VLOG_IS_ON(3);
   bool print_llvm_ir_optimized = VLOG_IS_ON(4);
   bool print_assembly = VLOG_IS_ON(4);
@@ -2,26 +2,43 @@
 
 #include "tile/targets/cpu/executable.h"
 
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Memory.h>
 #include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
 #include <algorithm>
 #include <deque>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <half.hpp>
 
 #include "base/util/env.h"
 #include "base/util/lookup.h"
+#include "tile/base/artifact_cache.h"
+#include "tbb/global_control.h"
 #include "tbb/tbb.h"
 #include "tile/stripe/stripe.h"
 #include "tile/targets/cpu/link_names.h"
@@ -41,6 +58,196 @@ namespace tile {
 namespace targets {
 namespace cpu {
 
+namespace {
+
+// Persists JITted objects through the process-wide ArtifactCache, so a warm
+// process restart can skip LLVM codegen for programs it has seen before.
+class DiskObjectCache final : public llvm::ObjectCache {
+ public:
+  // In per-module mode (used when the program is split into partitions) each
+  // module's object is stored under the base key plus the module identifier.
+  explicit DiskObjectCache(const std::string& key, bool per_module = false) : key_(key), per_module_(per_module) {}
+
+  void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final {
+    ArtifactCache::Instance()->Put(Key(module), std::string(obj.getBufferStart(), obj.getBufferSize()));
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final {
+    auto key = Key(module);
+    std::string bytes;
+    if (!ArtifactCache::Instance()->TryGet(key, &bytes)) {
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(bytes, key);
+  }
+
+ private:
+  std::string Key(const llvm::Module* module) const {
+    if (!per_module_) {
+      return key_;
+    }
+    return key_ + "-" + module->getModuleIdentifier();
+  }
+
+  std::string key_;
+  bool per_module_;
+};
+
+// A process-wide executable heap shared by every Executable.  MCJIT's
+// default memory manager maps fresh pages for each engine, so a server
+// holding many compiled programs scatters its code across the address
+// space and pays for it in iTLB misses.  The heap instead packs function
+// sections from every engine into large shared slabs, split into a hot
+// region (entry invokers, plus any block function that consumed time
+// during a profiled run) and a cold one for everything else, so
+// steady-state instruction fetch touches as few pages as possible.
+// Code is never unmapped; programs stay resident for the life of the
+// process, which matches how multi-model servers use the JIT.
+// PLAIDML_CPU_CODE_HEAP=0 restores the per-engine default manager.
+class CodeHeap {
+ public:
+  static CodeHeap* Instance() {
+    static CodeHeap heap;
+    return &heap;
+  }
+
+  bool enabled() const { return enabled_; }
+
+  uint8_t* AllocateCode(uintptr_t size, unsigned alignment, bool hot) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return Carve(hot ? &hot_ : &cold_, size, alignment);
+  }
+
+  uint8_t* AllocateData(uintptr_t size, unsigned alignment) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return Carve(&data_, size, alignment);
+  }
+
+  // Flips every code slab to read+execute.  Called once per engine; slabs
+  // that take allocations for a later engine are made writable again until
+  // that engine finalizes.
+  bool Finalize(std::string* err_msg) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto* regions : {&hot_, &cold_}) {
+      for (auto& region : *regions) {
+        if (!region.writable) {
+          continue;
+        }
+        auto ec = llvm::sys::Memory::protectMappedMemory(region.block,
+                                                         llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_EXEC);
+        if (ec) {
+          if (err_msg) {
+            *err_msg = ec.message();
+          }
+          return true;
+        }
+        llvm::sys::Memory::InvalidateInstructionCache(region.block.base(), region.block.allocatedSize());
+        region.writable = false;
+      }
+    }
+    return false;
+  }
+
+  // Records a profiled block's time so later compiles place its function in
+  // the hot region; the usual flow is a JitProfile pass first, then the
+  // production compile with the measurements in hand.
+  void RecordTicks(const std::string& symbol, int64_t ticks) {
+    if (ticks <= 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock{mutex_};
+    hot_symbols_.insert(symbol);
+  }
+
+  bool IsHot(llvm::StringRef section_name) {
+    // Function sections are named ".text.<function>"; block functions may
+    // carry a "$trip<N>" or "$dispatch" decoration on top of the block name.
+    auto name = section_name;
+    name.consume_front(".text");
+    name.consume_front(".");
+    name = name.take_until([](char c) { return c == '$'; });
+    if (name.equals(invoker_name_)) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (hot_symbols_.empty()) {
+      // No profile has run; pack everything densely rather than guess.
+      return true;
+    }
+    return hot_symbols_.count(name.str()) != 0;
+  }
+
+ private:
+  struct Region {
+    llvm::sys::MemoryBlock block;
+    uintptr_t used = 0;
+    bool writable = true;
+  };
+
+  CodeHeap() : enabled_(env::Get("PLAIDML_CPU_CODE_HEAP") != "0") {}
+
+  uint8_t* Carve(std::vector<Region>* regions, uintptr_t size, unsigned alignment) {
+    if (alignment == 0) {
+      alignment = 16;
+    }
+    if (!regions->empty()) {
+      auto& region = regions->back();
+      uintptr_t offset = (region.used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+      if (offset + size <= region.block.allocatedSize()) {
+        if (!region.writable) {
+          llvm::sys::Memory::protectMappedMemory(region.block,
+                                                 llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE);
+          region.writable = true;
+        }
+        region.used = offset + size;
+        return reinterpret_cast<uint8_t*>(region.block.base()) + offset;
+      }
+    }
+    std::error_code ec;
+    auto block = llvm::sys::Memory::allocateMappedMemory(std::max<uintptr_t>(size, kSlabBytes), nullptr,
+                                                         llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE, ec);
+    if (ec) {
+      throw std::runtime_error("CodeHeap allocation failed: " + ec.message());
+    }
+    Region region;
+    region.block = block;
+    region.used = size;
+    regions->push_back(region);
+    return reinterpret_cast<uint8_t*>(block.base());
+  }
+
+  // One huge page's worth, so a well-packed hot region can sit under a
+  // single iTLB entry on hosts with transparent huge pages.
+  static constexpr uintptr_t kSlabBytes = 2 << 20;
+
+  bool enabled_;
+  std::mutex mutex_;
+  std::vector<Region> hot_;
+  std::vector<Region> cold_;
+  std::vector<Region> data_;
+  std::set<std::string> hot_symbols_;
+};
+
+// Carves each engine's sections out of the shared CodeHeap instead of
+// mapping private pages.
+class HeapMemoryManager final : public llvm::RTDyldMemoryManager {
+ public:
+  uint8_t* allocateCodeSection(uintptr_t size, unsigned alignment, unsigned section_id,
+                               llvm::StringRef section_name) final {
+    auto heap = CodeHeap::Instance();
+    return heap->AllocateCode(size, alignment, heap->IsHot(section_name));
+  }
+
+  uint8_t* allocateDataSection(uintptr_t size, unsigned alignment, unsigned section_id, llvm::StringRef section_name,
+                               bool is_read_only) final {
+    return CodeHeap::Instance()->AllocateData(size, alignment);
+  }
+
+  bool finalizeMemory(std::string* err_msg) final { return CodeHeap::Instance()->Finalize(err_msg); }
+};
+
+}  // namespace
+
 class Runtime : public llvm::LegacyJITSymbolResolver {
  public:
   explicit Runtime(const std::map<std::string, void*> externals) : externals_(externals) {}
@@ -51,21 +258,85 @@ class Runtime : public llvm::LegacyJITSymbolResolver {
   std::map<std::string, void*> externals_;
 };
 
-Executable::Executable(const ProgramModule& module) : parameters_(module.parameters) {
+namespace {
+
+// Adapts Runtime's symbol resolution (support functions, externals, process
+// symbols) to ORC, so every partition resolves against the same table.
+class RuntimeDefinitionGenerator final : public llvm::orc::DefinitionGenerator {
+ public:
+  explicit RuntimeDefinitionGenerator(const std::map<std::string, void*>& externals) : runtime_(externals) {}
+
+  llvm::Error tryToGenerate(llvm::orc::LookupState& ls, llvm::orc::LookupKind kind, llvm::orc::JITDylib& jd,
+                            llvm::orc::JITDylibLookupFlags flags, const llvm::orc::SymbolLookupSet& names) final {
+    llvm::orc::SymbolMap syms;
+    for (const auto& kvp : names) {
+      auto name = (*kvp.first).str();
+      try {
+        auto sym = runtime_.findSymbol(name);
+        if (auto addr = sym.getAddress()) {
+          syms[kvp.first] = llvm::JITEvaluatedSymbol(*addr, llvm::JITSymbolFlags::Exported);
+        }
+      } catch (const std::runtime_error&) {
+        // Leave the symbol undefined; ORC reports the unresolved reference.
+      }
+    }
+    if (syms.empty()) {
+      return llvm::Error::success();
+    }
+    return jd.define(llvm::orc::absoluteSymbols(std::move(syms)));
+  }
+
+ private:
+  Runtime runtime_;
+};
+
+}  // namespace
+
+Executable::Executable(const ProgramModule& module, const std::string& cache_key) : parameters_(module.parameters) {
+  assert(module.module);
+  if (BuildParallelEngine(module, cache_key)) {
+    return;
+  }
   std::string errStr;
+  if (!cache_key.empty() && ArtifactCache::Instance()->enabled()) {
+    object_cache_ = std::make_unique<DiskObjectCache>(cache_key);
+  }
   std::unique_ptr<llvm::LegacyJITSymbolResolver> rez(new Runtime(module.externals));
-  assert(module.module);
   std::unique_ptr<llvm::Module> clone(llvm::CloneModule(*module.module));
-  auto ee = llvm::EngineBuilder(std::move(clone))
-                .setErrorStr(&errStr)
-                .setEngineKind(llvm::EngineKind::JIT)
-                .setVerifyModules(true)
-                .setSymbolResolver(std::move(rez))
-                .create();
+  // Codegen for the host CPU and its feature set (F16C, AVX-512, etc.) so
+  // that the vector IR the Compiler produces lowers to vector instructions;
+  // the EngineBuilder default is a generic machine.
+  std::vector<std::string> mattrs;
+  llvm::StringMap<bool> feature_map;
+  if (llvm::sys::getHostCPUFeatures(feature_map)) {
+    for (const auto& feature : feature_map) {
+      mattrs.push_back((feature.second ? "+" : "-") + feature.first().str());
+    }
+  }
+  llvm::EngineBuilder builder(std::move(clone));
+  builder.setErrorStr(&errStr)
+      .setEngineKind(llvm::EngineKind::JIT)
+      .setVerifyModules(true)
+      .setMCPU(llvm::sys::getHostCPUName())
+      .setMAttrs(mattrs)
+      .setSymbolResolver(std::move(rez));
+  if (CodeHeap::Instance()->enabled()) {
+    // Give each function its own section so the shared heap can pack hot
+    // entry code densely and segregate the cold remainder; with a single
+    // .text per module the split would be all-or-nothing.
+    llvm::TargetOptions topts;
+    topts.FunctionSections = true;
+    builder.setTargetOptions(topts);
+    builder.setMCJITMemoryManager(std::make_unique<HeapMemoryManager>());
+  }
+  auto ee = builder.create();
   if (ee) {
     if (env::Get("VTUNE_PROFILE") == "1") {
       ee->RegisterJITEventListener(llvm::JITEventListener::createIntelJITEventListener());
     }
+    if (object_cache_) {
+      ee->setObjectCache(object_cache_.get());
+    }
     ee->finalizeObject();
     engine_.reset(ee);
   } else {
@@ -73,13 +344,131 @@ Executable::Executable(const ProgramModule& module) : parameters_(module.paramet
   }
 }
 
+Executable::~Executable() = default;
+
+bool Executable::BuildParallelEngine(const ProgramModule& module, const std::string& cache_key) {
+  if (env::Get("PLAIDML_CPU_PARALLEL_JIT") == "0") {
+    return false;
+  }
+  unsigned parts = std::thread::hardware_concurrency();
+  auto threads = env::Get("PLAIDML_CPU_COMPILE_THREADS");
+  if (!threads.empty()) {
+    parts = std::max(1, std::atoi(threads.c_str()));
+  }
+  if (parts <= 1) {
+    return false;
+  }
+
+  auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!jtmb) {
+    llvm::consumeError(jtmb.takeError());
+    return false;
+  }
+  if (CodeHeap::Instance()->enabled()) {
+    // Per-function sections, for the same hot/cold packing the MCJIT path
+    // gets (see CodeHeap).
+    jtmb->getOptions().FunctionSections = true;
+  }
+
+  llvm::orc::LLJITBuilder builder;
+  builder.setJITTargetMachineBuilder(std::move(*jtmb));
+  builder.setNumCompileThreads(parts);
+  if (!cache_key.empty() && ArtifactCache::Instance()->enabled()) {
+    object_cache_ = std::make_unique<DiskObjectCache>(cache_key, /*per_module=*/true);
+    builder.setCompileFunctionCreator(
+        [cache = object_cache_.get()](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), cache);
+        });
+  }
+  if (CodeHeap::Instance()->enabled()) {
+    builder.setObjectLinkingLayerCreator(
+        [](llvm::orc::ExecutionSession& es,
+           const llvm::Triple& triple) -> llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>> {
+          auto layer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+              es, []() { return std::make_unique<HeapMemoryManager>(); });
+          if (env::Get("VTUNE_PROFILE") == "1") {
+            layer->registerJITEventListener(*llvm::JITEventListener::createIntelJITEventListener());
+          }
+          return layer;
+        });
+  }
+  auto jit = builder.create();
+  if (!jit) {
+    llvm::consumeError(jit.takeError());
+    return false;
+  }
+  lljit_ = std::move(*jit);
+  lljit_->getMainJITDylib().addGenerator(std::make_unique<RuntimeDefinitionGenerator>(module.externals));
+
+  // Split the program into linkable partitions.  Each partition gets its own
+  // LLVMContext (via a bitcode round-trip) so the compile pool can work on
+  // them concurrently, and each materializes only when one of its symbols is
+  // first referenced: looking up the invoker links its partition, whose
+  // batched references to the other partitions' block functions fan their
+  // compiles out across the pool, while partitions nothing ends up calling
+  // never compile at all.
+  std::unique_ptr<llvm::Module> clone(llvm::CloneModule(*module.module));
+  bool failed = false;
+  unsigned idx = 0;
+  llvm::SplitModule(*clone, parts, [&](std::unique_ptr<llvm::Module> part) {
+    if (failed) {
+      return;
+    }
+    llvm::SmallString<0> bits;
+    llvm::raw_svector_ostream os(bits);
+    llvm::WriteBitcodeToFile(*part, os);
+    auto part_id = "part" + std::to_string(idx++);
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto loaded = llvm::parseBitcodeFile(llvm::MemoryBufferRef(llvm::StringRef(bits.data(), bits.size()), part_id),
+                                         *context);
+    if (!loaded) {
+      llvm::consumeError(loaded.takeError());
+      failed = true;
+      return;
+    }
+    (*loaded)->setModuleIdentifier(part_id);
+    if (auto err = lljit_->addIRModule(llvm::orc::ThreadSafeModule(std::move(*loaded), std::move(context)))) {
+      llvm::consumeError(std::move(err));
+      failed = true;
+    }
+  });
+  if (failed) {
+    lljit_.reset();
+    object_cache_.reset();
+    return false;
+  }
+  return true;
+}
+
+uint64_t Executable::GlobalAddress(const std::string& name) {
+  if (lljit_) {
+    auto sym = lljit_->lookup(name);
+    if (!sym) {
+      llvm::consumeError(sym.takeError());
+      return 0;
+    }
+    return sym->getAddress();
+  }
+  return engine_->getGlobalValueAddress(name);
+}
+
 void Executable::Run(const std::map<std::string, void*>& buffers) {
   std::vector<void*> args(parameters_.size());
   for (size_t i = 0; i < args.size(); ++i) {
     args[i] = safe_at(buffers, parameters_[i]);
   }
   void* argvec = args.data();
-  uint64_t entrypoint = engine_->getFunctionAddress(invoker_name_);
+  uint64_t entrypoint;
+  if (lljit_) {
+    auto sym = lljit_->lookup(invoker_name_);
+    if (!sym) {
+      throw std::runtime_error("Failed to resolve program entry: " + llvm::toString(sym.takeError()));
+    }
+    entrypoint = sym->getAddress();
+  } else {
+    entrypoint = engine_->getFunctionAddress(invoker_name_);
+  }
   // To get the raw execution time for generated code.
   auto start = std::chrono::high_resolution_clock::now();
   ((void (*)(void*))entrypoint)(argvec);
@@ -93,17 +482,21 @@ void Executable::SetPerfAttrs(stripe::Block* block) {
   // Apply their values as tags.
   std::string block_id = block->name + "@" + std::to_string((uintptr_t)block);
   std::string count_name = profile_count_name_ + block_id;
-  uint64_t count_addr = engine_->getGlobalValueAddress(count_name);
+  uint64_t count_addr = GlobalAddress(count_name);
   if (count_addr) {
     block->set_attr("execution_count", *reinterpret_cast<int64_t*>(count_addr));
   }
   std::string ticks_name = profile_ticks_name_ + block_id;
-  uint64_t ticks_addr = engine_->getGlobalValueAddress(ticks_name);
+  uint64_t ticks_addr = GlobalAddress(ticks_name);
   if (ticks_addr) {
-    block->set_attr("execution_ticks", *reinterpret_cast<int64_t*>(ticks_addr));
+    int64_t ticks = *reinterpret_cast<int64_t*>(ticks_addr);
+    block->set_attr("execution_ticks", ticks);
+    // Feed the measurement back to the code heap so later compiles place
+    // this block's function among the hot entries.
+    CodeHeap::Instance()->RecordTicks(block->name, ticks);
   }
   std::string loop_body_name = profile_loop_body_name_ + block_id;
-  uint64_t loop_ticks_addr = engine_->getGlobalValueAddress(loop_body_name);
+  uint64_t loop_ticks_addr = GlobalAddress(loop_body_name);
   if (loop_ticks_addr) {
     block->set_attr("loop_body_ticks", *reinterpret_cast<int64_t*>(loop_ticks_addr));
   }
@@ -144,6 +537,22 @@ void XSMMRTCaller(libxsmm_function func, const void* aPtr, const void* bPtr, voi
 
 typedef void (*cpu_thread_block)(void** refs, ssize_t* inits, size_t range_begin, size_t range_end);
 void ParallelFor(void** refs, ssize_t* inits, size_t range_size, cpu_thread_block func) {
+  // The scheduler's worker pool is created on first use and persists across
+  // invocations.  PLAIDML_CPU_THREADS caps its size explicitly; failing
+  // that, the process-wide intra-op budget (PLAIDML_INTRA_OP_THREADS /
+  // PLAIDML_RESERVED_CORES) applies, and by default every core is available.
+  static std::unique_ptr<tbb::global_control> control = []() -> std::unique_ptr<tbb::global_control> {
+    auto threads = env::Get("PLAIDML_CPU_THREADS");
+    if (threads.size()) {
+      return std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism,
+                                                   std::max(1, std::atoi(threads.c_str())));
+    }
+    if (env::Get("PLAIDML_INTRA_OP_THREADS").empty() && env::Get("PLAIDML_RESERVED_CORES").empty()) {
+      return nullptr;
+    }
+    return std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism,
+                                                 env::IntraOpThreadBudget());
+  }();
   tbb::parallel_for(tbb::blocked_range<size_t>(0, range_size),
                     [=](const tbb::blocked_range<size_t>& r) { func(refs, inits, r.begin(), r.end()); });
 }
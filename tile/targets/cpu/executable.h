@@ -3,6 +3,7 @@
 #pragma once
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 
 #include <map>
 #include <memory>
@@ -12,6 +13,12 @@
 #include "tile/stripe/stripe.h"
 #include "tile/targets/cpu/programmodule.h"
 
+namespace llvm {
+namespace orc {
+class LLJIT;
+}  // namespace orc
+}  // namespace llvm
+
 namespace vertexai {
 namespace tile {
 namespace targets {
@@ -19,13 +26,27 @@ namespace cpu {
 
 class Executable {
  public:
-  explicit Executable(const ProgramModule& module);
+  // When a non-empty cache key is supplied and the program cache is enabled
+  // (PLAIDML_PROGRAM_CACHE), the JITted object is stored under the key and
+  // reused on later runs, skipping LLVM codegen entirely.
+  explicit Executable(const ProgramModule& module, const std::string& cache_key = "");
+  ~Executable();
   void Run(const std::map<std::string, void*>& buffers);
   void Save(const std::string& filename);
   void SetPerfAttrs(stripe::Block* block);
 
  private:
+  // Splits the program into per-kernel partitions and compiles them on an
+  // ORC JIT with a compile thread pool; returns false when the parallel
+  // path is disabled or unavailable, leaving construction to MCJIT.
+  bool BuildParallelEngine(const ProgramModule& module, const std::string& cache_key);
+
+  // Resolves a JITted global's address on whichever engine was built.
+  uint64_t GlobalAddress(const std::string& name);
+
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
   std::unique_ptr<llvm::ExecutionEngine> engine_;
+  std::unique_ptr<llvm::orc::LLJIT> lljit_;
   std::vector<std::string> parameters_;
 };
 
@@ -0,0 +1,107 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/targets/cpu/heatmap_model.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "base/util/env.h"
+#include "tile/targets/cpu/heatmap.h"
+
+namespace vertexai {
+namespace tile {
+namespace targets {
+namespace cpu {
+
+std::shared_ptr<Heatmap> Heatmap::Builtin() {
+  auto result = std::make_shared<Heatmap>();
+  for (uint64_t i = 0; i < kHeatmapSize; i++) {
+    result->Insert(kHeatmapKeys[i][0], kHeatmapKeys[i][1], kHeatmapKeys[i][2], kHeatmapValues[i]);
+  }
+  return result;
+}
+
+std::shared_ptr<Heatmap> Heatmap::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Unable to read heatmap: " + path);
+  }
+  auto result = std::make_shared<Heatmap>();
+  std::string line;
+  size_t lineno = 0;
+  while (std::getline(file, line)) {
+    lineno++;
+    if (line.empty() || (lineno == 1 && line.rfind("M,", 0) == 0)) {
+      continue;  // Skip the "M,N,K,GFLOPS" header.
+    }
+    unsigned m, n, k;
+    double gflops;
+    char c1, c2, c3;
+    std::istringstream row(line);
+    if (!(row >> m >> c1 >> n >> c2 >> k >> c3 >> gflops) || c1 != ',' || c2 != ',' || c3 != ',') {
+      throw std::runtime_error("Malformed heatmap row at " + path + ":" + std::to_string(lineno));
+    }
+    result->Insert(m, n, k, gflops);
+  }
+  if (!result->size()) {
+    throw std::runtime_error("Empty heatmap: " + path);
+  }
+  return result;
+}
+
+std::shared_ptr<Heatmap> Heatmap::Default() {
+  static std::mutex mu;
+  static std::shared_ptr<Heatmap> heatmap;
+  std::lock_guard<std::mutex> lock{mu};
+  if (!heatmap) {
+    auto path = env::Get("PLAIDML_CPU_HEATMAP");
+    heatmap = path.empty() ? Builtin() : Load(path);
+  }
+  return heatmap;
+}
+
+double Heatmap::Throughput(unsigned m, unsigned n, unsigned k) const {
+  auto it = table_.find(std::make_tuple(m, n, k));
+  if (it != table_.end()) {
+    return it->second;
+  }
+  // Interpolate along K: the keys sort by (m, n, k), so the nearest
+  // measured neighbors at the same (m, n) bracket the lookup position.
+  auto upper = table_.lower_bound(std::make_tuple(m, n, k));
+  if (upper != table_.end() && upper != table_.begin()) {
+    auto lower = std::prev(upper);
+    if (std::get<0>(upper->first) == m && std::get<1>(upper->first) == n &&  //
+        std::get<0>(lower->first) == m && std::get<1>(lower->first) == n) {
+      unsigned k0 = std::get<2>(lower->first);
+      unsigned k1 = std::get<2>(upper->first);
+      double t = static_cast<double>(k - k0) / (k1 - k0);
+      return lower->second + t * (upper->second - lower->second);
+    }
+  }
+  // Otherwise average the adjacent measured N columns, if both exist.
+  auto n0 = table_.find(std::make_tuple(m, n - 1, k));
+  auto n1 = table_.find(std::make_tuple(m, n + 1, k));
+  if (n1 != table_.end()) {
+    if (n0 != table_.end()) {
+      return (n0->second + n1->second) / 2;
+    }
+    if (n == 1) {
+      return n1->second;
+    }
+  }
+  // Lastly the adjacent measured M rows.
+  auto m0 = table_.find(std::make_tuple(m - 1, n, k));
+  auto m1 = table_.find(std::make_tuple(m + 1, n, k));
+  if (m0 != table_.end() && m1 != table_.end()) {
+    return (m0->second + m1->second) / 2;
+  }
+  return 0.0;
+}
+
+}  // namespace cpu
+}  // namespace targets
+}  // namespace tile
+}  // namespace vertexai
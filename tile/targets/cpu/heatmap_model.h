@@ -0,0 +1,61 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace vertexai {
+namespace tile {
+namespace targets {
+namespace cpu {
+
+// A GEMM microkernel throughput table: measured GFLOPS keyed by the
+// (M, N, K) shape of the inner tile.  One instance wraps either the
+// heatmap compiled into the binary at build time or one recorded on the
+// deployment hardware and loaded from a CSV file at runtime.
+class Heatmap {
+ public:
+  // The heatmap baked in at build time (see the heatmap rule in BUILD).
+  static std::shared_ptr<Heatmap> Builtin();
+  // Loads an "M,N,K,GFLOPS" CSV, the same format the build-time table is
+  // generated from and tools/heatmap/record writes.  Throws on malformed
+  // input or an unreadable path.
+  static std::shared_ptr<Heatmap> Load(const std::string& path);
+  // The heatmap named by PLAIDML_CPU_HEATMAP if that's set, otherwise the
+  // builtin one; loaded once and shared.
+  static std::shared_ptr<Heatmap> Default();
+
+  // Estimated GFLOPS for an (m, n, k) microkernel.  Exact entries are
+  // returned as measured; shapes between measured points are linearly
+  // interpolated from their nearest neighbors along one axis; zero means
+  // the shape is outside the measured envelope.
+  double Throughput(unsigned m, unsigned n, unsigned k) const;
+
+  // The best measured GFLOPS across all shapes; a practical machine peak
+  // for "percent of peak" style reporting.
+  double Peak() const {
+    double peak = 0.0;
+    for (const auto& kvp : table_) {
+      peak = std::max(peak, kvp.second);
+    }
+    return peak;
+  }
+
+  size_t size() const { return table_.size(); }
+
+  void Insert(unsigned m, unsigned n, unsigned k, double gflops) {
+    table_[std::make_tuple(m, n, k)] = gflops;
+  }
+
+ private:
+  std::map<std::tuple<unsigned, unsigned, unsigned>, double> table_;
+};
+
+}  // namespace cpu
+}  // namespace targets
+}  // namespace tile
+}  // namespace vertexai
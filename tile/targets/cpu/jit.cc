@@ -8,6 +8,7 @@
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Utils/Cloning.h>
@@ -15,11 +16,13 @@
 #include <algorithm>
 #include <deque>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include <half.hpp>
 
 #include "base/util/lookup.h"
+#include "tile/base/artifact_cache.h"
 #include "tile/stripe/stripe.h"
 #include "tile/targets/cpu/compiler.h"
 #include "tile/targets/cpu/executable.h"
@@ -30,6 +33,25 @@ namespace tile {
 namespace targets {
 namespace cpu {
 
+namespace {
+
+// Builds a program-cache key covering everything that affects the generated
+// object: the canonical Stripe program plus the config bits the Compiler
+// consults.  Externals are resolved by symbol name at load time, so they
+// don't invalidate a cached object.
+std::string CacheKey(const stripe::Block& program, const Config& config) {
+  if (!ArtifactCache::Instance()->enabled()) {
+    return "";
+  }
+  std::ostringstream key;
+  key << "cpu-jit-" << (config.arch.empty() ? llvm::sys::getHostCPUName().str() : config.arch);
+  key << "-" << std::hex << stripe::CanonicalHash(program) << std::dec;
+  key << "-" << config.profile_block_execution << config.profile_loop_body;
+  return key.str();
+}
+
+}  // namespace
+
 struct Native::Impl {
   llvm::LLVMContext context;
   ProgramModule module;
@@ -39,7 +61,7 @@ struct Native::Impl {
     Compiler compiler(&context, config);
     module = compiler.CompileProgram(program);
     assert(module.module);
-    executable.reset(new Executable(module));
+    executable.reset(new Executable(module, CacheKey(program, config)));
   }
 
   void run(const std::map<std::string, void*>& buffers) { executable->Run(buffers); }
@@ -70,7 +92,7 @@ void JitExecute(const stripe::Block& program, const Config& config, const std::m
   llvm::LLVMContext context;
   Compiler compiler(&context, config);
   auto module = compiler.CompileProgram(program);
-  Executable executable(std::move(module));
+  Executable executable(std::move(module), CacheKey(program, config));
   executable.Run(buffers);
 }
 
@@ -80,7 +102,7 @@ void JitProfile(stripe::Block* program, const std::map<std::string, void*>& buff
   config.profile_block_execution = true;
   Compiler compiler(&context, config);
   auto module = compiler.CompileProgram(*program);
-  Executable executable(std::move(module));
+  Executable executable(std::move(module), CacheKey(*program, config));
   executable.Run(buffers);
   executable.SetPerfAttrs(program);
 }
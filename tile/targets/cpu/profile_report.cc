@@ -0,0 +1,164 @@
+// Copyright 2019, Intel Corporation.
+
+#include "tile/targets/cpu/profile_report.h"
+
+#include <iomanip>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "tile/targets/cpu/heatmap_model.h"
+
+namespace vertexai {
+namespace tile {
+namespace targets {
+namespace cpu {
+
+namespace {
+
+// One report row, gathered from a profiled block's attrs and statements.
+struct Row {
+  std::string name;
+  size_t depth = 0;
+  int64_t trips = 0;
+  int64_t total_ticks = 0;
+  int64_t self_ticks = 0;
+  int64_t flops_per_trip = 0;
+  int64_t bytes_per_trip = 0;
+};
+
+// Arithmetic intrinsics counted as one floating-point op each.
+const std::set<std::string> kFlopIntrinsics = {
+    "add", "sub", "mul", "div", "neg", "sqrt", "exp", "log", "tanh", "max", "min", "cond",
+};
+
+int64_t CountFlops(const stripe::Block& block) {
+  int64_t flops = 0;
+  for (const auto& stmt : block.stmts) {
+    auto intr = stripe::Intrinsic::Downcast(stmt);
+    if (intr && is_float(intr->type) && kFlopIntrinsics.count(intr->name)) {
+      flops++;
+    }
+  }
+  return flops;
+}
+
+int64_t CountBytes(const stripe::Block& block) {
+  int64_t bytes = 0;
+  for (const auto& stmt : block.stmts) {
+    std::string ref_name;
+    if (auto load = stripe::Load::Downcast(stmt)) {
+      ref_name = load->from;
+    } else if (auto store = stripe::Store::Downcast(stmt)) {
+      ref_name = store->into;
+    } else {
+      continue;
+    }
+    auto it = block.ref_by_into(ref_name, false);
+    if (it != block.refs.end()) {
+      bytes += byte_width(it->interior_shape.type);
+    }
+  }
+  return bytes;
+}
+
+void GatherRows(const stripe::Block& block, size_t depth, std::vector<Row>* rows) {
+  Row row;
+  row.name = block.name.empty() ? "(unnamed)" : block.name;
+  row.depth = depth;
+  bool profiled = block.has_attr("execution_count") && block.has_attr("execution_ticks");
+  if (profiled) {
+    row.trips = block.get_attr_int("execution_count");
+    row.total_ticks = block.get_attr_int("execution_ticks");
+    row.self_ticks = row.total_ticks;
+    row.flops_per_trip = CountFlops(block);
+    row.bytes_per_trip = CountBytes(block);
+  }
+  size_t row_pos = rows->size();
+  rows->push_back(row);
+  for (const auto& stmt : block.stmts) {
+    auto inner = stripe::Block::Downcast(stmt);
+    if (inner) {
+      if (inner->has_attr("execution_ticks")) {
+        (*rows)[row_pos].self_ticks -= inner->get_attr_int("execution_ticks");
+      }
+      GatherRows(*inner, depth + 1, rows);
+    }
+  }
+  // A block that was never instrumented (or never entered) isn't worth a row
+  // unless it has profiled descendants, which got their own rows above.
+  if (!profiled) {
+    (*rows)[row_pos].self_ticks = 0;
+  }
+}
+
+std::string Indent(size_t depth, const std::string& name) {  //
+  return std::string(2 * depth, ' ') + name;
+}
+
+}  // namespace
+
+void WriteProfileReport(const stripe::Block& entry, const ProfileReportOptions& options, std::ostream& os) {
+  std::vector<Row> rows;
+  GatherRows(entry, 0, &rows);
+
+  int64_t program_ticks = 0;
+  for (const auto& row : rows) {
+    if (row.depth == 0) {
+      program_ticks = row.total_ticks;
+    }
+  }
+
+  double peak_gflops = options.peak_gflops;
+  if (peak_gflops == 0.0 && options.clock_ghz != 0.0) {
+    peak_gflops = Heatmap::Default()->Peak();
+  }
+
+  bool with_time = options.clock_ghz != 0.0;
+  os << boost::format("%-40s %12s %14s %14s %7s") % "block" % "trips" % "total_cycles" % "self_cycles" % "prog%";
+  if (with_time) {
+    os << boost::format(" %10s %9s") % "self_ms" % "gflops";
+    if (peak_gflops != 0.0) {
+      os << boost::format(" %6s") % "peak%";
+    }
+    os << boost::format(" %9s") % "gbps";
+    if (options.peak_gbps != 0.0) {
+      os << boost::format(" %7s") % "stream%";
+    }
+  }
+  os << "\n";
+
+  for (const auto& row : rows) {
+    if (row.trips == 0 && row.total_ticks == 0) {
+      continue;
+    }
+    double prog_pct = program_ticks ? 100.0 * row.total_ticks / program_ticks : 0.0;
+    os << boost::format("%-40s %12d %14d %14d %6.1f%%")  //
+              % Indent(row.depth, row.name) % row.trips % row.total_ticks % row.self_ticks % prog_pct;
+    if (with_time) {
+      double self_secs = row.self_ticks / (options.clock_ghz * 1e9);
+      double gflops = 0.0;
+      double gbps = 0.0;
+      if (self_secs > 0.0) {
+        gflops = row.flops_per_trip * row.trips / self_secs / 1e9;
+        gbps = row.bytes_per_trip * row.trips / self_secs / 1e9;
+      }
+      os << boost::format(" %10.3f %9.2f") % (self_secs * 1e3) % gflops;
+      if (peak_gflops != 0.0) {
+        os << boost::format(" %5.1f%%") % (100.0 * gflops / peak_gflops);
+      }
+      os << boost::format(" %9.2f") % gbps;
+      if (options.peak_gbps != 0.0) {
+        os << boost::format(" %6.1f%%") % (100.0 * gbps / options.peak_gbps);
+      }
+    }
+    os << "\n";
+  }
+}
+
+}  // namespace cpu
+}  // namespace targets
+}  // namespace tile
+}  // namespace vertexai
@@ -0,0 +1,40 @@
+// Copyright 2019, Intel Corporation.
+
+#pragma once
+
+#include <ostream>
+
+#include "tile/stripe/stripe.h"
+
+namespace vertexai {
+namespace tile {
+namespace targets {
+namespace cpu {
+
+struct ProfileReportOptions {
+  // Clock rate used to convert rdtsc cycle counts into wall time and
+  // throughput figures.  Zero means unknown: the report then sticks to
+  // cycles and percentages, which are still enough to rank blocks.
+  double clock_ghz = 0.0;
+  // Compute peak in GFLOPS for the "% of peak" column; zero means use the
+  // best entry in the GEMM heatmap for this machine.
+  double peak_gflops = 0.0;
+  // Memory bandwidth peak in GB/s (e.g. a measured STREAM triad number)
+  // for the "% of stream" column; zero omits the column, since there's no
+  // portable built-in source for it.
+  double peak_gbps = 0.0;
+};
+
+// Renders the per-block performance report for a block tree annotated by
+// JitProfile/set_perf_attrs (execution_count/execution_ticks attrs).  One
+// row per profiled block: trips, cycles (total and self, i.e. excluding
+// nested profiled blocks), share of program cycles, and - when a clock
+// rate is known - time, effective GFLOPS against the heatmap peak and
+// bytes/s against the supplied bandwidth peak, estimated from the block's
+// own loads, stores, and arithmetic intrinsics.
+void WriteProfileReport(const stripe::Block& entry, const ProfileReportOptions& options, std::ostream& os);
+
+}  // namespace cpu
+}  // namespace targets
+}  // namespace tile
+}  // namespace vertexai
@@ -1,13 +1,98 @@
 #include "tile/targets/targets.h"
 
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+
 #include "base/config/config.h"
+#include "base/util/env.h"
+#include "base/util/file.h"
+#include "base/util/logging.h"
 #include "tile/targets/configs.h"
 
+namespace fs = boost::filesystem;
+
 namespace vertexai {
 namespace tile {
 namespace targets {
 
-codegen::proto::Configs GetConfigs() { return ParseConfig<codegen::proto::Configs>(kConfigs); }
+namespace {
+
+std::shared_ptr<const codegen::proto::Configs> Builtin() {
+  // Parsing the embedded config blob costs hundreds of milliseconds; do it
+  // exactly once per process and share the result immutably.
+  static const auto configs =
+      std::make_shared<const codegen::proto::Configs>(ParseConfig<codegen::proto::Configs>(kConfigs));
+  return configs;
+}
+
+// The most recently loaded override snapshot and the file identity it came
+// from.  A reload swaps in a fresh snapshot; compiles still holding the old
+// shared_ptr finish against the configs they started with.
+struct OverrideState {
+  std::shared_ptr<const codegen::proto::Configs> configs;
+  std::string version;
+  std::time_t mtime = 0;
+  uintmax_t size = 0;
+};
+
+}  // namespace
+
+std::shared_ptr<const codegen::proto::Configs> GetConfigs(std::string* version) {
+  auto path = env::Get("PLAIDML_TARGET_CONFIG");
+  if (path.empty()) {
+    if (version) {
+      *version = "builtin";
+    }
+    return Builtin();
+  }
+  static std::mutex mu;
+  static OverrideState state;
+  std::lock_guard<std::mutex> lock{mu};
+  boost::system::error_code ec;
+  auto mtime = fs::last_write_time(path, ec);
+  auto size = ec ? 0 : fs::file_size(path, ec);
+  if (ec) {
+    // Keep serving whatever loaded last rather than flapping mid-rewrite;
+    // the built-ins only apply if the file never loaded at all.
+    LOG(ERROR) << "Target config file " << path << " is unreadable: " << ec.message();
+  } else if (!state.configs || state.mtime != mtime || state.size != size) {
+    try {
+      auto fresh =
+          std::make_shared<const codegen::proto::Configs>(ParseConfig<codegen::proto::Configs>(ReadFile(path)));
+      state.configs = std::move(fresh);
+      state.mtime = mtime;
+      state.size = size;
+      state.version = str(boost::format("%s@%d:%d") % path % mtime % size);
+      LOG(INFO) << "Loaded target configs from " << path;
+    } catch (const std::exception& ex) {
+      LOG(ERROR) << "Failed to parse target config file " << path << ": " << ex.what();
+    }
+  }
+  if (!state.configs) {
+    if (version) {
+      *version = "builtin";
+    }
+    return Builtin();
+  }
+  if (version) {
+    *version = state.version;
+  }
+  return state.configs;
+}
+
+std::string ConfigsVersion() {
+  std::string version;
+  GetConfigs(&version);
+  return version;
+}
+
+void PrefetchConfigs() {
+  std::thread([] { GetConfigs(); }).detach();
+}
 
 }  // namespace targets
 }  // namespace tile
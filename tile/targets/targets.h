@@ -1,12 +1,35 @@
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "tile/codegen/codegen.pb.h"
 
 namespace vertexai {
 namespace tile {
 namespace targets {
 
-codegen::proto::Configs GetConfigs();
+// Returns the active target configurations.  By default these are the
+// built-in configs, parsed once on first use and shared immutably for the
+// life of the process.  When PLAIDML_TARGET_CONFIG names a config file, it
+// overrides the built-ins and is watched by modification time: a compile
+// starting after the file changes sees the new configs, while programs
+// already compiled keep running on the artifacts they were built with.
+// Hold the returned snapshot across a compile rather than re-fetching, so
+// one compile never mixes two config versions.  When version is non-null it
+// receives the tag identifying the snapshot (see ConfigsVersion).
+std::shared_ptr<const codegen::proto::Configs> GetConfigs(std::string* version = nullptr);
+
+// An opaque tag naming the configs the next GetConfigs() call would return:
+// "builtin", or derived from the override file's identity.  Fold it into
+// compilation cache keys so artifacts compiled under an older config are
+// never reused after a reload.
+std::string ConfigsVersion();
+
+// Kicks off config parsing on a background thread so the first compile
+// doesn't stall on it.  Safe to call any number of times; a concurrent
+// GetConfigs() simply blocks until the parse completes.
+void PrefetchConfigs();
 
 }  // namespace targets
 }  // namespace tile
@@ -52,6 +52,12 @@ std::shared_ptr<lang::TensorValue> MakeTensor(const TensorShape& shape) {
 
 TileFile::TileFile(const boost::filesystem::path& path) : archive_(path.string()), path_(path) {}
 
+TileFile::~TileFile() {
+  if (prefetch_.joinable()) {
+    prefetch_.join();
+  }
+}
+
 lang::RunInfo TileFile::Load(const std::vector<std::shared_ptr<SimpleBuffer>>& inputs) {
   auto metadata = ReadMetadata();
   auto code = archive_.OpenFile("code").ReadString();
@@ -158,6 +164,46 @@ std::vector<float> TileFile::GetTensorFloatData(const metadata::proto::Tensor& t
   return result;
 }
 
+tile::BufferPtr TileFile::GetTensorData(const metadata::proto::Tensor& tensor) {
+  if (tensor.filename().empty()) {
+    throw std::runtime_error{"No internal data or data filename found in tensor"};
+  }
+  auto tensor_file = archive_.OpenFile(tensor.filename());
+  if (tensor_file.IsStored()) {
+    // The entry's bytes sit contiguously in the archive, so hand back a
+    // copy-on-write mapping of them instead of copying them onto the heap.
+    return std::make_shared<MmapBuffer>(archive_.path(), tensor_file.FileOffset(), tensor_file.size());
+  }
+  std::vector<char> bytes(tensor_file.size());
+  tensor_file.ReadInto(bytes.data(), bytes.size());
+  return std::make_shared<tile::SimpleBuffer>(bytes);
+}
+
+void TileFile::PrefetchTensorData() {
+  if (prefetch_.joinable()) {
+    return;
+  }
+  prefetch_ = std::thread([path = path_.string()]() {
+    try {
+      // A separate handle: unzFile positioning is stateful, so sharing
+      // archive_ would race with foreground opens.
+      UnZipArchive archive{path};
+      std::vector<char> scratch;
+      for (const auto& name : archive.Entries()) {
+        if (name == "code" || name == "metadata") {
+          continue;  // tiny, and already read by Load/ReadMetadata
+        }
+        auto file = archive.OpenFile(name);
+        scratch.resize(file.size());
+        file.ReadInto(scratch.data(), scratch.size());
+      }
+    } catch (...) {
+      // Prefetch is purely an optimization; any error here will resurface
+      // on the foreground read that actually needs the data.
+    }
+  });
+}
+
 }  // namespace util
 }  // namespace tile
 }  // namespace vertexai
@@ -2,11 +2,15 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "base/util/zipfile.h"
+#include "tile/base/buffer.h"
 #include "tile/lang/runinfo.h"
 #include "tile/proto/metadata.pb.h"
 
@@ -18,17 +22,64 @@ struct SimpleBuffer : lang::BufferBase {
   std::vector<uint8_t> bytes;
 };
 
+// A buffer backed by a copy-on-write mapping of a region of a file.  Pages
+// are faulted in from disk as the program touches them, so the cost of
+// loading is proportional to the bytes actually read rather than the size
+// of the region; writes land in anonymous pages and never reach the file.
+class MmapBuffer final : public tile::Buffer {
+  class MmapView final : public tile::View {
+   public:
+    MmapView(char* data, std::size_t size) : View(data, size) {}
+    void WriteBack(const context::Context& ctx) final {}
+  };
+
+ public:
+  MmapBuffer(const std::string& path, std::uint64_t offset, std::uint64_t size)
+      : mapping_{path.c_str(), boost::interprocess::read_only},
+        region_{mapping_, boost::interprocess::copy_on_write, static_cast<boost::interprocess::offset_t>(offset),
+                static_cast<std::size_t>(size)} {}
+
+  uint64_t size() const final { return region_.get_size(); }
+
+  boost::future<std::unique_ptr<tile::View>> MapCurrent(const context::Context& ctx) final {
+    std::unique_ptr<tile::View> view(new MmapView(static_cast<char*>(region_.get_address()), region_.get_size()));
+    return boost::make_ready_future(std::move(view));
+  }
+
+  std::unique_ptr<tile::View> MapDiscard(const context::Context& ctx) final {
+    return std::make_unique<MmapView>(static_cast<char*>(region_.get_address()), region_.get_size());
+  }
+
+ private:
+  boost::interprocess::file_mapping mapping_;
+  boost::interprocess::mapped_region region_;
+};
+
 class TileFile {
  public:
   explicit TileFile(const boost::filesystem::path& path);
+  ~TileFile();
 
   lang::RunInfo Load(const std::vector<std::shared_ptr<SimpleBuffer>>& inputs = {});
   metadata::proto::Metadata ReadMetadata();
   std::vector<float> GetTensorFloatData(const metadata::proto::Tensor& tensor);
 
+  // Returns the raw bytes of a tensor referenced by the metadata.  Tensors
+  // are stored uncompressed, so the returned buffer is normally a mapping of
+  // the archive itself and costs no copy; compressed entries fall back to an
+  // inflated heap copy.
+  tile::BufferPtr GetTensorData(const metadata::proto::Tensor& tensor);
+
+  // Warms the OS page cache with every weight and testcase tensor in the
+  // archive, on a background thread with its own archive handle so it never
+  // contends with foreground reads.  Single-tensor lookups stay lazy; call
+  // this when the tool will eventually touch most of the model.
+  void PrefetchTensorData();
+
  private:
   UnZipArchive archive_;
   boost::filesystem::path path_;
+  std::thread prefetch_;
 };
 
 }  // namespace util
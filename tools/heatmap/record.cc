@@ -0,0 +1,131 @@
+// Copyright 2019, Intel Corporation.
+//
+// Records a GEMM microkernel heatmap for the host CPU by sweeping inner
+// tile shapes through the CPU JIT and timing each one.  The output is an
+// "M,N,K,GFLOPS" CSV in the same format as the build-time heatmap, usable
+// via PLAIDML_CPU_HEATMAP or the autostencil pass's heatmap option.
+//
+// Usage: record OUT.csv [MAX_M MAX_N MAX_K [STEP]]
+//
+// Every even shape up to the bounds is measured by default; expect a few
+// minutes of runtime, since each shape is a separate JIT compilation.
+
+#include <google/protobuf/text_format.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "tile/stripe/stripe.h"
+#include "tile/targets/cpu/jit.h"
+
+namespace {
+
+using namespace vertexai::tile;  // NOLINT
+
+// A single (m, n, k) GEMM microkernel: the inner block a stencil pass
+// would carve out, wrapped in user-visible A/B/C refinements.
+std::shared_ptr<stripe::Block> MakeGemm(unsigned m, unsigned n, unsigned k) {
+  auto text = boost::format(R"(
+    loc {}
+    refs [
+      {key:"A" value {loc {} attrs: {key:"user" value:{}} dir:1
+        access {} access {}
+        interior_shape {type:FLOAT32 dims:{size:%1% stride:%3%} dims:{size:%3% stride:1}}}},
+      {key:"B" value {loc {} attrs: {key:"user" value:{}} dir:1
+        access {} access {}
+        interior_shape {type:FLOAT32 dims:{size:%3% stride:%2%} dims:{size:%2% stride:1}}}},
+      {key:"C" value {loc {} attrs: {key:"user" value:{}} dir:3
+        access {} access {}
+        interior_shape {type:FLOAT32 dims:{size:%1% stride:%2%} dims:{size:%2% stride:1}}}}
+    ]
+    stmts { block {
+      name: "gemm"
+      loc {}
+      idxs [{name:"m" range:%1%}, {name:"n" range:%2%}, {name:"k" range:%3%}]
+      refs [
+        {key:"a" value {loc {} dir:1 from:"A"
+          access {terms:{key:"m" value:1}} access {terms:{key:"k" value:1}}
+          interior_shape {type:FLOAT32 dims:{size:1 stride:%3%} dims:{size:1 stride:1}}}},
+        {key:"b" value {loc {} dir:1 from:"B"
+          access {terms:{key:"k" value:1}} access {terms:{key:"n" value:1}}
+          interior_shape {type:FLOAT32 dims:{size:1 stride:%2%} dims:{size:1 stride:1}}}},
+        {key:"c" value {loc {} dir:2 from:"C" agg_op:"add"
+          access {terms:{key:"m" value:1}} access {terms:{key:"n" value:1}}
+          interior_shape {type:FLOAT32 dims:{size:1 stride:%2%} dims:{size:1 stride:1}}}}
+      ]
+      stmts { load { from:"a" into:"$a" } }
+      stmts { load { from:"b" into:"$b" } }
+      stmts { intrinsic { name:"mul" type:FLOAT32 inputs:"$a" inputs:"$b" outputs:"$p" } }
+      stmts { store { from:"$p" into:"c" } }
+    } }
+  )") % m % n % k;
+  stripe::proto::Block proto;
+  google::protobuf::TextFormat::ParseFromString(text.str(), &proto);
+  return stripe::FromProto(proto);
+}
+
+double MeasureGflops(unsigned m, unsigned n, unsigned k) {
+  auto program = MakeGemm(m, n, k);
+  std::vector<float> a(size_t(m) * k, 1.0f);
+  std::vector<float> b(size_t(k) * n, 1.0f);
+  std::vector<float> c(size_t(m) * n, 0.0f);
+  std::map<std::string, void*> buffers{{"A", a.data()}, {"B", b.data()}, {"C", c.data()}};
+
+  targets::cpu::Native native;
+  native.compile(*program, targets::cpu::Config{});
+  native.run(buffers);  // Warm up: page in the code and the buffers.
+
+  auto deadline = std::chrono::milliseconds(20);
+  size_t runs = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration elapsed{};
+  do {
+    native.run(buffers);
+    runs++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < deadline);
+  double seconds = std::chrono::duration<double>(elapsed).count();
+  return 2.0 * m * n * k * runs / seconds / 1e9;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: record OUT.csv [MAX_M MAX_N MAX_K [STEP]]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  unsigned max_m = argc > 2 ? std::atoi(argv[2]) : 16;
+  unsigned max_n = argc > 3 ? std::atoi(argv[3]) : 64;
+  unsigned max_k = argc > 4 ? std::atoi(argv[4]) : 64;
+  unsigned step = argc > 5 ? std::atoi(argv[5]) : 2;
+  if (!max_m || !max_n || !max_k || !step) {
+    std::cerr << "record: bounds and step must be positive" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream out(argv[1]);
+  if (!out) {
+    std::cerr << "record: unable to write " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  out << "M,N,K,GFLOPS" << std::endl;
+  for (unsigned m = step; m <= max_m; m += step) {
+    for (unsigned n = step; n <= max_n; n += step) {
+      for (unsigned k = step; k <= max_k; k += step) {
+        double gflops = MeasureGflops(m, n, k);
+        out << m << "," << n << "," << k << "," << gflops << std::endl;
+      }
+    }
+    std::cerr << "record: finished m=" << m << std::endl;
+  }
+  return EXIT_SUCCESS;
+}